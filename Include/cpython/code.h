@@ -7,9 +7,11 @@ typedef uint16_t _Py_CODEUNIT;
 #ifdef WORDS_BIGENDIAN
 #  define _Py_OPCODE(word) ((word) >> 8)
 #  define _Py_OPARG(word) ((word) & 255)
+#  define _Py_MAKECODEUNIT(opcode, oparg) (((opcode) << 8) | (oparg))
 #else
 #  define _Py_OPCODE(word) ((word) & 255)
 #  define _Py_OPARG(word) ((word) >> 8)
+#  define _Py_MAKECODEUNIT(opcode, oparg) ((opcode) | ((oparg) << 8))
 #endif
 
 typedef struct _PyOpcache _PyOpcache;
@@ -61,6 +63,14 @@ struct PyCodeObject {
     _PyOpcache *co_opcache;
     int co_opcache_flag;  // used to determine when create a cache.
     unsigned char co_opcache_size;  // length of co_opcache.
+
+    /* Private copy of co_code executed once the code object is hot, in which
+     * generic instructions are replaced with type-specialized ones.
+     * NULL until the opcode cache is created. */
+    _Py_CODEUNIT *co_quickened;
+    /* Backoff counters of the adaptive instructions of co_quickened, one per
+     * code unit, allocated with it. */
+    uint16_t *co_adaptive_counters;
 };
 
 /* Masks for co_flags above */
@@ -136,6 +136,9 @@ struct _ts {
     /* Unique thread state id. */
     uint64_t id;
 
+    /* Cache of free small memory blocks (see Objects/obmalloc.c) */
+    struct _PyObject_BlockCache *obmalloc_cache;
+
     /* XXX signal handlers should also be here */
 
 };
@@ -10,15 +10,34 @@ typedef struct {
     uint64_t builtins_ver; /* ma_version of builtin dict */
 } _PyOpcache_LoadGlobal;
 
+typedef struct {
+    PyTypeObject *type;  /* Cached type (borrowed reference) */
+    Py_ssize_t hint;     /* Index in the instance dict if >= 0, or the
+                            inverted offset (~offset) of a __slots__ member
+                            if < -1 */
+    unsigned int tp_version_tag;  /* tp_version_tag of type */
+} _PyOpcache_LoadAttr;
+
+typedef struct {
+    PyTypeObject *type;  /* Cached type (borrowed reference) */
+    PyObject *meth;      /* Unbound method found on type (borrowed reference) */
+    unsigned int tp_version_tag;  /* tp_version_tag of type */
+    uint32_t dk_version; /* Keys version of a combined-table instance dict
+                            known not to shadow meth, or 0 */
+} _PyOpcache_LoadMethod;
+
 struct _PyOpcache {
     union {
         _PyOpcache_LoadGlobal lg;
+        _PyOpcache_LoadAttr la;   /* LOAD_ATTR and STORE_ATTR */
+        _PyOpcache_LoadMethod lm;
     } u;
     char optimized;
 };
 
 /* Private API */
 int _PyCode_InitOpcache(PyCodeObject *co);
+int _PyCode_Quicken(PyCodeObject *co);
 
 
 #ifdef __cplusplus
@@ -0,0 +1,58 @@
+/* Runtime detection of the SIMD instruction sets available to optional
+   fast paths.
+
+   When _Py_HAVE_X86_SIMD is defined, functions marked with _Py_TARGET_SSE42
+   or _Py_TARGET_AVX2 may use the intrinsics of <immintrin.h> for these
+   instruction sets, without building the rest of the file for them.  They
+   must only be called when _Py_GetSIMDLevel() returns at least the matching
+   level; callers keep a portable code path for the other machines.
+*/
+
+#ifndef Py_INTERNAL_CPUINFO_H
+#define Py_INTERNAL_CPUINFO_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef Py_BUILD_CORE
+#  error "this header requires Py_BUILD_CORE define"
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5))
+   /* The target attribute and __builtin_cpu_supports() are available
+      since GCC 4.8, but <immintrin.h> only defines the intrinsics of
+      instruction sets that are not enabled for the whole file since
+      GCC 4.9. */
+#  define _Py_HAVE_X86_SIMD
+#  define _Py_TARGET_SSE42 __attribute__((target("sse4.2")))
+#  define _Py_TARGET_AVX2 __attribute__((target("avx2")))
+#  include <immintrin.h>
+#endif
+
+/* Values of _Py_GetSIMDLevel(), each level including the previous ones */
+#define _Py_SIMD_NONE 0
+#define _Py_SIMD_SSE42 1
+#define _Py_SIMD_AVX2 2
+
+/* The level in use, or -1 if it was not detected yet.  Tests may lower it
+   to exercise the code paths of older machines. */
+PyAPI_DATA(int) _Py_simd_level;
+
+/* Return the highest level supported by the CPU and the OS. */
+PyAPI_FUNC(int) _Py_DetectSIMDLevel(void);
+
+static inline int
+_Py_GetSIMDLevel(void)
+{
+    int level = _Py_simd_level;
+    if (level < 0) {
+        level = _Py_simd_level = _Py_DetectSIMDLevel();
+    }
+    return level;
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* !Py_INTERNAL_CPUINFO_H */
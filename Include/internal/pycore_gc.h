@@ -15,7 +15,7 @@ typedef struct {
     uintptr_t _gc_next;
 
     // Pointer to previous object in the list.
-    // Lowest two bits are used for flags documented later.
+    // Lowest bits are used for flags documented later.
     uintptr_t _gc_prev;
 } PyGC_Head;
 
@@ -36,8 +36,17 @@ typedef struct {
 #define _PyGC_PREV_MASK_FINALIZED  (1)
 /* Bit 1 is set when the object is in generation which is GCed currently. */
 #define _PyGC_PREV_MASK_COLLECTING (2)
+#if SIZEOF_VOID_P >= 8
+/* Bit 2 is set when the object is in the oldest generation and has not been
+   examined yet by the incremental collection in progress.  This bit requires
+   GC heads and GC list heads to be aligned on 8 bytes. */
+#  define _PyGC_PREV_MASK_PENDING  (4)
+/* The (N-3) most significant bits contain the real address. */
+#  define _PyGC_PREV_SHIFT         (3)
+#else
 /* The (N-2) most significant bits contain the real address. */
-#define _PyGC_PREV_SHIFT           (2)
+#  define _PyGC_PREV_SHIFT         (2)
+#endif
 #define _PyGC_PREV_MASK            (((uintptr_t) -1) << _PyGC_PREV_SHIFT)
 
 // Lowest bit of _gc_next is used for flags only in GC.
@@ -45,7 +54,7 @@ typedef struct {
 #define _PyGCHead_NEXT(g)        ((PyGC_Head*)(g)->_gc_next)
 #define _PyGCHead_SET_NEXT(g, p) ((g)->_gc_next = (uintptr_t)(p))
 
-// Lowest two bits of _gc_prev is used for _PyGC_PREV_MASK_* flags.
+// Lowest bits of _gc_prev are used for _PyGC_PREV_MASK_* flags.
 #define _PyGCHead_PREV(g) ((PyGC_Head*)((g)->_gc_prev & _PyGC_PREV_MASK))
 #define _PyGCHead_SET_PREV(g, p) do { \
     assert(((uintptr_t)p & ~_PyGC_PREV_MASK) == 0); \
@@ -117,6 +126,46 @@ struct gc_generation {
                   generations */
 };
 
+/* State of the incremental collection of the oldest generation */
+struct gc_incremental_state {
+    /* pause budget of an increment in microseconds, 0 if disabled */
+    Py_ssize_t budget;
+    /* current phase, see the GC_INCR_* constants in gcmodule.c */
+    int phase;
+    /* objects of the oldest generation at the start of the collection which
+       are not flagged as pending yet */
+    PyGC_Head unflagged;
+    /* objects flagged as pending which have not been examined yet */
+    PyGC_Head pending;
+    /* objects found reachable from the roots whose referents have not been
+       visited yet */
+    PyGC_Head reachable;
+    /* number of pending objects taken by an increment, tuned to fit in the
+       budget */
+    Py_ssize_t slice;
+    /* number of objects which survived the collection so far */
+    Py_ssize_t survivors;
+};
+
+/* Phases of a collection whose duration is measured */
+#define _PyGC_PHASE_REFCOUNTS       0   /* update_refs(), subtract_refs() */
+#define _PyGC_PHASE_REACHABILITY    1   /* move_unreachable() */
+#define _PyGC_PHASE_WEAKREFS        2   /* handle_weakrefs() */
+#define _PyGC_PHASE_FINALIZERS      3   /* finalize_garbage() */
+#define _PyGC_PHASE_DELETION        4   /* delete_garbage() */
+#define _PyGC_NUM_PHASES            5
+
+/* Durations of a collection and of its phases */
+struct gc_collection_timing {
+    _PyTime_t total;
+    _PyTime_t phases[_PyGC_NUM_PHASES];
+};
+
+/* Number of buckets of the pause histograms.  Bucket 0 counts the pauses
+   shorter than 1 microsecond and bucket i the pauses of 2**(i-1) to 2**i
+   microseconds, except the last one which counts all the longer pauses. */
+#define _PyGC_PAUSE_BUCKETS 24
+
 /* Running stats per generation */
 struct gc_generation_stats {
     /* total number of collections */
@@ -125,6 +174,22 @@ struct gc_generation_stats {
     Py_ssize_t collected;
     /* total number of uncollectable objects (put into gc.garbage) */
     Py_ssize_t uncollectable;
+    /* total time spent in collections and in each of their phases */
+    struct gc_collection_timing timing;
+    /* histogram of the pauses: the durations of the collections, or of the
+       increments of incremental collections */
+    Py_ssize_t pauses[_PyGC_PAUSE_BUCKETS];
+};
+
+/* State of the parallel marking of full collections */
+struct gc_parallel_state {
+    /* Number of threads computing the reachable objects during full
+       collections, including the collecting thread.  0 or 1 disables
+       parallel marking. */
+    int nworkers;
+    /* Locks used by parallel collections, allocated on first use */
+    PyThread_type_lock mutex;
+    PyThread_type_lock done;
 };
 
 struct _gc_runtime_state {
@@ -159,6 +224,8 @@ struct _gc_runtime_state {
        collections, and are awaiting to undergo a full collection for
        the first time. */
     Py_ssize_t long_lived_pending;
+    struct gc_incremental_state incremental;
+    struct gc_parallel_state parallel;
 };
 
 PyAPI_FUNC(void) _PyGC_InitState(struct _gc_runtime_state *);
@@ -0,0 +1,22 @@
+#ifndef Py_INTERNAL_LONG_H
+#define Py_INTERNAL_LONG_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef Py_BUILD_CORE
+#  error "this header requires Py_BUILD_CORE define"
+#endif
+
+#include "longintrepr.h"    /* PyLongObject */
+
+/* For use by the specialized instructions in ceval.c: the arguments must
+   be exact ints.  _PyLong_Compare() returns a negative number, zero or a
+   positive number if a < b, a == b or a > b. */
+PyAPI_FUNC(PyObject *) _PyLong_Add(PyLongObject *a, PyLongObject *b);
+PyAPI_FUNC(Py_ssize_t) _PyLong_Compare(PyLongObject *a, PyLongObject *b);
+
+#ifdef __cplusplus
+}
+#endif
+#endif   /* !Py_INTERNAL_LONG_H */
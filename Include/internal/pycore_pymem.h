@@ -69,6 +69,11 @@ PyAPI_FUNC(int) _PyMem_GetAllocatorName(
    PYMEM_ALLOCATOR_NOT_SET does nothing. */
 PyAPI_FUNC(int) _PyMem_SetupAllocators(PyMemAllocatorName allocator);
 
+/* Per-thread cache of free pymalloc blocks, owned by a PyThreadState.
+   See Objects/obmalloc.c. */
+extern struct _PyObject_BlockCache* _PyObject_NewBlockCache(void);
+extern void _PyObject_FreeBlockCache(struct _PyObject_BlockCache *cache);
+
 /* bpo-35053: Expose _Py_tracemalloc_config for _Py_NewReference()
    which access directly _Py_tracemalloc_config.tracing for best
    performances. */
@@ -0,0 +1,24 @@
+#ifndef Py_INTERNAL_UNICODEOBJECT_H
+#define Py_INTERNAL_UNICODEOBJECT_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef Py_BUILD_CORE
+#  error "this header requires Py_BUILD_CORE define"
+#endif
+
+/* Find the first occurrence of p[:m] in s[:n], arrays of characters of the
+   given kind.  Return its index, or -1. */
+PyAPI_FUNC(Py_ssize_t) _PyUnicode_FindSubstring(
+    int kind,
+    const void *s,
+    Py_ssize_t n,
+    const void *p,
+    Py_ssize_t m
+    );
+
+#ifdef __cplusplus
+}
+#endif
+#endif   /* !Py_INTERNAL_UNICODEOBJECT_H */
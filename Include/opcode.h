@@ -127,6 +127,22 @@ extern "C" {
 #define SET_UPDATE              163
 #define DICT_MERGE              164
 #define DICT_UPDATE             165
+#define BINARY_ADD_ADAPTIVE       7
+#define BINARY_ADD_INT            8
+#define BINARY_ADD_FLOAT         13
+#define BINARY_ADD_UNICODE       14
+#define INPLACE_ADD_ADAPTIVE     18
+#define INPLACE_ADD_INT          21
+#define INPLACE_ADD_FLOAT        30
+#define INPLACE_ADD_UNICODE      31
+#define BINARY_SUBSCR_ADAPTIVE   32
+#define BINARY_SUBSCR_LIST_INT   33
+#define BINARY_SUBSCR_TUPLE_INT  34
+#define BINARY_SUBSCR_DICT       35
+#define COMPARE_OP_ADAPTIVE      36
+#define COMPARE_OP_INT           37
+#define COMPARE_OP_FLOAT         38
+#define COMPARE_OP_UNICODE       39
 
 /* EXCEPT_HANDLER is a special, implicit block type which is created when
    entering an except handler. It is not an opcode but we define it here
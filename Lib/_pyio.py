@@ -1029,18 +1029,21 @@ class BytesIO(BufferedIOBase):
 
 class BufferedReader(_BufferedIOMixin):
 
-    """BufferedReader(raw[, buffer_size])
+    """BufferedReader(raw[, buffer_size], *, readahead=0)
 
     A buffer for a readable, sequential BaseRawIO object.
 
     The constructor creates a BufferedReader for the given readable raw
     stream and buffer_size. If buffer_size is omitted, DEFAULT_BUFFER_SIZE
-    is used.
+    is used. If readahead is positive, the operating system is asked to
+    read that many bytes of the file ahead of the reads, in the background.
     """
 
-    def __init__(self, raw, buffer_size=DEFAULT_BUFFER_SIZE):
+    def __init__(self, raw, buffer_size=DEFAULT_BUFFER_SIZE, *, readahead=0):
         """Create a new buffered reader using the given readable raw IO object.
         """
+        if readahead < 0:
+            raise ValueError("readahead must not be negative")
         if not raw.readable():
             raise OSError('"raw" argument must be readable.')
 
@@ -1050,6 +1053,50 @@ class BufferedReader(_BufferedIOMixin):
         self.buffer_size = buffer_size
         self._reset_read_buf()
         self._read_lock = Lock()
+        self._readahead = readahead
+        self._readahead_fd = -1
+        self._readahead_end = 0
+        if readahead and hasattr(os, 'posix_fadvise'):
+            # The hints are only possible for the raw streams with a file
+            # descriptor, and skipped for the others.
+            try:
+                self._readahead_fd = raw.fileno()
+            except (AttributeError, OSError):
+                pass
+
+    @property
+    def readahead(self):
+        return self._readahead
+
+    def _prefetch(self):
+        """Ask the OS to read the file ahead of the raw stream position.
+
+        The file is read ahead by windows of readahead bytes.  The next
+        window is requested once half of the previous one has been read,
+        so that the disk is busy with it while the caller processes the
+        data.
+        """
+        try:
+            pos = self.raw.tell()
+            end = self._readahead_end
+            if pos > end or end - pos > self._readahead:
+                # First read, or the stream was moved away from the window.
+                end = pos
+            if end - pos > self._readahead // 2:
+                return
+            os.posix_fadvise(self._readahead_fd, end, self._readahead,
+                             os.POSIX_FADV_WILLNEED)
+        except OSError:
+            # E.g. ESPIPE: the stream is not a regular file after all.
+            self._readahead_fd = -1
+            return
+        self._readahead_end = end + self._readahead
+
+    def _raw_read(self, size):
+        data = self.raw.read(size)
+        if data and self._readahead and self._readahead_fd >= 0:
+            self._prefetch()
+        return data
 
     def readable(self):
         return self.raw.readable()
@@ -1109,7 +1156,7 @@ class BufferedReader(_BufferedIOMixin):
         chunks = [buf[pos:]]
         wanted = max(self.buffer_size, n)
         while avail < n:
-            chunk = self.raw.read(wanted)
+            chunk = self._raw_read(wanted)
             if chunk in empty_values:
                 nodata_val = chunk
                 break
@@ -1138,7 +1185,7 @@ class BufferedReader(_BufferedIOMixin):
         have = len(self._read_buf) - self._read_pos
         if have < want or have <= 0:
             to_read = self.buffer_size - have
-            current = self.raw.read(to_read)
+            current = self._raw_read(to_read)
             if current:
                 self._read_buf = self._read_buf[self._read_pos:] + current
                 self._read_pos = 0
@@ -1195,6 +1242,8 @@ class BufferedReader(_BufferedIOMixin):
                     if not n:
                         break # eof
                     written += n
+                    if self._readahead and self._readahead_fd >= 0:
+                        self._prefetch()
 
                 # Otherwise refill internal buffer - unless we're
                 # in read1 mode and already got some data
@@ -12,6 +12,7 @@ import subprocess
 import sys
 import threading
 import warnings
+import weakref
 
 from . import base_events
 from . import base_subprocess
@@ -433,6 +434,171 @@ class _UnixSelectorEventLoop(selector_events.BaseSelectorEventLoop):
         fut.add_done_callback(cb)
 
 
+if hasattr(selectors, 'IoUringSelector'):
+
+    __all__ += ('IoUringEventLoop',)
+
+    class IoUringEventLoop(_UnixSelectorEventLoop):
+        """Unix event loop on io_uring.
+
+        The low-level socket operations are io_uring operations, which the
+        kernel performs without waiting for the socket to be ready first,
+        and files can be read and written without a thread pool.
+        """
+
+        def __init__(self, entries=256):
+            super().__init__(selectors.IoUringSelector(entries))
+            # {socket: data received by a recv which completed after it
+            # was cancelled}, returned by the next recv on the socket
+            self._late_recv = weakref.WeakKeyDictionary()
+
+        def _ring_op(self, method, *args, discard=None):
+            # Queue an io_uring operation and return a future for its
+            # result.  discard(result) releases the result of an operation
+            # which completes after the future was cancelled.
+            fut = self.create_future()
+
+            def on_complete(result):
+                if fut.done():
+                    if discard is not None and result >= 0:
+                        discard(result)
+                elif result < 0:
+                    fut.set_exception(OSError(-result, os.strerror(-result)))
+                else:
+                    fut.set_result(result)
+
+            tag = self._selector._queue_op(on_complete, method, *args)
+
+            def on_cancel(fut):
+                if fut.cancelled() and not self.is_closed():
+                    self._selector._cancel_op(tag)
+
+            fut.add_done_callback(on_cancel)
+            return fut
+
+        async def sock_recv(self, sock, n):
+            """Receive data from the socket.
+
+            The return value is a bytes object representing the data
+            received.  The maximum amount of data to be received at once is
+            specified by nbytes.
+            """
+            selector_events._check_ssl_socket(sock)
+            if self._debug and sock.gettimeout() != 0:
+                raise ValueError("the socket must be non-blocking")
+            data = self._pop_late_recv(sock, n)
+            if data is not None:
+                return bytes(data)
+            buf = bytearray(n)
+            nbytes = await self._ring_op('recv', sock.fileno(), buf,
+                                         discard=self._keep_late_recv(sock,
+                                                                      buf))
+            del buf[nbytes:]
+            return bytes(buf)
+
+        async def sock_recv_into(self, sock, buf):
+            """Receive data from the socket.
+
+            The received data is written into *buf* (a writable buffer).
+            The return value is the number of bytes written.
+            """
+            selector_events._check_ssl_socket(sock)
+            if self._debug and sock.gettimeout() != 0:
+                raise ValueError("the socket must be non-blocking")
+            view = memoryview(buf).cast('B')
+            data = self._pop_late_recv(sock, len(view))
+            if data is not None:
+                view[:len(data)] = data
+                return len(data)
+            return await self._ring_op('recv', sock.fileno(), buf,
+                                       discard=self._keep_late_recv(sock,
+                                                                    view))
+
+        def _keep_late_recv(self, sock, buf):
+            # Return a discard() callback for a recv into buf, which keeps
+            # the data for the next recv on sock.
+            def keep(nbytes):
+                if nbytes:
+                    data = self._late_recv.setdefault(sock, bytearray())
+                    data += buf[:nbytes]
+            return keep
+
+        def _pop_late_recv(self, sock, n):
+            # Return at most n bytes of the data kept by _keep_late_recv(),
+            # or None if there is none.
+            data = self._late_recv.pop(sock, None)
+            if data is not None and len(data) > n:
+                self._late_recv[sock] = data[n:]
+                del data[n:]
+            return data
+
+        async def sock_sendall(self, sock, data):
+            """Send data to the socket.
+
+            The socket must be connected to a remote socket.  This method
+            continues to send data from data until either all data has been
+            sent or an error occurs.  None is returned on success.
+            """
+            selector_events._check_ssl_socket(sock)
+            if self._debug and sock.gettimeout() != 0:
+                raise ValueError("the socket must be non-blocking")
+            fd = sock.fileno()
+            view = memoryview(data).cast('B')
+            pos = 0
+            while True:
+                pos += await self._ring_op('send', fd, view[pos:])
+                if pos >= len(view):
+                    return
+
+        async def sock_accept(self, sock):
+            """Accept a connection.
+
+            The socket must be bound to an address and listening for
+            connections.  The return value is a pair (conn, address) where
+            conn is a new socket object usable to send and receive data on
+            the connection, and address is the address bound to the socket
+            on the other end of the connection.
+            """
+            selector_events._check_ssl_socket(sock)
+            if self._debug and sock.gettimeout() != 0:
+                raise ValueError("the socket must be non-blocking")
+            fd = await self._ring_op('accept', sock.fileno(), discard=os.close)
+            conn = socket.socket(sock.family, sock.type, sock.proto,
+                                 fileno=fd)
+            try:
+                conn.setblocking(False)
+                address = conn.getpeername()
+            except:
+                conn.close()
+                raise
+            return conn, address
+
+        async def file_read(self, fd, n, offset=-1):
+            """Read at most n bytes from the file descriptor fd.
+
+            Read at offset in the file, or at the current file position if
+            offset is -1.  Return a bytes object, empty at end of file.
+            """
+            buf = bytearray(n)
+            nbytes = await self._ring_op('read', fd, buf, offset)
+            del buf[nbytes:]
+            return bytes(buf)
+
+        async def file_readinto(self, fd, buf, offset=-1):
+            """Read from the file descriptor fd into buf.
+
+            Return the number of bytes read.
+            """
+            return await self._ring_op('read', fd, buf, offset)
+
+        async def file_write(self, fd, data, offset=-1):
+            """Write data to the file descriptor fd.
+
+            Return the number of bytes written.
+            """
+            return await self._ring_op('write', fd, data, offset)
+
+
 class _UnixReadPipeTransport(transports.ReadTransport):
 
     max_size = 256 * 1024  # max bytes we read in one event loop iteration
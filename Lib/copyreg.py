@@ -47,6 +47,16 @@ def _reconstructor(cls, base, state):
             base.__init__(obj, state)
     return obj
 
+# Used by pickle for bytearrays pickled out-of-band: a bytearray given to the
+# unpickler as the buffer is reused instead of being copied.
+
+def _bytearray_reconstructor(buffer):
+    with memoryview(buffer) as m:
+        obj = m.obj
+        if type(obj) is bytearray and not m.readonly and m.nbytes == len(obj):
+            return obj
+        return bytearray(m)
+
 _HEAPTYPE = 1<<9
 
 # Python code for object.__reduce_ex__ for protocols 0 and 1
@@ -147,6 +157,30 @@ def _slotnames(cls):
 
     return names
 
+def _shape_slots(obj):
+    """Return the slot names of the class of obj if the pickler can save its
+    instances as a shape and their attribute values, or None.
+
+    This is the case when object.__reduce_ex__() pickles them by calling
+    cls.__new__(cls) and restoring their __dict__ and slots, without any
+    method of the class customizing this.
+    """
+    cls = type(obj)
+    if (cls.__reduce_ex__ is not object.__reduce_ex__ or
+        cls.__reduce__ is not object.__reduce__):
+        return None
+    for name in ('__getnewargs_ex__', '__getnewargs__',
+                 '__getstate__', '__setstate__'):
+        if hasattr(cls, name):
+            return None
+    # Let object.__reduce_ex__() reject classes with other state, such as
+    # subclasses of list and dict or of extension types.
+    rv = obj.__reduce_ex__(2)
+    if (rv[0] is not __newobj__ or rv[1] != (cls,) or
+        rv[3] is not None or rv[4] is not None):
+        return None
+    return tuple(_slotnames(cls))
+
 # A registry of extension codes.  This is an ad-hoc compression
 # mechanism.  Whenever a global reference to <module>, <name> is about
 # to be pickled, the (<module>, <name>) tuple is looked up here to see
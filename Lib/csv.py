@@ -6,7 +6,7 @@ csv.py - read/write/investigate CSV files
 import re
 from _csv import Error, __version__, writer, reader, register_dialect, \
                  unregister_dialect, get_dialect, list_dialects, \
-                 field_size_limit, \
+                 field_size_limit, parse, Table, \
                  QUOTE_MINIMAL, QUOTE_ALL, QUOTE_NONNUMERIC, QUOTE_NONE, \
                  __doc__
 from _csv import Dialect as _Dialect
@@ -18,7 +18,7 @@ __all__ = ["QUOTE_MINIMAL", "QUOTE_ALL", "QUOTE_NONNUMERIC", "QUOTE_NONE",
            "field_size_limit", "reader", "writer",
            "register_dialect", "get_dialect", "list_dialects", "Sniffer",
            "unregister_dialect", "__version__", "DictReader", "DictWriter",
-           "unix_dialect"]
+           "unix_dialect", "parse", "iterparse", "Table"]
 
 class Dialect:
     """Describe a CSV dialect.
@@ -77,6 +77,37 @@ class unix_dialect(Dialect):
 register_dialect("unix", unix_dialect)
 
 
+def iterparse(file, dialect='excel', *, chunk_size=16 * 1024 * 1024,
+              **kwargs):
+    """Parse the CSV data of a binary file by chunks.
+
+    Yield a Table for each chunk of about chunk_size bytes read from the
+    file, with the records which end in it.  The other arguments are passed
+    to parse().
+    """
+    pending = []    # chunks not parsed yet
+    size = 0        # their total size
+    retry = 0       # size to reach before parsing them again
+    while chunk := file.read(chunk_size):
+        pending.append(chunk)
+        size += len(chunk)
+        if size < retry:
+            continue
+        data = b''.join(pending)
+        table = parse(data, dialect, final=False, **kwargs)
+        rest = data[table.nbytes:]
+        pending = [rest]
+        size = len(rest)
+        # Wait for twice as much data after parsing no record, so that
+        # records longer than chunk_size are parsed in linear time.
+        retry = 0 if table.nbytes else 2 * size
+        if table:
+            yield table
+    table = parse(b''.join(pending), dialect, **kwargs)
+    if table:
+        yield table
+
+
 class DictReader:
     def __init__(self, f, fieldnames=None, restkey=None, restval=None,
                  dialect="excel", *args, **kwds):
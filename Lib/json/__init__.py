@@ -97,15 +97,17 @@ Using json.tool from the shell to validate and pretty-print::
 """
 __version__ = '2.0.9'
 __all__ = [
-    'dump', 'dumps', 'load', 'loads',
-    'JSONDecoder', 'JSONDecodeError', 'JSONEncoder',
+    'dump', 'dumps', 'load', 'loads', 'iterload',
+    'JSONDecoder', 'JSONDecodeError', 'JSONEncoder', 'JSONStreamDecoder',
 ]
 
 __author__ = 'Bob Ippolito <bob@redivi.com>'
 
-from .decoder import JSONDecoder, JSONDecodeError
+from .decoder import JSONDecoder, JSONDecodeError, JSONStreamDecoder
+from .scanner import c_make_scanner
 from .encoder import JSONEncoder
 import codecs
+import io
 
 _default_encoder = JSONEncoder(
     skipkeys=False,
@@ -121,7 +123,8 @@ def dump(obj, fp, *, skipkeys=False, ensure_ascii=True, check_circular=True,
         allow_nan=True, cls=None, indent=None, separators=None,
         default=None, sort_keys=False, **kw):
     """Serialize ``obj`` as a JSON formatted stream to ``fp`` (a
-    ``.write()``-supporting file-like object).
+    ``.write()``-supporting file-like object).  The stream is encoded
+    to UTF-8 if ``fp`` is a binary file.
 
     If ``skipkeys`` is true then ``dict`` keys that are not basic types
     (``str``, ``int``, ``float``, ``bool``, ``None``) will be skipped
@@ -166,18 +169,19 @@ def dump(obj, fp, *, skipkeys=False, ensure_ascii=True, check_circular=True,
         check_circular and allow_nan and
         cls is None and indent is None and separators is None and
         default is None and not sort_keys and not kw):
-        iterable = _default_encoder.iterencode(obj)
+        encoder = _default_encoder
     else:
         if cls is None:
             cls = JSONEncoder
-        iterable = cls(skipkeys=skipkeys, ensure_ascii=ensure_ascii,
+        encoder = cls(skipkeys=skipkeys, ensure_ascii=ensure_ascii,
             check_circular=check_circular, allow_nan=allow_nan, indent=indent,
             separators=separators,
-            default=default, sort_keys=sort_keys, **kw).iterencode(obj)
-    # could accelerate with writelines in some versions of Python, at
-    # a debuggability cost
-    for chunk in iterable:
-        fp.write(chunk)
+            default=default, sort_keys=sort_keys, **kw)
+    if isinstance(encoder, JSONEncoder):
+        encoder._dump(obj, fp)
+    else:
+        for chunk in encoder.iterencode(obj):
+            fp.write(chunk)
 
 
 def dumps(obj, *, skipkeys=False, ensure_ascii=True, check_circular=True,
@@ -330,6 +334,7 @@ def loads(s, *, cls=None, object_hook=None, parse_float=None,
     To use a custom ``JSONDecoder`` subclass, specify it with the ``cls``
     kwarg; otherwise ``JSONDecoder`` is used.
     """
+    utf8 = False
     if isinstance(s, str):
         if s.startswith('\ufeff'):
             raise JSONDecodeError("Unexpected UTF-8 BOM (decode using utf-8-sig)",
@@ -338,12 +343,32 @@ def loads(s, *, cls=None, object_hook=None, parse_float=None,
         if not isinstance(s, (bytes, bytearray)):
             raise TypeError(f'the JSON object must be str, bytes or bytearray, '
                             f'not {s.__class__.__name__}')
-        s = s.decode(detect_encoding(s), 'surrogatepass')
+        encoding = detect_encoding(s)
+        # The C scanner parses UTF-8 without decoding the whole document
+        # to a str first.
+        utf8 = (cls is None and c_make_scanner is not None and
+                encoding in ('utf-8', 'utf-8-sig'))
+        if not utf8:
+            s = s.decode(encoding, 'surrogatepass')
 
     if (cls is None and object_hook is None and
             parse_int is None and parse_float is None and
             parse_constant is None and object_pairs_hook is None and not kw):
-        return _default_decoder.decode(s)
+        decoder = _default_decoder
+    else:
+        decoder = _make_decoder(cls, object_hook, parse_float, parse_int,
+                                parse_constant, object_pairs_hook, kw)
+    if utf8:
+        try:
+            return decoder._decode_utf8(s, 3 if encoding == 'utf-8-sig' else 0)
+        except (JSONDecodeError, UnicodeDecodeError):
+            # Report the error as for the decoded str
+            s = s.decode(encoding, 'surrogatepass')
+    return decoder.decode(s)
+
+
+def _make_decoder(cls, object_hook, parse_float, parse_int, parse_constant,
+                  object_pairs_hook, kw):
     if cls is None:
         cls = JSONDecoder
     if object_hook is not None:
@@ -356,4 +381,34 @@ def loads(s, *, cls=None, object_hook=None, parse_float=None,
         kw['parse_int'] = parse_int
     if parse_constant is not None:
         kw['parse_constant'] = parse_constant
-    return cls(**kw).decode(s)
+    return cls(**kw)
+
+
+def iterload(fp, *, cls=None, object_hook=None, parse_float=None,
+        parse_int=None, parse_constant=None, object_pairs_hook=None,
+        bufsize=io.DEFAULT_BUFFER_SIZE, **kw):
+    """Deserialize the stream of JSON documents read from ``fp`` (a
+    ``.read()``-supporting file-like object of UTF-8 encoded bytes or of
+    text) and return an iterator over the Python objects.
+
+    Each document is decoded as soon as it was read, without waiting for
+    the end of the stream.  Documents are separated by optional whitespace,
+    as in the "JSON Lines" format.  ``fp`` is read by chunks of at most
+    ``bufsize``, with its ``read1()`` method if it has one, so that the
+    documents sent over a socket are returned as they arrive.
+
+    The other arguments have the same meaning as in ``load()``.  See
+    ``JSONStreamDecoder`` to feed the data to the decoder yourself.
+    """
+    decoder = _make_decoder(cls, object_hook, parse_float, parse_int,
+                            parse_constant, object_pairs_hook, kw)
+    stream = JSONStreamDecoder(decoder)
+    read = getattr(fp, 'read1', fp.read)
+    while True:
+        data = read(bufsize)
+        if not data:
+            break
+        stream.feed(data)
+        yield from stream.read_values()
+    stream.close()
+    yield from stream.read_values()
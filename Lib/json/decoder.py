@@ -1,5 +1,7 @@
 """Implementation of JSONDecoder
 """
+import codecs
+import collections
 import re
 
 from json import scanner
@@ -7,8 +9,12 @@ try:
     from _json import scanstring as c_scanstring
 except ImportError:
     c_scanstring = None
+try:
+    from _json import find_value_end as c_find_value_end
+except ImportError:
+    c_find_value_end = None
 
-__all__ = ['JSONDecoder', 'JSONDecodeError']
+__all__ = ['JSONDecoder', 'JSONDecodeError', 'JSONStreamDecoder']
 
 FLAGS = re.VERBOSE | re.MULTILINE | re.DOTALL
 
@@ -26,11 +32,19 @@ class JSONDecodeError(ValueError):
     lineno: The line corresponding to pos
     colno: The column corresponding to pos
 
+    When doc is UTF-8 encoded bytes, pos and colno count bytes.
+
     """
     # Note that this exception is used from _json
     def __init__(self, msg, doc, pos):
-        lineno = doc.count('\n', 0, pos) + 1
-        colno = pos - doc.rfind('\n', 0, pos)
+        if isinstance(doc, str):
+            newline = '\n'
+        else:
+            if not isinstance(doc, (bytes, bytearray)):
+                doc = bytes(doc)
+            newline = b'\n'
+        lineno = doc.count(newline, 0, pos) + 1
+        colno = pos - doc.rfind(newline, 0, pos)
         errmsg = '%s: line %d column %d (char %d)' % (msg, lineno, colno, pos)
         ValueError.__init__(self, errmsg)
         self.msg = msg
@@ -131,6 +145,7 @@ scanstring = c_scanstring or py_scanstring
 
 WHITESPACE = re.compile(r'[ \t\n\r]*', FLAGS)
 WHITESPACE_STR = ' \t\n\r'
+WHITESPACE_BYTES = re.compile(rb'[ \t\n\r]*', FLAGS)
 
 
 def JSONObject(s_and_end, strict, scan_once, object_hook, object_pairs_hook,
@@ -283,7 +298,7 @@ class JSONDecoder(object):
 
     def __init__(self, *, object_hook=None, parse_float=None,
             parse_int=None, parse_constant=None, strict=True,
-            object_pairs_hook=None):
+            object_pairs_hook=None, presize_dicts=False):
         """``object_hook``, if specified, will be called with the result
         of every JSON object decoded and its return value will be used in
         place of the given ``dict``.  This can be used to provide custom
@@ -315,6 +330,11 @@ class JSONDecoder(object):
         characters will be allowed inside strings.  Control characters in
         this context are those with character codes in the 0-31 range,
         including ``'\\t'`` (tab), ``'\\n'``, ``'\\r'`` and ``'\\0'``.
+
+        If ``presize_dicts`` is true, the dict of each object is created
+        with room for as many items as the last object decoded that had
+        the same first key, which saves resizing the dicts of records of
+        many keys.  It only has an effect with the C accelerator.
         """
         self.object_hook = object_hook
         self.parse_float = parse_float or float
@@ -322,6 +342,7 @@ class JSONDecoder(object):
         self.parse_constant = parse_constant or _CONSTANTS.__getitem__
         self.strict = strict
         self.object_pairs_hook = object_pairs_hook
+        self.presize_dicts = presize_dicts
         self.parse_object = JSONObject
         self.parse_array = JSONArray
         self.parse_string = scanstring
@@ -354,3 +375,204 @@ class JSONDecoder(object):
         except StopIteration as err:
             raise JSONDecodeError("Expecting value", s, err.value) from None
         return obj, end
+
+    def _decode_utf8(self, b, idx=0, _w=WHITESPACE_BYTES.match):
+        # Like decode(), for the UTF-8 encoded bytes-like object b, which
+        # the C scanner parses without decoding it to a str first.  Error
+        # positions are byte offsets.
+        obj, end = self.raw_decode(b, idx=_w(b, idx).end())
+        end = _w(b, end).end()
+        if end != len(b):
+            raise JSONDecodeError("Extra data", b, end)
+        return obj
+
+
+_IN_STRING = 1
+_IN_ESCAPE = 2
+_IN_SCALAR = 4
+_STATE_BITS = 3
+
+STRINGEND = re.compile(rb'["\\]')
+SCALAREND = re.compile(rb'[ \t\n\r\[\]{},:"]')
+STRUCTURAL = re.compile(rb'["\[\]{}]')
+
+def py_find_value_end(buf, idx, state):
+    """Scan the UTF-8 encoded JSON text in buf from idx for the end of a
+    top-level value, without decoding it.  State is 0 when idx is the
+    first byte of the value, otherwise the state returned by the previous
+    call, with idx the end it returned.
+
+    Returns a tuple of the index after the value and 0 if the value is
+    complete, or of len(buf) and the state to resume from when more data
+    arrives.  A top-level number or constant ends at the next whitespace
+    or structural character."""
+    depth = state >> _STATE_BITS
+    flags = state & ((1 << _STATE_BITS) - 1)
+    n = len(buf)
+    while idx < n:
+        if flags & _IN_ESCAPE:
+            flags = _IN_STRING
+            idx += 1
+        elif flags & _IN_STRING:
+            m = STRINGEND.search(buf, idx)
+            if m is None:
+                idx = n
+                break
+            idx = m.end()
+            if buf[m.start()] == ord('\\'):
+                flags = _IN_STRING | _IN_ESCAPE
+            else:
+                flags = 0
+                if not depth:
+                    break
+        elif flags & _IN_SCALAR:
+            m = SCALAREND.search(buf, idx)
+            if m is None:
+                idx = n
+                break
+            flags = 0
+            idx = m.start()
+            break
+        elif depth:
+            m = STRUCTURAL.search(buf, idx)
+            if m is None:
+                idx = n
+                break
+            c = buf[m.start()]
+            idx = m.end()
+            if c == ord('"'):
+                flags = _IN_STRING
+            elif c in b'[{':
+                depth += 1
+            elif depth == 1:
+                depth = 0
+                break
+            else:
+                depth -= 1
+        else:
+            c = buf[idx]
+            idx += 1
+            if c == ord('"'):
+                flags = _IN_STRING
+            elif c in b'[{':
+                depth = 1
+            elif c in b']}':
+                # An unbalanced bracket ends the value, for the scanner to
+                # report the error
+                break
+            elif c not in b' \t\n\r':
+                flags = _IN_SCALAR
+    return idx, depth << _STATE_BITS | flags
+
+# Use speedup if available
+find_value_end = c_find_value_end or py_find_value_end
+
+
+class JSONStreamDecoder(object):
+    """Incremental decoder for a stream of JSON documents.
+
+    The stream is fed in chunks of UTF-8 encoded bytes or of str with
+    ``feed()``, which may split documents anywhere.  Each complete
+    top-level value is decoded as soon as its last byte arrives, and
+    ``read_values()`` returns them in order.  Documents are separated by
+    optional whitespace; numbers and constants at the top level must be
+    followed by whitespace or by another document, or end the stream.
+    A document that fails to decode raises ``JSONDecodeError`` from
+    ``feed()`` or ``close()`` and is skipped.
+
+    ``decoder`` is the ``JSONDecoder`` used for the documents, a new
+    default one if not given.  With the C accelerator, documents are
+    parsed from the UTF-8 data without being decoded to a str first,
+    and the positions of decoding errors are byte offsets in the document.
+    """
+
+    def __init__(self, decoder=None):
+        if decoder is None:
+            decoder = JSONDecoder()
+        self.decoder = decoder
+        self._buffer = bytearray()
+        self._scanned = 0   # end of the part of the pending document
+        self._state = 0     # scanned by find_value_end(), and its state
+        self._values = collections.deque()
+        self._bom = True
+        self._closed = False
+        # The C scanner parses bytes-like objects directly
+        self._decode_bytes = (scanner.c_make_scanner is not None and
+                              isinstance(decoder.scan_once,
+                                         scanner.c_make_scanner) and
+                              type(decoder).raw_decode is
+                              JSONDecoder.raw_decode)
+
+    def feed(self, data):
+        """Feed str or UTF-8 encoded bytes-like data to the decoder."""
+        if self._closed:
+            raise ValueError("feed() after close()")
+        if isinstance(data, str):
+            data = data.encode('utf-8', 'surrogatepass')
+        self._buffer += data
+        if self._bom:
+            if len(self._buffer) < 3 and codecs.BOM_UTF8.startswith(self._buffer):
+                return
+            if self._buffer.startswith(codecs.BOM_UTF8):
+                del self._buffer[:3]
+            self._bom = False
+        self._parse(False)
+
+    def close(self):
+        """Finish decoding the stream.
+
+        A document left incomplete raises ``JSONDecodeError``.
+        """
+        if not self._closed:
+            self._closed = True
+            self._bom = False
+            self._parse(True)
+
+    def read_values(self):
+        """Return an iterator over the documents decoded so far.
+
+        The values are removed from the decoder as they are returned.
+        """
+        values = self._values
+        while values:
+            # Like XMLPullParser.read_events(), return the values decoded
+            # even if the iteration is interrupted.
+            yield values.popleft()
+
+    def _parse(self, final, _w=WHITESPACE_BYTES.match):
+        buf = self._buffer
+        start = 0
+        try:
+            while True:
+                if not self._state:
+                    start = self._scanned = _w(buf, start).end()
+                    if start == len(buf):
+                        break
+                end, self._state = find_value_end(buf, self._scanned,
+                                                  self._state)
+                if self._state:
+                    self._scanned = end
+                    if not final:
+                        break
+                    # A number or constant ends with the stream, and the
+                    # scanner reports the error of any other document.
+                    self._state = 0
+                # A document that fails to decode is skipped
+                doc_start, start = start, end
+                self._scanned = end
+                self._values.append(self._decode(buf, doc_start, end))
+        finally:
+            # Drop the consumed data
+            del buf[:start]
+            self._scanned -= start
+
+    def _decode(self, buf, start, end):
+        with memoryview(buf) as view, view[start:end] as doc:
+            if self._decode_bytes:
+                obj, idx = self.decoder.raw_decode(doc)
+            else:
+                doc = str(doc, 'utf-8', 'surrogatepass')
+                obj, idx = self.decoder.raw_decode(doc)
+            if idx != len(doc):
+                raise JSONDecodeError("Extra data", doc, idx)
+        return obj
@@ -1,5 +1,6 @@
 """Implementation of JSONEncoder
 """
+import io
 import re
 
 try:
@@ -245,10 +246,7 @@ class JSONEncoder(object):
 
         if (_one_shot and c_make_encoder is not None
                 and self.indent is None):
-            _iterencode = c_make_encoder(
-                markers, self.default, _encoder, self.indent,
-                self.key_separator, self.item_separator, self.sort_keys,
-                self.skipkeys, self.allow_nan)
+            _iterencode = self._make_c_encoder()
         else:
             _iterencode = _make_iterencode(
                 markers, self.default, _encoder, self.indent, floatstr,
@@ -256,6 +254,31 @@ class JSONEncoder(object):
                 self.skipkeys, _one_shot)
         return _iterencode(o, 0)
 
+    def _make_c_encoder(self):
+        return c_make_encoder(
+            {} if self.check_circular else None, self.default,
+            encode_basestring_ascii if self.ensure_ascii else encode_basestring,
+            self.indent, self.key_separator, self.item_separator,
+            self.sort_keys, self.skipkeys, self.allow_nan)
+
+    def _dump(self, o, fp):
+        """Write the JSON representation of o to the file object fp,
+        encoded to UTF-8 if fp is a binary file.
+
+        Used by json.dump().  Unless iterencode() is overridden, the C
+        encoder writes the output by large chunks.
+
+        """
+        binary = isinstance(fp, (io.RawIOBase, io.BufferedIOBase))
+        if (c_make_encoder is not None and self.indent is None
+                and type(self).iterencode is JSONEncoder.iterencode):
+            self._make_c_encoder()(o, 0, fp.write, binary)
+            return
+        for chunk in self.iterencode(o):
+            if binary:
+                chunk = chunk.encode('utf-8', 'surrogatepass')
+            fp.write(chunk)
+
 def _make_iterencode(markers, _default, _encoder, _indent, _floatstr,
         _key_separator, _item_separator, _sort_keys, _skipkeys, _one_shot,
         ## HACK: hand-optimized bytecode; turn globals into locals
@@ -215,3 +215,27 @@ def_op('DICT_MERGE', 164)
 def_op('DICT_UPDATE', 165)
 
 del def_op, name_op, jrel_op, jabs_op
+
+# Type-specialized forms of some of the instructions above.  The
+# interpreter substitutes them in its private copy of the bytecode of hot
+# code objects (see _PyCode_Quicken() in Objects/codeobject.c), so they
+# never appear in co_code and are not part of opmap.  They are numbered
+# using the unused opcodes, in order.
+_specialized_instructions = [
+    "BINARY_ADD_ADAPTIVE",
+    "BINARY_ADD_INT",
+    "BINARY_ADD_FLOAT",
+    "BINARY_ADD_UNICODE",
+    "INPLACE_ADD_ADAPTIVE",
+    "INPLACE_ADD_INT",
+    "INPLACE_ADD_FLOAT",
+    "INPLACE_ADD_UNICODE",
+    "BINARY_SUBSCR_ADAPTIVE",
+    "BINARY_SUBSCR_LIST_INT",
+    "BINARY_SUBSCR_TUPLE_INT",
+    "BINARY_SUBSCR_DICT",
+    "COMPARE_OP_ADAPTIVE",
+    "COMPARE_OP_INT",
+    "COMPARE_OP_FLOAT",
+    "COMPARE_OP_UNICODE",
+]
@@ -26,6 +26,7 @@ Misc variables:
 from types import FunctionType
 from copyreg import dispatch_table
 from copyreg import _extension_registry, _inverted_registry, _extension_cache
+from copyreg import _bytearray_reconstructor, _shape_slots
 from itertools import islice
 from functools import partial
 import sys
@@ -194,6 +195,11 @@ BYTEARRAY8       = b'\x96'  # push bytearray
 NEXT_BUFFER      = b'\x97'  # push next out-of-band buffer
 READONLY_BUFFER  = b'\x98'  # make top of stack readonly
 
+# Shapes, written by picklers created with shapes=True (protocol 2 and later)
+
+SHAPED_NEWOBJ    = b'\x99'  # build object from the class of the shape on stack
+SHAPED_BUILD     = b'\x9a'  # set attributes named by the shape to stack slice
+
 __all__.extend([x for x in dir() if re.match("[A-Z][A-Z0-9_]+$", x)])
 
 
@@ -405,7 +411,7 @@ def decode_long(data):
 class _Pickler:
 
     def __init__(self, file, protocol=None, *, fix_imports=True,
-                 buffer_callback=None):
+                 buffer_callback=None, shapes=False):
         """This takes a binary file for writing a pickle data stream.
 
         The optional *protocol* argument tells the pickler to use the
@@ -438,6 +444,12 @@ class _Pickler:
 
         It is an error if *buffer_callback* is not None and *protocol*
         is None or smaller than 5.
+
+        If *shapes* is true, instances of classes pickled by the default
+        __reduce_ex__() are saved as a reference to the names of their
+        attributes, written once per class, and the attribute values.
+        Python 3.9 and earlier cannot read these pickles.  It is an error
+        if *shapes* is true and *protocol* is smaller than 2.
         """
         if protocol is None:
             protocol = DEFAULT_PROTOCOL
@@ -447,7 +459,12 @@ class _Pickler:
             raise ValueError("pickle protocol must be <= %d" % HIGHEST_PROTOCOL)
         if buffer_callback is not None and protocol < 5:
             raise ValueError("buffer_callback needs protocol >= 5")
+        if shapes and protocol < 2:
+            raise ValueError("shapes needs protocol >= 2")
         self._buffer_callback = buffer_callback
+        # {class: slot names, or None for the classes whose instances are
+        # not saved as shapes} and {shape: shape} for the shapes saved
+        self._shapes = {} if shapes else None
         try:
             self._file_write = file.write
         except AttributeError:
@@ -570,6 +587,9 @@ class _Pickler:
                     self.save_global(obj)
                     return
 
+                if self._shapes is not None and self.save_shaped(obj, t):
+                    return
+
                 # Check for a __reduce_ex__ method, fall back to __reduce__
                 reduce = getattr(obj, "__reduce_ex__", None)
                 if reduce is not None:
@@ -604,6 +624,58 @@ class _Pickler:
         # This exists so a subclass can override it
         return None
 
+    def save_shaped(self, obj, t):
+        # Save obj as its shape, a (class, dict names, slot names) tuple
+        # shared by the instances with the same attributes, followed by the
+        # values of the attributes.  Return false if obj cannot be saved
+        # this way.
+        shapes = self._shapes
+        try:
+            slots = shapes[t]
+        except KeyError:
+            slots = shapes[t] = _shape_slots(obj)
+        if slots is None:
+            return False
+
+        d = getattr(obj, "__dict__", None)
+        if d:
+            if type(d) is not dict:
+                return False
+            names = tuple(d)
+            values = list(d.values())
+        else:
+            names = ()
+            values = []
+        setslots = []
+        for name in slots:
+            try:
+                value = getattr(obj, name)
+            except AttributeError:
+                continue
+            setslots.append(name)
+            values.append(value)
+
+        # Each distinct shape is saved once, and then fetched from the memo.
+        shape = (t, names, tuple(setslots))
+        try:
+            shape = shapes[shape]
+        except KeyError:
+            for name in names:
+                if type(name) is not str:
+                    return False
+            shapes[shape] = shape
+
+        save = self.save
+        write = self.write
+        save(shape)
+        write(SHAPED_NEWOBJ)
+        self.memoize(obj)
+        write(MARK)
+        for value in values:
+            save(value)
+        write(SHAPED_BUILD)
+        return True
+
     def save_pers(self, pid):
         # Save a persistent id reference
         if self.bin:
@@ -812,6 +884,13 @@ class _Pickler:
                 self.save_reduce(bytearray, (bytes(obj),), obj=obj)
             return
         n = len(obj)
+        if (n and self._buffer_callback is not None and _HAVE_PICKLE_BUFFER
+                and type(obj) is bytearray):
+            # Offer the contents to the buffer callback, to be pickled
+            # out-of-band.  (save_picklebuffer() passes bytes.)
+            self.save_reduce(_bytearray_reconstructor, (PickleBuffer(obj),),
+                             obj=obj)
+            return
         if n >= self.framer._FRAME_SIZE_TARGET:
             self._write_large_bytes(BYTEARRAY8 + pack("<Q", n), obj)
         else:
@@ -1520,6 +1599,17 @@ class _Unpickler:
         self.append(obj)
     dispatch[NEWOBJ_EX[0]] = load_newobj_ex
 
+    def load_shaped_newobj(self):
+        shape = self.stack[-1]
+        if (type(shape) is not tuple or len(shape) != 3 or
+            not isinstance(shape[0], type) or
+            type(shape[1]) is not tuple or type(shape[2]) is not tuple):
+            raise UnpicklingError("SHAPED_NEWOBJ expected a shape, got %.200s"
+                                  % type(shape).__name__)
+        cls = shape[0]
+        self.append(cls.__new__(cls))
+    dispatch[SHAPED_NEWOBJ[0]] = load_shaped_newobj
+
     def load_global(self):
         module = self.readline()[:-1].decode("utf-8")
         name = self.readline()[:-1].decode("utf-8")
@@ -1730,6 +1820,28 @@ class _Unpickler:
                 setattr(inst, k, v)
     dispatch[BUILD[0]] = load_build
 
+    def load_shaped_build(self):
+        values = self.pop_mark()
+        stack = self.stack
+        inst = stack.pop()
+        cls, names, slots = stack[-1]
+        n = len(names)
+        if len(values) != n + len(slots):
+            raise UnpicklingError("SHAPED_BUILD got %d values for %d "
+                                  "attributes" % (len(values), n + len(slots)))
+        if n:
+            inst_dict = inst.__dict__
+            intern = sys.intern
+            for k, v in zip(names, values):
+                if type(k) is str:
+                    inst_dict[intern(k)] = v
+                else:
+                    inst_dict[k] = v
+        for k, v in zip(slots, values[n:]):
+            setattr(inst, k, v)
+        stack[-1] = inst
+    dispatch[SHAPED_BUILD[0]] = load_shaped_build
+
     def load_mark(self):
         self.metastack.append(self.stack)
         self.stack = []
@@ -1744,14 +1856,16 @@ class _Unpickler:
 
 # Shorthands
 
-def _dump(obj, file, protocol=None, *, fix_imports=True, buffer_callback=None):
+def _dump(obj, file, protocol=None, *, fix_imports=True, buffer_callback=None,
+          shapes=False):
     _Pickler(file, protocol, fix_imports=fix_imports,
-             buffer_callback=buffer_callback).dump(obj)
+             buffer_callback=buffer_callback, shapes=shapes).dump(obj)
 
-def _dumps(obj, protocol=None, *, fix_imports=True, buffer_callback=None):
+def _dumps(obj, protocol=None, *, fix_imports=True, buffer_callback=None,
+           shapes=False):
     f = io.BytesIO()
     _Pickler(f, protocol, fix_imports=fix_imports,
-             buffer_callback=buffer_callback).dump(obj)
+             buffer_callback=buffer_callback, shapes=shapes).dump(obj)
     res = f.getvalue()
     assert isinstance(res, bytes_types)
     return res
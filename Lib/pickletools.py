@@ -2118,6 +2118,37 @@ opcodes = [
       cls.__new__(cls, *args, *kwargs) is  pushed back  onto the stack.
       """),
 
+    I(name='SHAPED_NEWOBJ',
+      code='\x99',
+      arg=None,
+      stack_before=[anyobject],
+      stack_after=[anyobject, anyobject],
+      proto=2,
+      doc="""Build an object instance from a shape.
+
+      The stack top is a shape, a (cls, dictnames, slotnames) tuple, as
+      written by picklers created with shapes=True.  It is left on the
+      stack for SHAPED_BUILD, and the value returned by cls.__new__(cls)
+      is pushed onto the stack.
+      """),
+
+    I(name='SHAPED_BUILD',
+      code='\x9a',
+      arg=None,
+      stack_before=[anyobject, anyobject, markobject, stackslice],
+      stack_after=[anyobject],
+      proto=2,
+      doc="""Finish building an object instance from a shape.
+
+      Stack before: ... shape anyobject markobject stackslice
+      Stack after:  ... anyobject
+
+      The stack slice holds the values of the attributes named by the
+      shape, those of the __dict__ first and then those of the slots.  The
+      items of anyobject.__dict__ are set, with the names interned, then
+      the slots are set with setattr().
+      """),
+
     # Machine control.
 
     I(name='PROTO',
@@ -116,6 +116,8 @@ A, L, and U are mutually exclusive.
     X  VERBOSE     Ignore whitespace and comments for nicer looking RE's.
     U  UNICODE     For compatibility only. Ignored for string patterns (it
                    is the default), and forbidden for bytes patterns.
+    DFA            Match with a finite automaton, in linear time.  The
+                   pattern cannot contain backreferences or lookarounds.
 
 This module also defines an exception 'error'.
 
@@ -137,7 +139,7 @@ __all__ = [
     "findall", "finditer", "compile", "purge", "template", "escape",
     "error", "Pattern", "Match", "A", "I", "L", "M", "S", "X", "U",
     "ASCII", "IGNORECASE", "LOCALE", "MULTILINE", "DOTALL", "VERBOSE",
-    "UNICODE",
+    "UNICODE", "DFA",
 ]
 
 __version__ = "2.2.1"
@@ -150,6 +152,7 @@ class RegexFlag(enum.IntFlag):
     MULTILINE = M = sre_compile.SRE_FLAG_MULTILINE # make anchors look for newline
     DOTALL = S = sre_compile.SRE_FLAG_DOTALL # make dot match newline
     VERBOSE = X = sre_compile.SRE_FLAG_VERBOSE # ignore whitespace and comments
+    DFA = sre_compile.SRE_FLAG_DFA # match with a finite automaton
     # sre extensions (experimental, don't rely on these)
     TEMPLATE = T = sre_compile.SRE_FLAG_TEMPLATE # disable backtracking
     DEBUG = sre_compile.SRE_FLAG_DEBUG # dump pattern after compilation
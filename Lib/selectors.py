@@ -485,6 +485,134 @@ if hasattr(select, 'epoll'):
             super().close()
 
 
+if hasattr(select, 'io_uring'):
+
+    class IoUringSelector(_BaseSelectorImpl):
+        """io_uring-based selector.
+
+        A one-shot poll operation is queued for each registered file
+        descriptor, and queued again each time it completes.  The selector
+        also runs the completion callbacks of the other io_uring operations
+        queued with _queue_op(), which event loops use.
+        """
+
+        def __init__(self, entries=256):
+            super().__init__()
+            self._ring = select.io_uring(entries)
+            # tag of the poll operation queued for each fd, and reverse
+            self._fd_to_tag = {}
+            self._tag_to_fd = {}
+            # tag -> callback of the other operations in progress
+            self._op_callbacks = {}
+
+        def fileno(self):
+            return self._ring.fileno()
+
+        def _poll_add(self, fd, events):
+            poller_events = 0
+            if events & EVENT_READ:
+                poller_events |= select.POLLIN
+            if events & EVENT_WRITE:
+                poller_events |= select.POLLOUT
+            tag = self._ring.poll_add(fd, poller_events)
+            self._fd_to_tag[fd] = tag
+            self._tag_to_fd[tag] = fd
+
+        def _poll_cancel(self, fd):
+            tag = self._fd_to_tag.pop(fd, None)
+            if tag is not None:
+                # The completion of the cancelled operation is ignored
+                del self._tag_to_fd[tag]
+                self._ring.cancel(tag)
+
+        def register(self, fileobj, events, data=None):
+            key = super().register(fileobj, events, data)
+            try:
+                self._poll_add(key.fd, events)
+            except:
+                super().unregister(fileobj)
+                raise
+            return key
+
+        def unregister(self, fileobj):
+            key = super().unregister(fileobj)
+            self._poll_cancel(key.fd)
+            return key
+
+        def modify(self, fileobj, events, data=None):
+            try:
+                key = self._fd_to_key[self._fileobj_lookup(fileobj)]
+            except KeyError:
+                raise KeyError(f"{fileobj!r} is not registered") from None
+
+            changed = False
+            if events != key.events:
+                try:
+                    self._poll_cancel(key.fd)
+                    self._poll_add(key.fd, events)
+                except:
+                    self.unregister(fileobj)
+                    raise
+                changed = True
+            if data != key.data:
+                changed = True
+
+            if changed:
+                key = key._replace(events=events, data=data)
+                self._fd_to_key[key.fd] = key
+            return key
+
+        def _queue_op(self, callback, method, *args):
+            """Queue the io_uring operation method(*args).
+
+            callback(result) is called by select() when the operation
+            completes.  Return the tag of the operation.
+            """
+            tag = getattr(self._ring, method)(*args)
+            self._op_callbacks[tag] = callback
+            return tag
+
+        def _cancel_op(self, tag):
+            if tag in self._op_callbacks:
+                self._ring.cancel(tag)
+
+        def select(self, timeout=None):
+            if timeout is not None and timeout <= 0:
+                timeout = 0
+            ready = []
+            try:
+                completions = self._ring.wait(timeout)
+            except InterruptedError:
+                return ready
+            for tag, result, flags in completions:
+                fd = self._tag_to_fd.pop(tag, None)
+                if fd is None:
+                    callback = self._op_callbacks.pop(tag, None)
+                    if callback is not None:
+                        callback(result)
+                    continue
+                del self._fd_to_tag[fd]
+                key = self._key_from_fd(fd)
+                if result < 0:
+                    # The fd cannot be polled, for example it was closed:
+                    # report it ready so that its owner finds out.
+                    ready.append((key, key.events))
+                    continue
+                events = 0
+                if result & ~select.POLLIN:
+                    events |= EVENT_WRITE
+                if result & ~select.POLLOUT:
+                    events |= EVENT_READ
+                self._poll_add(fd, key.events)
+                ready.append((key, events & key.events))
+            return ready
+
+        def close(self):
+            self._ring.close()
+            self._op_callbacks.clear()
+            super().close()
+
+
 if hasattr(select, 'devpoll'):
 
     class DevpollSelector(_PollLikeSelector):
@@ -10,6 +10,7 @@ import stat
 import fnmatch
 import collections
 import errno
+import io
 
 try:
     import zlib
@@ -51,6 +52,8 @@ elif _WINDOWS:
 
 COPY_BUFSIZE = 1024 * 1024 if _WINDOWS else 64 * 1024
 _USE_CP_SENDFILE = hasattr(os, "sendfile") and sys.platform.startswith("linux")
+_USE_CP_COPY_FILE_RANGE = hasattr(os, "copy_file_range")
+_USE_CP_SPLICE = hasattr(os, "splice")
 _HAS_FCOPYFILE = posix and hasattr(posix, "_fcopyfile")  # macOS
 
 __all__ = ["copyfileobj", "copyfile", "copymode", "copystat", "copy", "copy2",
@@ -113,9 +116,9 @@ def _fastcopy_sendfile(fsrc, fdst):
     high-performance sendfile(2) syscall.
     This should work on Linux >= 2.6.33 only.
     """
-    # Note: copyfileobj() is left alone in order to not introduce any
-    # unexpected breakage. Possible risks by using zero-copy calls
-    # in copyfileobj() are:
+    # Note: copyfileobj() only uses zero-copy calls for the binary file
+    # objects of the io module (see _fastcopy_fileobj()). Possible risks
+    # by using them with other objects are:
     # - fdst cannot be open in "a"(ppend) mode
     # - fsrc and fdst may be open in "t"(ext) mode
     # - fsrc may be a BufferedReader (which hides unread data in a buffer),
@@ -172,6 +175,113 @@ def _fastcopy_sendfile(fsrc, fdst):
                 break  # EOF
             offset += sent
 
+def _fastcopy_copy_file_range(fsrc, fdst):
+    """Copy data from one regular file to another by using
+    copy_file_range(2), which lets the filesystem share the blocks or
+    copy them on the server side.
+    This should work on Linux >= 4.5, across filesystems on Linux >= 5.3.
+    """
+    global _USE_CP_COPY_FILE_RANGE
+    try:
+        infd = fsrc.fileno()
+        outfd = fdst.fileno()
+    except Exception as err:
+        raise _GiveupOnFastCopy(err)  # not a regular file
+
+    # Truncate to 1GiB to avoid OverflowError on 32-bit architectures,
+    # see bpo-38319.
+    blocksize = min(sys.maxsize, 2 ** 30)
+    copied = 0
+    while True:
+        try:
+            n = os.copy_file_range(infd, outfd, blocksize)
+        except OSError as err:
+            err.filename = fsrc.name
+            err.filename2 = fdst.name
+
+            if err.errno == errno.ENOSYS:
+                _USE_CP_COPY_FILE_RANGE = False
+                raise _GiveupOnFastCopy(err)
+
+            if err.errno == errno.ENOSPC:  # filesystem is full
+                raise err from None
+
+            # Give up on first call, e.g. EXDEV for a copy across
+            # filesystems on Linux < 5.3.
+            if copied == 0:
+                raise _GiveupOnFastCopy(err)
+
+            raise err
+        else:
+            if n == 0:
+                # copy_file_range() copies nothing from some special files
+                # (e.g. in /proc) which report a size of 0.
+                if copied == 0:
+                    raise _GiveupOnFastCopy()
+                break  # EOF
+            copied += n
+
+def _fastcopy_fileobj(fsrc, fdst, length):
+    """Copy data from file object fsrc to file object fdst in the kernel,
+    by using copy_file_range(2) between regular files and splice(2) from
+    or to a pipe.
+    """
+    # Only the binary file objects of the io module are handled: their
+    # buffers can be drained and their positions synchronized with their
+    # file descriptors (see the notes in _fastcopy_sendfile()).
+    if (type(fsrc) not in (io.FileIO, io.BufferedReader, io.BufferedRandom)
+            or type(fdst) not in (io.FileIO, io.BufferedWriter,
+                                  io.BufferedRandom)
+            or 'a' in fdst.mode):
+        raise _GiveupOnFastCopy()
+    try:
+        infd = fsrc.fileno()
+        outfd = fdst.fileno()
+        inmode = os.fstat(infd).st_mode
+        outmode = os.fstat(outfd).st_mode
+    except Exception as err:
+        raise _GiveupOnFastCopy(err)
+    if (_USE_CP_COPY_FILE_RANGE
+            and stat.S_ISREG(inmode) and stat.S_ISREG(outmode)):
+        copy = os.copy_file_range
+        blocksize = min(sys.maxsize, 2 ** 30)
+    elif _USE_CP_SPLICE and (stat.S_ISFIFO(inmode) or stat.S_ISFIFO(outmode)):
+        copy = os.splice
+        blocksize = length
+    else:
+        raise _GiveupOnFastCopy()
+
+    # The data read ahead into the buffer of fsrc goes first.
+    if type(fsrc) is not io.FileIO:
+        buffered = fsrc.peek()
+        if not buffered:
+            return  # EOF
+        fdst.write(fsrc.read(len(buffered)))
+    fdst.flush()
+
+    copied = 0
+    try:
+        while True:
+            try:
+                n = copy(infd, outfd, blocksize)
+            except OSError as err:
+                # Give up on first call and if no data was copied, e.g.
+                # EXDEV or EINVAL if the filesystems do not support it.
+                if copied == 0 and err.errno != errno.ENOSPC:
+                    raise _GiveupOnFastCopy(err)
+                raise
+            if n == 0:
+                if copied == 0:
+                    # Maybe a special file, let read() find out.
+                    raise _GiveupOnFastCopy()
+                break  # EOF
+            copied += n
+    finally:
+        # The buffered objects keep their own idea of the position.
+        for f, fd in ((fsrc, infd), (fdst, outfd)):
+            if copied and type(f) is not io.FileIO and f.seekable():
+                f.seek(os.lseek(fd, 0, os.SEEK_CUR))
+
 def _copyfileobj_readinto(fsrc, fdst, length=COPY_BUFSIZE):
     """readinto()/memoryview() based variant of copyfileobj().
     *fsrc* must support readinto() method and both files must be
@@ -193,9 +303,15 @@ def _copyfileobj_readinto(fsrc, fdst, length=COPY_BUFSIZE):
 
 def copyfileobj(fsrc, fdst, length=0):
     """copy data from file-like object fsrc to file-like object fdst"""
-    # Localize variable access to minimize overhead.
     if not length:
         length = COPY_BUFSIZE
+    # Linux
+    if _USE_CP_COPY_FILE_RANGE or _USE_CP_SPLICE:
+        try:
+            return _fastcopy_fileobj(fsrc, fdst, length)
+        except _GiveupOnFastCopy:
+            pass
+    # Localize variable access to minimize overhead.
     fsrc_read = fsrc.read
     fdst_write = fdst.write
     while True:
@@ -269,6 +385,12 @@ def copyfile(src, dst, *, follow_symlinks=True):
             # Linux
             elif _USE_CP_SENDFILE:
                 try:
+                    if _USE_CP_COPY_FILE_RANGE:
+                        try:
+                            _fastcopy_copy_file_range(fsrc, fdst)
+                            return dst
+                        except _GiveupOnFastCopy:
+                            pass
                     _fastcopy_sendfile(fsrc, fdst)
                     return dst
                 except _GiveupOnFastCopy:
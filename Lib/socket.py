@@ -51,7 +51,7 @@ the setsockopt() and getsockopt() methods.
 import _socket
 from _socket import *
 
-import os, sys, io, selectors
+import os, sys, io, selectors, stat
 from enum import IntEnum, IntFlag
 
 try:
@@ -351,9 +351,12 @@ class socket(_socket.socket):
             except (AttributeError, io.UnsupportedOperation) as err:
                 raise _GiveupOnSendfile(err)  # not a regular file
             try:
-                fsize = os.fstat(fileno).st_size
+                st = os.fstat(fileno)
             except OSError as err:
                 raise _GiveupOnSendfile(err)  # not a regular file
+            if stat.S_ISFIFO(st.st_mode):
+                return self._sendfile_use_splice(file, fileno, offset, count)
+            fsize = st.st_size
             if not fsize:
                 return 0  # empty file
             # Truncate to 1GiB to avoid OverflowError, see bpo-38319.
@@ -412,6 +415,78 @@ class socket(_socket.socket):
             raise _GiveupOnSendfile(
                 "os.sendfile() not available on this platform")
 
+    if hasattr(os, 'splice'):
+
+        def _sendfile_use_splice(self, file, fileno, offset, count):
+            # sendfile() does not read from pipes, splice() moves the data
+            # from the pipe to the socket without copying it.
+            if offset:
+                raise _GiveupOnSendfile("cannot seek a pipe")
+            sockno = self.fileno()
+            timeout = self.gettimeout()
+            if timeout == 0:
+                raise ValueError("non-blocking sockets are not supported")
+            total_sent = 0
+            # The data read ahead into the buffer of a BufferedReader goes
+            # first.
+            if isinstance(file, io.BufferedReader):
+                buffered = file.peek()
+                if count:
+                    buffered = buffered[:count]
+                if not buffered:
+                    return 0  # EOF
+                self.sendall(file.read(len(buffered)))
+                total_sent += len(buffered)
+            if hasattr(selectors, 'PollSelector'):
+                selector = selectors.PollSelector()
+            else:
+                selector = selectors.SelectSelector()
+            selector.register(sockno, selectors.EVENT_WRITE)
+
+            # localize variable access to minimize overhead
+            selector_select = selector.select
+            os_splice = os.splice
+            blocksize = 0x10000  # the default capacity of a pipe
+            spliced = 0
+            try:
+                while True:
+                    if timeout and not selector_select(timeout):
+                        raise _socket.timeout('timed out')
+                    if count:
+                        blocksize = min(blocksize, count - total_sent)
+                        if blocksize <= 0:
+                            break
+                    try:
+                        sent = os_splice(fileno, sockno, blocksize,
+                                         flags=os.SPLICE_F_MOVE)
+                    except BlockingIOError:
+                        if not timeout:
+                            # Block until the socket is ready to send some
+                            # data; avoids hogging CPU resources.
+                            selector_select()
+                        continue
+                    except OSError as err:
+                        if spliced:
+                            raise err from None
+                        # Nothing was spliced from the pipe yet, plain
+                        # send() can take over.
+                        if not total_sent:
+                            raise _GiveupOnSendfile(err)
+                        return total_sent + self._sendfile_use_send(
+                            file, 0, count and count - total_sent)
+                    else:
+                        if sent == 0:
+                            break  # EOF
+                        spliced += sent
+                        total_sent += sent
+                return total_sent
+            finally:
+                selector.close()
+    else:
+        def _sendfile_use_splice(self, file, fileno, offset, count):
+            raise _GiveupOnSendfile(
+                "os.splice() not available on this platform")
+
     def _sendfile_use_send(self, file, offset=0, count=None):
         self._check_sendfile_params(file, offset, count)
         if self.gettimeout() == 0:
@@ -445,7 +520,9 @@ class socket(_socket.socket):
                             break
             return total_sent
         finally:
-            if total_sent > 0 and hasattr(file, 'seek'):
+            # Pipes cannot be rewound to the data which was not sent.
+            if (total_sent > 0 and hasattr(file, 'seek')
+                    and getattr(file, 'seekable', lambda: True)()):
                 file.seek(offset + total_sent)
 
     def _check_sendfile_params(self, file, offset, count):
@@ -468,8 +545,9 @@ class socket(_socket.socket):
         os.sendfile() and return the total number of bytes which
         were sent.
         *file* must be a regular file object opened in binary mode.
-        If os.sendfile() is not available (e.g. Windows) or file is
-        not a regular file socket.send() will be used instead.
+        If *file* is a pipe, os.splice() is used instead of os.sendfile().
+        If neither is available (e.g. Windows) or file is not a regular
+        file or a pipe socket.send() will be used instead.
         *offset* tells from where to start reading the file.
         If specified, *count* is the total number of bytes to transmit
         as opposed to sending the file until EOF is reached.
@@ -533,10 +533,153 @@ def _get_charset_prefix(pattern, flags):
         return charset
     return None
 
+_MAXREQUIRED = 64
+
+def _get_sequence(pattern, items):
+    # flatten the groups which do not change the flags into the
+    # sequence of items of the pattern
+    for op, av in pattern.data:
+        if op is SUBPATTERN and not av[1] and not av[2]:
+            _get_sequence(av[3], items)
+        else:
+            items.append((op, av))
+    return items
+
+def _category_has(category, ch, flags):
+    # check if a category contains an ASCII character which is not a
+    # word character.  returns None if not known
+    if ch >= 128 or ch == 95 or chr(ch).isalnum():
+        return None
+    if category is CATEGORY_DIGIT:
+        return False
+    if category is CATEGORY_NOT_DIGIT:
+        return True
+    if category is CATEGORY_WORD or category is CATEGORY_NOT_WORD:
+        if flags & SRE_FLAG_LOCALE:
+            return None
+        return category is CATEGORY_NOT_WORD
+    if category is CATEGORY_SPACE or category is CATEGORY_NOT_SPACE:
+        if ch in b' \t\n\r\f\v':
+            has = True
+        elif 0x1c <= ch <= 0x1f:
+            return None # unicode whitespace
+        else:
+            has = False
+        return has == (category is CATEGORY_SPACE)
+    if category is CATEGORY_LINEBREAK or category is CATEGORY_NOT_LINEBREAK:
+        if ch == 10:
+            has = True
+        elif ch in b'\v\f\r\x1c\x1d\x1e':
+            return None # unicode line breaks
+        else:
+            has = False
+        return has == (category is CATEGORY_LINEBREAK)
+    return None
+
+def _charset_has(charset, ch, flags):
+    # check if a character set contains a character.  returns None if
+    # not known
+    negate = False
+    has = False
+    for op, av in charset:
+        if op is NEGATE:
+            negate = True
+            continue
+        if op is LITERAL:
+            r = av == ch
+        elif op is RANGE:
+            r = av[0] <= ch <= av[1]
+        elif op is CATEGORY:
+            r = _category_has(av, ch, flags)
+        else:
+            r = None
+        if r:
+            has = True
+            break
+        if r is None:
+            has = None
+    if has is None:
+        return None
+    return has != negate
+
+def _cannot_match(items, ch, flags):
+    # check that a sequence of items cannot match a given character,
+    # for characters which are not cased
+    for op, av in items:
+        if op is LITERAL:
+            if av == ch:
+                return False
+        elif op is NOT_LITERAL:
+            if av != ch:
+                return False
+        elif op is ANY:
+            if ch != 10 or flags & SRE_FLAG_DOTALL:
+                return False
+        elif op is IN:
+            if _charset_has(av, ch, flags) is not False:
+                return False
+        elif op in _REPEATING_CODES:
+            if not _cannot_match(av[2].data, ch, flags):
+                return False
+        elif op is SUBPATTERN:
+            if av[1] or av[2] or not _cannot_match(av[3].data, ch, flags):
+                return False
+        elif op is BRANCH:
+            for p in av[1]:
+                if not _cannot_match(p.data, ch, flags):
+                    return False
+        elif op is AT or op in _ASSERT_CODES:
+            pass # zero-width
+        else:
+            return False
+    return True
+
+def _get_stop_candidates(items, stops):
+    # characters excluded by the items, which the items may not match
+    for op, av in items:
+        if op is NOT_LITERAL:
+            stops.append(av)
+        elif op is IN:
+            if len(av) == 2 and av[0][0] is NEGATE and av[1][0] is LITERAL:
+                stops.append(av[1][1])
+        elif op in _REPEATING_CODES:
+            _get_stop_candidates(av[2].data, stops)
+    return stops
+
+def _get_required_literal(pattern, flags):
+    # look for the longest run of literal characters which each match
+    # must contain.  returns the literal, the maximal width of the part
+    # of the pattern before it, and a character which that part cannot
+    # match (or MAXCODE)
+    iscased = _get_iscased(flags)
+    items = _get_sequence(pattern, [])
+    best = start = 0
+    literal = []
+    for i, (op, av) in enumerate(items + [(None, None)]):
+        if op is LITERAL and not (iscased and iscased(av)):
+            continue
+        if i - start > len(literal):
+            best = start
+            literal = [av for op, av in items[start:i]]
+        start = i + 1
+    if not literal:
+        return None
+    before = items[:best]
+    hi = sre_parse.SubPattern(pattern.state, before).getwidth()[1]
+    stop = MAXCODE
+    for ch in _get_stop_candidates(before, [10]):
+        if iscased and iscased(ch):
+            continue
+        if _cannot_match(before, ch, flags):
+            stop = ch
+            break
+    return literal[:_MAXREQUIRED], hi, stop
+
 def _compile_info(code, pattern, flags):
     # internal: compile an info block.  in the current version,
-    # this contains min/max pattern width, and an optional literal
-    # prefix or a character map
+    # this contains min/max pattern width, an optional literal
+    # prefix or a character map, and an optional literal which
+    # any match contains
     lo, hi = pattern.getwidth()
     if hi > MAXCODE:
         hi = MAXCODE
@@ -547,12 +690,15 @@ def _compile_info(code, pattern, flags):
     prefix = []
     prefix_skip = 0
     charset = [] # not used
+    required = None
     if not (flags & SRE_FLAG_IGNORECASE and flags & SRE_FLAG_LOCALE):
         # look for literal prefix
         prefix, prefix_skip, got_all = _get_literal_prefix(pattern, flags)
-        # if no prefix, look for charset prefix
+        # if no prefix, look for charset prefix, and for a literal
+        # further in the pattern
         if not prefix:
             charset = _get_charset_prefix(pattern, flags)
+            required = _get_required_literal(pattern, flags)
 ##     if prefix:
 ##         print("*** PREFIX", prefix, prefix_skip)
 ##     if charset:
@@ -569,6 +715,8 @@ def _compile_info(code, pattern, flags):
             mask = mask | SRE_INFO_LITERAL
     elif charset:
         mask = mask | SRE_INFO_CHARSET
+    if required:
+        mask = mask | SRE_INFO_REQUIRED
     emit(mask)
     # pattern length
     if lo < MAXCODE:
@@ -577,6 +725,13 @@ def _compile_info(code, pattern, flags):
         emit(MAXCODE)
         prefix = prefix[:MAXCODE]
     emit(min(hi, MAXCODE))
+    # add required literal
+    if required:
+        literal, before_hi, stop = required
+        emit(len(literal)) # length
+        emit(min(before_hi, MAXCODE)) # maximal offset
+        emit(stop)
+        code.extend(literal)
     # add literal prefix
     if prefix:
         emit(len(prefix)) # length
@@ -731,6 +886,19 @@ def dis(code):
                     max = 'MAXREPEAT'
                 print_(op, skip, bin(flags), min, max, to=i+skip)
                 start = i+4
+                if flags & SRE_INFO_REQUIRED:
+                    required_len, offset, stop = code[i+4: i+7]
+                    if offset == MAXREPEAT:
+                        offset = 'MAXREPEAT'
+                    print_2('  required_offset', offset)
+                    if stop != MAXCODE:
+                        print_2('  required_stop', '%#02x' % stop)
+                    start = i + 7
+                    required = code[start: start+required_len]
+                    print_2('  required',
+                            '[%s]' % ', '.join('%#02x' % x for x in required),
+                            '(%r)' % ''.join(map(chr, required)))
+                    start += required_len
                 if flags & SRE_INFO_PREFIX:
                     prefix_len, prefix_skip = code[i+4: i+6]
                     print_2('  prefix_skip', prefix_skip)
@@ -756,6 +924,23 @@ def dis(code):
     dis_(0, len(code))
 
 
+def _check_dfa(pattern, flags):
+    # internal: check that the finite automaton can match the pattern
+    if flags & SRE_FLAG_LOCALE:
+        raise error("cannot use LOCALE flag with DFA flag")
+    for op, av in pattern:
+        if op in (GROUPREF, GROUPREF_EXISTS):
+            raise error("cannot use group references with DFA flag")
+        elif op in _ASSERT_CODES:
+            raise error("cannot use lookaround assertions with DFA flag")
+        elif op is SUBPATTERN:
+            _check_dfa(av[3], _combine_flags(flags, av[1], av[2]))
+        elif op is BRANCH:
+            for item in av[1]:
+                _check_dfa(item, flags)
+        elif op in _REPEATING_CODES:
+            _check_dfa(av[2], flags)
+
 def compile(p, flags=0):
     # internal: convert pattern list to internal format
 
@@ -765,6 +950,9 @@ def compile(p, flags=0):
     else:
         pattern = None
 
+    if (flags | p.state.flags) & SRE_FLAG_DFA:
+        _check_dfa(p, flags | p.state.flags)
+
     code = _code(p, flags)
 
     if flags & SRE_FLAG_DEBUG:
@@ -13,7 +13,7 @@
 
 # update when constants are added or removed
 
-MAGIC = 20171005
+MAGIC = 20200615
 
 from _sre import MAXREPEAT, MAXGROUPS
 
@@ -208,11 +208,13 @@ SRE_FLAG_UNICODE = 32 # use unicode "locale"
 SRE_FLAG_VERBOSE = 64 # ignore whitespace and comments
 SRE_FLAG_DEBUG = 128 # debugging
 SRE_FLAG_ASCII = 256 # use ascii "locale"
+SRE_FLAG_DFA = 512 # match with a finite automaton
 
 # flags for INFO primitive
 SRE_INFO_PREFIX = 1 # has prefix
 SRE_INFO_LITERAL = 2 # entire pattern is literal (given by prefix)
 SRE_INFO_CHARSET = 4 # pattern starts with character from given set
+SRE_INFO_REQUIRED = 8 # pattern contains given literal
 
 if __name__ == "__main__":
     def dump(f, d, prefix):
@@ -251,9 +253,11 @@ if __name__ == "__main__":
         f.write("#define SRE_FLAG_VERBOSE %d\n" % SRE_FLAG_VERBOSE)
         f.write("#define SRE_FLAG_DEBUG %d\n" % SRE_FLAG_DEBUG)
         f.write("#define SRE_FLAG_ASCII %d\n" % SRE_FLAG_ASCII)
+        f.write("#define SRE_FLAG_DFA %d\n" % SRE_FLAG_DFA)
 
         f.write("#define SRE_INFO_PREFIX %d\n" % SRE_INFO_PREFIX)
         f.write("#define SRE_INFO_LITERAL %d\n" % SRE_INFO_LITERAL)
         f.write("#define SRE_INFO_CHARSET %d\n" % SRE_INFO_CHARSET)
+        f.write("#define SRE_INFO_REQUIRED %d\n" % SRE_INFO_REQUIRED)
 
     print("done")
@@ -1212,6 +1212,10 @@ class AbstractUnpickleTests(unittest.TestCase):
             b'\x93',                    # STACK_GLOBAL
             b'Vlist\n\x93',
             b'\x94',                    # MEMOIZE
+            b'\x99',                    # SHAPED_NEWOBJ
+            b'\x9a',                    # SHAPED_BUILD
+            b'(\x9a',
+            b'N(\x9a',
         ]
         for p in badpickles:
             self.check_unpickling_error(self.bad_stack_errors, p)
@@ -1255,6 +1259,18 @@ class AbstractUnpickleTests(unittest.TestCase):
         for p in badpickles:
             self.check_unpickling_error(self.bad_stack_errors, p)
 
+    def test_bad_shape(self):
+        badpickles = [
+            b'\x80\x02N\x99.',                     # not a tuple
+            b'\x80\x02NNN\x87\x99.',               # not a class
+            b'\x80\x02cbuiltins\nobject\nNN\x87\x99.',
+            b'\x80\x02cbuiltins\nobject\n)N\x87\x99.',
+            b'\x80\x02c__main__\nH\n))\x87\x99(N\x9a.', # too many values
+            b'\x80\x02c__main__\nH\nX\x01\x00\x00\x00a\x85)\x87\x99(\x9a.',
+        ]
+        for p in badpickles:
+            self.check_unpickling_error(pickle.UnpicklingError, p)
+
     def test_truncated_data(self):
         self.check_unpickling_error(EOFError, b'')
         self.check_unpickling_error(EOFError, b'N')
@@ -2133,6 +2149,116 @@ class AbstractPickleTests(unittest.TestCase):
         y = self.loads(s)
         self.assert_is_copy(x, y)
 
+    def test_shapes(self):
+        x = C()
+        x.spam = 1
+        x.eggs = [x]
+        y = C()
+        y.spam = 'two'
+        y.eggs = x
+        objs = [x, y, C(), H()]
+        for proto in range(2, pickle.HIGHEST_PROTOCOL + 1):
+            with self.subTest(proto=proto):
+                s = self.dumps(objs, proto, shapes=True)
+                self.assertEqual(count_opcode(pickle.SHAPED_NEWOBJ, s), 4)
+                self.assertEqual(count_opcode(pickle.SHAPED_BUILD, s), 4)
+                self.assertFalse(opcode_in_pickle(pickle.BUILD, s))
+                # The names of the attributes are written once.
+                self.assertEqual(s.count(b'spam'), 1)
+                z = self.loads(s)
+                self.assertEqual([type(o) for o in z], [C, C, C, H])
+                self.assertEqual(z[0].spam, 1)
+                self.assertIs(z[0].eggs[0], z[0])
+                self.assertEqual(z[1].spam, 'two')
+                self.assertIs(z[1].eggs, z[0])
+                self.assertEqual(z[2].__dict__, {})
+                self.assertEqual(z[3].__dict__, {})
+                # The names are interned.
+                for name in z[1].__dict__:
+                    self.assertIs(name, sys.intern(name))
+        for proto in 0, 1:
+            with self.subTest(proto=proto):
+                self.assertRaises(ValueError, self.dumps, objs, proto,
+                                  shapes=True)
+
+    def test_shapes_change(self):
+        # Instances of a class with other attributes get their own shape.
+        objs = []
+        for names in ['ab', 'ab', 'ba', 'a', '', 'abc', 'ab']:
+            x = C()
+            for name in names:
+                setattr(x, name, name.upper())
+            objs.append(x)
+        for proto in range(2, pickle.HIGHEST_PROTOCOL + 1):
+            with self.subTest(proto=proto):
+                s = self.dumps(objs, proto, shapes=True)
+                self.assertEqual(count_opcode(pickle.SHAPED_NEWOBJ, s), 7)
+                z = self.loads(s)
+                for x, y in zip(objs, z):
+                    self.assertIs(type(y), C)
+                    self.assertEqual(list(y.__dict__.items()),
+                                     list(x.__dict__.items()))
+
+    def test_shapes_alternate(self):
+        # Each shape is written once, even if the instances alternate
+        # between shapes.
+        objs = []
+        for i in range(100):
+            x = C()
+            x.spam = i
+            if i % 2:
+                x.eggs = -i
+            objs.append(x)
+        for proto in range(2, pickle.HIGHEST_PROTOCOL + 1):
+            with self.subTest(proto=proto):
+                s = self.dumps(objs, proto, shapes=True)
+                self.assertEqual(s.count(b'spam'), 1)
+                self.assertEqual(s.count(b'eggs'), 1)
+                self.assertLess(len(s), len(self.dumps(objs, proto)))
+                z = self.loads(s)
+                for x, y in zip(objs, z):
+                    self.assertEqual(y.__dict__, x.__dict__)
+
+    def test_shapes_slots(self):
+        objs = [ShapedSlots(1, 2), ShapedSlots(3), ShapedSlots(),
+                ShapedSlots(4, 5, c=6), ShapedSlots(7, 8)]
+        objs[2].a = objs
+        for proto in range(2, pickle.HIGHEST_PROTOCOL + 1):
+            with self.subTest(proto=proto):
+                s = self.dumps(objs, proto, shapes=True)
+                self.assertEqual(count_opcode(pickle.SHAPED_NEWOBJ, s), 5)
+                z = self.loads(s)
+                self.assertIs(z[2].a, z)
+                del objs[2].a, z[2].a
+                self.assertEqual(z, objs)
+                objs[2].a = objs
+
+    def test_shapes_fallback(self):
+        # Instances of classes which customize their pickling are pickled
+        # as without shapes.
+        x = C()
+        x.__dict__[1] = 2
+        objs = [MyList([1, 2]), SlotList([3]),
+                SimpleNewObj.__new__(SimpleNewObj, 4),
+                ComplexNewObj.__new__(ComplexNewObj, 5), x]
+        objs[1].foo = 6
+        for proto in range(2, pickle.HIGHEST_PROTOCOL + 1):
+            with self.subTest(proto=proto):
+                s = self.dumps(objs, proto, shapes=True)
+                self.assertFalse(opcode_in_pickle(pickle.SHAPED_NEWOBJ, s))
+                z = self.loads(s)
+                for x, y in zip(objs, z):
+                    self.assert_is_copy(x, y)
+
+                x = REX_one()
+                s = self.dumps(x, proto, shapes=True)
+                self.assertEqual(x._reduce_called, 1)
+                self.assertFalse(opcode_in_pickle(pickle.SHAPED_NEWOBJ, s))
+
+                s = self.dumps(BBB(), proto, shapes=True)
+                self.assertFalse(opcode_in_pickle(pickle.SHAPED_NEWOBJ, s))
+                self.assertEqual(self.loads(s).a, "BBB.__setstate__")
+
     def test_reduce_overrides_default_reduce_ex(self):
         for proto in protocols:
             x = REX_one()
@@ -2756,6 +2882,41 @@ class AbstractPickleTests(unittest.TestCase):
             self.assertIs(type(new), type(obj))
             self.assertEqual(new, obj)
 
+    def test_oob_bytearray(self):
+        obj = bytearray(b"foobar")
+        for proto in range(5, pickle.HIGHEST_PROTOCOL + 1):
+            buffers = []
+            data = self.dumps([obj, obj], proto,
+                              buffer_callback=buffers.append)
+            self.assertNotIn(b"foobar", data)
+            self.assertEqual(count_opcode(pickle.NEXT_BUFFER, data), 1)
+            self.assertEqual(len(buffers), 1)
+            self.assertEqual(bytes(buffers[0]), b"foobar")
+            # The bytearray passed as buffer is reused
+            new = self.loads(data, buffers=[obj])
+            self.assertIs(new[0], obj)
+            self.assertIs(new[1], obj)
+            ba = bytearray(buffers[0])
+            new = self.loads(data, buffers=[ba])
+            self.assertIs(new[0], ba)
+            # Other buffers are copied
+            new = self.loads(data, buffers=[b"foobar"])
+            self.assertIs(type(new[0]), bytearray)
+            self.assertEqual(new[0], obj)
+            self.assertIs(new[1], new[0])
+            # In-band
+            data = self.dumps(obj, proto, buffer_callback=lambda pb: True)
+            new = self.loads(data)
+            self.assertIs(type(new), bytearray)
+            self.assertEqual(new, obj)
+            self.assertIsNot(new, obj)
+            # Empty bytearrays are always in-band
+            buffers = []
+            data = self.dumps(bytearray(), proto,
+                              buffer_callback=buffers.append)
+            self.assertEqual(buffers, [])
+            self.assertEqual(self.loads(data), bytearray())
+
     def test_picklebuffer_error(self):
         # PickleBuffer forbidden with protocol < 5
         pb = pickle.PickleBuffer(b"foobar")
@@ -3065,6 +3226,19 @@ myclasses = [MyInt, MyFloat,
 class SlotList(MyList):
     __slots__ = ["foo"]
 
+class ShapedSlots:
+    __slots__ = ('a', '__b', '__dict__')
+    def __init__(self, *args, **kwargs):
+        for name, value in zip(('a', '_ShapedSlots__b'), args):
+            setattr(self, name, value)
+        self.__dict__.update(kwargs)
+    def __eq__(self, other):
+        return type(self) is type(other) and self._state() == other._state()
+    def _state(self):
+        return (self.__dict__,
+                [getattr(self, name, AttributeError)
+                 for name in ('a', '_ShapedSlots__b')])
+
 class SimpleNewObj(int):
     def __init__(self, *args, **kwargs):
         # raise an error, to make sure this isn't called
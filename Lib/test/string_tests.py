@@ -2,7 +2,7 @@
 Common tests shared by test_unicode, test_userstring and test_bytes.
 """
 
-import unittest, string, sys, struct
+import unittest, string, sys, struct, random
 from test import support
 from collections import UserList
 
@@ -213,6 +213,48 @@ class BaseTest:
                 if loc != -1:
                     self.assertEqual(i[loc:loc+len(j)], j)
 
+    def test_find_long_needles(self):
+        # Compare with a naive search, on inputs long enough for the
+        # vectorized search of short needles and for the Two-Way search of
+        # long ones, with periodic needles in nearly periodic haystacks.
+        def naive_find(text, sub, start=0):
+            i = text.find(sub[0], start)
+            while i != -1 and not text.startswith(sub, i):
+                i = text.find(sub[0], i + 1)
+            return i
+
+        def naive_split(text, sub):
+            pieces = []
+            start = 0
+            i = naive_find(text, sub)
+            while i != -1:
+                pieces.append(text[start:i])
+                start = i + len(sub)
+                i = naive_find(text, sub, start)
+            pieces.append(text[start:])
+            return pieces
+
+        rand = random.Random(41972)
+        for size, maxlen in (100, 100), (3000, 1500), (40000, 300):
+            for _ in range(12):
+                period = ''.join(rand.choices('abc', k=rand.randrange(1, 8)))
+                sub = (period * maxlen)[:rand.randrange(2, maxlen)]
+                if rand.random() < 0.5:
+                    sub = sub[:-1] + 'd'
+                text = list((period * (size // len(period) + 1))[:size])
+                for _ in range(rand.randrange(10)):
+                    text[rand.randrange(size)] = rand.choice('abcd')
+                if rand.random() < 0.5 and len(sub) < size:
+                    i = rand.randrange(size - len(sub))
+                    text[i:i + len(sub)] = sub
+                text = ''.join(text)
+                with self.subTest(size=size, sub=sub):
+                    pieces = naive_split(text, sub)
+                    self.checkequal(naive_find(text, sub), text, 'find', sub)
+                    self.checkequal(len(pieces) - 1, text, 'count', sub)
+                    self.checkequal(pieces, text, 'split', sub)
+                    self.checkequal(''.join(pieces), text, 'replace', sub, '')
+
     def test_rfind(self):
         self.checkequal(9,  'abcdefghiabc', 'rfind', 'abc')
         self.checkequal(12, 'abcdefghiabc', 'rfind', '')
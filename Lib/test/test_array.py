@@ -93,6 +93,12 @@ class ArrayReconstructorTest(unittest.TestCase):
         self.assertRaises(ValueError, array_reconstructor,
                           array.array, "d", 16, b"a")
 
+    def test_buffer(self):
+        for items in (bytearray(b'abc'), memoryview(b'abc'),
+                      pickle.PickleBuffer(b'abc')):
+            a = array_reconstructor(array.array, 'b', SIGNED_INT8, items)
+            self.assertEqual(a, array.array('b', b'abc'))
+
     def test_numbers(self):
         testcases = (
             (['B', 'H', 'I', 'L'], UNSIGNED_INT8, '=BBBB',
@@ -266,6 +272,26 @@ class BaseTest:
             self.assertEqual(a.x, b.x)
             self.assertEqual(type(a), type(b))
 
+    def test_pickle_out_of_band(self):
+        a = array.array(self.typecode, self.example)
+        for protocol in range(5, pickle.HIGHEST_PROTOCOL + 1):
+            buffers = []
+            data = pickle.dumps(a, protocol, buffer_callback=buffers.append)
+            self.assertEqual(len(buffers), 1)
+            self.assertEqual(buffers[0].raw(), a.tobytes())
+            b = pickle.loads(data, buffers=buffers)
+            self.assertEqual(a, b)
+            b = pickle.loads(data, buffers=[bytearray(buffers[0])])
+            self.assertEqual(a, b)
+            # The buffer is not shared with the pickled array
+            a2 = pickle.loads(data, buffers=buffers)
+            a2[0] = a2[1]
+            self.assertEqual(a, b)
+            # In-band
+            b = pickle.loads(pickle.dumps(a, protocol,
+                                          buffer_callback=lambda pb: True))
+            self.assertEqual(a, b)
+
     def test_pickle_for_empty_array(self):
         for protocol in range(pickle.HIGHEST_PROTOCOL + 1):
             a = array.array(self.typecode)
@@ -2083,6 +2083,17 @@ else:
             def create_event_loop(self):
                 return asyncio.SelectorEventLoop(selectors.EpollSelector())
 
+    if hasattr(selectors, 'IoUringSelector'):
+        class IoUringEventLoopTests(UnixEventLoopTestsMixin,
+                                    SubprocessTestsMixin,
+                                    test_utils.TestCase):
+
+            def create_event_loop(self):
+                try:
+                    return asyncio.IoUringEventLoop()
+                except OSError as exc:
+                    self.skipTest(f"io_uring is not available: {exc}")
+
     if hasattr(selectors, 'PollSelector'):
         class PollEventLoopTests(UnixEventLoopTestsMixin,
                                  SubprocessTestsMixin,
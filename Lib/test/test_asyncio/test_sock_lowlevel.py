@@ -329,6 +329,50 @@ else:
             def create_event_loop(self):
                 return asyncio.SelectorEventLoop(selectors.EpollSelector())
 
+    if hasattr(selectors, 'IoUringSelector'):
+        class IoUringEventLoopTests(BaseSockTestsMixin,
+                                    test_utils.TestCase):
+
+            def create_event_loop(self):
+                try:
+                    return asyncio.IoUringEventLoop()
+                except OSError as exc:
+                    self.skipTest(f"io_uring is not available: {exc}")
+
+            def test_sock_recv_cancelled(self):
+                # The data of a recv which completes after it was cancelled
+                # is returned by the next recvs on the socket.
+                async def recv_cancelled(sock, peer, data):
+                    task = self.loop.create_task(self.loop.sock_recv(sock, 10))
+                    await asyncio.sleep(0)
+                    peer.send(data)
+                    task.cancel()
+                    with self.assertRaises(asyncio.CancelledError):
+                        await task
+                    peer.send(b'more')
+
+                async def main(sock, peer):
+                    await recv_cancelled(sock, peer, b'spam')
+                    self.assertEqual(await self.loop.sock_recv(sock, 10),
+                                     b'spam')
+                    self.assertEqual(await self.loop.sock_recv(sock, 10),
+                                     b'more')
+
+                    await recv_cancelled(sock, peer, b'eggs')
+                    buf = bytearray(3)
+                    self.assertEqual(
+                        await self.loop.sock_recv_into(sock, buf), 3)
+                    self.assertEqual(buf, b'egg')
+                    self.assertEqual(await self.loop.sock_recv(sock, 10),
+                                     b's')
+                    self.assertEqual(await self.loop.sock_recv(sock, 10),
+                                     b'more')
+
+                sock, peer = socket.socketpair()
+                with sock, peer:
+                    sock.setblocking(False)
+                    self.loop.run_until_complete(main(sock, peer))
+
     if hasattr(selectors, 'PollSelector'):
         class PollEventLoopTests(BaseSockTestsMixin,
                                  test_utils.TestCase):
@@ -642,6 +642,63 @@ class SelectorEventLoopUnixSockSendfileTests(test_utils.TestCase):
         self.assertEqual(1000, self.file.tell())
 
 
+@unittest.skipUnless(hasattr(asyncio, 'IoUringEventLoop'),
+                     'io_uring is not supported')
+class IoUringEventLoopFileTests(test_utils.TestCase):
+
+    def setUp(self):
+        super().setUp()
+        try:
+            self.loop = asyncio.IoUringEventLoop()
+        except OSError as exc:
+            self.skipTest(f"io_uring is not available: {exc}")
+        self.set_event_loop(self.loop)
+        self.file = tempfile.TemporaryFile(buffering=0)
+        self.addCleanup(self.file.close)
+
+    def run_loop(self, coro):
+        return self.loop.run_until_complete(coro)
+
+    def test_file_write_read(self):
+        self.assertEqual(
+            self.run_loop(self.loop.file_write(self.file, b'hello world', 0)),
+            11)
+        self.assertEqual(
+            self.run_loop(self.loop.file_read(self.file.fileno(), 5, 6)),
+            b'world')
+        self.assertEqual(
+            self.run_loop(self.loop.file_read(self.file.fileno(), 5, 11)),
+            b'')
+        # explicit offsets leave the file position unchanged
+        self.assertEqual(self.file.tell(), 0)
+
+    def test_file_current_position(self):
+        fd = self.file.fileno()
+        self.run_loop(self.loop.file_write(fd, b'abc'))
+        self.run_loop(self.loop.file_write(fd, memoryview(b'def')))
+        self.assertEqual(self.file.tell(), 6)
+        self.file.seek(1)
+        self.assertEqual(self.run_loop(self.loop.file_read(fd, 100)),
+                         b'bcdef')
+
+    def test_file_readinto(self):
+        self.file.write(b'spam and eggs')
+        buf = bytearray(4)
+        self.assertEqual(
+            self.run_loop(self.loop.file_readinto(self.file, buf, 9)), 4)
+        self.assertEqual(buf, b'eggs')
+        with self.assertRaises(TypeError):
+            self.run_loop(self.loop.file_readinto(self.file, b'ro', 0))
+
+    def test_file_error(self):
+        r, w = os.pipe()
+        os.close(w)
+        os.close(r)
+        with self.assertRaises(OSError) as cm:
+            self.run_loop(self.loop.file_read(r, 10))
+        self.assertEqual(cm.exception.errno, errno.EBADF)
+
+
 class UnixReadPipeTransportTests(test_utils.TestCase):
 
     def setUp(self):
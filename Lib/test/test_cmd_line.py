@@ -726,6 +726,34 @@ class CmdLineTest(unittest.TestCase):
             with self.subTest(env_var=env_var, name=name):
                 self.check_pythonmalloc(env_var, name)
 
+    @unittest.skipUnless(support.with_pymalloc(), 'need pymalloc')
+    def test_pythonmallocarena(self):
+        # Test the PYTHONMALLOCARENA environment variable
+        code = 'import sys; sys._debugmallocstats()'
+        tests = [
+            ('', 256 << 10),
+            ('1M', 1 << 20),
+            ('64k', 64 << 10),
+            ('16M', 16 << 20),
+        ]
+        bad = ['3M', '32M', '16K', '1G', 'big', '-1']
+        if sys.platform.startswith('linux'):
+            tests.append(('huge', 2 << 20))
+        elif sys.platform == 'win32':
+            bad.append('huge')
+        for env_var, size in tests:
+            with self.subTest(env_var=env_var):
+                res = assert_python_ok('-c', code, PYTHONMALLOC='pymalloc',
+                                       PYTHONMALLOCARENA=env_var)
+                self.assertIn(b'arenas * %d bytes/arena' % size, res.err)
+
+        for env_var in bad:
+            with self.subTest(env_var=env_var):
+                res = assert_python_failure('-c', 'pass',
+                                            PYTHONMALLOC='pymalloc',
+                                            PYTHONMALLOCARENA=env_var)
+                self.assertIn(b'PYTHONMALLOCARENA', res.err)
+
     def test_pythondevmode_env(self):
         # Test the PYTHONDEVMODE environment variable
         code = "import sys; print(sys.flags.dev_mode)"
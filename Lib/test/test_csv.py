@@ -2,8 +2,13 @@
 # csv package unit tests
 
 import copy
+import io
+import operator
+import random
+import re
 import sys
 import unittest
+from unittest import mock
 from io import StringIO
 from tempfile import TemporaryFile
 import csv
@@ -465,6 +470,8 @@ class TestCsvBase(unittest.TestCase):
             reader = csv.reader(fileobj, dialect = self.dialect)
             fields = list(reader)
             self.assertEqual(fields, expected_result)
+        table = csv.parse(input.encode(), dialect = self.dialect)
+        self.assertEqual(list(table), expected_result)
 
     def writerAssertEqual(self, input, expected_result):
         with TemporaryFile("w+", newline='') as fileobj:
@@ -1123,6 +1130,192 @@ class TestLeaks(unittest.TestCase):
         # if writer leaks during write, last delta should be 5 or more
         self.assertLess(delta, 5)
 
+class TestParse(unittest.TestCase):
+
+    def check(self, data, **kwargs):
+        # parse() returns the same rows as reader() on a file opened with
+        # newline='', or raises the same error.
+        text = data.decode(kwargs.get('encoding', 'utf-8'))
+        try:
+            expected = list(csv.reader(io.StringIO(text, newline=''),
+                                       **kwargs))
+        except csv.Error as e:
+            with self.assertRaisesRegex(csv.Error, re.escape(str(e))):
+                csv.parse(data, **kwargs)
+            return
+        for threads in 1, 3:
+            table = csv.parse(data, threads=threads, **kwargs)
+            self.assertEqual(len(table), len(expected))
+            self.assertEqual(list(table), expected)
+            self.assertEqual(table.nbytes, len(data))
+
+    def test_dialects(self):
+        inputs = [
+            b'', b'\n', b'a', b'a,b\r\nc,d', b'a,b\rc,d\n\n', b'\r\r\n\n',
+            b'"a\nb",c\r\n', b'"a""b",c', b'"a" b,c', b'a"b,c', b'"a\rb', b',',
+            b' "a", b', b'a\\,b,"c\\"d"\n\\\n', b'a\\', b'"a\\',
+            b'"a"', b'\xc3\xa9,\xe2\x82\xac\n', b'a;b;"c;d"', b"'a,b';c",
+        ]
+        dialects = [
+            {}, {'escapechar': '\\'}, {'doublequote': False, 'escapechar': '\\'},
+            {'quoting': csv.QUOTE_NONE, 'escapechar': '\\'},
+            {'quoting': csv.QUOTE_NONE}, {'skipinitialspace': True},
+            {'strict': True}, {'delimiter': ';'}, {'quotechar': "'"},
+            {'dialect': 'excel-tab'}, {'dialect': 'unix'},
+        ]
+        for data in inputs:
+            for kwargs in dialects:
+                with self.subTest(data=data, **kwargs):
+                    self.check(data, **kwargs)
+
+    def test_errors(self):
+        self.check(b'a,\0b')
+        self.check(b'"a"b', strict=True)
+        self.check(b'"a', strict=True)
+        with self.assertRaisesRegex(csv.Error, 'line contains NUL'):
+            csv.parse(b'a\0')
+        limit = csv.field_size_limit()
+        try:
+            csv.field_size_limit(10)
+            self.assertEqual(list(csv.parse(b'a' * 10)), [['a' * 10]])
+            with self.assertRaisesRegex(csv.Error, 'field larger than'):
+                csv.parse(b'a' * 11)
+            with self.assertRaisesRegex(csv.Error, 'field larger than'):
+                csv.parse(b'"' + b'a' * 11 + b'"')
+        finally:
+            csv.field_size_limit(limit)
+
+    def test_arguments(self):
+        self.assertRaises(TypeError, csv.parse)
+        self.assertRaises(TypeError, csv.parse, 'a,b')
+        self.assertRaises(TypeError, csv.parse, b'a', 'excel', 'x')
+        self.assertRaises(TypeError, csv.parse, b'a', spam=1)
+        self.assertRaises(csv.Error, csv.parse, b'a', 'spam')
+        self.assertRaises(ValueError, csv.parse, b'a', threads=-1)
+        self.assertRaises(TypeError, csv.parse, b'a', threads='1')
+        self.assertRaises(ValueError, csv.parse, b'a', delimiter='\xa7')
+        self.assertRaises(LookupError, csv.parse, b'a', encoding='spam')
+        self.assertRaises(LookupError, csv.parse, b'a', encoding='rot13')
+        self.assertRaises(LookupError, csv.parse, b'a', errors='spam')
+        self.assertRaises(TypeError, csv.Table)
+        self.assertEqual(list(csv.parse(bytearray(b'a,b'))), [['a', 'b']])
+        self.assertEqual(list(csv.parse(memoryview(b'a|b'), delimiter='|')),
+                         [['a', 'b']])
+        self.assertEqual(list(csv.parse(b'a\tb', csv.excel_tab, threads=0)),
+                         [['a', 'b']])
+
+    def test_encoding(self):
+        data = 'é,€\r\n'
+        self.assertEqual(list(csv.parse(data.encode())), [['é', '€']])
+        self.assertEqual(list(csv.parse(data.encode('cp1252'),
+                                        encoding='cp1252')),
+                         [['é', '€']])
+        table = csv.parse(b'\xff,a')
+        self.assertEqual(table.column(1), ['a'])
+        self.assertRaises(UnicodeDecodeError, table.column, 0)
+        self.assertRaises(UnicodeDecodeError, operator.getitem, table, 0)
+        table = csv.parse(b'\xff,a', errors='replace')
+        self.assertEqual(list(table), [['\ufffd', 'a']])
+
+    def test_nonnumeric(self):
+        table = csv.parse(b'1,"2",,3.5\n"x"\n', quoting=csv.QUOTE_NONNUMERIC)
+        self.assertEqual(list(table), [[1.0, '2', '', 3.5], ['x']])
+        self.assertEqual(table.column(0), [1.0, 'x'])
+        table = csv.parse(b'x', quoting=csv.QUOTE_NONNUMERIC)
+        self.assertRaises(ValueError, list, table)
+
+    def test_table(self):
+        table = csv.parse(b'a,b,c\n\nd,e\n"f\ng"\n')
+        self.assertEqual(len(table), 4)
+        self.assertEqual(table[0], ['a', 'b', 'c'])
+        self.assertEqual(table[-1], ['f\ng'])
+        self.assertEqual(table[1], [])
+        self.assertIsNot(table[0], table[0])
+        self.assertRaises(IndexError, operator.getitem, table, 4)
+        self.assertRaises(IndexError, operator.getitem, table, -5)
+        self.assertEqual(table.column(0), ['a', None, 'd', 'f\ng'])
+        self.assertEqual(table.column(1), ['b', None, 'e', None])
+        self.assertEqual(table.column(-1), ['c', None, 'e', 'f\ng'])
+        self.assertEqual(table.column(-3), ['a', None, None, None])
+        self.assertEqual(table.column(3), [None] * 4)
+        self.assertRaises(TypeError, table.column, 'a')
+        self.assertEqual(len(csv.parse(b'')), 0)
+        self.assertFalse(csv.parse(b''))
+
+    def test_final(self):
+        data = b'a,b\r\n"c\nd",e\r\nf,g\r'
+        for i in range(len(data) + 1):
+            table = csv.parse(data[:i], final=False)
+            rows = list(table)
+            rest = list(csv.parse(data[table.nbytes:]))
+            with self.subTest(i=i):
+                self.assertEqual(rows + rest, list(csv.parse(data)))
+        self.assertEqual(csv.parse(b'a,b', final=False).nbytes, 0)
+        self.assertEqual(csv.parse(b'a,b\n"c', final=False).nbytes, 4)
+        self.assertEqual(csv.parse(b'a,b\r', final=False).nbytes, 0)
+
+    def make_data(self, nrecords):
+        rnd = random.Random(42)
+        rows = []
+        for i in range(nrecords):
+            row = [str(i), 'x' * rnd.randrange(100)]
+            if rnd.random() < 0.2:
+                # A quoted field with line ends, which may be cut
+                row.append('a\n' * rnd.randrange(1, 100) + '"q"')
+            if rnd.random() < 0.1:
+                row.append('\r\n' * rnd.randrange(1, 1000))
+            rows.append(row)
+        f = io.StringIO(newline='')
+        csv.writer(f).writerows(rows)
+        return f.getvalue().encode(), rows
+
+    def test_threads(self):
+        data, rows = self.make_data(20000)
+        self.assertGreater(len(data), 1024 * 1024)
+        for threads in 2, 4, 16:
+            with self.subTest(threads=threads):
+                table = csv.parse(data, threads=threads)
+                self.assertEqual(list(table), rows)
+                self.assertEqual(table.column(0), [r[0] for r in rows])
+        # An error is reported only if it happens in a record
+        data += b'"a"b\r\n' + b'x\r\n' * 100000
+        with self.assertRaisesRegex(csv.Error, "',' expected after '\"'"):
+            csv.parse(data, threads=4, strict=True)
+
+    def test_iterparse(self):
+        data, rows = self.make_data(2000)
+        for chunk_size in 1, 1000, 100000, 1 << 30:
+            with self.subTest(chunk_size=chunk_size):
+                f = io.BytesIO(data)
+                result = []
+                for table in csv.iterparse(f, chunk_size=chunk_size,
+                                           threads=2):
+                    self.assertIsInstance(table, csv.Table)
+                    self.assertGreater(len(table), 0)
+                    result.extend(table)
+                self.assertEqual(result, rows)
+        f = io.BytesIO(b'1;2\r\n3;"4')
+        self.assertEqual([list(t) for t in csv.iterparse(f, delimiter=';')],
+                         [[['1', '2']], [['3', '4']]])
+        f = io.BytesIO(b'1;"2')
+        with self.assertRaises(csv.Error):
+            list(csv.iterparse(f, delimiter=';', strict=True))
+        self.assertEqual(list(csv.iterparse(io.BytesIO(b''))), [])
+
+    def test_iterparse_long_record(self):
+        # A record much longer than chunk_size is not parsed again for each
+        # chunk read.
+        field = 'x' * 100000
+        data = f'a,b\r\n"{field}",c\r\nd,e\r\n'.encode()
+        with mock.patch('csv.parse', wraps=csv.parse) as parse:
+            tables = list(csv.iterparse(io.BytesIO(data), chunk_size=10))
+        self.assertEqual([row for table in tables for row in table],
+                         [['a', 'b'], [field, 'c'], ['d', 'e']])
+        parsed = sum(len(call.args[0]) for call in parse.call_args_list)
+        self.assertLess(parsed, 5 * len(data))
+
+
+
 class TestUnicode(unittest.TestCase):
 
     names = ["Martin von Löwis",
@@ -79,6 +79,9 @@ else:
     # been released in release mode: with NDEBUG defined.
     BUILD_WITH_NDEBUG = (not hasattr(sys, 'gettotalrefcount'))
 
+# Keys of the "phase_times" dicts of gc.get_stats() and gc.callbacks
+PHASES = {"refcounts", "reachability", "weakrefs", "finalizers", "deletion"}
+
 ### Tests
 ###############################################################################
 
@@ -760,10 +763,18 @@ class GCTests(unittest.TestCase):
         for st in stats:
             self.assertIsInstance(st, dict)
             self.assertEqual(set(st),
-                             {"collected", "collections", "uncollectable"})
+                             {"collected", "collections", "uncollectable",
+                              "time", "phase_times", "pauses"})
             self.assertGreaterEqual(st["collected"], 0)
             self.assertGreaterEqual(st["collections"], 0)
             self.assertGreaterEqual(st["uncollectable"], 0)
+            self.assertGreaterEqual(st["time"], 0.0)
+            self.assertEqual(set(st["phase_times"]), PHASES)
+            for t in st["phase_times"].values():
+                self.assertGreaterEqual(t, 0.0)
+            self.assertLessEqual(sum(st["phase_times"].values()), st["time"])
+            self.assertIsInstance(st["pauses"], tuple)
+            self.assertEqual(len(st["pauses"]), 24)
         # Check that collection counts are incremented correctly
         if gc.isenabled():
             self.addCleanup(gc.enable)
@@ -774,6 +785,10 @@ class GCTests(unittest.TestCase):
         self.assertEqual(new[0]["collections"], old[0]["collections"] + 1)
         self.assertEqual(new[1]["collections"], old[1]["collections"])
         self.assertEqual(new[2]["collections"], old[2]["collections"])
+        self.assertEqual(sum(new[0]["pauses"]), sum(old[0]["pauses"]) + 1)
+        self.assertEqual(new[1]["pauses"], old[1]["pauses"])
+        self.assertGreater(new[0]["time"], old[0]["time"])
+        self.assertEqual(new[1]["time"], old[1]["time"])
         gc.collect(2)
         new = gc.get_stats()
         self.assertEqual(new[0]["collections"], old[0]["collections"] + 1)
@@ -786,6 +801,200 @@ class GCTests(unittest.TestCase):
         gc.unfreeze()
         self.assertEqual(gc.get_freeze_count(), 0)
 
+    def test_set_incremental(self):
+        self.assertEqual(gc.get_incremental(), 0)
+        self.assertRaises(ValueError, gc.set_incremental, -1)
+        self.assertRaises(OverflowError, gc.set_incremental, sys.maxsize)
+        self.assertRaises(TypeError, gc.set_incremental, 1.5)
+        gc.set_incremental(0)
+        self.assertEqual(gc.get_incremental(), 0)
+        try:
+            gc.set_incremental(500)
+        except ValueError:
+            self.skipTest('incremental collections are not supported')
+        try:
+            self.assertEqual(gc.get_incremental(), 500)
+        finally:
+            gc.set_incremental(0)
+        self.assertEqual(gc.get_incremental(), 0)
+
+    def run_incremental(self, budget, until):
+        # Allocate containers, which triggers automatic collections, until
+        # until() returns true.
+        try:
+            gc.set_incremental(budget)
+        except ValueError:
+            self.skipTest('incremental collections are not supported')
+        self.addCleanup(gc.set_incremental, 0)
+        self.addCleanup(gc.set_threshold, *gc.get_threshold())
+        if not gc.isenabled():
+            self.addCleanup(gc.disable)
+            gc.enable()
+        gc.set_threshold(100, 2, 2)
+        junk = []
+        for i in range(2000000):
+            junk.append([])
+            if len(junk) > 10000:
+                junk = []
+                if until():
+                    return
+        self.fail('incremental collection did not complete')
+
+    def test_incremental_collection(self):
+        class A:
+            pass
+
+        collected = []
+        refs = []
+        garbage = []
+        for i in range(1000):
+            a = A()
+            a.self = a
+            a.data = [i]
+            garbage.append(a)
+            refs.append(weakref.ref(a, collected.append))
+        live = A()
+        live.self = live
+        live.data = [-1]
+        # Move everything into the oldest generation before the cycles
+        # become garbage.
+        gc.collect()
+        del a, garbage
+
+        stats = gc.get_stats()[2]
+        collections = stats['collections']
+        self.run_incremental(
+            100,
+            lambda: (len(collected) == len(refs) and
+                     gc.get_stats()[2]['collections'] > collections + 1))
+        self.assertEqual(live.self, live)
+        self.assertEqual(live.data, [-1])
+        # Each increment is a pause of its own
+        new_stats = gc.get_stats()[2]
+        self.assertGreater(sum(new_stats['pauses']) - sum(stats['pauses']),
+                           new_stats['collections'] - collections)
+
+    def test_incremental_mutation(self):
+        # Objects moved between reachable and pending objects while a cycle
+        # is in progress must not be collected.
+        class A:
+            pass
+
+        head = A()
+        node = head
+        for i in range(1000):
+            node.next = A()
+            node.next.prev = node
+            node = node.next
+        gc.collect()
+        collections = gc.get_stats()[2]['collections']
+        # Repeatedly move the tail of the chain to a local variable and back,
+        # so that it is only reachable from a frame for a while.
+        def until():
+            nonlocal head
+            tail = head.next
+            head.next = None
+            tail.prev = None
+            gc.collect(0)
+            head.next = tail
+            tail.prev = head
+            return gc.get_stats()[2]['collections'] > collections + 2
+        self.run_incremental(50, until)
+        n = 0
+        node = head
+        while getattr(node, 'next', None) is not None:
+            self.assertIs(node.next.prev, node)
+            node = node.next
+            n += 1
+        self.assertEqual(n, 1000)
+
+    def test_incremental_get_objects(self):
+        # Objects waiting to be examined by the cycle in progress still
+        # belong to the oldest generation.
+        l = []
+        l.append(l)
+        gc.collect()
+        collections = gc.get_stats()[2]['collections']
+        def until():
+            self.assertTrue(any(l is e for e in gc.get_objects(generation=2)))
+            self.assertTrue(any(l is e for e in gc.get_referrers(l)))
+            return gc.get_stats()[2]['collections'] > collections + 1
+        self.run_incremental(100, until)
+
+    def test_set_parallel(self):
+        self.assertEqual(gc.get_parallel(), 0)
+        self.assertRaises(ValueError, gc.set_parallel, -1)
+        self.assertRaises(ValueError, gc.set_parallel, 10**6)
+        self.assertRaises(TypeError, gc.set_parallel, 2.0)
+        gc.set_parallel(1)
+        self.assertEqual(gc.get_parallel(), 1)
+        gc.set_parallel(0)
+        try:
+            gc.set_parallel(4)
+        except ValueError:
+            self.skipTest('parallel collections are not supported')
+        try:
+            self.assertEqual(gc.get_parallel(), 4)
+        finally:
+            gc.set_parallel(0)
+
+    def test_parallel_collection(self):
+        import random
+
+        class A:
+            pass
+
+        def build(seed, n=50000):
+            # A random graph large enough to be marked in parallel, with a
+            # long chain and garbage cycles.
+            rnd = random.Random(seed)
+            objs = [A() for _ in range(n)]
+            for o in objs:
+                o.a = objs[rnd.randrange(n)]
+                if rnd.random() < 0.3:
+                    o.b = [objs[rnd.randrange(n)]]
+            roots = [objs[rnd.randrange(n)] for _ in range(5)]
+            node = roots[0]
+            for i in range(20000):
+                node.chain = A()
+                node = node.chain
+            return roots
+
+        def reachable(roots):
+            seen = set()
+            stack = list(roots)
+            while stack:
+                o = stack.pop()
+                if id(o) not in seen:
+                    seen.add(id(o))
+                    refs = vars(o)
+                    stack.extend(v for k, v in refs.items() if k != 'b')
+                    stack.extend(refs.get('b', ()))
+            return len(seen)
+
+        def collect(nworkers, seed):
+            gc.collect()
+            gc.set_parallel(nworkers)
+            try:
+                roots = build(seed)
+                return gc.collect(), reachable(roots)
+            finally:
+                gc.set_parallel(0)
+
+        if gc.isenabled():
+            self.addCleanup(gc.enable)
+            gc.disable()
+        try:
+            gc.set_parallel(2)
+        except ValueError:
+            self.skipTest('parallel collections are not supported')
+        gc.set_parallel(0)
+        for seed in range(3):
+            with self.subTest(seed=seed):
+                expected = collect(0, seed)
+                self.assertEqual(collect(2, seed), expected)
+                self.assertEqual(collect(5, seed), expected)
+
     def test_get_objects(self):
         gc.collect()
         l = []
@@ -1116,6 +1325,13 @@ class GCCallbackTests(unittest.TestCase):
             self.assertTrue("generation" in info)
             self.assertTrue("collected" in info)
             self.assertTrue("uncollectable" in info)
+            self.assertTrue("time" in info)
+            self.assertEqual(set(info["phase_times"]), PHASES)
+            if v[1] == "start":
+                self.assertEqual(info["time"], 0.0)
+            else:
+                self.assertGreaterEqual(info["time"],
+                                        sum(info["phase_times"].values()))
 
     def test_collect_generation(self):
         self.preclean()
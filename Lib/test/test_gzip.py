@@ -530,6 +530,24 @@ class TestGzip(BaseTest):
                 with gzip.GzipFile(fileobj=io.BytesIO(datac), mode="rb") as f:
                     self.assertEqual(f.read(), data)
 
+    def test_compress_threads(self):
+        data = data1 * 20000
+        for threads in (2, 3, 0):
+            with self.subTest(threads=threads):
+                datac = gzip.compress(data, threads=threads)
+                self.assertEqual(gzip.decompress(datac), data)
+        with self.assertRaises(ValueError):
+            gzip.compress(data1, threads=-1)
+
+    def test_write_threads(self):
+        with gzip.GzipFile(self.filename, 'wb', threads=2) as f:
+            for i in range(20000):
+                f.write(data1)
+            f.flush()
+            f.write(data2)
+        with gzip.GzipFile(self.filename) as f:
+            self.assertEqual(f.read(), data1 * 20000 + data2)
+
     def test_compress_mtime(self):
         mtime = 123456789
         for data in [data1, data2]:
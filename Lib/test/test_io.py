@@ -33,6 +33,7 @@ import textwrap
 import threading
 import time
 import unittest
+import unittest.mock
 import warnings
 import weakref
 from collections import deque, UserList
@@ -1535,6 +1536,45 @@ class BufferedReaderTest(unittest.TestCase, CommonBufferedTests):
         self.assertRaises(self.UnsupportedOperation, bufio.truncate)
         self.assertRaises(self.UnsupportedOperation, bufio.truncate, 0)
 
+    def test_readahead(self):
+        data = bytes(range(256)) * 400
+        self.addCleanup(support.unlink, support.TESTFN)
+        with self.open(support.TESTFN, "wb") as f:
+            f.write(data)
+        rawio = self.FileIO(support.TESTFN, "rb")
+        with self.tp(rawio, 1000, readahead=4096) as bufio:
+            self.assertEqual(bufio.readahead, 4096)
+            self.assertEqual(bufio.read(10), data[:10])
+            self.assertEqual(bufio.read(5000), data[10:5010])
+            self.assertEqual(bufio.peek(1)[:1], data[5010:5011])
+            b = bytearray(3000)
+            self.assertEqual(bufio.readinto(b), 3000)
+            self.assertEqual(b, data[5010:8010])
+            # Seeking backward and forward restarts the readahead
+            bufio.seek(100)
+            self.assertEqual(bufio.read(2000), data[100:2100])
+            bufio.seek(90000)
+            self.assertEqual(bufio.read(2000), data[90000:92000])
+            self.assertEqual(bufio.read(), data[92000:])
+        with self.tp(self.FileIO(support.TESTFN, "rb")) as bufio:
+            self.assertEqual(bufio.readahead, 0)
+        rawio = self.FileIO(support.TESTFN, "rb")
+        self.assertRaises(ValueError, self.tp, rawio, readahead=-1)
+        rawio.close()
+
+    def test_readahead_no_file(self):
+        # The raw streams without file descriptor, and pipes, are read
+        # without readahead.
+        rawio = self.MockRawIO((b"abc", b"d", b"efg"))
+        bufio = self.tp(rawio, readahead=4096)
+        self.assertEqual(bufio.read(), b"abcdefg")
+        r, w = os.pipe()
+        os.write(w, b"x" * 5000)
+        os.close(w)
+        with self.tp(self.FileIO(r, "rb"), 1000, readahead=4096) as bufio:
+            self.assertEqual(bufio.read(3000), b"x" * 3000)
+            self.assertEqual(bufio.read(), b"x" * 2000)
+
 
 class CBufferedReaderTest(BufferedReaderTest, SizeofTest):
     tp = io.BufferedReader
@@ -1590,6 +1630,33 @@ class CBufferedReaderTest(BufferedReaderTest, SizeofTest):
 class PyBufferedReaderTest(BufferedReaderTest):
     tp = pyio.BufferedReader
 
+    @unittest.skipUnless(hasattr(os, 'posix_fadvise'),
+                         'requires os.posix_fadvise()')
+    def test_readahead_windows(self):
+        self.addCleanup(support.unlink, support.TESTFN)
+        with self.open(support.TESTFN, "wb") as f:
+            f.write(b"x" * 20000)
+        rawio = self.FileIO(support.TESTFN, "rb")
+        with unittest.mock.patch.object(pyio.os, 'posix_fadvise') as m:
+            with self.tp(rawio, 1000, readahead=4000) as bufio:
+                fd = rawio.fileno()
+                bufio.read(1)
+                # The first window starts after the first raw read
+                m.assert_called_once_with(fd, 1000, 4000,
+                                          os.POSIX_FADV_WILLNEED)
+                m.reset_mock()
+                bufio.read(1999)
+                m.assert_not_called()
+                # The next one is requested when half of it is read
+                bufio.read(1000)
+                m.assert_called_once_with(fd, 5000, 4000,
+                                          os.POSIX_FADV_WILLNEED)
+                m.reset_mock()
+                bufio.seek(15000)
+                bufio.read(1)
+                m.assert_called_once_with(fd, 16000, 4000,
+                                          os.POSIX_FADV_WILLNEED)
+
 
 class BufferedWriterTest(unittest.TestCase, CommonBufferedTests):
     write_mode = "wb"
@@ -2383,6 +2450,10 @@ class BufferedRandomTest(BufferedReaderTest, BufferedWriterTest):
     # a writable stream.
     test_truncate_on_read_only = None
 
+    # Only BufferedReader has a readahead mode.
+    test_readahead = None
+    test_readahead_no_file = None
+
 
 class CBufferedRandomTest(BufferedRandomTest, SizeofTest):
     tp = io.BufferedRandom
@@ -3117,6 +3188,48 @@ class TextIOWrapperTest(unittest.TestCase):
         txt.seek(0)
         self.assertEqual(txt.readlines(5), ["AA\n", "BB\n"])
 
+    def test_readlines_chunks(self):
+        # Lines within a decoded chunk and lines across chunks, of all
+        # character sizes and with all newline modes.
+        for text in ["a" * 50 + "\n" + "bb\r\ncc\rd\n" * 20 + "e" * 300,
+                     "\xe9" * 40 + "\r" + "x\ty\n" * 30 + "\r\n\r\n",
+                     "\u20ac" * 40 + "\r\n" + "\U0001d11e" * 50 + "\nend"]:
+            data = text.encode("utf-8")
+            for newline in (None, "", "\n", "\r", "\r\n"):
+                txt = self.TextIOWrapper(self.BytesIO(data), encoding="utf-8",
+                                         newline=newline)
+                expected = []
+                while True:
+                    line = txt.readline()
+                    if not line:
+                        break
+                    expected.append(line)
+                for chunk_size in (1, 7, 128, 8192):
+                    txt = self.TextIOWrapper(self.BytesIO(data),
+                                             encoding="utf-8",
+                                             newline=newline)
+                    txt._CHUNK_SIZE = chunk_size
+                    self.assertEqual(txt.readlines(), expected)
+                    self.assertEqual(txt.tell(), len(data))
+                    # With a hint, and mixed with readline()
+                    txt.seek(0)
+                    got = [txt.readline()]
+                    while True:
+                        lines = txt.readlines(20)
+                        if not lines:
+                            break
+                        # Only the last line exceeds the hint
+                        self.assertLessEqual(sum(map(len, lines[:-1])), 20)
+                        got += lines
+                    self.assertEqual(got, expected)
+
+    def test_readlines_subclass(self):
+        class MyTextIO(self.TextIOWrapper):
+            def readline(self, size=-1):
+                return super().readline(size).upper()
+        txt = MyTextIO(self.BytesIO(b"aa\nbb\ncc"), encoding="ascii")
+        self.assertEqual(txt.readlines(), ["AA\n", "BB\n", "CC"])
+
     # read in amounts equal to TextIOWrapper._CHUNK_SIZE which is 128.
     def test_read_by_chunk(self):
         # make sure "\r\n" straddles 128 char boundary.
@@ -3701,6 +3814,35 @@ class CTextIOWrapperTest(TextIOWrapperTest):
     io = io
     shutdown_error = "LookupError: unknown encoding: ascii"
 
+    @support.cpython_only
+    def test_readline_simd(self):
+        # Line endings are searched by blocks of 16 or 32 bytes with SIMD
+        # instructions if the CPU has them:  compare with the portable code
+        # around the block boundaries.
+        _testinternalcapi = support.import_module('_testinternalcapi')
+        old_level = _testinternalcapi.get_simd_level()
+        self.addCleanup(_testinternalcapi.set_simd_level, old_level)
+
+        def read_lines(data, newline):
+            txt = self.TextIOWrapper(self.BytesIO(data), encoding="utf-8",
+                                     newline=newline)
+            return txt.readlines(), self.StringIO(data.decode("utf-8"),
+                                                  newline=newline).readlines()
+
+        cases = []
+        for ch in ("a", "\xe9", "\u20ac", "\U0001d11e"):
+            for i in range(70):
+                for nl in ("\n", "\r", "\r\n"):
+                    cases.append(((ch * i + nl) * 3 + ch * 5).encode("utf-8"))
+        _testinternalcapi.set_simd_level(0)
+        expected = {(data, newline): read_lines(data, newline)
+                    for data in cases for newline in (None, "", "\n")}
+        for level in range(1, old_level + 1):
+            with self.subTest(level=level):
+                _testinternalcapi.set_simd_level(level)
+                for (data, newline), lines in expected.items():
+                    self.assertEqual(read_lines(data, newline), lines)
+
     def test_initialization(self):
         r = self.BytesIO(b"\xc3\xa9\n\n")
         b = self.BufferedReader(r, 1000)
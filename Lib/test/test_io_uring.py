@@ -0,0 +1,183 @@
+"""
+Tests for the io_uring wrapper.
+"""
+import errno
+import os
+import select
+import socket
+import time
+import unittest
+
+if not hasattr(select, "io_uring"):
+    raise unittest.SkipTest("test works only on Linux 5.9 and newer")
+
+try:
+    select.io_uring(1).close()
+except OSError as e:
+    raise unittest.SkipTest(f"io_uring is not available: {e}")
+
+
+class TestIoUring(unittest.TestCase):
+
+    def setUp(self):
+        self.ring = select.io_uring(8)
+        self.addCleanup(self.ring.close)
+
+    def pipe(self):
+        r, w = os.pipe()
+        self.addCleanup(os.close, r)
+        self.addCleanup(os.close, w)
+        return r, w
+
+    def socketpair(self):
+        a, b = socket.socketpair()
+        self.addCleanup(a.close)
+        self.addCleanup(b.close)
+        return a, b
+
+    def test_create(self):
+        ring = select.io_uring()
+        self.assertGreater(ring.fileno(), 0)
+        self.assertFalse(ring.closed)
+        ring.close()
+        self.assertTrue(ring.closed)
+        self.assertRaises(ValueError, ring.fileno)
+        self.assertRaises(ValueError, select.io_uring, 0)
+        self.assertRaises(ValueError, select.io_uring, -1)
+
+    def test_close(self):
+        ring = select.io_uring()
+        ring.close()
+        # close() can be called more than once
+        ring.close()
+        r, w = self.pipe()
+        self.assertRaises(ValueError, ring.read, r, bytearray(1))
+        self.assertRaises(ValueError, ring.poll_add, r, select.POLLIN)
+        self.assertRaises(ValueError, ring.submit)
+        self.assertRaises(ValueError, ring.wait, 0)
+
+    def test_context_manager(self):
+        with select.io_uring() as ring:
+            self.assertFalse(ring.closed)
+        self.assertTrue(ring.closed)
+        self.assertRaises(ValueError, ring.__enter__)
+
+    def test_fd_non_inheritable(self):
+        self.assertEqual(os.get_inheritable(self.ring.fileno()), False)
+
+    def test_read_write(self):
+        r, w = self.pipe()
+        buf = bytearray(10)
+        rtag = self.ring.read(r, buf)
+        wtag = self.ring.write(w, b'spam')
+        self.assertNotEqual(rtag, wtag)
+        results = {}
+        while len(results) < 2:
+            for tag, result, flags in self.ring.wait(5.0):
+                results[tag] = result
+        self.assertEqual(results, {rtag: 4, wtag: 4})
+        self.assertEqual(buf[:4], b'spam')
+
+    def test_read_offset(self):
+        with open(os.devnull, 'rb') as f:
+            buf = bytearray(10)
+            tag = self.ring.read(f.fileno(), buf, 0)
+            self.assertEqual(self.ring.wait(5.0), [(tag, 0, 0)])
+        self.assertRaises(ValueError, self.ring.read, 0, buf, -2)
+        self.assertRaises(TypeError, self.ring.read, 0, b'readonly')
+
+    def test_send_recv(self):
+        a, b = self.socketpair()
+        buf = bytearray(100)
+        rtag = self.ring.recv(b.fileno(), buf)
+        self.assertEqual(self.ring.submit(), 1)
+        self.assertEqual(self.ring.wait(0), [])
+        stag = self.ring.send(a, memoryview(b'eggs'))
+        results = {}
+        while len(results) < 2:
+            for tag, result, flags in self.ring.wait(5.0):
+                results[tag] = result
+        self.assertEqual(results, {stag: 4, rtag: 4})
+        self.assertEqual(buf[:4], b'eggs')
+
+    def test_accept(self):
+        server = socket.create_server(('127.0.0.1', 0))
+        self.addCleanup(server.close)
+        tag = self.ring.accept(server)
+        client = socket.create_connection(server.getsockname())
+        self.addCleanup(client.close)
+        [(rtag, fd, flags)] = self.ring.wait(5.0)
+        self.assertEqual(rtag, tag)
+        self.assertGreaterEqual(fd, 0)
+        conn = socket.socket(fileno=fd)
+        self.addCleanup(conn.close)
+        self.assertFalse(conn.get_inheritable())
+        self.assertEqual(conn.getpeername(), client.getsockname())
+
+    def test_poll_add(self):
+        r, w = self.pipe()
+        tag = self.ring.poll_add(r, select.POLLIN)
+        self.assertEqual(self.ring.wait(0), [])
+        os.write(w, b'x')
+        [(rtag, mask, flags)] = self.ring.wait(5.0)
+        self.assertEqual(rtag, tag)
+        self.assertTrue(mask & select.POLLIN)
+
+    def test_cancel(self):
+        r, w = self.pipe()
+        tag = self.ring.poll_add(r, select.POLLIN)
+        self.ring.submit()
+        self.ring.cancel(tag)
+        self.assertEqual(self.ring.wait(5.0), [(tag, -errno.ECANCELED, 0)])
+
+    def test_error(self):
+        r, w = self.pipe()
+        tag = self.ring.read(w, bytearray(1))
+        [(rtag, result, flags)] = self.ring.wait(5.0)
+        self.assertEqual(rtag, tag)
+        self.assertEqual(result, -errno.EBADF)
+
+    def test_wait_timeout(self):
+        r, w = self.pipe()
+        self.ring.poll_add(r, select.POLLIN)
+        t = time.monotonic()
+        self.assertEqual(self.ring.wait(0.1), [])
+        self.assertGreaterEqual(time.monotonic() - t, 0.09)
+        self.assertRaises(TypeError, self.ring.wait, 'spam')
+
+    def test_maxevents(self):
+        r, w = self.pipe()
+        os.write(w, b'x')
+        tags = [self.ring.poll_add(r, select.POLLIN) for i in range(3)]
+        self.assertRaises(ValueError, self.ring.wait, 0, 0)
+        results = self.ring.wait(5.0, maxevents=2)
+        self.assertEqual(len(results), 2)
+        results += self.ring.wait(5.0)
+        self.assertEqual(sorted(tag for tag, result, flags in results), tags)
+
+    def test_full_submission_queue(self):
+        # Queuing more operations than the submission queue holds submits
+        # the queued ones first.
+        r, w = self.pipe()
+        os.write(w, b'x')
+        tags = [self.ring.poll_add(r, select.POLLIN) for i in range(20)]
+        results = []
+        while len(results) < len(tags):
+            results += self.ring.wait(5.0)
+        self.assertEqual(sorted(tag for tag, result, flags in results), tags)
+
+    def test_close_in_progress(self):
+        # Closing the ring cancels the operations, and releases the buffers
+        # once the kernel no longer uses them.
+        r, w = self.pipe()
+        buf = bytearray(10)
+        self.ring.read(r, buf)
+        self.ring.submit()
+        with self.assertRaises(BufferError):
+            buf.append(0)
+        self.ring.close()
+        buf.append(0)
+
+
+if __name__ == "__main__":
+    unittest.main()
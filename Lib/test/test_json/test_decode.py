@@ -62,6 +62,32 @@ class TestDecode:
         self.check_keys_reuse(s, decoder.decode)
         self.assertFalse(decoder.memo)
 
+    def test_keys(self):
+        # Keys of all kinds and lengths, with escapes and more distinct keys
+        # than the C scanner caches.
+        keys = ['k%d' % i for i in range(2000)]
+        keys += ['', '\xe9', '\u20ac\u20ac', '\U0001f600', 'a\\"b', '\ud800',
+                 'x' * 64, 'x' * 65, 'y\u20ac' * 40, 'a\nb']
+        obj = [dict.fromkeys(keys[i::7], i) for i in range(7)] * 3
+        for ensure_ascii in True, False:
+            s = self.dumps(obj, ensure_ascii=ensure_ascii)
+            self.assertEqual(self.loads(s), obj)
+            self.assertEqual(self.loads(s.encode('utf-8', 'surrogatepass')),
+                             obj)
+
+    def test_presize_dicts(self):
+        decoder = self.json.decoder.JSONDecoder(presize_dicts=True)
+        self.assertTrue(decoder.presize_dicts)
+        obj = [{'id': i, 'name': str(i), 'tags': {'a': i, 'b': []}}
+               for i in range(10)]
+        obj += [{'id': 5}, {'id': 6, 'other': {}}, {}, {'name': 'x'}]
+        obj.append(dict.fromkeys('abcdefghijklmnopqrstuvwxyz'))
+        obj.append(dict.fromkeys('abc'))
+        s = self.dumps(obj)
+        self.assertEqual(decoder.decode(s), obj)
+        self.assertEqual(decoder.decode(s), obj)
+        self.assertEqual(self.loads(s.encode(), presize_dicts=True), obj)
+
     def test_extra_data(self):
         s = '[1, 2, 3]5'
         msg = 'Extra data'
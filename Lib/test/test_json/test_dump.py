@@ -1,4 +1,4 @@
-from io import StringIO
+from io import BytesIO, StringIO
 from test.test_json import PyTest, CTest
 
 from test.support import bigmemtest, _1G
@@ -12,6 +12,35 @@ class TestDump:
     def test_dumps(self):
         self.assertEqual(self.dumps({}), '{}')
 
+    def test_dump_binary(self):
+        doc = {'a': ['\xe9\u1234\U0001f600', 1, 2.5, None], 'b': '\ud800'}
+        for ensure_ascii in (True, False):
+            for indent in (None, 2):
+                bio = BytesIO()
+                self.json.dump(doc, bio, ensure_ascii=ensure_ascii,
+                               indent=indent)
+                s = self.dumps(doc, ensure_ascii=ensure_ascii, indent=indent)
+                self.assertEqual(bio.getvalue(),
+                                 s.encode('utf-8', 'surrogatepass'))
+                self.assertEqual(self.json.loads(bio.getvalue()), doc)
+
+    def test_dump_large(self):
+        doc = [{'id': i, 'name': 'item%d' % i, 'tags': ['\xe9', '"']}
+               for i in range(20000)]
+        for kwargs in ({}, {'ensure_ascii': False}, {'indent': 1},
+                       {'sort_keys': True, 'separators': (',', ':')}):
+            sio = StringIO()
+            self.json.dump(doc, sio, **kwargs)
+            self.assertEqual(sio.getvalue(), self.dumps(doc, **kwargs))
+
+    def test_dump_iterencode_override(self):
+        class Encoder(self.json.JSONEncoder):
+            def iterencode(self, o, _one_shot=False):
+                yield 'spam'
+        sio = StringIO()
+        self.json.dump([1, 2], sio, cls=Encoder)
+        self.assertEqual(sio.getvalue(), 'spam')
+
     def test_dump_skipkeys(self):
         v = {b'invalid_key': False, 'valid_key': True}
         with self.assertRaises(TypeError):
@@ -62,6 +91,29 @@ class TestPyDump(TestDump, PyTest): pass
 
 class TestCDump(TestDump, CTest):
 
+    def test_dump_chunks(self):
+        class Writer:
+            def __init__(self):
+                self.chunks = []
+            def write(self, chunk):
+                self.chunks.append(chunk)
+        doc = [list(range(1000))] * 100
+        w = Writer()
+        self.json.dump(doc, w)
+        self.assertGreater(len(w.chunks), 1)
+        self.assertLess(len(w.chunks), 10)
+        self.assertEqual(''.join(w.chunks), self.dumps(doc))
+
+    def test_dump_error(self):
+        class Error(Exception):
+            pass
+        def default(o):
+            raise Error
+        sio = StringIO()
+        with self.assertRaises(Error):
+            self.json.dump([1, object()], sio, default=default)
+        self.assertEqual(sio.getvalue(), '')
+
     # The size requirement here is hopefully over-estimated (actual
     # memory consumption depending on implementation details, and also
     # system memory management, since this may allocate a lot of
@@ -138,4 +138,26 @@ class TestScanstring:
 
 
 class TestPyScanstring(TestScanstring, PyTest): pass
-class TestCScanstring(TestScanstring, CTest): pass
+class TestCScanstring(TestScanstring, CTest):
+    def test_scanstring_bytes(self):
+        # The C scanner decodes UTF-8 bytes-like objects, with indices in
+        # bytes.
+        scanstring = self.json.decoder.scanstring
+        for s in ['"z\U0001d120x"', '"\\u007b"', '"\\ud834\\udd20\xe9"',
+                  '"\xe9\\n\u20ac\\t\\"\\\\"', '"\ud800 x"',
+                  '"' + 'a\xe9' * 40 + '\\/' + 'b' * 40 + '"']:
+            value, end = scanstring(s, 1, True)
+            data = s.encode('utf-8', 'surrogatepass')
+            for cls in bytes, bytearray, memoryview:
+                self.assertEqual(scanstring(cls(data), 1, True),
+                                 (value, len(s[:end].encode('utf-8',
+                                                            'surrogatepass'))))
+        self.assertEqual(scanstring(b'"a\x01b"', 1, False), ('a\x01b', 5))
+        for s in [b'"a\x01b"', b'"abc', b'"\\x"', b'"\\u12"', b'"\\u12x4"',
+                  b'"\\ud834\\udd2z"']:
+            with self.assertRaises(self.JSONDecodeError, msg=s) as cm:
+                scanstring(s, 1, True)
+            self.assertEqual(cm.exception.doc, s)
+        self.assertRaises(UnicodeDecodeError, scanstring, b'"\xff"', 1, True)
+        self.assertRaises(ValueError, scanstring, b'""', 3, True)
+        self.assertRaises(TypeError, scanstring, 42, 0, True)
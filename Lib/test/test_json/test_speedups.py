@@ -1,3 +1,4 @@
+from test import support
 from test.test_json import CTest
 
 
@@ -28,6 +29,74 @@ class TestDecode(CTest):
         self.assertRaises(ZeroDivisionError, test, '""')
         self.assertRaises(ZeroDivisionError, test, '{}')
 
+    def test_key_cache(self):
+        # The scanner keeps the keys it decoded across calls
+        decoder = self.json.decoder.JSONDecoder()
+        key, euro = decoder.decode('{"key": 1, "\u20ac": 2}')
+        key2, euro2 = decoder.decode('[{"key": 3, "\u20ac": 4}]')[0]
+        self.assertIs(key2, key)
+        self.assertIs(euro2, euro)
+        key3, euro3 = decoder.scan_once(b'{"key": 5, "\xe2\x82\xac": 6}', 0)[0]
+        self.assertIs(key3, key)
+        self.assertEqual(euro3, euro)
+        # Keys with escapes are not cached
+        key4, = decoder.decode('{"k\\u0065y": 7}')
+        self.assertEqual(key4, key)
+        self.assertIsNot(key4, key)
+
+    def test_presize_dicts(self):
+        decoder = self.json.decoder.JSONDecoder(presize_dicts=True)
+        self.assertTrue(decoder.scan_once.presize_dicts)
+        self.assertFalse(self.json.decoder.JSONDecoder().scan_once.presize_dicts)
+
+        class Context:
+            strict = True
+            object_hook = object_pairs_hook = None
+            parse_float = float
+            parse_int = int
+            parse_constant = None
+        # presize_dicts is optional
+        scanner = self.json.scanner.c_make_scanner(Context())
+        self.assertFalse(scanner.presize_dicts)
+        self.assertEqual(scanner('{"a": 1}', 0), ({'a': 1}, 8))
+
+    @support.cpython_only
+    def test_scan_simd(self):
+        # Strings are searched for quotes, backslashes and control
+        # characters by blocks of 16 or 32 bytes with SIMD instructions if
+        # the CPU has them: compare with the portable code around the block
+        # boundaries.
+        _testinternalcapi = support.import_module('_testinternalcapi')
+        old_level = _testinternalcapi.get_simd_level()
+        self.addCleanup(_testinternalcapi.set_simd_level, old_level)
+        scanstring = self.json.decoder.scanstring
+        find_value_end = self.json.decoder.find_value_end
+
+        def results(s):
+            data = s.encode()
+            res = []
+            for strict in True, False:
+                for doc in s, data:
+                    try:
+                        res.append(scanstring(doc, 1, strict))
+                    except ValueError as exc:
+                        res.append(str(exc))
+            res.append(find_value_end(data, 0, 0))
+            res.append(find_value_end(b'[' + data, 0, 0))
+            return res
+
+        tests = []
+        for c in '"', '\\"', '\\\\', '\x00', '\x1f', '\n', '\x7f', '\xe9':
+            for i in range(70):
+                tests.append('"' + 'a' * i + c + 'b' * 40 + '"')
+                tests.append('"' + 'a' * i + c)
+        _testinternalcapi.set_simd_level(0)
+        expected = [results(s) for s in tests]
+        for level in range(1, old_level + 1):
+            with self.subTest(level=level):
+                _testinternalcapi.set_simd_level(level)
+                self.assertEqual([results(s) for s in tests], expected)
+
 
 class TestEncode(CTest):
     def test_make_encoder(self):
@@ -0,0 +1,154 @@
+import io
+from test.test_json import PyTest, CTest
+
+
+DOCS = [
+    {"a": "x}\\\"y", "€": [1, 2.5, None]},
+    [[], {}, [[[]]]],
+    "text with \"quotes\", \\ and ]}",
+    12345,
+    -0.5e-3,
+    True,
+    None,
+    "",
+    {"nested": {"list": [1, {"b": "\U0001f600"}]}},
+]
+
+
+class TestStream:
+    def encoded(self, sep=b' '):
+        return sep.join(self.dumps(doc).encode() for doc in DOCS)
+
+    def decode_chunks(self, chunks):
+        decoder = self.json.JSONStreamDecoder()
+        values = []
+        for chunk in chunks:
+            decoder.feed(chunk)
+            values.extend(decoder.read_values())
+        decoder.close()
+        values.extend(decoder.read_values())
+        return values
+
+    def test_split_anywhere(self):
+        data = self.encoded()
+        for size in 1, 2, 3, 7, 64:
+            chunks = [data[i:i+size] for i in range(0, len(data), size)]
+            self.assertEqual(self.decode_chunks(chunks), DOCS)
+
+    def test_separators(self):
+        for sep in b'\n', b'\r\n', b' \t ', b'':
+            data = self.encoded(sep)
+            if not sep:
+                # Top-level numbers and constants need a separator
+                data = b' '.join(self.dumps(doc).encode() for doc in DOCS)
+                data = data.replace(b'] {', b']{').replace(b'} [', b'}[')
+            self.assertEqual(self.decode_chunks([data]), DOCS)
+            self.assertEqual(self.decode_chunks([b'\n' + data + b'\n\n']),
+                             DOCS)
+
+    def test_str_chunks(self):
+        data = self.encoded().decode()
+        self.assertEqual(self.decode_chunks([data[:20], data[20:]]), DOCS)
+        self.assertEqual(self.decode_chunks(['"\\ud800"', ' "\ud834"']),
+                         ['\ud800', '\ud834'])
+
+    def test_bom(self):
+        data = self.encoded()
+        self.assertEqual(self.decode_chunks([b'\xef', b'\xbb\xbf' + data]),
+                         DOCS)
+        self.assertEqual(self.decode_chunks([b'\xef\xbb\xbf', b'1']), [1])
+
+    def test_values_as_they_arrive(self):
+        decoder = self.json.JSONStreamDecoder()
+        decoder.feed(b'{"a": 1} [1, ')
+        self.assertEqual(list(decoder.read_values()), [{'a': 1}])
+        decoder.feed(b'2]')
+        self.assertEqual(list(decoder.read_values()), [[1, 2]])
+        decoder.feed(b' 12')
+        self.assertEqual(list(decoder.read_values()), [])
+        decoder.feed(b'3')
+        self.assertEqual(list(decoder.read_values()), [])
+        decoder.close()
+        self.assertEqual(list(decoder.read_values()), [123])
+        self.assertRaises(ValueError, decoder.feed, b'1')
+
+    def test_hooks(self):
+        decoder = self.json.JSONDecoder(object_pairs_hook=list,
+                                        parse_float=str)
+        stream = self.json.JSONStreamDecoder(decoder)
+        stream.feed(b'{"a": 1.5, "b": 2} 3.25 ')
+        self.assertEqual(list(stream.read_values()),
+                         [[('a', '1.5'), ('b', 2)], '3.25'])
+
+    def test_errors(self):
+        decoder = self.json.JSONStreamDecoder()
+        with self.assertRaises(self.JSONDecodeError) as cm:
+            decoder.feed(b'[1] [1, 2} [3]')
+        self.assertEqual(cm.exception.msg, "Expecting ',' delimiter")
+        self.assertEqual(cm.exception.pos, 5)
+        # The bad document is skipped
+        decoder.feed(b' ')
+        self.assertEqual(list(decoder.read_values()), [[1], [3]])
+        for data in b'tru ', b'12x ', b']', b'{"a" 1}', b'"\\q"':
+            decoder = self.json.JSONStreamDecoder()
+            with self.assertRaises(self.JSONDecodeError, msg=data):
+                decoder.feed(data)
+        for data in b'[1', b'{"a": ', b'"abc', b'"\\':
+            decoder = self.json.JSONStreamDecoder()
+            decoder.feed(data)
+            with self.assertRaises(self.JSONDecodeError, msg=data):
+                decoder.close()
+        decoder = self.json.JSONStreamDecoder()
+        self.assertRaises(UnicodeDecodeError, decoder.feed, b'"\xff" ')
+
+    def test_find_value_end(self):
+        find_value_end = self.json.decoder.find_value_end
+        self.assertEqual(find_value_end(b'[1, "]"] 2', 0, 0), (8, 0))
+        self.assertEqual(find_value_end(b'"\\"" 2', 0, 0), (4, 0))
+        self.assertEqual(find_value_end(b'12 3', 0, 0), (2, 0))
+        self.assertEqual(find_value_end(b'123', 1, 0), (3, 4))
+        end, state = find_value_end(b'{"a": [1, "\\', 0, 0)
+        self.assertEqual(end, 12)
+        self.assertNotEqual(state, 0)
+        self.assertEqual(find_value_end(b'{"a": [1, "\\"]"]}', end, state),
+                         (17, 0))
+
+    def test_iterload(self):
+        data = self.encoded(b'\n')
+        for bufsize in 1, 5, 1000:
+            self.assertEqual(list(self.json.iterload(io.BytesIO(data),
+                                                     bufsize=bufsize)),
+                             DOCS)
+        self.assertEqual(list(self.json.iterload(io.StringIO(data.decode()),
+                                                 bufsize=3)),
+                         DOCS)
+        self.assertEqual(list(self.json.iterload(io.BytesIO(b'{"a": 1.5}'),
+                                                 parse_float=str)),
+                         [{'a': '1.5'}])
+        self.assertEqual(list(self.json.iterload(io.BytesIO(b''))), [])
+
+    def test_iterload_lazy(self):
+        class Reader(io.RawIOBase):
+            def __init__(self, chunks):
+                self.chunks = chunks
+            def readable(self):
+                return True
+            def readinto(self, b):
+                if not self.chunks:
+                    return 0
+                chunk = self.chunks.pop(0)
+                b[:len(chunk)] = chunk
+                return len(chunk)
+        reader = Reader([b'[1] [', b'2] ', b'[3]'])
+        it = self.json.iterload(io.BufferedReader(reader))
+        self.assertEqual(next(it), [1])
+        self.assertEqual(reader.chunks, [b'2] ', b'[3]'])
+        self.assertEqual(next(it), [2])
+        self.assertEqual(list(it), [[3]])
+
+
+class TestPyStream(TestStream, PyTest): pass
+class TestCStream(TestStream, CTest):
+    def test_find_value_end_accelerated(self):
+        self.assertIs(self.json.decoder.find_value_end,
+                      self.json.decoder.c_find_value_end)
@@ -79,6 +79,27 @@ class TestUnicode:
         self.assertEqual(self.loads(b'\x007'), 7)
         self.assertEqual(self.loads(b'57'), 57)
 
+    def test_bytes_decode_utf8(self):
+        # UTF-8 input may be parsed without decoding it first: the result
+        # and the errors must be the same as for the decoded str.
+        for s in ['["a\xb5\u20ac\U0001d120", "\ud834"]',
+                  '{"\u0416\u0436": [1.5, "x\\n\\u20ac"]}',
+                  '  "' + 'abc\u20ac' * 20 + '"  ',
+                  '"\\ud834\\udd20\\ud834x"']:
+            data = s.encode('utf-8', 'surrogatepass')
+            self.assertEqual(self.loads(data), self.loads(s))
+            self.assertEqual(self.loads(bytearray(data)), self.loads(s))
+        for s in ['["\xb5", 1,]', '{"\u20ac" 1}', '["\u20ac" 1]',
+                  '[1, 2] x', '"\u20ac\x01"', '[1, "\\q"]']:
+            with self.assertRaises(self.JSONDecodeError) as cm:
+                self.loads(s)
+            with self.assertRaises(self.JSONDecodeError) as cm2:
+                self.loads(s.encode())
+            self.assertEqual(str(cm2.exception), str(cm.exception))
+            self.assertEqual(cm2.exception.doc, s)
+        self.assertRaises(UnicodeDecodeError, self.loads, b'["\x80", x]')
+        self.assertRaises(UnicodeDecodeError, self.loads, b'[1]\xff')
+
     def test_object_pairs_hook_with_unicode(self):
         s = '{"xkd":1, "kcw":2, "art":3, "hxm":4, "qrt":5, "pad":6, "hoy":7}'
         p = [("xkd", 1), ("kcw", 2), ("art", 3), ("hxm", 4),
@@ -12,6 +12,11 @@ SHIFT = sys.int_info.bits_per_digit
 BASE = 2 ** SHIFT
 MASK = BASE - 1
 KARATSUBA_CUTOFF = 70   # from longobject.c
+TOOM3_CUTOFF = 3000     # from longobject.c
+NTT_CUTOFF = 1500       # from longobject.c
+BZ_DIV_CUTOFF = 40      # from longobject.c
+DEC_TO_STR_CUTOFF = 100     # from longobject.c
+DEC_FROM_STR_CUTOFF = 3000  # from longobject.c
 
 # Max number of base BASE digits to use in test cases.  Doubling
 # this will more than double the runtime.
@@ -229,6 +234,96 @@ class LongTest(unittest.TestCase):
                          1)
                     self.assertEqual(x, y)
 
+    def slow_mul(self, x, y):
+        # Multiply by pieces of x small enough for the schoolbook method.
+        step = (KARATSUBA_CUTOFF // 2) * SHIFT
+        ax, ay = abs(x), abs(y)
+        result = 0
+        shift = 0
+        while ax:
+            result += ((ax & ((1 << step) - 1)) * ay) << shift
+            ax >>= step
+            shift += step
+        return result if (x < 0) == (y < 0) else -result
+
+    def test_large_multiplication(self):
+        # Sizes around the cutoffs of Toom-Cook and of the transform based
+        # multiplication, and around the powers of two where the length
+        # of the transform changes.
+        digits = [NTT_CUTOFF, NTT_CUTOFF + 1, 2048, 2049, TOOM3_CUTOFF + 1]
+        for lenx in digits:
+            x = self.getran(lenx)
+            with self.subTest(lenx=lenx):
+                self.assertEqual(x * x, self.slow_mul(x, x))
+                # The largest possible coefficients of the product
+                a = (1 << (lenx * SHIFT)) - 1
+                self.assertEqual(a * a, (a << (lenx * SHIFT)) - a)
+            for leny in digits + [lenx // 3 + 1, lenx * 3]:
+                y = self.getran(leny)
+                with self.subTest(lenx=lenx, leny=leny):
+                    self.assertEqual(x * y, self.slow_mul(x, y))
+                    self.assertEqual(y * x, self.slow_mul(x, y))
+
+    def test_large_division(self):
+        digits = [BZ_DIV_CUTOFF + 1, BZ_DIV_CUTOFF * 2 + 1, BZ_DIV_CUTOFF * 4,
+                  BZ_DIV_CUTOFF * 7 + 3, BZ_DIV_CUTOFF * 25]
+        for leny in digits:
+            for lenq in digits:
+                x = self.getran(leny + lenq)
+                y = self.getran(leny)
+                self.check_division(x, y)
+                q = self.getran(lenq)
+                for r in (0, 1, -1, abs(y) // 2):
+                    self.check_division(y * q + r, y)
+
+        # Divisors with long strings of one bits exercise the estimate of
+        # the quotient in the recursion.
+        for n in (BZ_DIV_CUTOFF * 4, BZ_DIV_CUTOFF * 7 + 1):
+            y = (1 << (n * SHIFT)) - 1
+            self.check_division(y * y, y)
+            self.check_division(y * y - 1, y)
+            self.check_division((y << (n * SHIFT)) - 1, y)
+            self.check_division(((y - 2) << (2 * n * SHIFT)) + y, y)
+            y = (1 << (n * SHIFT - 1)) + 1
+            self.check_division((1 << (3 * n * SHIFT)) - 1, y)
+
+    def test_large_decimal_conversion(self):
+        digits = [DEC_TO_STR_CUTOFF + 1, DEC_TO_STR_CUTOFF * 3,
+                  DEC_TO_STR_CUTOFF * 10 + 5]
+        for lenx in digits:
+            x = self.getran(lenx)
+            with self.subTest(lenx=lenx):
+                s = str(x)
+                self.assertEqual(s, self.slow_format(x, 10))
+                self.assertEqual(int(s), x)
+                self.assertEqual(repr(x), s)
+                self.assertEqual('%d' % x, s)
+                self.assertEqual(format(x, ','), f'{x:,}')
+                self.assertEqual(b'%d' % x, s.encode())
+
+        for ndigits in (DEC_FROM_STR_CUTOFF + 1, DEC_FROM_STR_CUTOFF * 3,
+                        DEC_FROM_STR_CUTOFF * 11 + 4):
+            s = ''.join(random.choice('0123456789') for _ in range(ndigits))
+            with self.subTest(ndigits=ndigits):
+                x = int(s)
+                self.assertEqual(str(x), s.lstrip('0') or '0')
+                self.assertEqual(int('-' + s), -x)
+                self.assertEqual(int(s.encode()), x)
+                self.assertEqual(int(' +%s\n' % s), x)
+                self.assertEqual(int('_'.join(s)), x)
+                n = 10 ** ndigits
+                self.assertEqual(int('1' + '0' * ndigits), n)
+                self.assertEqual(int('9' * ndigits), n - 1)
+                self.assertEqual(str(n), '1' + '0' * ndigits)
+                self.assertEqual(str(-n + 1), '-' + '9' * ndigits)
+                # Leading zeros, and results that are small ints
+                self.assertEqual(int('0' * ndigits + '12'), 12)
+                self.assertEqual(int('-' + '0' * ndigits + '1'), -1)
+                self.assertEqual(int('0' * ndigits), 0)
+                self.assertRaises(ValueError, int, s + '_')
+                self.assertRaises(ValueError, int, s + '__1')
+                self.assertRaises(ValueError, int, s + 'a')
+
     def check_bitop_identities_1(self, x):
         eq = self.assertEqual
         with self.subTest(x=x):
@@ -31,6 +31,11 @@ class CompressorDecompressorTestCase(unittest.TestCase):
         # Can't specify a preset and a custom filter chain at the same time.
         with self.assertRaises(ValueError):
             LZMACompressor(preset=7, filters=[{"id": lzma.FILTER_LZMA2}])
+        self.assertRaises(TypeError, LZMACompressor, threads=1.5)
+        self.assertRaises(ValueError, LZMACompressor, threads=-1)
+        # Only FORMAT_XZ supports several threads.
+        with self.assertRaises(ValueError):
+            LZMACompressor(format=lzma.FORMAT_ALONE, threads=2)
 
         self.assertRaises(TypeError, LZMADecompressor, ())
         self.assertRaises(TypeError, LZMADecompressor, memlimit=b"qw")
@@ -513,6 +518,20 @@ class CompressDecompressFunctionTestCase(unittest.TestCase):
         self.assertEqual(ddata, INPUT * 3)
 
 
+    def test_threads(self):
+        data = INPUT * 1000
+        for threads in (2, 3, 0):
+            for kwargs in ({"preset": 0},
+                           {"filters": [{"id": lzma.FILTER_DELTA},
+                                        {"id": lzma.FILTER_LZMA2,
+                                         "preset": 0}]}):
+                with self.subTest(threads=threads, **kwargs):
+                    x = lzma.compress(data, threads=threads, **kwargs)
+                    self.assertEqual(lzma.decompress(x), data)
+        x = lzma.compress(data, check=lzma.CHECK_SHA256, preset=0, threads=2)
+        self.assertEqual(lzma.decompress(x), data)
+
+
 class TempFile:
     """Context manager - creates a file, and deletes it on __exit__."""
 
@@ -1012,6 +1031,11 @@ class FileTestCase(unittest.TestCase):
                 f.write(INPUT)
             expected = lzma.compress(INPUT)
             self.assertEqual(dst.getvalue(), expected)
+        with BytesIO() as dst:
+            with LZMAFile(dst, "w", preset=0, threads=2) as f:
+                for i in range(1000):
+                    f.write(INPUT)
+            self.assertEqual(lzma.decompress(dst.getvalue()), INPUT * 1000)
         with BytesIO() as dst:
             with LZMAFile(dst, "w", format=lzma.FORMAT_XZ) as f:
                 f.write(INPUT)
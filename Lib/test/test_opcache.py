@@ -0,0 +1,467 @@
+import unittest
+
+# The opcode cache of a code object is only created after it has been
+# executed OPCACHE_MIN_RUNS (1024) times.  Call the functions under test
+# more often than that before checking that the caches are invalidated.
+WARMUP = 1100
+
+
+class TestLoadAttrCache(unittest.TestCase):
+
+    def test_descriptor_added_after_optimization(self):
+        class Descriptor:
+            pass
+
+        class C:
+            def __init__(self):
+                self.x = 1
+
+        def f(o):
+            return o.x
+
+        # C has no class attribute x yet, so o.x is cached as an instance
+        # attribute.
+        o = C()
+        for _ in range(WARMUP):
+            self.assertEqual(f(o), 1)
+
+        C.x = Descriptor()
+        self.assertEqual(f(o), 1)
+        Descriptor.__get__ = lambda self, instance, value: 2
+        Descriptor.__set__ = lambda *args: None
+
+        self.assertEqual(f(o), 2)
+
+    def test_property_added_after_optimization(self):
+        class C:
+            def __init__(self):
+                self.x = 1
+
+        def f(o):
+            return o.x
+
+        o = C()
+        for _ in range(WARMUP):
+            self.assertEqual(f(o), 1)
+
+        C.x = property(lambda self: 2)
+        self.assertEqual(f(o), 2)
+        del C.x
+        self.assertEqual(f(o), 1)
+
+    def test_instance_dict_changes(self):
+        class C:
+            pass
+
+        def f(o):
+            return o.x
+
+        objs = []
+        for i in range(WARMUP):
+            o = C()
+            if i % 2:
+                o.y = i
+            o.x = i
+            objs.append(o)
+        for i, o in enumerate(objs):
+            self.assertEqual(f(o), i)
+
+        o = C()
+        o.x = 1
+        del o.x
+        self.assertRaises(AttributeError, f, o)
+        o.__dict__ = {'x': 'replaced'}
+        self.assertEqual(f(o), 'replaced')
+
+    def test_class_changed(self):
+        class A:
+            def __init__(self):
+                self.x = 'A'
+
+        class B:
+            x = 'B'
+
+        def f(o):
+            return o.x
+
+        o = A()
+        for _ in range(WARMUP):
+            self.assertEqual(f(o), 'A')
+        del o.x
+        o.__class__ = B
+        self.assertEqual(f(o), 'B')
+
+    def test_slots(self):
+        class C:
+            __slots__ = ('x', 'y')
+
+        def f(o):
+            return o.y
+
+        o = C()
+        o.y = 1
+        for _ in range(WARMUP):
+            self.assertEqual(f(o), 1)
+
+        del o.y
+        self.assertRaises(AttributeError, f, o)
+        C.y = 3
+        self.assertEqual(f(o), 3)
+
+    def test_getattr_added_after_optimization(self):
+        class C:
+            pass
+
+        def f(o):
+            return o.x
+
+        o = C()
+        o.x = 1
+        for _ in range(WARMUP):
+            self.assertEqual(f(o), 1)
+
+        del o.x
+        C.__getattr__ = lambda self, name: 'dynamic'
+        self.assertEqual(f(o), 'dynamic')
+
+
+class TestStoreAttrCache(unittest.TestCase):
+
+    def test_store_instance_attribute(self):
+        class C:
+            def __init__(self, a, b):
+                self.a = a
+                self.b = b
+
+        objs = [C(i, -i) for i in range(WARMUP)]
+        for i, o in enumerate(objs):
+            self.assertEqual(vars(o), {'a': i, 'b': -i})
+            self.assertEqual(list(vars(o)), ['a', 'b'])
+
+    def test_store_order_differs(self):
+        class C:
+            pass
+
+        def f(o, v):
+            o.b = v
+
+        for i in range(WARMUP):
+            o = C()
+            if i % 3 == 0:
+                o.a = 'a'
+            f(o, i)
+            self.assertEqual(o.b, i)
+            if i % 3 == 0:
+                self.assertEqual(list(vars(o)), ['a', 'b'])
+            else:
+                self.assertEqual(list(vars(o)), ['b'])
+
+    def test_setter_added_after_optimization(self):
+        class C:
+            pass
+
+        def f(o, v):
+            o.x = v
+
+        o = C()
+        for i in range(WARMUP):
+            f(o, i)
+            self.assertEqual(o.x, i)
+
+        stored = []
+        C.x = property(lambda self: 'prop', lambda self, v: stored.append(v))
+        f(o, 'new')
+        self.assertEqual(stored, ['new'])
+        self.assertEqual(o.__dict__['x'], WARMUP - 1)
+
+    def test_store_slots(self):
+        class C:
+            __slots__ = ('x',)
+
+        def f(o, v):
+            o.x = v
+
+        o = C()
+        for i in range(WARMUP):
+            f(o, [i])
+            self.assertEqual(o.x, [i])
+
+        del C.x
+        self.assertRaises(AttributeError, f, o, 1)
+
+    def test_store_tracks_dict(self):
+        import gc
+
+        class C:
+            pass
+
+        def f(o, v):
+            o.x = v
+
+        o = C()
+        o.x = 1
+        for i in range(WARMUP):
+            f(o, i)
+        f(o, [])
+        self.assertTrue(gc.is_tracked(o.__dict__))
+
+
+class TestLoadMethodCache(unittest.TestCase):
+
+    def test_method_shadowed_by_instance(self):
+        class C:
+            def m(self):
+                return 'method'
+
+        def f(o):
+            return o.m()
+
+        o = C()
+        for _ in range(WARMUP):
+            self.assertEqual(f(o), 'method')
+
+        o.m = lambda: 'instance'
+        self.assertEqual(f(o), 'instance')
+        del o.m
+        self.assertEqual(f(o), 'method')
+
+    def test_shared_keys_grow(self):
+        class C:
+            def __init__(self):
+                self.a = 1
+
+            def m(self):
+                return 'method'
+
+        def f(o):
+            return o.m()
+
+        objs = [C() for _ in range(WARMUP)]
+        for o in objs:
+            self.assertEqual(f(o), 'method')
+
+        # Adding 'm' to one instance can extend the keys shared by all
+        # instances of C.
+        objs[0].m = lambda: 'instance'
+        self.assertEqual(f(objs[0]), 'instance')
+        self.assertEqual(f(objs[1]), 'method')
+        self.assertEqual(f(C()), 'method')
+
+    def test_shared_keys_value_added(self):
+        class C:
+            def __init__(self):
+                self.a = 1
+
+            def m(self):
+                return 'method'
+
+        def f(o):
+            return o.m()
+
+        # The keys shared by the instances of C already contain 'm', so
+        # setting it on another instance does not change them.
+        w = C()
+        w.m = lambda: 'w'
+        x = C()
+        y = C()
+        for _ in range(WARMUP):
+            self.assertEqual(f(y), 'method')
+
+        x.m = lambda: 'instance'
+        self.assertEqual(f(x), 'instance')
+        self.assertEqual(f(w), 'w')
+        self.assertEqual(f(y), 'method')
+
+    def test_method_replaced_on_class(self):
+        class C:
+            def m(self):
+                return 1
+
+        def f(o):
+            return o.m()
+
+        o = C()
+        for _ in range(WARMUP):
+            self.assertEqual(f(o), 1)
+
+        C.m = lambda self: 2
+        self.assertEqual(f(o), 2)
+        C.m = property(lambda self: lambda: 3)
+        self.assertEqual(f(o), 3)
+
+    def test_method_on_base_replaced(self):
+        class A:
+            def m(self):
+                return 'A'
+
+        class B(A):
+            pass
+
+        def f(o):
+            return o.m()
+
+        o = B()
+        for _ in range(WARMUP):
+            self.assertEqual(f(o), 'A')
+
+        A.m = lambda self: 'A2'
+        self.assertEqual(f(o), 'A2')
+        B.m = lambda self: 'B'
+        self.assertEqual(f(o), 'B')
+
+
+class TestSpecializedInstructions(unittest.TestCase):
+    # Hot code objects run from a quickened copy of their bytecode in which
+    # some instructions specialize themselves for the types of the operands
+    # they first see.  They must keep working for any other type afterwards.
+
+    def test_binary_add(self):
+        def f(a, b):
+            return a + b
+
+        for args, expected in [((1, 2), 3), ((1.5, 2.0), 3.5),
+                               (('a', 'b'), 'ab')]:
+            with self.subTest(args=args):
+                f = f.__class__(f.__code__.replace(), {})
+                for _ in range(WARMUP):
+                    self.assertEqual(f(*args), expected)
+                self.assertEqual(f(2**70, 1), 2**70 + 1)
+                self.assertEqual(f(1, 0.5), 1.5)
+                self.assertEqual(f([1], [2]), [1, 2])
+                self.assertEqual(f(True, True), 2)
+                self.assertRaises(TypeError, f, 'a', 1)
+
+    def test_inplace_add(self):
+        def f(a, b):
+            a += b
+            return a
+
+        for args, expected in [((1, 2), 3), ((1.5, 2.0), 3.5),
+                               (('a', 'b'), 'ab')]:
+            with self.subTest(args=args):
+                f = f.__class__(f.__code__.replace(), {})
+                for _ in range(WARMUP):
+                    self.assertEqual(f(*args), expected)
+                self.assertEqual(f(-1, 1), 0)
+                lst = [1]
+                self.assertIs(f(lst, [2]), lst)
+                self.assertEqual(lst, [1, 2])
+                self.assertRaises(TypeError, f, 1, 'a')
+
+    def test_mixed_types(self):
+        # An instruction whose operand types keep changing backs off and
+        # specializes itself again.
+        def f(a, b):
+            return a + b, a[0], a < b
+
+        values = [([1], [2]), ((1,), (2,)), ('a', 'b'), ({0: 1}, {0: 2})]
+        for i in range(20000):
+            a, b = values[i // 7 % len(values)]
+            if isinstance(a, dict):
+                self.assertRaises(TypeError, f, a, b)
+            else:
+                self.assertEqual(f(a, b), (a + b, a[0], a < b))
+
+    def test_string_concatenation_in_loop(self):
+        def f(n):
+            s = ''
+            for i in range(n):
+                s += 'x'
+                s = s + 'y'
+            return s
+
+        for _ in range(WARMUP):
+            self.assertEqual(f(2), 'xyxy')
+        self.assertEqual(f(1000), 'xy' * 1000)
+
+    def test_binary_subscr(self):
+        def f(a, b):
+            return a[b]
+
+        for args, expected in [(([1, 2, 3], 1), 2), (((1, 2, 3), -1), 3),
+                               (({'a': 1}, 'a'), 1)]:
+            with self.subTest(args=args):
+                f = f.__class__(f.__code__.replace(), {})
+                for _ in range(WARMUP):
+                    self.assertEqual(f(*args), expected)
+                self.assertEqual(f([1, 2], -2), 1)
+                self.assertEqual(f((1, 2), 1), 2)
+                self.assertEqual(f('abc', 1), 'b')
+                self.assertEqual(f({1: 'one'}, 1), 'one')
+                self.assertEqual(f([1, 2, 3], slice(1, None)), [2, 3])
+                self.assertRaises(IndexError, f, [1], 1)
+                self.assertRaises(IndexError, f, (1,), -2)
+                self.assertRaises(IndexError, f, [1], 2**100)
+                self.assertRaises(IndexError, f, (1,), -2**100)
+                self.assertRaises(KeyError, f, {}, 'missing')
+                self.assertRaises(TypeError, f, {}, [])
+
+    def test_binary_subscr_huge_index(self):
+        # Indexes which do not fit in Py_ssize_t reach the specialized
+        # forms for list and tuple too.
+        def f(a, b):
+            return a[b]
+
+        for seq in [1, 2, 3], (1, 2, 3):
+            with self.subTest(seq=seq):
+                f = f.__class__(f.__code__.replace(), {})
+                for _ in range(WARMUP):
+                    self.assertEqual(f(seq, 1), 2)
+                for index in 2**64, -2**64, 10**30, -10**30, 2**63, -2**63-1:
+                    self.assertRaises(IndexError, f, seq, index)
+                self.assertEqual(f(seq, -1), 3)
+
+    def test_binary_subscr_subclasses(self):
+        class L(list):
+            def __getitem__(self, i):
+                return 'L'
+
+        class D(dict):
+            def __missing__(self, key):
+                return 'missing'
+
+        def f(a, b):
+            return a[b]
+
+        for _ in range(WARMUP):
+            self.assertEqual(f([1], 0), 1)
+        self.assertEqual(f(L([1]), 0), 'L')
+        f = f.__class__(f.__code__.replace(), {})
+        for _ in range(WARMUP):
+            self.assertEqual(f({'a': 1}, 'a'), 1)
+        self.assertEqual(f(D(), 'a'), 'missing')
+
+    def test_compare_op(self):
+        import operator
+        ops = [operator.lt, operator.le, operator.eq,
+               operator.ne, operator.gt, operator.ge]
+        values = [(1, 2), (2, 2), (3, 2), (-2**100, 2**100), (2**100, 2**100),
+                  (1.0, 2.0), (2.0, 2.0), (float('nan'), 1.0),
+                  (float('nan'), float('nan')), (-0.0, 0.0),
+                  ('a', 'b'), ('b', 'b'), ('é', 'e'),
+                  (1, 1.0), (1.5, 2), ((1,), (2,)), ([2], [1])]
+        sources = ['a < b', 'a <= b', 'a == b', 'a != b', 'a > b', 'a >= b']
+        for source, op in zip(sources, ops):
+            for warm in [(1, 2), (1.0, 2.0), ('a', 'b')]:
+                with self.subTest(source=source, warm=warm):
+                    f = eval(f'lambda a, b: {source}')
+                    for _ in range(WARMUP):
+                        self.assertIs(f(*warm), op(*warm))
+                    for a, b in values:
+                        self.assertIs(f(a, b), op(a, b), (a, b))
+
+    def test_compare_op_in_branch(self):
+        def f(a, b):
+            if a < b:
+                return 'lt'
+            return 'ge'
+
+        for _ in range(WARMUP):
+            self.assertEqual(f(1, 2), 'lt')
+        self.assertEqual(f(2, 1), 'ge')
+        self.assertEqual(f('b', 'a'), 'ge')
+        self.assertRaises(TypeError, f, 1, 'a')
+
+
+if __name__ == "__main__":
+    unittest.main()
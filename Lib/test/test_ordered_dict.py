@@ -737,7 +737,7 @@ class CPythonOrderedDictTests(OrderedDictTests, unittest.TestCase):
         size = support.calcobjsize
         check = self.check_sizeof
 
-        basicsize = size('nQ2P' + '3PnPn2P') + calcsize('2nP2n')
+        basicsize = size('nQ2P' + '3PnPn2P') + calcsize('2nP2nI0P')
 
         entrysize = calcsize('n2P')
         p = calcsize('P')
@@ -373,6 +373,87 @@ class FileTests(unittest.TestCase):
             self.assertEqual(read[out_seek:],
                              data[in_skip:in_skip+i])
 
+    @unittest.skipUnless(hasattr(os, 'splice'), 'test needs os.splice()')
+    def test_splice_invalid_values(self):
+        with self.assertRaises(ValueError):
+            os.splice(0, 1, -10)
+
+    @unittest.skipUnless(hasattr(os, 'splice'), 'test needs os.splice()')
+    def test_splice(self):
+        TESTFN2 = support.TESTFN + ".3"
+        data = b'0123456789'
+
+        create_file(support.TESTFN, data)
+        self.addCleanup(support.unlink, support.TESTFN)
+
+        in_file = open(support.TESTFN, 'rb')
+        self.addCleanup(in_file.close)
+        in_fd = in_file.fileno()
+
+        read_fd, write_fd = os.pipe()
+        self.addCleanup(lambda: os.close(read_fd))
+        self.addCleanup(lambda: os.close(write_fd))
+
+        # file -> pipe, from the current position
+        i = os.splice(in_fd, write_fd, 5)
+        self.assertIn(i, range(0, 6))
+        self.assertEqual(os.read(read_fd, 100), data[:i])
+        self.assertEqual(in_file.tell(), i)
+
+        # file -> pipe, from an offset; the position is left alone
+        i = os.splice(in_fd, write_fd, 3, offset_src=7)
+        self.assertIn(i, range(0, 4))
+        self.assertEqual(os.read(read_fd, 100), data[7:7+i])
+
+        # pipe -> file, to an offset
+        out_file = open(TESTFN2, 'w+b')
+        self.addCleanup(support.unlink, TESTFN2)
+        self.addCleanup(out_file.close)
+        os.write(write_fd, data)
+        i = os.splice(read_fd, out_file.fileno(), len(data), offset_dst=2,
+                      flags=os.SPLICE_F_MOVE)
+        self.assertIn(i, range(0, len(data) + 1))
+        with open(TESTFN2, 'rb') as f:
+            self.assertEqual(f.read(), b'\x00\x00' + data[:i])
+
+        # an offset on a pipe is an error
+        with self.assertRaises(OSError) as cm:
+            os.splice(in_fd, write_fd, 1, offset_dst=0)
+        self.assertEqual(cm.exception.errno, errno.ESPIPE)
+
+    @unittest.skipUnless(hasattr(os, 'splice'), 'test needs os.splice()')
+    def test_splice_nonblock(self):
+        read_fd, write_fd = os.pipe()
+        self.addCleanup(lambda: os.close(read_fd))
+        self.addCleanup(lambda: os.close(write_fd))
+        read_fd2, write_fd2 = os.pipe()
+        self.addCleanup(lambda: os.close(read_fd2))
+        self.addCleanup(lambda: os.close(write_fd2))
+        with self.assertRaises(BlockingIOError):
+            os.splice(read_fd, write_fd2, 10, flags=os.SPLICE_F_NONBLOCK)
+
+    @unittest.skipUnless(hasattr(os, 'tee'), 'test needs os.tee()')
+    def test_tee(self):
+        data = b'0123456789'
+        read_fd, write_fd = os.pipe()
+        self.addCleanup(lambda: os.close(read_fd))
+        self.addCleanup(lambda: os.close(write_fd))
+        read_fd2, write_fd2 = os.pipe()
+        self.addCleanup(lambda: os.close(read_fd2))
+        self.addCleanup(lambda: os.close(write_fd2))
+
+        os.write(write_fd, data)
+        i = os.tee(read_fd, write_fd2, 100)
+        self.assertEqual(i, len(data))
+        self.assertEqual(os.read(read_fd2, 100), data)
+        # the data is still in the first pipe
+        self.assertEqual(os.read(read_fd, 100), data)
+
+        with self.assertRaises(ValueError):
+            os.tee(read_fd, write_fd2, -1)
+        with self.assertRaises(BlockingIOError):
+            os.tee(read_fd, write_fd2, 10, os.SPLICE_F_NONBLOCK)
+
 # Test attributes on return values from os.*stat* family.
 class StatAttributeTests(unittest.TestCase):
     def setUp(self):
@@ -21,6 +21,7 @@ from test.pickletester import AbstractPicklerUnpicklerObjectTests
 from test.pickletester import AbstractDispatchTableTests
 from test.pickletester import AbstractCustomPicklerClass
 from test.pickletester import BigmemPickleTests
+from test.pickletester import C, ShapedSlots
 
 try:
     import _pickle
@@ -223,6 +224,20 @@ if has_c_implementation:
         pickler = _pickle.Pickler
         unpickler = _pickle.Unpickler
 
+        def test_shapes_same_as_python(self):
+            objs = []
+            for names in ['ab', 'a', 'ab', 'ba', '', 'abc', 'a', 'ab']:
+                x = C()
+                for name in names:
+                    setattr(x, name, name.upper())
+                objs.append(x)
+            objs += [ShapedSlots(1, 2), ShapedSlots(3), ShapedSlots(4, 5),
+                     ShapedSlots(6, c=7), ShapedSlots(), ShapedSlots(8)]
+            for proto in range(2, pickle.HIGHEST_PROTOCOL + 1):
+                with self.subTest(proto=proto):
+                    self.assertEqual(self.dumps(objs, proto, shapes=True),
+                                     pickle._dumps(objs, proto, shapes=True))
+
     class CPersPicklerTests(PyPersPicklerTests):
         pickler = _pickle.Pickler
         unpickler = _pickle.Unpickler
@@ -272,7 +287,7 @@ if has_c_implementation:
         check_sizeof = support.check_sizeof
 
         def test_pickler(self):
-            basesize = support.calcobjsize('7P2n3i2n3i2P')
+            basesize = support.calcobjsize('7P2n3i2n3i3P')
             p = _pickle.Pickler(io.BytesIO())
             self.assertEqual(object.__sizeof__(p), basesize)
             MT_size = struct.calcsize('3nP0n')
@@ -1,9 +1,13 @@
 from test.support import (gc_collect, bigmemtest, _2G,
                           cpython_only, captured_stdout)
 import locale
+import random
 import re
+import signal
 import sre_compile
+import sre_parse
 import string
+import sys
 import unittest
 import warnings
 from re import Scanner
@@ -82,6 +86,36 @@ class ReTests(unittest.TestCase):
         self.assertEqual(re.match('x*', 'xxxa').span(), (0, 3))
         self.assertIsNone(re.match('a+', 'xxx'))
 
+    def test_search_required_literal(self):
+        # Patterns which contain a literal after their start
+        p = re.compile(r'.*ERROR code=(\d+)')
+        self.assertIsNone(p.search('INFO\n' * 100))
+        m = p.search('INFO\nERROR\nwarn: ERROR code=42\nERROR code=')
+        self.assertEqual(m.span(), (11, 30))
+        self.assertEqual(m.group(1), '42')
+        self.assertEqual(p.findall('ERROR code=1\nx ERROR code=2 ERROR code=3'),
+                         ['1', '3'])
+        self.assertEqual(p.search('xERROR code=1', 1).span(), (1, 13))
+        self.assertIsNone(p.search('xERROR code=1', 2))
+        self.assertIsNone(p.search('xERROR code=1', 0, 12))
+        self.assertEqual(re.search(r'(?s).*ab', 'x\nyab').span(), (0, 5))
+        self.assertEqual(re.search(r'\d{1,3}-ab', '1234-ab').span(), (1, 7))
+        self.assertEqual(re.search(r'[^,]*,ab', 'x,y,z,ab').span(), (4, 8))
+        self.assertEqual(re.search(r'\w+=1', 'a=2 b=1').span(), (4, 7))
+        self.assertEqual(re.search(r'(?i)\w+=1', 'a=2 B=1').span(), (4, 7))
+        self.assertEqual(re.search(r'x*(?:a|b)=1', 'a=2 b=1').span(), (4, 7))
+        self.assertEqual(re.search(br'.*ab', b'x\nyab').span(), (2, 5))
+        self.assertEqual(re.search(r'.*\xe0b', 'x\n\xe0b').span(), (2, 4))
+        self.assertEqual(re.search(r'.*\u0430b', 'x\n\u0430b').span(), (2, 4))
+        self.assertEqual(re.search(r'.*\U0001d49cb', 'x\n\U0001d49cb').span(),
+                         (2, 4))
+        self.assertIsNone(re.search(r'.*\u0430b', 'x\nab'))
+        self.assertIsNone(re.search(r'.*\U0001d49cb', 'x\n\u0430b'))
+        self.assertEqual(re.findall(r'\w*a', 'ba ca'), ['ba', 'ca'])
+        self.assertEqual(re.findall(r'(?:x*)a', 'aa'), ['a', 'a'])
+        self.assertEqual(re.sub(r'\d*ab', '-', '1ab2abab'), '---')
+        self.assertEqual(re.search(r'(?<=a)\w*bc', 'xabc').span(), (2, 4))
+
     def bump_num(self, matchobj):
         int_value = int(matchobj.group(0))
         return str(int_value + 1)
@@ -1083,6 +1117,99 @@ class ReTests(unittest.TestCase):
         for flag in [re.I, re.M, re.X, re.S, re.A, re.L]:
             self.assertTrue(re.compile(b'^pattern$', flag))
 
+    def test_dfa(self):
+        # The DFA flag finds the same matches and groups as the
+        # backtracking engine.
+        patterns = [
+            r'(a|ab)(c|bcd)(d*)', r'(a+)(b*)c|x', r'(a?)*', r'(?:|a)*',
+            r'(a*)*b', r'(a|b)*?c', r'((a)|b)+', r'(a){2,3}?(a*)',
+            r'\bfoo\b|bar$', r'^\w+$', r'\Aa|b\Z', r'(?s).+', r'(?i)ǅ+',
+            r'([^\W\d]+)(\d*)', r'(\s?\S*)+', r'(?:(a)|(b)|(c))*',
+            r'(x+x+)+[yz]', '\U0001f600|é+', r'(?m)^$', r'\B.\B',
+        ]
+        subjects = ['', 'a', 'aab', 'abcd', 'abcbcdd', 'xaacab',
+                    'foo bar\nbar foox', 'aaa\n\nbb ab', 'ǄǅǆǇ',
+                    'é\U0001f600éé 12ab3', 'xxxxxxxxxxxxxxxxxxxx']
+        def result(m):
+            return m and (m.regs, m.lastindex, m.lastgroup)
+        for pattern in patterns:
+            for flags in 0, re.M, re.S | re.I:
+                p = re.compile(pattern, flags)
+                q = re.compile(pattern, flags | re.DFA)
+                self.assertEqual(q.flags, p.flags | re.DFA)
+                for s in subjects:
+                    with self.subTest(pattern=pattern, flags=flags, s=s):
+                        for method in 'search', 'match', 'fullmatch':
+                            self.assertEqual(
+                                result(getattr(q, method)(s)),
+                                result(getattr(p, method)(s)))
+                            self.assertEqual(
+                                result(getattr(q, method)(s, 2, 5)),
+                                result(getattr(p, method)(s, 2, 5)))
+                        self.assertEqual(q.findall(s), p.findall(s))
+                        self.assertEqual(q.sub('-', s), p.sub('-', s))
+                        self.assertEqual(q.split(s), p.split(s))
+        q = re.compile(rb'(a|ab)(c|bcd)(d*)', re.DFA)
+        self.assertEqual(q.search(b'xabcd').regs,
+                         ((1, 5), (1, 2), (2, 5), (5, 5)))
+
+    def test_dfa_errors(self):
+        for pattern in r'(a)\1', r'(?P<x>a)(?P=x)', r'(a)?(?(1)b|c)':
+            with self.assertRaisesRegex(re.error, 'group references'):
+                re.compile(pattern, re.DFA)
+        for pattern in r'(?=a)', r'a(?!b)', r'(?<=a)b', r'(?<!a)b':
+            with self.assertRaisesRegex(re.error, 'lookaround'):
+                re.compile(pattern, re.DFA)
+        with self.assertRaisesRegex(re.error, 'LOCALE'):
+            re.compile(rb'\w', re.DFA | re.LOCALE)
+        with self.assertRaises(OverflowError):
+            re.compile(r'(?:a{1000}){1000}', re.DFA)
+
+    def test_dfa_linear(self):
+        # Patterns which make the backtracking engine take exponential
+        # time are matched in linear time.
+        self.assertIsNone(re.search(r'(x+x+)+[yz]', 'x' * 100000, re.DFA))
+        self.assertIsNone(re.match(r'(a|aa)*b|(a|aa)*c', 'a' * 100000,
+                                   re.DFA))
+        words = ['word%d' % i for i in range(2000)]
+        p = re.compile(r'\b(?:%s)\b' % '|'.join(words), re.DFA)
+        self.assertEqual(p.findall(' '.join(words[::7]) + ' word'),
+                         words[::7])
+
+    @cpython_only
+    def test_dfa_sizeof(self):
+        p = re.compile(r'(\w+)\s*=\s*(\d+)')
+        q = re.compile(p.pattern, re.DFA)
+        size = sys.getsizeof(q)
+        self.assertGreater(size, sys.getsizeof(p))
+        # the states built by a match are counted
+        q.search('spam = 42')
+        self.assertGreater(sys.getsizeof(q), size)
+
+    @unittest.skipUnless(hasattr(signal, 'setitimer'), 'requires setitimer()')
+    def test_dfa_reentrant(self):
+        # A signal handler which runs during a DFA match can use the same
+        # pattern, even if it needs so many new states that the cache of
+        # the automaton is flushed.
+        p = re.compile(r'(?:a|b)*a(?:a|b){17}c', re.DFA)
+        rng = random.Random(0)
+        def make_string(n):
+            return ''.join(rng.choice('ab') for i in range(n)) + 'a' * 18 + 'c'
+        string = make_string(400000)
+        other = make_string(50000)
+        spans = []
+        def handler(signum, frame):
+            spans.append(p.search(other).span())
+        old_handler = signal.signal(signal.SIGALRM, handler)
+        self.addCleanup(signal.signal, signal.SIGALRM, old_handler)
+        try:
+            for i in range(10):
+                signal.setitimer(signal.ITIMER_REAL, 0.01)
+                self.assertEqual(p.search(string).span(), (0, len(string)))
+        finally:
+            signal.setitimer(signal.ITIMER_REAL, 0)
+        self.assertEqual(set(spans), {(0, len(other))})
+
     def test_sre_character_literals(self):
         for i in [0, 8, 16, 32, 64, 127, 128, 255, 256, 0xFFFF, 0x10000, 0x10FFFF]:
             if i < 256:
@@ -2197,6 +2324,34 @@ class ImplementationTest(unittest.TestCase):
         self.assertEqual(f("ababba"), [0, 0, 1, 2, 0, 1])
         self.assertEqual(f("abcabdac"), [0, 0, 0, 1, 2, 0, 1, 0])
 
+    def test_required_literal(self):
+        def f(pattern):
+            p = sre_parse.parse(pattern)
+            r = sre_compile._get_required_literal(p, p.state.flags)
+            if r is None:
+                return None
+            literal, hi, stop = r
+            if stop == sre_compile.MAXCODE:
+                stop = None
+            else:
+                stop = chr(stop)
+            return ''.join(map(chr, literal)), hi, stop
+        MAXREPEAT = sre_compile.MAXREPEAT
+        self.assertEqual(f(r'.*ERROR code=(\d+)'),
+                         ('ERROR code=', MAXREPEAT, '\n'))
+        self.assertEqual(f(r'\d{1,3}ab'), ('ab', 3, '\n'))
+        self.assertEqual(f(r'(\d+)a(bc)'), ('abc', MAXREPEAT, '\n'))
+        self.assertEqual(f(r'[^,]*,ab'), (',ab', MAXREPEAT, ','))
+        self.assertEqual(f(r'[^,]*\nab'), ('\nab', MAXREPEAT, ','))
+        self.assertEqual(f(r'\s*ab'), ('ab', MAXREPEAT, None))
+        self.assertEqual(f(r'(?s).*ab'), ('ab', MAXREPEAT, None))
+        self.assertEqual(f(r'(?i)\w+=1b'), ('=1', MAXREPEAT, '\n'))
+        self.assertEqual(f(r'\d*' + 'a' * 100), ('a' * 64, MAXREPEAT, '\n'))
+        self.assertIsNone(f(r'\d*(?:ab)?'))
+        self.assertIsNone(f(r'\d*(?:ab|cd)'))
+        self.assertIsNone(f(r'\d*(?=ab)'))
+        self.assertIsNone(f(r'(?i)\w+b'))
+
 
 class ExternalTests(unittest.TestCase):
 
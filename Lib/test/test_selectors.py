@@ -558,6 +558,45 @@ class KqueueSelectorTestCase(BaseSelectorTestCase, ScalableSelectorMixIn):
         self.assertTrue(0.8 <= dt <= 2.0, dt)
 
 
+@unittest.skipUnless(hasattr(selectors, 'IoUringSelector'),
+                     "Test needs selectors.IoUringSelector")
+class IoUringSelectorTestCase(BaseSelectorTestCase, ScalableSelectorMixIn):
+
+    SELECTOR = getattr(selectors, 'IoUringSelector', None)
+
+    def setUp(self):
+        # io_uring can be disabled or forbidden by a seccomp filter
+        try:
+            self.SELECTOR().close()
+        except OSError as exc:
+            self.skipTest(f"io_uring is not available: {exc}")
+
+    def test_register_file(self):
+        # unlike epoll, io_uring polls regular files, which are always ready
+        s = self.SELECTOR()
+        self.addCleanup(s.close)
+        with tempfile.NamedTemporaryFile() as f:
+            s.register(f, selectors.EVENT_READ | selectors.EVENT_WRITE)
+            self.assertEqual(s.select(timeout=0),
+                             [(s.get_key(f),
+                               selectors.EVENT_READ | selectors.EVENT_WRITE)])
+            s.unregister(f)
+
+    def test_select_requeue(self):
+        # the poll operation is queued again after it completes
+        s = self.SELECTOR()
+        self.addCleanup(s.close)
+        rd, wr = self.make_socketpair()
+        s.register(rd, selectors.EVENT_READ)
+        self.assertEqual(s.select(timeout=0), [])
+        wr.send(b'x')
+        for i in range(3):
+            self.assertEqual(s.select(timeout=1),
+                             [(s.get_key(rd), selectors.EVENT_READ)])
+        rd.recv(1)
+        self.assertEqual(s.select(timeout=0), [])
+
+
 @unittest.skipUnless(hasattr(selectors, 'DevpollSelector'),
                      "Test needs selectors.DevpollSelector")
 class DevpollSelectorTestCase(BaseSelectorTestCase, ScalableSelectorMixIn):
@@ -569,7 +608,8 @@ class DevpollSelectorTestCase(BaseSelectorTestCase, ScalableSelectorMixIn):
 def test_main():
     tests = [DefaultSelectorTestCase, SelectSelectorTestCase,
              PollSelectorTestCase, EpollSelectorTestCase,
-             KqueueSelectorTestCase, DevpollSelectorTestCase]
+             IoUringSelectorTestCase, KqueueSelectorTestCase,
+             DevpollSelectorTestCase]
     support.run_unittest(*tests)
     support.reap_children()
 
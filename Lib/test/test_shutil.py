@@ -16,6 +16,7 @@ import random
 import string
 import contextlib
 import io
+import threading
 from shutil import (make_archive,
                     register_archive_format, unregister_archive_format,
                     get_archive_formats, Error, unpack_archive,
@@ -147,6 +148,23 @@ def supports_file2file_sendfile():
 
 SUPPORTS_SENDFILE = supports_file2file_sendfile()
 
+def supports_copy_file_range():
+    if not hasattr(os, "copy_file_range"):
+        return False
+    with tempfile.TemporaryFile(dir=os.getcwd()) as src:
+        src.write(b"0123456789")
+        src.flush()
+        with tempfile.TemporaryFile(dir=os.getcwd()) as dst:
+            try:
+                os.copy_file_range(src.fileno(), dst.fileno(), 2, 0)
+            except OSError:
+                return False
+            else:
+                return True
+
+
+SUPPORTS_COPY_FILE_RANGE = supports_copy_file_range()
+
 # AIX 32-bit mode, by default, lacks enough memory for the xz/lzma compiler test
 # The AIX command 'dump -o program' gives XCOFF header information
 # The second word of the last line in the maxdata value
@@ -2201,6 +2219,65 @@ class TestCopyFileObj(unittest.TestCase):
             self.assertEqual(src.tell(), self.FILESIZE)
             self.assertEqual(dst.tell(), self.FILESIZE)
 
+    def test_buffered_offset(self):
+        # Data already read ahead into the buffer of src is copied, and
+        # the positions of the buffered objects match their file
+        # descriptors.
+        with open(TESTFN, 'rb') as src:
+            data = src.read()
+        with self.get_files() as (src, dst):
+            self.assertEqual(src.read(10), data[:10])
+            dst.write(b'spam')
+            shutil.copyfileobj(src, dst)
+            self.assertEqual(src.tell(), self.FILESIZE)
+            self.assertEqual(src.read(), b'')
+            self.assertEqual(dst.tell(), self.FILESIZE - 6)
+            dst.write(b'eggs')
+        self.assertEqual(read_file(TESTFN2, binary=True),
+                         b'spam' + data[10:] + b'eggs')
+
+    def test_append_mode(self):
+        write_file(TESTFN2, b'spam', binary=True)
+        with open(TESTFN, 'rb') as src:
+            with open(TESTFN2, 'ab') as dst:
+                shutil.copyfileobj(src, dst)
+        with open(TESTFN, 'rb') as src:
+            self.assertEqual(read_file(TESTFN2, binary=True),
+                             b'spam' + src.read())
+
+    @unittest.skipUnless(hasattr(os, 'splice'), 'requires os.splice()')
+    def test_pipe(self):
+        with open(TESTFN, 'rb') as src:
+            data = src.read()
+        r, w = os.pipe()
+        with open(r, 'rb') as fr, open(w, 'wb') as fw:
+            def writer():
+                with open(TESTFN, 'rb') as src:
+                    shutil.copyfileobj(src, fw)
+                fw.close()
+            with unittest.mock.patch('os.splice',
+                                     wraps=os.splice) as m:
+                t = threading.Thread(target=writer)
+                t.start()
+                try:
+                    with open(TESTFN2, 'wb') as dst:
+                        shutil.copyfileobj(fr, dst)
+                finally:
+                    t.join()
+            self.assertTrue(m.called)
+        self.assertEqual(read_file(TESTFN2, binary=True), data)
+
+    @unittest.skipUnless(hasattr(os, 'splice'), 'requires os.splice()')
+    def test_pipe_offset(self):
+        r, w = os.pipe()
+        with open(r, 'rb') as fr, open(TESTFN2, 'wb') as dst:
+            os.write(w, b'spam and eggs')
+            os.close(w)
+            self.assertEqual(fr.read(1), b's')
+            shutil.copyfileobj(fr, dst)
+            self.assertEqual(dst.tell(), 12)
+        self.assertEqual(read_file(TESTFN2, binary=True), b'pam and eggs')
+
     @unittest.skipIf(os.name != 'nt', "Windows only")
     def test_win_impl(self):
         # Make sure alternate Windows implementation is called.
@@ -2336,6 +2413,12 @@ class _ZeroCopyFileTest(object):
 class TestZeroCopySendfile(_ZeroCopyFileTest, unittest.TestCase):
     PATCHPOINT = "os.sendfile"
 
+    def setUp(self):
+        # copyfile() tries copy_file_range() first.
+        patcher = unittest.mock.patch('shutil._USE_CP_COPY_FILE_RANGE', False)
+        patcher.start()
+        self.addCleanup(patcher.stop)
+
     def zerocopy_fun(self, fsrc, fdst):
         return shutil._fastcopy_sendfile(fsrc, fdst)
 
@@ -2451,6 +2534,75 @@ class TestZeroCopySendfile(_ZeroCopyFileTest, unittest.TestCase):
             shutil._USE_CP_SENDFILE = True
 
 
+@unittest.skipIf(not SUPPORTS_COPY_FILE_RANGE,
+                 'os.copy_file_range() not supported')
+class TestZeroCopyCopyFileRange(_ZeroCopyFileTest, unittest.TestCase):
+    PATCHPOINT = "os.copy_file_range"
+
+    def zerocopy_fun(self, fsrc, fdst):
+        return shutil._fastcopy_copy_file_range(fsrc, fdst)
+
+    def test_empty_file(self):
+        # Files of special filesystems (e.g. procfs) look empty to
+        # copy_file_range(), read() has the last word.
+        srcname = TESTFN + 'src'
+        self.addCleanup(lambda: support.unlink(srcname))
+        write_file(srcname, b'', binary=True)
+        with open(srcname, "rb") as src:
+            with open(TESTFN2, "wb") as dst:
+                with self.assertRaises(_GiveupOnFastCopy):
+                    self.zerocopy_fun(src, dst)
+        shutil.copyfile(srcname, TESTFN2)
+        self.assertEqual(read_file(TESTFN2, binary=True), b"")
+
+    def test_cross_device(self):
+        # Linux < 5.3 fails with EXDEV across filesystems, copyfile()
+        # falls back on sendfile().
+        with unittest.mock.patch(self.PATCHPOINT,
+                                 side_effect=OSError(errno.EXDEV, "yo")) as m:
+            shutil.copyfile(TESTFN, TESTFN2)
+            assert m.called
+        self.assertEqual(read_file(TESTFN2, binary=True), self.FILEDATA)
+
+    def test_exception_on_second_call(self):
+        def copy_file_range(*args, **kwargs):
+            if not flag:
+                flag.append(None)
+                return orig_copy_file_range(*args, **kwargs)
+            else:
+                raise OSError(errno.EBADF, "yo")
+
+        flag = []
+        orig_copy_file_range = os.copy_file_range
+        with unittest.mock.patch('os.copy_file_range',
+                                 side_effect=copy_file_range):
+            with self.get_files() as (src, dst):
+                with self.assertRaises(OSError) as cm:
+                    shutil._fastcopy_copy_file_range(src, dst)
+        assert flag
+        self.assertEqual(cm.exception.errno, errno.EBADF)
+
+    def test_not_implemented(self):
+        # Emulate a kernel without copy_file_range(). copyfile() is
+        # supposed to skip it from then on.
+        assert shutil._USE_CP_COPY_FILE_RANGE
+        try:
+            with unittest.mock.patch(
+                    self.PATCHPOINT,
+                    side_effect=OSError(errno.ENOSYS, "yo")) as m:
+                with self.get_files() as (src, dst):
+                    with self.assertRaises(_GiveupOnFastCopy):
+                        shutil._fastcopy_copy_file_range(src, dst)
+                assert m.called
+            assert not shutil._USE_CP_COPY_FILE_RANGE
+
+            with unittest.mock.patch(self.PATCHPOINT) as m:
+                shutil.copyfile(TESTFN, TESTFN2)
+                assert not m.called
+        finally:
+            shutil._USE_CP_COPY_FILE_RANGE = True
+
+
 @unittest.skipIf(not MACOS, 'macOS only')
 class TestZeroCopyMACOS(_ZeroCopyFileTest, unittest.TestCase):
     PATCHPOINT = "posix._fcopyfile"
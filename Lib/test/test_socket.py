@@ -2569,6 +2569,49 @@ class BasicUDPTest(ThreadedUDPSocketTest):
     def _testRecvFromNegative(self):
         self.cli.sendto(MSG, 0, (HOST, self.port))
 
+    @requireAttrs(socket.socket, "sendmmsg", "recvmmsg_into")
+    def testSendmmsgAndRecvmmsgInto(self):
+        # Testing sendmmsg() and recvmmsg_into() over UDP
+        self.assertEqual(self.serv.recvmmsg_into([]), [])
+        bufs = [bytearray(len(MSG)) for i in range(4)]
+        results = []
+        while len(results) < 3:
+            results += self.serv.recvmmsg_into(bufs[len(results):])
+        self.assertEqual(len(results), 3)
+        self.assertEqual([nbytes for nbytes, flags, addr in results],
+                         [len(MSG), 3, len(MSG)])
+        for nbytes, flags, addr in results:
+            self.assertEqual(flags, 0)
+            self.assertEqual(addr, self.cli_addr)
+        self.assertEqual(bufs[0], MSG)
+        self.assertEqual(bufs[1][:3], b'abc')
+        self.assertEqual(bufs[2], MSG[::-1])
+        self.assertEqual(bufs[3], bytes(len(MSG)))
+
+    def _testSendmmsgAndRecvmmsgInto(self):
+        self.assertEqual(self.cli.sendmmsg([]), 0)
+        with self.assertRaises(ValueError):
+            self.cli.sendmmsg([MSG], 0, [])
+        self.cli.bind((HOST, 0))
+        self.cli_addr = self.cli.getsockname()
+        self.assertEqual(
+            self.cli.sendmmsg([MSG, b'abc', memoryview(MSG[::-1])], 0,
+                              [(HOST, self.port)] * 3),
+            3)
+
+    @requireAttrs(socket.socket, "sendmmsg", "recvmmsg_into")
+    def testRecvmmsgIntoTrunc(self):
+        # Messages larger than the buffers are truncated
+        buf = bytearray(2)
+        [(nbytes, flags, addr)] = self.serv.recvmmsg_into([buf])
+        self.assertEqual(nbytes, 2)
+        self.assertTrue(flags & socket.MSG_TRUNC)
+        self.assertEqual(buf, MSG[:2])
+
+    def _testRecvmmsgIntoTrunc(self):
+        self.cli.connect((HOST, self.port))
+        self.assertEqual(self.cli.sendmmsg([MSG]), 1)
+
 
 @unittest.skipUnless(HAVE_SOCKET_UDPLITE,
           'UDPLITE sockets required for this test.')
@@ -6026,6 +6069,27 @@ class SendfileUsingSendTest(ThreadedTCPSocketTest):
         self.assertEqual(len(data), self.FILESIZE)
         self.assertEqual(data, self.FILEDATA)
 
+    # pipe
+
+    def _testPipe(self):
+        address = self.serv.getsockname()
+        r, w = os.pipe()
+        # Small enough to fit into the pipe.
+        os.write(w, self.FILEDATA[:16384])
+        os.close(w)
+        file = open(r, 'rb', buffering=1024)
+        with socket.create_connection(address) as sock, file as file:
+            # Some data is read ahead into the buffer first.
+            file.peek()
+            meth = self.meth_from_sock(sock)
+            sent = meth(file)
+            self.assertEqual(sent, 16384)
+
+    def testPipe(self):
+        conn = self.accept_conn()
+        data = self.recv_data(conn)
+        self.assertEqual(data, self.FILEDATA[:16384])
+
     # empty file
 
     def _testEmptyFileSend(self):
@@ -856,5 +856,140 @@ class UnpackIteratorTest(unittest.TestCase):
             self.assertEqual(bits, struct.pack(formatcode, f))
 
 
+class BulkTest(unittest.TestCase):
+    """
+    Tests for column-wise packing and unpacking (struct.Struct.pack_many
+    and struct.Struct.unpack_many).
+    """
+
+    def check(self, fmt, *columns):
+        s = struct.Struct(fmt)
+        data = b''.join(s.pack(*record) for record in zip(*columns))
+        self.assertEqual(s.pack_many(*columns), data)
+        self.assertEqual(s.unpack_many(data),
+                         tuple(map(list, zip(*s.iter_unpack(data))))
+                         if data else tuple([] for c in columns))
+        return s.unpack_many(data)
+
+    def test_integers(self):
+        for code, byteorder in iter_integer_formats():
+            fmt = byteorder + code + 'b' + code
+            size = struct.calcsize(byteorder + code)
+            if code.islower():
+                lo, hi = -2**(size*8-1), 2**(size*8-1) - 1
+            else:
+                lo, hi = 0, 2**(size*8) - 1
+            values = [lo, hi, 0, 1, lo + 1, hi - 1, hi // 3]
+            with self.subTest(fmt=fmt):
+                result = self.check(fmt, values, [-1] * len(values),
+                                    values[::-1])
+                self.assertEqual(result, (values, [-1] * len(values),
+                                          values[::-1]))
+
+    def test_int_like(self):
+        class MyInt(int):
+            pass
+        class Indexable:
+            def __init__(self, value):
+                self.value = value
+            def __index__(self):
+                return self.value
+        for fmt in '<iQ', '>iQ', 'iQ', '=bH':
+            with self.subTest(fmt=fmt):
+                self.check(fmt, [MyInt(1), True, Indexable(-3)],
+                           [Indexable(7), MyInt(2), 0])
+
+    def test_out_of_range(self):
+        # Out of range values raise the same errors as with pack().
+        for code, byteorder in iter_integer_formats():
+            fmt = byteorder + code
+            size = struct.calcsize(fmt)
+            for value in 2**(size*8), -2**(size*8-1) - 1, 2**64:
+                with self.subTest(fmt=fmt, value=value):
+                    with self.assertRaises(struct.error) as cm:
+                        struct.pack(fmt, value)
+                    with self.assertRaises(struct.error) as cm2:
+                        struct.pack_many(fmt, [0, value])
+                    self.assertEqual(str(cm2.exception), str(cm.exception))
+        self.assertRaises(struct.error, struct.pack_many, '<I', [1, 'x'])
+        self.assertRaises(struct.error, struct.pack_many, '>d', [1.0, 'x'])
+        self.assertRaises(struct.error, struct.pack_many, '3s', [b'x', 1])
+
+    def test_floats(self):
+        values = [0.0, -0.0, 1.5, -2.25, 1e300, math.inf, -math.inf, 7]
+        for byteorder in byteorders:
+            for code in 'efd':
+                fmt = byteorder + 'B' + code
+                with self.subTest(fmt=fmt):
+                    if code == 'd':
+                        vals = values
+                    else:
+                        vals = [v for v in values if abs(v) != 1e300]
+                    self.check(fmt, list(range(len(vals))), vals)
+        nans = struct.unpack_many('<d', struct.pack_many('<d', [math.nan]))
+        self.assertTrue(math.isnan(nans[0][0]))
+
+    def test_other_formats(self):
+        for byteorder in byteorders:
+            fmt = byteorder + '?3sc5pxhP'
+            if byteorder not in ('', '@'):
+                fmt = fmt.replace('P', 'q')
+            with self.subTest(fmt=fmt):
+                self.check(fmt, [True, False, True],
+                           [b'abcd', b'', bytearray(b'x')],
+                           [b'a', b'b', b'c'],
+                           [b'', b'spam', b'spam and eggs'],
+                           [1, 2, 3], [4, 5, 6])
+        self.assertEqual(struct.unpack_many('?', b'\x00\x01\x02'),
+                         ([False, True, True],))
+        self.assertEqual(struct.pack_many('>?', [0, 'x', []]),
+                         b'\x00\x01\x00')
+
+    def test_repeat(self):
+        result = self.check('<2I3d', [1, 2], [3, 4], [0.5, 1.0], [1.5, 2.0],
+                            [2.5, 3.0])
+        self.assertEqual(result, ([1, 2], [3, 4], [0.5, 1.0], [1.5, 2.0],
+                                  [2.5, 3.0]))
+
+    def test_columns(self):
+        s = struct.Struct('>IB')
+        # Any sequence can be a column.
+        self.assertEqual(s.pack_many(range(1, 3), (5, 6)),
+                         s.pack(1, 5) + s.pack(2, 6))
+        self.assertEqual(s.pack_many([], ()), b'')
+        self.assertEqual(s.unpack_many(b''), ([], []))
+        self.assertEqual(struct.Struct('').pack_many(), b'')
+        with self.assertRaises(struct.error):
+            s.pack_many([1, 2], [3])
+        with self.assertRaises(struct.error):
+            s.pack_many([1])
+        with self.assertRaises(struct.error):
+            s.pack_many([1], [2], [3])
+        with self.assertRaises(TypeError):
+            s.pack_many(1, 2)
+
+    def test_unpack_errors(self):
+        s = struct.Struct('>IB')
+        self.assertEqual(s.unpack_many(memoryview(bytes(range(1, 11)))),
+                         ([0x01020304, 0x06070809], [5, 10]))
+        with self.assertRaises(struct.error):
+            s.unpack_many(b'123456')
+        with self.assertRaises(struct.error):
+            s.unpack_many(b'1234567')
+        s = struct.Struct('>')
+        with self.assertRaises(struct.error):
+            s.unpack_many(b'')
+        with self.assertRaises(TypeError):
+            s.unpack_many('12')
+
+    def test_module_funcs(self):
+        data = struct.pack_many('<Id', [1, 2], [0.5, 1.5])
+        self.assertEqual(data, struct.pack('<Id', 1, 0.5) +
+                               struct.pack('<Id', 2, 1.5))
+        self.assertEqual(struct.unpack_many('<Id', data),
+                         ([1, 2], [0.5, 1.5]))
+        self.assertRaises(TypeError, struct.pack_many)
+
+
 if __name__ == '__main__':
     unittest.main()
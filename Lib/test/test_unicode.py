@@ -1755,6 +1755,102 @@ class UnicodeTest(string_tests.CommonTest,
             self.assertRaises(UnicodeDecodeError,
                               (b'\xF4'+cb+b'\xBF\xBF').decode, 'utf-8')
 
+    @support.cpython_only
+    def test_utf8_decode_simd(self):
+        # Long data is validated and decoded by blocks of 16 or 32 bytes with
+        # SIMD instructions if the CPU has them:  compare it with the portable
+        # decoder around the block boundaries.
+        _testinternalcapi = support.import_module('_testinternalcapi')
+        old_level = _testinternalcapi.get_simd_level()
+        self.addCleanup(_testinternalcapi.set_simd_level, old_level)
+
+        def decode(data, errors):
+            try:
+                return data.decode('utf-8', errors)
+            except UnicodeDecodeError as exc:
+                return (exc.start, exc.end, exc.reason)
+
+        def decode_incremental(data, n):
+            decoder = codecs.getincrementaldecoder('utf-8')()
+            try:
+                return [decoder.decode(data[i:i+n], i + n >= len(data))
+                        for i in range(0, len(data), n)]
+            except UnicodeDecodeError as exc:
+                return (exc.start, exc.end, exc.reason)
+
+        tests = []
+        for c in '\xe9', '\u0416', '\u20ac', '\U0001f600':
+            for i in range(70):
+                for j in 0, 1, 2, 17, 40:
+                    tests.append(('a' * i + c + 'b' * j).encode())
+                    tests.append((c * i + 'a' * j).encode())
+        invalid = [b'\x80', b'\xc0\x80', b'\xc2', b'\xc2\x41',
+                   b'\xe0\x80\x80', b'\xe2\x82', b'\xed\xa0\x80',
+                   b'\xf0\x8f\xbf\xbf', b'\xf0\x9f\x98',
+                   b'\xf4\x90\x80\x80', b'\xf8\x88\x80\x80\x80', b'\xff']
+        for seq in invalid:
+            for i in range(70):
+                tests.append(b'a' * i + seq + b'b' * 20)
+                tests.append(b'\xc3\xa9' * i + seq)
+                tests.append('\u0416'.encode() * (i // 2) + b'a' * (i % 2) +
+                             seq + '\u20ac'.encode() * 10)
+
+        def results():
+            return [(decode(data, 'strict'), decode(data, 'replace'),
+                     decode(data, 'surrogateescape'))
+                    for data in tests]
+        def incremental_results():
+            return [decode_incremental(data, n)
+                    for data in tests[::5] for n in (5, 17, 33)]
+
+        _testinternalcapi.set_simd_level(0)
+        expected = results()
+        expected_incremental = incremental_results()
+        for level in range(1, old_level + 1):
+            with self.subTest(level=level):
+                _testinternalcapi.set_simd_level(level)
+                for data, res, exp in zip(tests, results(), expected):
+                    self.assertEqual(res, exp, data)
+                    for s, e in zip(res, exp):
+                        if isinstance(s, str):
+                            self.assertEqual(sys.getsizeof(s),
+                                             sys.getsizeof(e), data)
+                self.assertEqual(incremental_results(), expected_incremental)
+
+    @support.cpython_only
+    def test_find_simd(self):
+        # Short needles are searched by blocks of 16 or 32 bytes with SIMD
+        # instructions if the CPU has them:  compare the results with the
+        # portable search for the three kinds of strings and for bytes.
+        _testinternalcapi = support.import_module('_testinternalcapi')
+        old_level = _testinternalcapi.get_simd_level()
+        self.addCleanup(_testinternalcapi.set_simd_level, old_level)
+
+        tests = []
+        for c in 'a', '\xe9', '\u20ac', '\U0001f600':
+            for m in 2, 3, 7, 16, 33, 64:
+                sub = c + 'xy' * (m // 2 - 1) + 'z' * (m % 2) + c
+                for n in range(m, 140, 5):
+                    text = ('xy' + c) * (n // 3) + 'x' * (n % 3)
+                    tests.append((text, sub))
+                    tests.append((text + sub, sub))
+                    tests.append((text + sub + text + sub + sub, sub))
+        tests += [(t.encode('utf-8'), s.encode('utf-8')) for t, s in tests]
+
+        def results():
+            return [(text.find(sub), text.find(sub, 1), text.count(sub),
+                     text.count(sub, 0, len(text) - 1), text.split(sub),
+                     text.replace(sub, sub[:1]))
+                    for text, sub in tests]
+
+        _testinternalcapi.set_simd_level(0)
+        expected = results()
+        for level in range(1, old_level + 1):
+            with self.subTest(level=level):
+                _testinternalcapi.set_simd_level(level)
+                for args, res, exp in zip(tests, results(), expected):
+                    self.assertEqual(res, exp, args)
+
     def test_issue8271(self):
         # Issue #8271: during the decoding of an invalid UTF-8 byte sequence,
         # only the start byte and the continuation byte(s) are now considered
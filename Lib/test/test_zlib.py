@@ -109,6 +109,12 @@ class ExceptionTestCase(unittest.TestCase):
         self.assertRaises(ValueError,
                 zlib.compressobj, 1, zlib.DEFLATED, zlib.MAX_WBITS + 1)
 
+    def test_badthreads(self):
+        self.assertRaises(ValueError, zlib.compress, b'ERROR', threads=-1)
+        self.assertRaises(ValueError, zlib.compressobj, threads=-1)
+        self.assertRaises(zlib.error, zlib.compress, HAMLET_SCENE * 100, 10,
+                          threads=2)
+
     def test_baddecompressobj(self):
         # verify failure on building decompress object with bad params
         self.assertRaises(ValueError, zlib.decompressobj, -1)
@@ -174,6 +180,15 @@ class CompressTestCase(BaseCompressTestCase, unittest.TestCase):
                                          bufsize=zlib.DEF_BUF_SIZE),
                          HAMLET_SCENE)
 
+    def test_threads(self):
+        data = HAMLET_SCENE * 512
+        for threads in (2, 3, 0):
+            x = zlib.compress(data, threads=threads)
+            self.assertEqual(zlib.decompress(x), data)
+        # Short data is compressed as usual
+        self.assertEqual(zlib.compress(HAMLET_SCENE, threads=2),
+                         zlib.compress(HAMLET_SCENE))
+
     def test_speech128(self):
         # compress more data
         data = HAMLET_SCENE * 128
@@ -656,6 +671,52 @@ class CompressObjectTestCase(BaseCompressTestCase, unittest.TestCase):
             self.assertEqual(zlib.decompress(s0),data0+data0)
             self.assertEqual(zlib.decompress(s1),data0+data1)
 
+    def test_threads(self):
+        data = HAMLET_SCENE * 512
+        rand = random.Random(42)
+        for wbits in (zlib.MAX_WBITS, -zlib.MAX_WBITS, zlib.MAX_WBITS + 16,
+                      9, -9):
+            for zdict in (None, HAMLET_SCENE[:1000]):
+                if zdict is not None and wbits > 16:
+                    continue
+                kwargs = {} if zdict is None else {'zdict': zdict}
+                with self.subTest(wbits=wbits, zdict=zdict is not None):
+                    co = zlib.compressobj(wbits=wbits, threads=3, **kwargs)
+                    bufs = []
+                    pos = 0
+                    while pos < len(data):
+                        n = rand.randrange(1, 500_000)
+                        bufs.append(co.compress(data[pos:pos + n]))
+                        pos += n
+                        if rand.random() < 0.3:
+                            bufs.append(co.flush(rand.choice(
+                                [zlib.Z_SYNC_FLUSH, zlib.Z_FULL_FLUSH])))
+                    bufs.append(co.flush())
+                    dco = zlib.decompressobj(wbits, **kwargs)
+                    self.assertEqual(dco.decompress(b''.join(bufs)), data)
+                    self.assertTrue(dco.eof)
+                    self.assertRaises(zlib.error, co.compress, b'x')
+                    self.assertRaises(zlib.error, co.flush)
+        # Sync flush
+        co = zlib.compressobj(threads=2)
+        dco = zlib.decompressobj()
+        x = co.compress(data) + co.flush(zlib.Z_SYNC_FLUSH)
+        self.assertEqual(dco.decompress(x), data)
+        x = co.compress(b'') + co.flush()
+        self.assertEqual(dco.decompress(x), b'')
+        self.assertTrue(dco.eof)
+
+    @requires_Compress_copy
+    def test_threads_copy(self):
+        data = HAMLET_SCENE * 64
+        c0 = zlib.compressobj(threads=2)
+        s = c0.compress(data)
+        c1 = c0.copy()
+        s0 = s + c0.compress(data) + c0.flush()
+        s1 = s + c1.compress(HAMLET_SCENE) + c1.flush()
+        self.assertEqual(zlib.decompress(s0), data + data)
+        self.assertEqual(zlib.decompress(s1), data + HAMLET_SCENE)
+
     @requires_Compress_copy
     def test_badcompresscopy(self):
         # Test copying a compression object in an inconsistent state
@@ -6,12 +6,20 @@ This module provides the low-level underpinnings of a CSV reading/writing
 module.  Users should not use this module directly, but import the csv.py
 module instead.
 
+It is built as a built-in module (Py_BUILD_CORE_BUILTIN define) on Windows
+and as an extension module (Py_BUILD_CORE_MODULE define) on other platforms.
+
 */
 
+#if !defined(Py_BUILD_CORE_BUILTIN) && !defined(Py_BUILD_CORE_MODULE)
+#  error "Py_BUILD_CORE_BUILTIN or Py_BUILD_CORE_MODULE must be defined"
+#endif
+
 #define MODULE_VERSION "1.0"
 
 #include "Python.h"
 #include "structmember.h"         // PyMemberDef
+#include "pycore_cpuinfo.h"       // _Py_GetSIMDLevel()
 #include <stdbool.h>
 
 
@@ -979,6 +987,1080 @@ csv_reader(PyObject *module, PyObject *args, PyObject *keyword_args)
     return (PyObject *)self;
 }
 
+/*
+ * PARSE
+ *
+ * parse() reads CSV data from a bytes-like object without the GIL, into a
+ * table which keeps the unescaped fields as bytes and creates the strings of
+ * a row or a column only when they are asked for.  The data is cut at line
+ * ends into pieces which are parsed in parallel, each as if it started a
+ * record.  Only afterwards is it known whether this was right: when the
+ * previous piece ends within a record, usually because a quoted field
+ * contains the line end, the piece is parsed again as its continuation.
+ * The state machine mirrors parse_process_char(), with the runs of plain
+ * characters in fields copied at once.
+ */
+
+/* The minimum size of the pieces parsed in parallel */
+#define PARSE_PIECE_SIZE (64 * 1024)
+
+typedef enum {
+    PARSE_OK, PARSE_NOMEM, PARSE_NUL, PARSE_STRICT, PARSE_LIMIT, PARSE_EOF
+} ParseError;
+
+typedef struct {
+    /* The records parsed */
+    char *data;                 /* unescaped fields, one after the other */
+    Py_ssize_t data_len;
+    Py_ssize_t data_size;
+    Py_ssize_t *ends;           /* end of each field in data */
+    char *numeric;              /* fields to convert to float, or NULL */
+    Py_ssize_t nfields;
+    Py_ssize_t fields_size;     /* allocated size of ends and numeric */
+    Py_ssize_t *records;        /* end of each record in ends */
+    Py_ssize_t nrecords;
+    Py_ssize_t records_size;
+
+    /* The input and the state of the parser */
+    Py_ssize_t start, end;      /* range of the input */
+    Py_ssize_t parsed;          /* end of the last record in the input */
+    ParserState state;
+    int numeric_field;
+    Py_ssize_t field_start;     /* start of the current field in data */
+    ParseError error;
+} ParsePiece;
+
+typedef struct {
+    const unsigned char *input;
+    ParsePiece *pieces;
+    Py_ssize_t npieces;
+    Py_ssize_t next;            /* index of the next piece to parse */
+    PyThread_type_lock lock;    /* protects next */
+
+    /* The dialect, with 0 for the characters that are not set */
+    int delimiter, quotechar, escapechar;
+    int quoting;
+    char doublequote, skipinitialspace, strict;
+    long field_limit;
+
+    /* The bytes that end a run of plain characters in an unquoted and in a
+       quoted field, and a table of them */
+    unsigned char field_stops[5];
+    unsigned char quoted_stops[5];
+    char is_field_stop[256];
+    char is_quoted_stop[256];
+    int simd_level;
+} ParseJob;
+
+typedef struct {
+    ParseJob *job;
+    PyThread_type_lock done;    /* released when the thread exits */
+} ParseWorker;
+
+typedef struct {
+    PyObject_HEAD
+    ParsePiece *pieces;
+    Py_ssize_t npieces;
+    Py_ssize_t *first_record;   /* index of the first record of each piece */
+    Py_ssize_t nrecords;
+    Py_ssize_t nbytes;          /* size of the data parsed */
+    PyObject *encoding;
+    PyObject *errors;
+    int utf8;                   /* is encoding UTF-8? */
+} TableObj;
+
+static PyTypeObject Table_Type;
+
+static int
+piece_init(ParsePiece *p, Py_ssize_t start, Py_ssize_t end, int numeric)
+{
+    memset(p, 0, sizeof(*p));
+    p->start = p->parsed = start;
+    p->end = end;
+    p->state = START_RECORD;
+    /* The fields are never longer than their input */
+    p->data_size = end - start;
+    p->data = PyMem_RawMalloc(p->data_size + 1);
+    p->fields_size = 1024;
+    p->ends = PyMem_RawMalloc(p->fields_size * sizeof(Py_ssize_t));
+    if (numeric)
+        p->numeric = PyMem_RawMalloc(p->fields_size);
+    p->records_size = 256;
+    p->records = PyMem_RawMalloc(p->records_size * sizeof(Py_ssize_t));
+    if (p->data == NULL || p->ends == NULL || p->records == NULL ||
+        (numeric && p->numeric == NULL)) {
+        p->error = PARSE_NOMEM;
+        return -1;
+    }
+    return 0;
+}
+
+static void
+piece_free(ParsePiece *p)
+{
+    PyMem_RawFree(p->data);
+    PyMem_RawFree(p->ends);
+    PyMem_RawFree(p->numeric);
+    PyMem_RawFree(p->records);
+    p->data = NULL;
+    p->ends = NULL;
+    p->numeric = NULL;
+    p->records = NULL;
+}
+
+/* Make room in p for parsing len more bytes of input. */
+static int
+piece_extend(ParsePiece *p, Py_ssize_t len)
+{
+    char *data = PyMem_RawRealloc(p->data, p->data_size + len + 1);
+    if (data == NULL) {
+        p->error = PARSE_NOMEM;
+        return -1;
+    }
+    p->data = data;
+    p->data_size += len;
+    return 0;
+}
+
+static int
+piece_save_field(ParseJob *job, ParsePiece *p)
+{
+    if (p->data_len - p->field_start > job->field_limit) {
+        p->error = PARSE_LIMIT;
+        return -1;
+    }
+    if (p->nfields == p->fields_size) {
+        Py_ssize_t size = p->fields_size * 2;
+        Py_ssize_t *ends;
+        if ((size_t)size > PY_SSIZE_T_MAX / sizeof(Py_ssize_t) ||
+            (ends = PyMem_RawRealloc(p->ends, size * sizeof(Py_ssize_t))) == NULL) {
+            p->error = PARSE_NOMEM;
+            return -1;
+        }
+        p->ends = ends;
+        if (p->numeric != NULL) {
+            char *numeric = PyMem_RawRealloc(p->numeric, size);
+            if (numeric == NULL) {
+                p->error = PARSE_NOMEM;
+                return -1;
+            }
+            p->numeric = numeric;
+        }
+        p->fields_size = size;
+    }
+    if (p->numeric != NULL)
+        p->numeric[p->nfields] = (char)p->numeric_field;
+    p->ends[p->nfields++] = p->data_len;
+    p->field_start = p->data_len;
+    p->numeric_field = 0;
+    return 0;
+}
+
+/* Record the end of a record at the index pos of the input. */
+static int
+piece_save_record(ParsePiece *p, Py_ssize_t pos)
+{
+    if (p->nrecords == p->records_size) {
+        Py_ssize_t size = p->records_size * 2;
+        Py_ssize_t *records;
+        if ((size_t)size > PY_SSIZE_T_MAX / sizeof(Py_ssize_t) ||
+            (records = PyMem_RawRealloc(p->records,
+                                        size * sizeof(Py_ssize_t))) == NULL) {
+            p->error = PARSE_NOMEM;
+            return -1;
+        }
+        p->records = records;
+        p->records_size = size;
+    }
+    p->records[p->nrecords++] = p->nfields;
+    p->parsed = pos;
+    return 0;
+}
+
+#define piece_add_char(p, c) ((p)->data[(p)->data_len++] = (char)(c))
+
+/* Process the character c like parse_process_char(), '\0' marking the end
+   of a line. */
+static int
+piece_process_char(ParseJob *job, ParsePiece *p, int c)
+{
+    switch (p->state) {
+    case START_RECORD:
+        /* start of record */
+        if (c == '\0')
+            /* empty line - return [] */
+            break;
+        else if (c == '\n' || c == '\r') {
+            p->state = EAT_CRNL;
+            break;
+        }
+        /* normal character - handle as START_FIELD */
+        p->state = START_FIELD;
+        /* fallthru */
+    case START_FIELD:
+        /* expecting field */
+        if (c == '\n' || c == '\r' || c == '\0') {
+            /* save empty field - return [fields] */
+            if (piece_save_field(job, p) < 0)
+                return -1;
+            p->state = (c == '\0' ? START_RECORD : EAT_CRNL);
+        }
+        else if (c == job->quotechar &&
+                 job->quoting != QUOTE_NONE) {
+            /* start quoted field */
+            p->state = IN_QUOTED_FIELD;
+        }
+        else if (c == job->escapechar) {
+            /* possible escaped character */
+            p->state = ESCAPED_CHAR;
+        }
+        else if (c == ' ' && job->skipinitialspace)
+            /* ignore space at start of field */
+            ;
+        else if (c == job->delimiter) {
+            /* save empty field */
+            if (piece_save_field(job, p) < 0)
+                return -1;
+        }
+        else {
+            /* begin new unquoted field */
+            if (job->quoting == QUOTE_NONNUMERIC)
+                p->numeric_field = 1;
+            piece_add_char(p, c);
+            p->state = IN_FIELD;
+        }
+        break;
+
+    case ESCAPED_CHAR:
+        if (c == '\n' || c=='\r') {
+            piece_add_char(p, c);
+            p->state = AFTER_ESCAPED_CRNL;
+            break;
+        }
+        if (c == '\0')
+            c = '\n';
+        piece_add_char(p, c);
+        p->state = IN_FIELD;
+        break;
+
+    case AFTER_ESCAPED_CRNL:
+        if (c == '\0')
+            break;
+        /*fallthru*/
+
+    case IN_FIELD:
+        /* in unquoted field */
+        if (c == '\n' || c == '\r' || c == '\0') {
+            /* end of line - return [fields] */
+            if (piece_save_field(job, p) < 0)
+                return -1;
+            p->state = (c == '\0' ? START_RECORD : EAT_CRNL);
+        }
+        else if (c == job->escapechar) {
+            /* possible escaped character */
+            p->state = ESCAPED_CHAR;
+        }
+        else if (c == job->delimiter) {
+            /* save field - wait for new field */
+            if (piece_save_field(job, p) < 0)
+                return -1;
+            p->state = START_FIELD;
+        }
+        else {
+            /* normal character - save in field */
+            piece_add_char(p, c);
+        }
+        break;
+
+    case IN_QUOTED_FIELD:
+        /* in quoted field */
+        if (c == '\0')
+            ;
+        else if (c == job->escapechar) {
+            /* Possible escape character */
+            p->state = ESCAPE_IN_QUOTED_FIELD;
+        }
+        else if (c == job->quotechar &&
+                 job->quoting != QUOTE_NONE) {
+            if (job->doublequote) {
+                /* doublequote; " represented by "" */
+                p->state = QUOTE_IN_QUOTED_FIELD;
+            }
+            else {
+                /* end of quote part of field */
+                p->state = IN_FIELD;
+            }
+        }
+        else {
+            /* normal character - save in field */
+            piece_add_char(p, c);
+        }
+        break;
+
+    case ESCAPE_IN_QUOTED_FIELD:
+        if (c == '\0')
+            c = '\n';
+        piece_add_char(p, c);
+        p->state = IN_QUOTED_FIELD;
+        break;
+
+    case QUOTE_IN_QUOTED_FIELD:
+        /* doublequote - seen a quote in a quoted field */
+        if (job->quoting != QUOTE_NONE &&
+            c == job->quotechar) {
+            /* save "" as " */
+            piece_add_char(p, c);
+            p->state = IN_QUOTED_FIELD;
+        }
+        else if (c == job->delimiter) {
+            /* save field - wait for new field */
+            if (piece_save_field(job, p) < 0)
+                return -1;
+            p->state = START_FIELD;
+        }
+        else if (c == '\n' || c == '\r' || c == '\0') {
+            /* end of line - return [fields] */
+            if (piece_save_field(job, p) < 0)
+                return -1;
+            p->state = (c == '\0' ? START_RECORD : EAT_CRNL);
+        }
+        else if (!job->strict) {
+            piece_add_char(p, c);
+            p->state = IN_FIELD;
+        }
+        else {
+            /* illegal */
+            p->error = PARSE_STRICT;
+            return -1;
+        }
+        break;
+
+    case EAT_CRNL:
+        /* The lines are split after the new-line characters, so this is
+           always followed by the end of the line. */
+        if (c == '\0')
+            p->state = START_RECORD;
+        break;
+
+    }
+    return 0;
+}
+
+#ifdef _Py_HAVE_X86_SIMD
+/* Compare 16 or 32 bytes at a time against the 5 stop bytes.  Return the
+   index of the first stop byte, or the start of the last block shorter than
+   a vector. */
+_Py_TARGET_SSE42 static Py_ssize_t
+find_stop_sse42(const unsigned char *s, Py_ssize_t i, Py_ssize_t end,
+                const unsigned char *stops)
+{
+    const __m128i c0 = _mm_set1_epi8((char)stops[0]);
+    const __m128i c1 = _mm_set1_epi8((char)stops[1]);
+    const __m128i c2 = _mm_set1_epi8((char)stops[2]);
+    const __m128i c3 = _mm_set1_epi8((char)stops[3]);
+    const __m128i c4 = _mm_set1_epi8((char)stops[4]);
+    for (; i + 16 <= end; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(s + i));
+        __m128i m = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, c0), _mm_cmpeq_epi8(v, c1)),
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, c2),
+                                      _mm_cmpeq_epi8(v, c3)),
+                         _mm_cmpeq_epi8(v, c4)));
+        unsigned int bits = (unsigned int)_mm_movemask_epi8(m);
+        if (bits) {
+            return i + __builtin_ctz(bits);
+        }
+    }
+    return i;
+}
+
+_Py_TARGET_AVX2 static Py_ssize_t
+find_stop_avx2(const unsigned char *s, Py_ssize_t i, Py_ssize_t end,
+               const unsigned char *stops)
+{
+    const __m256i c0 = _mm256_set1_epi8((char)stops[0]);
+    const __m256i c1 = _mm256_set1_epi8((char)stops[1]);
+    const __m256i c2 = _mm256_set1_epi8((char)stops[2]);
+    const __m256i c3 = _mm256_set1_epi8((char)stops[3]);
+    const __m256i c4 = _mm256_set1_epi8((char)stops[4]);
+    for (; i + 32 <= end; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(s + i));
+        __m256i m = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, c0),
+                            _mm256_cmpeq_epi8(v, c1)),
+            _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, c2),
+                                            _mm256_cmpeq_epi8(v, c3)),
+                            _mm256_cmpeq_epi8(v, c4)));
+        unsigned int bits = (unsigned int)_mm256_movemask_epi8(m);
+        if (bits) {
+            return i + __builtin_ctz(bits);
+        }
+    }
+    return i;
+}
+#endif
+
+/* Return the index of the first of the stop bytes in s[i:end], or end if
+   there is none. */
+static Py_ssize_t
+find_stop(ParseJob *job, const unsigned char *s, Py_ssize_t i, Py_ssize_t end,
+          const unsigned char *stops, const char *is_stop)
+{
+#ifdef _Py_HAVE_X86_SIMD
+    if (end - i >= 16) {
+        if (job->simd_level >= _Py_SIMD_AVX2) {
+            i = find_stop_avx2(s, i, end, stops);
+        }
+        if (job->simd_level >= _Py_SIMD_SSE42) {
+            i = find_stop_sse42(s, i, end, stops);
+        }
+    }
+#endif
+    for (; i < end; i++) {
+        if (is_stop[s[i]]) {
+            break;
+        }
+    }
+    return i;
+}
+
+/* Parse the lines of job->input[start:end] into p, from the state of p. */
+static void
+parse_piece(ParseJob *job, ParsePiece *p, Py_ssize_t start, Py_ssize_t end)
+{
+    const unsigned char *s = job->input;
+    Py_ssize_t i = start;
+    int c;
+
+    while (i < end) {
+        if (p->state == IN_FIELD || p->state == IN_QUOTED_FIELD) {
+            /* Copy the plain characters of the field at once */
+            Py_ssize_t j;
+            if (p->state == IN_FIELD)
+                j = find_stop(job, s, i, end,
+                              job->field_stops, job->is_field_stop);
+            else
+                j = find_stop(job, s, i, end,
+                              job->quoted_stops, job->is_quoted_stop);
+            memcpy(p->data + p->data_len, s + i, j - i);
+            p->data_len += j - i;
+            i = j;
+            if (i == end)
+                break;
+        }
+        c = s[i++];
+        if (c == '\0') {
+            p->error = PARSE_NUL;
+            return;
+        }
+        if (piece_process_char(job, p, c) < 0)
+            return;
+        /* Lines end like with universal newlines: at "\n", "\r\n" or "\r"
+           followed by another character. */
+        if (c == '\n' || (c == '\r' && (i == end || s[i] != '\n'))) {
+            if (piece_process_char(job, p, '\0') < 0)
+                return;
+            if (p->state == START_RECORD && piece_save_record(p, i) < 0)
+                return;
+        }
+    }
+}
+
+/* Finish the last record of p at the end of the input, like
+   Reader_iternext() does. */
+static void
+parse_piece_eof(ParseJob *job, ParsePiece *p)
+{
+    Py_ssize_t end = p->end;
+
+    if (end > p->start && job->input[end - 1] != '\n' &&
+        job->input[end - 1] != '\r') {
+        /* the last line has no line end */
+        if (piece_process_char(job, p, '\0') < 0)
+            return;
+        if (p->state == START_RECORD) {
+            piece_save_record(p, end);
+            return;
+        }
+    }
+    if (p->state == START_RECORD)
+        return;
+    if (p->data_len != p->field_start || p->state == IN_QUOTED_FIELD) {
+        if (job->strict)
+            p->error = PARSE_EOF;
+        else if (piece_save_field(job, p) == 0)
+            piece_save_record(p, end);
+    }
+}
+
+static void
+parse_worker_run(ParseJob *job)
+{
+    ParsePiece *p;
+    Py_ssize_t i;
+
+    for (;;) {
+        PyThread_acquire_lock(job->lock, 1);
+        i = job->next++;
+        PyThread_release_lock(job->lock);
+        if (i >= job->npieces)
+            break;
+        p = &job->pieces[i];
+        if (piece_init(p, p->start, p->end,
+                       job->quoting == QUOTE_NONNUMERIC) == 0)
+            parse_piece(job, p, p->start, p->end);
+    }
+}
+
+static void
+parse_worker_thread(void *arg)
+{
+    ParseWorker *worker = (ParseWorker *)arg;
+    parse_worker_run(worker->job);
+    PyThread_release_lock(worker->done);
+}
+
+static int
+cpu_count(void)
+{
+#ifdef MS_WINDOWS
+    SYSTEM_INFO sysinfo;
+    GetSystemInfo(&sysinfo);
+    return (int)sysinfo.dwNumberOfProcessors;
+#elif defined(HAVE_SYSCONF) && defined(_SC_NPROCESSORS_ONLN)
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    return ncpu > 0 ? (int)Py_MIN(ncpu, INT_MAX) : 1;
+#else
+    return 1;
+#endif
+}
+
+/* Return the index after the first line end in s[i:end], or end. */
+static Py_ssize_t
+find_line_end(const unsigned char *s, Py_ssize_t i, Py_ssize_t end)
+{
+    for (; i < end; i++) {
+        if (s[i] == '\n')
+            return i + 1;
+        if (s[i] == '\r')
+            return (i + 1 < end && s[i + 1] == '\n') ? i + 2 : i + 1;
+    }
+    return end;
+}
+
+/* Return the index after the last line end in s[0:len] that is known to be
+   one: a "\r" at the end may be followed by a "\n" not read yet. */
+static Py_ssize_t
+find_last_line_end(const unsigned char *s, Py_ssize_t len)
+{
+    Py_ssize_t i = len - 1;
+    if (i >= 0 && s[i] == '\r')
+        i--;
+    for (; i >= 0; i--) {
+        if (s[i] == '\n' || s[i] == '\r')
+            return i + 1;
+    }
+    return 0;
+}
+
+static void
+parse_set_stops(unsigned char *stops, char *is_stop, int c0, int c1, int c2,
+                int c3)
+{
+    /* NUL is always a stop byte, and takes the place of unset characters */
+    stops[0] = (unsigned char)c0;
+    stops[1] = (unsigned char)c1;
+    stops[2] = (unsigned char)c2;
+    stops[3] = (unsigned char)c3;
+    stops[4] = 0;
+    memset(is_stop, 0, 256);
+    for (int i = 0; i < 5; i++)
+        is_stop[stops[i]] = 1;
+}
+
+/* Parse the bytes-like object data with the dialect, on nthreads threads.
+   If final is false, a record that is not complete at the end of data is
+   left unparsed. */
+static PyObject *
+parse_data(DialectObj *dialect, Py_buffer *data, int nthreads, int final,
+           PyObject *encoding, PyObject *errors, int utf8)
+{
+    ParseJob job;
+    ParseWorker *workers = NULL;
+    Py_ssize_t i, k, len, npieces, cur = 0;
+    int nworkers = 0;
+    ParseError error;
+    TableObj *table = NULL;
+    ParsePiece *p;
+
+    memset(&job, 0, sizeof(job));
+    job.input = (const unsigned char *)data->buf;
+    job.delimiter = (int)dialect->delimiter;
+    job.quotechar = (int)dialect->quotechar;
+    job.escapechar = (int)dialect->escapechar;
+    job.quoting = dialect->quoting;
+    job.doublequote = dialect->doublequote;
+    job.skipinitialspace = dialect->skipinitialspace;
+    job.strict = dialect->strict;
+    job.field_limit = _csvstate_global->field_limit;
+    parse_set_stops(job.field_stops, job.is_field_stop,
+                    job.delimiter, job.escapechar, '\n', '\r');
+    parse_set_stops(job.quoted_stops, job.is_quoted_stop,
+                    job.quotechar, job.escapechar, 0, 0);
+#ifdef _Py_HAVE_X86_SIMD
+    job.simd_level = _Py_GetSIMDLevel();
+#endif
+
+    len = final ? data->len : find_last_line_end(job.input, data->len);
+
+    /* Cut the data in pieces at line ends, several per thread so that
+       the threads finishing first can take more */
+    npieces = 1;
+    if (nthreads > 1)
+        npieces = Py_MAX(1, Py_MIN((Py_ssize_t)nthreads * 4,
+                                   len / PARSE_PIECE_SIZE));
+    job.pieces = PyMem_Calloc(npieces, sizeof(ParsePiece));
+    job.lock = PyThread_allocate_lock();
+    if (job.pieces == NULL || job.lock == NULL) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    job.npieces = 0;
+    for (i = 0; i < len; ) {
+        Py_ssize_t target = (len / npieces) * (job.npieces + 1);
+        p = &job.pieces[job.npieces++];
+        p->start = i;
+        if (job.npieces == npieces)
+            i = len;
+        else
+            i = find_line_end(job.input, Py_MAX(i, target), len);
+        p->end = i;
+    }
+    if (job.npieces == 0) {
+        job.pieces[0].start = job.pieces[0].end = 0;
+        job.npieces = 1;
+    }
+
+    nthreads = (int)Py_MIN(nthreads, job.npieces);
+    if (nthreads > 1) {
+        workers = PyMem_Calloc(nthreads - 1, sizeof(ParseWorker));
+        if (workers == NULL) {
+            PyErr_NoMemory();
+            goto done;
+        }
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    for (; nworkers < nthreads - 1; nworkers++) {
+        ParseWorker *worker = &workers[nworkers];
+        worker->job = &job;
+        worker->done = PyThread_allocate_lock();
+        if (worker->done == NULL)
+            break;
+        PyThread_acquire_lock(worker->done, 1);
+        if (PyThread_start_new_thread(parse_worker_thread, worker) ==
+                PYTHREAD_INVALID_THREAD_ID) {
+            /* Do with the threads already started */
+            PyThread_free_lock(worker->done);
+            break;
+        }
+    }
+    parse_worker_run(&job);
+    for (i = 0; i < nworkers; i++) {
+        PyThread_acquire_lock(workers[i].done, 1);
+        PyThread_free_lock(workers[i].done);
+    }
+
+    /* The first piece starts a record.  A piece following one which ends
+       within a record did not: parse it again as its continuation. */
+    for (k = 1; k < job.npieces; k++) {
+        ParsePiece *prev = &job.pieces[cur];
+        if (prev->error != PARSE_OK)
+            break;
+        p = &job.pieces[k];
+        if (prev->state == START_RECORD) {
+            cur = k;
+            continue;
+        }
+        piece_free(p);
+        if (piece_extend(prev, p->end - p->start) < 0)
+            break;
+        parse_piece(&job, prev, p->start, p->end);
+        prev->end = p->end;
+        p->start = p->end;
+    }
+    p = &job.pieces[cur];
+    if (final && p->error == PARSE_OK)
+        parse_piece_eof(&job, p);
+    Py_END_ALLOW_THREADS
+
+    error = job.pieces[cur].error;
+    switch (error) {
+    case PARSE_OK:
+        break;
+    case PARSE_NOMEM:
+        PyErr_NoMemory();
+        goto done;
+    case PARSE_NUL:
+        PyErr_Format(_csvstate_global->error_obj, "line contains NUL");
+        goto done;
+    case PARSE_STRICT:
+        PyErr_Format(_csvstate_global->error_obj, "'%c' expected after '%c'",
+                     dialect->delimiter, dialect->quotechar);
+        goto done;
+    case PARSE_LIMIT:
+        PyErr_Format(_csvstate_global->error_obj,
+                     "field larger than field limit (%ld)",
+                     _csvstate_global->field_limit);
+        goto done;
+    case PARSE_EOF:
+        PyErr_SetString(_csvstate_global->error_obj,
+                        "unexpected end of data");
+        goto done;
+    }
+
+    table = PyObject_New(TableObj, &Table_Type);
+    if (table == NULL)
+        goto done;
+    table->pieces = NULL;
+    table->first_record = NULL;
+    table->npieces = 0;
+    table->nrecords = 0;
+    table->nbytes = final ? data->len : job.pieces[cur].parsed;
+    Py_INCREF(encoding);
+    table->encoding = encoding;
+    Py_INCREF(errors);
+    table->errors = errors;
+    table->utf8 = utf8;
+    table->pieces = PyMem_Calloc(cur + 1, sizeof(ParsePiece));
+    table->first_record = PyMem_Calloc(cur + 1, sizeof(Py_ssize_t));
+    if (table->pieces == NULL || table->first_record == NULL) {
+        Py_CLEAR(table);
+        PyErr_NoMemory();
+        goto done;
+    }
+    /* Move the pieces parsed to the table, without the fields of a last
+       record that is not complete */
+    for (k = 0; k <= cur; k++) {
+        p = &job.pieces[k];
+        if (p->data == NULL || p->nrecords == 0)
+            continue;
+        p->nfields = p->records[p->nrecords - 1];
+        table->first_record[table->npieces] = table->nrecords;
+        table->nrecords += p->nrecords;
+        table->pieces[table->npieces++] = *p;
+        p->data = NULL;
+        p->ends = NULL;
+        p->numeric = NULL;
+        p->records = NULL;
+    }
+
+done:
+    if (job.pieces != NULL) {
+        for (k = 0; k < job.npieces; k++)
+            piece_free(&job.pieces[k]);
+        PyMem_Free(job.pieces);
+    }
+    if (job.lock != NULL)
+        PyThread_free_lock(job.lock);
+    PyMem_Free(workers);
+    return (PyObject *)table;
+}
+
+/* Decode the field f of the piece p, with the C strings of the encoding
+   and the errors of the table. */
+static PyObject *
+table_field(TableObj *self, ParsePiece *p, Py_ssize_t f,
+            const char *encoding, const char *errors)
+{
+    Py_ssize_t start = f > 0 ? p->ends[f - 1] : 0;
+    PyObject *field;
+
+    if (self->utf8)
+        field = PyUnicode_DecodeUTF8(p->data + start, p->ends[f] - start,
+                                     errors);
+    else
+        field = PyUnicode_Decode(p->data + start, p->ends[f] - start,
+                                 encoding, errors);
+    if (field != NULL && p->numeric != NULL && p->numeric[f]) {
+        Py_SETREF(field, PyNumber_Float(field));
+    }
+    return field;
+}
+
+static Py_ssize_t
+Table_length(TableObj *self)
+{
+    return self->nrecords;
+}
+
+static PyObject *
+Table_item(TableObj *self, Py_ssize_t i)
+{
+    Py_ssize_t lo = 0, hi = self->npieces - 1, r, start, end, f;
+    ParsePiece *p;
+    PyObject *row;
+    const char *encoding, *errors;
+
+    if (i < 0 || i >= self->nrecords) {
+        PyErr_SetString(PyExc_IndexError, "table index out of range");
+        return NULL;
+    }
+    encoding = PyUnicode_AsUTF8(self->encoding);
+    errors = PyUnicode_AsUTF8(self->errors);
+    if (encoding == NULL || errors == NULL)
+        return NULL;
+    /* Find the last piece whose first record is not after i */
+    while (lo < hi) {
+        Py_ssize_t mid = (lo + hi + 1) / 2;
+        if (self->first_record[mid] <= i)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    p = &self->pieces[lo];
+    r = i - self->first_record[lo];
+    start = r > 0 ? p->records[r - 1] : 0;
+    end = p->records[r];
+    row = PyList_New(end - start);
+    if (row == NULL)
+        return NULL;
+    for (f = start; f < end; f++) {
+        PyObject *field = table_field(self, p, f, encoding, errors);
+        if (field == NULL) {
+            Py_DECREF(row);
+            return NULL;
+        }
+        PyList_SET_ITEM(row, f - start, field);
+    }
+    return row;
+}
+
+PyDoc_STRVAR(Table_column_doc,
+"column(index)\n"
+"\n"
+"Return the list of the fields at position index in each row, with None\n"
+"for the rows that do not have this field.");
+
+static PyObject *
+Table_column(TableObj *self, PyObject *arg)
+{
+    Py_ssize_t index, k, r, i = 0;
+    PyObject *column;
+    const char *encoding, *errors;
+
+    index = PyNumber_AsSsize_t(arg, PyExc_IndexError);
+    if (index == -1 && PyErr_Occurred())
+        return NULL;
+    encoding = PyUnicode_AsUTF8(self->encoding);
+    errors = PyUnicode_AsUTF8(self->errors);
+    if (encoding == NULL || errors == NULL)
+        return NULL;
+    column = PyList_New(self->nrecords);
+    if (column == NULL)
+        return NULL;
+    for (k = 0; k < self->npieces; k++) {
+        ParsePiece *p = &self->pieces[k];
+        for (r = 0; r < p->nrecords; r++) {
+            Py_ssize_t start = r > 0 ? p->records[r - 1] : 0;
+            Py_ssize_t n = p->records[r] - start;
+            PyObject *field;
+            if (index >= 0 ? index < n : -index <= n) {
+                field = table_field(self, p,
+                                    start + (index >= 0 ? index : n + index),
+                                    encoding, errors);
+                if (field == NULL) {
+                    Py_DECREF(column);
+                    return NULL;
+                }
+            }
+            else {
+                field = Py_None;
+                Py_INCREF(field);
+            }
+            PyList_SET_ITEM(column, i++, field);
+        }
+    }
+    return column;
+}
+
+static void
+Table_dealloc(TableObj *self)
+{
+    Py_ssize_t k;
+    for (k = 0; k < self->npieces; k++)
+        piece_free(&self->pieces[k]);
+    PyMem_Free(self->pieces);
+    PyMem_Free(self->first_record);
+    Py_XDECREF(self->encoding);
+    Py_XDECREF(self->errors);
+    PyObject_Del(self);
+}
+
+PyDoc_STRVAR(Table_Type_doc,
+"CSV table\n"
+"\n"
+"Table objects are the sequences of rows returned by parse().  The fields\n"
+"are decoded when a row or a column is accessed.\n"
+);
+
+static struct PyMethodDef Table_methods[] = {
+    { "column", (PyCFunction)Table_column, METH_O, Table_column_doc},
+    { NULL, NULL }
+};
+
+#define T_TABLE_OFF(x) offsetof(TableObj, x)
+
+static struct PyMemberDef Table_memberlist[] = {
+    { "nbytes", T_PYSSIZET, T_TABLE_OFF(nbytes), READONLY },
+    { NULL }
+};
+
+static PySequenceMethods Table_as_sequence = {
+    (lenfunc)Table_length,                  /*sq_length*/
+    0,                                      /*sq_concat*/
+    0,                                      /*sq_repeat*/
+    (ssizeargfunc)Table_item,               /*sq_item*/
+};
+
+static PyTypeObject Table_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_csv.Table",                           /*tp_name*/
+    sizeof(TableObj),                       /*tp_basicsize*/
+    0,                                      /*tp_itemsize*/
+    /* methods */
+    (destructor)Table_dealloc,              /*tp_dealloc*/
+    0,                                      /*tp_vectorcall_offset*/
+    (getattrfunc)0,                         /*tp_getattr*/
+    (setattrfunc)0,                         /*tp_setattr*/
+    0,                                      /*tp_as_async*/
+    (reprfunc)0,                            /*tp_repr*/
+    0,                                      /*tp_as_number*/
+    &Table_as_sequence,                     /*tp_as_sequence*/
+    0,                                      /*tp_as_mapping*/
+    (hashfunc)0,                            /*tp_hash*/
+    (ternaryfunc)0,                         /*tp_call*/
+    (reprfunc)0,                            /*tp_str*/
+    0,                                      /*tp_getattro*/
+    0,                                      /*tp_setattro*/
+    0,                                      /*tp_as_buffer*/
+    Py_TPFLAGS_DEFAULT,                     /*tp_flags*/
+    Table_Type_doc,                         /*tp_doc*/
+    0,                                      /*tp_traverse*/
+    0,                                      /*tp_clear*/
+    0,                                      /*tp_richcompare*/
+    0,                                      /*tp_weaklistoffset*/
+    0,                                      /*tp_iter*/
+    0,                                      /*tp_iternext*/
+    Table_methods,                          /*tp_methods*/
+    Table_memberlist,                       /*tp_members*/
+    0,                                      /*tp_getset*/
+};
+
+static PyObject *
+csv_parse(PyObject *module, PyObject *args, PyObject *keyword_args)
+{
+    _Py_static_string(PyId_utf_8, "utf-8");
+    _Py_IDENTIFIER(strict);
+    static const char * const keywords[] = {
+        "threads", "encoding", "errors", "final", NULL
+    };
+    PyObject *values[4] = {NULL, NULL, NULL, NULL};
+    PyObject *data, *dialect = NULL, *kwargs = NULL, *result = NULL;
+    PyObject *encoding, *errors, *codec, *name, *tmp;
+    const char *enc, *err;
+    DialectObj *dialect_obj = NULL;
+    Py_buffer buffer = {NULL, NULL};
+    int nthreads = 1, final = 1, utf8, i;
+
+    if (!PyArg_UnpackTuple(args, "parse", 1, 2, &data, &dialect))
+        return NULL;
+    /* Take the arguments of parse() out of the dialect settings */
+    if (keyword_args != NULL) {
+        kwargs = PyDict_Copy(keyword_args);
+        if (kwargs == NULL)
+            return NULL;
+        for (i = 0; keywords[i] != NULL; i++) {
+            values[i] = PyDict_GetItemString(kwargs, keywords[i]);
+            if (values[i] != NULL) {
+                Py_INCREF(values[i]);
+                if (PyDict_DelItemString(kwargs, keywords[i]) < 0)
+                    goto done;
+            }
+        }
+    }
+    if (values[0] != NULL) {
+        nthreads = _PyLong_AsInt(values[0]);
+        if (nthreads == -1 && PyErr_Occurred())
+            goto done;
+        if (nthreads < 0) {
+            PyErr_SetString(PyExc_ValueError,
+                            "threads must not be negative");
+            goto done;
+        }
+        if (nthreads == 0)
+            nthreads = cpu_count();
+    }
+    encoding = values[1] != NULL ? values[1] : _PyUnicode_FromId(&PyId_utf_8);
+    errors = values[2] != NULL ? values[2] : _PyUnicode_FromId(&PyId_strict);
+    if (encoding == NULL || errors == NULL)
+        goto done;
+    if (!PyUnicode_Check(encoding) || !PyUnicode_Check(errors)) {
+        PyErr_SetString(PyExc_TypeError,
+                        "encoding and errors must be strings");
+        goto done;
+    }
+    if (values[3] != NULL) {
+        final = PyObject_IsTrue(values[3]);
+        if (final < 0)
+            goto done;
+    }
+
+    dialect_obj = (DialectObj *)_call_dialect(dialect, kwargs);
+    if (dialect_obj == NULL)
+        goto done;
+    if (dialect_obj->delimiter >= 128 || dialect_obj->quotechar >= 128 ||
+        dialect_obj->escapechar >= 128) {
+        PyErr_SetString(PyExc_ValueError,
+                        "parse() requires ASCII delimiter, quotechar "
+                        "and escapechar");
+        goto done;
+    }
+    /* Look up the codec now rather than when the fields are decoded */
+    enc = PyUnicode_AsUTF8(encoding);
+    err = PyUnicode_AsUTF8(errors);
+    if (enc == NULL || err == NULL)
+        goto done;
+    codec = _PyCodec_LookupTextEncoding(enc, "codecs.decode()");
+    if (codec == NULL)
+        goto done;
+    name = PyObject_GetAttrString(codec, "name");
+    Py_DECREF(codec);
+    if (name == NULL)
+        goto done;
+    utf8 = PyUnicode_Check(name) &&
+           _PyUnicode_EqualToASCIIString(name, "utf-8");
+    Py_DECREF(name);
+    tmp = PyCodec_LookupError(err);
+    if (tmp == NULL)
+        goto done;
+    Py_DECREF(tmp);
+
+    if (PyObject_GetBuffer(data, &buffer, PyBUF_SIMPLE) < 0)
+        goto done;
+    result = parse_data(dialect_obj, &buffer, nthreads, final,
+                        encoding, errors, utf8);
+
+done:
+    if (buffer.obj != NULL)
+        PyBuffer_Release(&buffer);
+    for (i = 0; i < 4; i++)
+        Py_XDECREF(values[i]);
+    Py_XDECREF(kwargs);
+    Py_XDECREF(dialect_obj);
+    return result;
+}
+
 /*
  * WRITER
  */
@@ -1574,6 +2656,22 @@ PyDoc_STRVAR(csv_writer_doc,
 "\n"
 "The \"fileobj\" argument can be any object that supports the file API.\n");
 
+PyDoc_STRVAR(csv_parse_doc,
+"    table = parse(data [, dialect='excel']\n"
+"                  [, threads=1, encoding='utf-8', errors='strict',\n"
+"                  final=True] [optional keyword args])\n"
+"    for row in table:\n"
+"        process(row)\n"
+"\n"
+"The \"data\" argument is a bytes-like object containing CSV data in an\n"
+"ASCII compatible encoding.  It is parsed like reader() parses a file\n"
+"opened with newline='' on \"threads\" threads, 0 meaning the number\n"
+"of CPUs.  If \"final\" is false, a record which is not complete at the\n"
+"end of the data is left unparsed.\n"
+"\n"
+"The returned object is a sequence of the rows parsed.  The fields are\n"
+"decoded with \"encoding\" and \"errors\" when they are accessed.\n");
+
 PyDoc_STRVAR(csv_list_dialects_doc,
 "Return a list of all know dialect names.\n"
 "    names = csv.list_dialects()");
@@ -1602,6 +2700,8 @@ static struct PyMethodDef csv_methods[] = {
         METH_VARARGS | METH_KEYWORDS, csv_reader_doc},
     { "writer", (PyCFunction)(void(*)(void))csv_writer,
         METH_VARARGS | METH_KEYWORDS, csv_writer_doc},
+    { "parse", (PyCFunction)(void(*)(void))csv_parse,
+        METH_VARARGS | METH_KEYWORDS, csv_parse_doc},
     { "list_dialects", (PyCFunction)csv_list_dialects,
         METH_NOARGS, csv_list_dialects_doc},
     { "register_dialect", (PyCFunction)(void(*)(void))csv_register_dialect,
@@ -1639,6 +2739,9 @@ PyInit__csv(void)
     if (PyType_Ready(&Writer_Type) < 0)
         return NULL;
 
+    if (PyType_Ready(&Table_Type) < 0)
+        return NULL;
+
     /* Create the module and add the functions */
     module = PyModule_Create(&_csvmodule);
     if (module == NULL)
@@ -1672,6 +2775,10 @@ PyInit__csv(void)
         return NULL;
     }
 
+    if (PyModule_AddType(module, &Table_Type)) {
+        return NULL;
+    }
+
     /* Add the CSV exception object to the module. */
     get_csv_state(module)->error_obj = PyErr_NewException("_csv.Error", NULL, NULL);
     if (get_csv_state(module)->error_obj == NULL)
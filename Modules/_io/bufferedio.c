@@ -12,6 +12,9 @@
 #include "pycore_object.h"
 #include "structmember.h"         // PyMemberDef
 #include "_iomodule.h"
+#ifdef HAVE_FCNTL_H
+#include <fcntl.h>                // posix_fadvise()
+#endif
 
 /*[clinic input]
 module _io
@@ -236,6 +239,13 @@ typedef struct {
     Py_ssize_t buffer_size;
     Py_ssize_t buffer_mask;
 
+    /* Size of the window of the file read ahead by the OS (0 if none), the
+       file descriptor for the hints (-1 if they are not possible) and the
+       end of the windows requested so far. */
+    Py_ssize_t readahead;
+    int readahead_fd;
+    Py_off_t readahead_end;
+
     PyObject *dict;
     PyObject *weakreflist;
 } buffered;
@@ -1421,18 +1431,30 @@ static void _bufferedreader_reset_buf(buffered *self)
 _io.BufferedReader.__init__
     raw: object
     buffer_size: Py_ssize_t(c_default="DEFAULT_BUFFER_SIZE") = DEFAULT_BUFFER_SIZE
+    *
+    readahead: Py_ssize_t = 0
 
 Create a new buffered reader using the given readable raw IO object.
+
+If readahead is positive, the operating system is asked to read that
+many bytes of the file ahead of the reads, in the background.
 [clinic start generated code]*/
 
 static int
 _io_BufferedReader___init___impl(buffered *self, PyObject *raw,
-                                 Py_ssize_t buffer_size)
-/*[clinic end generated code: output=cddcfefa0ed294c4 input=fb887e06f11b4e48]*/
+                                 Py_ssize_t buffer_size,
+                                 Py_ssize_t readahead)
+/*[clinic end generated code: output=f2327961a828699e input=150956214fba6741]*/
 {
     self->ok = 0;
     self->detached = 0;
 
+    if (readahead < 0) {
+        PyErr_SetString(PyExc_ValueError,
+                        "readahead must not be negative");
+        return -1;
+    }
+
     if (_PyIOBase_check_readable(raw, Py_True) == NULL)
         return -1;
 
@@ -1446,6 +1468,19 @@ _io_BufferedReader___init___impl(buffered *self, PyObject *raw,
         return -1;
     _bufferedreader_reset_buf(self);
 
+    self->readahead = readahead;
+    self->readahead_fd = -1;
+    self->readahead_end = 0;
+#ifdef HAVE_POSIX_FADVISE
+    if (readahead > 0) {
+        /* The hints are only possible for the raw streams with a file
+           descriptor, and skipped for the others. */
+        self->readahead_fd = PyObject_AsFileDescriptor(raw);
+        if (self->readahead_fd < 0)
+            PyErr_Clear();
+    }
+#endif
+
     self->fast_closed_checks = (Py_IS_TYPE(self, &PyBufferedReader_Type) &&
                                 Py_IS_TYPE(raw, &PyFileIO_Type));
 
@@ -1453,6 +1488,37 @@ _io_BufferedReader___init___impl(buffered *self, PyObject *raw,
     return 0;
 }
 
+/* Ask the OS to read the file ahead of the raw stream position, by windows
+   of `readahead` bytes.  The next window is requested once half of the
+   previous one has been read, so that the disk is busy with it while the
+   caller processes the data. */
+static void
+_bufferedreader_prefetch(buffered *self)
+{
+#ifdef HAVE_POSIX_FADVISE
+    Py_off_t pos = self->abs_pos;
+    Py_off_t end = self->readahead_end;
+    int err;
+
+    if (pos > end || end - pos > self->readahead) {
+        /* First read, or the stream was moved away from the window. */
+        end = pos;
+    }
+    if (end - pos > self->readahead / 2)
+        return;
+    Py_BEGIN_ALLOW_THREADS
+    err = posix_fadvise(self->readahead_fd, end, self->readahead,
+                        POSIX_FADV_WILLNEED);
+    Py_END_ALLOW_THREADS
+    if (err) {
+        /* E.g. ESPIPE: the stream is not a regular file after all. */
+        self->readahead_fd = -1;
+        return;
+    }
+    self->readahead_end = end + self->readahead;
+#endif
+}
+
 static Py_ssize_t
 _bufferedreader_raw_read(buffered *self, char *start, Py_ssize_t len)
 {
@@ -1489,8 +1555,11 @@ _bufferedreader_raw_read(buffered *self, char *start, Py_ssize_t len)
                      "(should have been between 0 and %zd)", n, len);
         return -1;
     }
-    if (n > 0 && self->abs_pos != -1)
+    if (n > 0 && self->abs_pos != -1) {
         self->abs_pos += n;
+        if (self->readahead > 0 && self->readahead_fd >= 0)
+            _bufferedreader_prefetch(self);
+    }
     return n;
 }
 
@@ -2404,6 +2473,7 @@ static PyMethodDef bufferedreader_methods[] = {
 
 static PyMemberDef bufferedreader_members[] = {
     {"raw", T_OBJECT, offsetof(buffered, raw), READONLY},
+    {"readahead", T_PYSSIZET, offsetof(buffered, readahead), READONLY},
     {"_finalizing", T_BOOL, offsetof(buffered, finalizing), 0},
     {NULL}
 };
@@ -389,27 +389,32 @@ exit:
 }
 
 PyDoc_STRVAR(_io_BufferedReader___init____doc__,
-"BufferedReader(raw, buffer_size=DEFAULT_BUFFER_SIZE)\n"
+"BufferedReader(raw, buffer_size=DEFAULT_BUFFER_SIZE, *, readahead=0)\n"
 "--\n"
 "\n"
-"Create a new buffered reader using the given readable raw IO object.");
+"Create a new buffered reader using the given readable raw IO object.\n"
+"\n"
+"If readahead is positive, the operating system is asked to read that\n"
+"many bytes of the file ahead of the reads, in the background.");
 
 static int
 _io_BufferedReader___init___impl(buffered *self, PyObject *raw,
-                                 Py_ssize_t buffer_size);
+                                 Py_ssize_t buffer_size,
+                                 Py_ssize_t readahead);
 
 static int
 _io_BufferedReader___init__(PyObject *self, PyObject *args, PyObject *kwargs)
 {
     int return_value = -1;
-    static const char * const _keywords[] = {"raw", "buffer_size", NULL};
+    static const char * const _keywords[] = {"raw", "buffer_size", "readahead", NULL};
     static _PyArg_Parser _parser = {NULL, _keywords, "BufferedReader", 0};
-    PyObject *argsbuf[2];
+    PyObject *argsbuf[3];
     PyObject * const *fastargs;
     Py_ssize_t nargs = PyTuple_GET_SIZE(args);
     Py_ssize_t noptargs = nargs + (kwargs ? PyDict_GET_SIZE(kwargs) : 0) - 1;
     PyObject *raw;
     Py_ssize_t buffer_size = DEFAULT_BUFFER_SIZE;
+    Py_ssize_t readahead = 0;
 
     fastargs = _PyArg_UnpackKeywords(_PyTuple_CAST(args)->ob_item, nargs, kwargs, NULL, &_parser, 1, 2, 0, argsbuf);
     if (!fastargs) {
@@ -419,9 +424,30 @@ _io_BufferedReader___init__(PyObject *self, PyObject *args, PyObject *kwargs)
     if (!noptargs) {
         goto skip_optional_pos;
     }
+    if (fastargs[1]) {
+        {
+            Py_ssize_t ival = -1;
+            PyObject *iobj = PyNumber_Index(fastargs[1]);
+            if (iobj != NULL) {
+                ival = PyLong_AsSsize_t(iobj);
+                Py_DECREF(iobj);
+            }
+            if (ival == -1 && PyErr_Occurred()) {
+                goto exit;
+            }
+            buffer_size = ival;
+        }
+        if (!--noptargs) {
+            goto skip_optional_pos;
+        }
+    }
+skip_optional_pos:
+    if (!noptargs) {
+        goto skip_optional_kwonly;
+    }
     {
         Py_ssize_t ival = -1;
-        PyObject *iobj = PyNumber_Index(fastargs[1]);
+        PyObject *iobj = PyNumber_Index(fastargs[2]);
         if (iobj != NULL) {
             ival = PyLong_AsSsize_t(iobj);
             Py_DECREF(iobj);
@@ -429,10 +455,10 @@ _io_BufferedReader___init__(PyObject *self, PyObject *args, PyObject *kwargs)
         if (ival == -1 && PyErr_Occurred()) {
             goto exit;
         }
-        buffer_size = ival;
+        readahead = ival;
     }
-skip_optional_pos:
-    return_value = _io_BufferedReader___init___impl((buffered *)self, raw, buffer_size);
+skip_optional_kwonly:
+    return_value = _io_BufferedReader___init___impl((buffered *)self, raw, buffer_size, readahead);
 
 exit:
     return return_value;
@@ -637,4 +663,4 @@ skip_optional_pos:
 exit:
     return return_value;
 }
-/*[clinic end generated code: output=1882bb497ddc9375 input=a9049054013a1b77]*/
+/*[clinic end generated code: output=1374196ce41e6f7f input=a9049054013a1b77]*/
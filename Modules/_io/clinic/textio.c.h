@@ -469,6 +469,44 @@ exit:
     return return_value;
 }
 
+PyDoc_STRVAR(_io_TextIOWrapper_readlines__doc__,
+"readlines($self, hint=-1, /)\n"
+"--\n"
+"\n"
+"Return a list of lines from the stream.\n"
+"\n"
+"hint can be specified to control the number of lines read: no more\n"
+"lines will be read if the total size (in characters) of all lines so\n"
+"far exceeds hint.");
+
+#define _IO_TEXTIOWRAPPER_READLINES_METHODDEF    \
+    {"readlines", (PyCFunction)(void(*)(void))_io_TextIOWrapper_readlines, METH_FASTCALL, _io_TextIOWrapper_readlines__doc__},
+
+static PyObject *
+_io_TextIOWrapper_readlines_impl(textio *self, Py_ssize_t hint);
+
+static PyObject *
+_io_TextIOWrapper_readlines(textio *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    PyObject *return_value = NULL;
+    Py_ssize_t hint = -1;
+
+    if (!_PyArg_CheckPositional("readlines", nargs, 0, 1)) {
+        goto exit;
+    }
+    if (nargs < 1) {
+        goto skip_optional;
+    }
+    if (!_Py_convert_optional_to_ssize_t(args[0], &hint)) {
+        goto exit;
+    }
+skip_optional:
+    return_value = _io_TextIOWrapper_readlines_impl(self, hint);
+
+exit:
+    return return_value;
+}
+
 PyDoc_STRVAR(_io_TextIOWrapper_seek__doc__,
 "seek($self, cookie, whence=0, /)\n"
 "--\n"
@@ -671,4 +709,4 @@ _io_TextIOWrapper_close(textio *self, PyObject *Py_UNUSED(ignored))
 {
     return _io_TextIOWrapper_close_impl(self);
 }
-/*[clinic end generated code: output=ea96ee1eb3a71f77 input=a9049054013a1b77]*/
+/*[clinic end generated code: output=b13459c557772e48 input=a9049054013a1b77]*/
@@ -8,6 +8,7 @@
 
 #define PY_SSIZE_T_CLEAN
 #include "Python.h"
+#include "pycore_cpuinfo.h"       // _Py_GetSIMDLevel()
 #include "pycore_interp.h"        // PyInterpreterState.fs_codec
 #include "pycore_object.h"
 #include "pycore_pystate.h"       // _PyInterpreterState_GET()
@@ -2019,6 +2020,94 @@ _io_TextIOWrapper_read_impl(textio *self, Py_ssize_t n)
 }
 
 
+#ifdef _Py_HAVE_X86_SIMD
+/* Skip the vectors of 16 or 32 bytes from s which contain neither ch1 nor
+   ch2, for the line ending searches below. */
+
+#define SKIP_CHARS_SIMD(NAME, TARGET, VEC, LOADU, SET1, CMPEQ, OR, MOVEMASK) \
+static TARGET const char *                                                  \
+NAME(const char *s, const char *end, Py_UCS4 ch1, Py_UCS4 ch2)              \
+{                                                                           \
+    const VEC v1 = SET1(ch1);                                               \
+    const VEC v2 = SET1(ch2);                                               \
+    while (end - s >= (Py_ssize_t)sizeof(VEC)) {                            \
+        VEC a = LOADU((const VEC *)s);                                      \
+        if (MOVEMASK(OR(CMPEQ(a, v1), CMPEQ(a, v2))))                       \
+            break;                                                          \
+        s += sizeof(VEC);                                                   \
+    }                                                                       \
+    return s;                                                               \
+}
+
+#define SSE42_SET1_8(ch) _mm_set1_epi8((char)(ch))
+#define SSE42_SET1_16(ch) _mm_set1_epi16((short)(ch))
+#define SSE42_SET1_32(ch) _mm_set1_epi32((int)(ch))
+#define AVX2_SET1_8(ch) _mm256_set1_epi8((char)(ch))
+#define AVX2_SET1_16(ch) _mm256_set1_epi16((short)(ch))
+#define AVX2_SET1_32(ch) _mm256_set1_epi32((int)(ch))
+
+SKIP_CHARS_SIMD(skip_chars_sse42_1, _Py_TARGET_SSE42, __m128i,
+                _mm_loadu_si128, SSE42_SET1_8, _mm_cmpeq_epi8,
+                _mm_or_si128, _mm_movemask_epi8)
+SKIP_CHARS_SIMD(skip_chars_sse42_2, _Py_TARGET_SSE42, __m128i,
+                _mm_loadu_si128, SSE42_SET1_16, _mm_cmpeq_epi16,
+                _mm_or_si128, _mm_movemask_epi8)
+SKIP_CHARS_SIMD(skip_chars_sse42_4, _Py_TARGET_SSE42, __m128i,
+                _mm_loadu_si128, SSE42_SET1_32, _mm_cmpeq_epi32,
+                _mm_or_si128, _mm_movemask_epi8)
+SKIP_CHARS_SIMD(skip_chars_avx2_1, _Py_TARGET_AVX2, __m256i,
+                _mm256_loadu_si256, AVX2_SET1_8, _mm256_cmpeq_epi8,
+                _mm256_or_si256, _mm256_movemask_epi8)
+SKIP_CHARS_SIMD(skip_chars_avx2_2, _Py_TARGET_AVX2, __m256i,
+                _mm256_loadu_si256, AVX2_SET1_16, _mm256_cmpeq_epi16,
+                _mm256_or_si256, _mm256_movemask_epi8)
+SKIP_CHARS_SIMD(skip_chars_avx2_4, _Py_TARGET_AVX2, __m256i,
+                _mm256_loadu_si256, AVX2_SET1_32, _mm256_cmpeq_epi32,
+                _mm256_or_si256, _mm256_movemask_epi8)
+
+#undef SKIP_CHARS_SIMD
+#undef SSE42_SET1_8
+#undef SSE42_SET1_16
+#undef SSE42_SET1_32
+#undef AVX2_SET1_8
+#undef AVX2_SET1_16
+#undef AVX2_SET1_32
+#endif /* _Py_HAVE_X86_SIMD */
+
+/* Return a position of s, at most the first ch1 or ch2 character, from
+   which the scalar loops finish the search.  Lines are tens of characters
+   long, so the vectors are only worth it past a few of them. */
+static inline const char *
+skip_chars(int kind, const char *s, const char *end, Py_UCS4 ch1, Py_UCS4 ch2)
+{
+#ifdef _Py_HAVE_X86_SIMD
+    if (end - s >= 32) {
+        int level = _Py_GetSIMDLevel();
+        if (level >= _Py_SIMD_AVX2) {
+            switch (kind) {
+            case PyUnicode_1BYTE_KIND:
+                return skip_chars_avx2_1(s, end, ch1, ch2);
+            case PyUnicode_2BYTE_KIND:
+                return skip_chars_avx2_2(s, end, ch1, ch2);
+            default:
+                return skip_chars_avx2_4(s, end, ch1, ch2);
+            }
+        }
+        if (level >= _Py_SIMD_SSE42) {
+            switch (kind) {
+            case PyUnicode_1BYTE_KIND:
+                return skip_chars_sse42_1(s, end, ch1, ch2);
+            case PyUnicode_2BYTE_KIND:
+                return skip_chars_sse42_2(s, end, ch1, ch2);
+            default:
+                return skip_chars_sse42_4(s, end, ch1, ch2);
+            }
+        }
+    }
+#endif
+    return s;
+}
+
 /* NOTE: `end` must point to the real end of the Py_UCS4 storage,
    that is to the NUL character. Otherwise the function will produce
    incorrect results. */
@@ -2029,6 +2118,7 @@ find_control_char(int kind, const char *s, const char *end, Py_UCS4 ch)
         assert(ch < 256);
         return (char *) memchr((const void *) s, (char) ch, end - s);
     }
+    s = skip_chars(kind, s, end, ch, ch);
     for (;;) {
         while (PyUnicode_READ(kind, s, 0) > ch)
             s += kind;
@@ -2064,6 +2154,7 @@ _PyIO_find_line_ending(
         const char *s = start;
         for (;;) {
             Py_UCS4 ch;
+            s = skip_chars(kind, s, end, '\n', '\r');
             /* Fast path for non-control chars. The loop always ends
                since the Unicode string is NUL-terminated. */
             while (PyUnicode_READ(kind, s, 0) > '\r')
@@ -2303,6 +2394,116 @@ _io_TextIOWrapper_readline_impl(textio *self, Py_ssize_t size)
     return _textiowrapper_readline(self, size);
 }
 
+/*[clinic input]
+_io.TextIOWrapper.readlines
+    hint: Py_ssize_t(accept={int, NoneType}) = -1
+    /
+
+Return a list of lines from the stream.
+
+hint can be specified to control the number of lines read: no more
+lines will be read if the total size (in characters) of all lines so
+far exceeds hint.
+[clinic start generated code]*/
+
+static PyObject *
+_io_TextIOWrapper_readlines_impl(textio *self, Py_ssize_t hint)
+/*[clinic end generated code: output=7f9edfd8c77fdbf8 input=8a245843d90a097f]*/
+{
+    PyObject *result, *line;
+    Py_ssize_t length = 0;
+
+    CHECK_ATTACHED(self);
+
+    if (!Py_IS_TYPE(self, &PyTextIOWrapper_Type)) {
+        /* Subclasses may override readline() and __next__() */
+        _Py_IDENTIFIER(readlines);
+        return _PyObject_CallMethodId((PyObject *)&PyIOBase_Type,
+                                      &PyId_readlines, "On", self, hint);
+    }
+
+    CHECK_CLOSED(self);
+
+    if (_textiowrapper_writeflush(self) < 0)
+        return NULL;
+
+    result = PyList_New(0);
+    if (result == NULL)
+        return NULL;
+
+    /* As when iterating over the lines, telling the position is disabled
+       until EOF: no snapshots are taken when reading chunks. */
+    self->telling = 0;
+
+    while (1) {
+        Py_ssize_t line_length;
+
+        /* The lines which end in the decoded chunk are sliced out of it
+           directly, without going through readline(). */
+        if (self->decoded_chars != NULL) {
+            PyObject *chars = self->decoded_chars;
+            int kind = PyUnicode_KIND(chars);
+            const char *ptr = PyUnicode_DATA(chars);
+            Py_ssize_t chars_len = PyUnicode_GET_LENGTH(chars);
+            Py_ssize_t start = self->decoded_chars_used;
+
+            while (start < chars_len) {
+                Py_ssize_t consumed = 0;
+                Py_ssize_t endpos = _PyIO_find_line_ending(
+                    self->readtranslate, self->readuniversal, self->readnl,
+                    kind,
+                    ptr + kind * start,
+                    ptr + kind * chars_len,
+                    &consumed);
+                if (endpos < 0)
+                    break;
+                line = PyUnicode_Substring(chars, start, start + endpos);
+                if (line == NULL)
+                    goto error;
+                start += endpos;
+                self->decoded_chars_used = start;
+                if (PyList_Append(result, line) < 0) {
+                    Py_DECREF(line);
+                    goto error;
+                }
+                Py_DECREF(line);
+                if (hint > 0) {
+                    if (endpos > hint - length)
+                        return result;
+                    length += endpos;
+                }
+            }
+        }
+
+        /* The next line continues in the following chunks */
+        line = _textiowrapper_readline(self, -1);
+        if (line == NULL)
+            goto error;
+        line_length = PyUnicode_GET_LENGTH(line);
+        if (line_length == 0) {
+            /* Reached EOF or would have blocked */
+            Py_DECREF(line);
+            Py_CLEAR(self->snapshot);
+            self->telling = self->seekable;
+            return result;
+        }
+        if (PyList_Append(result, line) < 0) {
+            Py_DECREF(line);
+            goto error;
+        }
+        Py_DECREF(line);
+        if (hint > 0) {
+            if (line_length > hint - length)
+                return result;
+            length += line_length;
+        }
+    }
+
+  error:
+    Py_DECREF(result);
+    return NULL;
+}
+
 /* Seek and Tell */
 
 typedef struct {
@@ -3237,6 +3438,7 @@ static PyMethodDef textiowrapper_methods[] = {
     _IO_TEXTIOWRAPPER_WRITE_METHODDEF
     _IO_TEXTIOWRAPPER_READ_METHODDEF
     _IO_TEXTIOWRAPPER_READLINE_METHODDEF
+    _IO_TEXTIOWRAPPER_READLINES_METHODDEF
     _IO_TEXTIOWRAPPER_FLUSH_METHODDEF
     _IO_TEXTIOWRAPPER_CLOSE_METHODDEF
 
@@ -10,7 +10,7 @@
 
 #include "Python.h"
 #include "structmember.h"         // PyMemberDef
-#include "pycore_accu.h"
+#include "pycore_cpuinfo.h"       // _Py_GetSIMDLevel()
 
 typedef struct {
     PyObject *PyScannerType;
@@ -26,19 +26,37 @@ get_json_state(PyObject *module)
 }
 
 
+/* The scanner keeps the keys of the objects it decoded in a direct-mapped
+   cache, indexed by a hash of their encoded characters, so that decoding
+   many objects with the same keys does not create a new string for each
+   key.  The cache is kept across calls and is bounded in size: a key
+   replaces the one in its slot, and only short keys without escapes are
+   cached.  Each entry also remembers the size of the last object whose
+   first key it was, to create the next one with the right size. */
+#define KEY_CACHE_SIZE 512
+#define KEY_CACHE_MAX_LENGTH 64
+
+typedef struct {
+    PyObject *key;
+    Py_ssize_t object_size;
+} _PyScannerKey;
+
 typedef struct _PyScannerObject {
     PyObject_HEAD
     signed char strict;
+    signed char presize_dicts;
     PyObject *object_hook;
     PyObject *object_pairs_hook;
     PyObject *parse_float;
     PyObject *parse_int;
     PyObject *parse_constant;
     PyObject *memo;
+    _PyScannerKey *key_cache;   /* KEY_CACHE_SIZE entries, or NULL */
 } PyScannerObject;
 
 static PyMemberDef scanner_members[] = {
     {"strict", T_BOOL, offsetof(PyScannerObject, strict), READONLY, "strict"},
+    {"presize_dicts", T_BOOL, offsetof(PyScannerObject, presize_dicts), READONLY, "presize_dicts"},
     {"object_hook", T_OBJECT, offsetof(PyScannerObject, object_hook), READONLY, "object_hook"},
     {"object_pairs_hook", T_OBJECT, offsetof(PyScannerObject, object_pairs_hook), READONLY},
     {"parse_float", T_OBJECT, offsetof(PyScannerObject, parse_float), READONLY, "parse_float"},
@@ -61,6 +79,18 @@ typedef struct _PyEncoderObject {
     PyCFunction fast_encode;
 } PyEncoderObject;
 
+/* The encoder writes its output to a _PyUnicodeWriter.  When write is not
+   NULL, the output is passed to it by chunks of about ENCODER_CHUNK_SIZE
+   characters, encoded to UTF-8 if utf8 is set, instead of being kept
+   until the end. */
+#define ENCODER_CHUNK_SIZE 65536
+
+typedef struct {
+    _PyUnicodeWriter writer;
+    PyObject *write;
+    int utf8;
+} _PyEncoderOutput;
+
 static PyMemberDef encoder_members[] = {
     {"markers", T_OBJECT, offsetof(PyEncoderObject, markers), READONLY, "markers"},
     {"default", T_OBJECT, offsetof(PyEncoderObject, defaultfn), READONLY, "default"},
@@ -83,6 +113,10 @@ void init_json(void);
 static PyObject *
 scan_once_unicode(PyScannerObject *s, PyObject *pystr, Py_ssize_t idx, Py_ssize_t *next_idx_ptr);
 static PyObject *
+scan_once_bytes(PyScannerObject *s, PyObject *pystr, const char *input, Py_ssize_t length, Py_ssize_t idx, Py_ssize_t *next_idx_ptr);
+static PyObject *
+scanstring_bytes(PyObject *pystr, const char *input, Py_ssize_t len, Py_ssize_t end, int strict, Py_ssize_t *next_end_ptr);
+static PyObject *
 _build_rval_index_tuple(PyObject *rval, Py_ssize_t idx);
 static PyObject *
 scanner_new(PyTypeObject *type, PyObject *args, PyObject *kwds);
@@ -97,11 +131,13 @@ encoder_dealloc(PyObject *self);
 static int
 encoder_clear(PyEncoderObject *self);
 static int
-encoder_listencode_list(PyEncoderObject *s, _PyAccu *acc, PyObject *seq, Py_ssize_t indent_level);
+encoder_listencode_list(PyEncoderObject *s, _PyEncoderOutput *out, PyObject *seq, Py_ssize_t indent_level);
+static int
+encoder_listencode_obj(PyEncoderObject *s, _PyEncoderOutput *out, PyObject *obj, Py_ssize_t indent_level);
 static int
-encoder_listencode_obj(PyEncoderObject *s, _PyAccu *acc, PyObject *obj, Py_ssize_t indent_level);
+encoder_listencode_dict(PyEncoderObject *s, _PyEncoderOutput *out, PyObject *dct, Py_ssize_t indent_level);
 static int
-encoder_listencode_dict(PyEncoderObject *s, _PyAccu *acc, PyObject *dct, Py_ssize_t indent_level);
+encoder_flush(_PyEncoderOutput *out, int force);
 static PyObject *
 _encoded_const(PyObject *obj);
 static void
@@ -114,6 +150,84 @@ encoder_encode_float(PyEncoderObject *s, PyObject *obj);
 #define S_CHAR(c) (c >= ' ' && c <= '~' && c != '\\' && c != '"')
 #define IS_WHITESPACE(c) (((c) == ' ') || ((c) == '\t') || ((c) == '\n') || ((c) == '\r'))
 
+/* The characters that end a run of plain characters in a JSON string:
+   the closing quote, a backslash and the control characters, which are
+   either errors or, when strict is false, copied as they are. */
+#define IS_STRING_SPECIAL(c) ((c) == '"' || (c) == '\\' || (c) <= 0x1f)
+
+#ifdef _Py_HAVE_X86_SIMD
+/* Compare 16 or 32 bytes at a time against the quote and the backslash,
+   and find the control characters as the bytes whose unsigned maximum
+   with 0x1f is 0x1f.  Return the index of the first special byte, or the
+   start of the last block shorter than a vector. */
+_Py_TARGET_SSE42 static Py_ssize_t
+find_string_special_sse42(const unsigned char *buf, Py_ssize_t i,
+                          Py_ssize_t end)
+{
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1f);
+    for (; i + 16 <= end; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(buf + i));
+        __m128i m = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, quote),
+                         _mm_cmpeq_epi8(v, backslash)),
+            _mm_cmpeq_epi8(_mm_max_epu8(v, control), control));
+        unsigned int bits = (unsigned int)_mm_movemask_epi8(m);
+        if (bits) {
+            return i + __builtin_ctz(bits);
+        }
+    }
+    return i;
+}
+
+_Py_TARGET_AVX2 static Py_ssize_t
+find_string_special_avx2(const unsigned char *buf, Py_ssize_t i,
+                         Py_ssize_t end)
+{
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i control = _mm256_set1_epi8(0x1f);
+    for (; i + 32 <= end; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(buf + i));
+        __m256i m = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, quote),
+                            _mm256_cmpeq_epi8(v, backslash)),
+            _mm256_cmpeq_epi8(_mm256_max_epu8(v, control), control));
+        unsigned int bits = (unsigned int)_mm256_movemask_epi8(m);
+        if (bits) {
+            return i + __builtin_ctz(bits);
+        }
+    }
+    return i;
+}
+#endif
+
+static Py_ssize_t
+find_string_special(const unsigned char *buf, Py_ssize_t i, Py_ssize_t end)
+{
+    /* Return the index of the first quote, backslash or control character
+       of the bytes buf[i:end], or end if there is none.  This also works
+       on the data of 1-byte kind strings. */
+#ifdef _Py_HAVE_X86_SIMD
+    if (end - i >= 16) {
+        int level = _Py_GetSIMDLevel();
+        if (level >= _Py_SIMD_AVX2) {
+            i = find_string_special_avx2(buf, i, end);
+        }
+        if (level >= _Py_SIMD_SSE42) {
+            i = find_string_special_sse42(buf, i, end);
+        }
+    }
+#endif
+    for (; i < end; i++) {
+        if (IS_STRING_SPECIAL(buf[i])) {
+            break;
+        }
+    }
+    return i;
+}
+
 static Py_ssize_t
 ascii_escape_unichar(Py_UCS4 c, unsigned char *output, Py_ssize_t chars)
 {
@@ -411,14 +525,31 @@ scanstring_unicode(PyObject *pystr, Py_ssize_t end, int strict, Py_ssize_t *next
         {
             // Use tight scope variable to help register allocation.
             Py_UCS4 d = 0;
-            for (next = end; next < len; next++) {
-                d = PyUnicode_READ(kind, buf, next);
-                if (d == '"' || d == '\\') {
-                    break;
+            if (kind == PyUnicode_1BYTE_KIND) {
+                const Py_UCS1 *ucs1 = (const Py_UCS1 *)buf;
+                next = end;
+                while ((next = find_string_special(ucs1, next, len)) < len) {
+                    d = ucs1[next];
+                    if (d == '"' || d == '\\') {
+                        break;
+                    }
+                    if (strict) {
+                        raise_errmsg("Invalid control character at", pystr, next);
+                        goto bail;
+                    }
+                    next++;
                 }
-                if (d <= 0x1f && strict) {
-                    raise_errmsg("Invalid control character at", pystr, next);
-                    goto bail;
+            }
+            else {
+                for (next = end; next < len; next++) {
+                    d = PyUnicode_READ(kind, buf, next);
+                    if (d == '"' || d == '\\') {
+                        break;
+                    }
+                    if (d <= 0x1f && strict) {
+                        raise_errmsg("Invalid control character at", pystr, next);
+                        goto bail;
+                    }
                 }
             }
             c = d;
@@ -558,7 +689,10 @@ PyDoc_STRVAR(pydoc_scanstring,
     "control characters are allowed in the string.\n"
     "\n"
     "Returns a tuple of the decoded string and the index of the character in s\n"
-    "after the end quote."
+    "after the end quote.\n"
+    "\n"
+    "If s is a bytes-like object, it is decoded as UTF-8 and the indices\n"
+    "are byte offsets."
 );
 
 static PyObject *
@@ -575,9 +709,19 @@ py_scanstring(PyObject* Py_UNUSED(self), PyObject *args)
     if (PyUnicode_Check(pystr)) {
         rval = scanstring_unicode(pystr, end, strict, &next_end);
     }
+    else if (PyObject_CheckBuffer(pystr)) {
+        Py_buffer view;
+        if (PyObject_GetBuffer(pystr, &view, PyBUF_SIMPLE) < 0) {
+            return NULL;
+        }
+        rval = scanstring_bytes(pystr, view.buf, view.len, end, strict,
+                                &next_end);
+        PyBuffer_Release(&view);
+    }
     else {
         PyErr_Format(PyExc_TypeError,
-                     "first argument must be a string, not %.80s",
+                     "first argument must be a string or a bytes-like "
+                     "object, not %.80s",
                      Py_TYPE(pystr)->tp_name);
         return NULL;
     }
@@ -633,6 +777,114 @@ py_encode_basestring(PyObject* Py_UNUSED(self), PyObject *pystr)
     return rval;
 }
 
+/* Bits of the state of find_value_end(), the rest is the nesting depth */
+#define VALUE_IN_STRING 1
+#define VALUE_IN_ESCAPE 2
+#define VALUE_IN_SCALAR 4
+#define VALUE_STATE_BITS 3
+
+PyDoc_STRVAR(pydoc_find_value_end,
+    "find_value_end(buffer, idx, state) -> (end, state)\n"
+    "\n"
+    "Scan the UTF-8 encoded JSON text in buffer from idx for the end of a\n"
+    "top-level value, without decoding it.  State is 0 when idx is the\n"
+    "first byte of the value, otherwise the state returned by the previous\n"
+    "call, with idx the end it returned.\n"
+    "\n"
+    "Returns a tuple of the index after the value and 0 if the value is\n"
+    "complete, or of len(buffer) and the state to resume from when more\n"
+    "data arrives.  A top-level number or constant ends at the next\n"
+    "whitespace or structural character."
+);
+
+static PyObject *
+py_find_value_end(PyObject* Py_UNUSED(self), PyObject *args)
+{
+    PyObject *pybuf;
+    Py_buffer view;
+    const unsigned char *buf;
+    Py_ssize_t idx, len, depth, state;
+    int flags;
+
+    if (!PyArg_ParseTuple(args, "Onn:find_value_end", &pybuf, &idx, &state)) {
+        return NULL;
+    }
+    if (idx < 0 || state < 0) {
+        PyErr_SetString(PyExc_ValueError,
+                        "idx and state must not be negative");
+        return NULL;
+    }
+    if (PyObject_GetBuffer(pybuf, &view, PyBUF_SIMPLE) < 0) {
+        return NULL;
+    }
+    buf = (const unsigned char *)view.buf;
+    len = view.len;
+    depth = state >> VALUE_STATE_BITS;
+    flags = (int)(state & ((1 << VALUE_STATE_BITS) - 1));
+
+    while (idx < len) {
+        unsigned char c;
+        if (flags & VALUE_IN_ESCAPE) {
+            flags = VALUE_IN_STRING;
+            idx++;
+            continue;
+        }
+        if (flags & VALUE_IN_STRING) {
+            idx = find_string_special(buf, idx, len);
+            if (idx == len) {
+                break;
+            }
+            c = buf[idx++];
+            if (c == '\\') {
+                flags = VALUE_IN_STRING | VALUE_IN_ESCAPE;
+            }
+            else if (c == '"') {
+                flags = 0;
+                if (depth == 0) {
+                    goto done;
+                }
+            }
+            continue;
+        }
+        c = buf[idx];
+        if (flags & VALUE_IN_SCALAR) {
+            if (IS_WHITESPACE(c) || c == '[' || c == ']' || c == '{' ||
+                c == '}' || c == ',' || c == ':' || c == '"') {
+                flags = 0;
+                goto done;
+            }
+            idx++;
+            continue;
+        }
+        idx++;
+        switch (c) {
+            case '"':
+                flags = VALUE_IN_STRING;
+                break;
+            case '[': case '{':
+                depth++;
+                break;
+            case ']': case '}':
+                /* An unbalanced bracket ends the value, for the scanner
+                   to report the error */
+                if (depth <= 1) {
+                    depth = 0;
+                    goto done;
+                }
+                depth--;
+                break;
+            default:
+                if (depth == 0 && !IS_WHITESPACE(c)) {
+                    flags = VALUE_IN_SCALAR;
+                }
+        }
+    }
+done:
+    PyBuffer_Release(&view);
+    return Py_BuildValue("nn", idx,
+                         (depth << VALUE_STATE_BITS) | (Py_ssize_t)flags);
+}
+
 static void
 scanner_dealloc(PyObject *self)
 {
@@ -665,9 +917,213 @@ scanner_clear(PyScannerObject *self)
     Py_CLEAR(self->parse_int);
     Py_CLEAR(self->parse_constant);
     Py_CLEAR(self->memo);
+    if (self->key_cache != NULL) {
+        _PyScannerKey *cache = self->key_cache;
+        Py_ssize_t i;
+        self->key_cache = NULL;
+        for (i = 0; i < KEY_CACHE_SIZE; i++) {
+            Py_XDECREF(cache[i].key);
+        }
+        PyMem_Free(cache);
+    }
     return 0;
 }
 
+static _PyScannerKey *
+_key_cache_entry(PyScannerObject *s, int kind, const void *data, Py_ssize_t n)
+{
+    /* Return the entry of the key cache of s for the key of n characters
+       of the given kind at data.  UTF-8 keys are hashed as 1-byte kind,
+       so that ASCII keys have the same entry in str and bytes input. */
+    uint32_t h = 2166136261U;
+    Py_ssize_t i;
+
+    if (s->key_cache == NULL) {
+        s->key_cache = PyMem_Calloc(KEY_CACHE_SIZE, sizeof(_PyScannerKey));
+        if (s->key_cache == NULL) {
+            PyErr_NoMemory();
+            return NULL;
+        }
+    }
+    /* FNV-1a on the code points, folded to mix the high bits into the
+       index */
+    for (i = 0; i < n; i++) {
+        h = (h ^ PyUnicode_READ(kind, data, i)) * 16777619U;
+    }
+    return &s->key_cache[(h ^ (h >> 16)) & (KEY_CACHE_SIZE - 1)];
+}
+
+static PyObject *
+_key_cache_store(_PyScannerKey *entry, PyObject *key)
+{
+    /* Replace the key of entry with key, return key */
+    Py_INCREF(key);
+    Py_XSETREF(entry->key, key);
+    entry->object_size = 0;
+    return key;
+}
+
+static PyObject *
+_memo_key(PyScannerObject *s, PyObject *key)
+{
+    /* Return the first key equal to key found in this call, stealing the
+       reference to key */
+    PyObject *memokey;
+    if (key == NULL) {
+        return NULL;
+    }
+    memokey = PyDict_SetDefault(s->memo, key, key);
+    Py_XINCREF(memokey);
+    Py_DECREF(key);
+    return memokey;
+}
+
+static PyObject *
+scan_key_unicode(PyScannerObject *s, PyObject *pystr, Py_ssize_t idx,
+                 Py_ssize_t *next_idx_ptr, _PyScannerKey **entry_ptr)
+{
+    /* Read the key of a JSON object from PyUnicode pystr, like
+    scanstring_unicode().
+    idx is the index of the first character after the quote.
+    *entry_ptr is set to the entry of the key cache of short keys without
+        escapes, and to NULL for the other keys.
+
+    Return value is a new PyUnicode
+    */
+    const void *str = PyUnicode_DATA(pystr);
+    int kind = PyUnicode_KIND(pystr);
+    Py_ssize_t len = PyUnicode_GET_LENGTH(pystr);
+    Py_ssize_t limit = Py_MIN(len, idx + KEY_CACHE_MAX_LENGTH + 1);
+    Py_ssize_t end;
+
+    *entry_ptr = NULL;
+    if (kind == PyUnicode_1BYTE_KIND) {
+        end = find_string_special(str, idx, limit);
+    }
+    else {
+        for (end = idx; end < limit; end++) {
+            Py_UCS4 c = PyUnicode_READ(kind, str, end);
+            if (IS_STRING_SPECIAL(c)) {
+                break;
+            }
+        }
+    }
+    if (end < limit && PyUnicode_READ(kind, str, end) == '"') {
+        const unsigned char *data = (const unsigned char *)str + idx * kind;
+        Py_ssize_t n = end - idx;
+        _PyScannerKey *entry = _key_cache_entry(s, kind, data, n);
+        PyObject *key;
+        if (entry == NULL) {
+            return NULL;
+        }
+        key = entry->key;
+        if (key != NULL && PyUnicode_GET_LENGTH(key) == n) {
+            int key_kind = PyUnicode_KIND(key);
+            const void *key_data = PyUnicode_DATA(key);
+            Py_ssize_t i;
+            if (key_kind == kind) {
+                i = memcmp(key_data, data, n * kind) ? 0 : n;
+            }
+            else {
+                for (i = 0; i < n; i++) {
+                    if (PyUnicode_READ(key_kind, key_data, i) !=
+                        PyUnicode_READ(kind, data, i)) {
+                        break;
+                    }
+                }
+            }
+            if (i == n) {
+                Py_INCREF(key);
+                *entry_ptr = entry;
+                *next_idx_ptr = end + 1;
+                return key;
+            }
+        }
+        key = PyUnicode_Substring(pystr, idx, end);
+        if (key == NULL) {
+            return NULL;
+        }
+        *entry_ptr = entry;
+        *next_idx_ptr = end + 1;
+        return _key_cache_store(entry, key);
+    }
+    return _memo_key(s, scanstring_unicode(pystr, idx, s->strict,
+                                           next_idx_ptr));
+}
+
+static PyObject *
+scan_key_bytes(PyScannerObject *s, PyObject *pystr, const char *input,
+               Py_ssize_t length, Py_ssize_t idx, Py_ssize_t *next_idx_ptr,
+               _PyScannerKey **entry_ptr)
+{
+    /* Read the key of a JSON object from the UTF-8 encoded buffer input,
+    like scanstring_bytes().
+    idx is the index of the first byte after the quote.
+    *entry_ptr is set to the entry of the key cache of short keys without
+        escapes, and to NULL for the other keys.
+
+    Return value is a new PyUnicode
+    */
+    const unsigned char *buf = (const unsigned char *)input;
+    Py_ssize_t limit = Py_MIN(length, idx + KEY_CACHE_MAX_LENGTH + 1);
+    Py_ssize_t end;
+
+    *entry_ptr = NULL;
+    end = find_string_special(buf, idx, limit);
+    if (end < limit && buf[end] == '"') {
+        const unsigned char *data = buf + idx;
+        Py_ssize_t n = end - idx;
+        _PyScannerKey *entry = _key_cache_entry(s, PyUnicode_1BYTE_KIND,
+                                                data, n);
+        PyObject *key;
+        if (entry == NULL) {
+            return NULL;
+        }
+        key = entry->key;
+        if (key != NULL) {
+            const char *utf8;
+            Py_ssize_t size;
+            if (PyUnicode_IS_ASCII(key)) {
+                utf8 = (const char *)PyUnicode_1BYTE_DATA(key);
+                size = PyUnicode_GET_LENGTH(key);
+            }
+            else {
+                /* Keys with lone surrogates cannot be encoded */
+                utf8 = PyUnicode_AsUTF8AndSize(key, &size);
+                if (utf8 == NULL) {
+                    PyErr_Clear();
+                }
+            }
+            if (utf8 != NULL && size == n && memcmp(utf8, data, n) == 0) {
+                Py_INCREF(key);
+                *entry_ptr = entry;
+                *next_idx_ptr = end + 1;
+                return key;
+            }
+        }
+        key = PyUnicode_DecodeUTF8(input + idx, n, "surrogatepass");
+        if (key == NULL) {
+            return NULL;
+        }
+        *entry_ptr = entry;
+        *next_idx_ptr = end + 1;
+        return _key_cache_store(entry, key);
+    }
+    return _memo_key(s, scanstring_bytes(pystr, input, length, idx,
+                                         s->strict, next_idx_ptr));
+}
+
+static PyObject *
+_new_object_dict(PyScannerObject *s, _PyScannerKey *entry)
+{
+    /* Create the dict of an object whose first key has the cache entry
+       entry (or NULL) */
+    if (s->presize_dicts && entry != NULL && entry->object_size > 0) {
+        return _PyDict_NewPresized(entry->object_size);
+    }
+    return PyDict_New();
+}
+
 static PyObject *
 _parse_object_unicode(PyScannerObject *s, PyObject *pystr, Py_ssize_t idx, Py_ssize_t *next_idx_ptr)
 {
@@ -686,6 +1142,10 @@ _parse_object_unicode(PyScannerObject *s, PyObject *pystr, Py_ssize_t idx, Py_ss
     PyObject *key = NULL;
     int has_pairs_hook = (s->object_pairs_hook != Py_None);
     Py_ssize_t next_idx;
+    _PyScannerKey *entry;
+    _PyScannerKey *first_entry = NULL;
+    PyObject *first_key = NULL;
+    Py_ssize_t nitems = 0;
 
     if (PyUnicode_READY(pystr) == -1)
         return NULL;
@@ -694,12 +1154,12 @@ _parse_object_unicode(PyScannerObject *s, PyObject *pystr, Py_ssize_t idx, Py_ss
     kind = PyUnicode_KIND(pystr);
     end_idx = PyUnicode_GET_LENGTH(pystr) - 1;
 
-    if (has_pairs_hook)
+    /* The dict is created when its first key is known */
+    if (has_pairs_hook) {
         rval = PyList_New(0);
-    else
-        rval = PyDict_New();
-    if (rval == NULL)
-        return NULL;
+        if (rval == NULL)
+            return NULL;
+    }
 
     /* skip whitespace after { */
     while (idx <= end_idx && IS_WHITESPACE(PyUnicode_READ(kind,str, idx))) idx++;
@@ -707,23 +1167,21 @@ _parse_object_unicode(PyScannerObject *s, PyObject *pystr, Py_ssize_t idx, Py_ss
     /* only loop if the object is non-empty */
     if (idx > end_idx || PyUnicode_READ(kind, str, idx) != '}') {
         while (1) {
-            PyObject *memokey;
-
             /* read key */
             if (idx > end_idx || PyUnicode_READ(kind, str, idx) != '"') {
                 raise_errmsg("Expecting property name enclosed in double quotes", pystr, idx);
                 goto bail;
             }
-            key = scanstring_unicode(pystr, idx + 1, s->strict, &next_idx);
+            key = scan_key_unicode(s, pystr, idx + 1, &next_idx, &entry);
             if (key == NULL)
                 goto bail;
-            memokey = PyDict_SetDefault(s->memo, key, key);
-            if (memokey == NULL) {
-                goto bail;
+            if (rval == NULL) {
+                rval = _new_object_dict(s, entry);
+                if (rval == NULL)
+                    goto bail;
+                first_entry = entry;
+                first_key = key;
             }
-            Py_INCREF(memokey);
-            Py_DECREF(key);
-            key = memokey;
             idx = next_idx;
 
             /* skip whitespace between key and : delimiter, read :, skip whitespace */
@@ -757,6 +1215,7 @@ _parse_object_unicode(PyScannerObject *s, PyObject *pystr, Py_ssize_t idx, Py_ss
                     goto bail;
                 Py_CLEAR(key);
                 Py_CLEAR(val);
+                nitems++;
             }
             idx = next_idx;
 
@@ -779,6 +1238,17 @@ _parse_object_unicode(PyScannerObject *s, PyObject *pystr, Py_ssize_t idx, Py_ss
 
     *next_idx_ptr = idx + 1;
 
+    if (rval == NULL) {
+        rval = PyDict_New();
+        if (rval == NULL)
+            return NULL;
+    }
+    /* Remember the size for the next object with the same first key, if
+       the entry was not reused by the keys of nested objects */
+    else if (first_entry != NULL && first_entry->key == first_key) {
+        first_entry->object_size = nitems;
+    }
+
     if (has_pairs_hook) {
         val = PyObject_CallOneArg(s->object_pairs_hook, rval);
         Py_DECREF(rval);
@@ -1129,80 +1599,679 @@ scan_once_unicode(PyScannerObject *s, PyObject *pystr, Py_ssize_t idx, Py_ssize_
     return _match_number_unicode(s, pystr, idx, next_idx_ptr);
 }
 
-static PyObject *
-scanner_call(PyScannerObject *self, PyObject *args, PyObject *kwds)
+static int
+_write_utf8(_PyUnicodeWriter *writer, const char *buf, Py_ssize_t size)
 {
-    /* Python callable interface to scan_once_{str,unicode} */
-    PyObject *pystr;
-    PyObject *rval;
-    Py_ssize_t idx;
-    Py_ssize_t next_idx = -1;
-    static char *kwlist[] = {"string", "idx", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "On:scan_once", kwlist, &pystr, &idx))
-        return NULL;
+    /* Decode the UTF-8 bytes buf[:size] and append them to writer */
+    PyObject *chunk;
+    int res;
 
-    if (PyUnicode_Check(pystr)) {
-        rval = scan_once_unicode(self, pystr, idx, &next_idx);
+    chunk = PyUnicode_DecodeUTF8(buf, size, "surrogatepass");
+    if (chunk == NULL) {
+        return -1;
     }
-    else {
-        PyErr_Format(PyExc_TypeError,
-                 "first argument must be a string, not %.80s",
-                 Py_TYPE(pystr)->tp_name);
-        return NULL;
+    res = _PyUnicodeWriter_WriteStr(writer, chunk);
+    Py_DECREF(chunk);
+    return res;
+}
+
+static Py_UCS4
+_decode_hex4(const unsigned char *p)
+{
+    /* Decode the 4 hex digits at p, return (Py_UCS4)-1 if one is not */
+    Py_UCS4 c = 0;
+    int i;
+    for (i = 0; i < 4; i++) {
+        Py_UCS4 digit = p[i];
+        c <<= 4;
+        switch (digit) {
+            case '0': case '1': case '2': case '3': case '4':
+            case '5': case '6': case '7': case '8': case '9':
+                c |= (digit - '0'); break;
+            case 'a': case 'b': case 'c': case 'd': case 'e':
+            case 'f':
+                c |= (digit - 'a' + 10); break;
+            case 'A': case 'B': case 'C': case 'D': case 'E':
+            case 'F':
+                c |= (digit - 'A' + 10); break;
+            default:
+                return (Py_UCS4)-1;
+        }
     }
-    PyDict_Clear(self->memo);
-    if (rval == NULL)
-        return NULL;
-    return _build_rval_index_tuple(rval, next_idx);
+    return c;
 }
 
 static PyObject *
-scanner_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+scanstring_bytes(PyObject *pystr, const char *input, Py_ssize_t len,
+                 Py_ssize_t end, int strict, Py_ssize_t *next_end_ptr)
 {
-    PyScannerObject *s;
-    PyObject *ctx;
-    PyObject *strict;
-    static char *kwlist[] = {"context", NULL};
+    /* Read the JSON string from the UTF-8 encoded buffer input of len bytes,
+    exported by pystr.  Indices are byte offsets in the buffer.
+    end is the index of the first byte after the quote.
+    if strict is zero then literal control characters are allowed
+    *next_end_ptr is a return-by-reference index of the byte
+        after the end quote
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O:make_scanner", kwlist, &ctx))
-        return NULL;
+    Runs of plain characters are decoded from UTF-8 as they are found,
+    with the "surrogatepass" error handler, like json.loads() does.
 
-    s = (PyScannerObject *)type->tp_alloc(type, 0);
-    if (s == NULL) {
-        return NULL;
-    }
+    Return value is a new PyUnicode
+    */
+    const unsigned char *buf = (const unsigned char *)input;
+    PyObject *rval = NULL;
+    Py_ssize_t begin = end - 1;
+    Py_ssize_t next /* = begin */;
 
-    s->memo = PyDict_New();
-    if (s->memo == NULL)
-        goto bail;
+    _PyUnicodeWriter writer;
+    _PyUnicodeWriter_Init(&writer);
+    writer.overallocate = 1;
 
-    /* All of these will fail "gracefully" so we don't need to verify them */
-    strict = PyObject_GetAttrString(ctx, "strict");
-    if (strict == NULL)
-        goto bail;
-    s->strict = PyObject_IsTrue(strict);
-    Py_DECREF(strict);
-    if (s->strict < 0)
-        goto bail;
-    s->object_hook = PyObject_GetAttrString(ctx, "object_hook");
-    if (s->object_hook == NULL)
-        goto bail;
-    s->object_pairs_hook = PyObject_GetAttrString(ctx, "object_pairs_hook");
-    if (s->object_pairs_hook == NULL)
-        goto bail;
-    s->parse_float = PyObject_GetAttrString(ctx, "parse_float");
-    if (s->parse_float == NULL)
-        goto bail;
-    s->parse_int = PyObject_GetAttrString(ctx, "parse_int");
-    if (s->parse_int == NULL)
-        goto bail;
-    s->parse_constant = PyObject_GetAttrString(ctx, "parse_constant");
-    if (s->parse_constant == NULL)
+    if (end < 0 || len < end) {
+        PyErr_SetString(PyExc_ValueError, "end is out of bounds");
         goto bail;
-
-    return (PyObject *)s;
-
-bail:
+    }
+    while (1) {
+        /* Find the end of the string or the next escape */
+        Py_UCS4 c = 0;
+        next = end;
+        while ((next = find_string_special(buf, next, len)) < len) {
+            c = buf[next];
+            if (c == '"' || c == '\\') {
+                break;
+            }
+            if (strict) {
+                raise_errmsg("Invalid control character at", pystr, next);
+                goto bail;
+            }
+            next++;
+        }
+
+        if (c == '"') {
+            // Fast path for simple case.
+            if (writer.buffer == NULL) {
+                PyObject *ret = PyUnicode_DecodeUTF8(input + end, next - end,
+                                                     "surrogatepass");
+                if (ret == NULL) {
+                    goto bail;
+                }
+                *next_end_ptr = next + 1;
+                return ret;
+            }
+        }
+        else if (c != '\\') {
+            raise_errmsg("Unterminated string starting at", pystr, begin);
+            goto bail;
+        }
+
+        /* Pick up this chunk if it's not zero length */
+        if (next != end) {
+            if (_write_utf8(&writer, input + end, next - end) < 0) {
+                goto bail;
+            }
+        }
+        next++;
+        if (c == '"') {
+            end = next;
+            break;
+        }
+        if (next == len) {
+            raise_errmsg("Unterminated string starting at", pystr, begin);
+            goto bail;
+        }
+        c = buf[next];
+        if (c != 'u') {
+            /* Non-unicode backslash escapes */
+            end = next + 1;
+            switch (c) {
+                case '"': break;
+                case '\\': break;
+                case '/': break;
+                case 'b': c = '\b'; break;
+                case 'f': c = '\f'; break;
+                case 'n': c = '\n'; break;
+                case 'r': c = '\r'; break;
+                case 't': c = '\t'; break;
+                default: c = 0;
+            }
+            if (c == 0) {
+                raise_errmsg("Invalid \\escape", pystr, end - 2);
+                goto bail;
+            }
+        }
+        else {
+            next++;
+            end = next + 4;
+            if (end >= len) {
+                raise_errmsg("Invalid \\uXXXX escape", pystr, next - 1);
+                goto bail;
+            }
+            c = _decode_hex4(buf + next);
+            if (c == (Py_UCS4)-1) {
+                raise_errmsg("Invalid \\uXXXX escape", pystr, end - 5);
+                goto bail;
+            }
+            /* Surrogate pair */
+            if (Py_UNICODE_IS_HIGH_SURROGATE(c) && end + 6 < len &&
+                buf[end] == '\\' && buf[end + 1] == 'u') {
+                Py_UCS4 c2 = _decode_hex4(buf + end + 2);
+                if (c2 == (Py_UCS4)-1) {
+                    raise_errmsg("Invalid \\uXXXX escape", pystr, end + 1);
+                    goto bail;
+                }
+                if (Py_UNICODE_IS_LOW_SURROGATE(c2)) {
+                    c = Py_UNICODE_JOIN_SURROGATES(c, c2);
+                    end += 6;
+                }
+            }
+        }
+        if (_PyUnicodeWriter_WriteChar(&writer, c) < 0) {
+            goto bail;
+        }
+    }
+
+    rval = _PyUnicodeWriter_Finish(&writer);
+    *next_end_ptr = end;
+    return rval;
+
+bail:
+    *next_end_ptr = -1;
+    _PyUnicodeWriter_Dealloc(&writer);
+    return NULL;
+}
+
+static PyObject *
+_parse_object_bytes(PyScannerObject *s, PyObject *pystr, const char *input,
+                    Py_ssize_t length, Py_ssize_t idx, Py_ssize_t *next_idx_ptr)
+{
+    /* Read a JSON object from the UTF-8 encoded buffer input.
+    idx is the index of the first byte after the opening curly brace.
+    *next_idx_ptr is a return-by-reference index to the first byte after
+        the closing curly brace.
+
+    Returns a new PyObject (usually a dict, but object_hook can change that)
+    */
+    const unsigned char *str = (const unsigned char *)input;
+    Py_ssize_t end_idx = length - 1;
+    PyObject *val = NULL;
+    PyObject *rval = NULL;
+    PyObject *key = NULL;
+    int has_pairs_hook = (s->object_pairs_hook != Py_None);
+    Py_ssize_t next_idx;
+    _PyScannerKey *entry;
+    _PyScannerKey *first_entry = NULL;
+    PyObject *first_key = NULL;
+    Py_ssize_t nitems = 0;
+
+    /* The dict is created when its first key is known */
+    if (has_pairs_hook) {
+        rval = PyList_New(0);
+        if (rval == NULL)
+            return NULL;
+    }
+
+    /* skip whitespace after { */
+    while (idx <= end_idx && IS_WHITESPACE(str[idx])) idx++;
+
+    /* only loop if the object is non-empty */
+    if (idx > end_idx || str[idx] != '}') {
+        while (1) {
+            /* read key */
+            if (idx > end_idx || str[idx] != '"') {
+                raise_errmsg("Expecting property name enclosed in double quotes", pystr, idx);
+                goto bail;
+            }
+            key = scan_key_bytes(s, pystr, input, length, idx + 1, &next_idx, &entry);
+            if (key == NULL)
+                goto bail;
+            if (rval == NULL) {
+                rval = _new_object_dict(s, entry);
+                if (rval == NULL)
+                    goto bail;
+                first_entry = entry;
+                first_key = key;
+            }
+            idx = next_idx;
+
+            /* skip whitespace between key and : delimiter, read :, skip whitespace */
+            while (idx <= end_idx && IS_WHITESPACE(str[idx])) idx++;
+            if (idx > end_idx || str[idx] != ':') {
+                raise_errmsg("Expecting ':' delimiter", pystr, idx);
+                goto bail;
+            }
+            idx++;
+            while (idx <= end_idx && IS_WHITESPACE(str[idx])) idx++;
+
+            /* read any JSON term */
+            val = scan_once_bytes(s, pystr, input, length, idx, &next_idx);
+            if (val == NULL)
+                goto bail;
+
+            if (has_pairs_hook) {
+                PyObject *item = PyTuple_Pack(2, key, val);
+                if (item == NULL)
+                    goto bail;
+                Py_CLEAR(key);
+                Py_CLEAR(val);
+                if (PyList_Append(rval, item) == -1) {
+                    Py_DECREF(item);
+                    goto bail;
+                }
+                Py_DECREF(item);
+            }
+            else {
+                if (PyDict_SetItem(rval, key, val) < 0)
+                    goto bail;
+                Py_CLEAR(key);
+                Py_CLEAR(val);
+                nitems++;
+            }
+            idx = next_idx;
+
+            /* skip whitespace before } or , */
+            while (idx <= end_idx && IS_WHITESPACE(str[idx])) idx++;
+
+            /* bail if the object is closed or we didn't get the , delimiter */
+            if (idx <= end_idx && str[idx] == '}')
+                break;
+            if (idx > end_idx || str[idx] != ',') {
+                raise_errmsg("Expecting ',' delimiter", pystr, idx);
+                goto bail;
+            }
+            idx++;
+
+            /* skip whitespace after , delimiter */
+            while (idx <= end_idx && IS_WHITESPACE(str[idx])) idx++;
+        }
+    }
+
+    *next_idx_ptr = idx + 1;
+
+    if (rval == NULL) {
+        rval = PyDict_New();
+        if (rval == NULL)
+            return NULL;
+    }
+    /* Remember the size for the next object with the same first key, if
+       the entry was not reused by the keys of nested objects */
+    else if (first_entry != NULL && first_entry->key == first_key) {
+        first_entry->object_size = nitems;
+    }
+
+    if (has_pairs_hook) {
+        val = PyObject_CallOneArg(s->object_pairs_hook, rval);
+        Py_DECREF(rval);
+        return val;
+    }
+
+    /* if object_hook is not None: rval = object_hook(rval) */
+    if (s->object_hook != Py_None) {
+        val = PyObject_CallOneArg(s->object_hook, rval);
+        Py_DECREF(rval);
+        return val;
+    }
+    return rval;
+bail:
+    Py_XDECREF(key);
+    Py_XDECREF(val);
+    Py_XDECREF(rval);
+    return NULL;
+}
+
+static PyObject *
+_parse_array_bytes(PyScannerObject *s, PyObject *pystr, const char *input,
+                   Py_ssize_t length, Py_ssize_t idx, Py_ssize_t *next_idx_ptr)
+{
+    /* Read a JSON array from the UTF-8 encoded buffer input.
+    idx is the index of the first byte after the opening brace.
+    *next_idx_ptr is a return-by-reference index to the first byte after
+        the closing brace.
+
+    Returns a new PyList
+    */
+    const unsigned char *str = (const unsigned char *)input;
+    Py_ssize_t end_idx = length - 1;
+    PyObject *val = NULL;
+    PyObject *rval;
+    Py_ssize_t next_idx;
+
+    rval = PyList_New(0);
+    if (rval == NULL)
+        return NULL;
+
+    /* skip whitespace after [ */
+    while (idx <= end_idx && IS_WHITESPACE(str[idx])) idx++;
+
+    /* only loop if the array is non-empty */
+    if (idx > end_idx || str[idx] != ']') {
+        while (1) {
+
+            /* read any JSON term  */
+            val = scan_once_bytes(s, pystr, input, length, idx, &next_idx);
+            if (val == NULL)
+                goto bail;
+
+            if (PyList_Append(rval, val) == -1)
+                goto bail;
+
+            Py_CLEAR(val);
+            idx = next_idx;
+
+            /* skip whitespace between term and , */
+            while (idx <= end_idx && IS_WHITESPACE(str[idx])) idx++;
+
+            /* bail if the array is closed or we didn't get the , delimiter */
+            if (idx <= end_idx && str[idx] == ']')
+                break;
+            if (idx > end_idx || str[idx] != ',') {
+                raise_errmsg("Expecting ',' delimiter", pystr, idx);
+                goto bail;
+            }
+            idx++;
+
+            /* skip whitespace after , */
+            while (idx <= end_idx && IS_WHITESPACE(str[idx])) idx++;
+        }
+    }
+
+    /* verify that idx < end_idx, str[idx] should be ']' */
+    if (idx > end_idx || str[idx] != ']') {
+        raise_errmsg("Expecting value", pystr, end_idx);
+        goto bail;
+    }
+    *next_idx_ptr = idx + 1;
+    return rval;
+bail:
+    Py_XDECREF(val);
+    Py_DECREF(rval);
+    return NULL;
+}
+
+static PyObject *
+_match_number_bytes(PyScannerObject *s, const char *input, Py_ssize_t length,
+                    Py_ssize_t start, Py_ssize_t *next_idx_ptr)
+{
+    /* Read a JSON number from the UTF-8 encoded buffer input.
+    idx is the index of the first byte of the number
+    *next_idx_ptr is a return-by-reference index to the first byte after
+        the number.
+
+    Returns a new PyObject representation of that number:
+        PyLong, or PyFloat.
+        May return other types if parse_int or parse_float are set
+    */
+    const unsigned char *str = (const unsigned char *)input;
+    Py_ssize_t end_idx = length - 1;
+    Py_ssize_t idx = start;
+    int is_float = 0;
+    PyObject *rval;
+    PyObject *numstr = NULL;
+    PyObject *custom_func;
+
+    /* read a sign if it's there, make sure it's not the end of the string */
+    if (str[idx] == '-') {
+        idx++;
+        if (idx > end_idx) {
+            raise_stop_iteration(start);
+            return NULL;
+        }
+    }
+
+    /* read as many integer digits as we find as long as it doesn't start with 0 */
+    if (str[idx] >= '1' && str[idx] <= '9') {
+        idx++;
+        while (idx <= end_idx && str[idx] >= '0' && str[idx] <= '9') idx++;
+    }
+    /* if it starts with 0 we only expect one integer digit */
+    else if (str[idx] == '0') {
+        idx++;
+    }
+    /* no integer digits, error */
+    else {
+        raise_stop_iteration(start);
+        return NULL;
+    }
+
+    /* if the next char is '.' followed by a digit then read all float digits */
+    if (idx < end_idx && str[idx] == '.' && str[idx + 1] >= '0' && str[idx + 1] <= '9') {
+        is_float = 1;
+        idx += 2;
+        while (idx <= end_idx && str[idx] >= '0' && str[idx] <= '9') idx++;
+    }
+
+    /* if the next char is 'e' or 'E' then maybe read the exponent (or backtrack) */
+    if (idx < end_idx && (str[idx] == 'e' || str[idx] == 'E')) {
+        Py_ssize_t e_start = idx;
+        idx++;
+
+        /* read an exponent sign if present */
+        if (idx < end_idx && (str[idx] == '-' || str[idx] == '+')) idx++;
+
+        /* read all digits */
+        while (idx <= end_idx && str[idx] >= '0' && str[idx] <= '9') idx++;
+
+        /* if we got a digit, then parse as float. if not, backtrack */
+        if (str[idx - 1] >= '0' && str[idx - 1] <= '9') {
+            is_float = 1;
+        }
+        else {
+            idx = e_start;
+        }
+    }
+
+    if (is_float && s->parse_float != (PyObject *)&PyFloat_Type)
+        custom_func = s->parse_float;
+    else if (!is_float && s->parse_int != (PyObject *) &PyLong_Type)
+        custom_func = s->parse_int;
+    else
+        custom_func = NULL;
+
+    if (custom_func) {
+        /* copy the section we determined to be a number */
+        numstr = PyUnicode_DecodeASCII(input + start, idx - start, NULL);
+        if (numstr == NULL)
+            return NULL;
+        rval = PyObject_CallOneArg(custom_func, numstr);
+    }
+    else {
+        /* The buffer is not necessarily NUL terminated */
+        numstr = PyBytes_FromStringAndSize(input + start, idx - start);
+        if (numstr == NULL)
+            return NULL;
+        if (is_float)
+            rval = PyFloat_FromString(numstr);
+        else
+            rval = PyLong_FromString(PyBytes_AS_STRING(numstr), NULL, 10);
+    }
+    Py_DECREF(numstr);
+    *next_idx_ptr = idx;
+    return rval;
+}
+
+static PyObject *
+scan_once_bytes(PyScannerObject *s, PyObject *pystr, const char *input,
+                Py_ssize_t length, Py_ssize_t idx, Py_ssize_t *next_idx_ptr)
+{
+    /* Read one JSON term (of any kind) from the UTF-8 encoded buffer input
+    of length bytes, exported by pystr.
+    idx is the index of the first byte of the term
+    *next_idx_ptr is a return-by-reference index to the first byte after
+        the term.
+
+    Returns a new PyObject representation of the term.
+    */
+    const unsigned char *str = (const unsigned char *)input;
+    PyObject *res;
+
+    if (idx < 0) {
+        PyErr_SetString(PyExc_ValueError, "idx cannot be negative");
+        return NULL;
+    }
+    if (idx >= length) {
+        raise_stop_iteration(idx);
+        return NULL;
+    }
+
+    switch (str[idx]) {
+        case '"':
+            /* string */
+            return scanstring_bytes(pystr, input, length, idx + 1, s->strict,
+                                    next_idx_ptr);
+        case '{':
+            /* object */
+            if (Py_EnterRecursiveCall(" while decoding a JSON object "
+                                      "from a bytes-like object"))
+                return NULL;
+            res = _parse_object_bytes(s, pystr, input, length, idx + 1,
+                                      next_idx_ptr);
+            Py_LeaveRecursiveCall();
+            return res;
+        case '[':
+            /* array */
+            if (Py_EnterRecursiveCall(" while decoding a JSON array "
+                                      "from a bytes-like object"))
+                return NULL;
+            res = _parse_array_bytes(s, pystr, input, length, idx + 1,
+                                     next_idx_ptr);
+            Py_LeaveRecursiveCall();
+            return res;
+        case 'n':
+            /* null */
+            if ((idx + 3 < length) && memcmp(str + idx, "null", 4) == 0) {
+                *next_idx_ptr = idx + 4;
+                Py_RETURN_NONE;
+            }
+            break;
+        case 't':
+            /* true */
+            if ((idx + 3 < length) && memcmp(str + idx, "true", 4) == 0) {
+                *next_idx_ptr = idx + 4;
+                Py_RETURN_TRUE;
+            }
+            break;
+        case 'f':
+            /* false */
+            if ((idx + 4 < length) && memcmp(str + idx, "false", 5) == 0) {
+                *next_idx_ptr = idx + 5;
+                Py_RETURN_FALSE;
+            }
+            break;
+        case 'N':
+            /* NaN */
+            if ((idx + 2 < length) && memcmp(str + idx, "NaN", 3) == 0) {
+                return _parse_constant(s, "NaN", idx, next_idx_ptr);
+            }
+            break;
+        case 'I':
+            /* Infinity */
+            if ((idx + 7 < length) && memcmp(str + idx, "Infinity", 8) == 0) {
+                return _parse_constant(s, "Infinity", idx, next_idx_ptr);
+            }
+            break;
+        case '-':
+            /* -Infinity */
+            if ((idx + 8 < length) && memcmp(str + idx, "-Infinity", 9) == 0) {
+                return _parse_constant(s, "-Infinity", idx, next_idx_ptr);
+            }
+            break;
+    }
+    /* Didn't find a string, object, array, or named constant. Look for a number. */
+    return _match_number_bytes(s, input, length, idx, next_idx_ptr);
+}
+
+static PyObject *
+scanner_call(PyScannerObject *self, PyObject *args, PyObject *kwds)
+{
+    /* Python callable interface to scan_once_{str,unicode} */
+    PyObject *pystr;
+    PyObject *rval;
+    Py_ssize_t idx;
+    Py_ssize_t next_idx = -1;
+    static char *kwlist[] = {"string", "idx", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "On:scan_once", kwlist, &pystr, &idx))
+        return NULL;
+
+    if (PyUnicode_Check(pystr)) {
+        rval = scan_once_unicode(self, pystr, idx, &next_idx);
+    }
+    else if (PyObject_CheckBuffer(pystr)) {
+        Py_buffer view;
+        if (PyObject_GetBuffer(pystr, &view, PyBUF_SIMPLE) < 0) {
+            return NULL;
+        }
+        rval = scan_once_bytes(self, pystr, view.buf, view.len, idx, &next_idx);
+        PyBuffer_Release(&view);
+    }
+    else {
+        PyErr_Format(PyExc_TypeError,
+                 "first argument must be a string or a bytes-like object, "
+                 "not %.80s",
+                 Py_TYPE(pystr)->tp_name);
+        return NULL;
+    }
+    PyDict_Clear(self->memo);
+    if (rval == NULL)
+        return NULL;
+    return _build_rval_index_tuple(rval, next_idx);
+}
+
+static PyObject *
+scanner_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    PyScannerObject *s;
+    PyObject *ctx;
+    PyObject *strict;
+    PyObject *presize_dicts;
+    static char *kwlist[] = {"context", NULL};
+    _Py_IDENTIFIER(presize_dicts);
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O:make_scanner", kwlist, &ctx))
+        return NULL;
+
+    s = (PyScannerObject *)type->tp_alloc(type, 0);
+    if (s == NULL) {
+        return NULL;
+    }
+
+    s->memo = PyDict_New();
+    if (s->memo == NULL)
+        goto bail;
+
+    /* All of these will fail "gracefully" so we don't need to verify them */
+    strict = PyObject_GetAttrString(ctx, "strict");
+    if (strict == NULL)
+        goto bail;
+    s->strict = PyObject_IsTrue(strict);
+    Py_DECREF(strict);
+    if (s->strict < 0)
+        goto bail;
+    s->object_hook = PyObject_GetAttrString(ctx, "object_hook");
+    if (s->object_hook == NULL)
+        goto bail;
+    s->object_pairs_hook = PyObject_GetAttrString(ctx, "object_pairs_hook");
+    if (s->object_pairs_hook == NULL)
+        goto bail;
+    s->parse_float = PyObject_GetAttrString(ctx, "parse_float");
+    if (s->parse_float == NULL)
+        goto bail;
+    s->parse_int = PyObject_GetAttrString(ctx, "parse_int");
+    if (s->parse_int == NULL)
+        goto bail;
+    s->parse_constant = PyObject_GetAttrString(ctx, "parse_constant");
+    if (s->parse_constant == NULL)
+        goto bail;
+    /* Optional, for the contexts that predate it */
+    if (_PyObject_LookupAttrId(ctx, &PyId_presize_dicts, &presize_dicts) < 0)
+        goto bail;
+    if (presize_dicts != NULL) {
+        s->presize_dicts = PyObject_IsTrue(presize_dicts);
+        Py_DECREF(presize_dicts);
+        if (s->presize_dicts < 0)
+            goto bail;
+    }
+
+    return (PyObject *)s;
+
+bail:
     Py_DECREF(s);
     return NULL;
 }
@@ -1286,20 +2355,34 @@ static PyObject *
 encoder_call(PyEncoderObject *self, PyObject *args, PyObject *kwds)
 {
     /* Python callable interface to encode_listencode_obj */
-    static char *kwlist[] = {"obj", "_current_indent_level", NULL};
-    PyObject *obj;
+    static char *kwlist[] = {"obj", "_current_indent_level", "write", "utf8", NULL};
+    PyObject *obj, *result;
+    PyObject *write = Py_None;
     Py_ssize_t indent_level;
-    _PyAccu acc;
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "On:_iterencode", kwlist,
-        &obj, &indent_level))
+    int utf8 = 0;
+    _PyEncoderOutput out;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "On|Op:_iterencode", kwlist,
+        &obj, &indent_level, &write, &utf8))
         return NULL;
-    if (_PyAccu_Init(&acc))
-        return NULL;
-    if (encoder_listencode_obj(self, &acc, obj, indent_level)) {
-        _PyAccu_Destroy(&acc);
+    _PyUnicodeWriter_Init(&out.writer);
+    out.writer.overallocate = 1;
+    out.write = (write != Py_None) ? write : NULL;
+    out.utf8 = utf8;
+    if (encoder_listencode_obj(self, &out, obj, indent_level) ||
+            encoder_flush(&out, 1)) {
+        _PyUnicodeWriter_Dealloc(&out.writer);
         return NULL;
     }
-    return _PyAccu_FinishAsList(&acc);
+    if (out.write != NULL) {
+        Py_RETURN_NONE;
+    }
+    result = _PyUnicodeWriter_Finish(&out.writer);
+    if (result == NULL)
+        return NULL;
+    /* The result is a sequence of chunks, like the one of
+       JSONEncoder.iterencode(). */
+    Py_SETREF(result, PyTuple_Pack(1, result));
+    return result;
 }
 
 static PyObject *
@@ -1383,58 +2466,122 @@ encoder_encode_string(PyEncoderObject *s, PyObject *obj)
 }
 
 static int
-_steal_accumulate(_PyAccu *acc, PyObject *stolen)
+encoder_flush(_PyEncoderOutput *out, int force)
+{
+    /* Pass the output to the write() callable, if any, once it is long
+       enough or at the end of the encoding (force) */
+    PyObject *chunk, *res;
+
+    if (out->write == NULL || out->writer.pos == 0 ||
+            (!force && out->writer.pos < ENCODER_CHUNK_SIZE))
+        return 0;
+    chunk = _PyUnicodeWriter_Finish(&out->writer);
+    _PyUnicodeWriter_Init(&out->writer);
+    out->writer.overallocate = 1;
+    if (chunk == NULL)
+        return -1;
+    if (out->utf8) {
+        /* Lone surrogates round-trip like with json.loads() */
+        Py_SETREF(chunk, _PyUnicode_AsUTF8String(chunk, "surrogatepass"));
+        if (chunk == NULL)
+            return -1;
+    }
+    res = PyObject_CallOneArg(out->write, chunk);
+    Py_DECREF(chunk);
+    if (res == NULL)
+        return -1;
+    Py_DECREF(res);
+    return 0;
+}
+
+static int
+encoder_write_string(PyEncoderObject *s, _PyEncoderOutput *out, PyObject *obj)
+{
+    /* Write the JSON representation of a string.  Strings with no character
+       to escape, the common case, are copied as they are. */
+    PyObject *encoded;
+    int rv;
+
+    if (s->fast_encode && PyUnicode_IS_READY(obj) &&
+            PyUnicode_KIND(obj) == PyUnicode_1BYTE_KIND) {
+        const Py_UCS1 *data = PyUnicode_1BYTE_DATA(obj);
+        Py_ssize_t len = PyUnicode_GET_LENGTH(obj);
+        int plain;
+        if (s->fast_encode == (PyCFunction)py_encode_basestring_ascii) {
+            /* Also escapes DEL and non-ASCII characters */
+            plain = PyUnicode_IS_ASCII(obj) &&
+                    find_string_special(data, 0, len) == len &&
+                    memchr(data, 0x7f, len) == NULL;
+        }
+        else {
+            plain = find_string_special(data, 0, len) == len;
+        }
+        if (plain) {
+            if (_PyUnicodeWriter_WriteChar(&out->writer, '"') < 0 ||
+                    _PyUnicodeWriter_WriteStr(&out->writer, obj) < 0 ||
+                    _PyUnicodeWriter_WriteChar(&out->writer, '"') < 0)
+                return -1;
+            return 0;
+        }
+    }
+    encoded = encoder_encode_string(s, obj);
+    if (encoded == NULL)
+        return -1;
+    rv = _PyUnicodeWriter_WriteStr(&out->writer, encoded);
+    Py_DECREF(encoded);
+    return rv;
+}
+
+static int
+encoder_write_steal(_PyEncoderOutput *out, PyObject *stolen)
 {
-    /* Append stolen and then decrement its reference count */
-    int rval = _PyAccu_Accumulate(acc, stolen);
+    /* Write stolen and then decrement its reference count */
+    int rval = _PyUnicodeWriter_WriteStr(&out->writer, stolen);
     Py_DECREF(stolen);
     return rval;
 }
 
 static int
-encoder_listencode_obj(PyEncoderObject *s, _PyAccu *acc,
+encoder_listencode_obj(PyEncoderObject *s, _PyEncoderOutput *out,
                        PyObject *obj, Py_ssize_t indent_level)
 {
     /* Encode Python object obj to a JSON term */
     PyObject *newobj;
     int rv;
 
-    if (obj == Py_None || obj == Py_True || obj == Py_False) {
-        PyObject *cstr = _encoded_const(obj);
-        if (cstr == NULL)
-            return -1;
-        return _steal_accumulate(acc, cstr);
+    if (obj == Py_None) {
+        return _PyUnicodeWriter_WriteASCIIString(&out->writer, "null", 4);
+    }
+    else if (obj == Py_True) {
+        return _PyUnicodeWriter_WriteASCIIString(&out->writer, "true", 4);
+    }
+    else if (obj == Py_False) {
+        return _PyUnicodeWriter_WriteASCIIString(&out->writer, "false", 5);
     }
     else if (PyUnicode_Check(obj))
     {
-        PyObject *encoded = encoder_encode_string(s, obj);
-        if (encoded == NULL)
-            return -1;
-        return _steal_accumulate(acc, encoded);
+        return encoder_write_string(s, out, obj);
     }
     else if (PyLong_Check(obj)) {
-        PyObject *encoded = PyLong_Type.tp_repr(obj);
-        if (encoded == NULL)
-            return -1;
-        return _steal_accumulate(acc, encoded);
+        return _PyLong_FormatWriter(&out->writer, obj, 10, 0);
     }
     else if (PyFloat_Check(obj)) {
         PyObject *encoded = encoder_encode_float(s, obj);
         if (encoded == NULL)
             return -1;
-        return _steal_accumulate(acc, encoded);
+        return encoder_write_steal(out, encoded);
     }
     else if (PyList_Check(obj) || PyTuple_Check(obj)) {
         if (Py_EnterRecursiveCall(" while encoding a JSON object"))
             return -1;
-        rv = encoder_listencode_list(s, acc, obj, indent_level);
+        rv = encoder_listencode_list(s, out, obj, indent_level);
         Py_LeaveRecursiveCall();
         return rv;
     }
     else if (PyDict_Check(obj)) {
         if (Py_EnterRecursiveCall(" while encoding a JSON object"))
             return -1;
-        rv = encoder_listencode_dict(s, acc, obj, indent_level);
+        rv = encoder_listencode_dict(s, out, obj, indent_level);
         Py_LeaveRecursiveCall();
         return rv;
     }
@@ -1468,7 +2615,7 @@ encoder_listencode_obj(PyEncoderObject *s, _PyAccu *acc,
             Py_XDECREF(ident);
             return -1;
         }
-        rv = encoder_listencode_obj(s, acc, newobj, indent_level);
+        rv = encoder_listencode_obj(s, out, newobj, indent_level);
         Py_LeaveRecursiveCall();
 
         Py_DECREF(newobj);
@@ -1488,29 +2635,20 @@ encoder_listencode_obj(PyEncoderObject *s, _PyAccu *acc,
 }
 
 static int
-encoder_listencode_dict(PyEncoderObject *s, _PyAccu *acc,
+encoder_listencode_dict(PyEncoderObject *s, _PyEncoderOutput *out,
                         PyObject *dct, Py_ssize_t indent_level)
 {
     /* Encode Python dict dct a JSON term */
-    static PyObject *open_dict = NULL;
-    static PyObject *close_dict = NULL;
-    static PyObject *empty_dict = NULL;
     PyObject *kstr = NULL;
     PyObject *ident = NULL;
     PyObject *it = NULL;
     PyObject *items;
     PyObject *item = NULL;
     Py_ssize_t idx;
+    int rv;
 
-    if (open_dict == NULL || close_dict == NULL || empty_dict == NULL) {
-        open_dict = PyUnicode_InternFromString("{");
-        close_dict = PyUnicode_InternFromString("}");
-        empty_dict = PyUnicode_InternFromString("{}");
-        if (open_dict == NULL || close_dict == NULL || empty_dict == NULL)
-            return -1;
-    }
     if (PyDict_GET_SIZE(dct) == 0)  /* Fast path */
-        return _PyAccu_Accumulate(acc, empty_dict);
+        return _PyUnicodeWriter_WriteASCIIString(&out->writer, "{}", 2);
 
     if (s->markers != Py_None) {
         int has_key;
@@ -1528,7 +2666,7 @@ encoder_listencode_dict(PyEncoderObject *s, _PyAccu *acc,
         }
     }
 
-    if (_PyAccu_Accumulate(acc, open_dict))
+    if (_PyUnicodeWriter_WriteChar(&out->writer, '{'))
         goto bail;
 
     if (s->indent != Py_None) {
@@ -1554,7 +2692,7 @@ encoder_listencode_dict(PyEncoderObject *s, _PyAccu *acc,
         goto bail;
     idx = 0;
     while ((item = PyIter_Next(it)) != NULL) {
-        PyObject *encoded, *key, *value;
+        PyObject *key, *value;
         if (!PyTuple_Check(item) || PyTuple_GET_SIZE(item) != 2) {
             PyErr_SetString(PyExc_ValueError, "items must return 2-tuples");
             goto bail;
@@ -1594,24 +2732,20 @@ encoder_listencode_dict(PyEncoderObject *s, _PyAccu *acc,
         }
 
         if (idx) {
-            if (_PyAccu_Accumulate(acc, s->item_separator))
+            if (_PyUnicodeWriter_WriteStr(&out->writer, s->item_separator))
                 goto bail;
         }
 
-        encoded = encoder_encode_string(s, kstr);
+        rv = encoder_write_string(s, out, kstr);
         Py_CLEAR(kstr);
-        if (encoded == NULL)
+        if (rv)
             goto bail;
-        if (_PyAccu_Accumulate(acc, encoded)) {
-            Py_DECREF(encoded);
-            goto bail;
-        }
-        Py_DECREF(encoded);
-        if (_PyAccu_Accumulate(acc, s->key_separator))
+        if (_PyUnicodeWriter_WriteStr(&out->writer, s->key_separator))
             goto bail;
 
         value = PyTuple_GET_ITEM(item, 1);
-        if (encoder_listencode_obj(s, acc, value, indent_level))
+        if (encoder_listencode_obj(s, out, value, indent_level) ||
+                encoder_flush(out, 0))
             goto bail;
         idx += 1;
         Py_DECREF(item);
@@ -1631,7 +2765,7 @@ encoder_listencode_dict(PyEncoderObject *s, _PyAccu *acc,
 
         yield '\n' + (' ' * (_indent * _current_indent_level))
     }*/
-    if (_PyAccu_Accumulate(acc, close_dict))
+    if (_PyUnicodeWriter_WriteChar(&out->writer, '}'))
         goto bail;
     return 0;
 
@@ -1645,31 +2779,21 @@ bail:
 
 
 static int
-encoder_listencode_list(PyEncoderObject *s, _PyAccu *acc,
+encoder_listencode_list(PyEncoderObject *s, _PyEncoderOutput *out,
                         PyObject *seq, Py_ssize_t indent_level)
 {
     /* Encode Python list seq to a JSON term */
-    static PyObject *open_array = NULL;
-    static PyObject *close_array = NULL;
-    static PyObject *empty_array = NULL;
     PyObject *ident = NULL;
     PyObject *s_fast = NULL;
     Py_ssize_t i;
 
-    if (open_array == NULL || close_array == NULL || empty_array == NULL) {
-        open_array = PyUnicode_InternFromString("[");
-        close_array = PyUnicode_InternFromString("]");
-        empty_array = PyUnicode_InternFromString("[]");
-        if (open_array == NULL || close_array == NULL || empty_array == NULL)
-            return -1;
-    }
     ident = NULL;
     s_fast = PySequence_Fast(seq, "_iterencode_list needs a sequence");
     if (s_fast == NULL)
         return -1;
     if (PySequence_Fast_GET_SIZE(s_fast) == 0) {
         Py_DECREF(s_fast);
-        return _PyAccu_Accumulate(acc, empty_array);
+        return _PyUnicodeWriter_WriteASCIIString(&out->writer, "[]", 2);
     }
 
     if (s->markers != Py_None) {
@@ -1688,7 +2812,7 @@ encoder_listencode_list(PyEncoderObject *s, _PyAccu *acc,
         }
     }
 
-    if (_PyAccu_Accumulate(acc, open_array))
+    if (_PyUnicodeWriter_WriteChar(&out->writer, '['))
         goto bail;
     if (s->indent != Py_None) {
         /* TODO: DOES NOT RUN */
@@ -1702,10 +2826,11 @@ encoder_listencode_list(PyEncoderObject *s, _PyAccu *acc,
     for (i = 0; i < PySequence_Fast_GET_SIZE(s_fast); i++) {
         PyObject *obj = PySequence_Fast_GET_ITEM(s_fast, i);
         if (i) {
-            if (_PyAccu_Accumulate(acc, s->item_separator))
+            if (_PyUnicodeWriter_WriteStr(&out->writer, s->item_separator))
                 goto bail;
         }
-        if (encoder_listencode_obj(s, acc, obj, indent_level))
+        if (encoder_listencode_obj(s, out, obj, indent_level) ||
+                encoder_flush(out, 0))
             goto bail;
     }
     if (ident != NULL) {
@@ -1720,7 +2845,7 @@ encoder_listencode_list(PyEncoderObject *s, _PyAccu *acc,
 
         yield '\n' + (' ' * (_indent * _current_indent_level))
     }*/
-    if (_PyAccu_Accumulate(acc, close_array))
+    if (_PyUnicodeWriter_WriteChar(&out->writer, ']'))
         goto bail;
     Py_DECREF(s_fast);
     return 0;
@@ -1801,6 +2926,10 @@ static PyMethodDef speedups_methods[] = {
         (PyCFunction)py_scanstring,
         METH_VARARGS,
         pydoc_scanstring},
+    {"find_value_end",
+        (PyCFunction)py_find_value_end,
+        METH_VARARGS,
+        pydoc_find_value_end},
     {NULL, NULL, 0, NULL}
 };
 
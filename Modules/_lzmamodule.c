@@ -587,12 +587,43 @@ _lzma_LZMACompressor_flush_impl(Compressor *self)
     return result;
 }
 
+/* The multithreaded encoder was added in liblzma 5.2.0 */
+#if LZMA_VERSION >= 50020002
+#  define HAVE_LZMA_MT
+#endif
+
 static int
 Compressor_init_xz(lzma_stream *lzs, int check, uint32_t preset,
-                   PyObject *filterspecs)
+                   PyObject *filterspecs, int threads)
 {
     lzma_ret lzret;
 
+#ifdef HAVE_LZMA_MT
+    if (threads == 0)
+        threads = (int)Py_MIN(lzma_cputhreads(), INT_MAX);
+    if (threads > 1) {
+        lzma_mt mt;
+        lzma_filter filters[LZMA_FILTERS_MAX + 1];
+
+        memset(&mt, 0, sizeof(mt));
+        mt.threads = (uint32_t)threads;
+        mt.check = check;
+        if (filterspecs == Py_None) {
+            mt.preset = preset;
+            lzret = lzma_stream_encoder_mt(lzs, &mt);
+        } else {
+            if (parse_filter_chain_spec(filters, filterspecs) == -1)
+                return -1;
+            mt.filters = filters;
+            lzret = lzma_stream_encoder_mt(lzs, &mt);
+            free_filter_chain(filters);
+        }
+        if (catch_lzma_error(lzret))
+            return -1;
+        else
+            return 0;
+    }
+#endif
     if (filterspecs == Py_None) {
         lzret = lzma_easy_encoder(lzs, preset, check);
     } else {
@@ -686,6 +717,11 @@ _lzma.LZMACompressor.__init__
         have an entry for "id" indicating the ID of the filter, plus
         additional entries for options to the filter.
 
+    *
+    threads: int = 1
+        The number of threads used to compress the data, 0 meaning
+        the number of CPUs.  Only supported by FORMAT_XZ.
+
 Create a compressor object for compressing data incrementally.
 
 The settings used by the compressor can be specified either as a
@@ -700,18 +736,31 @@ For one-shot compression, use the compress() function instead.
 static int
 Compressor_init(Compressor *self, PyObject *args, PyObject *kwargs)
 {
-    static char *arg_names[] = {"format", "check", "preset", "filters", NULL};
+    static char *arg_names[] = {"format", "check", "preset", "filters",
+                                "threads", NULL};
     int format = FORMAT_XZ;
     int check = -1;
     uint32_t preset = LZMA_PRESET_DEFAULT;
     PyObject *preset_obj = Py_None;
     PyObject *filterspecs = Py_None;
+    int threads = 1;
 
     if (!PyArg_ParseTupleAndKeywords(args, kwargs,
-                                     "|iiOO:LZMACompressor", arg_names,
+                                     "|iiOO$i:LZMACompressor", arg_names,
                                      &format, &check, &preset_obj,
-                                     &filterspecs))
+                                     &filterspecs, &threads))
+        return -1;
+
+    if (threads < 0) {
+        PyErr_SetString(PyExc_ValueError, "threads must not be negative");
         return -1;
+    }
+    if (format != FORMAT_XZ && threads != 1) {
+        PyErr_SetString(PyExc_ValueError,
+                        "Multithreaded compression is only supported by "
+                        "FORMAT_XZ");
+        return -1;
+    }
 
     if (format != FORMAT_XZ && check != -1 && check != LZMA_CHECK_NONE) {
         PyErr_SetString(PyExc_ValueError,
@@ -745,7 +794,8 @@ Compressor_init(Compressor *self, PyObject *args, PyObject *kwargs)
         case FORMAT_XZ:
             if (check == -1)
                 check = LZMA_CHECK_CRC64;
-            if (Compressor_init_xz(&self->lzs, check, preset, filterspecs) != 0)
+            if (Compressor_init_xz(&self->lzs, check, preset, filterspecs,
+                                   threads) != 0)
                 break;
             return 0;
 
@@ -786,7 +836,8 @@ static PyMethodDef Compressor_methods[] = {
 };
 
 PyDoc_STRVAR(Compressor_doc,
-"LZMACompressor(format=FORMAT_XZ, check=-1, preset=None, filters=None)\n"
+"LZMACompressor(format=FORMAT_XZ, check=-1, preset=None, filters=None, *,\n"
+"               threads=1)\n"
 "\n"
 "Create a compressor object for compressing data incrementally.\n"
 "\n"
@@ -811,6 +862,9 @@ PyDoc_STRVAR(Compressor_doc,
 "have an entry for \"id\" indicating the ID of the filter, plus\n"
 "additional entries for options to the filter.\n"
 "\n"
+"threads specifies the number of threads used to compress the data, 0\n"
+"meaning the number of CPUs. Only FORMAT_XZ supports several threads.\n"
+"\n"
 "For one-shot compression, use the compress() function instead.\n");
 
 static PyTypeObject Compressor_type = {
@@ -109,7 +109,11 @@ enum opcode {
     /* Protocol 5 */
     BYTEARRAY8       = '\x96',
     NEXT_BUFFER      = '\x97',
-    READONLY_BUFFER  = '\x98'
+    READONLY_BUFFER  = '\x98',
+
+    /* Shapes, written by picklers created with shapes=True */
+    SHAPED_NEWOBJ    = '\x99',
+    SHAPED_BUILD     = '\x9a'
 };
 
 enum {
@@ -154,6 +158,11 @@ typedef struct {
     PyObject *extension_cache;
     /* copyreg._inverted_registry, {code: (module_name, function_name)} */
     PyObject *inverted_registry;
+    /* copyreg._bytearray_reconstructor, used for pickling bytearrays
+       out-of-band */
+    PyObject *bytearray_reconstructor;
+    /* copyreg._shape_slots, used for pickling instances as shapes */
+    PyObject *shape_slots;
 
     /* Import mappings for compatibility with Python 2.x */
 
@@ -204,6 +213,8 @@ _Pickle_ClearState(PickleState *st)
     Py_CLEAR(st->extension_registry);
     Py_CLEAR(st->extension_cache);
     Py_CLEAR(st->inverted_registry);
+    Py_CLEAR(st->bytearray_reconstructor);
+    Py_CLEAR(st->shape_slots);
     Py_CLEAR(st->name_mapping_2to3);
     Py_CLEAR(st->import_mapping_2to3);
     Py_CLEAR(st->name_mapping_3to2);
@@ -268,6 +279,13 @@ _Pickle_InitState(PickleState *st)
                      "not %.200s", Py_TYPE(st->extension_cache)->tp_name);
         goto error;
     }
+    st->bytearray_reconstructor =
+        PyObject_GetAttrString(copyreg, "_bytearray_reconstructor");
+    if (!st->bytearray_reconstructor)
+        goto error;
+    st->shape_slots = PyObject_GetAttrString(copyreg, "_shape_slots");
+    if (!st->shape_slots)
+        goto error;
     Py_CLEAR(copyreg);
 
     /* Load the 2.x -> 3.x stdlib module mapping tables */
@@ -651,6 +669,10 @@ typedef struct PicklerObject {
                                    the name of globals for Python 2.x. */
     PyObject *fast_memo;
     PyObject *buffer_callback;  /* Callback for out-of-band buffers, or NULL */
+    PyObject *shapes;           /* {type: slot names, or None for the
+                                   types whose instances are not saved as
+                                   shapes} and {shape: shape} for the shapes
+                                   saved, or NULL if shapes are not used */
 } PicklerObject;
 
 typedef struct UnpicklerObject {
@@ -1113,6 +1135,7 @@ _Pickler_New(void)
     self->pers_func = NULL;
     self->dispatch_table = NULL;
     self->buffer_callback = NULL;
+    self->shapes = NULL;
     self->write = NULL;
     self->proto = 0;
     self->bin = 0;
@@ -1202,6 +1225,23 @@ _Pickler_SetBufferCallback(PicklerObject *self, PyObject *buffer_callback)
     return 0;
 }
 
+static int
+_Pickler_SetShapes(PicklerObject *self, int shapes)
+{
+    if (!shapes) {
+        return 0;
+    }
+    if (self->proto < 2) {
+        PyErr_SetString(PyExc_ValueError, "shapes needs protocol >= 2");
+        return -1;
+    }
+    self->shapes = PyDict_New();
+    if (self->shapes == NULL) {
+        return -1;
+    }
+    return 0;
+}
+
 /* Returns the size of the input on success, -1 on failure. This takes its
    own reference to `input`. */
 static Py_ssize_t
@@ -2509,6 +2549,27 @@ save_bytearray(PicklerObject *self, PyObject *obj)
         Py_DECREF(reduce_value);
         return status;
     }
+    else if (self->buffer_callback != NULL && PyByteArray_GET_SIZE(obj) > 0) {
+        /* Offer the contents to the buffer callback in a PickleBuffer, to
+         * be pickled out-of-band.  The bytearray is rebuilt from the buffer
+         * given to the unpickler, without a copy if it is a bytearray. */
+        PickleState *st = _Pickle_GetGlobalState();
+        PyObject *reduce_value, *buffer;
+        int status;
+
+        buffer = PyPickleBuffer_FromObject(obj);
+        if (buffer == NULL)
+            return -1;
+        reduce_value = Py_BuildValue("(O(N))", st->bytearray_reconstructor,
+                                     buffer);
+        if (reduce_value == NULL)
+            return -1;
+
+        /* save_reduce() will memoize the object automatically. */
+        status = save_reduce(self, reduce_value, obj);
+        Py_DECREF(reduce_value);
+        return status;
+    }
     else {
         return _save_bytearray_data(self, obj, PyByteArray_AS_STRING(obj),
                                     PyByteArray_GET_SIZE(obj));
@@ -4255,6 +4316,135 @@ save_reduce(PicklerObject *self, PyObject *args, PyObject *obj)
     return 0;
 }
 
+/* Save obj as its shape, a (class, dict names, slot names) tuple shared by
+   the instances with the same attributes, followed by the values of the
+   attributes.  Returns -1 on error, 0 if obj cannot be saved this way and 1
+   if it was saved. */
+static int
+save_shaped(PicklerObject *self, PyObject *obj)
+{
+    PyObject *type = (PyObject *)Py_TYPE(obj);
+    PyObject *slots, *shape = NULL;
+    PyObject *dict = NULL, *values = NULL;
+    PyObject *names = NULL, *setslots = NULL;
+    PyObject *key, *value;
+    Py_ssize_t i, n, nslots, k, m;
+    int status = -1;
+    _Py_IDENTIFIER(__dict__);
+
+    const char shaped_newobj_op = SHAPED_NEWOBJ;
+    const char mark_op = MARK;
+    const char shaped_build_op = SHAPED_BUILD;
+
+    slots = PyDict_GetItemWithError(self->shapes, type);
+    if (slots == NULL) {
+        PickleState *st = _Pickle_GetGlobalState();
+
+        if (PyErr_Occurred())
+            return -1;
+        slots = PyObject_CallOneArg(st->shape_slots, obj);
+        if (slots == NULL)
+            return -1;
+        if (slots != Py_None && !PyTuple_Check(slots)) {
+            PyErr_SetString(PyExc_TypeError,
+                            "copyreg._shape_slots() must return a tuple "
+                            "or None");
+            Py_DECREF(slots);
+            return -1;
+        }
+        if (PyDict_SetItem(self->shapes, type, slots) < 0) {
+            Py_DECREF(slots);
+            return -1;
+        }
+        Py_DECREF(slots);
+    }
+    if (slots == Py_None)
+        return 0;
+    Py_INCREF(slots);
+
+    if (_PyObject_LookupAttrId(obj, &PyId___dict__, &dict) < 0)
+        goto error;
+    if (dict != NULL && !PyDict_CheckExact(dict)) {
+        status = 0;
+        goto error;
+    }
+    n = dict != NULL ? PyDict_GET_SIZE(dict) : 0;
+    nslots = PyTuple_GET_SIZE(slots);
+    values = PyTuple_New(n + nslots);
+    if (values == NULL)
+        goto error;
+
+    /* Collect the names and values of the dict, */
+    names = PyTuple_New(n);
+    if (names == NULL)
+        goto error;
+    i = 0;
+    k = 0;
+    while (dict != NULL && PyDict_Next(dict, &i, &key, &value)) {
+        if (!PyUnicode_CheckExact(key)) {
+            status = 0;
+            goto error;
+        }
+        Py_INCREF(key);
+        PyTuple_SET_ITEM(names, k, key);
+        Py_INCREF(value);
+        PyTuple_SET_ITEM(values, k, value);
+        k++;
+    }
+
+    /* then the names and values of the slots which are set. */
+    setslots = PyTuple_New(nslots);
+    if (setslots == NULL)
+        goto error;
+    m = 0;
+    for (i = 0; i < nslots; i++) {
+        PyObject *name = PyTuple_GET_ITEM(slots, i);
+
+        if (_PyObject_LookupAttr(obj, name, &value) < 0)
+            goto error;
+        if (value == NULL)
+            continue;
+        PyTuple_SET_ITEM(values, k + m, value);
+        Py_INCREF(name);
+        PyTuple_SET_ITEM(setslots, m, name);
+        m++;
+    }
+    if (m != nslots && _PyTuple_Resize(&setslots, m) < 0)
+        goto error;
+
+    /* Each distinct shape is saved once, and then fetched from the memo. */
+    shape = PyTuple_Pack(3, type, names, setslots);
+    if (shape == NULL)
+        goto error;
+    value = PyDict_SetDefault(self->shapes, shape, shape);
+    if (value == NULL)
+        goto error;
+    Py_INCREF(value);
+    Py_SETREF(shape, value);
+
+    if (save(self, shape, 0) < 0 ||
+        _Pickler_Write(self, &shaped_newobj_op, 1) < 0 ||
+        memo_put(self, obj) < 0 ||
+        _Pickler_Write(self, &mark_op, 1) < 0)
+        goto error;
+    for (i = 0; i < k + m; i++) {
+        if (save(self, PyTuple_GET_ITEM(values, i), 0) < 0)
+            goto error;
+    }
+    if (_Pickler_Write(self, &shaped_build_op, 1) < 0)
+        goto error;
+    status = 1;
+
+  error:
+    Py_DECREF(slots);
+    Py_XDECREF(shape);
+    Py_XDECREF(dict);
+    Py_XDECREF(values);
+    Py_XDECREF(names);
+    Py_XDECREF(setslots);
+    return status;
+}
+
 static int
 save(PicklerObject *self, PyObject *obj, int pers_save)
 {
@@ -4412,6 +4602,12 @@ save(PicklerObject *self, PyObject *obj, int pers_save)
         status = save_global(self, obj, NULL);
         goto done;
     }
+    else if (self->shapes != NULL &&
+             (status = save_shaped(self, obj)) != 0) {
+        if (status > 0)
+            status = 0;
+        goto done;
+    }
     else {
         _Py_IDENTIFIER(__reduce__);
         _Py_IDENTIFIER(__reduce_ex__);
@@ -4642,6 +4838,7 @@ Pickler_dealloc(PicklerObject *self)
     Py_XDECREF(self->fast_memo);
     Py_XDECREF(self->reducer_override);
     Py_XDECREF(self->buffer_callback);
+    Py_XDECREF(self->shapes);
 
     PyMemoTable_Del(self->memo);
 
@@ -4657,6 +4854,7 @@ Pickler_traverse(PicklerObject *self, visitproc visit, void *arg)
     Py_VISIT(self->fast_memo);
     Py_VISIT(self->reducer_override);
     Py_VISIT(self->buffer_callback);
+    Py_VISIT(self->shapes);
     return 0;
 }
 
@@ -4670,6 +4868,7 @@ Pickler_clear(PicklerObject *self)
     Py_CLEAR(self->fast_memo);
     Py_CLEAR(self->reducer_override);
     Py_CLEAR(self->buffer_callback);
+    Py_CLEAR(self->shapes);
 
     if (self->memo != NULL) {
         PyMemoTable *memo = self->memo;
@@ -4688,6 +4887,7 @@ _pickle.Pickler.__init__
   protocol: object = None
   fix_imports: bool = True
   buffer_callback: object = None
+  shapes: bool = False
 
 This takes a binary file for writing a pickle data stream.
 
@@ -4720,13 +4920,19 @@ buffer is serialized in-band, i.e. inside the pickle stream.
 It is an error if *buffer_callback* is not None and *protocol*
 is None or smaller than 5.
 
+If *shapes* is true, instances of classes pickled by the default
+__reduce_ex__() are saved as a reference to the names of their
+attributes, written once per class, and the attribute values.  Python
+3.9 and earlier cannot read these pickles.  It is an error if *shapes*
+is true and *protocol* is smaller than 2.
+
 [clinic start generated code]*/
 
 static int
 _pickle_Pickler___init___impl(PicklerObject *self, PyObject *file,
                               PyObject *protocol, int fix_imports,
-                              PyObject *buffer_callback)
-/*[clinic end generated code: output=0abedc50590d259b input=a7c969699bf5dad3]*/
+                              PyObject *buffer_callback, int shapes)
+/*[clinic end generated code: output=6ccea7534106bab2 input=04af56c01e7fcf58]*/
 {
     _Py_IDENTIFIER(persistent_id);
     _Py_IDENTIFIER(dispatch_table);
@@ -4744,6 +4950,9 @@ _pickle_Pickler___init___impl(PicklerObject *self, PyObject *file,
     if (_Pickler_SetBufferCallback(self, buffer_callback) < 0)
         return -1;
 
+    if (_Pickler_SetShapes(self, shapes) < 0)
+        return -1;
+
     /* memo and output_buffer may have already been created in _Pickler_New */
     if (self->memo == NULL) {
         self->memo = PyMemoTable_New();
@@ -5964,6 +6173,55 @@ load_newobj(UnpicklerObject *self)
     return -1;
 }
 
+/* Check that shape is a (class, dict names, slot names) tuple. */
+static int
+check_shape(PyObject *shape, const char *opname)
+{
+    if (!PyTuple_CheckExact(shape) || PyTuple_GET_SIZE(shape) != 3 ||
+        !PyType_Check(PyTuple_GET_ITEM(shape, 0)) ||
+        !PyTuple_CheckExact(PyTuple_GET_ITEM(shape, 1)) ||
+        !PyTuple_CheckExact(PyTuple_GET_ITEM(shape, 2))) {
+        PickleState *st = _Pickle_GetGlobalState();
+        PyErr_Format(st->UnpicklingError, "%s expected a shape, got %.200s",
+                     opname, Py_TYPE(shape)->tp_name);
+        return -1;
+    }
+    return 0;
+}
+
+static int
+load_shaped_newobj(UnpicklerObject *self)
+{
+    PyObject *shape, *args, *obj;
+    PyTypeObject *cls;
+
+    /* Stack is ... shape, and we want to push cls.__new__(cls) for the
+     * class of the shape, keeping the shape for SHAPED_BUILD.
+     */
+    if (Py_SIZE(self->stack) <= self->stack->fence)
+        return Pdata_stack_underflow(self->stack);
+    shape = self->stack->data[Py_SIZE(self->stack) - 1];
+    if (check_shape(shape, "SHAPED_NEWOBJ") < 0)
+        return -1;
+
+    cls = (PyTypeObject *)PyTuple_GET_ITEM(shape, 0);
+    if (cls->tp_new == NULL) {
+        PickleState *st = _Pickle_GetGlobalState();
+        PyErr_SetString(st->UnpicklingError, "SHAPED_NEWOBJ class "
+                        "has NULL tp_new");
+        return -1;
+    }
+    args = PyTuple_New(0);
+    if (args == NULL)
+        return -1;
+    obj = cls->tp_new(cls, args, NULL);
+    Py_DECREF(args);
+    if (obj == NULL)
+        return -1;
+    PDATA_PUSH(self->stack, obj, -1);
+    return 0;
+}
+
 static int
 load_newobj_ex(UnpicklerObject *self)
 {
@@ -6778,6 +7036,75 @@ load_build(UnpicklerObject *self)
     return status;
 }
 
+static int
+load_shaped_build(UnpicklerObject *self)
+{
+    PyObject *shape, *inst, *names, *slots;
+    PyObject *dict;
+    PyObject **values;
+    Py_ssize_t i, x, len, n, nslots;
+    _Py_IDENTIFIER(__dict__);
+
+    /* Stack is ... shape, instance, markobject, values.  We want to set the
+     * attributes named by the shape to the values and leave the instance at
+     * the stack top.
+     */
+    if ((x = marker(self)) < 0)
+        return -1;
+    len = Py_SIZE(self->stack);
+    if (x > len || x - 2 < self->stack->fence)
+        return Pdata_stack_underflow(self->stack);
+
+    shape = self->stack->data[x - 2];
+    inst = self->stack->data[x - 1];
+    if (check_shape(shape, "SHAPED_BUILD") < 0)
+        return -1;
+    names = PyTuple_GET_ITEM(shape, 1);
+    slots = PyTuple_GET_ITEM(shape, 2);
+    n = PyTuple_GET_SIZE(names);
+    nslots = PyTuple_GET_SIZE(slots);
+    if (len - x != n + nslots) {
+        PickleState *st = _Pickle_GetGlobalState();
+        PyErr_Format(st->UnpicklingError,
+                     "SHAPED_BUILD got %zd values for %zd attributes",
+                     len - x, n + nslots);
+        return -1;
+    }
+    values = self->stack->data + x;
+
+    if (n > 0) {
+        dict = _PyObject_GetAttrId(inst, &PyId___dict__);
+        if (dict == NULL)
+            return -1;
+        for (i = 0; i < n; i++) {
+            PyObject **name = &PyTuple_GET_ITEM(names, i);
+
+            /* Intern the names once for all the instances of the shape,
+               like the keys of the instance dicts normally are. */
+            if (PyUnicode_CheckExact(*name) &&
+                !PyUnicode_CHECK_INTERNED(*name))
+                PyUnicode_InternInPlace(name);
+            if (PyObject_SetItem(dict, *name, values[i]) < 0) {
+                Py_DECREF(dict);
+                return -1;
+            }
+        }
+        Py_DECREF(dict);
+    }
+    for (i = 0; i < nslots; i++) {
+        if (PyObject_SetAttr(inst, PyTuple_GET_ITEM(slots, i),
+                             values[n + i]) < 0)
+            return -1;
+    }
+
+    /* Pop the values and replace the shape with the instance. */
+    Pdata_clear(self->stack, x);
+    self->stack->data[x - 2] = inst;
+    Py_SET_SIZE(self->stack, x - 1);
+    Py_DECREF(shape);
+    return 0;
+}
+
 static int
 load_mark(UnpicklerObject *self)
 {
@@ -6922,6 +7249,8 @@ load(UnpicklerObject *self)
         OP(BYTEARRAY8, load_counted_bytearray)
         OP(NEXT_BUFFER, load_next_buffer)
         OP(READONLY_BUFFER, load_readonly_buffer)
+        OP(SHAPED_NEWOBJ, load_shaped_newobj)
+        OP(SHAPED_BUILD, load_shaped_build)
         OP_ARG(SHORT_BINSTRING, load_counted_binstring, 1)
         OP_ARG(BINSTRING, load_counted_binstring, 4)
         OP(STRING, load_string)
@@ -7676,6 +8005,7 @@ _pickle.dump
   *
   fix_imports: bool = True
   buffer_callback: object = None
+  shapes: bool = False
 
 Write a pickled representation of obj to the open file object file.
 
@@ -7704,13 +8034,18 @@ If *buffer_callback* is None (the default), buffer views are serialized
 into *file* as part of the pickle stream.  It is an error if
 *buffer_callback* is not None and *protocol* is None or smaller than 5.
 
+If *shapes* is true, instances of classes pickled by the default
+__reduce_ex__() are saved as a reference to the names of their
+attributes, written once per class, and the attribute values.  Python
+3.9 and earlier cannot read these pickles.
+
 [clinic start generated code]*/
 
 static PyObject *
 _pickle_dump_impl(PyObject *module, PyObject *obj, PyObject *file,
                   PyObject *protocol, int fix_imports,
-                  PyObject *buffer_callback)
-/*[clinic end generated code: output=706186dba996490c input=5ed6653da99cd97c]*/
+                  PyObject *buffer_callback, int shapes)
+/*[clinic end generated code: output=8a172a8693cd194d input=61952dedb4b93f91]*/
 {
     PicklerObject *pickler = _Pickler_New();
 
@@ -7726,6 +8061,9 @@ _pickle_dump_impl(PyObject *module, PyObject *obj, PyObject *file,
     if (_Pickler_SetBufferCallback(pickler, buffer_callback) < 0)
         goto error;
 
+    if (_Pickler_SetShapes(pickler, shapes) < 0)
+        goto error;
+
     if (dump(pickler, obj) < 0)
         goto error;
 
@@ -7749,6 +8087,7 @@ _pickle.dumps
   *
   fix_imports: bool = True
   buffer_callback: object = None
+  shapes: bool = False
 
 Return the pickled representation of the object as a bytes object.
 
@@ -7769,12 +8108,17 @@ If *buffer_callback* is None (the default), buffer views are serialized
 into *file* as part of the pickle stream.  It is an error if
 *buffer_callback* is not None and *protocol* is None or smaller than 5.
 
+If *shapes* is true, instances of classes pickled by the default
+__reduce_ex__() are saved as a reference to the names of their
+attributes, written once per class, and the attribute values.  Python
+3.9 and earlier cannot read these pickles.
+
 [clinic start generated code]*/
 
 static PyObject *
 _pickle_dumps_impl(PyObject *module, PyObject *obj, PyObject *protocol,
-                   int fix_imports, PyObject *buffer_callback)
-/*[clinic end generated code: output=fbab0093a5580fdf input=e543272436c6f987]*/
+                   int fix_imports, PyObject *buffer_callback, int shapes)
+/*[clinic end generated code: output=2ea34b101183f0cf input=b39d54382f468e61]*/
 {
     PyObject *result;
     PicklerObject *pickler = _Pickler_New();
@@ -7788,6 +8132,9 @@ _pickle_dumps_impl(PyObject *module, PyObject *obj, PyObject *protocol,
     if (_Pickler_SetBufferCallback(pickler, buffer_callback) < 0)
         goto error;
 
+    if (_Pickler_SetShapes(pickler, shapes) < 0)
+        goto error;
+
     if (dump(pickler, obj) < 0)
         goto error;
 
@@ -7960,6 +8307,8 @@ pickle_traverse(PyObject *m, visitproc visit, void *arg)
     Py_VISIT(st->extension_registry);
     Py_VISIT(st->extension_cache);
     Py_VISIT(st->inverted_registry);
+    Py_VISIT(st->bytearray_reconstructor);
+    Py_VISIT(st->shape_slots);
     Py_VISIT(st->name_mapping_2to3);
     Py_VISIT(st->import_mapping_2to3);
     Py_VISIT(st->name_mapping_3to2);
@@ -41,6 +41,7 @@ static const char copyright[] =
 #define PY_SSIZE_T_CLEAN
 
 #include "Python.h"
+#include "pycore_unicodeobject.h" // _PyUnicode_FindSubstring()
 #include "structmember.h"         // PyMemberDef
 
 #include "sre.h"
@@ -223,6 +224,11 @@ data_stack_grow(SRE_STATE* state, Py_ssize_t size)
     return 0;
 }
 
+/* the longest part of a required literal which search looks for */
+#define SRE_REQUIRED_MAX 64
+
+#include "sre_dfa.h"
+
 /* generate 8-bit version */
 
 #define SRE_CHAR Py_UCS1
@@ -452,6 +458,8 @@ state_init(SRE_STATE* state, PatternObject* pattern, PyObject* string,
     state->pos = start;
     state->endpos = end;
 
+    state->dfa = pattern->dfa;
+
     return string;
   err:
     PyMem_Del(state->mark);
@@ -550,12 +558,28 @@ pattern_dealloc(PatternObject* self)
     Py_XDECREF(self->pattern);
     Py_XDECREF(self->groupindex);
     Py_XDECREF(self->indexgroup);
+    dfa_free(self->dfa);
     PyObject_DEL(self);
 }
 
 LOCAL(Py_ssize_t)
 sre_match(SRE_STATE* state, SRE_CODE* pattern)
 {
+    if (state->dfa && !state->dfa->busy && state->start <= state->end) {
+        Py_ssize_t status;
+
+        /* A match started while the automaton is busy, by a signal handler
+           or by a thread it lets run, uses the backtracking engine. */
+        state->dfa->busy = 1;
+        if (state->charsize == 1)
+            status = sre_ucs1_dfa_match(state);
+        else if (state->charsize == 2)
+            status = sre_ucs2_dfa_match(state);
+        else
+            status = sre_ucs4_dfa_match(state);
+        state->dfa->busy = 0;
+        return status;
+    }
     if (state->charsize == 1)
         return sre_ucs1_match(state, pattern, 1);
     if (state->charsize == 2)
@@ -567,6 +591,22 @@ sre_match(SRE_STATE* state, SRE_CODE* pattern)
 LOCAL(Py_ssize_t)
 sre_search(SRE_STATE* state, SRE_CODE* pattern)
 {
+    if (state->dfa && !state->dfa->busy) {
+        Py_ssize_t status;
+
+        if (state->start > state->end)
+            return 0;
+        /* see sre_match() */
+        state->dfa->busy = 1;
+        if (state->charsize == 1)
+            status = sre_ucs1_dfa_search(state);
+        else if (state->charsize == 2)
+            status = sre_ucs2_dfa_search(state);
+        else
+            status = sre_ucs4_dfa_search(state);
+        state->dfa->busy = 0;
+        return status;
+    }
     if (state->charsize == 1)
         return sre_ucs1_search(state, pattern);
     if (state->charsize == 2)
@@ -1220,6 +1260,25 @@ _sre_SRE_Pattern___deepcopy__(PatternObject *self, PyObject *memo)
     return (PyObject *)self;
 }
 
+/*[clinic input]
+_sre.SRE_Pattern.__sizeof__
+
+Return the size of the pattern in memory, in bytes.
+
+This includes the automaton of a pattern compiled with the DFA flag.
+[clinic start generated code]*/
+
+static PyObject *
+_sre_SRE_Pattern___sizeof___impl(PatternObject *self)
+/*[clinic end generated code: output=4776389700db11f8 input=ed6ff954b038a901]*/
+{
+    Py_ssize_t res;
+
+    res = _PyObject_SIZE(Py_TYPE(self)) + Py_SIZE(self) * sizeof(SRE_CODE);
+    res += dfa_sizeof(self->dfa);
+    return PyLong_FromSsize_t(res);
+}
+
 static PyObject *
 pattern_repr(PatternObject *obj)
 {
@@ -1236,6 +1295,7 @@ pattern_repr(PatternObject *obj)
         {"re.VERBOSE", SRE_FLAG_VERBOSE},
         {"re.DEBUG", SRE_FLAG_DEBUG},
         {"re.ASCII", SRE_FLAG_ASCII},
+        {"re.DFA", SRE_FLAG_DFA},
     };
     PyObject *result = NULL;
     PyObject *flag_items;
@@ -1345,6 +1405,7 @@ _sre_compile_impl(PyObject *module, PyObject *pattern, int flags,
     self->pattern = NULL;
     self->groupindex = NULL;
     self->indexgroup = NULL;
+    self->dfa = NULL;
 
     self->codesize = n;
 
@@ -1402,6 +1463,14 @@ _sre_compile_impl(PyObject *module, PyObject *pattern, int flags,
         return NULL;
     }
 
+    if (flags & SRE_FLAG_DFA) {
+        self->dfa = dfa_new(self->code, self->codesize, groups);
+        if (!self->dfa) {
+            Py_DECREF(self);
+            return NULL;
+        }
+    }
+
     return (PyObject*) self;
 }
 
@@ -1645,8 +1714,8 @@ _validate_inner(SRE_CODE *code, SRE_CODE *end, Py_ssize_t groups)
             {
                 /* A minimal info field is
                    <INFO> <1=skip> <2=flags> <3=min> <4=max>;
-                   If SRE_INFO_PREFIX or SRE_INFO_CHARSET is in the flags,
-                   more follows. */
+                   If SRE_INFO_REQUIRED, SRE_INFO_PREFIX or SRE_INFO_CHARSET
+                   is in the flags, more follows. */
                 SRE_CODE flags, i;
                 SRE_CODE *newcode;
                 GET_SKIP;
@@ -1657,16 +1726,34 @@ _validate_inner(SRE_CODE *code, SRE_CODE *end, Py_ssize_t groups)
                 /* Check that only valid flags are present */
                 if ((flags & ~(SRE_INFO_PREFIX |
                                SRE_INFO_LITERAL |
-                               SRE_INFO_CHARSET)) != 0)
+                               SRE_INFO_CHARSET |
+                               SRE_INFO_REQUIRED)) != 0)
                     FAIL;
                 /* PREFIX and CHARSET are mutually exclusive */
                 if ((flags & SRE_INFO_PREFIX) &&
                     (flags & SRE_INFO_CHARSET))
                     FAIL;
+                /* PREFIX and REQUIRED are mutually exclusive */
+                if ((flags & SRE_INFO_PREFIX) &&
+                    (flags & SRE_INFO_REQUIRED))
+                    FAIL;
                 /* LITERAL implies PREFIX */
                 if ((flags & SRE_INFO_LITERAL) &&
                     !(flags & SRE_INFO_PREFIX))
                     FAIL;
+                /* Validate the required literal */
+                if (flags & SRE_INFO_REQUIRED) {
+                    SRE_CODE required_len;
+                    GET_ARG; required_len = arg;
+                    if (required_len == 0)
+                        FAIL;
+                    GET_ARG;
+                    GET_ARG;
+                    /* Here comes the literal */
+                    if (required_len > (uintptr_t)(newcode - code))
+                        FAIL;
+                    code += required_len;
+                }
                 /* Validate the prefix */
                 if (flags & SRE_INFO_PREFIX) {
                     SRE_CODE prefix_len;
@@ -2568,6 +2655,7 @@ static PyMethodDef pattern_methods[] = {
     _SRE_SRE_PATTERN_SCANNER_METHODDEF
     _SRE_SRE_PATTERN___COPY___METHODDEF
     _SRE_SRE_PATTERN___DEEPCOPY___METHODDEF
+    _SRE_SRE_PATTERN___SIZEOF___METHODDEF
     {"__class_getitem__", (PyCFunction)Py_GenericAlias, METH_O|METH_CLASS,
      PyDoc_STR("See PEP 585")},
     {NULL, NULL}
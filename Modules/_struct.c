@@ -1761,6 +1761,305 @@ Struct_iter_unpack(PyStructObject *self, PyObject *buffer)
 }
 
 
+/* Bulk unpacking and packing of many records, one field at a time. */
+
+/* How the values of a format are converted by the bulk loops below.  The
+   integer, double and bool formats are converted inline; the other formats
+   use the functions of their formatdef. */
+enum bulk_kind {
+    BULK_GENERIC,
+    BULK_SIGNED,        /* two's complement integer of e->size bytes */
+    BULK_UNSIGNED,      /* unsigned integer of e->size bytes */
+    BULK_DOUBLE,        /* C double */
+    BULK_STD_DOUBLE,    /* IEEE 754 double, converted by _PyFloat_*8() */
+    BULK_BOOL           /* standard bool, one byte */
+};
+
+static enum bulk_kind
+bulk_kind(const formatdef *e, int *swap, int *le)
+{
+    PyObject *(*u)(const char *, const formatdef *) = e->unpack;
+
+    *swap = 0;
+    *le = PY_LITTLE_ENDIAN;
+    if (u == lu_int || u == lu_uint || u == lu_longlong ||
+        u == lu_ulonglong || u == lu_double) {
+        *swap = !PY_LITTLE_ENDIAN;
+        *le = 1;
+    }
+    else if (u == bu_int || u == bu_uint || u == bu_longlong ||
+             u == bu_ulonglong || u == bu_double) {
+        *swap = PY_LITTLE_ENDIAN;
+        *le = 0;
+    }
+
+    if (u == nu_byte || u == nu_short || u == nu_int || u == nu_long ||
+        u == nu_ssize_t || u == nu_longlong ||
+        u == lu_int || u == lu_longlong || u == bu_int || u == bu_longlong) {
+        if (e->size == 1 || e->size == 2 || e->size == 4 || e->size == 8)
+            return BULK_SIGNED;
+    }
+    else if (u == nu_ubyte || u == nu_ushort || u == nu_uint ||
+             u == nu_ulong || u == nu_size_t || u == nu_ulonglong ||
+             u == lu_uint || u == lu_ulonglong ||
+             u == bu_uint || u == bu_ulonglong) {
+        if (e->size == 1 || e->size == 2 || e->size == 4 || e->size == 8)
+            return BULK_UNSIGNED;
+    }
+    else if (u == nu_double)
+        return BULK_DOUBLE;
+    else if (u == lu_double || u == bu_double)
+        return BULK_STD_DOUBLE;
+    else if (u == bu_bool)
+        return BULK_BOOL;
+    return BULK_GENERIC;
+}
+
+#define bulk_swap8(x) (x)
+
+static inline uint16_t
+bulk_swap16(uint16_t x)
+{
+    return (uint16_t)((x >> 8) | (x << 8));
+}
+
+static inline uint32_t
+bulk_swap32(uint32_t x)
+{
+    return ((x & 0x000000ffU) << 24) | ((x & 0x0000ff00U) << 8) |
+           ((x & 0x00ff0000U) >> 8) | ((x & 0xff000000U) >> 24);
+}
+
+static inline uint64_t
+bulk_swap64(uint64_t x)
+{
+    return ((uint64_t)bulk_swap32((uint32_t)x) << 32) |
+           bulk_swap32((uint32_t)(x >> 32));
+}
+
+/* Unpack the values of format e found at p, p + step, ... in n records
+   into a new list. */
+static PyObject *
+unpack_column(const formatdef *e, Py_ssize_t itemsize,
+              const char *p, Py_ssize_t step, Py_ssize_t n)
+{
+    PyObject *list, *v;
+    Py_ssize_t i;
+    int swap, le;
+
+    list = PyList_New(n);
+    if (list == NULL)
+        return NULL;
+
+#define UNPACK_INTS(UTYPE, TYPE, SWAP, CONVERT)                 \
+    for (i = 0; i < n; i++, p += step) {                        \
+        UTYPE x;                                                \
+        memcpy(&x, p, sizeof(x));                               \
+        if (swap)                                               \
+            x = SWAP(x);                                        \
+        v = CONVERT((TYPE)x);                                   \
+        if (v == NULL)                                          \
+            goto fail;                                          \
+        PyList_SET_ITEM(list, i, v);                            \
+    }                                                           \
+    break;
+
+    switch (bulk_kind(e, &swap, &le)) {
+    case BULK_SIGNED:
+        switch (e->size) {
+        case 1: UNPACK_INTS(uint8_t, int8_t, bulk_swap8, PyLong_FromLong)
+        case 2: UNPACK_INTS(uint16_t, int16_t, bulk_swap16, PyLong_FromLong)
+        case 4: UNPACK_INTS(uint32_t, int32_t, bulk_swap32, PyLong_FromLong)
+        case 8: UNPACK_INTS(uint64_t, int64_t, bulk_swap64,
+                            PyLong_FromLongLong)
+        }
+        break;
+    case BULK_UNSIGNED:
+        switch (e->size) {
+        case 1: UNPACK_INTS(uint8_t, uint8_t, bulk_swap8,
+                            PyLong_FromUnsignedLong)
+        case 2: UNPACK_INTS(uint16_t, uint16_t, bulk_swap16,
+                            PyLong_FromUnsignedLong)
+        case 4: UNPACK_INTS(uint32_t, uint32_t, bulk_swap32,
+                            PyLong_FromUnsignedLong)
+        case 8: UNPACK_INTS(uint64_t, uint64_t, bulk_swap64,
+                            PyLong_FromUnsignedLongLong)
+        }
+        break;
+    case BULK_DOUBLE:
+        for (i = 0; i < n; i++, p += step) {
+            double x;
+            memcpy(&x, p, sizeof(x));
+            v = PyFloat_FromDouble(x);
+            if (v == NULL)
+                goto fail;
+            PyList_SET_ITEM(list, i, v);
+        }
+        break;
+    case BULK_STD_DOUBLE:
+        for (i = 0; i < n; i++, p += step) {
+            double x = _PyFloat_Unpack8((const unsigned char *)p, le);
+            if (x == -1.0 && PyErr_Occurred())
+                goto fail;
+            v = PyFloat_FromDouble(x);
+            if (v == NULL)
+                goto fail;
+            PyList_SET_ITEM(list, i, v);
+        }
+        break;
+    case BULK_BOOL:
+        for (i = 0; i < n; i++, p += step) {
+            v = PyBool_FromLong(*p != 0);
+            PyList_SET_ITEM(list, i, v);
+        }
+        break;
+    case BULK_GENERIC:
+        for (i = 0; i < n; i++, p += step) {
+            if (e->format == 's') {
+                v = PyBytes_FromStringAndSize(p, itemsize);
+            } else if (e->format == 'p') {
+                Py_ssize_t len = *(unsigned char*)p;
+                if (len >= itemsize)
+                    len = itemsize - 1;
+                v = PyBytes_FromStringAndSize(p + 1, len);
+            } else {
+                v = e->unpack(p, e);
+            }
+            if (v == NULL)
+                goto fail;
+            PyList_SET_ITEM(list, i, v);
+        }
+        break;
+    }
+#undef UNPACK_INTS
+
+    return list;
+fail:
+    Py_DECREF(list);
+    return NULL;
+}
+
+/*[clinic input]
+Struct.unpack_many
+
+    buffer: Py_buffer
+    /
+
+Return a tuple of lists containing the unpacked values, one per field.
+
+The buffer is unpacked as consecutive records, like with iter_unpack(),
+and the i-th list holds the i-th value of each record.  The buffer's
+size in bytes must be a multiple of Struct.size.
+[clinic start generated code]*/
+
+static PyObject *
+Struct_unpack_many_impl(PyStructObject *self, Py_buffer *buffer)
+/*[clinic end generated code: output=daf5f658d509d4fa input=1b47e36ef99bf369]*/
+{
+    formatcode *code;
+    PyObject *result;
+    Py_ssize_t i = 0, n;
+
+    assert(self->s_codes != NULL);
+    if (self->s_size == 0) {
+        PyErr_Format(_structmodulestate_global->StructError,
+                     "cannot unpack many records with a struct of length 0");
+        return NULL;
+    }
+    if (buffer->len % self->s_size != 0) {
+        PyErr_Format(_structmodulestate_global->StructError,
+                     "unpack_many requires a buffer of "
+                     "a multiple of %zd bytes",
+                     self->s_size);
+        return NULL;
+    }
+    n = buffer->len / self->s_size;
+
+    result = PyTuple_New(self->s_len);
+    if (result == NULL)
+        return NULL;
+    for (code = self->s_codes; code->fmtdef != NULL; code++) {
+        const char *p = (const char *)buffer->buf + code->offset;
+        Py_ssize_t j = code->repeat;
+        while (j--) {
+            PyObject *column = unpack_column(code->fmtdef, code->size,
+                                             p, self->s_size, n);
+            if (column == NULL) {
+                Py_DECREF(result);
+                return NULL;
+            }
+            PyTuple_SET_ITEM(result, i++, column);
+            p += code->size;
+        }
+    }
+    return result;
+}
+
+
+/* Pack the value v according to code at res. */
+static int
+s_pack_value(const formatcode *code, char *res, PyObject *v)
+{
+    const formatdef *e = code->fmtdef;
+
+    if (e->format == 's') {
+        Py_ssize_t n;
+        int isstring;
+        const void *p;
+        isstring = PyBytes_Check(v);
+        if (!isstring && !PyByteArray_Check(v)) {
+            PyErr_SetString(_structmodulestate_global->StructError,
+                            "argument for 's' must be a bytes object");
+            return -1;
+        }
+        if (isstring) {
+            n = PyBytes_GET_SIZE(v);
+            p = PyBytes_AS_STRING(v);
+        }
+        else {
+            n = PyByteArray_GET_SIZE(v);
+            p = PyByteArray_AS_STRING(v);
+        }
+        if (n > code->size)
+            n = code->size;
+        if (n > 0)
+            memcpy(res, p, n);
+    } else if (e->format == 'p') {
+        Py_ssize_t n;
+        int isstring;
+        const void *p;
+        isstring = PyBytes_Check(v);
+        if (!isstring && !PyByteArray_Check(v)) {
+            PyErr_SetString(_structmodulestate_global->StructError,
+                            "argument for 'p' must be a bytes object");
+            return -1;
+        }
+        if (isstring) {
+            n = PyBytes_GET_SIZE(v);
+            p = PyBytes_AS_STRING(v);
+        }
+        else {
+            n = PyByteArray_GET_SIZE(v);
+            p = PyByteArray_AS_STRING(v);
+        }
+        if (n > (code->size - 1))
+            n = code->size - 1;
+        if (n > 0)
+            memcpy(res + 1, p, n);
+        if (n > 255)
+            n = 255;
+        *res = Py_SAFE_DOWNCAST(n, Py_ssize_t, unsigned char);
+    } else {
+        if (e->pack(res, v, e) < 0) {
+            if (PyLong_Check(v) && PyErr_ExceptionMatches(PyExc_OverflowError))
+                PyErr_SetString(_structmodulestate_global->StructError,
+                                "int too large to convert");
+            return -1;
+        }
+    }
+    return 0;
+}
+
 /*
  * Guts of the pack function.
  *
@@ -1782,66 +2081,11 @@ s_pack_internal(PyStructObject *soself, PyObject *const *args, int offset, char*
     memset(buf, '\0', soself->s_size);
     i = offset;
     for (code = soself->s_codes; code->fmtdef != NULL; code++) {
-        const formatdef *e = code->fmtdef;
         char *res = buf + code->offset;
         Py_ssize_t j = code->repeat;
         while (j--) {
-            PyObject *v = args[i++];
-            if (e->format == 's') {
-                Py_ssize_t n;
-                int isstring;
-                const void *p;
-                isstring = PyBytes_Check(v);
-                if (!isstring && !PyByteArray_Check(v)) {
-                    PyErr_SetString(_structmodulestate_global->StructError,
-                                    "argument for 's' must be a bytes object");
-                    return -1;
-                }
-                if (isstring) {
-                    n = PyBytes_GET_SIZE(v);
-                    p = PyBytes_AS_STRING(v);
-                }
-                else {
-                    n = PyByteArray_GET_SIZE(v);
-                    p = PyByteArray_AS_STRING(v);
-                }
-                if (n > code->size)
-                    n = code->size;
-                if (n > 0)
-                    memcpy(res, p, n);
-            } else if (e->format == 'p') {
-                Py_ssize_t n;
-                int isstring;
-                const void *p;
-                isstring = PyBytes_Check(v);
-                if (!isstring && !PyByteArray_Check(v)) {
-                    PyErr_SetString(_structmodulestate_global->StructError,
-                                    "argument for 'p' must be a bytes object");
-                    return -1;
-                }
-                if (isstring) {
-                    n = PyBytes_GET_SIZE(v);
-                    p = PyBytes_AS_STRING(v);
-                }
-                else {
-                    n = PyByteArray_GET_SIZE(v);
-                    p = PyByteArray_AS_STRING(v);
-                }
-                if (n > (code->size - 1))
-                    n = code->size - 1;
-                if (n > 0)
-                    memcpy(res + 1, p, n);
-                if (n > 255)
-                    n = 255;
-                *res = Py_SAFE_DOWNCAST(n, Py_ssize_t, unsigned char);
-            } else {
-                if (e->pack(res, v, e) < 0) {
-                    if (PyLong_Check(v) && PyErr_ExceptionMatches(PyExc_OverflowError))
-                        PyErr_SetString(_structmodulestate_global->StructError,
-                                        "int too large to convert");
-                    return -1;
-                }
-            }
+            if (s_pack_value(code, res, args[i++]) < 0)
+                return -1;
             res += code->size;
         }
     }
@@ -1850,6 +2094,84 @@ s_pack_internal(PyStructObject *soself, PyObject *const *args, int offset, char*
     return 0;
 }
 
+/* Pack the n values of items according to code at p, p + step, ... */
+static int
+pack_column(const formatcode *code, char *p, Py_ssize_t step,
+            PyObject *const *items, Py_ssize_t n)
+{
+    const formatdef *e = code->fmtdef;
+    enum bulk_kind kind;
+    Py_ssize_t i;
+    int swap, le;
+
+    /* Exact ints in the range of the format and exact floats are stored
+       inline; other values, including those raising errors, are packed by
+       s_pack_value(). */
+#define PACK_INTS(UTYPE, SWAP, MIN, MAX)                        \
+    for (i = 0; i < n; i++, p += step) {                        \
+        PyObject *v = items[i];                                 \
+        if (PyLong_CheckExact(v)) {                             \
+            int overflow;                                       \
+            long long x = PyLong_AsLongLongAndOverflow(v, &overflow); \
+            if (!overflow && x >= (MIN) && x <= (MAX)) {        \
+                UTYPE y = (UTYPE)x;                             \
+                if (swap)                                       \
+                    y = SWAP(y);                                \
+                memcpy(p, &y, sizeof(y));                       \
+                continue;                                       \
+            }                                                   \
+        }                                                       \
+        if (s_pack_value(code, p, v) < 0)                       \
+            return -1;                                          \
+    }                                                           \
+    return 0;
+
+    kind = bulk_kind(e, &swap, &le);
+    switch (kind) {
+    case BULK_SIGNED:
+        switch (e->size) {
+        case 1: PACK_INTS(uint8_t, bulk_swap8, INT8_MIN, INT8_MAX)
+        case 2: PACK_INTS(uint16_t, bulk_swap16, INT16_MIN, INT16_MAX)
+        case 4: PACK_INTS(uint32_t, bulk_swap32, INT32_MIN, INT32_MAX)
+        case 8: PACK_INTS(uint64_t, bulk_swap64, LLONG_MIN, LLONG_MAX)
+        }
+        break;
+    case BULK_UNSIGNED:
+        switch (e->size) {
+        case 1: PACK_INTS(uint8_t, bulk_swap8, 0, UINT8_MAX)
+        case 2: PACK_INTS(uint16_t, bulk_swap16, 0, UINT16_MAX)
+        case 4: PACK_INTS(uint32_t, bulk_swap32, 0, (long long)UINT32_MAX)
+        case 8: PACK_INTS(uint64_t, bulk_swap64, 0, LLONG_MAX)
+        }
+        break;
+    case BULK_DOUBLE:
+    case BULK_STD_DOUBLE:
+        for (i = 0; i < n; i++, p += step) {
+            PyObject *v = items[i];
+            if (PyFloat_CheckExact(v)) {
+                double x = PyFloat_AS_DOUBLE(v);
+                if (kind == BULK_DOUBLE)
+                    memcpy(p, &x, sizeof(x));
+                else if (_PyFloat_Pack8(x, (unsigned char *)p, le) < 0)
+                    return -1;
+                continue;
+            }
+            if (s_pack_value(code, p, v) < 0)
+                return -1;
+        }
+        return 0;
+    default:
+        break;
+    }
+#undef PACK_INTS
+
+    for (i = 0; i < n; i++, p += step) {
+        if (s_pack_value(code, p, items[i]) < 0)
+            return -1;
+    }
+    return 0;
+}
+
 
 PyDoc_STRVAR(s_pack__doc__,
 "S.pack(v1, v2, ...) -> bytes\n\
@@ -1893,6 +2215,90 @@ s_pack(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
     return _PyBytesWriter_Finish(&writer, buf + soself->s_size);
 }
 
+PyDoc_STRVAR(s_pack_many__doc__,
+"S.pack_many(column1, column2, ...) -> bytes\n\
+\n\
+Return a bytes object containing records packed according to the format\n\
+string S.format, the i-th record holding the i-th item of each column.\n\
+The columns must be sequences of the same length, one per value of\n\
+S.pack(), like the lists returned by S.unpack_many().  See help(struct)\n\
+for more on format strings.");
+
+static PyObject *
+s_pack_many(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    PyStructObject *soself;
+    PyObject **columns;
+    PyObject *result = NULL;
+    formatcode *code;
+    Py_ssize_t i, n = 0;
+    char *buf;
+
+    /* Validate arguments. */
+    soself = (PyStructObject *)self;
+    assert(PyStruct_Check(self));
+    assert(soself->s_codes != NULL);
+    if (nargs != soself->s_len)
+    {
+        PyErr_Format(_structmodulestate_global->StructError,
+            "pack_many expected %zd columns for packing (got %zd)",
+            soself->s_len, nargs);
+        return NULL;
+    }
+
+    columns = PyMem_New(PyObject *, nargs + 1);
+    if (columns == NULL)
+        return PyErr_NoMemory();
+    for (i = 0; i < nargs; i++) {
+        /* A tuple, so that packing cannot change the items. */
+        columns[i] = PySequence_Tuple(args[i]);
+        if (columns[i] == NULL)
+            goto done;
+        if (i == 0)
+            n = PyTuple_GET_SIZE(columns[0]);
+        else if (PyTuple_GET_SIZE(columns[i]) != n) {
+            i++;
+            PyErr_SetString(_structmodulestate_global->StructError,
+                            "pack_many columns must have the same length");
+            goto done;
+        }
+    }
+
+    if (soself->s_size > 0 && n > PY_SSIZE_T_MAX / soself->s_size) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    result = PyBytes_FromStringAndSize(NULL, n * soself->s_size);
+    if (result == NULL)
+        goto done;
+    buf = PyBytes_AS_STRING(result);
+    memset(buf, '\0', n * soself->s_size);
+
+    i = 0;
+    for (code = soself->s_codes; code->fmtdef != NULL; code++) {
+        char *res = buf + code->offset;
+        Py_ssize_t j = code->repeat;
+        while (j--) {
+            if (pack_column(code, res, soself->s_size,
+                            &PyTuple_GET_ITEM(columns[i], 0), n) < 0) {
+                Py_CLEAR(result);
+                break;
+            }
+            i++;
+            res += code->size;
+        }
+        if (result == NULL)
+            break;
+    }
+    i = nargs;
+
+  done:
+    while (i-- > 0)
+        Py_XDECREF(columns[i]);
+    PyMem_Free(columns);
+    return result;
+}
+
 PyDoc_STRVAR(s_pack_into__doc__,
 "S.pack_into(buffer, offset, v1, v2, ...)\n\
 \n\
@@ -2028,8 +2434,10 @@ static struct PyMethodDef s_methods[] = {
     STRUCT_ITER_UNPACK_METHODDEF
     {"pack",            (PyCFunction)(void(*)(void))s_pack, METH_FASTCALL, s_pack__doc__},
     {"pack_into",       (PyCFunction)(void(*)(void))s_pack_into, METH_FASTCALL, s_pack_into__doc__},
+    {"pack_many",       (PyCFunction)(void(*)(void))s_pack_many, METH_FASTCALL, s_pack_many__doc__},
     STRUCT_UNPACK_METHODDEF
     STRUCT_UNPACK_FROM_METHODDEF
+    STRUCT_UNPACK_MANY_METHODDEF
     {"__sizeof__",      (PyCFunction)s_sizeof, METH_NOARGS, s_sizeof__doc__},
     {NULL,       NULL}          /* sentinel */
 };
@@ -2206,6 +2614,33 @@ pack_into(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
     return result;
 }
 
+PyDoc_STRVAR(pack_many_doc,
+"pack_many(format, column1, column2, ...) -> bytes\n\
+\n\
+Return a bytes object containing records packed according to the format\n\
+string, the i-th record holding the i-th item of each column.  See\n\
+help(struct) for more on format strings.");
+
+static PyObject *
+pack_many(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    PyObject *s_object = NULL;
+    PyObject *format, *result;
+
+    if (nargs == 0) {
+        PyErr_SetString(PyExc_TypeError, "missing format argument");
+        return NULL;
+    }
+    format = args[0];
+
+    if (!cache_struct_converter(format, (PyStructObject **)&s_object)) {
+        return NULL;
+    }
+    result = s_pack_many(s_object, args + 1, nargs - 1);
+    Py_DECREF(s_object);
+    return result;
+}
+
 /*[clinic input]
 unpack
 
@@ -2273,14 +2708,38 @@ iter_unpack_impl(PyObject *module, PyStructObject *s_object,
     return Struct_iter_unpack(s_object, buffer);
 }
 
+/*[clinic input]
+unpack_many
+
+    format as s_object: cache_struct
+    buffer: Py_buffer
+    /
+
+Return a tuple of lists containing values unpacked according to the format.
+
+The buffer is unpacked as consecutive records, and the i-th list holds the
+i-th value of each record.  The buffer's size in bytes must be a multiple
+of calcsize(format).
+[clinic start generated code]*/
+
+static PyObject *
+unpack_many_impl(PyObject *module, PyStructObject *s_object,
+                 Py_buffer *buffer)
+/*[clinic end generated code: output=523bb42c68423f28 input=b58e1aadbb4fbadd]*/
+{
+    return Struct_unpack_many_impl(s_object, buffer);
+}
+
 static struct PyMethodDef module_functions[] = {
     _CLEARCACHE_METHODDEF
     CALCSIZE_METHODDEF
     ITER_UNPACK_METHODDEF
     {"pack",            (PyCFunction)(void(*)(void))pack, METH_FASTCALL,   pack_doc},
     {"pack_into",       (PyCFunction)(void(*)(void))pack_into, METH_FASTCALL,   pack_into_doc},
+    {"pack_many",       (PyCFunction)(void(*)(void))pack_many, METH_FASTCALL,   pack_many_doc},
     UNPACK_METHODDEF
     UNPACK_FROM_METHODDEF
+    UNPACK_MANY_METHODDEF
     {NULL,       NULL}          /* sentinel */
 };
 
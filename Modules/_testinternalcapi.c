@@ -13,6 +13,7 @@
 
 #include "Python.h"
 #include "pycore_byteswap.h"     // _Py_bswap32()
+#include "pycore_cpuinfo.h"      // _Py_GetSIMDLevel()
 #include "pycore_initconfig.h"   // _Py_GetConfigsAsDict()
 #include "pycore_hashtable.h"    // _Py_hashtable_new()
 #include "pycore_gc.h"           // PyGC_Head
@@ -153,11 +154,37 @@ test_hashtable(PyObject *self, PyObject *Py_UNUSED(args))
 }
 
 
+static PyObject *
+get_simd_level(PyObject *self, PyObject *Py_UNUSED(args))
+{
+    return PyLong_FromLong(_Py_GetSIMDLevel());
+}
+
+
+static PyObject *
+set_simd_level(PyObject *self, PyObject *arg)
+{
+    int level = _PyLong_AsInt(arg);
+    if (level == -1 && PyErr_Occurred()) {
+        return NULL;
+    }
+    if (level < 0 || level > _Py_DetectSIMDLevel()) {
+        PyErr_SetString(PyExc_ValueError,
+                        "SIMD level not supported by this CPU");
+        return NULL;
+    }
+    _Py_simd_level = level;
+    Py_RETURN_NONE;
+}
+
+
 static PyMethodDef TestMethods[] = {
     {"get_configs", get_configs, METH_NOARGS},
     {"get_recursion_depth", get_recursion_depth, METH_NOARGS},
     {"test_bswap", test_bswap, METH_NOARGS},
     {"test_hashtable", test_hashtable, METH_NOARGS},
+    {"get_simd_level", get_simd_level, METH_NOARGS},
+    {"set_simd_level", set_simd_level, METH_O},
     {NULL, NULL} /* sentinel */
 };
 
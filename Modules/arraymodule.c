@@ -1905,71 +1905,29 @@ make_array(PyTypeObject *arraytype, char typecode, PyObject *items)
     return array_obj;
 }
 
-/*
- * This functions is a special constructor used when unpickling an array. It
- * provides a portable way to rebuild an array from its memory representation.
- */
-/*[clinic input]
-array._array_reconstructor
-
-    arraytype: object(type="PyTypeObject *")
-    typecode: int(accept={str})
-    mformat_code: int(type="enum machine_format_code")
-    items: object
-    /
-
-Internal. Used for pickling support.
-[clinic start generated code]*/
-
+/* Rebuild an array from the memory representation of its items in the given
+ * machine format. */
 static PyObject *
-array__array_reconstructor_impl(PyObject *module, PyTypeObject *arraytype,
-                                int typecode,
-                                enum machine_format_code mformat_code,
-                                PyObject *items)
-/*[clinic end generated code: output=e05263141ba28365 input=2464dc8f4c7736b5]*/
+array_reconstruct(PyTypeObject *arraytype, const struct arraydescr *descr,
+                  enum machine_format_code mformat_code,
+                  const unsigned char *memstr, Py_ssize_t size)
 {
     PyObject *converted_items;
     PyObject *result;
-    const struct arraydescr *descr;
-
-    if (!PyType_Check(arraytype)) {
-        PyErr_Format(PyExc_TypeError,
-            "first argument must be a type object, not %.200s",
-            Py_TYPE(arraytype)->tp_name);
-        return NULL;
-    }
-    if (!PyType_IsSubtype(arraytype, &Arraytype)) {
-        PyErr_Format(PyExc_TypeError,
-            "%.200s is not a subtype of %.200s",
-            arraytype->tp_name, Arraytype.tp_name);
-        return NULL;
-    }
-    for (descr = descriptors; descr->typecode != '\0'; descr++) {
-        if ((int)descr->typecode == typecode)
-            break;
-    }
-    if (descr->typecode == '\0') {
-        PyErr_SetString(PyExc_ValueError,
-                        "second argument must be a valid type code");
-        return NULL;
-    }
-    if (mformat_code < MACHINE_FORMAT_CODE_MIN ||
-        mformat_code > MACHINE_FORMAT_CODE_MAX) {
-        PyErr_SetString(PyExc_ValueError,
-            "third argument must be a valid machine format code.");
-        return NULL;
-    }
-    if (!PyBytes_Check(items)) {
-        PyErr_Format(PyExc_TypeError,
-            "fourth argument should be bytes, not %.200s",
-            Py_TYPE(items)->tp_name);
-        return NULL;
-    }
+    int typecode = descr->typecode;
 
     /* Fast path: No decoding has to be done. */
     if (mformat_code == typecode_to_mformat_code((char)typecode) ||
         mformat_code == UNKNOWN_FORMAT) {
-        return make_array(arraytype, (char)typecode, items);
+        if (size % descr->itemsize != 0) {
+            PyErr_SetString(PyExc_ValueError,
+                            "bytes length not a multiple of item size");
+            return NULL;
+        }
+        result = newarrayobject(arraytype, size / descr->itemsize, descr);
+        if (result != NULL && size > 0)
+            memcpy(((arrayobject *)result)->ob_item, memstr, size);
+        return result;
     }
 
     /* Slow path: Decode the byte string according to the given machine
@@ -1977,7 +1935,7 @@ array__array_reconstructor_impl(PyObject *module, PyTypeObject *arraytype,
      * object is architecturally different from the one that pickled the
      * array.
      */
-    if (Py_SIZE(items) % mformat_descriptors[mformat_code].size != 0) {
+    if (size % mformat_descriptors[mformat_code].size != 0) {
         PyErr_SetString(PyExc_ValueError,
                         "string length not a multiple of item size");
         return NULL;
@@ -1987,9 +1945,7 @@ array__array_reconstructor_impl(PyObject *module, PyTypeObject *arraytype,
     case IEEE_754_FLOAT_BE: {
         Py_ssize_t i;
         int le = (mformat_code == IEEE_754_FLOAT_LE) ? 1 : 0;
-        Py_ssize_t itemcount = Py_SIZE(items) / 4;
-        const unsigned char *memstr =
-            (unsigned char *)PyBytes_AS_STRING(items);
+        Py_ssize_t itemcount = size / 4;
 
         converted_items = PyList_New(itemcount);
         if (converted_items == NULL)
@@ -2009,9 +1965,7 @@ array__array_reconstructor_impl(PyObject *module, PyTypeObject *arraytype,
     case IEEE_754_DOUBLE_BE: {
         Py_ssize_t i;
         int le = (mformat_code == IEEE_754_DOUBLE_LE) ? 1 : 0;
-        Py_ssize_t itemcount = Py_SIZE(items) / 8;
-        const unsigned char *memstr =
-            (unsigned char *)PyBytes_AS_STRING(items);
+        Py_ssize_t itemcount = size / 8;
 
         converted_items = PyList_New(itemcount);
         if (converted_items == NULL)
@@ -2031,7 +1985,7 @@ array__array_reconstructor_impl(PyObject *module, PyTypeObject *arraytype,
     case UTF16_BE: {
         int byteorder = (mformat_code == UTF16_LE) ? -1 : 1;
         converted_items = PyUnicode_DecodeUTF16(
-            PyBytes_AS_STRING(items), Py_SIZE(items),
+            (const char *)memstr, size,
             "strict", &byteorder);
         if (converted_items == NULL)
             return NULL;
@@ -2041,7 +1995,7 @@ array__array_reconstructor_impl(PyObject *module, PyTypeObject *arraytype,
     case UTF32_BE: {
         int byteorder = (mformat_code == UTF32_LE) ? -1 : 1;
         converted_items = PyUnicode_DecodeUTF32(
-            PyBytes_AS_STRING(items), Py_SIZE(items),
+            (const char *)memstr, size,
             "strict", &byteorder);
         if (converted_items == NULL)
             return NULL;
@@ -2065,9 +2019,7 @@ array__array_reconstructor_impl(PyObject *module, PyTypeObject *arraytype,
         Py_ssize_t i;
         const struct mformatdescr mf_descr =
             mformat_descriptors[mformat_code];
-        Py_ssize_t itemcount = Py_SIZE(items) / mf_descr.size;
-        const unsigned char *memstr =
-            (unsigned char *)PyBytes_AS_STRING(items);
+        Py_ssize_t itemcount = size / mf_descr.size;
         const struct arraydescr *descr;
 
         /* If possible, try to pack array's items using a data type
@@ -2120,6 +2072,76 @@ array__array_reconstructor_impl(PyObject *module, PyTypeObject *arraytype,
     return result;
 }
 
+/*
+ * This functions is a special constructor used when unpickling an array. It
+ * provides a portable way to rebuild an array from its memory representation.
+ */
+/*[clinic input]
+array._array_reconstructor
+
+    arraytype: object(type="PyTypeObject *")
+    typecode: int(accept={str})
+    mformat_code: int(type="enum machine_format_code")
+    items: object
+    /
+
+Internal. Used for pickling support.
+[clinic start generated code]*/
+
+static PyObject *
+array__array_reconstructor_impl(PyObject *module, PyTypeObject *arraytype,
+                                int typecode,
+                                enum machine_format_code mformat_code,
+                                PyObject *items)
+/*[clinic end generated code: output=e05263141ba28365 input=2464dc8f4c7736b5]*/
+{
+    PyObject *result;
+    const struct arraydescr *descr;
+    Py_buffer buffer;
+
+    if (!PyType_Check(arraytype)) {
+        PyErr_Format(PyExc_TypeError,
+            "first argument must be a type object, not %.200s",
+            Py_TYPE(arraytype)->tp_name);
+        return NULL;
+    }
+    if (!PyType_IsSubtype(arraytype, &Arraytype)) {
+        PyErr_Format(PyExc_TypeError,
+            "%.200s is not a subtype of %.200s",
+            arraytype->tp_name, Arraytype.tp_name);
+        return NULL;
+    }
+    for (descr = descriptors; descr->typecode != '\0'; descr++) {
+        if ((int)descr->typecode == typecode)
+            break;
+    }
+    if (descr->typecode == '\0') {
+        PyErr_SetString(PyExc_ValueError,
+                        "second argument must be a valid type code");
+        return NULL;
+    }
+    if (mformat_code < MACHINE_FORMAT_CODE_MIN ||
+        mformat_code > MACHINE_FORMAT_CODE_MAX) {
+        PyErr_SetString(PyExc_ValueError,
+            "third argument must be a valid machine format code.");
+        return NULL;
+    }
+    if (!PyObject_CheckBuffer(items)) {
+        PyErr_Format(PyExc_TypeError,
+            "fourth argument should be a bytes-like object, not %.200s",
+            Py_TYPE(items)->tp_name);
+        return NULL;
+    }
+    /* With pickle protocol 5, items is the buffer given to the unpickler
+     * when the array was pickled out-of-band. */
+    if (PyObject_GetBuffer(items, &buffer, PyBUF_SIMPLE) < 0)
+        return NULL;
+    result = array_reconstruct(arraytype, descr, mformat_code,
+                               (const unsigned char *)buffer.buf, buffer.len);
+    PyBuffer_Release(&buffer);
+    return result;
+}
+
 /*[clinic input]
 array.array.__reduce_ex__
 
@@ -2142,6 +2164,7 @@ array_array___reduce_ex__(arrayobject *self, PyObject *value)
     long protocol;
     _Py_IDENTIFIER(_array_reconstructor);
     _Py_IDENTIFIER(__dict__);
+    _Py_IDENTIFIER(toreadonly);
 
     if (array_reconstructor == NULL) {
         PyObject *array_module = PyImport_ImportModule("array");
@@ -2198,7 +2221,25 @@ array_array___reduce_ex__(arrayobject *self, PyObject *value)
         return result;
     }
 
-    array_str = array_array_tobytes_impl(self);
+    if (protocol >= 5) {
+        /* Pass the items in a read-only PickleBuffer, which is pickled
+         * in-band as bytes, or out-of-band without copying them. */
+        PyObject *view = PyMemoryView_FromObject((PyObject *)self);
+        if (view == NULL) {
+            Py_DECREF(dict);
+            return NULL;
+        }
+        Py_SETREF(view, _PyObject_CallMethodIdNoArgs(view, &PyId_toreadonly));
+        if (view == NULL) {
+            Py_DECREF(dict);
+            return NULL;
+        }
+        array_str = PyPickleBuffer_FromObject(view);
+        Py_DECREF(view);
+    }
+    else {
+        array_str = array_array_tobytes_impl(self);
+    }
     if (array_str == NULL) {
         Py_DECREF(dict);
         return NULL;
@@ -756,6 +756,26 @@ PyDoc_STRVAR(_sre_SRE_Pattern___deepcopy____doc__,
 #define _SRE_SRE_PATTERN___DEEPCOPY___METHODDEF    \
     {"__deepcopy__", (PyCFunction)_sre_SRE_Pattern___deepcopy__, METH_O, _sre_SRE_Pattern___deepcopy____doc__},
 
+PyDoc_STRVAR(_sre_SRE_Pattern___sizeof____doc__,
+"__sizeof__($self, /)\n"
+"--\n"
+"\n"
+"Return the size of the pattern in memory, in bytes.\n"
+"\n"
+"This includes the automaton of a pattern compiled with the DFA flag.");
+
+#define _SRE_SRE_PATTERN___SIZEOF___METHODDEF    \
+    {"__sizeof__", (PyCFunction)_sre_SRE_Pattern___sizeof__, METH_NOARGS, _sre_SRE_Pattern___sizeof____doc__},
+
+static PyObject *
+_sre_SRE_Pattern___sizeof___impl(PatternObject *self);
+
+static PyObject *
+_sre_SRE_Pattern___sizeof__(PatternObject *self, PyObject *Py_UNUSED(ignored))
+{
+    return _sre_SRE_Pattern___sizeof___impl(self);
+}
+
 PyDoc_STRVAR(_sre_compile__doc__,
 "compile($module, /, pattern, flags, code, groups, groupindex,\n"
 "        indexgroup)\n"
@@ -1102,4 +1122,4 @@ _sre_SRE_Scanner_search(ScannerObject *self, PyObject *Py_UNUSED(ignored))
 {
     return _sre_SRE_Scanner_search_impl(self);
 }
-/*[clinic end generated code: output=7a3360917b40a808 input=a9049054013a1b77]*/
+/*[clinic end generated code: output=be11a0ffec66663b input=a9049054013a1b77]*/
@@ -162,6 +162,46 @@ PyDoc_STRVAR(Struct_iter_unpack__doc__,
 #define STRUCT_ITER_UNPACK_METHODDEF    \
     {"iter_unpack", (PyCFunction)Struct_iter_unpack, METH_O, Struct_iter_unpack__doc__},
 
+PyDoc_STRVAR(Struct_unpack_many__doc__,
+"unpack_many($self, buffer, /)\n"
+"--\n"
+"\n"
+"Return a tuple of lists containing the unpacked values, one per field.\n"
+"\n"
+"The buffer is unpacked as consecutive records, like with iter_unpack(),\n"
+"and the i-th list holds the i-th value of each record.  The buffer\'s\n"
+"size in bytes must be a multiple of Struct.size.");
+
+#define STRUCT_UNPACK_MANY_METHODDEF    \
+    {"unpack_many", (PyCFunction)Struct_unpack_many, METH_O, Struct_unpack_many__doc__},
+
+static PyObject *
+Struct_unpack_many_impl(PyStructObject *self, Py_buffer *buffer);
+
+static PyObject *
+Struct_unpack_many(PyStructObject *self, PyObject *arg)
+{
+    PyObject *return_value = NULL;
+    Py_buffer buffer = {NULL, NULL};
+
+    if (PyObject_GetBuffer(arg, &buffer, PyBUF_SIMPLE) != 0) {
+        goto exit;
+    }
+    if (!PyBuffer_IsContiguous(&buffer, 'C')) {
+        _PyArg_BadArgument("unpack_many", "argument", "contiguous buffer", arg);
+        goto exit;
+    }
+    return_value = Struct_unpack_many_impl(self, &buffer);
+
+exit:
+    /* Cleanup for buffer */
+    if (buffer.obj) {
+       PyBuffer_Release(&buffer);
+    }
+
+    return return_value;
+}
+
 PyDoc_STRVAR(_clearcache__doc__,
 "_clearcache($module, /)\n"
 "--\n"
@@ -376,4 +416,54 @@ exit:
 
     return return_value;
 }
-/*[clinic end generated code: output=1205daf7f616f0cf input=a9049054013a1b77]*/
+
+PyDoc_STRVAR(unpack_many__doc__,
+"unpack_many($module, format, buffer, /)\n"
+"--\n"
+"\n"
+"Return a tuple of lists containing values unpacked according to the format.\n"
+"\n"
+"The buffer is unpacked as consecutive records, and the i-th list holds the\n"
+"i-th value of each record.  The buffer\'s size in bytes must be a multiple\n"
+"of calcsize(format).");
+
+#define UNPACK_MANY_METHODDEF    \
+    {"unpack_many", (PyCFunction)(void(*)(void))unpack_many, METH_FASTCALL, unpack_many__doc__},
+
+static PyObject *
+unpack_many_impl(PyObject *module, PyStructObject *s_object,
+                 Py_buffer *buffer);
+
+static PyObject *
+unpack_many(PyObject *module, PyObject *const *args, Py_ssize_t nargs)
+{
+    PyObject *return_value = NULL;
+    PyStructObject *s_object = NULL;
+    Py_buffer buffer = {NULL, NULL};
+
+    if (!_PyArg_CheckPositional("unpack_many", nargs, 2, 2)) {
+        goto exit;
+    }
+    if (!cache_struct_converter(args[0], &s_object)) {
+        goto exit;
+    }
+    if (PyObject_GetBuffer(args[1], &buffer, PyBUF_SIMPLE) != 0) {
+        goto exit;
+    }
+    if (!PyBuffer_IsContiguous(&buffer, 'C')) {
+        _PyArg_BadArgument("unpack_many", "argument 2", "contiguous buffer", args[1]);
+        goto exit;
+    }
+    return_value = unpack_many_impl(module, s_object, &buffer);
+
+exit:
+    /* Cleanup for s_object */
+    Py_XDECREF(s_object);
+    /* Cleanup for buffer */
+    if (buffer.obj) {
+       PyBuffer_Release(&buffer);
+    }
+
+    return return_value;
+}
+/*[clinic end generated code: output=41179f65146cd98e input=a9049054013a1b77]*/
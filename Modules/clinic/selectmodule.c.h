@@ -901,6 +901,584 @@ exit:
 
 #endif /* defined(HAVE_EPOLL) */
 
+#if defined(HAVE_IO_URING)
+
+PyDoc_STRVAR(select_io_uring__doc__,
+"io_uring(entries=256)\n"
+"--\n"
+"\n"
+"Returns an io_uring object.\n"
+"\n"
+"  entries\n"
+"    The size of the submission queue.  The completion queue is twice\n"
+"    as large.");
+
+static PyObject *
+select_io_uring_impl(PyTypeObject *type, int entries);
+
+static PyObject *
+select_io_uring(PyTypeObject *type, PyObject *args, PyObject *kwargs)
+{
+    PyObject *return_value = NULL;
+    static const char * const _keywords[] = {"entries", NULL};
+    static _PyArg_Parser _parser = {NULL, _keywords, "io_uring", 0};
+    PyObject *argsbuf[1];
+    PyObject * const *fastargs;
+    Py_ssize_t nargs = PyTuple_GET_SIZE(args);
+    Py_ssize_t noptargs = nargs + (kwargs ? PyDict_GET_SIZE(kwargs) : 0) - 0;
+    int entries = 256;
+
+    fastargs = _PyArg_UnpackKeywords(_PyTuple_CAST(args)->ob_item, nargs, kwargs, NULL, &_parser, 0, 1, 0, argsbuf);
+    if (!fastargs) {
+        goto exit;
+    }
+    if (!noptargs) {
+        goto skip_optional_pos;
+    }
+    entries = _PyLong_AsInt(fastargs[0]);
+    if (entries == -1 && PyErr_Occurred()) {
+        goto exit;
+    }
+skip_optional_pos:
+    return_value = select_io_uring_impl(type, entries);
+
+exit:
+    return return_value;
+}
+
+#endif /* defined(HAVE_IO_URING) */
+
+#if defined(HAVE_IO_URING)
+
+PyDoc_STRVAR(select_io_uring_close__doc__,
+"close($self, /)\n"
+"--\n"
+"\n"
+"Close the io_uring file descriptor.\n"
+"\n"
+"The operations in progress are cancelled.  Further operations on the\n"
+"io_uring object will raise an exception.");
+
+#define SELECT_IO_URING_CLOSE_METHODDEF    \
+    {"close", (PyCFunction)select_io_uring_close, METH_NOARGS, select_io_uring_close__doc__},
+
+static PyObject *
+select_io_uring_close_impl(pyIoUring_Object *self);
+
+static PyObject *
+select_io_uring_close(pyIoUring_Object *self, PyObject *Py_UNUSED(ignored))
+{
+    return select_io_uring_close_impl(self);
+}
+
+#endif /* defined(HAVE_IO_URING) */
+
+#if defined(HAVE_IO_URING)
+
+PyDoc_STRVAR(select_io_uring_fileno__doc__,
+"fileno($self, /)\n"
+"--\n"
+"\n"
+"Return the io_uring file descriptor.\n"
+"\n"
+"It becomes readable when completions are available.");
+
+#define SELECT_IO_URING_FILENO_METHODDEF    \
+    {"fileno", (PyCFunction)select_io_uring_fileno, METH_NOARGS, select_io_uring_fileno__doc__},
+
+static PyObject *
+select_io_uring_fileno_impl(pyIoUring_Object *self);
+
+static PyObject *
+select_io_uring_fileno(pyIoUring_Object *self, PyObject *Py_UNUSED(ignored))
+{
+    return select_io_uring_fileno_impl(self);
+}
+
+#endif /* defined(HAVE_IO_URING) */
+
+#if defined(HAVE_IO_URING)
+
+PyDoc_STRVAR(select_io_uring_read__doc__,
+"read($self, fd, buffer, offset=-1, /)\n"
+"--\n"
+"\n"
+"Queue a read of up to len(buffer) bytes from fd into buffer.\n"
+"\n"
+"  buffer\n"
+"    a writable bytes-like object\n"
+"  offset\n"
+"    the offset in the file; -1 means the current file position\n"
+"\n"
+"The result of the operation is the number of bytes read.  Return its tag.");
+
+#define SELECT_IO_URING_READ_METHODDEF    \
+    {"read", (PyCFunction)(void(*)(void))select_io_uring_read, METH_FASTCALL, select_io_uring_read__doc__},
+
+static PyObject *
+select_io_uring_read_impl(pyIoUring_Object *self, int fd, PyObject *buffer,
+                          long long offset);
+
+static PyObject *
+select_io_uring_read(pyIoUring_Object *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    PyObject *return_value = NULL;
+    int fd;
+    PyObject *buffer;
+    long long offset = -1;
+
+    if (!_PyArg_CheckPositional("read", nargs, 2, 3)) {
+        goto exit;
+    }
+    if (!fildes_converter(args[0], &fd)) {
+        goto exit;
+    }
+    buffer = args[1];
+    if (nargs < 3) {
+        goto skip_optional;
+    }
+    offset = PyLong_AsLongLong(args[2]);
+    if (offset == -1 && PyErr_Occurred()) {
+        goto exit;
+    }
+skip_optional:
+    return_value = select_io_uring_read_impl(self, fd, buffer, offset);
+
+exit:
+    return return_value;
+}
+
+#endif /* defined(HAVE_IO_URING) */
+
+#if defined(HAVE_IO_URING)
+
+PyDoc_STRVAR(select_io_uring_write__doc__,
+"write($self, fd, buffer, offset=-1, /)\n"
+"--\n"
+"\n"
+"Queue a write of the contents of buffer to fd.\n"
+"\n"
+"  buffer\n"
+"    a bytes-like object\n"
+"  offset\n"
+"    the offset in the file; -1 means the current file position\n"
+"\n"
+"The result of the operation is the number of bytes written.  Return its\n"
+"tag.");
+
+#define SELECT_IO_URING_WRITE_METHODDEF    \
+    {"write", (PyCFunction)(void(*)(void))select_io_uring_write, METH_FASTCALL, select_io_uring_write__doc__},
+
+static PyObject *
+select_io_uring_write_impl(pyIoUring_Object *self, int fd, PyObject *buffer,
+                           long long offset);
+
+static PyObject *
+select_io_uring_write(pyIoUring_Object *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    PyObject *return_value = NULL;
+    int fd;
+    PyObject *buffer;
+    long long offset = -1;
+
+    if (!_PyArg_CheckPositional("write", nargs, 2, 3)) {
+        goto exit;
+    }
+    if (!fildes_converter(args[0], &fd)) {
+        goto exit;
+    }
+    buffer = args[1];
+    if (nargs < 3) {
+        goto skip_optional;
+    }
+    offset = PyLong_AsLongLong(args[2]);
+    if (offset == -1 && PyErr_Occurred()) {
+        goto exit;
+    }
+skip_optional:
+    return_value = select_io_uring_write_impl(self, fd, buffer, offset);
+
+exit:
+    return return_value;
+}
+
+#endif /* defined(HAVE_IO_URING) */
+
+#if defined(HAVE_IO_URING)
+
+PyDoc_STRVAR(select_io_uring_recv__doc__,
+"recv($self, fd, buffer, flags=0, /)\n"
+"--\n"
+"\n"
+"Queue a receive of up to len(buffer) bytes from socket fd into buffer.\n"
+"\n"
+"  buffer\n"
+"    a writable bytes-like object\n"
+"  flags\n"
+"    the flags of recv()\n"
+"\n"
+"The result of the operation is the number of bytes received.  Return its\n"
+"tag.");
+
+#define SELECT_IO_URING_RECV_METHODDEF    \
+    {"recv", (PyCFunction)(void(*)(void))select_io_uring_recv, METH_FASTCALL, select_io_uring_recv__doc__},
+
+static PyObject *
+select_io_uring_recv_impl(pyIoUring_Object *self, int fd, PyObject *buffer,
+                          unsigned int flags);
+
+static PyObject *
+select_io_uring_recv(pyIoUring_Object *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    PyObject *return_value = NULL;
+    int fd;
+    PyObject *buffer;
+    unsigned int flags = 0;
+
+    if (!_PyArg_CheckPositional("recv", nargs, 2, 3)) {
+        goto exit;
+    }
+    if (!fildes_converter(args[0], &fd)) {
+        goto exit;
+    }
+    buffer = args[1];
+    if (nargs < 3) {
+        goto skip_optional;
+    }
+    flags = (unsigned int)PyLong_AsUnsignedLongMask(args[2]);
+    if (flags == (unsigned int)-1 && PyErr_Occurred()) {
+        goto exit;
+    }
+skip_optional:
+    return_value = select_io_uring_recv_impl(self, fd, buffer, flags);
+
+exit:
+    return return_value;
+}
+
+#endif /* defined(HAVE_IO_URING) */
+
+#if defined(HAVE_IO_URING)
+
+PyDoc_STRVAR(select_io_uring_send__doc__,
+"send($self, fd, buffer, flags=0, /)\n"
+"--\n"
+"\n"
+"Queue a send of the contents of buffer to socket fd.\n"
+"\n"
+"  buffer\n"
+"    a bytes-like object\n"
+"  flags\n"
+"    the flags of send()\n"
+"\n"
+"The result of the operation is the number of bytes sent.  Return its tag.");
+
+#define SELECT_IO_URING_SEND_METHODDEF    \
+    {"send", (PyCFunction)(void(*)(void))select_io_uring_send, METH_FASTCALL, select_io_uring_send__doc__},
+
+static PyObject *
+select_io_uring_send_impl(pyIoUring_Object *self, int fd, PyObject *buffer,
+                          unsigned int flags);
+
+static PyObject *
+select_io_uring_send(pyIoUring_Object *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    PyObject *return_value = NULL;
+    int fd;
+    PyObject *buffer;
+    unsigned int flags = 0;
+
+    if (!_PyArg_CheckPositional("send", nargs, 2, 3)) {
+        goto exit;
+    }
+    if (!fildes_converter(args[0], &fd)) {
+        goto exit;
+    }
+    buffer = args[1];
+    if (nargs < 3) {
+        goto skip_optional;
+    }
+    flags = (unsigned int)PyLong_AsUnsignedLongMask(args[2]);
+    if (flags == (unsigned int)-1 && PyErr_Occurred()) {
+        goto exit;
+    }
+skip_optional:
+    return_value = select_io_uring_send_impl(self, fd, buffer, flags);
+
+exit:
+    return return_value;
+}
+
+#endif /* defined(HAVE_IO_URING) */
+
+#if defined(HAVE_IO_URING)
+
+PyDoc_STRVAR(select_io_uring_accept__doc__,
+"accept($self, fd, /)\n"
+"--\n"
+"\n"
+"Queue the acceptance of a connection on the listening socket fd.\n"
+"\n"
+"The result of the operation is the file descriptor of the new socket,\n"
+"which is non-inheritable.  Return its tag.");
+
+#define SELECT_IO_URING_ACCEPT_METHODDEF    \
+    {"accept", (PyCFunction)select_io_uring_accept, METH_O, select_io_uring_accept__doc__},
+
+static PyObject *
+select_io_uring_accept_impl(pyIoUring_Object *self, int fd);
+
+static PyObject *
+select_io_uring_accept(pyIoUring_Object *self, PyObject *arg)
+{
+    PyObject *return_value = NULL;
+    int fd;
+
+    if (!fildes_converter(arg, &fd)) {
+        goto exit;
+    }
+    return_value = select_io_uring_accept_impl(self, fd);
+
+exit:
+    return return_value;
+}
+
+#endif /* defined(HAVE_IO_URING) */
+
+#if defined(HAVE_IO_URING)
+
+PyDoc_STRVAR(select_io_uring_poll_add__doc__,
+"poll_add($self, fd, eventmask, /)\n"
+"--\n"
+"\n"
+"Queue a wait for one of the events of eventmask on fd.\n"
+"\n"
+"  eventmask\n"
+"    a bit set composed of the various POLL constants\n"
+"\n"
+"The result of the operation is the mask of the events which occurred.\n"
+"Return its tag.");
+
+#define SELECT_IO_URING_POLL_ADD_METHODDEF    \
+    {"poll_add", (PyCFunction)(void(*)(void))select_io_uring_poll_add, METH_FASTCALL, select_io_uring_poll_add__doc__},
+
+static PyObject *
+select_io_uring_poll_add_impl(pyIoUring_Object *self, int fd,
+                              unsigned int eventmask);
+
+static PyObject *
+select_io_uring_poll_add(pyIoUring_Object *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    PyObject *return_value = NULL;
+    int fd;
+    unsigned int eventmask;
+
+    if (!_PyArg_CheckPositional("poll_add", nargs, 2, 2)) {
+        goto exit;
+    }
+    if (!fildes_converter(args[0], &fd)) {
+        goto exit;
+    }
+    eventmask = (unsigned int)PyLong_AsUnsignedLongMask(args[1]);
+    if (eventmask == (unsigned int)-1 && PyErr_Occurred()) {
+        goto exit;
+    }
+    return_value = select_io_uring_poll_add_impl(self, fd, eventmask);
+
+exit:
+    return return_value;
+}
+
+#endif /* defined(HAVE_IO_URING) */
+
+#if defined(HAVE_IO_URING)
+
+PyDoc_STRVAR(select_io_uring_cancel__doc__,
+"cancel($self, tag, /)\n"
+"--\n"
+"\n"
+"Queue the cancellation of the operation with the given tag.\n"
+"\n"
+"If the operation is cancelled, its result is -errno.ECANCELED.  The\n"
+"cancellation itself reports no completion.");
+
+#define SELECT_IO_URING_CANCEL_METHODDEF    \
+    {"cancel", (PyCFunction)select_io_uring_cancel, METH_O, select_io_uring_cancel__doc__},
+
+static PyObject *
+select_io_uring_cancel_impl(pyIoUring_Object *self, unsigned long long tag);
+
+static PyObject *
+select_io_uring_cancel(pyIoUring_Object *self, PyObject *arg)
+{
+    PyObject *return_value = NULL;
+    unsigned long long tag;
+
+    if (!PyLong_Check(arg)) {
+        _PyArg_BadArgument("cancel", "argument", "int", arg);
+        goto exit;
+    }
+    tag = PyLong_AsUnsignedLongLongMask(arg);
+    return_value = select_io_uring_cancel_impl(self, tag);
+
+exit:
+    return return_value;
+}
+
+#endif /* defined(HAVE_IO_URING) */
+
+#if defined(HAVE_IO_URING)
+
+PyDoc_STRVAR(select_io_uring_submit__doc__,
+"submit($self, /)\n"
+"--\n"
+"\n"
+"Submit the queued operations to the kernel.\n"
+"\n"
+"wait() submits them too.  Return the number of operations submitted.");
+
+#define SELECT_IO_URING_SUBMIT_METHODDEF    \
+    {"submit", (PyCFunction)select_io_uring_submit, METH_NOARGS, select_io_uring_submit__doc__},
+
+static PyObject *
+select_io_uring_submit_impl(pyIoUring_Object *self);
+
+static PyObject *
+select_io_uring_submit(pyIoUring_Object *self, PyObject *Py_UNUSED(ignored))
+{
+    return select_io_uring_submit_impl(self);
+}
+
+#endif /* defined(HAVE_IO_URING) */
+
+#if defined(HAVE_IO_URING)
+
+PyDoc_STRVAR(select_io_uring_wait__doc__,
+"wait($self, /, timeout=None, maxevents=-1)\n"
+"--\n"
+"\n"
+"Submit the queued operations and wait for their completion.\n"
+"\n"
+"  timeout\n"
+"    the maximum time to wait in seconds (as float);\n"
+"    a timeout of None or -1 makes wait block indefinitely\n"
+"  maxevents\n"
+"    the maximum number of completions returned; -1 means no limit\n"
+"\n"
+"Returns a list of (tag, result, flags) 3-tuples for the operations which\n"
+"completed.  A negative result is an error number with the sign inverted.");
+
+#define SELECT_IO_URING_WAIT_METHODDEF    \
+    {"wait", (PyCFunction)(void(*)(void))select_io_uring_wait, METH_FASTCALL|METH_KEYWORDS, select_io_uring_wait__doc__},
+
+static PyObject *
+select_io_uring_wait_impl(pyIoUring_Object *self, PyObject *timeout_obj,
+                          int maxevents);
+
+static PyObject *
+select_io_uring_wait(pyIoUring_Object *self, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames)
+{
+    PyObject *return_value = NULL;
+    static const char * const _keywords[] = {"timeout", "maxevents", NULL};
+    static _PyArg_Parser _parser = {NULL, _keywords, "wait", 0};
+    PyObject *argsbuf[2];
+    Py_ssize_t noptargs = nargs + (kwnames ? PyTuple_GET_SIZE(kwnames) : 0) - 0;
+    PyObject *timeout_obj = Py_None;
+    int maxevents = -1;
+
+    args = _PyArg_UnpackKeywords(args, nargs, NULL, kwnames, &_parser, 0, 2, 0, argsbuf);
+    if (!args) {
+        goto exit;
+    }
+    if (!noptargs) {
+        goto skip_optional_pos;
+    }
+    if (args[0]) {
+        timeout_obj = args[0];
+        if (!--noptargs) {
+            goto skip_optional_pos;
+        }
+    }
+    maxevents = _PyLong_AsInt(args[1]);
+    if (maxevents == -1 && PyErr_Occurred()) {
+        goto exit;
+    }
+skip_optional_pos:
+    return_value = select_io_uring_wait_impl(self, timeout_obj, maxevents);
+
+exit:
+    return return_value;
+}
+
+#endif /* defined(HAVE_IO_URING) */
+
+#if defined(HAVE_IO_URING)
+
+PyDoc_STRVAR(select_io_uring___enter____doc__,
+"__enter__($self, /)\n"
+"--\n"
+"\n");
+
+#define SELECT_IO_URING___ENTER___METHODDEF    \
+    {"__enter__", (PyCFunction)select_io_uring___enter__, METH_NOARGS, select_io_uring___enter____doc__},
+
+static PyObject *
+select_io_uring___enter___impl(pyIoUring_Object *self);
+
+static PyObject *
+select_io_uring___enter__(pyIoUring_Object *self, PyObject *Py_UNUSED(ignored))
+{
+    return select_io_uring___enter___impl(self);
+}
+
+#endif /* defined(HAVE_IO_URING) */
+
+#if defined(HAVE_IO_URING)
+
+PyDoc_STRVAR(select_io_uring___exit____doc__,
+"__exit__($self, exc_type=None, exc_value=None, exc_tb=None, /)\n"
+"--\n"
+"\n");
+
+#define SELECT_IO_URING___EXIT___METHODDEF    \
+    {"__exit__", (PyCFunction)(void(*)(void))select_io_uring___exit__, METH_FASTCALL, select_io_uring___exit____doc__},
+
+static PyObject *
+select_io_uring___exit___impl(pyIoUring_Object *self, PyObject *exc_type,
+                              PyObject *exc_value, PyObject *exc_tb);
+
+static PyObject *
+select_io_uring___exit__(pyIoUring_Object *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    PyObject *return_value = NULL;
+    PyObject *exc_type = Py_None;
+    PyObject *exc_value = Py_None;
+    PyObject *exc_tb = Py_None;
+
+    if (!_PyArg_CheckPositional("__exit__", nargs, 0, 3)) {
+        goto exit;
+    }
+    if (nargs < 1) {
+        goto skip_optional;
+    }
+    exc_type = args[0];
+    if (nargs < 2) {
+        goto skip_optional;
+    }
+    exc_value = args[1];
+    if (nargs < 3) {
+        goto skip_optional;
+    }
+    exc_tb = args[2];
+skip_optional:
+    return_value = select_io_uring___exit___impl(self, exc_type, exc_value, exc_tb);
+
+exit:
+    return return_value;
+}
+
+#endif /* defined(HAVE_IO_URING) */
+
 #if defined(HAVE_KQUEUE)
 
 PyDoc_STRVAR(select_kqueue__doc__,
@@ -1160,6 +1738,58 @@ exit:
     #define SELECT_EPOLL___EXIT___METHODDEF
 #endif /* !defined(SELECT_EPOLL___EXIT___METHODDEF) */
 
+#ifndef SELECT_IO_URING_CLOSE_METHODDEF
+    #define SELECT_IO_URING_CLOSE_METHODDEF
+#endif /* !defined(SELECT_IO_URING_CLOSE_METHODDEF) */
+
+#ifndef SELECT_IO_URING_FILENO_METHODDEF
+    #define SELECT_IO_URING_FILENO_METHODDEF
+#endif /* !defined(SELECT_IO_URING_FILENO_METHODDEF) */
+
+#ifndef SELECT_IO_URING_READ_METHODDEF
+    #define SELECT_IO_URING_READ_METHODDEF
+#endif /* !defined(SELECT_IO_URING_READ_METHODDEF) */
+
+#ifndef SELECT_IO_URING_WRITE_METHODDEF
+    #define SELECT_IO_URING_WRITE_METHODDEF
+#endif /* !defined(SELECT_IO_URING_WRITE_METHODDEF) */
+
+#ifndef SELECT_IO_URING_RECV_METHODDEF
+    #define SELECT_IO_URING_RECV_METHODDEF
+#endif /* !defined(SELECT_IO_URING_RECV_METHODDEF) */
+
+#ifndef SELECT_IO_URING_SEND_METHODDEF
+    #define SELECT_IO_URING_SEND_METHODDEF
+#endif /* !defined(SELECT_IO_URING_SEND_METHODDEF) */
+
+#ifndef SELECT_IO_URING_ACCEPT_METHODDEF
+    #define SELECT_IO_URING_ACCEPT_METHODDEF
+#endif /* !defined(SELECT_IO_URING_ACCEPT_METHODDEF) */
+
+#ifndef SELECT_IO_URING_POLL_ADD_METHODDEF
+    #define SELECT_IO_URING_POLL_ADD_METHODDEF
+#endif /* !defined(SELECT_IO_URING_POLL_ADD_METHODDEF) */
+
+#ifndef SELECT_IO_URING_CANCEL_METHODDEF
+    #define SELECT_IO_URING_CANCEL_METHODDEF
+#endif /* !defined(SELECT_IO_URING_CANCEL_METHODDEF) */
+
+#ifndef SELECT_IO_URING_SUBMIT_METHODDEF
+    #define SELECT_IO_URING_SUBMIT_METHODDEF
+#endif /* !defined(SELECT_IO_URING_SUBMIT_METHODDEF) */
+
+#ifndef SELECT_IO_URING_WAIT_METHODDEF
+    #define SELECT_IO_URING_WAIT_METHODDEF
+#endif /* !defined(SELECT_IO_URING_WAIT_METHODDEF) */
+
+#ifndef SELECT_IO_URING___ENTER___METHODDEF
+    #define SELECT_IO_URING___ENTER___METHODDEF
+#endif /* !defined(SELECT_IO_URING___ENTER___METHODDEF) */
+
+#ifndef SELECT_IO_URING___EXIT___METHODDEF
+    #define SELECT_IO_URING___EXIT___METHODDEF
+#endif /* !defined(SELECT_IO_URING___EXIT___METHODDEF) */
+
 #ifndef SELECT_KQUEUE_CLOSE_METHODDEF
     #define SELECT_KQUEUE_CLOSE_METHODDEF
 #endif /* !defined(SELECT_KQUEUE_CLOSE_METHODDEF) */
@@ -1175,4 +1805,4 @@ exit:
 #ifndef SELECT_KQUEUE_CONTROL_METHODDEF
     #define SELECT_KQUEUE_CONTROL_METHODDEF
 #endif /* !defined(SELECT_KQUEUE_CONTROL_METHODDEF) */
-/*[clinic end generated code: output=a055330869acbd16 input=a9049054013a1b77]*/
+/*[clinic end generated code: output=e33bdaeea28375a8 input=a9049054013a1b77]*/
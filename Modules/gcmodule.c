@@ -24,6 +24,7 @@
 */
 
 #include "Python.h"
+#include "frameobject.h"        // PyFrameObject.f_back
 #include "pycore_context.h"
 #include "pycore_initconfig.h"
 #include "pycore_interp.h"      // PyInterpreterState.gc
@@ -117,6 +118,26 @@ gc_decref(PyGC_Head *g)
     g->_gc_prev -= 1 << _PyGC_PREV_SHIFT;
 }
 
+#ifdef _PyGC_PREV_MASK_PENDING
+static inline int
+gc_is_pending(PyGC_Head *g)
+{
+    return (g->_gc_prev & _PyGC_PREV_MASK_PENDING) != 0;
+}
+
+static inline void
+gc_set_pending(PyGC_Head *g)
+{
+    g->_gc_prev |= _PyGC_PREV_MASK_PENDING;
+}
+
+static inline void
+gc_clear_pending(PyGC_Head *g)
+{
+    g->_gc_prev &= ~_PyGC_PREV_MASK_PENDING;
+}
+#endif
+
 /* set for debugging information */
 #define DEBUG_STATS             (1<<0) /* print collection statistics */
 #define DEBUG_COLLECTABLE       (1<<1) /* print collectable objects */
@@ -128,6 +149,12 @@ gc_decref(PyGC_Head *g)
 
 #define GEN_HEAD(gcstate, n) (&(gcstate)->generations[n].head)
 
+/* Phases of the incremental collection of the oldest generation */
+#define GC_INCR_IDLE            0
+#define GC_INCR_FLAG            1
+#define GC_INCR_MARK            2
+#define GC_INCR_SCAN            3
+
 void
 _PyGC_InitState(GCState *gcstate)
 {
@@ -149,6 +176,16 @@ _PyGC_InitState(GCState *gcstate)
            (uintptr_t)&gcstate->permanent_generation.head}, 0, 0
     };
     gcstate->permanent_generation = permanent_generation;
+
+    struct gc_incremental_state *incr = &gcstate->incremental;
+    PyGC_Head *incr_lists[] = {&incr->unflagged, &incr->pending,
+                               &incr->reachable};
+    for (size_t i = 0; i < Py_ARRAY_LENGTH(incr_lists); i++) {
+        incr_lists[i]->_gc_next = (uintptr_t)incr_lists[i];
+        incr_lists[i]->_gc_prev = (uintptr_t)incr_lists[i];
+    }
+    incr->phase = GC_INCR_IDLE;
+    incr->slice = 1000;
 }
 
 
@@ -172,7 +209,7 @@ _gc_prev values
 
 Between collections, _gc_prev is used for doubly linked list.
 
-Lowest two bits of _gc_prev are used for flags.
+Lowest bits of _gc_prev are used for flags.
 PREV_MASK_COLLECTING is used only while collecting and cleared before GC ends
 or _PyObject_GC_UNTRACK() is called.
 
@@ -190,6 +227,12 @@ PREV_MASK_COLLECTING
     Objects in generation being collected are marked PREV_MASK_COLLECTING in
     update_refs().
 
+_PyGC_PREV_MASK_PENDING
+    Objects of the oldest generation which are waiting to be examined by an
+    incremental collection have this flag, see "Incremental collection of
+    the oldest generation" below.  update_refs() and _PyObject_GC_UNTRACK()
+    clear it.
+
 
 _gc_next values
 ---------------
@@ -305,6 +348,27 @@ gc_list_merge(PyGC_Head *from, PyGC_Head *to)
     gc_list_init(from);
 }
 
+/* Move the nodes of list `from` which come before `end` onto the end of list
+ * `to`.  `end` is a node of `from` or `from` itself. */
+static void
+gc_list_move_prefix(PyGC_Head *from, PyGC_Head *end, PyGC_Head *to)
+{
+    PyGC_Head *first = GC_NEXT(from);
+    if (first == end) {
+        return;
+    }
+    PyGC_Head *last = GC_PREV(end);
+
+    _PyGCHead_SET_NEXT(from, end);
+    _PyGCHead_SET_PREV(end, from);
+
+    PyGC_Head *to_tail = GC_PREV(to);
+    _PyGCHead_SET_NEXT(to_tail, first);
+    _PyGCHead_SET_PREV(first, to_tail);
+    _PyGCHead_SET_NEXT(last, to);
+    _PyGCHead_SET_PREV(to, last);
+}
+
 static Py_ssize_t
 gc_list_size(PyGC_Head *list)
 {
@@ -344,6 +408,22 @@ append_objects(PyObject *py_list, PyGC_Head *gc_list)
     return 0;
 }
 
+/* Append the objects of the oldest generation which are held by the
+ * incremental collection in progress to a Python list.
+ * Return 0 if all OK, < 0 if error (out of memory for list)
+ */
+static int
+append_incremental_objects(PyObject *py_list, GCState *gcstate)
+{
+    struct gc_incremental_state *incr = &gcstate->incremental;
+    if (append_objects(py_list, &incr->unflagged) ||
+        append_objects(py_list, &incr->pending) ||
+        append_objects(py_list, &incr->reachable)) {
+        return -1;
+    }
+    return 0;
+}
+
 // Constants for validate_list's flags argument.
 enum flagstates {collecting_clear_unreachable_clear,
                  collecting_clear_unreachable_set,
@@ -1053,6 +1133,17 @@ show_stats_each_generations(GCState *gcstate)
         buf, gc_list_size(&gcstate->permanent_generation.head));
 }
 
+/* Add the time elapsed since 'start' to the duration of 'phase' and return
+   the current time. */
+static _PyTime_t
+timing_add_phase(struct gc_collection_timing *timing, int phase,
+                 _PyTime_t start)
+{
+    _PyTime_t now = _PyTime_GetPerfCounter();
+    timing->phases[phase] += now - start;
+    return now;
+}
+
 /* Deduce which objects among "base" are unreachable from outside the list
    and move them to 'unreachable'. The process consist in the following steps:
 
@@ -1075,13 +1166,21 @@ Contracts:
     * The "unreachable" list must be uninitialized (this function calls
       gc_list_init over 'unreachable').
 
+    * If "timing" is not NULL, the durations of steps 1 and 2 and of step 3
+      are added to its refcounts and reachability phases.
+
 IMPORTANT: This function leaves 'unreachable' with the NEXT_MASK_UNREACHABLE
 flag set but it does not clear it to skip unnecessary iteration. Before the
 flag is cleared (for example, by using 'clear_unreachable_mask' function or
 by a call to 'move_legacy_finalizers'), the 'unreachable' list is not a normal
 list and we can not use most gc_list_* functions for it. */
 static inline void
-deduce_unreachable(PyGC_Head *base, PyGC_Head *unreachable) {
+deduce_unreachable(PyGC_Head *base, PyGC_Head *unreachable,
+                   struct gc_collection_timing *timing) {
+    _PyTime_t t = 0;
+    if (timing != NULL) {
+        t = _PyTime_GetPerfCounter();
+    }
     validate_list(base, collecting_clear_unreachable_clear);
     /* Using ob_refcnt and gc_refs, calculate which objects in the
      * container set are reachable from outside the set (i.e., have a
@@ -1090,6 +1189,9 @@ deduce_unreachable(PyGC_Head *base, PyGC_Head *unreachable) {
      */
     update_refs(base);  // gc_prev is used for gc_refs
     subtract_refs(base);
+    if (timing != NULL) {
+        t = timing_add_phase(timing, _PyGC_PHASE_REFCOUNTS, t);
+    }
 
     /* Leave everything reachable from outside base in base, and move
      * everything else (in base) to unreachable.
@@ -1128,10 +1230,549 @@ deduce_unreachable(PyGC_Head *base, PyGC_Head *unreachable) {
      */
     gc_list_init(unreachable);
     move_unreachable(base, unreachable);  // gc_prev is pointer again
+    if (timing != NULL) {
+        timing_add_phase(timing, _PyGC_PHASE_REACHABILITY, t);
+    }
+    validate_list(base, collecting_clear_unreachable_clear);
+    validate_list(unreachable, collecting_set_unreachable_set);
+}
+
+/* Parallel marking of full collections
+   =====================================
+
+When gc.set_parallel() sets more than one worker, full collections of large
+heaps compute the gc_refs and the reachable objects with helper threads.
+Nothing else runs during a collection, so tp_traverse can safely be called
+from several threads at once: it only reads the objects.
+
+update_refs() runs in the collecting thread and splits the list into chunks
+of GC_PARALLEL_CHUNK objects.  Each worker owns a range of chunks, and takes
+chunks from the front of its range, then from the front of the ranges of the
+other workers once its own range is exhausted.  Both phases run over the
+chunks:
+
+subtract_refs
+    Each worker traverses the objects of its chunks and decrements the
+    gc_refs of their referents with atomic operations.
+
+move_unreachable
+    Each worker looks for objects with positive gc_refs in its chunks and
+    marks everything reachable from them by clearing PREV_MASK_COLLECTING
+    with an atomic operation, using a mark stack.  Since most of the heap is
+    usually reachable from a few roots, a worker whose mark stack is large
+    moves its bottom half to a shared stack when other workers are idle.
+    The marking is over when no worker has anything left to do.  The
+    collecting thread then moves the objects still flagged with
+    PREV_MASK_COLLECTING to 'unreachable' and restores the _gc_prev pointers,
+    producing the same lists as move_unreachable().
+
+The helper threads have no thread state and must not use the Python
+allocators: even PyMem_RawMalloc() can take the GIL when tracemalloc is
+tracing.  They are started for each full collection, which is cheap compared
+to the collections which are worth parallelizing.
+*/
+
+/* Parallel marking needs atomic read-modify-write operations on _gc_prev */
+#if defined(HAVE_BUILTIN_ATOMIC) && defined(HAVE_SCHED_H)
+#  define GC_PARALLEL
+#endif
+
+/* Upper bound of gc.set_parallel() */
+#define GC_PARALLEL_MAX_WORKERS 1024
+
+#ifdef GC_PARALLEL
+
+#include <sched.h>              // sched_yield()
+
+/* Number of objects of a chunk */
+#define GC_PARALLEL_CHUNK       1024
+/* Smaller generations are not worth starting threads */
+#define GC_PARALLEL_MIN_CHUNKS  16
+/* Most mark stack entries moved to or from the shared stack at once */
+#define GC_PARALLEL_SHARE       256
+
+struct gc_parallel;
+
+struct gc_worker {
+    struct gc_parallel *par;
+    /* The chunks owned by the worker are chunks[next:end].  The worker and
+       the other workers take them by incrementing 'next' atomically. */
+    Py_ssize_t next;
+    Py_ssize_t end;
+    /* Mark stack, allocated with malloc() */
+    PyGC_Head **stack;
+    Py_ssize_t size;
+    Py_ssize_t capacity;
+};
+
+struct gc_parallel {
+    int nworkers;
+    struct gc_worker *workers;
+    /* First object of each chunk; the last chunk ends at 'list' */
+    PyGC_Head **chunks;
+    Py_ssize_t nchunks;
+    PyGC_Head *list;
+    void (*func)(struct gc_worker *);
+    /* Mark stack entries given away for idle workers, allocated with
+       malloc() and protected by 'mutex'.  'nshared' is also read
+       atomically without the mutex. */
+    PyThread_type_lock mutex;
+    PyGC_Head **shared;
+    Py_ssize_t nshared;
+    Py_ssize_t shared_capacity;
+    /* Number of workers which are not waiting for work */
+    int active;
+    /* Number of helper threads which have not returned yet; the last one
+       releases 'done' */
+    int running;
+    PyThread_type_lock done;
+    /* Set if a mark stack could not grow */
+    int overflow;
+};
+
+#define ATOMIC_LOAD(p) __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define ATOMIC_LOAD_RELAXED(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+
+/* Take a chunk from the range of the worker, or from the range of another
+   worker.  Return its index, or -1 if all the chunks have been taken. */
+static Py_ssize_t
+parallel_take_chunk(struct gc_worker *w)
+{
+    struct gc_parallel *par = w->par;
+    int self = (int)(w - par->workers);
+    for (int i = 0; i < par->nworkers; i++) {
+        struct gc_worker *owner = &par->workers[(self + i) % par->nworkers];
+        if (ATOMIC_LOAD_RELAXED(&owner->next) < owner->end) {
+            Py_ssize_t c = __atomic_fetch_add(&owner->next, 1,
+                                              __ATOMIC_RELAXED);
+            if (c < owner->end) {
+                return c;
+            }
+        }
+    }
+    return -1;
+}
+
+static inline PyGC_Head *
+parallel_chunk_end(struct gc_parallel *par, Py_ssize_t c)
+{
+    return c + 1 < par->nchunks ? par->chunks[c + 1] : par->list;
+}
+
+/* A traversal callback for parallel_subtract_refs. */
+static int
+visit_decref_atomic(PyObject *op, void *parent)
+{
+    _PyObject_ASSERT(_PyObject_CAST(parent), !_PyObject_IsFreed(op));
+
+    if (_PyObject_IS_GC(op)) {
+        PyGC_Head *gc = AS_GC(op);
+        if (ATOMIC_LOAD_RELAXED(&gc->_gc_prev) & PREV_MASK_COLLECTING) {
+            __atomic_fetch_sub(&gc->_gc_prev,
+                               (uintptr_t)1 << _PyGC_PREV_SHIFT,
+                               __ATOMIC_RELAXED);
+        }
+    }
+    return 0;
+}
+
+/* subtract_refs() of the chunks taken by a worker. */
+static void
+parallel_subtract_refs(struct gc_worker *w)
+{
+    struct gc_parallel *par = w->par;
+    Py_ssize_t c;
+    while ((c = parallel_take_chunk(w)) >= 0) {
+        PyGC_Head *end = parallel_chunk_end(par, c);
+        for (PyGC_Head *gc = par->chunks[c]; gc != end; gc = GC_NEXT(gc)) {
+            PyObject *op = FROM_GC(gc);
+            (void) Py_TYPE(op)->tp_traverse(op, visit_decref_atomic, op);
+        }
+    }
+}
+
+/* Mark gc as reachable.  Return 1 if it was not marked yet, which makes the
+   caller responsible for traversing it. */
+static inline int
+parallel_mark(PyGC_Head *gc)
+{
+    if (!(ATOMIC_LOAD_RELAXED(&gc->_gc_prev) & PREV_MASK_COLLECTING)) {
+        return 0;
+    }
+    uintptr_t prev = __atomic_fetch_and(&gc->_gc_prev,
+                                        ~(uintptr_t)PREV_MASK_COLLECTING,
+                                        __ATOMIC_RELAXED);
+    return (prev & PREV_MASK_COLLECTING) != 0;
+}
+
+/* Ensure that the mark stack of w can hold n more entries. */
+static int
+parallel_reserve(struct gc_worker *w, Py_ssize_t n)
+{
+    if (w->size + n <= w->capacity) {
+        return 0;
+    }
+    Py_ssize_t capacity = Py_MAX(w->capacity * 2, w->size + n);
+    capacity = Py_MAX(capacity, 2 * GC_PARALLEL_SHARE);
+    if ((size_t)capacity > PY_SSIZE_T_MAX / sizeof(PyGC_Head *)) {
+        return -1;
+    }
+    PyGC_Head **stack = realloc(w->stack, capacity * sizeof(PyGC_Head *));
+    if (stack == NULL) {
+        return -1;
+    }
+    w->stack = stack;
+    w->capacity = capacity;
+    return 0;
+}
+
+/* Move the bottom half of the mark stack of w to the shared stack. */
+static void
+parallel_share(struct gc_worker *w)
+{
+    struct gc_parallel *par = w->par;
+    Py_ssize_t n = Py_MIN(w->size / 2, GC_PARALLEL_SHARE);
+
+    PyThread_acquire_lock(par->mutex, WAIT_LOCK);
+    if (par->nshared + n > par->shared_capacity) {
+        Py_ssize_t capacity = Py_MAX(par->shared_capacity * 2,
+                                     par->nshared + n);
+        PyGC_Head **shared = realloc(par->shared,
+                                     capacity * sizeof(PyGC_Head *));
+        if (shared == NULL) {
+            PyThread_release_lock(par->mutex);
+            return;
+        }
+        par->shared = shared;
+        par->shared_capacity = capacity;
+    }
+    memcpy(par->shared + par->nshared, w->stack, n * sizeof(PyGC_Head *));
+    __atomic_store_n(&par->nshared, par->nshared + n, __ATOMIC_SEQ_CST);
+    PyThread_release_lock(par->mutex);
+
+    memmove(w->stack, w->stack + n, (w->size - n) * sizeof(PyGC_Head *));
+    w->size -= n;
+}
+
+/* Move entries of the shared stack to the empty mark stack of w.  Return
+   the number of entries taken. */
+static Py_ssize_t
+parallel_take_shared(struct gc_worker *w)
+{
+    struct gc_parallel *par = w->par;
+    assert(w->size == 0);
+    if (ATOMIC_LOAD(&par->nshared) == 0) {
+        return 0;
+    }
+    PyThread_acquire_lock(par->mutex, WAIT_LOCK);
+    Py_ssize_t n = Py_MIN(par->nshared, GC_PARALLEL_SHARE);
+    if (parallel_reserve(w, n) < 0) {
+        /* Drop the entries, see parallel_mark_overflow() */
+        __atomic_store_n(&par->overflow, 1, __ATOMIC_RELAXED);
+        __atomic_store_n(&par->nshared, 0, __ATOMIC_SEQ_CST);
+        PyThread_release_lock(par->mutex);
+        return 0;
+    }
+    par->nshared -= n;
+    memcpy(w->stack, par->shared + par->nshared, n * sizeof(PyGC_Head *));
+    __atomic_store_n(&par->nshared, par->nshared, __ATOMIC_SEQ_CST);
+    PyThread_release_lock(par->mutex);
+    w->size = n;
+    return n;
+}
+
+static void
+parallel_push(struct gc_worker *w, PyGC_Head *gc)
+{
+    if (parallel_reserve(w, 1) < 0) {
+        /* gc stays marked without having been traversed, see
+           parallel_mark_overflow() */
+        __atomic_store_n(&w->par->overflow, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    w->stack[w->size++] = gc;
+    if (w->size >= 2 * GC_PARALLEL_SHARE
+        && ATOMIC_LOAD_RELAXED(&w->par->active) < w->par->nworkers
+        && ATOMIC_LOAD_RELAXED(&w->par->nshared) == 0)
+    {
+        parallel_share(w);
+    }
+}
+
+/* A traversal callback for parallel_move_reachable. */
+static int
+visit_mark(PyObject *op, struct gc_worker *w)
+{
+    if (_PyObject_IS_GC(op)) {
+        PyGC_Head *gc = AS_GC(op);
+        if (parallel_mark(gc)) {
+            parallel_push(w, gc);
+        }
+    }
+    return 0;
+}
+
+/* Traverse the objects of the mark stack of w until it is empty. */
+static void
+parallel_drain(struct gc_worker *w)
+{
+    while (w->size > 0) {
+        PyObject *op = FROM_GC(w->stack[--w->size]);
+        (void) Py_TYPE(op)->tp_traverse(op, (visitproc)visit_mark, w);
+    }
+}
+
+/* Mark the objects reachable from the objects with positive gc_refs. */
+static void
+parallel_move_reachable(struct gc_worker *w)
+{
+    struct gc_parallel *par = w->par;
+    for (;;) {
+        Py_ssize_t c;
+        while ((c = parallel_take_chunk(w)) >= 0) {
+            PyGC_Head *end = parallel_chunk_end(par, c);
+            for (PyGC_Head *gc = par->chunks[c]; gc != end; gc = GC_NEXT(gc)) {
+                uintptr_t prev = ATOMIC_LOAD_RELAXED(&gc->_gc_prev);
+                if ((prev >> _PyGC_PREV_SHIFT) != 0 && parallel_mark(gc)) {
+                    parallel_push(w, gc);
+                    parallel_drain(w);
+                }
+            }
+        }
+        if (parallel_take_shared(w)) {
+            parallel_drain(w);
+            continue;
+        }
+
+        /* All the chunks are taken: wait for shared entries until all the
+           workers are idle.  Only active workers share entries, and they
+           look at the shared stack before leaving, so no entry is left. */
+        __atomic_fetch_sub(&par->active, 1, __ATOMIC_SEQ_CST);
+        for (;;) {
+            if (ATOMIC_LOAD(&par->nshared) > 0) {
+                __atomic_fetch_add(&par->active, 1, __ATOMIC_SEQ_CST);
+                if (parallel_take_shared(w)) {
+                    break;
+                }
+                __atomic_fetch_sub(&par->active, 1, __ATOMIC_SEQ_CST);
+            }
+            if (ATOMIC_LOAD(&par->active) == 0) {
+                return;
+            }
+            sched_yield();
+        }
+        parallel_drain(w);
+    }
+}
+
+/* Entry point of the helper threads */
+static void
+parallel_helper(void *arg)
+{
+    struct gc_worker *w = (struct gc_worker *)arg;
+    struct gc_parallel *par = w->par;
+    PyThread_type_lock done = par->done;
+
+    par->func(w);
+    /* par may go away as soon as the last helper decrements 'running' */
+    if (__atomic_sub_fetch(&par->running, 1, __ATOMIC_ACQ_REL) == 0) {
+        PyThread_release_lock(done);
+    }
+}
+
+/* Run func in all the workers, worker 0 being the current thread, and wait
+   until they all return.  The chunks are divided evenly between the
+   workers. */
+static void
+parallel_run(struct gc_parallel *par, void (*func)(struct gc_worker *))
+{
+    for (int i = 0; i < par->nworkers; i++) {
+        par->workers[i].next = par->nchunks * i / par->nworkers;
+        par->workers[i].end = par->nchunks * (i + 1) / par->nworkers;
+    }
+    par->func = func;
+    par->active = par->nworkers;
+    par->running = par->nworkers - 1;
+
+    PyThread_acquire_lock(par->done, WAIT_LOCK);
+    for (int i = 1; i < par->nworkers; i++) {
+        if (PyThread_start_new_thread(parallel_helper, &par->workers[i])
+            == PYTHREAD_INVALID_THREAD_ID)
+        {
+            /* The other workers take the chunks of the missing one */
+            __atomic_fetch_sub(&par->active, 1, __ATOMIC_SEQ_CST);
+            if (__atomic_sub_fetch(&par->running, 1, __ATOMIC_ACQ_REL) == 0) {
+                PyThread_release_lock(par->done);
+            }
+        }
+    }
+    func(&par->workers[0]);
+    PyThread_acquire_lock(par->done, WAIT_LOCK);
+    PyThread_release_lock(par->done);
+}
+
+/* A traversal callback for parallel_mark_overflow. */
+static int
+visit_mark_overflow(PyObject *op, int *marked)
+{
+    if (_PyObject_IS_GC(op)) {
+        PyGC_Head *gc = AS_GC(op);
+        if (gc_is_collecting(gc)) {
+            gc_clear_collecting(gc);
+            *marked = 1;
+        }
+    }
+    return 0;
+}
+
+/* Some objects were marked but not traversed because a mark stack could not
+   grow: traverse all the marked objects until no new object gets marked. */
+static void
+parallel_mark_overflow(PyGC_Head *young)
+{
+    int marked = 1;
+    while (marked) {
+        marked = 0;
+        for (PyGC_Head *gc = GC_NEXT(young); gc != young; gc = GC_NEXT(gc)) {
+            if (!gc_is_collecting(gc)) {
+                PyObject *op = FROM_GC(gc);
+                (void) Py_TYPE(op)->tp_traverse(
+                    op, (visitproc)visit_mark_overflow, &marked);
+            }
+        }
+    }
+}
+
+/* Move the objects which were not marked to unreachable, leaving young and
+   unreachable in the state move_unreachable() leaves them. */
+static void
+parallel_move_unreachable(PyGC_Head *young, PyGC_Head *unreachable)
+{
+    PyGC_Head *prev = young;
+    PyGC_Head *gc = GC_NEXT(young);
+    while (gc != young) {
+        PyGC_Head *next = GC_NEXT(gc);
+        if (gc_is_collecting(gc)) {
+            // Same as the unreachable branch of move_unreachable()
+            prev->_gc_next = gc->_gc_next;
+            PyGC_Head *last = GC_PREV(unreachable);
+            last->_gc_next = (NEXT_MASK_UNREACHABLE | (uintptr_t)gc);
+            _PyGCHead_SET_PREV(gc, last);
+            gc->_gc_next = (NEXT_MASK_UNREACHABLE | (uintptr_t)unreachable);
+            unreachable->_gc_prev = (uintptr_t)gc;
+        }
+        else {
+            _PyGCHead_SET_PREV(gc, prev);
+            prev = gc;
+        }
+        gc = next;
+    }
+    young->_gc_prev = (uintptr_t)prev;
+    unreachable->_gc_next &= ~NEXT_MASK_UNREACHABLE;
+}
+
+/* update_refs() which also stores the first object of every chunk of 'base'
+   in par->chunks.  Return -1 if the chunks could not be allocated, after
+   updating the refs all the same. */
+static int
+parallel_update_refs(struct gc_parallel *par, PyGC_Head *base)
+{
+    Py_ssize_t capacity = 0;
+    Py_ssize_t i = 0;
+    int err = 0;
+    par->chunks = NULL;
+    par->nchunks = 0;
+    for (PyGC_Head *gc = GC_NEXT(base); gc != base; gc = GC_NEXT(gc), i++) {
+        gc_reset_refs(gc, Py_REFCNT(FROM_GC(gc)));
+        // See update_refs()
+        _PyObject_ASSERT(FROM_GC(gc), gc_get_refs(gc) != 0);
+        if (i % GC_PARALLEL_CHUNK != 0 || err) {
+            continue;
+        }
+        if (par->nchunks == capacity) {
+            capacity = Py_MAX(capacity * 2, 64);
+            PyGC_Head **chunks = PyMem_RawRealloc(
+                par->chunks, capacity * sizeof(PyGC_Head *));
+            if (chunks == NULL) {
+                err = -1;
+                continue;
+            }
+            par->chunks = chunks;
+        }
+        par->chunks[par->nchunks++] = gc;
+    }
+    par->list = base;
+    return err;
+}
+
+/* deduce_unreachable() for full collections, parallelized with helper
+   threads when the generation is large enough. */
+static void
+deduce_unreachable_parallel(GCState *gcstate, PyGC_Head *base,
+                            PyGC_Head *unreachable,
+                            struct gc_collection_timing *timing)
+{
+    struct gc_parallel par;
+    memset(&par, 0, sizeof(par));
+
+    if (gcstate->parallel.mutex == NULL) {
+        gcstate->parallel.mutex = PyThread_allocate_lock();
+    }
+    if (gcstate->parallel.done == NULL) {
+        gcstate->parallel.done = PyThread_allocate_lock();
+    }
+    if (gcstate->parallel.mutex == NULL || gcstate->parallel.done == NULL) {
+        deduce_unreachable(base, unreachable, timing);
+        return;
+    }
+
+    _PyTime_t t = _PyTime_GetPerfCounter();
+    validate_list(base, collecting_clear_unreachable_clear);
+    int err = parallel_update_refs(&par, base);
+    par.nworkers = (int)Py_MIN(gcstate->parallel.nworkers, par.nchunks);
+    if (err == 0 && par.nchunks >= GC_PARALLEL_MIN_CHUNKS) {
+        par.workers = PyMem_RawCalloc(par.nworkers, sizeof(struct gc_worker));
+    }
+    if (par.workers == NULL) {
+        PyMem_RawFree(par.chunks);
+        subtract_refs(base);
+        t = timing_add_phase(timing, _PyGC_PHASE_REFCOUNTS, t);
+        gc_list_init(unreachable);
+        move_unreachable(base, unreachable);
+        timing_add_phase(timing, _PyGC_PHASE_REACHABILITY, t);
+        validate_list(base, collecting_clear_unreachable_clear);
+        validate_list(unreachable, collecting_set_unreachable_set);
+        return;
+    }
+    for (int i = 0; i < par.nworkers; i++) {
+        par.workers[i].par = &par;
+    }
+    par.mutex = gcstate->parallel.mutex;
+    par.done = gcstate->parallel.done;
+
+    parallel_run(&par, parallel_subtract_refs);
+    t = timing_add_phase(timing, _PyGC_PHASE_REFCOUNTS, t);
+
+    parallel_run(&par, parallel_move_reachable);
+    if (par.overflow) {
+        parallel_mark_overflow(base);
+    }
+    gc_list_init(unreachable);
+    parallel_move_unreachable(base, unreachable);
+    timing_add_phase(timing, _PyGC_PHASE_REACHABILITY, t);
+
+    for (int i = 0; i < par.nworkers; i++) {
+        free(par.workers[i].stack);
+    }
+    free(par.shared);
+    PyMem_RawFree(par.workers);
+    PyMem_RawFree(par.chunks);
     validate_list(base, collecting_clear_unreachable_clear);
     validate_list(unreachable, collecting_set_unreachable_set);
 }
 
+#endif  /* GC_PARALLEL */
+
 /* Handle objects that may have resurrected after a call to 'finalize_garbage', moving
    them to 'old_generation' and placing the rest on 'still_unreachable'.
 
@@ -1157,83 +1798,30 @@ handle_resurrected_objects(PyGC_Head *unreachable, PyGC_Head* still_unreachable,
     // have the PREV_MARK_COLLECTING set, but the objects are going to be
     // removed so we can skip the expense of clearing the flag.
     PyGC_Head* resurrected = unreachable;
-    deduce_unreachable(resurrected, still_unreachable);
+    deduce_unreachable(resurrected, still_unreachable, NULL);
     clear_unreachable_mask(still_unreachable);
 
     // Move the resurrected objects to the old generation for future collection.
     gc_list_merge(resurrected, old_generation);
 }
 
-/* This is the main function.  Read this to understand how the
- * collection process works. */
+/* Delete the objects in 'unreachable', found by deduce_unreachable(), or
+ * append them to gc.garbage if they can't be deleted safely.  Objects
+ * resurrected by their finalizers and weakrefs whose callbacks must be called
+ * are moved to 'old'.  Return the number of collected objects and store the
+ * number of uncollectable objects in *n_uncollectable.  The durations of the
+ * weakrefs, finalizers and deletion phases are added to 'timing'.
+ */
 static Py_ssize_t
-collect(PyThreadState *tstate, int generation,
-        Py_ssize_t *n_collected, Py_ssize_t *n_uncollectable, int nofail)
+handle_unreachable(PyThreadState *tstate, GCState *gcstate,
+                   PyGC_Head *unreachable, PyGC_Head *old,
+                   Py_ssize_t *n_uncollectable,
+                   struct gc_collection_timing *timing)
 {
-    int i;
     Py_ssize_t m = 0; /* # objects collected */
     Py_ssize_t n = 0; /* # unreachable objects that couldn't be collected */
-    PyGC_Head *young; /* the generation we are examining */
-    PyGC_Head *old; /* next older generation */
-    PyGC_Head unreachable; /* non-problematic unreachable trash */
     PyGC_Head finalizers;  /* objects with, & reachable from, __del__ */
     PyGC_Head *gc;
-    _PyTime_t t1 = 0;   /* initialize to prevent a compiler warning */
-    GCState *gcstate = &tstate->interp->gc;
-
-#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
-    if (tstate->interp->config._isolated_interpreter) {
-        // bpo-40533: The garbage collector must not be run on parallel on
-        // Python objects shared by multiple interpreters.
-        return 0;
-    }
-#endif
-
-    if (gcstate->debug & DEBUG_STATS) {
-        PySys_WriteStderr("gc: collecting generation %d...\n", generation);
-        show_stats_each_generations(gcstate);
-        t1 = _PyTime_GetMonotonicClock();
-    }
-
-    if (PyDTrace_GC_START_ENABLED())
-        PyDTrace_GC_START(generation);
-
-    /* update collection and allocation counters */
-    if (generation+1 < NUM_GENERATIONS)
-        gcstate->generations[generation+1].count += 1;
-    for (i = 0; i <= generation; i++)
-        gcstate->generations[i].count = 0;
-
-    /* merge younger generations with one we are currently collecting */
-    for (i = 0; i < generation; i++) {
-        gc_list_merge(GEN_HEAD(gcstate, i), GEN_HEAD(gcstate, generation));
-    }
-
-    /* handy references */
-    young = GEN_HEAD(gcstate, generation);
-    if (generation < NUM_GENERATIONS-1)
-        old = GEN_HEAD(gcstate, generation+1);
-    else
-        old = young;
-    validate_list(old, collecting_clear_unreachable_clear);
-
-    deduce_unreachable(young, &unreachable);
-
-    untrack_tuples(young);
-    /* Move reachable objects to next generation. */
-    if (young != old) {
-        if (generation == NUM_GENERATIONS - 2) {
-            gcstate->long_lived_pending += gc_list_size(young);
-        }
-        gc_list_merge(young, old);
-    }
-    else {
-        /* We only un-track dicts in full collections, to avoid quadratic
-           dict build-up. See issue #14775. */
-        untrack_dicts(young);
-        gcstate->long_lived_pending = 0;
-        gcstate->long_lived_total = gc_list_size(young);
-    }
 
     /* All objects in unreachable are trash, but objects reachable from
      * legacy finalizers (e.g. tp_del) can't safely be deleted.
@@ -1241,7 +1829,7 @@ collect(PyThreadState *tstate, int generation,
     gc_list_init(&finalizers);
     // NEXT_MASK_UNREACHABLE is cleared here.
     // After move_legacy_finalizers(), unreachable is normal list.
-    move_legacy_finalizers(&unreachable, &finalizers);
+    move_legacy_finalizers(unreachable, &finalizers);
     /* finalizers contains the unreachable objects with a legacy finalizer;
      * unreachable objects reachable *from* those are also uncollectable,
      * and we move those into the finalizers list too.
@@ -1249,29 +1837,32 @@ collect(PyThreadState *tstate, int generation,
     move_legacy_finalizer_reachable(&finalizers);
 
     validate_list(&finalizers, collecting_clear_unreachable_clear);
-    validate_list(&unreachable, collecting_set_unreachable_clear);
+    validate_list(unreachable, collecting_set_unreachable_clear);
 
     /* Print debugging information. */
     if (gcstate->debug & DEBUG_COLLECTABLE) {
-        for (gc = GC_NEXT(&unreachable); gc != &unreachable; gc = GC_NEXT(gc)) {
+        for (gc = GC_NEXT(unreachable); gc != unreachable; gc = GC_NEXT(gc)) {
             debug_cycle("collectable", FROM_GC(gc));
         }
     }
 
     /* Clear weakrefs and invoke callbacks as necessary. */
-    m += handle_weakrefs(&unreachable, old);
+    _PyTime_t t = _PyTime_GetPerfCounter();
+    m += handle_weakrefs(unreachable, old);
+    t = timing_add_phase(timing, _PyGC_PHASE_WEAKREFS, t);
 
     validate_list(old, collecting_clear_unreachable_clear);
-    validate_list(&unreachable, collecting_set_unreachable_clear);
+    validate_list(unreachable, collecting_set_unreachable_clear);
 
     /* Call tp_finalize on objects which have one. */
-    finalize_garbage(tstate, &unreachable);
+    finalize_garbage(tstate, unreachable);
 
     /* Handle any objects that may have resurrected after the call
      * to 'finalize_garbage' and continue the collection with the
      * objects that are still unreachable */
     PyGC_Head final_unreachable;
-    handle_resurrected_objects(&unreachable, &final_unreachable, old);
+    handle_resurrected_objects(unreachable, &final_unreachable, old);
+    t = timing_add_phase(timing, _PyGC_PHASE_FINALIZERS, t);
 
     /* Call tp_clear on objects in the final_unreachable set.  This will cause
     * the reference cycles to be broken.  It may also cause some objects
@@ -1279,6 +1870,7 @@ collect(PyThreadState *tstate, int generation,
     */
     m += gc_list_size(&final_unreachable);
     delete_garbage(tstate, gcstate, &final_unreachable, old);
+    timing_add_phase(timing, _PyGC_PHASE_DELETION, t);
 
     /* Collect statistics on uncollectable objects found and print
      * debugging information. */
@@ -1287,26 +1879,456 @@ collect(PyThreadState *tstate, int generation,
         if (gcstate->debug & DEBUG_UNCOLLECTABLE)
             debug_cycle("uncollectable", FROM_GC(gc));
     }
+
+    /* Append instances in the uncollectable set to a Python
+     * reachable list of garbage.  The programmer has to deal with
+     * this if they insist on creating this type of structure.
+     */
+    handle_legacy_finalizers(tstate, gcstate, &finalizers, old);
+    validate_list(old, collecting_clear_unreachable_clear);
+
+    *n_uncollectable = n;
+    return m;
+}
+
+/* Add the durations of a collection, or of an increment of an incremental
+ * collection, to the statistics of its generation. */
+static void
+record_timing(struct gc_generation_stats *stats,
+              const struct gc_collection_timing *timing)
+{
+    stats->timing.total += timing->total;
+    for (int i = 0; i < _PyGC_NUM_PHASES; i++) {
+        stats->timing.phases[i] += timing->phases[i];
+    }
+
+    /* Bucket i counts the pauses of 2**(i-1) to 2**i microseconds */
+    _PyTime_t us = _PyTime_AsMicroseconds(timing->total, _PyTime_ROUND_FLOOR);
+    int bucket = 0;
+    while (us > 0 && bucket < _PyGC_PAUSE_BUCKETS - 1) {
+        us >>= 1;
+        bucket++;
+    }
+    stats->pauses[bucket]++;
+}
+
+/* Incremental collection of the oldest generation
+   ================================================
+
+A full collection examines all the objects of the oldest generation at once,
+which takes seconds with very large heaps.  When gc.set_incremental() sets a
+pause budget, automatic collections of the oldest generation are instead
+spread over many increments.  Each increment runs after an automatic
+collection of the middle generation and lasts about the budget.
+
+At the start of an incremental collection, all objects of the oldest
+generation are moved to the 'unflagged' list, and they go back to the oldest
+generation as they are examined.  Objects promoted meanwhile from the younger
+generations stay in the oldest generation: the next incremental collection
+examines them.  Since there are no write barriers, nothing is known about
+the mutations done between two increments, so each increment must be
+correct on its own.  The collection goes through these phases:
+
+GC_INCR_FLAG
+    The objects of 'unflagged' get the _PyGC_PREV_MASK_PENDING flag and are
+    moved to 'pending'.  The flag tells the next phases in constant time
+    whether an object is still waiting to be examined.
+
+GC_INCR_MARK
+    Pending objects transitively reachable from the roots of the interpreter
+    (sys.modules, the sys and builtins dicts and the frames of all threads)
+    go back to the oldest generation.  They were alive when they were
+    reached, and if they die later they are left to the next collection.
+    Marking is not required for correctness, but most objects of a large heap
+    are reachable from the modules and marking them is much cheaper than
+    computing their gc_refs.
+
+GC_INCR_SCAN
+    Each increment takes a slice of the pending objects, adds all pending
+    objects transitively reachable from them and collects the result as if it
+    were a young generation: references from outside the increment keep its
+    objects alive, so an increment never deletes a live object.  Since an
+    increment is closed over the pending objects, a garbage cycle made of
+    pending objects always ends up in a single increment.
+
+The number of objects taken by a slice adapts to the measured duration of
+the previous increments.  The budget is a target rather than a hard limit:
+the closure of a slice can be much larger than the slice itself.
+
+The pending flag needs a third free bit in _gc_prev pointers, so incremental
+collections are only supported on 64-bit platforms.
+*/
+
+/* Number of objects processed between two reads of the clock */
+#define GC_INCR_FLAG_CHUNK      4096
+#define GC_INCR_MARK_CHUNK      256
+/* Bounds of the number of objects taken by a slice */
+#define GC_INCR_MIN_SLICE       64
+#define GC_INCR_MAX_SLICE       (1 << 20)
+
+/* Abandon the incremental collection in progress, if any, and put the
+   objects it still holds back into the oldest generation. */
+static void
+incremental_abort(GCState *gcstate)
+{
+    struct gc_incremental_state *incr = &gcstate->incremental;
+    if (incr->phase == GC_INCR_IDLE) {
+        return;
+    }
+#ifdef _PyGC_PREV_MASK_PENDING
+    for (PyGC_Head *gc = GC_NEXT(&incr->pending);
+         gc != &incr->pending; gc = GC_NEXT(gc)) {
+        gc_clear_pending(gc);
+    }
+#endif
+    PyGC_Head *old = GEN_HEAD(gcstate, NUM_GENERATIONS-1);
+    gc_list_merge(&incr->unflagged, old);
+    gc_list_merge(&incr->pending, old);
+    gc_list_merge(&incr->reachable, old);
+    incr->phase = GC_INCR_IDLE;
+}
+
+#ifdef _PyGC_PREV_MASK_PENDING
+
+/* A traversal callback moving pending objects to the list 'tolist'. */
+static int
+visit_pending(PyObject *op, PyGC_Head *tolist)
+{
+    if (_PyObject_IS_GC(op)) {
+        PyGC_Head *gc = AS_GC(op);
+        if (gc_is_pending(gc)) {
+            gc_clear_pending(gc);
+            gc_list_move(gc, tolist);
+        }
+    }
+    return 0;
+}
+
+/* Flag the objects of the 'unflagged' list as pending.  Return 1 when done,
+   0 if the deadline was reached first. */
+static int
+incremental_flag(struct gc_incremental_state *incr, _PyTime_t deadline)
+{
+    PyGC_Head *unflagged = &incr->unflagged;
+    PyGC_Head *gc = GC_NEXT(unflagged);
+    Py_ssize_t n = 0;
+    while (gc != unflagged) {
+        gc_set_pending(gc);
+        gc = GC_NEXT(gc);
+        if (++n % GC_INCR_FLAG_CHUNK == 0
+            && _PyTime_GetPerfCounter() >= deadline) {
+            break;
+        }
+    }
+    gc_list_move_prefix(unflagged, gc, &incr->pending);
+    return gc_list_is_empty(unflagged);
+}
+
+/* Move the pending objects referred to by the roots of the interpreter to
+   the 'reachable' list.  Roots which are not pending themselves (frames are
+   usually young) are traversed right away. */
+static void
+incremental_mark_roots(PyInterpreterState *interp,
+                       struct gc_incremental_state *incr)
+{
+    PyObject *roots[] = {interp->modules, interp->sysdict, interp->builtins};
+    for (size_t i = 0; i < Py_ARRAY_LENGTH(roots); i++) {
+        PyObject *op = roots[i];
+        if (op == NULL || !_PyObject_IS_GC(op)) {
+            continue;
+        }
+        if (gc_is_pending(AS_GC(op))) {
+            visit_pending(op, &incr->reachable);
+        }
+        else {
+            (void) Py_TYPE(op)->tp_traverse(op, (visitproc)visit_pending,
+                                            &incr->reachable);
+        }
+    }
+    for (PyThreadState *t = interp->tstate_head; t != NULL; t = t->next) {
+        for (PyFrameObject *f = t->frame; f != NULL; f = f->f_back) {
+            PyObject *op = (PyObject *)f;
+            visit_pending(op, &incr->reachable);
+            (void) Py_TYPE(op)->tp_traverse(op, (visitproc)visit_pending,
+                                            &incr->reachable);
+        }
+    }
+}
+
+/* Move the objects of the 'reachable' list to the oldest generation after
+   moving their pending referents to 'reachable'.  Return 1 when done, 0 if
+   the deadline was reached first. */
+static int
+incremental_mark(GCState *gcstate, _PyTime_t deadline)
+{
+    struct gc_incremental_state *incr = &gcstate->incremental;
+    PyGC_Head *old = GEN_HEAD(gcstate, NUM_GENERATIONS-1);
+    while (!gc_list_is_empty(&incr->reachable)) {
+        for (int i = 0; i < GC_INCR_MARK_CHUNK; i++) {
+            PyGC_Head *gc = GC_NEXT(&incr->reachable);
+            if (gc == &incr->reachable) {
+                break;
+            }
+            PyObject *op = FROM_GC(gc);
+            (void) Py_TYPE(op)->tp_traverse(op, (visitproc)visit_pending,
+                                            &incr->reachable);
+            gc_list_move(gc, old);
+            incr->survivors++;
+        }
+        if (_PyTime_GetPerfCounter() >= deadline) {
+            return gc_list_is_empty(&incr->reachable);
+        }
+    }
+    return 1;
+}
+
+/* Collect a slice of the pending objects and the pending objects reachable
+   from it.  Return the number of collected objects and store the number of
+   uncollectable objects in *n_uncollectable.  The durations of the phases
+   are added to 'timing'. */
+static Py_ssize_t
+incremental_scan(PyThreadState *tstate, GCState *gcstate,
+                 Py_ssize_t *n_uncollectable,
+                 struct gc_collection_timing *timing)
+{
+    struct gc_incremental_state *incr = &gcstate->incremental;
+    PyGC_Head *old = GEN_HEAD(gcstate, NUM_GENERATIONS-1);
+    PyGC_Head increment;
+    PyGC_Head unreachable;
+
+    _PyTime_t t = _PyTime_GetPerfCounter();
+    gc_list_init(&increment);
+    PyGC_Head *end = GC_NEXT(&incr->pending);
+    for (Py_ssize_t i = 0; i < incr->slice && end != &incr->pending; i++) {
+        gc_clear_pending(end);
+        end = GC_NEXT(end);
+    }
+    gc_list_move_prefix(&incr->pending, end, &increment);
+    /* The increment list grows while it is traversed, until it holds all
+       the pending objects reachable from the slice. */
+    for (PyGC_Head *gc = GC_NEXT(&increment);
+         gc != &increment; gc = GC_NEXT(gc)) {
+        PyObject *op = FROM_GC(gc);
+        (void) Py_TYPE(op)->tp_traverse(op, (visitproc)visit_pending,
+                                        &increment);
+    }
+    timing_add_phase(timing, _PyGC_PHASE_REACHABILITY, t);
+
+    validate_list(old, collecting_clear_unreachable_clear);
+    deduce_unreachable(&increment, &unreachable, timing);
+    untrack_tuples(&increment);
+    untrack_dicts(&increment);
+    incr->survivors += gc_list_size(&increment);
+    gc_list_merge(&increment, old);
+
+    return handle_unreachable(tstate, gcstate, &unreachable, old,
+                              n_uncollectable, timing);
+}
+
+/* Run one increment of the incremental collection of the oldest generation,
+   starting a new collection if none is in progress.  The durations of the
+   increment and of its phases are stored in *timing. */
+static Py_ssize_t
+incremental_step(PyThreadState *tstate,
+                 Py_ssize_t *n_collected, Py_ssize_t *n_uncollectable,
+                 struct gc_collection_timing *timing)
+{
+    GCState *gcstate = &tstate->interp->gc;
+    struct gc_incremental_state *incr = &gcstate->incremental;
+    Py_ssize_t m = 0; /* # objects collected */
+    Py_ssize_t n = 0; /* # unreachable objects that couldn't be collected */
+
+    *n_collected = 0;
+    *n_uncollectable = 0;
+    memset(timing, 0, sizeof(*timing));
+    /* a gc callback may have disabled incremental collections */
+    if (incr->budget == 0) {
+        return 0;
+    }
+
+    _PyTime_t start = _PyTime_GetPerfCounter();
+    _PyTime_t budget = _PyTime_FromNanoseconds(incr->budget * 1000);
+    _PyTime_t deadline = start + budget;
+
+    if (gcstate->debug & DEBUG_STATS) {
+        PySys_WriteStderr("gc: incremental collection of generation %d...\n",
+                          NUM_GENERATIONS-1);
+        show_stats_each_generations(gcstate);
+    }
+
+    if (PyDTrace_GC_START_ENABLED())
+        PyDTrace_GC_START(NUM_GENERATIONS-1);
+
+    if (incr->phase == GC_INCR_IDLE) {
+        gc_list_merge(GEN_HEAD(gcstate, NUM_GENERATIONS-1), &incr->unflagged);
+        gcstate->generations[NUM_GENERATIONS-1].count = 0;
+        gcstate->long_lived_pending = 0;
+        incr->survivors = 0;
+        incr->phase = GC_INCR_FLAG;
+    }
+
+    if (incr->phase == GC_INCR_FLAG || incr->phase == GC_INCR_MARK) {
+        if (incr->phase == GC_INCR_FLAG && incremental_flag(incr, deadline)) {
+            incremental_mark_roots(tstate->interp, incr);
+            incr->phase = GC_INCR_MARK;
+        }
+        if (incr->phase == GC_INCR_MARK && incremental_mark(gcstate, deadline)) {
+            incr->phase = GC_INCR_SCAN;
+        }
+        /* Flagging and marking are part of finding the reachable objects */
+        timing_add_phase(timing, _PyGC_PHASE_REACHABILITY, start);
+    }
+    else if (incr->phase == GC_INCR_SCAN) {
+        m = incremental_scan(tstate, gcstate, &n, timing);
+
+        /* Size the next slice so that it fits in the budget */
+        _PyTime_t elapsed = _PyTime_GetPerfCounter() - start;
+        double slice = (double)incr->slice * 2;
+        if (elapsed > 0) {
+            slice = Py_MIN(slice, (double)incr->slice * budget / elapsed);
+        }
+        slice = Py_MAX(slice, GC_INCR_MIN_SLICE);
+        incr->slice = (Py_ssize_t)Py_MIN(slice, GC_INCR_MAX_SLICE);
+    }
+
+    /* Finalizers run by incremental_scan() may have aborted the collection */
+    if (incr->phase == GC_INCR_SCAN && gc_list_is_empty(&incr->pending)) {
+        incr->phase = GC_INCR_IDLE;
+        gcstate->generation_stats[NUM_GENERATIONS-1].collections++;
+        gcstate->long_lived_total = incr->survivors;
+        clear_freelists();
+    }
+    timing->total = _PyTime_GetPerfCounter() - start;
+
     if (gcstate->debug & DEBUG_STATS) {
-        double d = _PyTime_AsSecondsDouble(_PyTime_GetMonotonicClock() - t1);
+        double d = _PyTime_AsSecondsDouble(timing->total);
         PySys_WriteStderr(
             "gc: done, %" PY_FORMAT_SIZE_T "d unreachable, "
             "%" PY_FORMAT_SIZE_T "d uncollectable, %.4fs elapsed\n",
             n+m, n, d);
     }
 
-    /* Append instances in the uncollectable set to a Python
-     * reachable list of garbage.  The programmer has to deal with
-     * this if they insist on creating this type of structure.
-     */
-    handle_legacy_finalizers(tstate, gcstate, &finalizers, old);
+    if (_PyErr_Occurred(tstate)) {
+        _PyErr_WriteUnraisableMsg("in garbage collection", NULL);
+    }
+
+    struct gc_generation_stats *stats =
+        &gcstate->generation_stats[NUM_GENERATIONS-1];
+    stats->collected += m;
+    stats->uncollectable += n;
+    record_timing(stats, timing);
+    *n_collected = m;
+    *n_uncollectable = n;
+
+    if (PyDTrace_GC_DONE_ENABLED()) {
+        PyDTrace_GC_DONE(n + m);
+    }
+
+    assert(!_PyErr_Occurred(tstate));
+    return n + m;
+}
+
+#endif  /* _PyGC_PREV_MASK_PENDING */
+
+/* This is the main function.  Read this to understand how the
+ * collection process works. */
+static Py_ssize_t
+collect(PyThreadState *tstate, int generation,
+        Py_ssize_t *n_collected, Py_ssize_t *n_uncollectable, int nofail,
+        struct gc_collection_timing *timing)
+{
+    int i;
+    Py_ssize_t m = 0; /* # objects collected */
+    Py_ssize_t n = 0; /* # unreachable objects that couldn't be collected */
+    PyGC_Head *young; /* the generation we are examining */
+    PyGC_Head *old; /* next older generation */
+    PyGC_Head unreachable; /* non-problematic unreachable trash */
+    struct gc_collection_timing t = {0};
+    GCState *gcstate = &tstate->interp->gc;
+
+#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
+    if (tstate->interp->config._isolated_interpreter) {
+        // bpo-40533: The garbage collector must not be run on parallel on
+        // Python objects shared by multiple interpreters.
+        return 0;
+    }
+#endif
+
+    if (gcstate->debug & DEBUG_STATS) {
+        PySys_WriteStderr("gc: collecting generation %d...\n", generation);
+        show_stats_each_generations(gcstate);
+    }
+    _PyTime_t start = _PyTime_GetPerfCounter();
+
+    if (PyDTrace_GC_START_ENABLED())
+        PyDTrace_GC_START(generation);
+
+    /* update collection and allocation counters */
+    if (generation+1 < NUM_GENERATIONS)
+        gcstate->generations[generation+1].count += 1;
+    for (i = 0; i <= generation; i++)
+        gcstate->generations[i].count = 0;
+
+    /* A full collection takes over the incremental collection in progress */
+    if (generation == NUM_GENERATIONS-1) {
+        incremental_abort(gcstate);
+    }
+
+    /* merge younger generations with one we are currently collecting */
+    for (i = 0; i < generation; i++) {
+        gc_list_merge(GEN_HEAD(gcstate, i), GEN_HEAD(gcstate, generation));
+    }
+
+    /* handy references */
+    young = GEN_HEAD(gcstate, generation);
+    if (generation < NUM_GENERATIONS-1)
+        old = GEN_HEAD(gcstate, generation+1);
+    else
+        old = young;
     validate_list(old, collecting_clear_unreachable_clear);
 
+#ifdef GC_PARALLEL
+    if (generation == NUM_GENERATIONS-1 && gcstate->parallel.nworkers > 1) {
+        deduce_unreachable_parallel(gcstate, young, &unreachable, &t);
+    }
+    else
+#endif
+    {
+        deduce_unreachable(young, &unreachable, &t);
+    }
+
+    untrack_tuples(young);
+    /* Move reachable objects to next generation. */
+    if (young != old) {
+        if (generation == NUM_GENERATIONS - 2) {
+            gcstate->long_lived_pending += gc_list_size(young);
+        }
+        gc_list_merge(young, old);
+    }
+    else {
+        /* We only un-track dicts in full collections, to avoid quadratic
+           dict build-up. See issue #14775. */
+        untrack_dicts(young);
+        gcstate->long_lived_pending = 0;
+        gcstate->long_lived_total = gc_list_size(young);
+    }
+
+    m = handle_unreachable(tstate, gcstate, &unreachable, old, &n, &t);
+
     /* Clear free list only during the collection of the highest
      * generation */
     if (generation == NUM_GENERATIONS-1) {
         clear_freelists();
     }
+    t.total = _PyTime_GetPerfCounter() - start;
+
+    if (gcstate->debug & DEBUG_STATS) {
+        double d = _PyTime_AsSecondsDouble(t.total);
+        PySys_WriteStderr(
+            "gc: done, %" PY_FORMAT_SIZE_T "d unreachable, "
+            "%" PY_FORMAT_SIZE_T "d uncollectable, %.4fs elapsed\n",
+            n+m, n, d);
+    }
 
     if (_PyErr_Occurred(tstate)) {
         if (nofail) {
@@ -1324,11 +2346,15 @@ collect(PyThreadState *tstate, int generation,
     if (n_uncollectable) {
         *n_uncollectable = n;
     }
+    if (timing) {
+        *timing = t;
+    }
 
     struct gc_generation_stats *stats = &gcstate->generation_stats[generation];
     stats->collections++;
     stats->collected += m;
     stats->uncollectable += n;
+    record_timing(stats, &t);
 
     if (PyDTrace_GC_DONE_ENABLED()) {
         PyDTrace_GC_DONE(n + m);
@@ -1338,14 +2364,47 @@ collect(PyThreadState *tstate, int generation,
     return n + m;
 }
 
+/* Return a new dict mapping the names of the phases of a collection to
+ * their durations in seconds.
+ */
+static PyObject *
+phase_times_as_dict(const struct gc_collection_timing *timing)
+{
+    static const char * const names[_PyGC_NUM_PHASES] = {
+        [_PyGC_PHASE_REFCOUNTS] = "refcounts",
+        [_PyGC_PHASE_REACHABILITY] = "reachability",
+        [_PyGC_PHASE_WEAKREFS] = "weakrefs",
+        [_PyGC_PHASE_FINALIZERS] = "finalizers",
+        [_PyGC_PHASE_DELETION] = "deletion",
+    };
+    PyObject *dict = PyDict_New();
+    if (dict == NULL) {
+        return NULL;
+    }
+    for (int i = 0; i < _PyGC_NUM_PHASES; i++) {
+        PyObject *t = PyFloat_FromDouble(
+            _PyTime_AsSecondsDouble(timing->phases[i]));
+        if (t == NULL || PyDict_SetItemString(dict, names[i], t) < 0) {
+            Py_XDECREF(t);
+            Py_DECREF(dict);
+            return NULL;
+        }
+        Py_DECREF(t);
+    }
+    return dict;
+}
+
 /* Invoke progress callbacks to notify clients that garbage collection
- * is starting or stopping
+ * is starting or stopping.  'timing' is NULL when it is starting.
  */
 static void
 invoke_gc_callback(PyThreadState *tstate, const char *phase,
                    int generation, Py_ssize_t collected,
-                   Py_ssize_t uncollectable)
+                   Py_ssize_t uncollectable,
+                   const struct gc_collection_timing *timing)
 {
+    static const struct gc_collection_timing no_timing = {0};
+
     assert(!_PyErr_Occurred(tstate));
 
     /* we may get called very early */
@@ -1358,10 +2417,15 @@ invoke_gc_callback(PyThreadState *tstate, const char *phase,
     assert(PyList_CheckExact(gcstate->callbacks));
     PyObject *info = NULL;
     if (PyList_GET_SIZE(gcstate->callbacks) != 0) {
-        info = Py_BuildValue("{sisnsn}",
+        if (timing == NULL) {
+            timing = &no_timing;
+        }
+        info = Py_BuildValue("{sisnsnsdsN}",
             "generation", generation,
             "collected", collected,
-            "uncollectable", uncollectable);
+            "uncollectable", uncollectable,
+            "time", _PyTime_AsSecondsDouble(timing->total),
+            "phase_times", phase_times_as_dict(timing));
         if (info == NULL) {
             PyErr_WriteUnraisable(NULL);
             return;
@@ -1391,13 +2455,35 @@ collect_with_callback(PyThreadState *tstate, int generation)
 {
     assert(!_PyErr_Occurred(tstate));
     Py_ssize_t result, collected, uncollectable;
-    invoke_gc_callback(tstate, "start", generation, 0, 0);
-    result = collect(tstate, generation, &collected, &uncollectable, 0);
-    invoke_gc_callback(tstate, "stop", generation, collected, uncollectable);
+    struct gc_collection_timing timing;
+    invoke_gc_callback(tstate, "start", generation, 0, 0, NULL);
+    result = collect(tstate, generation, &collected, &uncollectable, 0,
+                     &timing);
+    invoke_gc_callback(tstate, "stop", generation, collected, uncollectable,
+                       &timing);
     assert(!_PyErr_Occurred(tstate));
     return result;
 }
 
+#ifdef _PyGC_PREV_MASK_PENDING
+/* Run an increment of the incremental collection of the oldest generation
+ * and invoke progress callbacks.
+ */
+static Py_ssize_t
+incremental_step_with_callback(PyThreadState *tstate)
+{
+    assert(!_PyErr_Occurred(tstate));
+    Py_ssize_t result, collected, uncollectable;
+    struct gc_collection_timing timing;
+    invoke_gc_callback(tstate, "start", NUM_GENERATIONS - 1, 0, 0, NULL);
+    result = incremental_step(tstate, &collected, &uncollectable, &timing);
+    invoke_gc_callback(tstate, "stop", NUM_GENERATIONS - 1,
+                       collected, uncollectable, &timing);
+    assert(!_PyErr_Occurred(tstate));
+    return result;
+}
+#endif
+
 static Py_ssize_t
 collect_generations(PyThreadState *tstate)
 {
@@ -1447,7 +2533,27 @@ collect_generations(PyThreadState *tstate)
             if (i == NUM_GENERATIONS - 1
                 && gcstate->long_lived_pending < gcstate->long_lived_total / 4)
                 continue;
+#ifdef _PyGC_PREV_MASK_PENDING
+            /* With incremental collections, the oldest generation is only
+               collected by increments following the collections of the
+               middle generation. */
+            struct gc_incremental_state *incr = &gcstate->incremental;
+            int increment = 0;
+            if (i == NUM_GENERATIONS - 1 && incr->budget > 0) {
+                i = NUM_GENERATIONS - 2;
+                increment = 1;
+            }
+            else if (i == NUM_GENERATIONS - 2
+                     && incr->phase != GC_INCR_IDLE) {
+                increment = 1;
+            }
             n = collect_with_callback(tstate, i);
+            if (increment) {
+                n += incremental_step_with_callback(tstate);
+            }
+#else
+            n = collect_with_callback(tstate, i);
+#endif
             break;
         }
     }
@@ -1626,6 +2732,122 @@ gc_get_threshold_impl(PyObject *module)
                          gcstate->generations[2].threshold);
 }
 
+/*[clinic input]
+gc.set_incremental
+
+    budget: Py_ssize_t
+    /
+
+Set the pause budget of incremental collections, in microseconds.
+
+With a non-zero budget, automatic collections of the oldest generation are
+spread over increments lasting about budget microseconds each, which run
+after the collections of the middle generation.  A budget of zero disables
+incremental collections.
+[clinic start generated code]*/
+
+static PyObject *
+gc_set_incremental_impl(PyObject *module, Py_ssize_t budget)
+/*[clinic end generated code: output=eb3596ce342d7b32 input=ec4bb7600de2965e]*/
+{
+    PyThreadState *tstate = _PyThreadState_GET();
+    GCState *gcstate = &tstate->interp->gc;
+    if (budget < 0) {
+        _PyErr_SetString(tstate, PyExc_ValueError,
+                         "budget must be a non-negative integer");
+        return NULL;
+    }
+    if (budget > PY_SSIZE_T_MAX / 1000) {
+        _PyErr_SetString(tstate, PyExc_OverflowError, "budget is too large");
+        return NULL;
+    }
+#ifndef _PyGC_PREV_MASK_PENDING
+    if (budget != 0) {
+        _PyErr_SetString(tstate, PyExc_ValueError,
+                         "incremental collections are not supported "
+                         "on this platform");
+        return NULL;
+    }
+#endif
+    if (budget == 0) {
+        incremental_abort(gcstate);
+    }
+    gcstate->incremental.budget = budget;
+    Py_RETURN_NONE;
+}
+
+/*[clinic input]
+gc.get_incremental -> Py_ssize_t
+
+Return the pause budget of incremental collections, in microseconds.
+
+Zero means that incremental collections are disabled.
+[clinic start generated code]*/
+
+static Py_ssize_t
+gc_get_incremental_impl(PyObject *module)
+/*[clinic end generated code: output=5028249752fdc310 input=43630597570cd722]*/
+{
+    PyThreadState *tstate = _PyThreadState_GET();
+    GCState *gcstate = &tstate->interp->gc;
+    return gcstate->incremental.budget;
+}
+
+/*[clinic input]
+gc.set_parallel
+
+    nworkers: int
+    /
+
+Set the number of threads marking objects during full collections.
+
+The collecting thread counts as one of them.  Values of 0 and 1 disable
+parallel marking.
+[clinic start generated code]*/
+
+static PyObject *
+gc_set_parallel_impl(PyObject *module, int nworkers)
+/*[clinic end generated code: output=c554d4adce9145d8 input=1fa361ddc97a2517]*/
+{
+    PyThreadState *tstate = _PyThreadState_GET();
+    GCState *gcstate = &tstate->interp->gc;
+    if (nworkers < 0) {
+        _PyErr_SetString(tstate, PyExc_ValueError,
+                         "nworkers must be a non-negative integer");
+        return NULL;
+    }
+    if (nworkers > GC_PARALLEL_MAX_WORKERS) {
+        _PyErr_Format(tstate, PyExc_ValueError,
+                      "nworkers must be at most %d", GC_PARALLEL_MAX_WORKERS);
+        return NULL;
+    }
+#ifndef GC_PARALLEL
+    if (nworkers > 1) {
+        _PyErr_SetString(tstate, PyExc_ValueError,
+                         "parallel collections are not supported "
+                         "on this platform");
+        return NULL;
+    }
+#endif
+    gcstate->parallel.nworkers = nworkers;
+    Py_RETURN_NONE;
+}
+
+/*[clinic input]
+gc.get_parallel -> int
+
+Return the number of threads marking objects during full collections.
+[clinic start generated code]*/
+
+static int
+gc_get_parallel_impl(PyObject *module)
+/*[clinic end generated code: output=5b8b3265d5cdfb34 input=8c32e85f5f2e8241]*/
+{
+    PyThreadState *tstate = _PyThreadState_GET();
+    GCState *gcstate = &tstate->interp->gc;
+    return gcstate->parallel.nworkers;
+}
+
 /*[clinic input]
 gc.get_count
 
@@ -1688,13 +2910,22 @@ gc_get_referrers(PyObject *self, PyObject *args)
     }
 
     GCState *gcstate = &tstate->interp->gc;
+    struct gc_incremental_state *incr = &gcstate->incremental;
     for (i = 0; i < NUM_GENERATIONS; i++) {
         if (!(gc_referrers_for(args, GEN_HEAD(gcstate, i), result))) {
-            Py_DECREF(result);
-            return NULL;
+            goto error;
         }
     }
+    if (!gc_referrers_for(args, &incr->unflagged, result) ||
+        !gc_referrers_for(args, &incr->pending, result) ||
+        !gc_referrers_for(args, &incr->reachable, result)) {
+        goto error;
+    }
     return result;
+
+error:
+    Py_DECREF(result);
+    return NULL;
 }
 
 /* Append obj to list; return true if error (out of memory), false if OK. */
@@ -1778,6 +3009,10 @@ gc_get_objects_impl(PyObject *module, Py_ssize_t generation)
         if (append_objects(result, GEN_HEAD(gcstate, generation))) {
             goto error;
         }
+        if (generation == NUM_GENERATIONS - 1
+            && append_incremental_objects(result, gcstate)) {
+            goto error;
+        }
 
         return result;
     }
@@ -1788,6 +3023,9 @@ gc_get_objects_impl(PyObject *module, Py_ssize_t generation)
             goto error;
         }
     }
+    if (append_incremental_objects(result, gcstate)) {
+        goto error;
+    }
     return result;
 
 error:
@@ -1821,12 +3059,26 @@ gc_get_stats_impl(PyObject *module)
         return NULL;
 
     for (i = 0; i < NUM_GENERATIONS; i++) {
-        PyObject *dict;
+        PyObject *dict, *pauses;
         st = &stats[i];
-        dict = Py_BuildValue("{snsnsn}",
+        pauses = PyTuple_New(_PyGC_PAUSE_BUCKETS);
+        if (pauses == NULL)
+            goto error;
+        for (int j = 0; j < _PyGC_PAUSE_BUCKETS; j++) {
+            PyObject *count = PyLong_FromSsize_t(st->pauses[j]);
+            if (count == NULL) {
+                Py_DECREF(pauses);
+                goto error;
+            }
+            PyTuple_SET_ITEM(pauses, j, count);
+        }
+        dict = Py_BuildValue("{snsnsnsdsNsN}",
                              "collections", st->collections,
                              "collected", st->collected,
-                             "uncollectable", st->uncollectable
+                             "uncollectable", st->uncollectable,
+                             "time", _PyTime_AsSecondsDouble(st->timing.total),
+                             "phase_times", phase_times_as_dict(&st->timing),
+                             "pauses", pauses
                             );
         if (dict == NULL)
             goto error;
@@ -1904,6 +3156,7 @@ gc_freeze_impl(PyObject *module)
 {
     PyThreadState *tstate = _PyThreadState_GET();
     GCState *gcstate = &tstate->interp->gc;
+    incremental_abort(gcstate);
     for (int i = 0; i < NUM_GENERATIONS; ++i) {
         gc_list_merge(GEN_HEAD(gcstate, i), &gcstate->permanent_generation.head);
         gcstate->generations[i].count = 0;
@@ -1959,6 +3212,10 @@ PyDoc_STRVAR(gc__doc__,
 "get_debug() -- Get debugging flags.\n"
 "set_threshold() -- Set the collection thresholds.\n"
 "get_threshold() -- Return the current the collection thresholds.\n"
+"set_incremental() -- Set the pause budget of incremental collections.\n"
+"get_incremental() -- Return the pause budget of incremental collections.\n"
+"set_parallel() -- Set the number of threads marking objects.\n"
+"get_parallel() -- Return the number of threads marking objects.\n"
 "get_objects() -- Return a list of all objects tracked by the collector.\n"
 "is_tracked() -- Returns true if a given object is tracked.\n"
 "is_finalized() -- Returns true if a given object has been already finalized.\n"
@@ -1977,6 +3234,10 @@ static PyMethodDef GcMethods[] = {
     GC_GET_COUNT_METHODDEF
     {"set_threshold",  gc_set_threshold, METH_VARARGS, gc_set_thresh__doc__},
     GC_GET_THRESHOLD_METHODDEF
+    GC_SET_INCREMENTAL_METHODDEF
+    GC_GET_INCREMENTAL_METHODDEF
+    GC_SET_PARALLEL_METHODDEF
+    GC_GET_PARALLEL_METHODDEF
     GC_COLLECT_METHODDEF
     GC_GET_OBJECTS_METHODDEF
     GC_GET_STATS_METHODDEF
@@ -2102,7 +3363,7 @@ _PyGC_CollectNoFail(void)
     }
     else {
         gcstate->collecting = 1;
-        n = collect(tstate, NUM_GENERATIONS - 1, NULL, NULL, 1);
+        n = collect(tstate, NUM_GENERATIONS - 1, NULL, NULL, 1, NULL);
         gcstate->collecting = 0;
     }
     return n;
@@ -2151,6 +3412,14 @@ _PyGC_Fini(PyThreadState *tstate)
     GCState *gcstate = &tstate->interp->gc;
     Py_CLEAR(gcstate->garbage);
     Py_CLEAR(gcstate->callbacks);
+    if (gcstate->parallel.mutex != NULL) {
+        PyThread_free_lock(gcstate->parallel.mutex);
+        gcstate->parallel.mutex = NULL;
+    }
+    if (gcstate->parallel.done != NULL) {
+        PyThread_free_lock(gcstate->parallel.done);
+        gcstate->parallel.done = NULL;
+    }
 }
 
 /* for debugging */
@@ -2235,7 +3504,8 @@ _PyObject_GC_Alloc(int use_calloc, size_t basicsize)
     if (g == NULL) {
         return _PyErr_NoMemory(tstate);
     }
-    assert(((uintptr_t)g & 3) == 0);  // g must be aligned 4bytes boundary
+    // g must be aligned so that flags fit in the low bits of _gc_prev
+    assert(((uintptr_t)g & ~_PyGC_PREV_MASK) == 0);
 
     g->_gc_next = 0;
     g->_gc_prev = 0;
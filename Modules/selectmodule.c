@@ -58,11 +58,23 @@ extern void bzero(void *, int);
 #  define SOCKET int
 #endif
 
+#ifdef HAVE_LINUX_IO_URING_H
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(IORING_FEAT_EXT_ARG) \
+    && defined(HAVE_POLL)
+#define HAVE_IO_URING
+#endif
+#endif
+
 typedef struct {
     PyObject *close;
     PyTypeObject *poll_Type;
     PyTypeObject *devpoll_Type;
     PyTypeObject *pyEpoll_Type;
+    PyTypeObject *pyIoUring_Type;
     PyTypeObject *kqueue_event_Type;
     PyTypeObject *kqueue_queue_Type;
 } _selectstate;
@@ -84,9 +96,10 @@ module select
 class select.poll "pollObject *" "&poll_Type"
 class select.devpoll "devpollObject *" "&devpoll_Type"
 class select.epoll "pyEpoll_Object *" "&pyEpoll_Type"
+class select.io_uring "pyIoUring_Object *" "_selectstate_global->pyIoUring_Type"
 class select.kqueue "kqueue_queue_Object *" "_selectstate_global->kqueue_queue_Type"
 [clinic start generated code]*/
-/*[clinic end generated code: output=da39a3ee5e6b4b0d input=41071028e0ede093]*/
+/*[clinic end generated code: output=da39a3ee5e6b4b0d input=426802e295cb625b]*/
 
 static int
 fildes_converter(PyObject *o, void *p)
@@ -1703,6 +1716,958 @@ the maximum number of monitored events.");
 
 #endif /* HAVE_EPOLL */
 
+#ifdef HAVE_IO_URING
+/* **************************************************************************
+ *                      io_uring interface for Linux 5.9+
+ *
+ * The rings are shared with the kernel and driven with raw system calls.
+ * Every operation is identified by a tag, chosen by the io_uring object and
+ * returned to the caller, which the kernel passes back in the completion.
+ */
+
+typedef struct {
+    PyObject_HEAD
+    int ring_fd;                        /* io_uring file descriptor */
+    unsigned int features;              /* IORING_FEAT_* flags */
+    int waiting;                        /* number of threads in wait() */
+
+    /* submission queue */
+    void *sq_ring;
+    size_t sq_ring_size;
+    unsigned int *sq_khead;
+    unsigned int *sq_ktail;
+    unsigned int *sq_kflags;
+    unsigned int *sq_array;
+    unsigned int sq_mask;
+    unsigned int sq_entries;
+    unsigned int sq_tail;               /* tail of the queued entries */
+    struct io_uring_sqe *sqes;
+    size_t sqes_size;
+
+    /* completion queue */
+    void *cq_ring;
+    size_t cq_ring_size;
+    unsigned int *cq_khead;
+    unsigned int *cq_ktail;
+    unsigned int cq_mask;
+    struct io_uring_cqe *cqes;
+
+    unsigned long long next_tag;
+    PyObject *buffers;                  /* {tag: memoryview} of the
+                                           operations in progress */
+} pyIoUring_Object;
+
+/* user_data of the cancellation requests, whose completions are dropped */
+#define IOURING_INTERNAL_TAG 0
+
+static PyObject *
+iouring_err_closed(void)
+{
+    PyErr_SetString(PyExc_ValueError,
+                    "I/O operation on closed io_uring object");
+    return NULL;
+}
+
+static int
+iouring_enter(int ring_fd, unsigned int to_submit, unsigned int min_complete,
+              unsigned int flags, void *arg, size_t argsz)
+{
+    return (int)syscall(__NR_io_uring_enter, ring_fd, to_submit,
+                        min_complete, flags, arg, argsz);
+}
+
+static unsigned int
+iouring_sq_queued(pyIoUring_Object *self)
+{
+    return self->sq_tail - __atomic_load_n(self->sq_khead, __ATOMIC_ACQUIRE);
+}
+
+/* Pass the queued entries to the kernel.  With IORING_ENTER_GETEVENTS, it
+   also moves the completions which overflowed the ring into it.  Return the
+   number of entries submitted, or -1 with an exception set. */
+static int
+iouring_submit(pyIoUring_Object *self, unsigned int flags)
+{
+    unsigned int queued = iouring_sq_queued(self);
+    int result;
+
+    if (queued == 0 && flags == 0) {
+        return 0;
+    }
+    do {
+        result = iouring_enter(self->ring_fd, queued, 0, flags, NULL, 0);
+    } while (result < 0 && errno == EINTR && !PyErr_CheckSignals());
+    if (result < 0) {
+        if (!PyErr_Occurred()) {
+            PyErr_SetFromErrno(PyExc_OSError);
+        }
+        return -1;
+    }
+    return result;
+}
+
+/* Return a free submission queue entry, submitting the queued entries if
+   the queue is full, or NULL with an exception set. */
+static struct io_uring_sqe *
+iouring_get_sqe(pyIoUring_Object *self)
+{
+    struct io_uring_sqe *sqe;
+
+    if (self->ring_fd < 0) {
+        iouring_err_closed();
+        return NULL;
+    }
+    if (iouring_sq_queued(self) >= self->sq_entries) {
+        if (iouring_submit(self, 0) < 0) {
+            return NULL;
+        }
+        if (iouring_sq_queued(self) >= self->sq_entries) {
+            errno = EBUSY;
+            PyErr_SetFromErrno(PyExc_OSError);
+            return NULL;
+        }
+    }
+    sqe = &self->sqes[self->sq_tail & self->sq_mask];
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+/* Queue the entry returned by the last iouring_get_sqe() call. */
+static void
+iouring_queue_sqe(pyIoUring_Object *self, struct io_uring_sqe *sqe)
+{
+    unsigned int index = self->sq_tail & self->sq_mask;
+
+    assert(sqe == &self->sqes[index]);
+    self->sq_array[index] = index;
+    self->sq_tail++;
+    __atomic_store_n(self->sq_ktail, self->sq_tail, __ATOMIC_RELEASE);
+}
+
+/* Queue an operation and return its tag.  If buffer is not NULL, it is kept
+   alive until the operation completes. */
+static PyObject *
+iouring_queue_op(pyIoUring_Object *self, struct io_uring_sqe *sqe,
+                 PyObject *buffer)
+{
+    PyObject *tag = PyLong_FromUnsignedLongLong(self->next_tag);
+    if (tag == NULL) {
+        return NULL;
+    }
+    if (buffer != NULL && PyDict_SetItem(self->buffers, tag, buffer) < 0) {
+        Py_DECREF(tag);
+        return NULL;
+    }
+    sqe->user_data = self->next_tag++;
+    iouring_queue_sqe(self, sqe);
+    return tag;
+}
+
+/* Return a memoryview of a contiguous buffer, to be kept with the operation
+   using it. */
+static PyObject *
+iouring_get_buffer(PyObject *obj, int writable, Py_buffer **view)
+{
+    PyObject *memview = PyMemoryView_FromObject(obj);
+    if (memview == NULL) {
+        return NULL;
+    }
+    *view = PyMemoryView_GET_BUFFER(memview);
+    if (writable && (*view)->readonly) {
+        PyErr_SetString(PyExc_TypeError, "buffer must be writable");
+        Py_DECREF(memview);
+        return NULL;
+    }
+    if (!PyBuffer_IsContiguous(*view, 'C')) {
+        PyErr_SetString(PyExc_BufferError, "buffer must be contiguous");
+        Py_DECREF(memview);
+        return NULL;
+    }
+    return memview;
+}
+
+static PyObject *
+iouring_queue_rw(pyIoUring_Object *self, int opcode, int fd, PyObject *buffer,
+                 unsigned long long offset, unsigned int msg_flags)
+{
+    struct io_uring_sqe *sqe;
+    Py_buffer *view;
+    PyObject *memview, *tag;
+    int writable = (opcode == IORING_OP_READ || opcode == IORING_OP_RECV);
+
+    memview = iouring_get_buffer(buffer, writable, &view);
+    if (memview == NULL) {
+        return NULL;
+    }
+    sqe = iouring_get_sqe(self);
+    if (sqe == NULL) {
+        Py_DECREF(memview);
+        return NULL;
+    }
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->addr = (unsigned long long)(uintptr_t)view->buf;
+    sqe->len = (unsigned int)Py_MIN(view->len, INT_MAX);
+    sqe->off = offset;
+    sqe->msg_flags = msg_flags;
+    tag = iouring_queue_op(self, sqe, memview);
+    Py_DECREF(memview);
+    return tag;
+}
+
+/* Remove the completions from the ring, and append them to elist as
+   (tag, result, flags) tuples, until it has maxevents items. */
+static int
+iouring_reap_ring(pyIoUring_Object *self, PyObject *elist, int maxevents)
+{
+    unsigned int head, tail;
+
+    head = *self->cq_khead;
+    tail = __atomic_load_n(self->cq_ktail, __ATOMIC_ACQUIRE);
+    for (; head != tail && PyList_GET_SIZE(elist) < maxevents; head++) {
+        struct io_uring_cqe *cqe = &self->cqes[head & self->cq_mask];
+        PyObject *tag, *etuple;
+
+        if (cqe->user_data == IOURING_INTERNAL_TAG) {
+            continue;
+        }
+        tag = PyLong_FromUnsignedLongLong(cqe->user_data);
+        if (tag == NULL) {
+            goto error;
+        }
+        if (PyDict_DelItem(self->buffers, tag) < 0) {
+            if (!PyErr_ExceptionMatches(PyExc_KeyError)) {
+                Py_DECREF(tag);
+                goto error;
+            }
+            PyErr_Clear();
+        }
+        etuple = Py_BuildValue("NiI", tag, cqe->res, cqe->flags);
+        if (etuple == NULL) {
+            goto error;
+        }
+        if (PyList_Append(elist, etuple) < 0) {
+            Py_DECREF(etuple);
+            goto error;
+        }
+        Py_DECREF(etuple);
+    }
+    __atomic_store_n(self->cq_khead, head, __ATOMIC_RELEASE);
+    return 0;
+
+error:
+    /* The entries up to head are consumed anyway: their operations are
+       done. */
+    __atomic_store_n(self->cq_khead, head + 1, __ATOMIC_RELEASE);
+    return -1;
+}
+
+/* Return the completions as a list of (tag, result, flags) tuples, at most
+   maxevents of them, including those which overflowed the ring. */
+static PyObject *
+iouring_reap(pyIoUring_Object *self, int maxevents)
+{
+    PyObject *elist = PyList_New(0);
+
+    if (elist == NULL) {
+        return NULL;
+    }
+    while (1) {
+        if (iouring_reap_ring(self, elist, maxevents) < 0) {
+            goto error;
+        }
+        if (PyList_GET_SIZE(elist) >= maxevents
+            || !(__atomic_load_n(self->sq_kflags, __ATOMIC_RELAXED)
+                 & IORING_SQ_CQ_OVERFLOW)) {
+            break;
+        }
+        if (iouring_submit(self, IORING_ENTER_GETEVENTS) < 0) {
+            goto error;
+        }
+    }
+    return elist;
+
+error:
+    Py_DECREF(elist);
+    return NULL;
+}
+
+static int
+iouring_cq_ready(pyIoUring_Object *self)
+{
+    return *self->cq_khead != __atomic_load_n(self->cq_ktail,
+                                              __ATOMIC_ACQUIRE);
+}
+
+static void
+iouring_unmap(pyIoUring_Object *self)
+{
+    if (self->sqes != NULL) {
+        munmap(self->sqes, self->sqes_size);
+        self->sqes = NULL;
+    }
+    if (self->cq_ring != NULL && self->cq_ring != self->sq_ring) {
+        munmap(self->cq_ring, self->cq_ring_size);
+    }
+    self->cq_ring = NULL;
+    if (self->sq_ring != NULL) {
+        munmap(self->sq_ring, self->sq_ring_size);
+        self->sq_ring = NULL;
+    }
+}
+
+/* Cancel the operations which use a buffer and wait for their completion,
+   so that the kernel no longer accesses the buffers once they are released.
+   The other operations are cancelled by closing the ring. */
+static int
+iouring_cancel_buffers(pyIoUring_Object *self)
+{
+    PyObject *tag, *value, *elist;
+    Py_ssize_t pos = 0;
+
+    while (PyDict_Next(self->buffers, &pos, &tag, &value)) {
+        struct io_uring_sqe *sqe = iouring_get_sqe(self);
+        if (sqe == NULL) {
+            return -1;
+        }
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->fd = -1;
+        sqe->addr = PyLong_AsUnsignedLongLong(tag);
+        sqe->user_data = IOURING_INTERNAL_TAG;
+        iouring_queue_sqe(self, sqe);
+    }
+    if (iouring_submit(self, 0) < 0) {
+        return -1;
+    }
+    while (PyDict_GET_SIZE(self->buffers) > 0) {
+        if (!iouring_cq_ready(self)) {
+            int result;
+            Py_BEGIN_ALLOW_THREADS
+            result = iouring_enter(self->ring_fd, 0, 1,
+                                   IORING_ENTER_GETEVENTS, NULL, 0);
+            Py_END_ALLOW_THREADS
+            if (result < 0 && errno != EINTR) {
+                PyErr_SetFromErrno(PyExc_OSError);
+                return -1;
+            }
+        }
+        elist = iouring_reap(self, INT_MAX);
+        if (elist == NULL) {
+            return -1;
+        }
+        Py_DECREF(elist);
+    }
+    return 0;
+}
+
+static int
+iouring_internal_close(pyIoUring_Object *self)
+{
+    int save_errno = 0;
+    if (self->ring_fd >= 0) {
+        int ring_fd = self->ring_fd;
+        if (self->buffers != NULL && PyDict_GET_SIZE(self->buffers) > 0
+            && iouring_cancel_buffers(self) < 0) {
+            return -1;
+        }
+        iouring_unmap(self);
+        self->ring_fd = -1;
+        Py_BEGIN_ALLOW_THREADS
+        if (close(ring_fd) < 0)
+            save_errno = errno;
+        Py_END_ALLOW_THREADS
+    }
+    return save_errno;
+}
+
+static void *
+iouring_mmap(int ring_fd, size_t size, off_t offset)
+{
+    void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, ring_fd, offset);
+    return ptr == MAP_FAILED ? NULL : ptr;
+}
+
+/*[clinic input]
+@classmethod
+select.io_uring.__new__
+
+    entries: int = 256
+      The size of the submission queue.  The completion queue is twice
+      as large.
+
+Returns an io_uring object.
+[clinic start generated code]*/
+
+static PyObject *
+select_io_uring_impl(PyTypeObject *type, int entries)
+/*[clinic end generated code: output=3e176ae7f5b0bc8b input=748f0e68b1e0776b]*/
+{
+    struct io_uring_params params;
+    pyIoUring_Object *self;
+    char *sq_ring, *cq_ring;
+
+    if (entries <= 0) {
+        PyErr_SetString(PyExc_ValueError, "entries must be positive");
+        return NULL;
+    }
+
+    allocfunc iouring_alloc = PyType_GetSlot(type, Py_tp_alloc);
+    assert(iouring_alloc != NULL);
+    self = (pyIoUring_Object *) iouring_alloc(type, 0);
+    if (self == NULL)
+        return NULL;
+    self->ring_fd = -1;
+    self->next_tag = IOURING_INTERNAL_TAG + 1;
+    self->buffers = PyDict_New();
+    if (self->buffers == NULL) {
+        Py_DECREF(self);
+        return NULL;
+    }
+
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CLAMP;
+    Py_BEGIN_ALLOW_THREADS
+    /* The file descriptor is always created with O_CLOEXEC. */
+    self->ring_fd = (int)syscall(__NR_io_uring_setup, (unsigned int)entries,
+                                 &params);
+    Py_END_ALLOW_THREADS
+    if (self->ring_fd < 0) {
+        self->ring_fd = -1;
+        goto error;
+    }
+    if (!(params.features & IORING_FEAT_POLL_32BITS)) {
+        /* Older kernels lack some of the operations */
+        errno = ENOSYS;
+        goto error;
+    }
+    self->features = params.features;
+
+    self->sq_ring_size = params.sq_off.array
+                         + params.sq_entries * sizeof(unsigned int);
+    self->cq_ring_size = params.cq_off.cqes
+                         + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        self->sq_ring_size = Py_MAX(self->sq_ring_size, self->cq_ring_size);
+        self->cq_ring_size = self->sq_ring_size;
+    }
+    self->sq_ring = iouring_mmap(self->ring_fd, self->sq_ring_size,
+                                 IORING_OFF_SQ_RING);
+    if (self->sq_ring == NULL) {
+        goto error;
+    }
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        self->cq_ring = self->sq_ring;
+    }
+    else {
+        self->cq_ring = iouring_mmap(self->ring_fd, self->cq_ring_size,
+                                     IORING_OFF_CQ_RING);
+        if (self->cq_ring == NULL) {
+            goto error;
+        }
+    }
+    self->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    self->sqes = iouring_mmap(self->ring_fd, self->sqes_size,
+                              IORING_OFF_SQES);
+    if (self->sqes == NULL) {
+        goto error;
+    }
+
+    sq_ring = self->sq_ring;
+    self->sq_khead = (unsigned int *)(sq_ring + params.sq_off.head);
+    self->sq_ktail = (unsigned int *)(sq_ring + params.sq_off.tail);
+    self->sq_kflags = (unsigned int *)(sq_ring + params.sq_off.flags);
+    self->sq_array = (unsigned int *)(sq_ring + params.sq_off.array);
+    self->sq_mask = *(unsigned int *)(sq_ring + params.sq_off.ring_mask);
+    self->sq_entries = params.sq_entries;
+    self->sq_tail = *self->sq_ktail;
+
+    cq_ring = self->cq_ring;
+    self->cq_khead = (unsigned int *)(cq_ring + params.cq_off.head);
+    self->cq_ktail = (unsigned int *)(cq_ring + params.cq_off.tail);
+    self->cq_mask = *(unsigned int *)(cq_ring + params.cq_off.ring_mask);
+    self->cqes = (struct io_uring_cqe *)(cq_ring + params.cq_off.cqes);
+
+    return (PyObject *)self;
+
+error:
+    PyErr_SetFromErrno(PyExc_OSError);
+    Py_DECREF(self);
+    return NULL;
+}
+
+
+static void
+iouring_dealloc(pyIoUring_Object *self)
+{
+    PyObject *exc_type, *exc_value, *exc_tb;
+    PyTypeObject* type = Py_TYPE(self);
+
+    PyErr_Fetch(&exc_type, &exc_value, &exc_tb);
+    if (iouring_internal_close(self) < 0) {
+        PyErr_WriteUnraisable((PyObject *)self);
+        /* The kernel may still write to the buffers. */
+        self->buffers = NULL;
+        iouring_unmap(self);
+        close(self->ring_fd);
+    }
+    PyErr_Restore(exc_type, exc_value, exc_tb);
+    Py_XDECREF(self->buffers);
+    freefunc iouring_free = PyType_GetSlot(type, Py_tp_free);
+    iouring_free((PyObject *)self);
+    Py_DECREF((PyObject *)type);
+}
+
+/*[clinic input]
+select.io_uring.close
+
+Close the io_uring file descriptor.
+
+The operations in progress are cancelled.  Further operations on the
+io_uring object will raise an exception.
+[clinic start generated code]*/
+
+static PyObject *
+select_io_uring_close_impl(pyIoUring_Object *self)
+/*[clinic end generated code: output=ab34c3876bdadb71 input=e3743213a168e268]*/
+{
+    if (self->waiting) {
+        PyErr_SetString(PyExc_RuntimeError,
+                        "cannot close an io_uring object while waiting "
+                        "on it");
+        return NULL;
+    }
+    int result = iouring_internal_close(self);
+    if (result < 0) {
+        return NULL;
+    }
+    if (result > 0) {
+        errno = result;
+        PyErr_SetFromErrno(PyExc_OSError);
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+
+static PyObject*
+iouring_get_closed(pyIoUring_Object *self, void *Py_UNUSED(ignored))
+{
+    if (self->ring_fd < 0)
+        Py_RETURN_TRUE;
+    else
+        Py_RETURN_FALSE;
+}
+
+/*[clinic input]
+select.io_uring.fileno
+
+Return the io_uring file descriptor.
+
+It becomes readable when completions are available.
+[clinic start generated code]*/
+
+static PyObject *
+select_io_uring_fileno_impl(pyIoUring_Object *self)
+/*[clinic end generated code: output=7915f2f83c9cd9ae input=ba5fb83a2a9f1ce5]*/
+{
+    if (self->ring_fd < 0)
+        return iouring_err_closed();
+    return PyLong_FromLong(self->ring_fd);
+}
+
+/*[clinic input]
+select.io_uring.read
+
+    fd: fildes
+    buffer: object
+      a writable bytes-like object
+    offset: long_long = -1
+      the offset in the file; -1 means the current file position
+    /
+
+Queue a read of up to len(buffer) bytes from fd into buffer.
+
+The result of the operation is the number of bytes read.  Return its tag.
+[clinic start generated code]*/
+
+static PyObject *
+select_io_uring_read_impl(pyIoUring_Object *self, int fd, PyObject *buffer,
+                          long long offset)
+/*[clinic end generated code: output=d4c9c93bc6470b9e input=bcccd5e7d610c097]*/
+{
+    if (offset < -1) {
+        PyErr_SetString(PyExc_ValueError, "negative offset");
+        return NULL;
+    }
+    return iouring_queue_rw(self, IORING_OP_READ, fd, buffer,
+                            (unsigned long long)offset, 0);
+}
+
+/*[clinic input]
+select.io_uring.write
+
+    fd: fildes
+    buffer: object
+      a bytes-like object
+    offset: long_long = -1
+      the offset in the file; -1 means the current file position
+    /
+
+Queue a write of the contents of buffer to fd.
+
+The result of the operation is the number of bytes written.  Return its
+tag.
+[clinic start generated code]*/
+
+static PyObject *
+select_io_uring_write_impl(pyIoUring_Object *self, int fd, PyObject *buffer,
+                           long long offset)
+/*[clinic end generated code: output=e6b3ec5d6cd63590 input=c086153bf2c620a6]*/
+{
+    if (offset < -1) {
+        PyErr_SetString(PyExc_ValueError, "negative offset");
+        return NULL;
+    }
+    return iouring_queue_rw(self, IORING_OP_WRITE, fd, buffer,
+                            (unsigned long long)offset, 0);
+}
+
+/*[clinic input]
+select.io_uring.recv
+
+    fd: fildes
+    buffer: object
+      a writable bytes-like object
+    flags: unsigned_int(bitwise=True) = 0
+      the flags of recv()
+    /
+
+Queue a receive of up to len(buffer) bytes from socket fd into buffer.
+
+The result of the operation is the number of bytes received.  Return its
+tag.
+[clinic start generated code]*/
+
+static PyObject *
+select_io_uring_recv_impl(pyIoUring_Object *self, int fd, PyObject *buffer,
+                          unsigned int flags)
+/*[clinic end generated code: output=dbb0576522f3481d input=bd20f0b5377b3354]*/
+{
+    return iouring_queue_rw(self, IORING_OP_RECV, fd, buffer, 0, flags);
+}
+
+/*[clinic input]
+select.io_uring.send
+
+    fd: fildes
+    buffer: object
+      a bytes-like object
+    flags: unsigned_int(bitwise=True) = 0
+      the flags of send()
+    /
+
+Queue a send of the contents of buffer to socket fd.
+
+The result of the operation is the number of bytes sent.  Return its tag.
+[clinic start generated code]*/
+
+static PyObject *
+select_io_uring_send_impl(pyIoUring_Object *self, int fd, PyObject *buffer,
+                          unsigned int flags)
+/*[clinic end generated code: output=6bdf34a68fc33072 input=09e48e56b7011f2d]*/
+{
+    return iouring_queue_rw(self, IORING_OP_SEND, fd, buffer, 0, flags);
+}
+
+/*[clinic input]
+select.io_uring.accept
+
+    fd: fildes
+    /
+
+Queue the acceptance of a connection on the listening socket fd.
+
+The result of the operation is the file descriptor of the new socket,
+which is non-inheritable.  Return its tag.
+[clinic start generated code]*/
+
+static PyObject *
+select_io_uring_accept_impl(pyIoUring_Object *self, int fd)
+/*[clinic end generated code: output=2c21e2fe7dfa3b32 input=176ba62a571c20c2]*/
+{
+    struct io_uring_sqe *sqe = iouring_get_sqe(self);
+    if (sqe == NULL) {
+        return NULL;
+    }
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = fd;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    return iouring_queue_op(self, sqe, NULL);
+}
+
+/*[clinic input]
+select.io_uring.poll_add
+
+    fd: fildes
+    eventmask: unsigned_int(bitwise=True)
+      a bit set composed of the various POLL constants
+    /
+
+Queue a wait for one of the events of eventmask on fd.
+
+The result of the operation is the mask of the events which occurred.
+Return its tag.
+[clinic start generated code]*/
+
+static PyObject *
+select_io_uring_poll_add_impl(pyIoUring_Object *self, int fd,
+                              unsigned int eventmask)
+/*[clinic end generated code: output=e616781a31ef3bf1 input=45c00e684345e9a3]*/
+{
+    struct io_uring_sqe *sqe = iouring_get_sqe(self);
+    if (sqe == NULL) {
+        return NULL;
+    }
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+#if PY_BIG_ENDIAN
+    eventmask = (eventmask << 16) | (eventmask >> 16);
+#endif
+    sqe->poll32_events = eventmask;
+    return iouring_queue_op(self, sqe, NULL);
+}
+
+/*[clinic input]
+select.io_uring.cancel
+
+    tag: unsigned_long_long(bitwise=True)
+    /
+
+Queue the cancellation of the operation with the given tag.
+
+If the operation is cancelled, its result is -errno.ECANCELED.  The
+cancellation itself reports no completion.
+[clinic start generated code]*/
+
+static PyObject *
+select_io_uring_cancel_impl(pyIoUring_Object *self, unsigned long long tag)
+/*[clinic end generated code: output=455974072205094f input=c6693e6396e82b22]*/
+{
+    struct io_uring_sqe *sqe = iouring_get_sqe(self);
+    if (sqe == NULL) {
+        return NULL;
+    }
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = tag;
+    sqe->user_data = IOURING_INTERNAL_TAG;
+    iouring_queue_sqe(self, sqe);
+    Py_RETURN_NONE;
+}
+
+/*[clinic input]
+select.io_uring.submit
+
+Submit the queued operations to the kernel.
+
+wait() submits them too.  Return the number of operations submitted.
+[clinic start generated code]*/
+
+static PyObject *
+select_io_uring_submit_impl(pyIoUring_Object *self)
+/*[clinic end generated code: output=07eb59929b462eb5 input=00521b070acfd386]*/
+{
+    int result;
+
+    if (self->ring_fd < 0)
+        return iouring_err_closed();
+    result = iouring_submit(self, 0);
+    if (result < 0) {
+        return NULL;
+    }
+    return PyLong_FromLong(result);
+}
+
+/*[clinic input]
+select.io_uring.wait
+
+    timeout as timeout_obj: object = None
+      the maximum time to wait in seconds (as float);
+      a timeout of None or -1 makes wait block indefinitely
+    maxevents: int = -1
+      the maximum number of completions returned; -1 means no limit
+
+Submit the queued operations and wait for their completion.
+
+Returns a list of (tag, result, flags) 3-tuples for the operations which
+completed.  A negative result is an error number with the sign inverted.
+[clinic start generated code]*/
+
+static PyObject *
+select_io_uring_wait_impl(pyIoUring_Object *self, PyObject *timeout_obj,
+                          int maxevents)
+/*[clinic end generated code: output=ef820e560839125c input=3b6462cdfa381603]*/
+{
+    _PyTime_t timeout = -1, deadline = 0;
+    unsigned int flags = 0;
+    int result;
+
+    if (self->ring_fd < 0)
+        return iouring_err_closed();
+
+    if (timeout_obj != Py_None) {
+        if (_PyTime_FromSecondsObject(&timeout, timeout_obj,
+                                      _PyTime_ROUND_TIMEOUT) < 0) {
+            if (PyErr_ExceptionMatches(PyExc_TypeError)) {
+                PyErr_SetString(PyExc_TypeError,
+                                "timeout must be an integer or None");
+            }
+            return NULL;
+        }
+        if (timeout >= 0) {
+            deadline = _PyTime_GetMonotonicClock() + timeout;
+        }
+    }
+
+    if (maxevents == -1) {
+        maxevents = INT_MAX;
+    }
+    else if (maxevents < 1) {
+        PyErr_Format(PyExc_ValueError,
+                     "maxevents must be greater than 0, got %d",
+                     maxevents);
+        return NULL;
+    }
+
+    /* Move the completions which overflowed the ring into it */
+    if (__atomic_load_n(self->sq_kflags, __ATOMIC_RELAXED)
+        & IORING_SQ_CQ_OVERFLOW) {
+        flags = IORING_ENTER_GETEVENTS;
+    }
+
+    if (timeout == 0 || iouring_cq_ready(self)) {
+        if (iouring_submit(self, flags) < 0) {
+            return NULL;
+        }
+        return iouring_reap(self, maxevents);
+    }
+
+    self->waiting++;
+    do {
+        /* Submit and wait in a single system call if the kernel takes a
+           timeout, otherwise poll the ring file descriptor. */
+        unsigned int queued = iouring_sq_queued(self);
+        if (self->features & IORING_FEAT_EXT_ARG) {
+            struct __kernel_timespec ts;
+            struct io_uring_getevents_arg arg;
+
+            memset(&arg, 0, sizeof(arg));
+            if (timeout >= 0) {
+                struct timespec tv;
+                if (_PyTime_AsTimespec(timeout, &tv) < 0) {
+                    self->waiting--;
+                    return NULL;
+                }
+                ts.tv_sec = tv.tv_sec;
+                ts.tv_nsec = tv.tv_nsec;
+                arg.ts = (unsigned long long)(uintptr_t)&ts;
+            }
+            Py_BEGIN_ALLOW_THREADS
+            result = iouring_enter(self->ring_fd, queued, 1,
+                                   IORING_ENTER_GETEVENTS
+                                   | IORING_ENTER_EXT_ARG,
+                                   &arg, sizeof(arg));
+            Py_END_ALLOW_THREADS
+            if (result < 0 && errno == ETIME) {
+                result = 0;
+            }
+        }
+        else {
+            struct pollfd pfd = {self->ring_fd, POLLIN, 0};
+            int ms = -1;
+
+            result = iouring_enter(self->ring_fd, queued, 0, flags, NULL, 0);
+            if (result >= 0 && !iouring_cq_ready(self)) {
+                if (timeout >= 0) {
+                    _PyTime_t t = _PyTime_AsMilliseconds(
+                        timeout, _PyTime_ROUND_CEILING);
+                    ms = (int)Py_MIN(t, INT_MAX);
+                }
+                Py_BEGIN_ALLOW_THREADS
+                result = poll(&pfd, 1, ms);
+                Py_END_ALLOW_THREADS
+            }
+        }
+
+        if (result >= 0 || errno != EINTR)
+            break;
+
+        /* wait was interrupted by a signal */
+        if (PyErr_CheckSignals()) {
+            self->waiting--;
+            return NULL;
+        }
+
+        if (timeout >= 0) {
+            timeout = deadline - _PyTime_GetMonotonicClock();
+            if (timeout < 0) {
+                timeout = 0;
+            }
+        }
+    } while (1);
+    self->waiting--;
+
+    if (result < 0) {
+        PyErr_SetFromErrno(PyExc_OSError);
+        return NULL;
+    }
+    return iouring_reap(self, maxevents);
+}
+
+
+/*[clinic input]
+select.io_uring.__enter__
+
+[clinic start generated code]*/
+
+static PyObject *
+select_io_uring___enter___impl(pyIoUring_Object *self)
+/*[clinic end generated code: output=6453f8b2562a22d4 input=8edfa5fe3684ef9a]*/
+{
+    if (self->ring_fd < 0)
+        return iouring_err_closed();
+
+    Py_INCREF(self);
+    return (PyObject *)self;
+}
+
+/*[clinic input]
+select.io_uring.__exit__
+
+    exc_type:  object = None
+    exc_value: object = None
+    exc_tb:    object = None
+    /
+
+[clinic start generated code]*/
+
+static PyObject *
+select_io_uring___exit___impl(pyIoUring_Object *self, PyObject *exc_type,
+                              PyObject *exc_value, PyObject *exc_tb)
+/*[clinic end generated code: output=313376fb85210e74 input=1e269333b0d5d167]*/
+{
+    return PyObject_CallMethodObjArgs((PyObject *)self, _selectstate_global->close, NULL);
+}
+
+static PyGetSetDef iouring_getsetlist[] = {
+    {"closed", (getter)iouring_get_closed, NULL,
+     "True if the io_uring object is closed"},
+    {0},
+};
+
+#endif /* HAVE_IO_URING */
+
 #ifdef HAVE_KQUEUE
 /* **************************************************************************
  *                      kqueue interface for BSD
@@ -2354,6 +3319,45 @@ static PyType_Spec pyEpoll_Type_spec = {
 
 #endif /* HAVE_EPOLL */
 
+#ifdef HAVE_IO_URING
+
+static PyMethodDef iouring_methods[] = {
+    SELECT_IO_URING_CLOSE_METHODDEF
+    SELECT_IO_URING_FILENO_METHODDEF
+    SELECT_IO_URING_READ_METHODDEF
+    SELECT_IO_URING_WRITE_METHODDEF
+    SELECT_IO_URING_RECV_METHODDEF
+    SELECT_IO_URING_SEND_METHODDEF
+    SELECT_IO_URING_ACCEPT_METHODDEF
+    SELECT_IO_URING_POLL_ADD_METHODDEF
+    SELECT_IO_URING_CANCEL_METHODDEF
+    SELECT_IO_URING_SUBMIT_METHODDEF
+    SELECT_IO_URING_WAIT_METHODDEF
+    SELECT_IO_URING___ENTER___METHODDEF
+    SELECT_IO_URING___EXIT___METHODDEF
+    {NULL,      NULL},
+};
+
+static PyType_Slot pyIoUring_Type_slots[] = {
+    {Py_tp_dealloc, iouring_dealloc},
+    {Py_tp_doc, (void*)select_io_uring__doc__},
+    {Py_tp_getattro, PyObject_GenericGetAttr},
+    {Py_tp_getset, iouring_getsetlist},
+    {Py_tp_methods, iouring_methods},
+    {Py_tp_new, select_io_uring},
+    {0, 0},
+};
+
+static PyType_Spec pyIoUring_Type_spec = {
+    "select.io_uring",
+    sizeof(pyIoUring_Object),
+    0,
+    Py_TPFLAGS_DEFAULT,
+    pyIoUring_Type_slots
+};
+
+#endif /* HAVE_IO_URING */
+
 #ifdef HAVE_KQUEUE
 
 static PyMethodDef kqueue_queue_methods[] = {
@@ -2412,6 +3416,7 @@ _select_traverse(PyObject *module, visitproc visit, void *arg)
     Py_VISIT(get_select_state(module)->poll_Type);
     Py_VISIT(get_select_state(module)->devpoll_Type);
     Py_VISIT(get_select_state(module)->pyEpoll_Type);
+    Py_VISIT(get_select_state(module)->pyIoUring_Type);
     Py_VISIT(get_select_state(module)->kqueue_event_Type);
     Py_VISIT(get_select_state(module)->kqueue_queue_Type);
     return 0;
@@ -2424,6 +3429,7 @@ _select_clear(PyObject *module)
     Py_CLEAR(get_select_state(module)->poll_Type);
     Py_CLEAR(get_select_state(module)->devpoll_Type);
     Py_CLEAR(get_select_state(module)->pyEpoll_Type);
+    Py_CLEAR(get_select_state(module)->pyIoUring_Type);
     Py_CLEAR(get_select_state(module)->kqueue_event_Type);
     Py_CLEAR(get_select_state(module)->kqueue_queue_Type);
     return 0;
@@ -2568,6 +3574,15 @@ PyInit_select(void)
 #endif
 #endif /* HAVE_EPOLL */
 
+#ifdef HAVE_IO_URING
+    PyObject *pyIoUring_Type = PyType_FromSpec(&pyIoUring_Type_spec);
+    if (pyIoUring_Type == NULL)
+        return NULL;
+    get_select_state(m)->pyIoUring_Type = (PyTypeObject *)pyIoUring_Type;
+    Py_INCREF(pyIoUring_Type);
+    PyModule_AddObject(m, "io_uring", pyIoUring_Type);
+#endif /* HAVE_IO_URING */
+
 #ifdef HAVE_KQUEUE
     PyObject *kqueue_event_Type = PyType_FromSpec(&kqueue_event_Type_spec);
     if (kqueue_event_Type == NULL)
@@ -4152,6 +4152,150 @@ SCM_RIGHTS mechanism.");
 #endif    /* CMSG_LEN */
 
 
+#ifdef HAVE_RECVMMSG
+struct sock_recvmmsg {
+    struct mmsghdr *msgvec;
+    unsigned int vlen;
+    int flags;
+    int result;
+};
+
+static int
+sock_recvmmsg_impl(PySocketSockObject *s, void *data)
+{
+    struct sock_recvmmsg *ctx = data;
+
+    ctx->result = recvmmsg(s->sock_fd, ctx->msgvec, ctx->vlen, ctx->flags,
+                           NULL);
+    return (ctx->result >= 0);
+}
+
+/* s.recvmmsg_into(buffers[, flags]) method */
+
+static PyObject *
+sock_recvmmsg_into(PySocketSockObject *s, PyObject *args)
+{
+    int flags = 0;
+    Py_ssize_t i, nitems, nbufs = 0;
+    socklen_t addrbuflen;
+    struct mmsghdr *msgvec = NULL;
+    struct iovec *iovs = NULL;
+    sock_addr_t *addrbufs = NULL;
+    Py_buffer *bufs = NULL;
+    PyObject *buffers_arg, *fast, *retval = NULL;
+    struct sock_recvmmsg ctx;
+
+    if (!PyArg_ParseTuple(args, "O|i:recvmmsg_into", &buffers_arg, &flags))
+        return NULL;
+    if (!getsockaddrlen(s, &addrbuflen))
+        return NULL;
+
+    if ((fast = PySequence_Fast(buffers_arg,
+                                "recvmmsg_into() argument 1 must be an "
+                                "iterable")) == NULL)
+        return NULL;
+    nitems = PySequence_Fast_GET_SIZE(fast);
+    if (nitems > INT_MAX) {
+        PyErr_SetString(PyExc_OSError,
+                        "recvmmsg_into() argument 1 is too long");
+        goto finally;
+    }
+    if (nitems == 0) {
+        retval = PyList_New(0);
+        goto finally;
+    }
+
+    /* Fill in a message header with a single iovec for each item, and
+       save the Py_buffer structs to release afterwards. */
+    if ((msgvec = PyMem_Calloc(nitems, sizeof(struct mmsghdr))) == NULL ||
+        (iovs = PyMem_New(struct iovec, nitems)) == NULL ||
+        (addrbufs = PyMem_New(sock_addr_t, nitems)) == NULL ||
+        (bufs = PyMem_New(Py_buffer, nitems)) == NULL) {
+        PyErr_NoMemory();
+        goto finally;
+    }
+    for (; nbufs < nitems; nbufs++) {
+        struct msghdr *msg = &msgvec[nbufs].msg_hdr;
+
+        if (!PyArg_Parse(PySequence_Fast_GET_ITEM(fast, nbufs),
+                         "w*;recvmmsg_into() argument 1 must be an iterable "
+                         "of single-segment read-write buffers",
+                         &bufs[nbufs]))
+            goto finally;
+        iovs[nbufs].iov_base = bufs[nbufs].buf;
+        iovs[nbufs].iov_len = bufs[nbufs].len;
+        /* See the comment in sock_recvmsg_guts() */
+        memset(&addrbufs[nbufs], 0, addrbuflen);
+        SAS2SA(&addrbufs[nbufs])->sa_family = AF_UNSPEC;
+        msg->msg_name = SAS2SA(&addrbufs[nbufs]);
+        msg->msg_namelen = addrbuflen;
+        msg->msg_iov = &iovs[nbufs];
+        msg->msg_iovlen = 1;
+    }
+
+    /* Make the system call. */
+    if (!IS_SELECTABLE(s)) {
+        select_error();
+        goto finally;
+    }
+
+    ctx.msgvec = msgvec;
+    ctx.vlen = (unsigned int)nitems;
+    /* Wait for the first message only, like recv() */
+    ctx.flags = flags | MSG_WAITFORONE;
+    if (sock_call(s, 0, sock_recvmmsg_impl, &ctx) < 0)
+        goto finally;
+
+    if ((retval = PyList_New(ctx.result)) == NULL)
+        goto finally;
+    for (i = 0; i < ctx.result; i++) {
+        struct msghdr *msg = &msgvec[i].msg_hdr;
+        PyObject *item;
+
+        item = Py_BuildValue("niN",
+                             (Py_ssize_t)msgvec[i].msg_len,
+                             (int)msg->msg_flags,
+                             makesockaddr(s->sock_fd, msg->msg_name,
+                                          ((msg->msg_namelen > addrbuflen) ?
+                                           addrbuflen : msg->msg_namelen),
+                                          s->sock_proto));
+        if (item == NULL) {
+            Py_CLEAR(retval);
+            goto finally;
+        }
+        PyList_SET_ITEM(retval, i, item);
+    }
+
+finally:
+    for (i = 0; i < nbufs; i++)
+        PyBuffer_Release(&bufs[i]);
+    PyMem_Free(bufs);
+    PyMem_Free(addrbufs);
+    PyMem_Free(iovs);
+    PyMem_Free(msgvec);
+    Py_DECREF(fast);
+    return retval;
+}
+
+PyDoc_STRVAR(recvmmsg_into_doc,
+"recvmmsg_into(buffers[, flags]) -> [(nbytes, msg_flags, address), ...]\n\
+\n\
+Receive several messages from the socket with a single system call,\n\
+each into its own buffer.  The buffers argument must be an iterable of\n\
+objects that export writable buffers (e.g. bytearray objects).  The\n\
+call waits until a message is available, then receives it and the\n\
+messages already queued, up to one per buffer.  The flags argument\n\
+defaults to 0 and has the same meaning as for recv().\n\
+\n\
+The return value is a list of 3-tuples (nbytes, msg_flags, address),\n\
+one for each message received, in the order of the buffers: nbytes is\n\
+the size of the message written into the buffer, msg_flags is the\n\
+bitwise OR of various flags indicating conditions on the received\n\
+message (MSG_TRUNC if the message did not fit into the buffer), and\n\
+address is the address of the sending socket, as for recvmsg().");
+#endif    /* HAVE_RECVMMSG */
+
+
 struct sock_send {
     char *buf;
     Py_ssize_t len;
@@ -4663,6 +4807,145 @@ the message.  The return value is the number of bytes of non-ancillary\n\
 data sent.");
 #endif    /* CMSG_LEN */
 
+#ifdef HAVE_SENDMMSG
+struct sock_sendmmsg {
+    struct mmsghdr *msgvec;
+    unsigned int vlen;
+    int flags;
+    int result;
+};
+
+static int
+sock_sendmmsg_impl(PySocketSockObject *s, void *data)
+{
+    struct sock_sendmmsg *ctx = data;
+
+    ctx->result = sendmmsg(s->sock_fd, ctx->msgvec, ctx->vlen, ctx->flags);
+    return (ctx->result >= 0);
+}
+
+/* s.sendmmsg(buffers[, flags[, addresses]]) method */
+
+static PyObject *
+sock_sendmmsg(PySocketSockObject *s, PyObject *args)
+{
+    int flags = 0;
+    Py_ssize_t i, nitems, ndatabufs = 0;
+    struct mmsghdr *msgvec = NULL;
+    struct iovec *iovs = NULL;
+    sock_addr_t *addrbufs = NULL;
+    Py_buffer *databufs = NULL;
+    PyObject *data_arg, *addrs_arg = NULL, *data_fast = NULL,
+        *addrs_fast = NULL, *retval = NULL;
+    struct sock_sendmmsg ctx;
+
+    if (!PyArg_ParseTuple(args, "O|iO:sendmmsg",
+                          &data_arg, &flags, &addrs_arg))
+        return NULL;
+
+    if ((data_fast = PySequence_Fast(data_arg,
+                                     "sendmmsg() argument 1 must be an "
+                                     "iterable")) == NULL)
+        goto finally;
+    nitems = PySequence_Fast_GET_SIZE(data_fast);
+    if (nitems > INT_MAX) {
+        PyErr_SetString(PyExc_OSError, "sendmmsg() argument 1 is too long");
+        goto finally;
+    }
+    if (addrs_arg != NULL && addrs_arg != Py_None) {
+        if ((addrs_fast = PySequence_Fast(addrs_arg,
+                                          "sendmmsg() argument 3 must be an "
+                                          "iterable")) == NULL)
+            goto finally;
+        if (PySequence_Fast_GET_SIZE(addrs_fast) != nitems) {
+            PyErr_SetString(PyExc_ValueError,
+                            "sendmmsg() arguments 1 and 3 must have the "
+                            "same length");
+            goto finally;
+        }
+    }
+    if (PySys_Audit("socket.sendmmsg", "OO", s,
+                    addrs_fast ? addrs_fast : Py_None) < 0)
+        goto finally;
+    if (nitems == 0) {
+        retval = PyLong_FromLong(0);
+        goto finally;
+    }
+
+    /* Fill in a message header with a single iovec for each message, and
+       save the Py_buffer structs to release afterwards. */
+    if ((msgvec = PyMem_Calloc(nitems, sizeof(struct mmsghdr))) == NULL ||
+        (iovs = PyMem_New(struct iovec, nitems)) == NULL ||
+        (databufs = PyMem_New(Py_buffer, nitems)) == NULL ||
+        (addrs_fast != NULL &&
+         (addrbufs = PyMem_New(sock_addr_t, nitems)) == NULL)) {
+        PyErr_NoMemory();
+        goto finally;
+    }
+    for (; ndatabufs < nitems; ndatabufs++) {
+        struct msghdr *msg = &msgvec[ndatabufs].msg_hdr;
+
+        if (!PyArg_Parse(PySequence_Fast_GET_ITEM(data_fast, ndatabufs),
+                         "y*;sendmmsg() argument 1 must be an iterable of "
+                         "bytes-like objects",
+                         &databufs[ndatabufs]))
+            goto finally;
+        iovs[ndatabufs].iov_base = databufs[ndatabufs].buf;
+        iovs[ndatabufs].iov_len = databufs[ndatabufs].len;
+        msg->msg_iov = &iovs[ndatabufs];
+        msg->msg_iovlen = 1;
+        if (addrs_fast != NULL) {
+            int addrlen;
+
+            if (!getsockaddrarg(s,
+                                PySequence_Fast_GET_ITEM(addrs_fast, ndatabufs),
+                                &addrbufs[ndatabufs], &addrlen, "sendmmsg")) {
+                PyBuffer_Release(&databufs[ndatabufs]);
+                goto finally;
+            }
+            msg->msg_name = &addrbufs[ndatabufs];
+            msg->msg_namelen = addrlen;
+        }
+    }
+
+    /* Make the system call. */
+    if (!IS_SELECTABLE(s)) {
+        select_error();
+        goto finally;
+    }
+
+    ctx.msgvec = msgvec;
+    ctx.vlen = (unsigned int)nitems;
+    ctx.flags = flags;
+    if (sock_call(s, 1, sock_sendmmsg_impl, &ctx) < 0)
+        goto finally;
+
+    retval = PyLong_FromLong(ctx.result);
+
+finally:
+    for (i = 0; i < ndatabufs; i++)
+        PyBuffer_Release(&databufs[i]);
+    PyMem_Free(databufs);
+    PyMem_Free(addrbufs);
+    PyMem_Free(iovs);
+    PyMem_Free(msgvec);
+    Py_XDECREF(addrs_fast);
+    Py_XDECREF(data_fast);
+    return retval;
+}
+
+PyDoc_STRVAR(sendmmsg_doc,
+"sendmmsg(buffers[, flags[, addresses]]) -> count\n\
+\n\
+Send several messages to the socket with a single system call.  The\n\
+buffers argument is an iterable of bytes-like objects, each of which is\n\
+sent as a separate message.  The flags argument defaults to 0 and has\n\
+the same meaning as for send().  If addresses is supplied and not None,\n\
+it is an iterable of destination addresses, one for each message.  The\n\
+return value is the number of messages sent, which can be less than\n\
+the number of buffers.");
+#endif    /* HAVE_SENDMMSG */
+
 #ifdef HAVE_SOCKADDR_ALG
 static PyObject*
 sock_sendmsg_afalg(PySocketSockObject *self, PyObject *args, PyObject *kwds)
@@ -5008,6 +5291,14 @@ static PyMethodDef sock_methods[] = {
     {"sendmsg",           (PyCFunction)sock_sendmsg, METH_VARARGS,
                       sendmsg_doc},
 #endif
+#ifdef HAVE_RECVMMSG
+    {"recvmmsg_into",     (PyCFunction)sock_recvmmsg_into, METH_VARARGS,
+                      recvmmsg_into_doc},
+#endif
+#ifdef HAVE_SENDMMSG
+    {"sendmmsg",          (PyCFunction)sock_sendmmsg, METH_VARARGS,
+                      sendmmsg_doc},
+#endif
 #ifdef HAVE_SOCKADDR_ALG
     {"sendmsg_afalg",     (PyCFunction)(void(*)(void))sock_sendmsg_afalg, METH_VARARGS | METH_KEYWORDS,
                       sendmsg_afalg_doc},
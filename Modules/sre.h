@@ -34,6 +34,7 @@ typedef struct {
     int flags; /* flags used when compiling pattern source */
     PyObject *weakreflist; /* List of weak references */
     int isbytes; /* pattern type (1 - bytes, 0 - string, -1 - None) */
+    struct SRE_DFA_T *dfa; /* automaton (DFA flag only) */
     /* pattern code */
     Py_ssize_t codesize;
     SRE_CODE code[1];
@@ -83,6 +84,8 @@ typedef struct {
     size_t data_stack_base;
     /* current repeat context */
     SRE_REPEAT *repeat;
+    /* automaton of the pattern (DFA flag only) */
+    struct SRE_DFA_T *dfa;
 } SRE_STATE;
 
 typedef struct {
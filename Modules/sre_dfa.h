@@ -0,0 +1,1339 @@
+/*
+ * Secret Labs' Regular Expression Engine
+ *
+ * finite automaton engine, for patterns compiled with the DFA flag
+ *
+ * See the _sre.c file for information on usage and redistribution.
+ */
+
+/* The code of a pattern compiled with the DFA flag is translated to a
+   Thompson NFA, and strings are matched by following all the threads of
+   the NFA at once instead of backtracking.  The threads are kept in the
+   order in which the backtracking engine would try them, so that the match
+   found is the same.
+
+   The sets of threads are turned into the states of a DFA while scanning
+   the string, and the states and their transitions are kept in a cache of
+   bounded size, which is simply flushed when it is full.  The transitions
+   of a state are indexed by classes of characters that no instruction can
+   tell apart.
+
+   search() runs the DFA over the string to find where the match ends, then
+   the DFA of the reversed pattern backwards from there to find where it
+   starts.  If the pattern has groups, the NFA is then simulated over the
+   match, with registers for the group marks in each thread (a "Pike VM").
+   All this takes time linear in the length of the string.
+
+   Group references and lookaround assertions cannot be matched this way;
+   sre_compile.py refuses them with the DFA flag. */
+
+/* the largest NFA, in instructions */
+#define SRE_DFA_MAX_INSTS 100000
+
+/* the memory used by the states of one DFA, before it is flushed */
+#define SRE_DFA_CACHE_SIZE (4 << 20)
+
+/* the number of cached transitions on characters above 255 */
+#define SRE_DFA_WIDE_SIZE 1024
+
+/* NFA instructions */
+#define NFA_CHAR 0          /* consume a character matching code */
+#define NFA_SPLIT 1         /* continue at x, then at y */
+#define NFA_EMPTYCHECK 2    /* at y after an empty iteration, else at x */
+#define NFA_MARK 3          /* set group mark arg */
+#define NFA_AT 4            /* check position arg */
+#define NFA_MATCH 5
+#define NFA_FAIL 6
+
+/* A thread which enters an iteration of a repeat which can match an empty
+   string is marked as such, until it leaves the iteration: if it leaves
+   it without consuming a character, the repeat ends.  Since the repeats
+   entered at the current position are always the innermost ones, the
+   marks of a thread are simply counted, and the threads at an instruction
+   are told apart by this count, up to the depth of the instruction in
+   such repeats.  A SPLIT with arg 1 (2) enters such a repeat at x (y). */
+
+typedef struct {
+    int op;
+    int x, y;
+    SRE_CODE arg;
+    const SRE_CODE* code;
+    int slot;           /* the first slot of the instruction in visited */
+} SRE_NFA_INST;
+
+typedef struct {
+    SRE_NFA_INST* inst;
+    int ninst;
+    int allocated;
+    int start;
+    int depth;          /* while compiling: the depth in nullable repeats */
+    int nslots;         /* the number of (instruction, count) pairs */
+} SRE_NFA;
+
+/* what a position looks like from one side: the edge of the string, or
+   a character */
+#define DFA_EDGE 1
+#define DFA_NL 2            /* newline */
+#define DFA_WORD 4          /* ASCII word character */
+#define DFA_UWORD 8         /* Unicode word character */
+#define DFA_LAST 16         /* the last character of the string */
+#define DFA_CONTEXT 31
+
+/* more flags of DFA states */
+#define DFA_NOMATCH 32      /* an empty match is not allowed here */
+#define DFA_MATCHED 64      /* search: a match has been found */
+#define DFA_MATCH_BEFORE 128 /* a match ends before the last character */
+#define DFA_DEAD 256        /* no threads left */
+#define DFA_SPECIAL (DFA_MATCH_BEFORE | DFA_DEAD)
+
+/* DFA modes */
+#define DFA_SEARCH 0        /* leftmost match, anywhere */
+#define DFA_MATCH 1         /* leftmost match, at the start */
+#define DFA_FULLMATCH 2     /* match up to the end */
+#define DFA_REVERSE 3       /* longest match of the reversed pattern */
+#define DFA_MODES 4
+
+typedef struct SRE_DFA_STATE_T {
+    struct SRE_DFA_STATE_T* chain;   /* next state of the hash bucket */
+    size_t hash;
+    unsigned int flags;
+    int ninst;
+    int* inst;                       /* threads, in priority order */
+    struct SRE_DFA_STATE_T* next[1]; /* transitions, by class */
+} SRE_DFA_STATE;
+
+typedef struct {
+    SRE_DFA_STATE* from;
+    Py_UCS4 ch;
+    SRE_DFA_STATE* to;
+} SRE_DFA_WIDE;
+
+typedef struct {
+    const SRE_NFA* nfa;
+    int mode;
+    SRE_DFA_STATE** table;
+    size_t tablesize;
+    size_t nstates;
+    size_t memory;
+    size_t flushes;
+    SRE_DFA_STATE* start[DFA_CONTEXT + DFA_NOMATCH + 1];
+    SRE_DFA_WIDE wide[SRE_DFA_WIDE_SIZE];
+} SRE_DFA_CACHE;
+
+typedef struct SRE_DFA_T {
+    SRE_NFA forward;
+    SRE_NFA reverse;
+    Py_ssize_t groups;
+    unsigned int needs;     /* the context that AT instructions look at */
+    int nclasses;
+    unsigned char classes[256];
+    SRE_DFA_CACHE* cache[DFA_MODES];
+    /* set while a match runs the automaton: the states and the work space
+       must not change when it checks for signals */
+    int busy;
+    /* work space for computing transitions */
+    unsigned int generation;
+    unsigned int* visited;
+    unsigned int* added;
+    int* stack;
+    int* chars;
+    int* list;
+} SRE_DFA;
+
+/* -------------------------------------------------------------------- */
+/* NFA compiler */
+
+static int
+nfa_emit(SRE_NFA* nfa, int op, int x, int y, SRE_CODE arg,
+         const SRE_CODE* code)
+{
+    SRE_NFA_INST* inst;
+
+    if (nfa->ninst >= nfa->allocated) {
+        int allocated;
+        if (nfa->ninst >= SRE_DFA_MAX_INSTS) {
+            PyErr_SetString(PyExc_OverflowError,
+                            "regular expression is too large for the "
+                            "DFA flag");
+            return -1;
+        }
+        allocated = nfa->allocated ? nfa->allocated * 2 : 64;
+        if (allocated > SRE_DFA_MAX_INSTS)
+            allocated = SRE_DFA_MAX_INSTS;
+        inst = PyMem_Realloc(nfa->inst, allocated * sizeof(SRE_NFA_INST));
+        if (!inst) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        nfa->inst = inst;
+        nfa->allocated = allocated;
+    }
+    inst = &nfa->inst[nfa->ninst];
+    inst->op = op;
+    inst->x = x;
+    inst->y = y;
+    inst->arg = arg;
+    inst->code = code;
+    inst->slot = nfa->depth;
+    return nfa->ninst++;
+}
+
+static const SRE_CODE*
+nfa_next_op(const SRE_CODE* code)
+{
+    /* return the opcode following the one at code, or NULL if it is not
+       supported */
+
+    switch (code[0]) {
+
+    case SRE_OP_LITERAL:
+    case SRE_OP_NOT_LITERAL:
+    case SRE_OP_LITERAL_IGNORE:
+    case SRE_OP_NOT_LITERAL_IGNORE:
+    case SRE_OP_LITERAL_UNI_IGNORE:
+    case SRE_OP_NOT_LITERAL_UNI_IGNORE:
+    case SRE_OP_CATEGORY:
+    case SRE_OP_AT:
+    case SRE_OP_MARK:
+        return code + 2;
+
+    case SRE_OP_ANY:
+    case SRE_OP_ANY_ALL:
+    case SRE_OP_FAILURE:
+        return code + 1;
+
+    case SRE_OP_IN:
+    case SRE_OP_IN_IGNORE:
+    case SRE_OP_IN_UNI_IGNORE:
+    case SRE_OP_INFO:
+    case SRE_OP_REPEAT_ONE:
+    case SRE_OP_MIN_REPEAT_ONE:
+        return code + 1 + code[1];
+
+    case SRE_OP_REPEAT:
+        return code + 2 + code[1];
+
+    case SRE_OP_BRANCH:
+        /* <BRANCH> <skip> code <JUMP> ... <NULL> */
+        code++;
+        while (code[0])
+            code += code[0];
+        return code + 1;
+
+    }
+    return NULL;
+}
+
+static int nfa_compile(SRE_NFA* nfa, const SRE_CODE* code,
+                       const SRE_CODE* end, int next, int reverse);
+
+static int
+nfa_nullable(const SRE_CODE* code, const SRE_CODE* end)
+{
+    /* return 1 if the opcodes from code to end can match an empty
+       string */
+
+    const SRE_CODE* alt;
+
+    for (; code < end; code = nfa_next_op(code)) {
+        switch (code[0]) {
+
+        case SRE_OP_AT:
+        case SRE_OP_MARK:
+        case SRE_OP_INFO:
+            break;
+
+        case SRE_OP_BRANCH:
+            for (alt = code + 1; alt[0]; alt += alt[0])
+                if (nfa_nullable(alt + 1, alt + alt[0] - 2))
+                    break;
+            if (!alt[0])
+                return 0;
+            break;
+
+        case SRE_OP_REPEAT_ONE:
+        case SRE_OP_MIN_REPEAT_ONE:
+            if (code[2] > 0 && !nfa_nullable(code + 4, code + code[1]))
+                return 0;
+            break;
+
+        case SRE_OP_REPEAT:
+            if (code[2] > 0 && !nfa_nullable(code + 4, code + 1 + code[1]))
+                return 0;
+            break;
+
+        default:
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int
+nfa_compile_repeat(SRE_NFA* nfa, const SRE_CODE* code, const SRE_CODE* end,
+                   SRE_CODE min, SRE_CODE max, int greedy, int next,
+                   int reverse)
+{
+    /* compile <code>{min,max}.  An iteration beyond min which matches an
+       empty string ends the repeat, like in the backtracking engine. */
+
+    int entry = next, split, check, body;
+    int nullable = nfa_nullable(code, end);
+    SRE_CODE i, n = max == SRE_MAXREPEAT ? 1 : max - min;
+
+    if (code == end)
+        return next;
+
+    for (i = 0; i < n; i++) {
+        split = nfa_emit(nfa, NFA_SPLIT, -1, -1,
+                         nullable ? (greedy ? 1 : 2) : 0, NULL);
+        if (split < 0)
+            return -1;
+        check = max == SRE_MAXREPEAT ? split : entry;
+        if (nullable) {
+            nfa->depth++;
+            check = nfa_emit(nfa, NFA_EMPTYCHECK, check, next, 0, NULL);
+        }
+        body = check < 0 ? -1 : nfa_compile(nfa, code, end, check, reverse);
+        if (nullable)
+            nfa->depth--;
+        if (body < 0)
+            return -1;
+        nfa->inst[split].x = greedy ? body : next;
+        nfa->inst[split].y = greedy ? next : body;
+        entry = split;
+    }
+
+    for (i = 0; i < min; i++) {
+        entry = nfa_compile(nfa, code, end, entry, reverse);
+        if (entry < 0)
+            return -1;
+    }
+    return entry;
+}
+
+static int
+nfa_compile_op(SRE_NFA* nfa, const SRE_CODE* code, int next, int reverse)
+{
+    /* compile the opcode at code, continuing at next */
+
+    switch (code[0]) {
+
+    case SRE_OP_LITERAL:
+    case SRE_OP_NOT_LITERAL:
+    case SRE_OP_LITERAL_IGNORE:
+    case SRE_OP_NOT_LITERAL_IGNORE:
+    case SRE_OP_LITERAL_UNI_IGNORE:
+    case SRE_OP_NOT_LITERAL_UNI_IGNORE:
+    case SRE_OP_CATEGORY:
+    case SRE_OP_ANY:
+    case SRE_OP_ANY_ALL:
+    case SRE_OP_IN:
+    case SRE_OP_IN_IGNORE:
+    case SRE_OP_IN_UNI_IGNORE:
+        return nfa_emit(nfa, NFA_CHAR, next, -1, 0, code);
+
+    case SRE_OP_AT:
+        switch (code[1]) {
+        case SRE_AT_LOC_BOUNDARY:
+        case SRE_AT_LOC_NON_BOUNDARY:
+            break;
+        default:
+            return nfa_emit(nfa, NFA_AT, next, -1, code[1], NULL);
+        }
+        break;
+
+    case SRE_OP_MARK:
+        /* the reversed pattern only finds where a match starts */
+        if (reverse)
+            return next;
+        return nfa_emit(nfa, NFA_MARK, next, -1, code[1], NULL);
+
+    case SRE_OP_FAILURE:
+        return nfa_emit(nfa, NFA_FAIL, -1, -1, 0, NULL);
+
+    case SRE_OP_INFO:
+        return next;
+
+    case SRE_OP_BRANCH:
+    {
+        /* <BRANCH> <skip> code <JUMP> ... <NULL> */
+        const SRE_CODE* alt;
+        int n = 0, i, entry, *entries;
+
+        for (alt = code + 1; alt[0]; alt += alt[0])
+            n++;
+        entries = PyMem_New(int, n);
+        if (!entries) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        for (alt = code + 1, i = 0; alt[0]; alt += alt[0], i++) {
+            entries[i] = nfa_compile(nfa, alt + 1, alt + alt[0] - 2, next,
+                                     reverse);
+            if (entries[i] < 0) {
+                PyMem_Free(entries);
+                return -1;
+            }
+        }
+        entry = n ? entries[n - 1] : nfa_emit(nfa, NFA_FAIL, -1, -1, 0, NULL);
+        for (i = n - 2; i >= 0 && entry >= 0; i--)
+            entry = nfa_emit(nfa, NFA_SPLIT, entries[i], entry, 0, NULL);
+        PyMem_Free(entries);
+        return entry;
+    }
+
+    case SRE_OP_REPEAT_ONE:
+    case SRE_OP_MIN_REPEAT_ONE:
+        /* <REPEAT_ONE> <skip> <1=min> <2=max> item <SUCCESS> tail */
+        return nfa_compile_repeat(nfa, code + 4, code + code[1], code[2],
+                                  code[3], code[0] == SRE_OP_REPEAT_ONE,
+                                  next, reverse);
+
+    case SRE_OP_REPEAT:
+        /* <REPEAT> <skip> <1=min> <2=max> item <UNTIL> tail */
+        return nfa_compile_repeat(nfa, code + 4, code + 1 + code[1], code[2],
+                                  code[3],
+                                  code[1 + code[1]] == SRE_OP_MAX_UNTIL,
+                                  next, reverse);
+
+    }
+
+    PyErr_SetString(PyExc_RuntimeError,
+                    "internal: unsupported operator for the DFA flag");
+    return -1;
+}
+
+static int
+nfa_compile(SRE_NFA* nfa, const SRE_CODE* code, const SRE_CODE* end,
+            int next, int reverse)
+{
+    /* compile the sequence of opcodes from code to end, continuing at
+       next.  Return the first instruction, or -1 on error. */
+
+    const SRE_CODE* small[16];
+    const SRE_CODE** ops = small;
+    Py_ssize_t n = 0, allocated = Py_ARRAY_LENGTH(small), i;
+
+    while (code < end) {
+        if (n >= allocated) {
+            const SRE_CODE** p;
+            allocated *= 2;
+            if (ops == small) {
+                p = PyMem_New(const SRE_CODE*, allocated);
+                if (p)
+                    memcpy(p, small, sizeof(small));
+            }
+            else
+                p = PyMem_Resize(ops, const SRE_CODE*, allocated);
+            if (!p) {
+                PyErr_NoMemory();
+                next = -1;
+                goto done;
+            }
+            ops = p;
+        }
+        ops[n++] = code;
+        code = nfa_next_op(code);
+        if (!code) {
+            PyErr_SetString(PyExc_RuntimeError,
+                            "internal: unsupported operator for the DFA flag");
+            next = -1;
+            goto done;
+        }
+    }
+
+    /* the reversed pattern matches the opcodes from the last one */
+    if (reverse) {
+        for (i = 0; i < n && next >= 0; i++)
+            next = nfa_compile_op(nfa, ops[i], next, reverse);
+    }
+    else {
+        for (i = n - 1; i >= 0 && next >= 0; i--)
+            next = nfa_compile_op(nfa, ops[i], next, reverse);
+    }
+
+  done:
+    if (ops != small)
+        PyMem_Free(ops);
+    return next;
+}
+
+/* -------------------------------------------------------------------- */
+/* instructions */
+
+LOCAL(int) sre_ucs4_charset(SRE_STATE* state, const SRE_CODE* set,
+                            SRE_CODE ch);
+
+LOCAL(int)
+dfa_test(const SRE_CODE* code, Py_UCS4 ch)
+{
+    /* check if the opcode at code matches ch */
+
+    switch (code[0]) {
+    case SRE_OP_LITERAL:
+        return ch == code[1];
+    case SRE_OP_NOT_LITERAL:
+        return ch != code[1];
+    case SRE_OP_LITERAL_IGNORE:
+        return sre_lower_ascii(ch) == code[1];
+    case SRE_OP_NOT_LITERAL_IGNORE:
+        return sre_lower_ascii(ch) != code[1];
+    case SRE_OP_LITERAL_UNI_IGNORE:
+        return sre_lower_unicode(ch) == code[1];
+    case SRE_OP_NOT_LITERAL_UNI_IGNORE:
+        return sre_lower_unicode(ch) != code[1];
+    case SRE_OP_CATEGORY:
+        return sre_category(code[1], ch);
+    case SRE_OP_ANY:
+        return !SRE_IS_LINEBREAK(ch);
+    case SRE_OP_ANY_ALL:
+        return 1;
+    case SRE_OP_IN:
+        return sre_ucs4_charset(NULL, code + 2, ch);
+    case SRE_OP_IN_IGNORE:
+        return sre_ucs4_charset(NULL, code + 2, sre_lower_ascii(ch));
+    case SRE_OP_IN_UNI_IGNORE:
+        return sre_ucs4_charset(NULL, code + 2, sre_lower_unicode(ch));
+    }
+    return 0;
+}
+
+LOCAL(unsigned int)
+dfa_context(Py_UCS4 ch)
+{
+    unsigned int context = 0;
+    if (SRE_IS_LINEBREAK(ch))
+        context |= DFA_NL;
+    if (SRE_IS_WORD(ch))
+        context |= DFA_WORD;
+    if (SRE_UNI_IS_WORD(ch))
+        context |= DFA_UWORD;
+    return context;
+}
+
+static int
+dfa_at(SRE_CODE at, unsigned int left, unsigned int right)
+{
+    /* check position at, between left and right (see SRE(at)) */
+
+    switch (at) {
+
+    case SRE_AT_BEGINNING:
+    case SRE_AT_BEGINNING_STRING:
+        return (left & DFA_EDGE) != 0;
+
+    case SRE_AT_BEGINNING_LINE:
+        return (left & (DFA_EDGE | DFA_NL)) != 0;
+
+    case SRE_AT_END:
+        return ((right & DFA_EDGE) ||
+                (right & (DFA_NL | DFA_LAST)) == (DFA_NL | DFA_LAST));
+
+    case SRE_AT_END_LINE:
+        return (right & (DFA_EDGE | DFA_NL)) != 0;
+
+    case SRE_AT_END_STRING:
+        return (right & DFA_EDGE) != 0;
+
+    case SRE_AT_BOUNDARY:
+        /* no boundary in an empty string */
+        if (left & right & DFA_EDGE)
+            return 0;
+        return !(left & DFA_WORD) != !(right & DFA_WORD);
+
+    case SRE_AT_NON_BOUNDARY:
+        if (left & right & DFA_EDGE)
+            return 0;
+        return !(left & DFA_WORD) == !(right & DFA_WORD);
+
+    case SRE_AT_UNI_BOUNDARY:
+        if (left & right & DFA_EDGE)
+            return 0;
+        return !(left & DFA_UWORD) != !(right & DFA_UWORD);
+
+    case SRE_AT_UNI_NON_BOUNDARY:
+        if (left & right & DFA_EDGE)
+            return 0;
+        return !(left & DFA_UWORD) == !(right & DFA_UWORD);
+
+    }
+    return 0;
+}
+
+static unsigned int
+dfa_at_needs(SRE_CODE at)
+{
+    /* return the context that dfa_at() looks at for at */
+
+    switch (at) {
+    case SRE_AT_BEGINNING:
+    case SRE_AT_BEGINNING_STRING:
+    case SRE_AT_END_STRING:
+        return DFA_EDGE;
+    case SRE_AT_BEGINNING_LINE:
+    case SRE_AT_END_LINE:
+        return DFA_EDGE | DFA_NL;
+    case SRE_AT_END:
+        return DFA_EDGE | DFA_NL | DFA_LAST;
+    case SRE_AT_BOUNDARY:
+    case SRE_AT_NON_BOUNDARY:
+        return DFA_EDGE | DFA_WORD;
+    case SRE_AT_UNI_BOUNDARY:
+    case SRE_AT_UNI_NON_BOUNDARY:
+        return DFA_EDGE | DFA_UWORD;
+    }
+    return 0;
+}
+
+/* -------------------------------------------------------------------- */
+/* automaton construction */
+
+static int
+dfa_compare_codes(const void* a, const void* b)
+{
+    const SRE_CODE* x = *(const SRE_CODE* const*)a;
+    const SRE_CODE* y = *(const SRE_CODE* const*)b;
+    return x < y ? -1 : x > y;
+}
+
+static void
+dfa_split_classes(SRE_DFA* dfa, const unsigned char* bits)
+{
+    /* split the classes of characters along bits */
+
+    short ids[512];
+    int ch, n = 0;
+
+    memset(ids, -1, sizeof(ids));
+    for (ch = 0; ch < 256; ch++) {
+        int key = dfa->classes[ch] * 2 + bits[ch];
+        if (ids[key] < 0)
+            ids[key] = n++;
+        dfa->classes[ch] = (unsigned char) ids[key];
+    }
+    dfa->nclasses = n;
+}
+
+static int
+dfa_init_classes(SRE_DFA* dfa)
+{
+    /* compute the classes of characters below 256 which no instruction
+       and no position check can tell apart */
+
+    const SRE_NFA* nfa = &dfa->forward;
+    const SRE_CODE** codes;
+    unsigned char bits[256];
+    int i, n = 0, ch;
+
+    codes = PyMem_New(const SRE_CODE*, nfa->ninst + 1);
+    if (!codes) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    for (i = 0; i < nfa->ninst; i++)
+        if (nfa->inst[i].op == NFA_CHAR)
+            codes[n++] = nfa->inst[i].code;
+    qsort(codes, n, sizeof(codes[0]), dfa_compare_codes);
+
+    memset(dfa->classes, 0, sizeof(dfa->classes));
+    dfa->nclasses = 1;
+    for (i = 0; i < n && dfa->nclasses < 256; i++) {
+        if (i > 0 && codes[i] == codes[i - 1])
+            continue;
+        for (ch = 0; ch < 256; ch++)
+            bits[ch] = (unsigned char) dfa_test(codes[i], ch);
+        dfa_split_classes(dfa, bits);
+    }
+    PyMem_Free(codes);
+
+    if (dfa->needs & (DFA_NL | DFA_WORD | DFA_UWORD)) {
+        for (ch = 0; ch < 256; ch++)
+            bits[ch] = (unsigned char) (dfa_context(ch) & dfa->needs);
+        for (i = 0; i < 3; i++) {
+            unsigned char split[256];
+            unsigned int flag = (DFA_NL << i);
+            if (!(dfa->needs & flag))
+                continue;
+            for (ch = 0; ch < 256; ch++)
+                split[ch] = (bits[ch] & flag) != 0;
+            dfa_split_classes(dfa, split);
+        }
+    }
+    return 0;
+}
+
+static int
+nfa_init(SRE_NFA* nfa, const SRE_CODE* code, const SRE_CODE* end,
+         int reverse)
+{
+    int match = nfa_emit(nfa, NFA_MATCH, -1, -1, 0, NULL);
+    int i, slots = 0;
+
+    if (match < 0)
+        return -1;
+    nfa->start = nfa_compile(nfa, code, end, match, reverse);
+    if (nfa->start < 0)
+        return -1;
+    for (i = 0; i < nfa->ninst; i++) {
+        int depth = nfa->inst[i].slot;
+        if (depth >= 4 * SRE_DFA_MAX_INSTS - slots) {
+            PyErr_SetString(PyExc_OverflowError,
+                            "regular expression is too large for the "
+                            "DFA flag");
+            return -1;
+        }
+        nfa->inst[i].slot = slots;
+        slots += depth + 1;
+    }
+    nfa->nslots = slots;
+    return nfa->start;
+}
+
+static void dfa_free_cache(SRE_DFA_CACHE* cache);
+
+static void
+dfa_free(SRE_DFA* dfa)
+{
+    int i;
+
+    if (!dfa)
+        return;
+    for (i = 0; i < DFA_MODES; i++)
+        dfa_free_cache(dfa->cache[i]);
+    PyMem_Free(dfa->forward.inst);
+    PyMem_Free(dfa->reverse.inst);
+    PyMem_Free(dfa->visited);
+    PyMem_Free(dfa->added);
+    PyMem_Free(dfa->stack);
+    PyMem_Free(dfa->chars);
+    PyMem_Free(dfa->list);
+    PyMem_Free(dfa);
+}
+
+static size_t
+dfa_sizeof(const SRE_DFA* dfa)
+{
+    /* the memory used by the automaton, its caches and its work space */
+
+    size_t size, n, slots;
+    int i;
+
+    if (!dfa)
+        return 0;
+    n = Py_MAX(dfa->forward.ninst, dfa->reverse.ninst);
+    slots = Py_MAX(dfa->forward.nslots, dfa->reverse.nslots);
+    size = sizeof(SRE_DFA);
+    size += (dfa->forward.allocated + dfa->reverse.allocated) *
+            sizeof(SRE_NFA_INST);
+    /* visited and added, then stack, chars and list */
+    size += (slots + n) * sizeof(unsigned int);
+    size += (4 * slots + 4 + n + n + 1) * sizeof(int);
+    for (i = 0; i < DFA_MODES; i++)
+        if (dfa->cache[i])
+            size += sizeof(SRE_DFA_CACHE) + dfa->cache[i]->memory;
+    return size;
+}
+
+static SRE_DFA*
+dfa_new(const SRE_CODE* code, Py_ssize_t codesize, Py_ssize_t groups)
+{
+    /* build the automaton of a pattern compiled with the DFA flag */
+
+    SRE_DFA* dfa;
+    const SRE_CODE* end = code + codesize - 1;  /* up to the final SUCCESS */
+    int i, n, slots;
+
+    dfa = PyMem_Calloc(1, sizeof(SRE_DFA));
+    if (!dfa) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    dfa->groups = groups;
+
+    if (nfa_init(&dfa->forward, code, end, 0) < 0 ||
+        nfa_init(&dfa->reverse, code, end, 1) < 0)
+        goto error;
+
+    for (i = 0; i < dfa->forward.ninst; i++)
+        if (dfa->forward.inst[i].op == NFA_AT)
+            dfa->needs |= dfa_at_needs(dfa->forward.inst[i].arg);
+
+    if (dfa_init_classes(dfa) < 0)
+        goto error;
+
+    n = Py_MAX(dfa->forward.ninst, dfa->reverse.ninst);
+    slots = Py_MAX(dfa->forward.nslots, dfa->reverse.nslots);
+    dfa->visited = PyMem_Calloc(slots, sizeof(unsigned int));
+    dfa->added = PyMem_Calloc(n, sizeof(unsigned int));
+    dfa->stack = PyMem_New(int, 4 * slots + 4);
+    dfa->chars = PyMem_New(int, n);
+    dfa->list = PyMem_New(int, n + 1);
+    if (!dfa->visited || !dfa->added || !dfa->stack || !dfa->chars ||
+        !dfa->list) {
+        PyErr_NoMemory();
+        goto error;
+    }
+    return dfa;
+
+  error:
+    dfa_free(dfa);
+    return NULL;
+}
+
+/* -------------------------------------------------------------------- */
+/* state cache */
+
+#define DFA_TABLE_SIZE 1024
+
+#define DFA_WIDE_INDEX(state, ch) \
+    ((((size_t)(state) >> 4) ^ ((ch) * 2654435761u)) & (SRE_DFA_WIDE_SIZE-1))
+
+static SRE_DFA_CACHE*
+dfa_cache(SRE_DFA* dfa, int mode)
+{
+    /* return the cache of the DFA of the given mode */
+
+    SRE_DFA_CACHE* cache = dfa->cache[mode];
+
+    if (cache)
+        return cache;
+    cache = PyMem_Calloc(1, sizeof(SRE_DFA_CACHE));
+    if (!cache)
+        return NULL;
+    cache->table = PyMem_Calloc(DFA_TABLE_SIZE, sizeof(SRE_DFA_STATE*));
+    if (!cache->table) {
+        PyMem_Free(cache);
+        return NULL;
+    }
+    cache->tablesize = DFA_TABLE_SIZE;
+    cache->memory = DFA_TABLE_SIZE * sizeof(SRE_DFA_STATE*);
+    cache->nfa = mode == DFA_REVERSE ? &dfa->reverse : &dfa->forward;
+    cache->mode = mode;
+    dfa->cache[mode] = cache;
+    return cache;
+}
+
+static void
+dfa_flush(SRE_DFA_CACHE* cache)
+{
+    /* forget all the states */
+
+    size_t i;
+
+    for (i = 0; i < cache->tablesize; i++) {
+        SRE_DFA_STATE* s = cache->table[i];
+        while (s) {
+            SRE_DFA_STATE* chain = s->chain;
+            PyMem_Free(s);
+            s = chain;
+        }
+        cache->table[i] = NULL;
+    }
+    cache->nstates = 0;
+    cache->memory = cache->tablesize * sizeof(SRE_DFA_STATE*);
+    cache->flushes++;
+    memset(cache->start, 0, sizeof(cache->start));
+    memset(cache->wide, 0, sizeof(cache->wide));
+}
+
+static void
+dfa_free_cache(SRE_DFA_CACHE* cache)
+{
+    if (!cache)
+        return;
+    dfa_flush(cache);
+    PyMem_Free(cache->table);
+    PyMem_Free(cache);
+}
+
+static int
+dfa_grow_table(SRE_DFA_CACHE* cache)
+{
+    size_t tablesize = cache->tablesize * 2, i;
+    SRE_DFA_STATE** table;
+
+    table = PyMem_Calloc(tablesize, sizeof(SRE_DFA_STATE*));
+    if (!table)
+        return -1;
+    for (i = 0; i < cache->tablesize; i++) {
+        SRE_DFA_STATE* s = cache->table[i];
+        while (s) {
+            SRE_DFA_STATE* chain = s->chain;
+            s->chain = table[s->hash & (tablesize - 1)];
+            table[s->hash & (tablesize - 1)] = s;
+            s = chain;
+        }
+    }
+    PyMem_Free(cache->table);
+    cache->memory += (tablesize - cache->tablesize) * sizeof(SRE_DFA_STATE*);
+    cache->table = table;
+    cache->tablesize = tablesize;
+    return 0;
+}
+
+static SRE_DFA_STATE*
+dfa_intern(SRE_DFA* dfa, SRE_DFA_CACHE* cache, unsigned int flags,
+           const int* inst, int ninst)
+{
+    /* return the state with the given flags and threads, creating it if
+       needed.  This flushes the cache when it is full. */
+
+    size_t hash = flags * 1000003u ^ (size_t)ninst, size;
+    SRE_DFA_STATE* s;
+    int i;
+
+    for (i = 0; i < ninst; i++)
+        hash = (hash ^ (size_t)inst[i]) * 1000003u;
+
+    for (s = cache->table[hash & (cache->tablesize - 1)]; s; s = s->chain)
+        if (s->hash == hash && s->ninst == ninst &&
+            (s->flags & ~DFA_DEAD) == flags &&
+            memcmp(s->inst, inst, ninst * sizeof(int)) == 0)
+            return s;
+
+    size = offsetof(SRE_DFA_STATE, next) +
+           dfa->nclasses * sizeof(SRE_DFA_STATE*) + ninst * sizeof(int);
+    if (cache->memory + size > SRE_DFA_CACHE_SIZE && cache->nstates > 0)
+        dfa_flush(cache);
+    if (cache->nstates >= cache->tablesize && dfa_grow_table(cache) < 0)
+        return NULL;
+
+    s = PyMem_Malloc(size);
+    if (!s)
+        return NULL;
+    s->hash = hash;
+    s->flags = ninst ? flags : flags | DFA_DEAD;
+    s->ninst = ninst;
+    memset(s->next, 0, dfa->nclasses * sizeof(SRE_DFA_STATE*));
+    s->inst = (int*) &s->next[dfa->nclasses];
+    memcpy(s->inst, inst, ninst * sizeof(int));
+    s->chain = cache->table[hash & (cache->tablesize - 1)];
+    cache->table[hash & (cache->tablesize - 1)] = s;
+    cache->nstates++;
+    cache->memory += size;
+    return s;
+}
+
+/* -------------------------------------------------------------------- */
+/* transitions */
+
+static unsigned int
+dfa_generation(SRE_DFA* dfa)
+{
+    if (++dfa->generation == 0) {
+        int n = Py_MAX(dfa->forward.ninst, dfa->reverse.ninst);
+        int slots = Py_MAX(dfa->forward.nslots, dfa->reverse.nslots);
+        memset(dfa->visited, 0, slots * sizeof(unsigned int));
+        memset(dfa->added, 0, n * sizeof(unsigned int));
+        dfa->generation = 1;
+    }
+    return dfa->generation;
+}
+
+static int
+dfa_closure(SRE_DFA* dfa, const SRE_NFA* nfa, int mode,
+            const int* threads, int nthreads,
+            unsigned int left, unsigned int right, int nomatch, int* nchars)
+{
+    /* follow the threads, in priority order, up to the instructions which
+       consume a character, and collect these in dfa->chars.  Return 1 if
+       a match is found.  A match cuts the threads of lower priority,
+       except when looking for the longest match. */
+
+    unsigned int generation = dfa_generation(dfa);
+    unsigned int* visited = dfa->visited;
+    int* stack = dfa->stack;
+    int i, sp, n = 0, matched = 0;
+
+    /* the stack holds pairs of an instruction and a count of the repeats
+       entered here */
+    for (i = 0; i < nthreads; i++) {
+        stack[0] = threads[i];
+        stack[1] = 0;
+        sp = 2;
+        while (sp > 0) {
+            int count = stack[--sp];
+            int pc = stack[--sp];
+            const SRE_NFA_INST* inst = &nfa->inst[pc];
+            int slot = inst->slot + (inst->op == NFA_CHAR ? 0 : count);
+            if (visited[slot] == generation)
+                continue;
+            visited[slot] = generation;
+            switch (inst->op) {
+            case NFA_CHAR:
+                dfa->chars[n++] = pc;
+                break;
+            case NFA_SPLIT:
+                stack[sp++] = inst->y;
+                stack[sp++] = count + (inst->arg == 2);
+                stack[sp++] = inst->x;
+                stack[sp++] = count + (inst->arg == 1);
+                break;
+            case NFA_EMPTYCHECK:
+                stack[sp++] = count ? inst->y : inst->x;
+                stack[sp++] = count ? count - 1 : 0;
+                break;
+            case NFA_MARK:
+                stack[sp++] = inst->x;
+                stack[sp++] = count;
+                break;
+            case NFA_AT:
+                if (dfa_at(inst->arg, left, right)) {
+                    stack[sp++] = inst->x;
+                    stack[sp++] = count;
+                }
+                break;
+            case NFA_MATCH:
+                if (nomatch ||
+                    (mode == DFA_FULLMATCH && !(right & DFA_EDGE)))
+                    break;
+                matched = 1;
+                if (mode != DFA_REVERSE)
+                    goto done;
+                break;
+            }
+        }
+    }
+  done:
+    *nchars = n;
+    return matched;
+}
+
+static SRE_DFA_STATE*
+dfa_step(SRE_DFA* dfa, SRE_DFA_CACHE* cache, SRE_DFA_STATE* s, Py_UCS4 ch,
+         int last)
+{
+    /* compute the transition of state s on character ch, which is the last
+       one of the string if last is true, and cache it.  Return NULL on
+       memory error. */
+
+    const SRE_NFA* nfa = cache->nfa;
+    size_t flushes = cache->flushes;
+    unsigned int context = dfa_context(ch), left, right, flags;
+    unsigned int generation;
+    int matched, nchars, n = 0, i;
+    SRE_DFA_STATE* next;
+
+    if (last)
+        context |= DFA_LAST;
+    if (cache->mode == DFA_REVERSE) {
+        left = context;
+        right = s->flags & DFA_CONTEXT;
+        flags = context & dfa->needs;
+    }
+    else {
+        left = s->flags & DFA_CONTEXT;
+        right = context;
+        flags = context & dfa->needs & ~DFA_LAST;
+    }
+
+    matched = dfa_closure(dfa, nfa, cache->mode, s->inst, s->ninst,
+                          left, right, s->flags & DFA_NOMATCH, &nchars);
+    generation = dfa->generation;
+    for (i = 0; i < nchars; i++) {
+        const SRE_NFA_INST* inst = &nfa->inst[dfa->chars[i]];
+        if (dfa->added[inst->x] != generation && dfa_test(inst->code, ch)) {
+            dfa->added[inst->x] = generation;
+            dfa->list[n++] = inst->x;
+        }
+    }
+    if (matched)
+        flags |= DFA_MATCH_BEFORE;
+    if (cache->mode == DFA_SEARCH) {
+        if (matched || (s->flags & DFA_MATCHED))
+            flags |= DFA_MATCHED;
+        else if (dfa->added[nfa->start] != generation)
+            /* start a new match at the next position */
+            dfa->list[n++] = nfa->start;
+    }
+
+    next = dfa_intern(dfa, cache, flags, dfa->list, n);
+    if (next && cache->flushes == flushes &&
+        !(last && (dfa->needs & DFA_LAST))) {
+        if (ch < 256)
+            s->next[dfa->classes[ch]] = next;
+        else {
+            SRE_DFA_WIDE* wide = &cache->wide[DFA_WIDE_INDEX(s, ch)];
+            wide->from = s;
+            wide->ch = ch;
+            wide->to = next;
+        }
+    }
+    return next;
+}
+
+LOCAL(SRE_DFA_STATE*)
+dfa_wide_step(SRE_DFA* dfa, SRE_DFA_CACHE* cache, SRE_DFA_STATE* s,
+              Py_UCS4 ch)
+{
+    /* transition on a character above 255 */
+    SRE_DFA_WIDE* wide = &cache->wide[DFA_WIDE_INDEX(s, ch)];
+    if (wide->from == s && wide->ch == ch)
+        return wide->to;
+    return dfa_step(dfa, cache, s, ch, 0);
+}
+
+static SRE_DFA_STATE*
+dfa_start(SRE_DFA* dfa, SRE_DFA_CACHE* cache, unsigned int flags)
+{
+    /* return the initial state, given the context of the position */
+
+    flags &= dfa->needs | DFA_NOMATCH;
+    if (!cache->start[flags])
+        cache->start[flags] = dfa_intern(dfa, cache, flags,
+                                         &cache->nfa->start, 1);
+    return cache->start[flags];
+}
+
+static int
+dfa_final(SRE_DFA* dfa, SRE_DFA_CACHE* cache, SRE_DFA_STATE* s,
+          unsigned int context)
+{
+    /* check if there is a match at the end of the scan, where context
+       is next to the last character scanned */
+
+    int nchars;
+
+    if (cache->mode == DFA_REVERSE)
+        return dfa_closure(dfa, cache->nfa, cache->mode, s->inst, s->ninst,
+                           context, s->flags & DFA_CONTEXT, 0, &nchars);
+    return dfa_closure(dfa, cache->nfa, cache->mode, s->inst, s->ninst,
+                       s->flags & DFA_CONTEXT, context,
+                       s->flags & DFA_NOMATCH, &nchars);
+}
+
+/* -------------------------------------------------------------------- */
+/* group marks */
+
+typedef struct {
+    int pc;
+    int count;          /* the repeats entered here, see SRE_NFA_INST */
+    Py_ssize_t regs;    /* offset of the registers in the pool */
+} SRE_PIKE_THREAD;
+
+typedef struct {
+    Py_ssize_t* regs;
+    Py_ssize_t size;
+    Py_ssize_t allocated;
+} SRE_PIKE_POOL;
+
+static Py_ssize_t
+pike_copy(SRE_PIKE_POOL* pool, const SRE_PIKE_POOL* from, Py_ssize_t regs,
+          Py_ssize_t nregs)
+{
+    /* append a copy of the registers at offset regs of pool from to pool,
+       and return its offset.  from may be pool. */
+
+    Py_ssize_t offset = pool->size;
+
+    if (pool->size + nregs > pool->allocated) {
+        Py_ssize_t allocated = (pool->size + nregs) * 2;
+        Py_ssize_t* p = PyMem_Resize(pool->regs, Py_ssize_t, allocated);
+        if (!p)
+            return -1;
+        pool->regs = p;
+        pool->allocated = allocated;
+    }
+    memcpy(pool->regs + offset, from->regs + regs,
+           nregs * sizeof(Py_ssize_t));
+    pool->size += nregs;
+    return offset;
+}
+
+LOCAL(Py_UCS4)
+dfa_getchar(SRE_STATE* state, Py_ssize_t i)
+{
+    switch (state->charsize) {
+    case 1:
+        return ((const Py_UCS1*) state->beginning)[i];
+    case 2:
+        return ((const Py_UCS2*) state->beginning)[i];
+    default:
+        return ((const Py_UCS4*) state->beginning)[i];
+    }
+}
+
+static Py_ssize_t
+dfa_captures(SRE_STATE* state, const void* startp, const void* endp,
+             int mode)
+{
+    /* find the group marks of the match from startp to endp, and store
+       them in the state */
+
+    SRE_DFA* dfa = state->dfa;
+    const SRE_NFA* nfa = &dfa->forward;
+    Py_ssize_t start, end, length, nomatch, pos, i;
+    Py_ssize_t nregs = 2 * dfa->groups + 2;
+    Py_ssize_t* best = NULL;
+    SRE_PIKE_THREAD *threads = NULL, *next = NULL, *chars = NULL;
+    SRE_PIKE_THREAD *stack = NULL, *tmp;
+    SRE_PIKE_POOL pool = {NULL, 0, 0}, nextpool = {NULL, 0, 0}, swap;
+    Py_ssize_t status = SRE_ERROR_MEMORY;
+    int nthreads, nchars, found = 0;
+    unsigned int sigcount = 0;
+
+    if (dfa->groups == 0) {
+        state->lastmark = state->lastindex = -1;
+        return 1;
+    }
+
+    start = ((char*) startp - (char*) state->beginning) / state->charsize;
+    end = ((char*) endp - (char*) state->beginning) / state->charsize;
+    length = ((char*) state->end - (char*) state->beginning) /
+             state->charsize;
+    nomatch = (state->must_advance && startp == state->start) ? start : -1;
+
+    best = PyMem_New(Py_ssize_t, nregs);
+    threads = PyMem_New(SRE_PIKE_THREAD, nfa->ninst + 1);
+    next = PyMem_New(SRE_PIKE_THREAD, nfa->ninst + 1);
+    chars = PyMem_New(SRE_PIKE_THREAD, nfa->ninst);
+    stack = PyMem_New(SRE_PIKE_THREAD, 2 * nfa->nslots + 2);
+    if (!best || !threads || !next || !chars || !stack)
+        goto done;
+
+    /* all marks unset, lastmark and lastindex -1 */
+    pool.regs = PyMem_New(Py_ssize_t, nregs);
+    if (!pool.regs)
+        goto done;
+    for (i = 0; i < nregs; i++)
+        pool.regs[i] = -1;
+    pool.size = pool.allocated = nregs;
+    threads[0].pc = nfa->start;
+    threads[0].count = 0;
+    threads[0].regs = 0;
+    nthreads = 1;
+
+    for (pos = start; ; pos++) {
+        unsigned int left, right, generation;
+        Py_UCS4 ch = 0;
+        int t, sp;
+
+        ++sigcount;
+        if ((0 == (sigcount & 0xfff)) && PyErr_CheckSignals()) {
+            status = SRE_ERROR_INTERRUPTED;
+            goto done;
+        }
+
+        left = pos == 0 ? DFA_EDGE : dfa_context(dfa_getchar(state, pos - 1));
+        if (pos >= length)
+            right = DFA_EDGE;
+        else {
+            ch = dfa_getchar(state, pos);
+            right = dfa_context(ch) | (pos == length - 1 ? DFA_LAST : 0);
+        }
+
+        /* follow the threads, like dfa_closure() */
+        generation = dfa_generation(dfa);
+        nchars = 0;
+        for (t = 0; t < nthreads; t++) {
+            stack[0] = threads[t];
+            sp = 1;
+            while (sp > 0) {
+                SRE_PIKE_THREAD thread = stack[--sp];
+                const SRE_NFA_INST* inst = &nfa->inst[thread.pc];
+                Py_ssize_t* regs;
+                int slot = inst->slot +
+                           (inst->op == NFA_CHAR ? 0 : thread.count);
+                if (dfa->visited[slot] == generation)
+                    continue;
+                dfa->visited[slot] = generation;
+                switch (inst->op) {
+                case NFA_CHAR:
+                    chars[nchars++] = thread;
+                    break;
+                case NFA_SPLIT:
+                    stack[sp] = thread;
+                    stack[sp].pc = inst->y;
+                    stack[sp++].count += inst->arg == 2;
+                    stack[sp] = thread;
+                    stack[sp].pc = inst->x;
+                    stack[sp++].count += inst->arg == 1;
+                    break;
+                case NFA_EMPTYCHECK:
+                    stack[sp] = thread;
+                    stack[sp].pc = thread.count ? inst->y : inst->x;
+                    stack[sp++].count = thread.count ? thread.count - 1 : 0;
+                    break;
+                case NFA_MARK:
+                    stack[sp] = thread;
+                    stack[sp].pc = inst->x;
+                    stack[sp].regs = pike_copy(&pool, &pool, thread.regs,
+                                               nregs);
+                    if (stack[sp].regs < 0)
+                        goto done;
+                    regs = pool.regs + stack[sp++].regs;
+                    regs[inst->arg] = pos;
+                    if (inst->arg & 1)
+                        regs[nregs - 1] = inst->arg / 2 + 1;
+                    if ((Py_ssize_t) inst->arg > regs[nregs - 2])
+                        regs[nregs - 2] = inst->arg;
+                    break;
+                case NFA_AT:
+                    if (dfa_at(inst->arg, left, right)) {
+                        stack[sp] = thread;
+                        stack[sp++].pc = inst->x;
+                    }
+                    break;
+                case NFA_MATCH:
+                    if (pos == nomatch ||
+                        (mode == DFA_FULLMATCH && !(right & DFA_EDGE)))
+                        break;
+                    memcpy(best, pool.regs + thread.regs,
+                           nregs * sizeof(Py_ssize_t));
+                    found = 1;
+                    goto cut;
+                }
+            }
+        }
+      cut:
+        if (pos >= end || nchars == 0)
+            break;
+
+        /* consume the character */
+        nextpool.size = 0;
+        nthreads = 0;
+        for (t = 0; t < nchars; t++) {
+            const SRE_NFA_INST* inst = &nfa->inst[chars[t].pc];
+            if (dfa->added[inst->x] != generation &&
+                dfa_test(inst->code, ch)) {
+                dfa->added[inst->x] = generation;
+                next[nthreads].pc = inst->x;
+                next[nthreads].count = 0;
+                next[nthreads].regs = pike_copy(&nextpool, &pool,
+                                                chars[t].regs, nregs);
+                if (next[nthreads++].regs < 0)
+                    goto done;
+            }
+        }
+        tmp = threads;
+        threads = next;
+        next = tmp;
+        swap = pool;
+        pool = nextpool;
+        nextpool = swap;
+    }
+
+    if (!found) {
+        /* the automaton found a match, so this cannot happen */
+        status = SRE_ERROR_STATE;
+        goto done;
+    }
+    for (i = 0; i < 2 * dfa->groups; i++)
+        state->mark[i] = best[i] < 0 ? NULL :
+            (const void*) ((char*) state->beginning +
+                           best[i] * state->charsize);
+    state->lastmark = best[nregs - 2];
+    state->lastindex = best[nregs - 1];
+    status = 1;
+
+  done:
+    PyMem_Free(best);
+    PyMem_Free(threads);
+    PyMem_Free(next);
+    PyMem_Free(chars);
+    PyMem_Free(stack);
+    PyMem_Free(pool.regs);
+    PyMem_Free(nextpool.regs);
+    return status;
+}
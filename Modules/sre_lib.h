@@ -1367,6 +1367,54 @@ exit:
 #define RESET_CAPTURE_GROUP() \
     do { state->lastmark = state->lastindex = -1; } while (0)
 
+/* return the first position at or after ptr where a match containing the
+   required literal may start, or NULL if there is none.  *found is the
+   first occurrence of the literal at or after the position returned by
+   the previous call, or NULL. */
+LOCAL(SRE_CHAR*)
+SRE(skip_required)(SRE_STATE* state, SRE_CHAR* ptr,
+                   const SRE_CHAR* literal, Py_ssize_t literal_len,
+                   SRE_CODE max_offset, SRE_CODE stop, SRE_CHAR** found)
+{
+    SRE_CHAR* end = (SRE_CHAR *)state->end;
+    SRE_CHAR* p;
+    Py_ssize_t i;
+
+    if (*found != NULL && *found >= ptr)
+        return ptr;
+    i = _PyUnicode_FindSubstring(SIZEOF_SRE_CHAR, ptr, end - ptr,
+                                 literal, literal_len);
+    if (i < 0) {
+        *found = NULL;
+        return NULL;
+    }
+    p = *found = ptr + i;
+    TRACE(("|%p|%p|SEARCH REQUIRED\n", literal, p));
+    /* a match starting further than max_offset before the literal
+       cannot reach it... */
+    if (max_offset != SRE_MAXREPEAT && i > (Py_ssize_t)max_offset)
+        ptr = p - max_offset;
+    /* ...nor can a match starting before a character that the part
+       of the pattern before the literal cannot match */
+    if (stop == (SRE_CODE)-1)
+        return ptr;
+#if SIZEOF_SRE_CHAR < 4
+    if ((SRE_CODE)(SRE_CHAR) stop != stop)
+        return ptr;
+#endif
+#if SIZEOF_SRE_CHAR == 1 && defined(HAVE_MEMRCHR)
+    p = memrchr(ptr, (int) stop, p - ptr);
+    return p != NULL ? p + 1 : ptr;
+#else
+    while (p > ptr) {
+        if (p[-1] == (SRE_CHAR) stop)
+            return p;
+        p--;
+    }
+    return ptr;
+#endif
+}
+
 LOCAL(Py_ssize_t)
 SRE(search)(SRE_STATE* state, SRE_CODE* pattern)
 {
@@ -1378,6 +1426,12 @@ SRE(search)(SRE_STATE* state, SRE_CODE* pattern)
     SRE_CODE* prefix = NULL;
     SRE_CODE* charset = NULL;
     SRE_CODE* overlap = NULL;
+    SRE_CODE* required = NULL;
+    Py_ssize_t required_len = 0;
+    SRE_CODE required_offset = 0;
+    SRE_CODE required_stop = 0;
+    SRE_CHAR required_literal[SRE_REQUIRED_MAX];
+    SRE_CHAR* required_found = NULL;
     int flags = 0;
 
     if (ptr > end)
@@ -1386,6 +1440,7 @@ SRE(search)(SRE_STATE* state, SRE_CODE* pattern)
     if (pattern[0] == SRE_OP_INFO) {
         /* optimization info block */
         /* <INFO> <1=skip> <2=flags> <3=min> <4=max> <5=prefix info>  */
+        SRE_CODE* info = pattern + 5;
 
         flags = pattern[2];
 
@@ -1402,17 +1457,27 @@ SRE(search)(SRE_STATE* state, SRE_CODE* pattern)
                 end = ptr;
         }
 
+        if (flags & SRE_INFO_REQUIRED) {
+            /* pattern contains a known literal */
+            /* <length> <max offset> <stop> <literal data> */
+            required_len = Py_MIN(info[0], SRE_REQUIRED_MAX);
+            required_offset = info[1];
+            required_stop = info[2];
+            required = info + 3;
+            info += 3 + info[0];
+        }
+
         if (flags & SRE_INFO_PREFIX) {
             /* pattern starts with a known prefix */
             /* <length> <skip> <prefix data> <overlap data> */
-            prefix_len = pattern[5];
-            prefix_skip = pattern[6];
-            prefix = pattern + 7;
+            prefix_len = info[0];
+            prefix_skip = info[1];
+            prefix = info + 2;
             overlap = prefix + prefix_len - 1;
         } else if (flags & SRE_INFO_CHARSET)
             /* pattern starts with a character from a known set */
             /* <charset> */
-            charset = pattern + 5;
+            charset = info;
 
         pattern += 1 + pattern[1];
     }
@@ -1421,6 +1486,17 @@ SRE(search)(SRE_STATE* state, SRE_CODE* pattern)
            prefix, prefix_len, prefix_skip));
     TRACE(("charset = %p\n", charset));
 
+    if (required) {
+        Py_ssize_t i;
+        for (i = 0; i < required_len; i++) {
+            required_literal[i] = (SRE_CHAR) required[i];
+#if SIZEOF_SRE_CHAR < 4
+            if ((SRE_CODE) required_literal[i] != required[i])
+                return 0; /* literal can't match: doesn't fit in char width */
+#endif
+        }
+    }
+
     if (prefix_len == 1) {
         /* pattern starts with a literal character */
         SRE_CHAR c = (SRE_CHAR) prefix[0];
@@ -1509,6 +1585,17 @@ SRE(search)(SRE_STATE* state, SRE_CODE* pattern)
                 ptr++;
             if (ptr >= end)
                 return 0;
+            if (required) {
+                SRE_CHAR* next = SRE(skip_required)(state, ptr,
+                    required_literal, required_len,
+                    required_offset, required_stop, &required_found);
+                if (next == NULL)
+                    return 0;
+                if (next != ptr) {
+                    ptr = next;
+                    continue;
+                }
+            }
             TRACE(("|%p|%p|SEARCH CHARSET\n", pattern, ptr));
             state->start = ptr;
             state->ptr = ptr;
@@ -1521,12 +1608,30 @@ SRE(search)(SRE_STATE* state, SRE_CODE* pattern)
     } else {
         /* general case */
         assert(ptr <= end);
+        if (required) {
+            SRE_CHAR* next = SRE(skip_required)(state, ptr,
+                required_literal, required_len,
+                required_offset, required_stop, &required_found);
+            if (next == NULL || next > end)
+                return 0;
+            if (next != ptr) {
+                ptr = next;
+                state->must_advance = 0;
+            }
+        }
         TRACE(("|%p|%p|SEARCH\n", pattern, ptr));
         state->start = state->ptr = ptr;
         status = SRE(match)(state, pattern, 1);
         state->must_advance = 0;
         while (status == 0 && ptr < end) {
             ptr++;
+            if (required) {
+                ptr = SRE(skip_required)(state, ptr,
+                    required_literal, required_len,
+                    required_offset, required_stop, &required_found);
+                if (ptr == NULL || ptr > end)
+                    return 0;
+            }
             RESET_CAPTURE_GROUP();
             TRACE(("|%p|%p|SEARCH\n", pattern, ptr));
             state->start = state->ptr = ptr;
@@ -1537,6 +1642,180 @@ SRE(search)(SRE_STATE* state, SRE_CODE* pattern)
     return status;
 }
 
+/* finite automaton engine (see sre_dfa.h) */
+
+LOCAL(Py_ssize_t)
+SRE(dfa_forward)(SRE_STATE* state, int mode, const SRE_CHAR** matchp)
+{
+    /* run the DFA from state->start, and set *matchp to the end of the
+       match */
+
+    SRE_DFA* dfa = state->dfa;
+    SRE_DFA_CACHE* cache;
+    SRE_DFA_STATE *s, *next;
+    const SRE_CHAR* ptr = (const SRE_CHAR *)state->start;
+    const SRE_CHAR* end = (const SRE_CHAR *)state->end;
+    const SRE_CHAR* last;
+    const SRE_CHAR* match = NULL;
+    unsigned int flags;
+    unsigned int sigcount = 0;
+    SRE_CODE ch;
+
+    cache = dfa_cache(dfa, mode);
+    if (!cache)
+        return SRE_ERROR_MEMORY;
+    if ((const void*) ptr == state->beginning)
+        flags = DFA_EDGE;
+    else
+        flags = dfa_context(ptr[-1]);
+    if (state->must_advance)
+        flags |= DFA_NOMATCH;
+    s = dfa_start(dfa, cache, flags);
+    if (!s)
+        return SRE_ERROR_MEMORY;
+
+    /* the transition on the last character is not cached if "$" needs
+       to know that it is the last one */
+    last = (dfa->needs & DFA_LAST) ? end - 1 : NULL;
+
+    while (ptr < end) {
+        ++sigcount;
+        if ((0 == (sigcount & 0xfff)) && PyErr_CheckSignals())
+            return SRE_ERROR_INTERRUPTED;
+        ch = *ptr;
+#if SIZEOF_SRE_CHAR > 1
+        if (ch >= 256)
+            next = dfa_wide_step(dfa, cache, s, ch);
+        else
+#endif
+        {
+            next = s->next[dfa->classes[ch]];
+            if (next == NULL || ptr == last)
+                next = dfa_step(dfa, cache, s, ch, ptr == end - 1);
+        }
+        if (next == NULL)
+            return SRE_ERROR_MEMORY;
+        s = next;
+        ptr++;
+        if (s->flags & DFA_SPECIAL) {
+            if (s->flags & DFA_MATCH_BEFORE)
+                match = ptr - 1;
+            if (s->flags & DFA_DEAD)
+                goto done;
+        }
+    }
+    if (dfa_final(dfa, cache, s, DFA_EDGE))
+        match = end;
+
+  done:
+    *matchp = match;
+    return match != NULL;
+}
+
+LOCAL(Py_ssize_t)
+SRE(dfa_reverse)(SRE_STATE* state, const SRE_CHAR* matchend,
+                 const SRE_CHAR** matchp)
+{
+    /* run the DFA of the reversed pattern backwards from matchend, and
+       set *matchp to the start of the longest match */
+
+    SRE_DFA* dfa = state->dfa;
+    SRE_DFA_CACHE* cache;
+    SRE_DFA_STATE *s, *next;
+    const SRE_CHAR* ptr = matchend;
+    const SRE_CHAR* start = (const SRE_CHAR *)state->start;
+    const SRE_CHAR* end = (const SRE_CHAR *)state->end;
+    const SRE_CHAR* last;
+    const SRE_CHAR* match = NULL;
+    unsigned int flags;
+    unsigned int sigcount = 0;
+    SRE_CODE ch;
+
+    cache = dfa_cache(dfa, DFA_REVERSE);
+    if (!cache)
+        return SRE_ERROR_MEMORY;
+    if (ptr == end)
+        flags = DFA_EDGE;
+    else
+        flags = dfa_context(ptr[0]) | (ptr == end - 1 ? DFA_LAST : 0);
+    s = dfa_start(dfa, cache, flags);
+    if (!s)
+        return SRE_ERROR_MEMORY;
+
+    last = (dfa->needs & DFA_LAST) ? end - 1 : NULL;
+
+    while (ptr > start) {
+        ++sigcount;
+        if ((0 == (sigcount & 0xfff)) && PyErr_CheckSignals())
+            return SRE_ERROR_INTERRUPTED;
+        ch = ptr[-1];
+#if SIZEOF_SRE_CHAR > 1
+        if (ch >= 256)
+            next = dfa_wide_step(dfa, cache, s, ch);
+        else
+#endif
+        {
+            next = s->next[dfa->classes[ch]];
+            if (next == NULL || ptr - 1 == last)
+                next = dfa_step(dfa, cache, s, ch, ptr - 1 == end - 1);
+        }
+        if (next == NULL)
+            return SRE_ERROR_MEMORY;
+        s = next;
+        ptr--;
+        if (s->flags & DFA_SPECIAL) {
+            if (s->flags & DFA_MATCH_BEFORE)
+                match = ptr + 1;
+            if (s->flags & DFA_DEAD)
+                goto done;
+        }
+    }
+    if (dfa_final(dfa, cache, s, (const void*) ptr == state->beginning ?
+                                 DFA_EDGE : dfa_context(ptr[-1])))
+        match = ptr;
+
+  done:
+    *matchp = match;
+    return match != NULL;
+}
+
+LOCAL(Py_ssize_t)
+SRE(dfa_search)(SRE_STATE* state)
+{
+    const SRE_CHAR *start, *end;
+    Py_ssize_t status;
+
+    status = SRE(dfa_forward)(state, DFA_SEARCH, &end);
+    if (status <= 0)
+        return status;
+    status = SRE(dfa_reverse)(state, end, &start);
+    if (status <= 0)
+        return status < 0 ? status : SRE_ERROR_STATE;
+    status = dfa_captures(state, start, end, DFA_SEARCH);
+    if (status <= 0)
+        return status;
+    state->start = start;
+    state->ptr = end;
+    return 1;
+}
+
+LOCAL(Py_ssize_t)
+SRE(dfa_match)(SRE_STATE* state)
+{
+    int mode = state->match_all ? DFA_FULLMATCH : DFA_MATCH;
+    const SRE_CHAR *end;
+    Py_ssize_t status;
+
+    status = SRE(dfa_forward)(state, mode, &end);
+    if (status <= 0)
+        return status;
+    status = dfa_captures(state, state->start, end, mode);
+    if (status <= 0)
+        return status;
+    state->ptr = end;
+    return 1;
+}
+
 #undef SRE_CHAR
 #undef SIZEOF_SRE_CHAR
 #undef SRE
@@ -59,6 +59,7 @@ typedef struct
     int is_initialised;
     PyObject *zdict;
     PyThread_type_lock lock;
+    struct parallel_state *par;     /* NULL unless compressing with threads */
 } compobject;
 
 static void
@@ -107,6 +108,7 @@ newcompobject(PyTypeObject *type)
     self->eof = 0;
     self->is_initialised = 0;
     self->zdict = NULL;
+    self->par = NULL;
     self->unused_data = PyBytes_FromStringAndSize("", 0);
     if (self->unused_data == NULL) {
         Py_DECREF(self);
@@ -199,6 +201,514 @@ arrange_output_buffer(z_stream *zst, PyObject **buffer, Py_ssize_t length)
     return ret;
 }
 
+/* Parallel compression.
+
+   With threads > 1, the input is cut into blocks of PARALLEL_BLOCK_SIZE bytes
+   which are compressed independently on several threads, like pigz does.
+   Each block is primed with the window of data that precedes it, so little
+   compression is lost, and ends with a sync flush, which aligns it on a byte
+   boundary: the concatenation of the compressed blocks is a single deflate
+   stream.  The checksums of the blocks are computed on the same threads and
+   combined.  The zlib or gzip header and trailer are written by the caller. */
+
+#define PARALLEL_BLOCK_SIZE (128*1024)
+
+/* Kind of checksum of the input, depending on the container format */
+#define CHECK_NONE 0
+#define CHECK_ADLER32 1
+#define CHECK_CRC32 2
+
+typedef struct {
+    const Byte *data;       /* input of the block */
+    size_t len;
+    const Byte *dict;       /* the data that precedes the block */
+    size_t dictlen;
+    int flush;              /* Z_SYNC_FLUSH, or Z_FINISH for the last block */
+    Byte *out;              /* compressed data, from PyMem_RawMalloc() */
+    size_t outlen;
+    uLong check;            /* checksum of the input */
+    int err;
+} deflate_block;
+
+typedef struct {
+    deflate_block *blocks;
+    Py_ssize_t nblocks;
+    Py_ssize_t next;        /* index of the next block to compress */
+    PyThread_type_lock lock;    /* protects next */
+    int level, wbits, memLevel, strategy;
+    int check;
+} deflate_job;
+
+typedef struct {
+    deflate_job *job;
+    PyThread_type_lock done;    /* released when the thread exits */
+} deflate_worker;
+
+static int
+deflate_one_block(z_stream *zst, deflate_block *b, int check)
+{
+    size_t size;
+    Byte *out;
+    int err;
+
+    if (check == CHECK_ADLER32)
+        b->check = adler32(adler32(0, Z_NULL, 0), b->data, (uInt)b->len);
+    else if (check == CHECK_CRC32)
+        b->check = crc32(crc32(0, Z_NULL, 0), b->data, (uInt)b->len);
+
+    err = deflateReset(zst);
+    if (err == Z_OK && b->dictlen > 0)
+        err = deflateSetDictionary(zst, b->dict, (uInt)b->dictlen);
+    if (err != Z_OK)
+        return err;
+    /* Room for the sync flush marker and the end of the last byte */
+    size = deflateBound(zst, (uLong)b->len) + 16;
+    b->out = PyMem_RawMalloc(size);
+    if (b->out == NULL)
+        return Z_MEM_ERROR;
+    zst->next_in = (Byte *)b->data;
+    zst->avail_in = (uInt)b->len;
+    for (;;) {
+        zst->next_out = b->out + b->outlen;
+        zst->avail_out = (uInt)(size - b->outlen);
+        err = deflate(zst, b->flush);
+        b->outlen = size - zst->avail_out;
+        if (err == Z_STREAM_ERROR)
+            return err;
+        if (b->flush == Z_FINISH ? err == Z_STREAM_END : zst->avail_out != 0)
+            return Z_OK;
+        /* Should not happen, the output buffer was large enough */
+        out = PyMem_RawRealloc(b->out, size * 2);
+        if (out == NULL)
+            return Z_MEM_ERROR;
+        b->out = out;
+        size *= 2;
+    }
+}
+
+static void
+deflate_worker_run(deflate_job *job)
+{
+    z_stream zst;
+    Py_ssize_t i;
+    int err;
+
+    zst.opaque = NULL;
+    zst.zalloc = PyZlib_Malloc;
+    zst.zfree = PyZlib_Free;
+    err = deflateInit2(&zst, job->level, DEFLATED, -job->wbits,
+                       job->memLevel, job->strategy);
+    for (;;) {
+        PyThread_acquire_lock(job->lock, 1);
+        i = job->next++;
+        PyThread_release_lock(job->lock);
+        if (i >= job->nblocks)
+            break;
+        job->blocks[i].err = (err == Z_OK ?
+            deflate_one_block(&zst, &job->blocks[i], job->check) : err);
+    }
+    if (err == Z_OK)
+        deflateEnd(&zst);
+}
+
+static void
+deflate_worker_thread(void *arg)
+{
+    deflate_worker *worker = (deflate_worker *)arg;
+    deflate_worker_run(worker->job);
+    PyThread_release_lock(worker->done);
+}
+
+static int
+cpu_count(void)
+{
+#ifdef MS_WINDOWS
+    SYSTEM_INFO sysinfo;
+    GetSystemInfo(&sysinfo);
+    return (int)sysinfo.dwNumberOfProcessors;
+#elif defined(HAVE_SYSCONF) && defined(_SC_NPROCESSORS_ONLN)
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    return ncpu > 0 ? (int)Py_MIN(ncpu, INT_MAX) : 1;
+#else
+    return 1;
+#endif
+}
+
+/* Compress len bytes of data as raw deflate blocks on up to nthreads
+   threads, dict being the data that precedes them in the stream.  The last
+   block ends with flush (Z_SYNC_FLUSH or Z_FINISH).  The result starts with
+   the headlen bytes of head and ends with taillen bytes left for the caller
+   to fill.  If check is not CHECK_NONE, *pcheck is updated with the data. */
+static PyObject *
+parallel_deflate(const Byte *dict, Py_ssize_t dictlen,
+                 const Byte *data, Py_ssize_t len,
+                 int level, int wbits, int memLevel, int strategy,
+                 int nthreads, int flush, int check, uLong *pcheck,
+                 const Byte *head, Py_ssize_t headlen, Py_ssize_t taillen)
+{
+    deflate_job job;
+    deflate_worker *workers = NULL;
+    Py_ssize_t i, size, window = (Py_ssize_t)1 << wbits;
+    int nworkers = 0, err = Z_OK;
+    PyObject *RetVal = NULL;
+    char *p;
+
+    job.nblocks = Py_MAX(1, (len + PARALLEL_BLOCK_SIZE - 1) / PARALLEL_BLOCK_SIZE);
+    job.blocks = PyMem_Calloc(job.nblocks, sizeof(deflate_block));
+    job.lock = PyThread_allocate_lock();
+    if (job.blocks == NULL || job.lock == NULL) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    job.next = 0;
+    job.level = level;
+    job.wbits = wbits;
+    job.memLevel = memLevel;
+    job.strategy = strategy;
+    job.check = check;
+    for (i = 0; i < job.nblocks; i++) {
+        deflate_block *b = &job.blocks[i];
+        b->data = data + i * PARALLEL_BLOCK_SIZE;
+        b->len = Py_MIN(len - i * PARALLEL_BLOCK_SIZE, PARALLEL_BLOCK_SIZE);
+        if (i == 0) {
+            if (dictlen > window) {
+                dict += dictlen - window;
+                dictlen = window;
+            }
+            b->dict = dict;
+            b->dictlen = dictlen;
+        }
+        else {
+            b->dict = b->data - window;
+            b->dictlen = window;
+        }
+        b->flush = (i == job.nblocks - 1) ? flush : Z_SYNC_FLUSH;
+    }
+
+    nthreads = (int)Py_MIN(nthreads, job.nblocks);
+    if (nthreads > 1) {
+        workers = PyMem_Calloc(nthreads - 1, sizeof(deflate_worker));
+        if (workers == NULL) {
+            PyErr_NoMemory();
+            goto done;
+        }
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    for (; nworkers < nthreads - 1; nworkers++) {
+        deflate_worker *worker = &workers[nworkers];
+        worker->job = &job;
+        worker->done = PyThread_allocate_lock();
+        if (worker->done == NULL)
+            break;
+        PyThread_acquire_lock(worker->done, 1);
+        if (PyThread_start_new_thread(deflate_worker_thread, worker) ==
+                PYTHREAD_INVALID_THREAD_ID) {
+            /* Do with the threads already started */
+            PyThread_free_lock(worker->done);
+            break;
+        }
+    }
+    deflate_worker_run(&job);
+    for (i = 0; i < nworkers; i++) {
+        PyThread_acquire_lock(workers[i].done, 1);
+        PyThread_free_lock(workers[i].done);
+    }
+    Py_END_ALLOW_THREADS
+
+    size = headlen + taillen;
+    for (i = 0; i < job.nblocks; i++) {
+        if (job.blocks[i].err != Z_OK) {
+            err = job.blocks[i].err;
+            break;
+        }
+        size += job.blocks[i].outlen;
+    }
+    if (err == Z_MEM_ERROR) {
+        PyErr_SetString(PyExc_MemoryError,
+                        "Out of memory while compressing data");
+        goto done;
+    }
+    else if (err != Z_OK) {
+        PyErr_Format(_zlibstate_global->ZlibError,
+                     "Error %d while compressing data", err);
+        goto done;
+    }
+
+    RetVal = PyBytes_FromStringAndSize(NULL, size);
+    if (RetVal == NULL)
+        goto done;
+    p = PyBytes_AS_STRING(RetVal);
+    memcpy(p, head, headlen);
+    p += headlen;
+    for (i = 0; i < job.nblocks; i++) {
+        memcpy(p, job.blocks[i].out, job.blocks[i].outlen);
+        p += job.blocks[i].outlen;
+        if (check == CHECK_ADLER32)
+            *pcheck = adler32_combine(*pcheck, job.blocks[i].check,
+                                      (z_off_t)job.blocks[i].len);
+        else if (check == CHECK_CRC32)
+            *pcheck = crc32_combine(*pcheck, job.blocks[i].check,
+                                    (z_off_t)job.blocks[i].len);
+    }
+
+done:
+    if (job.blocks != NULL) {
+        for (i = 0; i < job.nblocks; i++)
+            PyMem_RawFree(job.blocks[i].out);
+        PyMem_Free(job.blocks);
+    }
+    if (job.lock != NULL)
+        PyThread_free_lock(job.lock);
+    PyMem_Free(workers);
+    return RetVal;
+}
+
+/* Write the header of the zlib or gzip container to buf, as deflate() does,
+   and return its length. */
+static Py_ssize_t
+deflate_header(Byte *buf, int check, int wbits, int level, int strategy,
+               int has_dict, uLong dictid)
+{
+    if (level == Z_DEFAULT_COMPRESSION)
+        level = 6;
+    if (check == CHECK_CRC32) {
+        /* No file name and no modification time */
+        buf[0] = 0x1f;
+        buf[1] = 0x8b;
+        buf[2] = DEFLATED;
+        memset(buf + 3, 0, 5);
+        buf[8] = (level == 9 ? 2 :
+                  (strategy >= Z_HUFFMAN_ONLY || level < 2) ? 4 : 0);
+        buf[9] = 255;   /* Unknown OS, like the gzip module */
+        return 10;
+    }
+    else if (check == CHECK_ADLER32) {
+        unsigned int header = (DEFLATED + ((wbits - 8) << 4)) << 8;
+        int level_flags;
+        if (strategy >= Z_HUFFMAN_ONLY || level < 2)
+            level_flags = 0;
+        else if (level < 6)
+            level_flags = 1;
+        else if (level == 6)
+            level_flags = 2;
+        else
+            level_flags = 3;
+        header |= level_flags << 6;
+        if (has_dict)
+            header |= 0x20;     /* PRESET_DICT */
+        header += 31 - (header % 31);
+        buf[0] = (Byte)(header >> 8);
+        buf[1] = (Byte)header;
+        if (!has_dict)
+            return 2;
+        buf[2] = (Byte)(dictid >> 24);
+        buf[3] = (Byte)(dictid >> 16);
+        buf[4] = (Byte)(dictid >> 8);
+        buf[5] = (Byte)dictid;
+        return 6;
+    }
+    return 0;
+}
+
+static Py_ssize_t
+deflate_trailer_size(int check)
+{
+    return check == CHECK_CRC32 ? 8 : check == CHECK_ADLER32 ? 4 : 0;
+}
+
+static void
+deflate_trailer(Byte *buf, int check, uLong checksum, uLong total_in)
+{
+    int i;
+    if (check == CHECK_CRC32) {
+        for (i = 0; i < 4; i++) {
+            buf[i] = (Byte)(checksum >> (8 * i));
+            buf[4 + i] = (Byte)(total_in >> (8 * i));
+        }
+    }
+    else if (check == CHECK_ADLER32) {
+        for (i = 0; i < 4; i++)
+            buf[i] = (Byte)(checksum >> (24 - 8 * i));
+    }
+}
+
+/* Map the wbits argument of compressobj() to the container format and the
+   base-two logarithm of the window size. */
+static int
+wbits_to_check(int wbits, int *window_bits)
+{
+    int check = CHECK_ADLER32;
+    if (wbits < 0) {
+        check = CHECK_NONE;
+        wbits = -wbits;
+    }
+    else if (wbits > 16) {
+        check = CHECK_CRC32;
+        wbits -= 16;
+    }
+    /* deflate() uses 9 for 8 */
+    *window_bits = Py_MAX(wbits, 9);
+    return check;
+}
+
+/* State of the compressor objects that use several threads */
+typedef struct parallel_state {
+    int threads;
+    int level, wbits, memLevel, strategy;
+    int check;
+    Byte header[10];        /* written at the start of the first output */
+    Py_ssize_t headerlen;
+    Byte *pending;          /* input not compressed yet */
+    Py_ssize_t pending_len, pending_size;
+    Byte window[1 << MAX_WBITS];    /* the last input compressed */
+    Py_ssize_t window_len;
+    uLong checksum;
+    uLong total_in;
+} parallel_state;
+
+static parallel_state *
+parallel_state_new(int threads, int level, int wbits, int memLevel,
+                   int strategy, Py_buffer *zdict)
+{
+    parallel_state *par = PyMem_Calloc(1, sizeof(parallel_state));
+    if (par == NULL) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    par->threads = threads;
+    par->level = level;
+    par->memLevel = memLevel;
+    par->strategy = strategy;
+    par->check = wbits_to_check(wbits, &par->wbits);
+    par->checksum = (par->check == CHECK_CRC32 ?
+                     crc32(0, Z_NULL, 0) : adler32(0, Z_NULL, 0));
+    if (zdict->buf != NULL) {
+        Py_ssize_t window = (Py_ssize_t)1 << par->wbits;
+        par->window_len = Py_MIN(zdict->len, window);
+        memcpy(par->window,
+               (Byte *)zdict->buf + zdict->len - par->window_len,
+               par->window_len);
+    }
+    par->headerlen = deflate_header(
+        par->header, par->check, par->wbits, level, strategy,
+        zdict->buf != NULL,
+        zdict->buf != NULL ?
+            adler32(adler32(0, Z_NULL, 0), zdict->buf, (uInt)zdict->len) : 0);
+    return par;
+}
+
+static void
+parallel_state_free(parallel_state *par)
+{
+    if (par != NULL) {
+        PyMem_Free(par->pending);
+        PyMem_Free(par);
+    }
+}
+
+/* Compress data, then flush the compressor according to mode.  With
+   Z_NO_FLUSH, the input is kept until there are enough blocks for all the
+   threads. */
+static PyObject *
+parallel_compress(compobject *self, const Byte *data, Py_ssize_t len,
+                  int mode)
+{
+    parallel_state *par = self->par;
+    Py_ssize_t n, taillen = 0, window = (Py_ssize_t)1 << par->wbits;
+    PyObject *RetVal;
+    int flush;
+
+    if (len > par->pending_size - par->pending_len) {
+        Py_ssize_t size;
+        Byte *pending;
+        if (len > PY_SSIZE_T_MAX - par->pending_len) {
+            PyErr_NoMemory();
+            return NULL;
+        }
+        size = par->pending_len + len;
+        if (size < PY_SSIZE_T_MAX / 2)
+            size = Py_MAX(size, par->pending_size * 2);
+        pending = PyMem_Realloc(par->pending, size);
+        if (pending == NULL) {
+            PyErr_NoMemory();
+            return NULL;
+        }
+        par->pending = pending;
+        par->pending_size = size;
+    }
+    if (len > 0) {
+        memcpy(par->pending + par->pending_len, data, len);
+        par->pending_len += len;
+    }
+
+    if (mode == Z_NO_FLUSH) {
+        if (par->pending_len < (Py_ssize_t)par->threads * PARALLEL_BLOCK_SIZE) {
+            RetVal = PyBytes_FromStringAndSize((char *)par->header,
+                                               par->headerlen);
+            if (RetVal != NULL)
+                par->headerlen = 0;
+            return RetVal;
+        }
+        n = par->pending_len - par->pending_len % PARALLEL_BLOCK_SIZE;
+        flush = Z_SYNC_FLUSH;
+    }
+    else {
+        n = par->pending_len;
+        flush = (mode == Z_FINISH) ? Z_FINISH : Z_SYNC_FLUSH;
+        if (mode == Z_FINISH)
+            taillen = deflate_trailer_size(par->check);
+    }
+
+    RetVal = parallel_deflate(par->window, par->window_len, par->pending, n,
+                              par->level, par->wbits, par->memLevel,
+                              par->strategy, par->threads, flush,
+                              par->check, &par->checksum,
+                              par->header, par->headerlen, taillen);
+    if (RetVal == NULL)
+        return NULL;
+    par->headerlen = 0;
+    par->total_in += (uLong)n;
+    if (taillen > 0) {
+        deflate_trailer((Byte *)PyBytes_AS_STRING(RetVal) +
+                            PyBytes_GET_SIZE(RetVal) - taillen,
+                        par->check, par->checksum, par->total_in);
+    }
+
+    /* Keep the end of the compressed input as the window of the next
+       blocks, unless the stream must be decompressible from here. */
+    if (mode == Z_FULL_FLUSH) {
+        par->window_len = 0;
+    }
+    else if (n >= window) {
+        memcpy(par->window, par->pending + n - window, window);
+        par->window_len = window;
+    }
+    else {
+        Py_ssize_t keep = Py_MIN(par->window_len, window - n);
+        memmove(par->window, par->window + par->window_len - keep, keep);
+        memcpy(par->window + keep, par->pending, n);
+        par->window_len = keep + n;
+    }
+    memmove(par->pending, par->pending + n, par->pending_len - n);
+    par->pending_len -= n;
+    return RetVal;
+}
+
+/* Convert the threads argument of compress() and compressobj(), 0 meaning
+   the number of CPUs. */
+static int
+check_threads(int *threads)
+{
+    if (*threads < 0) {
+        PyErr_SetString(PyExc_ValueError, "threads must not be negative");
+        return -1;
+    }
+    if (*threads == 0)
+        *threads = cpu_count();
+    return 0;
+}
+
 /*[clinic input]
 zlib.compress
 
@@ -207,13 +717,17 @@ zlib.compress
     /
     level: int(c_default="Z_DEFAULT_COMPRESSION") = Z_DEFAULT_COMPRESSION
         Compression level, in 0-9 or -1.
+    *
+    threads: int = 1
+        Number of threads used to compress the data; 0 means the number
+        of CPUs.
 
 Returns a bytes object containing compressed data.
 [clinic start generated code]*/
 
 static PyObject *
-zlib_compress_impl(PyObject *module, Py_buffer *data, int level)
-/*[clinic end generated code: output=d80906d73f6294c8 input=638d54b6315dbed3]*/
+zlib_compress_impl(PyObject *module, Py_buffer *data, int level, int threads)
+/*[clinic end generated code: output=c4c9e402a303e81d input=7a5bdeeac83817b9]*/
 {
     PyObject *RetVal = NULL;
     Byte *ibuf;
@@ -224,6 +738,32 @@ zlib_compress_impl(PyObject *module, Py_buffer *data, int level)
     ibuf = data->buf;
     ibuflen = data->len;
 
+    if (check_threads(&threads) < 0)
+        return NULL;
+    if (threads > 1 && ibuflen > PARALLEL_BLOCK_SIZE) {
+        Byte header[10];
+        Py_ssize_t headerlen;
+        uLong checksum = adler32(0, Z_NULL, 0);
+
+        if (level < Z_DEFAULT_COMPRESSION || level > Z_BEST_COMPRESSION) {
+            PyErr_SetString(_zlibstate_global->ZlibError,
+                            "Bad compression level");
+            return NULL;
+        }
+        headerlen = deflate_header(header, CHECK_ADLER32, MAX_WBITS, level,
+                                   Z_DEFAULT_STRATEGY, 0, 0);
+        RetVal = parallel_deflate(NULL, 0, ibuf, ibuflen, level, MAX_WBITS,
+                                  DEF_MEM_LEVEL, Z_DEFAULT_STRATEGY, threads,
+                                  Z_FINISH, CHECK_ADLER32, &checksum,
+                                  header, headerlen, 4);
+        if (RetVal != NULL) {
+            deflate_trailer((Byte *)PyBytes_AS_STRING(RetVal) +
+                                PyBytes_GET_SIZE(RetVal) - 4,
+                            CHECK_ADLER32, checksum, 0);
+        }
+        return RetVal;
+    }
+
     zst.opaque = NULL;
     zst.zalloc = PyZlib_Malloc;
     zst.zfree = PyZlib_Free;
@@ -425,14 +965,20 @@ zlib.compressobj
     zdict: Py_buffer = None
         The predefined compression dictionary - a sequence of bytes
         containing subsequences that are likely to occur in the input data.
+    *
+    threads: int = 1
+        Number of threads used to compress the data; 0 means the number
+        of CPUs.  With more than one thread, the input is compressed by
+        blocks of 128 KiB.
 
 Return a compressor object.
 [clinic start generated code]*/
 
 static PyObject *
 zlib_compressobj_impl(PyObject *module, int level, int method, int wbits,
-                      int memLevel, int strategy, Py_buffer *zdict)
-/*[clinic end generated code: output=8b5bed9c8fc3814d input=2fa3d026f90ab8d5]*/
+                      int memLevel, int strategy, Py_buffer *zdict,
+                      int threads)
+/*[clinic end generated code: output=6ba7bdf0ac76db9a input=ef2cdc0d6b83f514]*/
 {
     compobject *self = NULL;
     int err;
@@ -442,6 +988,8 @@ zlib_compressobj_impl(PyObject *module, int level, int method, int wbits,
                         "zdict length does not fit in an unsigned int");
         goto error;
     }
+    if (check_threads(&threads) < 0)
+        goto error;
 
     self = newcompobject(_zlibstate_global->Comptype);
     if (self == NULL)
@@ -456,13 +1004,13 @@ zlib_compressobj_impl(PyObject *module, int level, int method, int wbits,
     case Z_OK:
         self->is_initialised = 1;
         if (zdict->buf == NULL) {
-            goto success;
+            goto initialised;
         } else {
             err = deflateSetDictionary(&self->zst,
                                        zdict->buf, (unsigned int)zdict->len);
             switch (err) {
             case Z_OK:
-                goto success;
+                goto initialised;
             case Z_STREAM_ERROR:
                 PyErr_SetString(PyExc_ValueError, "Invalid dictionary");
                 goto error;
@@ -483,6 +1031,14 @@ zlib_compressobj_impl(PyObject *module, int level, int method, int wbits,
         goto error;
     }
 
+ initialised:
+    /* The stream initialised above is only used to check the arguments */
+    if (threads <= 1)
+        goto success;
+    self->par = parallel_state_new(threads, level, wbits, memLevel,
+                                   strategy, zdict);
+    if (self->par != NULL)
+        goto success;
  error:
     Py_CLEAR(self);
  success:
@@ -603,6 +1159,7 @@ Comp_dealloc(compobject *self)
 {
     if (self->is_initialised)
         deflateEnd(&self->zst);
+    parallel_state_free(self->par);
     Dealloc(self);
 }
 
@@ -636,6 +1193,16 @@ zlib_Compress_compress_impl(compobject *self, Py_buffer *data)
     Py_ssize_t ibuflen, obuflen = DEF_BUF_SIZE;
     int err;
 
+    if (self->par != NULL) {
+        ENTER_ZLIB(self);
+        if (self->is_initialised)
+            RetVal = parallel_compress(self, data->buf, data->len, Z_NO_FLUSH);
+        else
+            zlib_error(self->zst, Z_STREAM_ERROR, "while compressing data");
+        LEAVE_ZLIB(self);
+        return RetVal;
+    }
+
     self->zst.next_in = data->buf;
     ibuflen = data->len;
 
@@ -859,6 +1426,20 @@ zlib_Compress_flush_impl(compobject *self, int mode)
 
     ENTER_ZLIB(self);
 
+    if (self->par != NULL) {
+        if (!self->is_initialised) {
+            /* Like deflate() on a finished stream */
+            zlib_error(self->zst, Z_STREAM_ERROR, "while flushing");
+            goto error;
+        }
+        RetVal = parallel_compress(self, NULL, 0, mode);
+        if (RetVal != NULL && mode == Z_FINISH) {
+            deflateEnd(&self->zst);
+            self->is_initialised = 0;
+        }
+        goto error;
+    }
+
     self->zst.avail_in = 0;
 
     do {
@@ -960,6 +1541,27 @@ zlib_Compress_copy_impl(compobject *self)
     /* Mark it as being initialized */
     retval->is_initialised = 1;
 
+    if (self->par != NULL) {
+        retval->par = PyMem_Malloc(sizeof(parallel_state));
+        if (retval->par == NULL) {
+            PyErr_NoMemory();
+            goto error;
+        }
+        memcpy(retval->par, self->par, sizeof(parallel_state));
+        retval->par->pending = NULL;
+        retval->par->pending_size = 0;
+        if (self->par->pending_len > 0) {
+            retval->par->pending = PyMem_Malloc(self->par->pending_len);
+            if (retval->par->pending == NULL) {
+                PyErr_NoMemory();
+                goto error;
+            }
+            memcpy(retval->par->pending, self->par->pending,
+                   self->par->pending_len);
+            retval->par->pending_size = self->par->pending_len;
+        }
+    }
+
     LEAVE_ZLIB(self);
     return (PyObject *)retval;
 
@@ -4,6 +4,7 @@
 #include "Python.h"
 #include "pycore_abstract.h"      // _PyIndex_Check()
 #include "pycore_bytes_methods.h"
+#include "pycore_cpuinfo.h"      // _Py_GetSIMDLevel()
 #include "pycore_object.h"
 #include "bytesobject.h"
 #include "pystrhex.h"
@@ -260,6 +260,8 @@ PyCode_NewWithPosOnlyArgs(int argcount, int posonlyargcount, int kwonlyargcount,
     co->co_opcache = NULL;
     co->co_opcache_flag = 0;
     co->co_opcache_size = 0;
+    co->co_quickened = NULL;
+    co->co_adaptive_counters = NULL;
     return co;
 }
 
@@ -293,8 +295,9 @@ _PyCode_InitOpcache(PyCodeObject *co)
         unsigned char opcode = _Py_OPCODE(opcodes[i]);
         i++;  // 'i' is now aligned to (next_instr - first_instr)
 
-        // TODO: LOAD_METHOD, LOAD_ATTR
-        if (opcode == LOAD_GLOBAL) {
+        if (opcode == LOAD_GLOBAL || opcode == LOAD_ATTR ||
+            opcode == STORE_ATTR || opcode == LOAD_METHOD)
+        {
             opts++;
             co->co_opcache_map[i] = (unsigned char)opts;
             if (opts > 254) {
@@ -320,6 +323,49 @@ _PyCode_InitOpcache(PyCodeObject *co)
     return 0;
 }
 
+int
+_PyCode_Quicken(PyCodeObject *co)
+{
+    Py_ssize_t co_size = PyBytes_Size(co->co_code) / sizeof(_Py_CODEUNIT);
+    _Py_CODEUNIT *quickened = (_Py_CODEUNIT *)PyMem_Malloc(
+        co_size * (sizeof(_Py_CODEUNIT) + sizeof(uint16_t)));
+    if (quickened == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    memcpy(quickened, PyBytes_AS_STRING(co->co_code),
+           co_size * sizeof(_Py_CODEUNIT));
+    co->co_adaptive_counters = (uint16_t *)(quickened + co_size);
+    memset(co->co_adaptive_counters, 0, co_size * sizeof(uint16_t));
+
+    /* The adaptive instructions specialize themselves for the types of
+       their operands the first time they are executed. */
+    for (Py_ssize_t i = 0; i < co_size; i++) {
+        int opcode = _Py_OPCODE(quickened[i]);
+        int oparg = _Py_OPARG(quickened[i]);
+        switch (opcode) {
+            case BINARY_ADD:
+                opcode = BINARY_ADD_ADAPTIVE;
+                break;
+            case INPLACE_ADD:
+                opcode = INPLACE_ADD_ADAPTIVE;
+                break;
+            case BINARY_SUBSCR:
+                opcode = BINARY_SUBSCR_ADAPTIVE;
+                break;
+            case COMPARE_OP:
+                opcode = COMPARE_OP_ADAPTIVE;
+                break;
+            default:
+                continue;
+        }
+        quickened[i] = _Py_MAKECODEUNIT(opcode, oparg);
+    }
+
+    co->co_quickened = quickened;
+    return 0;
+}
+
 PyCodeObject *
 PyCode_NewEmpty(const char *filename, const char *funcname, int firstlineno)
 {
@@ -551,6 +597,9 @@ code_dealloc(PyCodeObject *co)
     if (co->co_opcache_map != NULL) {
         PyMem_FREE(co->co_opcache_map);
     }
+    if (co->co_quickened != NULL) {
+        PyMem_FREE(co->co_quickened);
+    }
     co->co_opcache_flag = 0;
     co->co_opcache_size = 0;
 
@@ -607,6 +656,11 @@ code_sizeof(PyCodeObject *co, PyObject *Py_UNUSED(args))
         // co_opcache
         res += co->co_opcache_size * sizeof(_PyOpcache);
     }
+    if (co->co_quickened != NULL) {
+        // co_quickened and co_adaptive_counters
+        res += PyBytes_GET_SIZE(co->co_code) / sizeof(_Py_CODEUNIT) *
+               (sizeof(_Py_CODEUNIT) + sizeof(uint16_t));
+    }
     return PyLong_FromSsize_t(res);
 }
 
@@ -46,6 +46,12 @@ struct _dictkeysobject {
     /* Number of used entries in dk_entries. */
     Py_ssize_t dk_nentries;
 
+    /* Version of the set of keys, or 0 if no version has been assigned.
+       It is reset to 0 whenever a key is added to or removed from
+       dk_entries, so a non-zero dk_version identifies one exact
+       key-to-index layout.  See _PyDict_GetKeysVersion(). */
+    uint32_t dk_version;
+
     /* Actual hash table of dk_size entries. It holds indices in dk_entries,
        or DKIX_EMPTY(-1) or DKIX_DUMMY(-2).
 
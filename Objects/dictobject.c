@@ -246,6 +246,11 @@ static uint64_t pydict_global_version = 0;
 
 #define DICT_NEXT_VERSION() (++pydict_global_version)
 
+/* Global counter used to set dk_version field of dictionary keys.
+ * Zero means "no version", so the counter stops handing out versions once
+ * it wraps around. */
+static uint32_t pydict_next_keys_version = 1;
+
 /* Dictionary reuse scheme to save calls to malloc and free */
 #ifndef PyDict_MAXFREELIST
 #define PyDict_MAXFREELIST 80
@@ -453,6 +458,7 @@ static PyDictKeysObject empty_keys_struct = {
         lookdict_split, /* dk_lookup */
         0, /* dk_usable (immutable) */
         0, /* dk_nentries */
+        0, /* dk_version */
         {DKIX_EMPTY, DKIX_EMPTY, DKIX_EMPTY, DKIX_EMPTY,
          DKIX_EMPTY, DKIX_EMPTY, DKIX_EMPTY, DKIX_EMPTY}, /* dk_indices */
 };
@@ -589,6 +595,7 @@ static PyDictKeysObject *new_keys_object(Py_ssize_t size)
     dk->dk_usable = usable;
     dk->dk_lookup = lookdict_unicode_nodummy;
     dk->dk_nentries = 0;
+    dk->dk_version = 0;
     memset(&dk->dk_indices[0], 0xff, es * size);
     memset(DK_ENTRIES(dk), 0, sizeof(PyDictKeyEntry) * usable);
     return dk;
@@ -683,6 +690,7 @@ clone_combined_dict(PyDictObject *orig)
     }
 
     memcpy(keys, orig->ma_keys, keys_size);
+    keys->dk_version = 0;
 
     /* After copying key/value pairs, we need to incref all
        keys and values and they are about to be co-owned by a
@@ -1106,6 +1114,7 @@ insertdict(PyDictObject *mp, PyObject *key, Py_hash_t hash, PyObject *value)
         mp->ma_version_tag = DICT_NEXT_VERSION();
         mp->ma_keys->dk_usable--;
         mp->ma_keys->dk_nentries++;
+        mp->ma_keys->dk_version = 0;
         assert(mp->ma_keys->dk_usable >= 0);
         ASSERT_CONSISTENT(mp);
         return 0;
@@ -1546,6 +1555,119 @@ _PyDict_LoadGlobal(PyDictObject *globals, PyDictObject *builtins, PyObject *key)
     return value;
 }
 
+/* Fast lookup of a string key for the attribute caches in ceval.c.
+
+   `hint` is an entry index returned by a previous call.  If the entry at
+   `hint` still holds `key`, its value is returned without probing the hash
+   table.  Otherwise do a regular lookup.
+
+   Store a borrowed reference to the value in *value (NULL if the key is
+   missing) and return the index of the entry, DKIX_EMPTY if the key is
+   missing, or DKIX_ERROR if an exception was raised. */
+Py_ssize_t
+_PyDict_GetItemHint(PyDictObject *mp, PyObject *key,
+                    Py_ssize_t hint, PyObject **value)
+{
+    PyDictKeysObject *keys = mp->ma_keys;
+    Py_hash_t hash;
+
+    assert(*value == NULL);
+    assert(PyDict_CheckExact((PyObject *)mp));
+    assert(PyUnicode_CheckExact(key));
+
+    if (hint >= 0 && hint < keys->dk_nentries) {
+        PyObject *res;
+        PyDictKeyEntry *ep = &DK_ENTRIES(keys)[hint];
+
+        if (ep->me_key == key) {
+            if (_PyDict_HasSplitTable(mp)) {
+                res = mp->ma_values[hint];
+            }
+            else {
+                res = ep->me_value;
+            }
+            if (res != NULL) {
+                *value = res;
+                return hint;
+            }
+        }
+    }
+
+    if ((hash = ((PyASCIIObject *) key)->hash) == -1) {
+        hash = PyObject_Hash(key);
+        if (hash == -1) {
+            return DKIX_ERROR;
+        }
+    }
+    return keys->dk_lookup(mp, key, hash, value);
+}
+
+/* Store `value` at the entry index `hint` previously returned by
+   _PyDict_GetItemHint().  Only the cases which leave the set of keys
+   untouched are handled: replacing the value of an existing key, and
+   filling the next pending value of a split table.
+
+   Return 1 on success, or 0 if the hint cannot be used and the caller
+   must fall back to the generic path.  Never raises an exception. */
+int
+_PyDict_SetItemHint(PyDictObject *mp, PyObject *key,
+                    Py_ssize_t hint, PyObject *value)
+{
+    PyDictKeysObject *keys = mp->ma_keys;
+    PyObject *old_value;
+
+    assert(PyDict_CheckExact((PyObject *)mp));
+    assert(value != NULL);
+
+    if (hint < 0 || hint >= keys->dk_nentries ||
+        DK_ENTRIES(keys)[hint].me_key != key)
+    {
+        return 0;
+    }
+
+    if (_PyDict_HasSplitTable(mp)) {
+        old_value = mp->ma_values[hint];
+        /* Insertion order must match the shared keys */
+        if (old_value == NULL && mp->ma_used != hint) {
+            return 0;
+        }
+    }
+    else {
+        old_value = DK_ENTRIES(keys)[hint].me_value;
+        assert(old_value != NULL);
+    }
+
+    Py_INCREF(value);
+    MAINTAIN_TRACKING(mp, key, value);
+    if (_PyDict_HasSplitTable(mp)) {
+        if (old_value == NULL) {
+            mp->ma_used++;
+        }
+        mp->ma_values[hint] = value;
+    }
+    else {
+        DK_ENTRIES(keys)[hint].me_value = value;
+    }
+    mp->ma_version_tag = DICT_NEXT_VERSION();
+    Py_XDECREF(old_value); /* which **CAN** re-enter (see issue #22653) */
+    ASSERT_CONSISTENT(mp);
+    return 1;
+}
+
+/* Return the version of the keys of `mp`, assigning a new one if needed.
+   Two dictionaries with the same non-zero keys version have the same keys
+   stored at the same indices.  Return 0 if no version can be assigned. */
+uint32_t
+_PyDict_GetKeysVersion(PyDictObject *mp)
+{
+    PyDictKeysObject *keys = mp->ma_keys;
+
+    if (keys->dk_version == 0 && pydict_next_keys_version != 0) {
+        keys->dk_version = pydict_next_keys_version++;
+    }
+    return keys->dk_version;
+}
+
 /* CAUTION: PyDict_SetItem() must guarantee that it won't resize the
  * dictionary if it's merely replacing the value for an existing key.
  * This means that it's safe to loop over a dictionary with PyDict_Next()
@@ -1616,6 +1738,7 @@ delitem_common(PyDictObject *mp, Py_hash_t hash, Py_ssize_t ix,
     ep = &DK_ENTRIES(mp->ma_keys)[ix];
     dictkeys_set_index(mp->ma_keys, hashpos, DKIX_DUMMY);
     ENSURE_ALLOWS_DELETIONS(mp);
+    mp->ma_keys->dk_version = 0;
     old_key = ep->me_key;
     ep->me_key = NULL;
     ep->me_value = NULL;
@@ -1887,6 +2010,7 @@ _PyDict_Pop_KnownHash(PyObject *dict, PyObject *key, Py_hash_t hash, PyObject *d
     dictkeys_set_index(mp->ma_keys, hashpos, DKIX_DUMMY);
     ep = &DK_ENTRIES(mp->ma_keys)[ix];
     ENSURE_ALLOWS_DELETIONS(mp);
+    mp->ma_keys->dk_version = 0;
     old_key = ep->me_key;
     ep->me_key = NULL;
     ep->me_value = NULL;
@@ -2991,6 +3115,7 @@ PyDict_SetDefault(PyObject *d, PyObject *key, PyObject *defaultobj)
         mp->ma_version_tag = DICT_NEXT_VERSION();
         mp->ma_keys->dk_usable--;
         mp->ma_keys->dk_nentries++;
+        mp->ma_keys->dk_version = 0;
         assert(mp->ma_keys->dk_usable >= 0);
     }
     else if (value == NULL) {
@@ -3121,6 +3246,7 @@ dict_popitem_impl(PyDictObject *self)
     ep->me_value = NULL;
     /* We can't dk_usable++ since there is DKIX_DUMMY in indices */
     self->ma_keys->dk_nentries = i;
+    self->ma_keys->dk_version = 0;
     self->ma_used--;
     self->ma_version_tag = DICT_NEXT_VERSION();
     ASSERT_CONSISTENT(self);
@@ -4,6 +4,7 @@
 
 #include "Python.h"
 #include "pycore_interp.h"    // _PY_NSMALLPOSINTS
+#include "pycore_long.h"      // _PyLong_Add()
 #include "pycore_pystate.h"   // _Py_IsMainInterpreter()
 #include "longintrepr.h"
 
@@ -89,6 +90,31 @@ _PyLong_Negate(PyLongObject **x_p)
 #define KARATSUBA_CUTOFF 70
 #define KARATSUBA_SQUARE_CUTOFF (2 * KARATSUBA_CUTOFF)
 
+/* Above NTT_CUTOFF digits in the smaller operand, multiplication by
+ * number-theoretic transform (ntt_mul) is used, as long as the product
+ * fits in the largest transform.  Toom-Cook 3-way multiplication (toom3_mul)
+ * beats Karatsuba only a bit above TOOM3_CUTOFF digits; it is used for the
+ * products too large for the transform, and on platforms with 15-bit digits,
+ * where ntt_mul isn't available.
+ */
+#define TOOM3_CUTOFF 3000
+#define NTT_CUTOFF 1500
+/* The largest transform length the primes used by ntt_mul allow */
+#define NTT_MAX_LENGTH ((Py_ssize_t)1 << 24)
+
+/* For int division, use the recursive Burnikel-Ziegler algorithm when both
+ * the divisor and the quotient have more than BZ_DIV_CUTOFF digits.
+ */
+#define BZ_DIV_CUTOFF 40
+
+/* Conversion between int and decimal strings is quadratic time with the
+ * simple algorithms.  Ints of more than DEC_TO_STR_CUTOFF digits, and
+ * strings of more than DEC_FROM_STR_CUTOFF decimal digits, are converted
+ * by divide-and-conquer instead.
+ */
+#define DEC_TO_STR_CUTOFF 100
+#define DEC_FROM_STR_CUTOFF 3000
+
 /* For exponentiation, use the binary left-to-right algorithm
  * unless the exponent contains more than FIVEARY_CUTOFF digits.
  * In that case, do 5 bits at a time.  The potential drawback is that
@@ -1574,6 +1600,40 @@ divrem1(PyLongObject *a, digit n, digit *prem)
     return long_normalize(z);
 }
 
+/* Convert the digit vector pin[0:size_a] to an array of base
+   _PyLong_DECIMAL_BASE digits in pout, following Knuth (TAOCP, Volume 2
+   (3rd edn), section 4.4, Method 1b).  pout must have room for all the
+   digits.  Returns the number of digits stored, or -1 if interrupted. */
+
+static Py_ssize_t
+x_to_decimal(const digit *pin, Py_ssize_t size_a, digit *pout)
+{
+    Py_ssize_t size = 0, i, j;
+
+    for (i = size_a; --i >= 0; ) {
+        digit hi = pin[i];
+        for (j = 0; j < size; j++) {
+            twodigits z = (twodigits)pout[j] << PyLong_SHIFT | hi;
+            hi = (digit)(z / _PyLong_DECIMAL_BASE);
+            pout[j] = (digit)(z - (twodigits)hi *
+                              _PyLong_DECIMAL_BASE);
+        }
+        while (hi) {
+            pout[size++] = hi % _PyLong_DECIMAL_BASE;
+            hi /= _PyLong_DECIMAL_BASE;
+        }
+        /* check for keyboard interrupt */
+        SIGCHECK({
+                return -1;
+            });
+    }
+    return size;
+}
+
+/* forward */
+static PyLongObject *long_to_decimal_digits
+    (PyLongObject *, Py_ssize_t, Py_ssize_t *);
+
 /* Convert an integer to a base 10 string.  Returns a new non-shared
    string.  (Return value is non-shared so that callers can modify the
    returned value if necessary.) */
@@ -1588,7 +1648,7 @@ long_to_decimal_string_internal(PyObject *aa,
     PyLongObject *scratch, *a;
     PyObject *str = NULL;
     Py_ssize_t size, strlen, size_a, i, j;
-    digit *pout, *pin, rem, tenpow;
+    digit *pout, rem, tenpow;
     int negative;
     int d;
     enum PyUnicode_Kind kind;
@@ -1619,33 +1679,23 @@ long_to_decimal_string_internal(PyObject *aa,
         (10 * PyLong_SHIFT - 33 * _PyLong_DECIMAL_SHIFT);
     assert(size_a < PY_SSIZE_T_MAX/2);
     size = 1 + size_a + size_a / d;
-    scratch = _PyLong_New(size);
-    if (scratch == NULL)
-        return -1;
 
-    /* convert array of base _PyLong_BASE digits in pin to an array of
-       base _PyLong_DECIMAL_BASE digits in pout, following Knuth (TAOCP,
-       Volume 2 (3rd edn), section 4.4, Method 1b). */
-    pin = a->ob_digit;
-    pout = scratch->ob_digit;
-    size = 0;
-    for (i = size_a; --i >= 0; ) {
-        digit hi = pin[i];
-        for (j = 0; j < size; j++) {
-            twodigits z = (twodigits)pout[j] << PyLong_SHIFT | hi;
-            hi = (digit)(z / _PyLong_DECIMAL_BASE);
-            pout[j] = (digit)(z - (twodigits)hi *
-                              _PyLong_DECIMAL_BASE);
-        }
-        while (hi) {
-            pout[size++] = hi % _PyLong_DECIMAL_BASE;
-            hi /= _PyLong_DECIMAL_BASE;
+    if (size_a > DEC_TO_STR_CUTOFF) {
+        scratch = long_to_decimal_digits(a, size, &size);
+        if (scratch == NULL)
+            return -1;
+        pout = scratch->ob_digit;
+    }
+    else {
+        scratch = _PyLong_New(size);
+        if (scratch == NULL)
+            return -1;
+        pout = scratch->ob_digit;
+        size = x_to_decimal(a->ob_digit, size_a, pout);
+        if (size < 0) {
+            Py_DECREF(scratch);
+            return -1;
         }
-        /* check for keyboard interrupt */
-        SIGCHECK({
-                Py_DECREF(scratch);
-                return -1;
-            });
     }
     /* pout should have at least one digit, so that the case when a = 0
        works correctly */
@@ -2104,6 +2154,10 @@ long_from_binary_base(const char **str, int base, PyLongObject **res)
     return 0;
 }
 
+/* forward */
+static PyLongObject *long_from_decimal_string
+    (const char *, const char *, Py_ssize_t);
+
 /* Parses an int from a bytestring. Leading and trailing whitespace will be
  * ignored.
  *
@@ -2184,6 +2238,8 @@ PyLong_FromString(const char *str, char **pend, int base)
 Binary bases can be converted in time linear in the number of digits, because
 Python's representation base is binary.  Other bases (including decimal!) use
 the simple quadratic-time algorithm below, complicated by some speed tricks.
+Long decimal strings are the exception:  long_from_decimal_string() converts
+them by divide-and-conquer, in subquadratic time.
 
 First some math:  the largest integer that can be expressed in N base-B digits
 is B**N-1.  Consequently, if we have an N-digit input in base B, the worst-
@@ -2336,6 +2392,15 @@ digit beyond the first.
                             "too many digits in integer");
             return NULL;
         }
+        if (base == 10 && digits > DEC_FROM_STR_CUTOFF) {
+            /* Subquadratic conversion of long decimal strings */
+            z = long_from_decimal_string(str, scan, digits);
+            if (z == NULL) {
+                return NULL;
+            }
+            str = scan;
+            goto digits_done;
+        }
         size_z = (Py_ssize_t)fsize_z;
         /* Uncomment next line to test exceedingly rare copy code */
         /* size_z = 1; */
@@ -2416,6 +2481,7 @@ digit beyond the first.
             }
         }
     }
+  digits_done:
     if (z == NULL) {
         return NULL;
     }
@@ -2536,6 +2602,8 @@ PyLong_FromUnicodeObject(PyObject *u, int base)
 /* forward */
 static PyLongObject *x_divrem
     (PyLongObject *, PyLongObject *, PyLongObject **);
+static int bz_divrem
+    (PyLongObject *, PyLongObject *, PyLongObject **, PyLongObject **);
 static PyObject *long_long(PyObject *v);
 
 /* Int division with remainder, top-level routine */
@@ -2575,6 +2643,10 @@ long_divrem(PyLongObject *a, PyLongObject *b,
             return -1;
         }
     }
+    else if (size_b > BZ_DIV_CUTOFF && size_a - size_b > BZ_DIV_CUTOFF) {
+        if (bz_divrem(a, b, &z, prem) < 0)
+            return -1;
+    }
     else {
         z = x_divrem(a, b, prem);
         if (z == NULL)
@@ -2910,6 +2982,12 @@ long_compare(PyLongObject *a, PyLongObject *b)
     return sign;
 }
 
+Py_ssize_t
+_PyLong_Compare(PyLongObject *a, PyLongObject *b)
+{
+    return long_compare(a, b);
+}
+
 static PyObject *
 long_richcompare(PyObject *self, PyObject *other, int op)
 {
@@ -3070,13 +3148,11 @@ x_sub(PyLongObject *a, PyLongObject *b)
     return maybe_small_long(long_normalize(z));
 }
 
-static PyObject *
-long_add(PyLongObject *a, PyLongObject *b)
+PyObject *
+_PyLong_Add(PyLongObject *a, PyLongObject *b)
 {
     PyLongObject *z;
 
-    CHECK_BINOP(a, b);
-
     if (Py_ABS(Py_SIZE(a)) <= 1 && Py_ABS(Py_SIZE(b)) <= 1) {
         return PyLong_FromLong(MEDIUM_VALUE(a) + MEDIUM_VALUE(b));
     }
@@ -3104,6 +3180,13 @@ long_add(PyLongObject *a, PyLongObject *b)
     return (PyObject *)z;
 }
 
+static PyObject *
+long_add(PyLongObject *a, PyLongObject *b)
+{
+    CHECK_BINOP(a, b);
+    return _PyLong_Add(a, b);
+}
+
 static PyObject *
 long_sub(PyLongObject *a, PyLongObject *b)
 {
@@ -3258,6 +3341,10 @@ kmul_split(PyLongObject *n,
 }
 
 static PyLongObject *k_lopsided_mul(PyLongObject *a, PyLongObject *b);
+static PyLongObject *toom3_mul(PyLongObject *a, PyLongObject *b);
+#if PyLong_SHIFT == 30
+static PyLongObject *ntt_mul(PyLongObject *a, PyLongObject *b);
+#endif
 
 /* Karatsuba multiplication.  Ignores the input signs, and returns the
  * absolute value of the product (or NULL if error).
@@ -3313,9 +3400,23 @@ k_mul(PyLongObject *a, PyLongObject *b)
      * b as a string of "big digits", each of width a->ob_size.  That
      * leads to a sequence of balanced calls to k_mul.
      */
+#if PyLong_SHIFT == 30
+    /* For large enough inputs, the transform based multiplication wins,
+     * even when the sizes are unbalanced.
+     */
+    if (asize > NTT_CUTOFF && asize + bsize <= NTT_MAX_LENGTH)
+        return ntt_mul(a, b);
+#endif
+
     if (2 * asize <= bsize)
         return k_lopsided_mul(a, b);
 
+    /* Toom-Cook 3-way splits b in three; that's only worth it if a has a
+     * nonzero high piece too.
+     */
+    if (asize > TOOM3_CUTOFF && asize > 2 * ((bsize + 2) / 3))
+        return toom3_mul(a, b);
+
     /* Split a & b into hi & lo pieces. */
     shift = bsize >> 1;
     if (kmul_split(a, shift, &ah, &al) < 0) goto fail;
@@ -3538,6 +3639,534 @@ k_lopsided_mul(PyLongObject *a, PyLongObject *b)
     return NULL;
 }
 
+/* Return the nonnegative int made of the digits lo <= i < hi of abs(n),
+   that is (abs(n) >> lo*PyLong_SHIFT) % PyLong_BASE**(hi-lo).  hi may be
+   larger than the size of n.  Returns NULL on failure. */
+static PyLongObject *
+long_digit_slice(PyLongObject *n, Py_ssize_t lo, Py_ssize_t hi)
+{
+    PyLongObject *z;
+
+    hi = Py_MIN(hi, Py_ABS(Py_SIZE(n)));
+    if (hi <= lo)
+        return (PyLongObject *)PyLong_FromLong(0);
+    z = _PyLong_New(hi - lo);
+    if (z == NULL)
+        return NULL;
+    memcpy(z->ob_digit, n->ob_digit + lo, (hi - lo) * sizeof(digit));
+    return long_normalize(z);
+}
+
+/* Return abs(hi) * PyLong_BASE**n + abs(lo), which must be < PyLong_BASE**n.
+   The result is always a new object.  Returns NULL on failure. */
+static PyLongObject *
+long_digit_concat(PyLongObject *hi, PyLongObject *lo, Py_ssize_t n)
+{
+    const Py_ssize_t size_hi = Py_ABS(Py_SIZE(hi));
+    const Py_ssize_t size_lo = Py_ABS(Py_SIZE(lo));
+    PyLongObject *z;
+
+    assert(size_lo <= n);
+    z = _PyLong_New(size_hi ? n + size_hi : size_lo);
+    if (z == NULL)
+        return NULL;
+    memcpy(z->ob_digit, lo->ob_digit, size_lo * sizeof(digit));
+    if (size_hi) {
+        memset(z->ob_digit + size_lo, 0, (n - size_lo) * sizeof(digit));
+        memcpy(z->ob_digit + n, hi->ob_digit, size_hi * sizeof(digit));
+    }
+    return long_normalize(z);
+}
+
+/* Return x / n for a digit n that divides x exactly.  The sign of x is
+   kept.  Returns NULL on failure. */
+static PyLongObject *
+long_divexact1(PyLongObject *x, digit n)
+{
+    PyLongObject *z;
+    digit rem;
+
+    z = divrem1(x, n, &rem);
+    assert(rem == 0);
+    if (z != NULL && Py_SIZE(x) < 0)
+        Py_SET_SIZE(z, -Py_SIZE(z));
+    return z;
+}
+
+static PyObject *long_mul(PyLongObject *a, PyLongObject *b);
+
+/* A helper for Toom-Cook multiplication (toom3_mul).  Sets v[0], v[1] and
+   v[2] to the values of the polynomial x2*t**2 + x1*t + x0 at t = 1, -1
+   and -2.  Returns 0 on success, -1 on failure. */
+static int
+toom3_eval(PyLongObject *x0, PyLongObject *x1, PyLongObject *x2,
+           PyLongObject *v[3])
+{
+    PyLongObject *s, *t;
+
+    v[0] = v[1] = v[2] = NULL;
+    /* v[0] = x0 + x2 + x1, v[1] = x0 + x2 - x1 */
+    s = (PyLongObject *)long_add(x0, x2);
+    if (s == NULL)
+        return -1;
+    v[0] = (PyLongObject *)long_add(s, x1);
+    v[1] = (PyLongObject *)long_sub(s, x1);
+    Py_DECREF(s);
+    if (v[0] == NULL || v[1] == NULL)
+        goto fail;
+
+    /* v[2] = 2*(v[1] + x2) - x0 */
+    s = (PyLongObject *)long_add(v[1], x2);
+    if (s == NULL)
+        goto fail;
+    t = (PyLongObject *)long_add(s, s);
+    Py_DECREF(s);
+    if (t == NULL)
+        goto fail;
+    v[2] = (PyLongObject *)long_sub(t, x0);
+    Py_DECREF(t);
+    if (v[2] == NULL)
+        goto fail;
+    return 0;
+
+  fail:
+    Py_CLEAR(v[0]);
+    Py_CLEAR(v[1]);
+    Py_CLEAR(v[2]);
+    return -1;
+}
+
+/* Toom-Cook 3-way multiplication.  Ignores the input signs, and returns
+ * the absolute value of the product (or NULL if error).
+ *
+ * With X = PyLong_BASE**k, both inputs are split in three pieces of k
+ * digits, a = a2*X**2 + a1*X + a0, and likewise for b.  The product is the
+ * degree 4 polynomial r(X) = a(X)*b(X), whose coefficients are recovered
+ * from its values at 0, 1, -1, -2 and infinity.  That takes 5 products of
+ * pieces instead of the 9 of the schoolbook method.  The evaluation and
+ * interpolation sequences are those of M. Bodrato and A. Zanoni, "Integer
+ * and Polynomial Multiplication: Towards Optimal Toom-Cook Matrices",
+ * ISSAC 2007.
+ */
+static PyLongObject *
+toom3_mul(PyLongObject *a, PyLongObject *b)
+{
+    const Py_ssize_t asize = Py_ABS(Py_SIZE(a));
+    const Py_ssize_t bsize = Py_ABS(Py_SIZE(b));
+    const Py_ssize_t k = (bsize + 2) / 3;
+    PyLongObject *a0 = NULL, *a1 = NULL, *a2 = NULL;
+    PyLongObject *b0 = NULL, *b1 = NULL, *b2 = NULL;
+    PyLongObject *va[3] = {NULL, NULL, NULL};
+    PyLongObject *vb[3] = {NULL, NULL, NULL};
+    /* r0..r4 end up as the coefficients of r(X) */
+    PyLongObject *r[5] = {NULL, NULL, NULL, NULL, NULL};
+    PyLongObject *r1 = NULL, *rm1 = NULL, *rm2 = NULL;
+    PyLongObject *t = NULL, *ret = NULL;
+    Py_ssize_t i;
+
+    assert(asize <= bsize && asize > 2 * k);
+
+    if ((a0 = long_digit_slice(a, 0, k)) == NULL ||
+        (a1 = long_digit_slice(a, k, 2 * k)) == NULL ||
+        (a2 = long_digit_slice(a, 2 * k, asize)) == NULL)
+        goto fail;
+    if (toom3_eval(a0, a1, a2, va) < 0)
+        goto fail;
+    if (a == b) {
+        b0 = a0; b1 = a1; b2 = a2;
+        Py_INCREF(b0); Py_INCREF(b1); Py_INCREF(b2);
+        for (i = 0; i < 3; i++) {
+            vb[i] = va[i];
+            Py_INCREF(vb[i]);
+        }
+    }
+    else {
+        if ((b0 = long_digit_slice(b, 0, k)) == NULL ||
+            (b1 = long_digit_slice(b, k, 2 * k)) == NULL ||
+            (b2 = long_digit_slice(b, 2 * k, bsize)) == NULL)
+            goto fail;
+        if (toom3_eval(b0, b1, b2, vb) < 0)
+            goto fail;
+    }
+
+    /* Pointwise products.  For a square, the operands are the same
+       objects, so that k_mul still sees squares. */
+    if ((r[0] = (PyLongObject *)long_mul(a0, b0)) == NULL ||
+        (r1 = (PyLongObject *)long_mul(va[0], vb[0])) == NULL ||
+        (rm1 = (PyLongObject *)long_mul(va[1], vb[1])) == NULL ||
+        (rm2 = (PyLongObject *)long_mul(va[2], vb[2])) == NULL ||
+        (r[4] = (PyLongObject *)long_mul(a2, b2)) == NULL)
+        goto fail;
+
+    /* Interpolation:
+     *   r3 = (r(-2) - r(1)) / 3
+     *   r1 = (r(1) - r(-1)) / 2
+     *   r2 = r(-1) - r(0)
+     *   r3 = (r2 - r3) / 2 + 2*r(inf)
+     *   r2 = r2 + r1 - r(inf)
+     *   r1 = r1 - r3
+     * All the divisions are exact.
+     */
+#define TOOM3_STEP(target, expr)                                \
+    do {                                                        \
+        PyLongObject *_tmp = (PyLongObject *)(expr);            \
+        Py_XSETREF(target, _tmp);                               \
+        if (target == NULL)                                     \
+            goto fail;                                          \
+    } while (0)
+
+    TOOM3_STEP(t, long_sub(rm2, r1));
+    TOOM3_STEP(r[3], long_divexact1(t, 3));
+    TOOM3_STEP(t, long_sub(r1, rm1));
+    TOOM3_STEP(r[1], long_divexact1(t, 2));
+    TOOM3_STEP(r[2], long_sub(rm1, r[0]));
+    TOOM3_STEP(t, long_sub(r[2], r[3]));
+    TOOM3_STEP(t, long_divexact1(t, 2));
+    TOOM3_STEP(r[3], long_add(t, r[4]));
+    TOOM3_STEP(r[3], long_add(r[3], r[4]));
+    TOOM3_STEP(t, long_add(r[2], r[1]));
+    TOOM3_STEP(r[2], long_sub(t, r[4]));
+    TOOM3_STEP(r[1], long_sub(r[1], r[3]));
+#undef TOOM3_STEP
+
+    /* Add the coefficients into the result at their offsets.  They are
+       all nonnegative, and each partial sum is at most the product, so
+       no carry can get out of the result. */
+    ret = _PyLong_New(asize + bsize);
+    if (ret == NULL)
+        goto fail;
+    memset(ret->ob_digit, 0, Py_SIZE(ret) * sizeof(digit));
+    for (i = 0; i < 5; i++) {
+        assert(Py_SIZE(r[i]) >= 0);
+        if (Py_SIZE(r[i]) == 0)
+            continue;
+        assert(i * k + Py_SIZE(r[i]) <= Py_SIZE(ret));
+        (void)v_iadd(ret->ob_digit + i * k, Py_SIZE(ret) - i * k,
+                     r[i]->ob_digit, Py_SIZE(r[i]));
+    }
+    ret = long_normalize(ret);
+
+  fail:
+    Py_XDECREF(a0);
+    Py_XDECREF(a1);
+    Py_XDECREF(a2);
+    Py_XDECREF(b0);
+    Py_XDECREF(b1);
+    Py_XDECREF(b2);
+    for (i = 0; i < 3; i++) {
+        Py_XDECREF(va[i]);
+        Py_XDECREF(vb[i]);
+    }
+    for (i = 0; i < 5; i++)
+        Py_XDECREF(r[i]);
+    Py_XDECREF(r1);
+    Py_XDECREF(rm1);
+    Py_XDECREF(rm2);
+    Py_XDECREF(t);
+    return ret;
+}
+
+#if PyLong_SHIFT == 30
+
+/* Multiplication by number-theoretic transform (NTT).
+ *
+ * The digits of a and b are the coefficients of two polynomials, whose
+ * product is computed with a cyclic convolution of length a power of two,
+ * n >= asize + bsize - 1.  Each coefficient of the product is less than
+ * n * PyLong_BASE**2 <= 2**84, so it is determined by its residues modulo
+ * three primes p of about 30 bits, whose product is about 2**89.  The
+ * convolutions modulo each p are computed by transform, which takes
+ * O(n log n) operations, and the coefficients are recovered with the
+ * Chinese remainder theorem.  The primes are of the form c*2**m + 1, with
+ * m >= 24, so there are roots of unity of order up to 2**24 modulo all
+ * of them, hence NTT_MAX_LENGTH.
+ *
+ * The arithmetic modulo p uses Montgomery's reduction, with R = 2**32:
+ * the twiddle factors are kept multiplied by R, so that multiplying them
+ * by plain residues gives plain residues.
+ */
+
+typedef struct {
+    uint32_t p;         /* the modulus, < 2**31 */
+    uint32_t g;         /* a primitive root modulo p */
+} ntt_prime;
+
+static const ntt_prime ntt_primes[3] = {
+    {2013265921U, 31},  /* 15 * 2**27 + 1 */
+    {469762049U, 3},    /* 7 * 2**26 + 1 */
+    {754974721U, 11},   /* 45 * 2**24 + 1 */
+};
+
+typedef struct {
+    uint32_t p;
+    uint32_t pinv;      /* -1/p modulo 2**32 */
+} ntt_modulus;
+
+/* Return t / R modulo p, for t < p * R. */
+static inline uint32_t
+ntt_redc(uint64_t t, const ntt_modulus *m)
+{
+    uint32_t q = (uint32_t)t * m->pinv;
+    uint32_t u = (uint32_t)((t + (uint64_t)q * m->p) >> 32);
+    return u >= m->p ? u - m->p : u;
+}
+
+static inline uint32_t
+ntt_mulmod(uint32_t x, uint32_t y, const ntt_modulus *m)
+{
+    return ntt_redc((uint64_t)x * y, m);
+}
+
+/* Return -1/p modulo 2**32, for an odd p. */
+static uint32_t
+ntt_pinv(uint32_t p)
+{
+    /* Newton's iteration doubles the number of correct low bits of 1/p,
+       starting from the 3 bits of p itself. */
+    uint32_t inv = p;
+    int i;
+
+    for (i = 0; i < 4; i++)
+        inv *= 2 - p * inv;
+    return -inv;
+}
+
+/* Return x**e % p, without Montgomery's representation. */
+static uint32_t
+ntt_powmod(uint32_t x, uint64_t e, uint32_t p)
+{
+    uint64_t result = 1, base = x % p;
+
+    while (e) {
+        if (e & 1)
+            result = result * base % p;
+        base = base * base % p;
+        e >>= 1;
+    }
+    return (uint32_t)result;
+}
+
+/* Return d % p, for p > PyLong_BASE / 3. */
+static inline uint32_t
+ntt_reduce_digit(digit d, uint32_t p)
+{
+    uint32_t x = d;
+
+    if (x >= p)
+        x -= p;
+    if (x >= p)
+        x -= p;
+    return x;
+}
+
+/* Fill tw[1:n] with the twiddle factors of a transform of length n, given
+   w of order n:  for each half-length h = 1, 2, 4, ..., n/2 of the
+   butterflies, tw[h + j] = w**(j*n/(2*h)) * R % p, for 0 <= j < h. */
+static void
+ntt_twiddles(uint32_t *tw, Py_ssize_t n, uint32_t w, const ntt_modulus *m)
+{
+    const Py_ssize_t half = n >> 1;
+    const uint32_t wr = (uint32_t)(((uint64_t)w << 32) % m->p);
+    Py_ssize_t h, j;
+
+    tw[half] = (uint32_t)(((uint64_t)1 << 32) % m->p);
+    for (j = 1; j < half; j++)
+        tw[half + j] = ntt_mulmod(tw[half + j - 1], wr, m);
+    for (h = half >> 1; h >= 1; h >>= 1)
+        for (j = 0; j < h; j++)
+            tw[h + j] = tw[2*h + 2*j];
+}
+
+/* Forward transform, decimation in frequency.  The input is in natural
+   order and the output in bit-reversed order. */
+static void
+ntt_forward(uint32_t *x, Py_ssize_t n, const uint32_t *tw,
+            const ntt_modulus *m)
+{
+    const uint32_t p = m->p;
+    Py_ssize_t h, s, j;
+
+    for (h = n >> 1; h >= 1; h >>= 1) {
+        for (s = 0; s < n; s += 2*h) {
+            uint32_t *x0 = x + s, *x1 = x + s + h;
+            for (j = 0; j < h; j++) {
+                uint32_t u = x0[j], v = x1[j];
+                uint32_t sum = u + v, diff = u + p - v;
+                x0[j] = sum >= p ? sum - p : sum;
+                x1[j] = ntt_mulmod(diff, tw[h + j], m);
+            }
+        }
+    }
+}
+
+/* Inverse transform, decimation in time, without the final division by n.
+   The input is in bit-reversed order and the output in natural order.
+   tw holds the twiddle factors of the inverse of the root used for the
+   forward transform. */
+static void
+ntt_inverse(uint32_t *x, Py_ssize_t n, const uint32_t *tw,
+            const ntt_modulus *m)
+{
+    const uint32_t p = m->p;
+    Py_ssize_t h, s, j;
+
+    for (h = 1; h < n; h <<= 1) {
+        for (s = 0; s < n; s += 2*h) {
+            uint32_t *x0 = x + s, *x1 = x + s + h;
+            for (j = 0; j < h; j++) {
+                uint32_t u = x0[j], v = ntt_mulmod(x1[j], tw[h + j], m);
+                uint32_t sum = u + v, diff = u + p - v;
+                x0[j] = sum >= p ? sum - p : sum;
+                x1[j] = diff >= p ? diff - p : diff;
+            }
+        }
+    }
+}
+
+/* Store the cyclic convolution of the digits of a and b modulo the prime
+   P into x[0:n].  y[0:n] and tw[0:n] are scratch space; y isn't used when
+   a is b. */
+static void
+ntt_convolve(PyLongObject *a, PyLongObject *b, const ntt_prime *P,
+             Py_ssize_t n, uint32_t *x, uint32_t *y, uint32_t *tw)
+{
+    const Py_ssize_t asize = Py_ABS(Py_SIZE(a));
+    const Py_ssize_t bsize = Py_ABS(Py_SIZE(b));
+    ntt_modulus m;
+    uint32_t w, scale;
+    Py_ssize_t i;
+
+    m.p = P->p;
+    m.pinv = ntt_pinv(P->p);
+
+    w = ntt_powmod(P->g, (P->p - 1) / (uint64_t)n, P->p);
+    ntt_twiddles(tw, n, w, &m);
+
+    /* The primes are all larger than PyLong_BASE / 3. */
+    for (i = 0; i < asize; i++)
+        x[i] = ntt_reduce_digit(a->ob_digit[i], P->p);
+    memset(x + asize, 0, (n - asize) * sizeof(uint32_t));
+    ntt_forward(x, n, tw, &m);
+    if (a == b) {
+        for (i = 0; i < n; i++)
+            x[i] = ntt_mulmod(x[i], x[i], &m);
+    }
+    else {
+        for (i = 0; i < bsize; i++)
+            y[i] = ntt_reduce_digit(b->ob_digit[i], P->p);
+        memset(y + bsize, 0, (n - bsize) * sizeof(uint32_t));
+        ntt_forward(y, n, tw, &m);
+        for (i = 0; i < n; i++)
+            x[i] = ntt_mulmod(x[i], y[i], &m);
+    }
+
+    /* The pointwise products above are divided by R.  Multiplying by
+       R**2/n (divided by R again) makes up for that and for the factor n
+       the inverse transform introduces. */
+    ntt_twiddles(tw, n, ntt_powmod(w, P->p - 2, P->p), &m);
+    ntt_inverse(x, n, tw, &m);
+    scale = (uint32_t)((uint64_t)ntt_powmod((uint32_t)n, P->p - 2, P->p) *
+                       ntt_powmod(2, 64, P->p) % P->p);
+    for (i = 0; i < n; i++)
+        x[i] = ntt_mulmod(x[i], scale, &m);
+}
+
+/* Multiply a and b by number-theoretic transform.  Ignores the input
+ * signs, and returns the absolute value of the product (or NULL if error).
+ */
+static PyLongObject *
+ntt_mul(PyLongObject *a, PyLongObject *b)
+{
+    const Py_ssize_t asize = Py_ABS(Py_SIZE(a));
+    const Py_ssize_t bsize = Py_ABS(Py_SIZE(b));
+    const uint64_t p1 = ntt_primes[0].p;
+    const uint64_t p2 = ntt_primes[1].p;
+    const uint64_t p3 = ntt_primes[2].p;
+    const uint64_t p12 = p1 * p2;
+    ntt_modulus m2, m3;
+    uint32_t c2, c3, c32;
+    uint64_t carry;
+    uint32_t *buf, *res[3], *y, *tw;
+    Py_ssize_t n, i, ncoeffs;
+    PyLongObject *z;
+    int k;
+
+    ncoeffs = asize + bsize - 1;
+    n = 2;
+    while (n < ncoeffs)
+        n <<= 1;
+    assert(n <= NTT_MAX_LENGTH);
+
+    buf = PyMem_New(uint32_t, 5 * n);
+    if (buf == NULL) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    res[0] = buf;
+    res[1] = buf + n;
+    res[2] = buf + 2 * n;
+    y = buf + 3 * n;
+    tw = buf + 4 * n;
+    for (k = 0; k < 3; k++) {
+        ntt_convolve(a, b, &ntt_primes[k], n, res[k], y, tw);
+        SIGCHECK({
+                PyMem_Free(buf);
+                return NULL;
+            });
+    }
+
+    z = _PyLong_New(asize + bsize);
+    if (z == NULL) {
+        PyMem_Free(buf);
+        return NULL;
+    }
+
+    /* Garner's algorithm:  a coefficient c with residues r1, r2 and r3 is
+     * c = r1 + p1*v2 + p1*p2*v3, where
+     *     v2 = (r2 - r1) / p1 % p2
+     *     v3 = ((r3 - r1) / (p1*p2) - v2 / p2) % p3
+     * The divisions are multiplications by inverses, with the constants
+     * multiplied by R for Montgomery's reduction.  The coefficients are
+     * added into z as they are found.  Splitting p1*p2 < 2**60 into two
+     * digits keeps all the intermediate values, including the carry, below
+     * 2**63.
+     */
+    m2.p = (uint32_t)p2;
+    m2.pinv = ntt_pinv(m2.p);
+    m3.p = (uint32_t)p3;
+    m3.pinv = ntt_pinv(m3.p);
+    c2 = ntt_powmod((uint32_t)(p1 % p2), p2 - 2, m2.p);
+    c2 = (uint32_t)(((uint64_t)c2 << 32) % p2);
+    c3 = ntt_powmod((uint32_t)(p12 % p3), p3 - 2, m3.p);
+    c3 = (uint32_t)(((uint64_t)c3 << 32) % p3);
+    c32 = ntt_powmod((uint32_t)p2, p3 - 2, m3.p);
+    c32 = (uint32_t)(((uint64_t)c32 << 32) % p3);
+    carry = 0;
+    for (i = 0; i < asize + bsize; i++) {
+        uint64_t c0 = carry, c1 = 0;
+        if (i < ncoeffs) {
+            /* p1 < 5*p2 and p1 < 3*p3 keep the differences positive */
+            uint32_t r1 = res[0][i], v2, v3, t;
+            uint64_t lo;
+            v2 = ntt_mulmod(res[1][i] + 5 * m2.p - r1, c2, &m2);
+            v3 = ntt_mulmod(res[2][i] + 3 * m3.p - r1, c3, &m3);
+            t = ntt_mulmod(v2, c32, &m3);
+            v3 = v3 >= t ? v3 - t : v3 + m3.p - t;
+            lo = r1 + p1 * v2;
+            c0 += (lo & PyLong_MASK) + (p12 & PyLong_MASK) * v3;
+            c1 = (lo >> PyLong_SHIFT) + (p12 >> PyLong_SHIFT) * v3;
+        }
+        z->ob_digit[i] = (digit)(c0 & PyLong_MASK);
+        carry = (c0 >> PyLong_SHIFT) + c1;
+    }
+    assert(carry == 0);
+
+    PyMem_Free(buf);
+    return long_normalize(z);
+}
+
+#endif /* PyLong_SHIFT == 30 */
+
 static PyObject *
 long_mul(PyLongObject *a, PyLongObject *b)
 {
@@ -3561,6 +4190,510 @@ long_mul(PyLongObject *a, PyLongObject *b)
     return (PyObject *)z;
 }
 
+/* Burnikel-Ziegler division.
+ *
+ * The schoolbook division x_divrem takes time proportional to the product
+ * of the sizes of the divisor and the quotient.  C. Burnikel and
+ * J. Ziegler, "Fast Recursive Division", MPI-I-98-1-022 (1998), divide a
+ * 2n-digit number by an n-digit one with two divisions of 3n/2 digits by
+ * n digits, each of which is in turn a recursive division of n digits by
+ * n/2 digits and a multiplication of n/2 digits.  That reduces division to
+ * multiplication, and with a subquadratic multiplication it takes
+ * O(M(n) log n) time.  The "digits" here are blocks of n Python digits,
+ * and the divisor must be normalized:  the top bit of its top digit is set.
+ */
+
+/* Divide the nonnegative a by the nonnegative b, which has at least two
+   digits, with the schoolbook algorithm. */
+static int
+bz_divrem_base(PyLongObject *a, PyLongObject *b,
+               PyLongObject **pq, PyLongObject **pr)
+{
+    assert(Py_SIZE(a) >= 0 && Py_SIZE(b) >= 2);
+    if (long_compare(a, b) < 0) {
+        *pq = (PyLongObject *)PyLong_FromLong(0);
+        if (*pq == NULL)
+            return -1;
+        Py_INCREF(a);
+        *pr = a;
+        return 0;
+    }
+    *pq = x_divrem(a, b, pr);
+    return *pq == NULL ? -1 : 0;
+}
+
+static int bz_div3n2n(PyLongObject *a12, PyLongObject *a3, PyLongObject *b,
+                      PyLongObject *b1, PyLongObject *b2, Py_ssize_t n,
+                      PyLongObject **pq, PyLongObject **pr);
+
+/* Divide a by b, where b has exactly n digits and is normalized, and
+   0 <= a < b * PyLong_BASE**n.  Sets *pq and *pr to the quotient and the
+   remainder.  Returns 0 on success, -1 on failure. */
+static int
+bz_div2n1n(PyLongObject *a, PyLongObject *b, Py_ssize_t n,
+           PyLongObject **pq, PyLongObject **pr)
+{
+    PyLongObject *a1 = NULL, *a2 = NULL, *b1 = NULL, *b2 = NULL;
+    PyLongObject *q1 = NULL, *q2 = NULL, *r = NULL, *t;
+    Py_ssize_t half;
+    int pad, err = -1;
+
+    assert(Py_SIZE(b) == n);
+    if (n <= BZ_DIV_CUTOFF || Py_SIZE(a) - n <= BZ_DIV_CUTOFF)
+        return bz_divrem_base(a, b, pq, pr);
+
+    /* Make n even by multiplying both a and b by PyLong_BASE. */
+    pad = n & 1;
+    if (pad) {
+        a = long_digit_concat(a, (PyLongObject *)_PyLong_Zero, 1);
+        if (a == NULL)
+            return -1;
+        b = long_digit_concat(b, (PyLongObject *)_PyLong_Zero, 1);
+        if (b == NULL) {
+            Py_DECREF(a);
+            return -1;
+        }
+        n++;
+    }
+    else {
+        Py_INCREF(a);
+        Py_INCREF(b);
+    }
+    half = n >> 1;
+
+    if ((b1 = long_digit_slice(b, half, n)) == NULL ||
+        (b2 = long_digit_slice(b, 0, half)) == NULL)
+        goto done;
+
+    /* The top 3 half-blocks of a by b, then the remainder followed by the
+       last half-block of a, by b again. */
+    if ((a1 = long_digit_slice(a, n, PY_SSIZE_T_MAX)) == NULL ||
+        (a2 = long_digit_slice(a, half, n)) == NULL)
+        goto done;
+    if (bz_div3n2n(a1, a2, b, b1, b2, half, &q1, &r) < 0)
+        goto done;
+    Py_SETREF(a2, long_digit_slice(a, 0, half));
+    if (a2 == NULL)
+        goto done;
+    t = r;
+    r = NULL;
+    err = bz_div3n2n(t, a2, b, b1, b2, half, &q2, &r);
+    Py_DECREF(t);
+    if (err < 0)
+        goto done;
+
+    err = -1;
+    if (pad) {
+        /* The remainder was multiplied by PyLong_BASE too. */
+        assert(Py_SIZE(r) == 0 || r->ob_digit[0] == 0);
+        Py_SETREF(r, long_digit_slice(r, 1, PY_SSIZE_T_MAX));
+        if (r == NULL)
+            goto done;
+    }
+    *pq = long_digit_concat(q1, q2, half);
+    if (*pq == NULL)
+        goto done;
+    *pr = r;
+    r = NULL;
+    err = 0;
+
+  done:
+    Py_DECREF(a);
+    Py_DECREF(b);
+    Py_XDECREF(a1);
+    Py_XDECREF(a2);
+    Py_XDECREF(b1);
+    Py_XDECREF(b2);
+    Py_XDECREF(q1);
+    Py_XDECREF(q2);
+    Py_XDECREF(r);
+    return err;
+}
+
+/* A helper for bz_div2n1n.  Divide a12 * PyLong_BASE**n + a3 by
+   b = b1 * PyLong_BASE**n + b2, where b1 has n digits and is normalized,
+   0 <= a3 < PyLong_BASE**n and 0 <= a12 < b * PyLong_BASE**n.  The quotient
+   is less than PyLong_BASE**n. */
+static int
+bz_div3n2n(PyLongObject *a12, PyLongObject *a3, PyLongObject *b,
+           PyLongObject *b1, PyLongObject *b2, Py_ssize_t n,
+           PyLongObject **pq, PyLongObject **pr)
+{
+    PyLongObject *q = NULL, *r = NULL, *t;
+    Py_ssize_t i;
+
+    t = long_digit_slice(a12, n, PY_SSIZE_T_MAX);
+    if (t == NULL)
+        return -1;
+    if (long_compare(t, b1) == 0) {
+        /* The quotient of a12 by b1 would be PyLong_BASE**n or more, so
+           estimate it as PyLong_BASE**n - 1, with the remainder
+           a12 - b1 * (PyLong_BASE**n - 1). */
+        Py_DECREF(t);
+        q = _PyLong_New(n);
+        if (q == NULL)
+            return -1;
+        for (i = 0; i < n; i++)
+            q->ob_digit[i] = PyLong_MASK;
+        t = long_digit_concat(b1, (PyLongObject *)_PyLong_Zero, n);
+        if (t == NULL)
+            goto fail;
+        r = (PyLongObject *)long_sub(a12, t);
+        Py_DECREF(t);
+        if (r == NULL)
+            goto fail;
+        Py_SETREF(r, (PyLongObject *)long_add(r, b1));
+        if (r == NULL)
+            goto fail;
+    }
+    else {
+        Py_DECREF(t);
+        if (bz_div2n1n(a12, b1, n, &q, &r) < 0)
+            return -1;
+    }
+
+    /* The estimate q is at most 2 too large:  the exact remainder is
+       r * PyLong_BASE**n + a3 - q * b2. */
+    Py_SETREF(r, long_digit_concat(r, a3, n));
+    if (r == NULL)
+        goto fail;
+    t = (PyLongObject *)long_mul(q, b2);
+    if (t == NULL)
+        goto fail;
+    Py_SETREF(r, (PyLongObject *)long_sub(r, t));
+    Py_DECREF(t);
+    if (r == NULL)
+        goto fail;
+    while (Py_SIZE(r) < 0) {
+        Py_SETREF(q, (PyLongObject *)long_sub(q,
+                                              (PyLongObject *)_PyLong_One));
+        if (q == NULL)
+            goto fail;
+        Py_SETREF(r, (PyLongObject *)long_add(r, b));
+        if (r == NULL)
+            goto fail;
+    }
+    *pq = q;
+    *pr = r;
+    return 0;
+
+  fail:
+    Py_XDECREF(q);
+    Py_XDECREF(r);
+    return -1;
+}
+
+/* Return abs(a) << d, for 0 <= d < PyLong_SHIFT, as a new object. */
+static PyLongObject *
+bz_lshift(PyLongObject *a, int d)
+{
+    const Py_ssize_t size_a = Py_ABS(Py_SIZE(a));
+    PyLongObject *z;
+
+    z = _PyLong_New(size_a + 1);
+    if (z == NULL)
+        return NULL;
+    z->ob_digit[size_a] = v_lshift(z->ob_digit, a->ob_digit, size_a, d);
+    return long_normalize(z);
+}
+
+/* Divide abs(a) by abs(b) with the Burnikel-Ziegler algorithm, and set
+   *pdiv and *prem to new objects, the quotient and the remainder.  The
+   quotient is found by blocks of as many digits as b has.  Returns 0 on
+   success, -1 on failure. */
+static int
+bz_divrem(PyLongObject *a, PyLongObject *b,
+          PyLongObject **pdiv, PyLongObject **prem)
+{
+    const Py_ssize_t size_b = Py_ABS(Py_SIZE(b));
+    PyLongObject *an = NULL, *bn = NULL, *q = NULL, *r = NULL;
+    PyLongObject *chunk, *t, *qi;
+    Py_ssize_t n, nblocks, i;
+    int d;
+
+    /* Normalize b, and shift a by the same number of bits. */
+    d = PyLong_SHIFT - _Py_bit_length(b->ob_digit[size_b - 1]);
+    if ((an = bz_lshift(a, d)) == NULL ||
+        (bn = bz_lshift(b, d)) == NULL)
+        goto fail;
+    n = Py_SIZE(bn);
+    nblocks = (Py_SIZE(an) + n - 1) / n;
+
+    q = _PyLong_New(nblocks * n);
+    if (q == NULL)
+        goto fail;
+    r = (PyLongObject *)PyLong_FromLong(0);
+    if (r == NULL)
+        goto fail;
+    /* Since r < bn, r * PyLong_BASE**n + chunk < bn * PyLong_BASE**n, and
+       each block of the quotient fits in n digits. */
+    for (i = nblocks; --i >= 0; ) {
+        chunk = long_digit_slice(an, i * n, (i + 1) * n);
+        if (chunk == NULL)
+            goto fail;
+        t = long_digit_concat(r, chunk, n);
+        Py_DECREF(chunk);
+        if (t == NULL)
+            goto fail;
+        Py_CLEAR(r);
+        if (bz_div2n1n(t, bn, n, &qi, &r) < 0) {
+            Py_DECREF(t);
+            goto fail;
+        }
+        Py_DECREF(t);
+        assert(Py_SIZE(qi) <= n);
+        memcpy(q->ob_digit + i * n, qi->ob_digit,
+               Py_SIZE(qi) * sizeof(digit));
+        memset(q->ob_digit + i * n + Py_SIZE(qi), 0,
+               (n - Py_SIZE(qi)) * sizeof(digit));
+        Py_DECREF(qi);
+    }
+
+    /* Unshift the remainder into a new object. */
+    t = _PyLong_New(Py_SIZE(r));
+    if (t == NULL)
+        goto fail;
+    (void)v_rshift(t->ob_digit, r->ob_digit, Py_SIZE(r), d);
+    Py_DECREF(r);
+    Py_DECREF(an);
+    Py_DECREF(bn);
+    *prem = long_normalize(t);
+    *pdiv = long_normalize(q);
+    return 0;
+
+  fail:
+    Py_XDECREF(an);
+    Py_XDECREF(bn);
+    Py_XDECREF(q);
+    Py_XDECREF(r);
+    return -1;
+}
+
+/* Divide-and-conquer conversion between ints and decimal strings.
+ *
+ * Both directions split the number at a power 10**(_PyLong_DECIMAL_SHIFT *
+ * 2**k) of ten, and convert the two halves recursively.  With the
+ * subquadratic multiplication and division above, they take
+ * O(M(n) log n) time instead of O(n**2).
+ */
+
+/* Set pw[i] to _PyLong_DECIMAL_BASE**(2**i), for 0 <= i < k.  Returns 0 on
+   success, -1 on failure (with pw cleared). */
+static int
+dec_powers(PyLongObject **pw, int k)
+{
+    int i;
+
+    assert(k > 0);
+    pw[0] = (PyLongObject *)PyLong_FromLong(_PyLong_DECIMAL_BASE);
+    if (pw[0] == NULL)
+        return -1;
+    for (i = 1; i < k; i++) {
+        pw[i] = (PyLongObject *)long_mul(pw[i - 1], pw[i - 1]);
+        if (pw[i] == NULL) {
+            while (--i >= 0)
+                Py_DECREF(pw[i]);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Store the 2**k least significant base _PyLong_DECIMAL_BASE digits of the
+   nonnegative x into pout, given x < pw[k]. */
+static int
+dec_to_str_dc(PyLongObject *x, int k, PyLongObject **pw, digit *pout)
+{
+    const Py_ssize_t n = (Py_ssize_t)1 << k;
+    PyLongObject *q, *r;
+    int err;
+
+    assert(Py_SIZE(x) >= 0);
+    if (Py_SIZE(x) <= DEC_TO_STR_CUTOFF) {
+        Py_ssize_t size = x_to_decimal(x->ob_digit, Py_SIZE(x), pout);
+        if (size < 0)
+            return -1;
+        assert(size <= n);
+        memset(pout + size, 0, (n - size) * sizeof(digit));
+        return 0;
+    }
+    assert(k > 0);
+    if (long_divrem(x, pw[k - 1], &q, &r) < 0)
+        return -1;
+    err = dec_to_str_dc(r, k - 1, pw, pout);
+    if (err == 0)
+        err = dec_to_str_dc(q, k - 1, pw, pout + n / 2);
+    Py_DECREF(q);
+    Py_DECREF(r);
+    return err;
+}
+
+/* Like x_to_decimal, for large ints:  return a scratch int whose digits
+   are the base _PyLong_DECIMAL_BASE digits of abs(a), and set *psize to
+   their number, given an upper bound for it.  Returns NULL on failure. */
+static PyLongObject *
+long_to_decimal_digits(PyLongObject *a, Py_ssize_t bound, Py_ssize_t *psize)
+{
+    PyLongObject *x, *scratch = NULL;
+    PyLongObject *pw[8 * sizeof(Py_ssize_t)];
+    Py_ssize_t size;
+    int i, k;
+
+    /* abs(a) < pw[k] since it has at most bound decimal digits */
+    k = 1;
+    while (((Py_ssize_t)1 << k) < bound)
+        k++;
+    x = (PyLongObject *)_PyLong_Copy(a);
+    if (x == NULL)
+        return NULL;
+    Py_SET_SIZE(x, Py_ABS(Py_SIZE(x)));
+    if (dec_powers(pw, k) < 0) {
+        Py_DECREF(x);
+        return NULL;
+    }
+    scratch = _PyLong_New((Py_ssize_t)1 << k);
+    if (scratch != NULL &&
+        dec_to_str_dc(x, k, pw, scratch->ob_digit) < 0)
+        Py_CLEAR(scratch);
+    for (i = 0; i < k; i++)
+        Py_DECREF(pw[i]);
+    Py_DECREF(x);
+    if (scratch == NULL)
+        return NULL;
+
+    size = (Py_ssize_t)1 << k;
+    while (size > 1 && scratch->ob_digit[size - 1] == 0)
+        size--;
+    *psize = size;
+    return scratch;
+}
+
+/* Return the int whose decimal digits are s[0:len], with the quadratic
+   algorithm.  The characters must all be ASCII digits. */
+static PyLongObject *
+x_from_decimal(const char *s, Py_ssize_t len)
+{
+    PyLongObject *z;
+    Py_ssize_t size = 0, i;
+
+    /* _PyLong_DECIMAL_BASE <= PyLong_BASE, so every _PyLong_DECIMAL_SHIFT
+       decimal digits take at most one digit. */
+    z = _PyLong_New(len / _PyLong_DECIMAL_SHIFT + 1);
+    if (z == NULL)
+        return NULL;
+    while (len > 0) {
+        /* The first chunk takes the leftover decimal digits. */
+        Py_ssize_t w = (len - 1) % _PyLong_DECIMAL_SHIFT + 1;
+        twodigits c = 0, mult = 1;
+
+        len -= w;
+        while (w-- > 0) {
+            c = c * 10 + (*s++ - '0');
+            mult *= 10;
+        }
+        for (i = 0; i < size; i++) {
+            c += (twodigits)z->ob_digit[i] * mult;
+            z->ob_digit[i] = (digit)(c & PyLong_MASK);
+            c >>= PyLong_SHIFT;
+        }
+        if (c) {
+            assert(c < PyLong_BASE);
+            z->ob_digit[size++] = (digit)c;
+        }
+    }
+    Py_SET_SIZE(z, size);
+    return z;
+}
+
+/* Return the int whose decimal digits are s[0:len], given
+   pw[k] = _PyLong_DECIMAL_BASE**(2**k) for all the k with
+   _PyLong_DECIMAL_SHIFT * 2**k < len. */
+static PyLongObject *
+dec_from_str_dc(const char *s, Py_ssize_t len, PyLongObject **pw)
+{
+    PyLongObject *hi, *lo, *t, *z;
+    Py_ssize_t m;
+    int k;
+
+    if (len <= DEC_FROM_STR_CUTOFF)
+        return x_from_decimal(s, len);
+
+    /* Split off the low m = _PyLong_DECIMAL_SHIFT * 2**k digits, for the
+       largest such m < len. */
+    k = 0;
+    while (((Py_ssize_t)_PyLong_DECIMAL_SHIFT << (k + 1)) < len)
+        k++;
+    m = (Py_ssize_t)_PyLong_DECIMAL_SHIFT << k;
+    hi = dec_from_str_dc(s, len - m, pw);
+    if (hi == NULL)
+        return NULL;
+    t = (PyLongObject *)long_mul(hi, pw[k]);
+    Py_DECREF(hi);
+    if (t == NULL)
+        return NULL;
+    lo = dec_from_str_dc(s + len - m, m, pw);
+    if (lo == NULL) {
+        Py_DECREF(t);
+        return NULL;
+    }
+    z = (PyLongObject *)long_add(t, lo);
+    Py_DECREF(t);
+    Py_DECREF(lo);
+    return z;
+}
+
+/* A helper for PyLong_FromString:  return the nonnegative int whose decimal
+   digits are those of str[0:end], which holds ndigits ASCII digits and
+   possibly single underscores.  The result is a new object. */
+static PyLongObject *
+long_from_decimal_string(const char *str, const char *end, Py_ssize_t ndigits)
+{
+    PyLongObject *pw[8 * sizeof(Py_ssize_t)];
+    PyLongObject *x, *z;
+    char *buf, *p;
+    Py_ssize_t len;
+    int i, k;
+
+    buf = PyMem_Malloc(ndigits);
+    if (buf == NULL) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    /* Copy the digits, dropping the underscores and the leading zeros. */
+    for (p = buf; str < end; str++) {
+        if (*str != '_' && (*str != '0' || p != buf))
+            *p++ = *str;
+    }
+    len = p - buf;
+
+    k = 0;
+    while (((Py_ssize_t)_PyLong_DECIMAL_SHIFT << k) < len)
+        k++;
+    if (k == 0) {
+        x = x_from_decimal(buf, len);
+    }
+    else {
+        if (dec_powers(pw, k) < 0) {
+            PyMem_Free(buf);
+            return NULL;
+        }
+        x = dec_from_str_dc(buf, len, pw);
+        for (i = 0; i < k; i++)
+            Py_DECREF(pw[i]);
+    }
+    PyMem_Free(buf);
+    if (x == NULL)
+        return NULL;
+
+    /* The caller may negate the result in place, so it must not be shared,
+       even if it is a small int. */
+    z = _PyLong_New(Py_SIZE(x));
+    if (z != NULL)
+        memcpy(z->ob_digit, x->ob_digit, Py_SIZE(x) * sizeof(digit));
+    Py_DECREF(x);
+    return z;
+}
+
 /* Fast modulo division for single-digit longs. */
 static PyObject *
 fast_mod(PyLongObject *a, PyLongObject *b)
@@ -1,5 +1,6 @@
 #include "Python.h"
 #include "pycore_pymem.h"         // _PyTraceMalloc_Config
+#include "pycore_pystate.h"       // _PyThreadState_GET()
 
 #include <stdbool.h>
 
@@ -143,10 +144,54 @@ _PyObject_ArenaVirtualFree(void *ctx, void *ptr, size_t size)
 }
 
 #elif defined(ARENAS_USE_MMAP)
+/* Back arenas with huge pages, see PYTHONMALLOCARENA in new_arena() */
+static int arena_use_hugepages = 0;
+
+#define HUGE_PAGE_SIZE          (2 << 20)       /* 2MB */
+
+#ifdef MADV_HUGEPAGE
+/* Map a region aligned on a huge page boundary, so that the kernel can back
+   it with transparent huge pages. */
+static void *
+arena_mmap_transparent_hugepages(size_t size)
+{
+    uint8_t *ptr = mmap(NULL, size + HUGE_PAGE_SIZE, PROT_READ|PROT_WRITE,
+                        MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) {
+        return NULL;
+    }
+    /* Unmap the unaligned head and the tail of the region */
+    size_t head = (size_t)((uintptr_t)_Py_ALIGN_UP(ptr, HUGE_PAGE_SIZE)
+                           - (uintptr_t)ptr);
+    if (head != 0) {
+        munmap(ptr, head);
+    }
+    munmap(ptr + head + size, HUGE_PAGE_SIZE - head);
+    ptr += head;
+    /* Failure only means that the arena uses normal pages */
+    (void)madvise(ptr, size, MADV_HUGEPAGE);
+    return ptr;
+}
+#endif
+
 static void *
 _PyObject_ArenaMmap(void *ctx, size_t size)
 {
     void *ptr;
+    if (arena_use_hugepages && size % HUGE_PAGE_SIZE == 0) {
+#ifdef MAP_HUGETLB
+        /* Explicit huge pages are only available if the system reserved
+           some, otherwise fall back to transparent huge pages. */
+        ptr = mmap(NULL, size, PROT_READ|PROT_WRITE,
+                   MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB, -1, 0);
+        if (ptr != MAP_FAILED) {
+            return ptr;
+        }
+#endif
+#ifdef MADV_HUGEPAGE
+        return arena_mmap_transparent_hugepages(size);
+#endif
+    }
     ptr = mmap(NULL, size, PROT_READ|PROT_WRITE,
                MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
     if (ptr == MAP_FAILED)
@@ -906,11 +951,20 @@ static int running_on_valgrind = -1;
  *
  * Arenas are allocated with mmap() on systems supporting anonymous memory
  * mappings to reduce heap fragmentation.
+ *
+ * All arenas have the same size, arena_size.  It is DEFAULT_ARENA_SIZE unless
+ * the PYTHONMALLOCARENA environment variable asks for another power of 2
+ * between MIN_ARENA_SIZE and MAX_ARENA_SIZE, and it can't change once the
+ * first arena has been allocated:  see new_arena().
  */
-#define ARENA_SIZE              (256 << 10)     /* 256KB */
+#define DEFAULT_ARENA_SIZE      (256 << 10)     /* 256KB */
+#define MIN_ARENA_SIZE          (64 << 10)      /* 64KB */
+#define MAX_ARENA_SIZE          (16 << 20)      /* 16MB */
+
+static uint arena_size = DEFAULT_ARENA_SIZE;
 
 #ifdef WITH_MEMORY_LIMITS
-#define MAX_ARENAS              (SMALL_MEMORY_LIMIT / ARENA_SIZE)
+#define MAX_ARENAS              (SMALL_MEMORY_LIMIT / arena_size)
 #endif
 
 /*
@@ -920,8 +974,8 @@ static int running_on_valgrind = -1;
 #define POOL_SIZE               SYSTEM_PAGE_SIZE        /* must be 2^N */
 #define POOL_SIZE_MASK          SYSTEM_PAGE_SIZE_MASK
 
-#define MAX_POOLS_IN_ARENA  (ARENA_SIZE / POOL_SIZE)
-#if MAX_POOLS_IN_ARENA * POOL_SIZE != ARENA_SIZE
+#define MAX_POOLS_IN_ARENA  (MAX_ARENA_SIZE / POOL_SIZE)
+#if MIN_ARENA_SIZE % POOL_SIZE != 0
 #   error "arena size not an exact multiple of pool size"
 #endif
 
@@ -1129,6 +1183,72 @@ static poolp usedpools[2 * ((NB_SMALL_SIZE_CLASSES + 7) / 8) * 8] = {
 #endif /* NB_SMALL_SIZE_CLASSES >  8 */
 };
 
+/*==========================================================================
+Per-thread block caches.
+
+Each thread state owns a small cache of free blocks per size class, see
+_PyObject_NewBlockCache().  Blocks in a cache are still counted as allocated
+by their pool:  pymalloc_free() pushes a block onto the cache of the current
+thread without touching its pool, and pymalloc_alloc() pops it from there.
+Pools are only touched when a cache runs empty, in which case up to half of
+its capacity is taken in one go from the free list of the first used pool of
+the size class, or when a block is freed while the cache of its size class is
+full, in which case the block goes straight back to its pool.
+
+The capacity of a cache is limited to BLOCK_CACHE_BYTES per size class, so
+that a thread pins at most NB_SMALL_SIZE_CLASSES * BLOCK_CACHE_BYTES bytes of
+pool memory.  A cache is emptied when its thread state is cleared.
+
+The caches rely on the GIL like the rest of pymalloc:  the current thread
+state is the one holding the GIL, and only the owner of a cache uses it.
+*/
+
+#define BLOCK_CACHE_BYTES 4096
+
+struct block_cache_class {
+    /* Singly-linked list of free blocks, linked through their first word */
+    block *head;
+    uint count;
+    uint limit;
+};
+
+struct _PyObject_BlockCache {
+    struct block_cache_class classes[NB_SMALL_SIZE_CLASSES];
+};
+
+/* Return the block cache of the current thread, or NULL. */
+static inline struct _PyObject_BlockCache *
+get_block_cache(void)
+{
+    PyThreadState *tstate = _PyThreadState_GET();
+    return tstate != NULL ? tstate->obmalloc_cache : NULL;
+}
+
+/* Number of blocks held by the caches of all thread states, per size class
+   if numblocks is not NULL. */
+static size_t
+count_cached_blocks(size_t *numblocks)
+{
+    size_t n = 0;
+    PyInterpreterState *interp = PyInterpreterState_Head();
+    for (; interp != NULL; interp = PyInterpreterState_Next(interp)) {
+        PyThreadState *tstate = PyInterpreterState_ThreadHead(interp);
+        for (; tstate != NULL; tstate = PyThreadState_Next(tstate)) {
+            struct _PyObject_BlockCache *cache = tstate->obmalloc_cache;
+            if (cache == NULL) {
+                continue;
+            }
+            for (uint i = 0; i < NB_SMALL_SIZE_CLASSES; i++) {
+                n += cache->classes[i].count;
+                if (numblocks != NULL) {
+                    numblocks[i] += cache->classes[i].count;
+                }
+            }
+        }
+    }
+    return n;
+}
+
 /*==========================================================================
 Arena management.
 
@@ -1195,7 +1315,7 @@ static struct arena_object* usable_arenas = NULL;
 static struct arena_object* nfp2lasta[MAX_POOLS_IN_ARENA + 1] = { NULL };
 
 /* How many arena_objects do we initially allocate?
- * 16 = can allocate 16 arenas = 16 * ARENA_SIZE = 4MB before growing the
+ * 16 = can allocate 16 arenas = 16 * arena_size = 4MB before growing the
  * `arenas` vector.
  */
 #define INITIAL_ARENA_OBJECTS 16
@@ -1230,10 +1350,59 @@ _Py_GetAllocatedBlocks(void)
             n += p->ref.count;
         }
     }
+    /* Blocks in the thread caches are free from the user's point of view */
+    n -= count_cached_blocks(NULL);
     return n;
 }
 
 
+/* Set arena_size from the PYTHONMALLOCARENA environment variable:  "huge"
+ * for arenas backed by huge pages, or the size of the arenas in bytes, with
+ * an optional "K" or "M" suffix.
+ */
+static void
+init_arena_size(void)
+{
+    const char *opt = Py_GETENV("PYTHONMALLOCARENA");
+    if (opt == NULL || *opt == '\0') {
+        return;
+    }
+    if (strcmp(opt, "huge") == 0) {
+#if defined(ARENAS_USE_MMAP) && (defined(MAP_HUGETLB) || defined(MADV_HUGEPAGE))
+        arena_size = HUGE_PAGE_SIZE;
+        arena_use_hugepages = 1;
+        return;
+#else
+        Py_FatalError("PYTHONMALLOCARENA: huge page arenas are not "
+                      "supported on this platform");
+#endif
+    }
+
+    char *end;
+    errno = 0;
+    unsigned long size = strtoul(opt, &end, 10);
+    unsigned long unit = 1;
+    if (*end == 'K' || *end == 'k') {
+        unit = 1 << 10;
+        end++;
+    }
+    else if (*end == 'M' || *end == 'm') {
+        unit = 1 << 20;
+        end++;
+    }
+    if (end == opt || *end != '\0' || errno != 0
+        || size > MAX_ARENA_SIZE / unit)
+    {
+        Py_FatalError("PYTHONMALLOCARENA: invalid arena size");
+    }
+    size *= unit;
+    if (size < MIN_ARENA_SIZE || (size & (size - 1)) != 0) {
+        Py_FatalError("PYTHONMALLOCARENA: arena size must be a power of 2 "
+                      "between 64K and 16M");
+    }
+    arena_size = (uint)size;
+}
+
 /* Allocate a new arena.  If we run out of memory, return NULL.  Else
  * allocate a new arena, and return the address of an arena_object
  * describing the new arena.  It's expected that the caller will set
@@ -1250,6 +1419,8 @@ new_arena(void)
     if (debug_stats == -1) {
         const char *opt = Py_GETENV("PYTHONMALLOCSTATS");
         debug_stats = (opt != NULL && *opt != '\0');
+        /* The arena size can't change after the first arena */
+        init_arena_size();
     }
     if (debug_stats)
         _PyObject_DebugMallocStats(stderr);
@@ -1301,7 +1472,7 @@ new_arena(void)
     arenaobj = unused_arena_objects;
     unused_arena_objects = arenaobj->nextarena;
     assert(arenaobj->address == 0);
-    address = _PyObject_Arena.alloc(_PyObject_Arena.ctx, ARENA_SIZE);
+    address = _PyObject_Arena.alloc(_PyObject_Arena.ctx, arena_size);
     if (address == NULL) {
         /* The allocation failed: return NULL after putting the
          * arenaobj back.
@@ -1320,7 +1491,7 @@ new_arena(void)
     /* pool_address <- first pool-aligned address in the arena
        nfreepools <- number of whole pools that fit after alignment */
     arenaobj->pool_address = (block*)arenaobj->address;
-    arenaobj->nfreepools = MAX_POOLS_IN_ARENA;
+    arenaobj->nfreepools = arena_size / POOL_SIZE;
     excess = (uint)(arenaobj->address & POOL_SIZE_MASK);
     if (excess != 0) {
         --arenaobj->nfreepools;
@@ -1343,7 +1514,8 @@ variable and pass the latter to the macro; because address_in_range is
 called on every alloc/realloc/free, micro-efficiency is important here).
 
 Tricky:  Let B be the arena base address associated with the pool, B =
-arenas[(POOL)->arenaindex].address.  Then P belongs to the arena if and only if
+arenas[(POOL)->arenaindex].address, and ARENA_SIZE the size of all arenas
+(arena_size).  Then P belongs to the arena if and only if
 
     B <= P < B + ARENA_SIZE
 
@@ -1419,7 +1591,7 @@ address_in_range(void *p, poolp pool)
     // only once.
     uint arenaindex = *((volatile uint *)&pool->arenaindex);
     return arenaindex < maxarenas &&
-        (uintptr_t)p - arenas[arenaindex].address < ARENA_SIZE &&
+        (uintptr_t)p - arenas[arenaindex].address < arena_size &&
         arenas[arenaindex].address != 0;
 }
 
@@ -1516,7 +1688,7 @@ allocate_from_new_pool(uint size)
             assert(usable_arenas->freepools != NULL ||
                    usable_arenas->pool_address <=
                    (block*)usable_arenas->address +
-                       ARENA_SIZE - POOL_SIZE);
+                       arena_size - POOL_SIZE);
         }
     }
     else {
@@ -1525,7 +1697,7 @@ allocate_from_new_pool(uint size)
         assert(usable_arenas->freepools == NULL);
         pool = (poolp)usable_arenas->pool_address;
         assert((block*)pool <= (block*)usable_arenas->address +
-                                 ARENA_SIZE - POOL_SIZE);
+                                 arena_size - POOL_SIZE);
         pool->arenaindex = (uint)(usable_arenas - arenas);
         assert(&arenas[pool->arenaindex] == usable_arenas);
         pool->szidx = DUMMY_SIZE_IDX;
@@ -1578,6 +1750,44 @@ allocate_from_new_pool(uint size)
     return bp;
 }
 
+/* Called when the cache of size class `size` is empty.  Take up to half of
+ * its capacity from the free list of a used pool, return one block and
+ * keep the others in the cache.
+ */
+static void*
+block_cache_refill(struct block_cache_class *cc, uint size)
+{
+    poolp pool = usedpools[size + size];
+    if (UNLIKELY(pool == pool->nextpool)) {
+        return allocate_from_new_pool(size);
+    }
+
+    uint n = 0;
+    uint batch = cc->limit / 2;
+    block *head = NULL;
+    do {
+        block *bp = pool->freeblock;
+        assert(bp != NULL);
+        pool->freeblock = *(block **)bp;
+        *(block **)bp = head;
+        head = bp;
+        n++;
+        if (UNLIKELY(pool->freeblock == NULL)) {
+            // Extend the free list, or unlink the pool if it is full.
+            pymalloc_pool_extend(pool, size);
+            if (pool->freeblock == NULL) {
+                break;
+            }
+        }
+    } while (n < batch);
+    pool->ref.count += n;
+
+    assert(cc->head == NULL && cc->count == 0);
+    cc->head = *(block **)head;
+    cc->count = n - 1;
+    return head;
+}
+
 /* pymalloc allocator
 
    Return a pointer to newly allocated memory if pymalloc allocated memory.
@@ -1606,9 +1816,21 @@ pymalloc_alloc(void *ctx, size_t nbytes)
     }
 
     uint size = (uint)(nbytes - 1) >> ALIGNMENT_SHIFT;
-    poolp pool = usedpools[size + size];
     block *bp;
 
+    struct _PyObject_BlockCache *cache = get_block_cache();
+    if (LIKELY(cache != NULL)) {
+        struct block_cache_class *cc = &cache->classes[size];
+        bp = cc->head;
+        if (LIKELY(bp != NULL)) {
+            cc->head = *(block **)bp;
+            cc->count--;
+            return (void *)bp;
+        }
+        return block_cache_refill(cc, size);
+    }
+
+    poolp pool = usedpools[size + size];
     if (LIKELY(pool != pool->nextpool)) {
         /*
          * There is a used pool for this size class.
@@ -1770,7 +1992,7 @@ insert_to_freepool(poolp pool)
 
         /* Free the entire arena. */
         _PyObject_Arena.free(_PyObject_Arena.ctx,
-                             (void *)ao->address, ARENA_SIZE);
+                             (void *)ao->address, arena_size);
         ao->address = 0;                        /* mark unassociated */
         --narenas_currently_allocated;
 
@@ -1848,26 +2070,10 @@ insert_to_freepool(poolp pool)
            || ao->prevarena->nextarena == ao);
 }
 
-/* Free a memory block allocated by pymalloc_alloc().
-   Return 1 if it was freed.
-   Return 0 if the block was not allocated by pymalloc_alloc(). */
-static inline int
-pymalloc_free(void *ctx, void *p)
+/* Give the block p back to its pool. */
+static inline void
+pool_free_block(poolp pool, void *p)
 {
-    assert(p != NULL);
-
-#ifdef WITH_VALGRIND
-    if (UNLIKELY(running_on_valgrind > 0)) {
-        return 0;
-    }
-#endif
-
-    poolp pool = POOL_ADDR(p);
-    if (UNLIKELY(!address_in_range(p, pool))) {
-        return 0;
-    }
-    /* We allocated this address. */
-
     /* Link p to the start of the pool's freeblock list.  Since
      * the pool had at least the p block outstanding, the pool
      * wasn't empty (so it's already in a usedpools[] list, or
@@ -1888,7 +2094,7 @@ pymalloc_free(void *ctx, void *p)
          * blocks of the same size class.
          */
         insert_to_usedpool(pool);
-        return 1;
+        return;
     }
 
     /* freeblock wasn't NULL, so the pool wasn't full,
@@ -1896,7 +2102,7 @@ pymalloc_free(void *ctx, void *p)
      */
     if (LIKELY(pool->ref.count != 0)) {
         /* pool isn't empty:  leave it in usedpools */
-        return 1;
+        return;
     }
 
     /* Pool is now empty:  unlink from usedpools, and
@@ -1905,6 +2111,53 @@ pymalloc_free(void *ctx, void *p)
      * (being not referenced, they are perhaps paged out).
      */
     insert_to_freepool(pool);
+}
+
+/* Give the first n blocks of a cache back to their pools. */
+static void
+block_cache_flush(struct block_cache_class *cc, uint n)
+{
+    assert(n <= cc->count);
+    for (; n > 0; n--) {
+        block *bp = cc->head;
+        cc->head = *(block **)bp;
+        cc->count--;
+        pool_free_block(POOL_ADDR(bp), bp);
+    }
+}
+
+/* Free a memory block allocated by pymalloc_alloc().
+   Return 1 if it was freed.
+   Return 0 if the block was not allocated by pymalloc_alloc(). */
+static inline int
+pymalloc_free(void *ctx, void *p)
+{
+    assert(p != NULL);
+
+#ifdef WITH_VALGRIND
+    if (UNLIKELY(running_on_valgrind > 0)) {
+        return 0;
+    }
+#endif
+
+    poolp pool = POOL_ADDR(p);
+    if (UNLIKELY(!address_in_range(p, pool))) {
+        return 0;
+    }
+    /* We allocated this address. */
+
+    struct _PyObject_BlockCache *cache = get_block_cache();
+    if (LIKELY(cache != NULL)) {
+        struct block_cache_class *cc = &cache->classes[pool->szidx];
+        if (LIKELY(cc->count < cc->limit)) {
+            *(block **)p = cc->head;
+            cc->head = (block *)p;
+            cc->count++;
+            return 1;
+        }
+    }
+
+    pool_free_block(pool, p);
     return 1;
 }
 
@@ -2011,6 +2264,43 @@ _PyObject_Realloc(void *ctx, void *ptr, size_t nbytes)
     return PyMem_RawRealloc(ptr, nbytes);
 }
 
+
+/* Create a cache of free blocks for a new thread state.
+
+   Return NULL if pymalloc is not the object allocator or on memory
+   allocation failure:  the thread then uses the pools directly. */
+struct _PyObject_BlockCache *
+_PyObject_NewBlockCache(void)
+{
+    if (!_PyMem_PymallocEnabled()) {
+        return NULL;
+    }
+    struct _PyObject_BlockCache *cache = PyMem_RawCalloc(1, sizeof(*cache));
+    if (cache == NULL) {
+        return NULL;
+    }
+    for (uint i = 0; i < NB_SMALL_SIZE_CLASSES; i++) {
+        /* At least 2, so that a refill takes at least one block */
+        cache->classes[i].limit = Py_MAX(2, BLOCK_CACHE_BYTES / INDEX2SIZE(i));
+    }
+    return cache;
+}
+
+
+/* Give the blocks of a cache back to their pools and free the cache. */
+void
+_PyObject_FreeBlockCache(struct _PyObject_BlockCache *cache)
+{
+    if (cache == NULL) {
+        return;
+    }
+    for (uint i = 0; i < NB_SMALL_SIZE_CLASSES; i++) {
+        struct block_cache_class *cc = &cache->classes[i];
+        block_cache_flush(cc, cc->count);
+    }
+    PyMem_RawFree(cache);
+}
+
 #else   /* ! WITH_PYMALLOC */
 
 /*==========================================================================*/
@@ -2023,6 +2313,18 @@ _Py_GetAllocatedBlocks(void)
     return 0;
 }
 
+struct _PyObject_BlockCache *
+_PyObject_NewBlockCache(void)
+{
+    return NULL;
+}
+
+void
+_PyObject_FreeBlockCache(struct _PyObject_BlockCache *cache)
+{
+    assert(cache == NULL);
+}
+
 #endif /* WITH_PYMALLOC */
 
 
@@ -2604,6 +2906,8 @@ _PyObject_DebugMallocStats(FILE *out)
     size_t numpools[SMALL_REQUEST_THRESHOLD >> ALIGNMENT_SHIFT];
     size_t numblocks[SMALL_REQUEST_THRESHOLD >> ALIGNMENT_SHIFT];
     size_t numfreeblocks[SMALL_REQUEST_THRESHOLD >> ALIGNMENT_SHIFT];
+    /* # of blocks held by the thread caches per class index */
+    size_t numcachedblocks[SMALL_REQUEST_THRESHOLD >> ALIGNMENT_SHIFT];
     /* total # of allocated bytes in used and full pools */
     size_t allocated_bytes = 0;
     /* total # of available bytes in used pools */
@@ -2621,7 +2925,7 @@ _PyObject_DebugMallocStats(FILE *out)
     size_t quantization = 0;
     /* # of arenas actually allocated. */
     size_t narenas = 0;
-    /* running total -- should equal narenas * ARENA_SIZE */
+    /* running total -- should equal narenas * arena_size */
     size_t total;
     char buf[128];
 
@@ -2629,7 +2933,7 @@ _PyObject_DebugMallocStats(FILE *out)
             SMALL_REQUEST_THRESHOLD, numclasses);
 
     for (i = 0; i < numclasses; ++i)
-        numpools[i] = numblocks[i] = numfreeblocks[i] = 0;
+        numpools[i] = numblocks[i] = numfreeblocks[i] = numcachedblocks[i] = 0;
 
     /* Because full pools aren't linked to from anything, it's easiest
      * to march over all the arenas.  If we're lucky, most of the memory
@@ -2680,6 +2984,13 @@ _PyObject_DebugMallocStats(FILE *out)
     }
     assert(narenas == narenas_currently_allocated);
 
+    /* Blocks in the thread caches are counted as available */
+    size_t ncached = count_cached_blocks(numcachedblocks);
+    for (i = 0; i < numclasses; ++i) {
+        numblocks[i] -= numcachedblocks[i];
+        numfreeblocks[i] += numcachedblocks[i];
+    }
+
     fputc('\n', out);
     fputs("class   size   num pools   blocks in use  avail blocks\n"
           "-----   ----   ---------   -------------  ------------\n",
@@ -2705,6 +3016,7 @@ _PyObject_DebugMallocStats(FILE *out)
         quantization += p * ((POOL_SIZE - POOL_OVERHEAD) % size);
     }
     fputc('\n', out);
+    (void)printone(out, "# blocks in thread caches", ncached);
 #ifdef PYMEM_DEBUG_SERIALNO
     if (_PyMem_DebugEnabled()) {
         (void)printone(out, "# times object malloc called", serialno);
@@ -2716,9 +3028,9 @@ _PyObject_DebugMallocStats(FILE *out)
     (void)printone(out, "# arenas allocated current", narenas);
 
     PyOS_snprintf(buf, sizeof(buf),
-        "%" PY_FORMAT_SIZE_T "u arenas * %d bytes/arena",
-        narenas, ARENA_SIZE);
-    (void)printone(out, buf, narenas * ARENA_SIZE);
+        "%" PY_FORMAT_SIZE_T "u arenas * %u bytes/arena",
+        narenas, arena_size);
+    (void)printone(out, buf, narenas * arena_size);
 
     fputc('\n', out);
 
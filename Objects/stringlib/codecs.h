@@ -254,6 +254,151 @@ InvalidContinuation3:
 
 #undef ASCII_CHAR_MASK
 
+#if defined(_Py_HAVE_X86_SIMD) && STRINGLIB_MAX_CHAR > 0x7Fu
+/* Decode the valid UTF-8 data s[0:end - s] into the characters q[0:qend -
+   q], which must all fit in STRINGLIB_CHAR, with the shuffles of
+   utf8_simd.h.  The input is read by chunks of 64 bytes, whose masks of
+   non-ASCII and of continuation bytes are computed at once.  Steps that
+   start with at least 6 ASCII characters copy or widen 16 bytes whole, and
+   the characters after the ASCII ones are overwritten by the next step. */
+static _Py_TARGET_SSE42 void
+STRINGLIB(utf8_decode_valid)(const unsigned char *s, const unsigned char *end,
+                             STRINGLIB_CHAR *q, STRINGLIB_CHAR *qend)
+{
+#if STRINGLIB_SIZEOF_CHAR > 1
+    const __m128i zero = _mm_setzero_si128();
+#endif
+    const __m128i cont = _mm_set1_epi8(-64);
+
+    while (end - s >= 64 && qend - q >= 64) {
+        uint64_t nonascii = 0, conts = 0, ends;
+        int i, pos = 0;
+
+        for (i = 0; i < 4; i++) {
+            __m128i v = _mm_loadu_si128((const __m128i *)(s + 16 * i));
+            nonascii |= (uint64_t)(unsigned int)_mm_movemask_epi8(v) << 16 * i;
+            conts |= (uint64_t)(unsigned int)_mm_movemask_epi8(
+                _mm_cmplt_epi8(v, cont)) << 16 * i;
+        }
+        /* The bytes followed by a byte that is not a continuation byte */
+        ends = ~conts >> 1;
+
+        while (pos < 48) {
+            __m128i v = _mm_loadu_si128((const __m128i *)(s + pos));
+            uint64_t rest = nonascii >> pos;
+            const unsigned char *entry;
+
+            if ((rest & 0x3F) == 0) {
+                int n = (rest & 0xFFFF) ? __builtin_ctzll(rest) : 16;
+#if STRINGLIB_SIZEOF_CHAR == 1
+                _mm_storeu_si128((__m128i *)q, v);
+#elif STRINGLIB_SIZEOF_CHAR == 2
+                _mm_storeu_si128((__m128i *)q, _mm_unpacklo_epi8(v, zero));
+                _mm_storeu_si128((__m128i *)(q + 8),
+                                 _mm_unpackhi_epi8(v, zero));
+#else
+                _mm_storeu_si128((__m128i *)q, _mm_cvtepu8_epi32(v));
+                _mm_storeu_si128((__m128i *)(q + 4),
+                                 _mm_cvtepu8_epi32(_mm_srli_si128(v, 4)));
+                _mm_storeu_si128((__m128i *)(q + 8),
+                                 _mm_cvtepu8_epi32(_mm_srli_si128(v, 8)));
+                _mm_storeu_si128((__m128i *)(q + 12),
+                                 _mm_cvtepu8_epi32(_mm_srli_si128(v, 12)));
+#endif
+                pos += n;
+                q += n;
+                continue;
+            }
+
+            entry = utf8_shuffle_index[(ends >> pos) & 0xFFF];
+            if (entry[0] < UTF8_SHUFFLES_16) {
+                __m128i chars = utf8_compose_16(v, entry[0]);
+#if STRINGLIB_SIZEOF_CHAR == 1
+                _mm_storel_epi64((__m128i *)q, _mm_packus_epi16(chars, chars));
+#elif STRINGLIB_SIZEOF_CHAR == 2
+                _mm_storeu_si128((__m128i *)q, chars);
+#else
+                _mm_storeu_si128((__m128i *)q, _mm_unpacklo_epi16(chars, zero));
+                _mm_storeu_si128((__m128i *)(q + 4),
+                                 _mm_unpackhi_epi16(chars, zero));
+#endif
+                pos += entry[1];
+                q += 6;
+                continue;
+            }
+#if STRINGLIB_MAX_CHAR > 0xFFu
+            if (entry[0] != UTF8_NO_SHUFFLE) {
+                __m128i chars = utf8_compose_32(v, entry[0]);
+#if STRINGLIB_SIZEOF_CHAR == 2
+                _mm_storeu_si128((__m128i *)q, _mm_packus_epi32(chars, chars));
+#else
+                _mm_storeu_si128((__m128i *)q, chars);
+#endif
+                pos += entry[1];
+                q += 4;
+                continue;
+            }
+#endif
+#if STRINGLIB_MAX_CHAR > 0xFFFFu
+            /* A sequence of 4 bytes comes early:  decode the characters up
+               to its end one by one. */
+            {
+                const unsigned char *p = s + pos;
+                Py_UCS4 ch;
+                do {
+                    ch = *p;
+                    if (ch < 0x80) {
+                        p++;
+                    }
+                    else if (ch < 0xE0) {
+                        ch = ((ch & 0x1F) << 6) | (p[1] & 0x3F);
+                        p += 2;
+                    }
+                    else if (ch < 0xF0) {
+                        ch = ((ch & 0x0F) << 12) | ((p[1] & 0x3F) << 6) |
+                             (p[2] & 0x3F);
+                        p += 3;
+                    }
+                    else {
+                        ch = ((ch & 0x07) << 18) | ((p[1] & 0x3F) << 12) |
+                             ((p[2] & 0x3F) << 6) | (p[3] & 0x3F);
+                        p += 4;
+                    }
+                    *q++ = ch;
+                } while (ch < 0x10000);
+                pos = (int)(p - s);
+            }
+#else
+            Py_UNREACHABLE();
+#endif
+        }
+        s += pos;
+    }
+
+    while (s < end) {
+        Py_UCS4 ch = *s;
+        if (ch < 0x80) {
+            s++;
+        }
+        else if (STRINGLIB_MAX_CHAR <= 0xFFu || ch < 0xE0) {
+            ch = ((ch & 0x1F) << 6) | (s[1] & 0x3F);
+            s += 2;
+        }
+        else if (STRINGLIB_MAX_CHAR <= 0xFFFFu || ch < 0xF0) {
+            ch = ((ch & 0x0F) << 12) | ((s[1] & 0x3F) << 6) | (s[2] & 0x3F);
+            s += 3;
+        }
+        else {
+            ch = ((ch & 0x07) << 18) | ((s[1] & 0x3F) << 12) |
+                 ((s[2] & 0x3F) << 6) | (s[3] & 0x3F);
+            s += 4;
+        }
+        *q++ = (STRINGLIB_CHAR)ch;
+    }
+    assert(q == qend);
+}
+#endif /* _Py_HAVE_X86_SIMD */
+
 
 /* UTF-8 encoder specialized for a Unicode kind to avoid the slow
    PyUnicode_READ() macro. Delete some parts of the code depending on the kind:
@@ -4,7 +4,12 @@
 
 /* fast search/count implementation, based on a mix between boyer-
    moore and horspool, with a few more bells and whistles on the top.
-   for some more background, see: http://effbot.org/zone/stringlib.htm */
+   for some more background, see: http://effbot.org/zone/stringlib.htm
+
+   forward searches and counts of short needles use SIMD instructions
+   when the CPU has them, and long needles in long haystacks use the
+   Two-Way algorithm, whose time is linear even on the periodic inputs
+   where the above is quadratic. */
 
 /* note: fastsearch may access s[n], which isn't a problem when using
    Python's ordinary string types, but may cause problems if you're
@@ -160,6 +165,425 @@ STRINGLIB(rfind_char)(const STRINGLIB_CHAR* s, Py_ssize_t n, STRINGLIB_CHAR ch)
 
 #undef MEMCHR_CUT_OFF
 
+/* The Two-Way algorithm of M. Crochemore and D. Perrin, "Two-way string
+   matching", Journal of the ACM 38(3), 1991, finds a needle in linear time
+   and constant space whatever the input.  The needle is split at a
+   critical factorization p = p[:cut] + p[cut:].  The right half of each
+   window is compared from left to right, then its left half; a mismatch in
+   the right half shifts the window past the characters that matched, and a
+   mismatch in the left half shifts it by the period of the needle.  When
+   the needle is periodic, the prefix of the shifted window that is known
+   to match is not compared again.
+
+   As in Horspool's algorithm, the last character of a window is first
+   looked up in a table of shifts indexed by its low bits, which skips most
+   windows in the average case. */
+
+#define STRINGLIB_SHIFT_BITS 6
+#define STRINGLIB_SHIFT_SIZE (1 << STRINGLIB_SHIFT_BITS)
+#define STRINGLIB_SHIFT_MASK (STRINGLIB_SHIFT_SIZE - 1)
+#define STRINGLIB_MAX_SHIFT 255
+
+typedef struct {
+    const STRINGLIB_CHAR *needle;
+    Py_ssize_t len;
+    Py_ssize_t cut;
+    Py_ssize_t period;
+    /* The distance from the last character of the needle to the previous
+       one with the same low bits */
+    Py_ssize_t gap;
+    int is_periodic;
+    unsigned char shift[STRINGLIB_SHIFT_SIZE];
+} STRINGLIB(prework);
+
+/* Return the start of the maximal suffix of needle[0:m] for the ordering
+   of the characters, or for the reverse ordering, and set *period to the
+   period of the suffix. */
+static Py_ssize_t
+STRINGLIB(_maximal_suffix)(const STRINGLIB_CHAR *needle, Py_ssize_t m,
+                           Py_ssize_t *period, int reverse)
+{
+    Py_ssize_t ms = -1, j = 0, k = 1, per = 1;
+
+    while (j + k < m) {
+        STRINGLIB_CHAR a = needle[j + k];
+        STRINGLIB_CHAR b = needle[ms + k];
+        if (reverse ? a > b : a < b) {
+            /* The suffix at j + k is smaller than the one at ms + 1 */
+            j += k;
+            k = 1;
+            per = j - ms;
+        }
+        else if (a == b) {
+            if (k != per) {
+                k++;
+            }
+            else {
+                j += per;
+                k = 1;
+            }
+        }
+        else {
+            /* The suffix at j + k is larger */
+            ms = j;
+            j = ms + 1;
+            k = per = 1;
+        }
+    }
+    *period = per;
+    return ms + 1;
+}
+
+static void
+STRINGLIB(_preprocess)(const STRINGLIB_CHAR *needle, Py_ssize_t m,
+                       STRINGLIB(prework) *pw)
+{
+    Py_ssize_t cut1, cut2, period1, period2, not_found, i;
+
+    /* The later of the two maximal suffixes gives a critical
+       factorization, and the period of its right half. */
+    cut1 = STRINGLIB(_maximal_suffix)(needle, m, &period1, 0);
+    cut2 = STRINGLIB(_maximal_suffix)(needle, m, &period2, 1);
+    pw->needle = needle;
+    pw->len = m;
+    if (cut1 > cut2) {
+        pw->cut = cut1;
+        pw->period = period1;
+    }
+    else {
+        pw->cut = cut2;
+        pw->period = period2;
+    }
+    assert(pw->cut + pw->period <= m);
+    pw->is_periodic = memcmp(needle, needle + pw->period,
+                             pw->cut * STRINGLIB_SIZEOF_CHAR) == 0;
+    if (!pw->is_periodic) {
+        /* A lower bound of the period of the needle */
+        pw->period = Py_MAX(pw->cut, m - pw->cut) + 1;
+    }
+
+    pw->gap = m;
+    for (i = m - 2; i >= 0; i--) {
+        if (((needle[i] ^ needle[m - 1]) & STRINGLIB_SHIFT_MASK) == 0) {
+            pw->gap = m - 1 - i;
+            break;
+        }
+    }
+
+    /* Shift a window to the last character of the needle, among the last
+       STRINGLIB_MAX_SHIFT ones, with the same low bits as its last
+       character. */
+    not_found = Py_MIN(m, STRINGLIB_MAX_SHIFT);
+    memset(pw->shift, (int)not_found, sizeof(pw->shift));
+    for (i = m - not_found; i < m; i++) {
+        pw->shift[needle[i] & STRINGLIB_SHIFT_MASK] =
+            Py_SAFE_DOWNCAST(m - 1 - i, Py_ssize_t, unsigned char);
+    }
+}
+
+/* Return the index of the first occurrence of the needle of pw in s[0:n],
+   or -1. */
+static Py_ssize_t
+STRINGLIB(_two_way)(const STRINGLIB_CHAR *s, Py_ssize_t n,
+                    const STRINGLIB(prework) *pw)
+{
+    const STRINGLIB_CHAR *p = pw->needle;
+    const Py_ssize_t m = pw->len, cut = pw->cut, gap = pw->gap;
+    const Py_ssize_t period = pw->is_periodic ? pw->period
+                                              : Py_MAX(pw->period, gap);
+    const STRINGLIB_CHAR *window_last = s + m - 1;
+    const STRINGLIB_CHAR *const end = s + n;
+    const STRINGLIB_CHAR *window;
+    /* The number of characters at the start of the window known to match */
+    Py_ssize_t memory = 0;
+    Py_ssize_t i;
+
+    while (window_last < end) {
+        if (memory == 0) {
+            for (;;) {
+                Py_ssize_t shift =
+                    pw->shift[*window_last & STRINGLIB_SHIFT_MASK];
+                if (shift == 0) {
+                    break;
+                }
+                window_last += shift;
+                if (window_last >= end) {
+                    return -1;
+                }
+            }
+        }
+        window = window_last - m + 1;
+        i = Py_MAX(cut, memory);
+        while (i < m && p[i] == window[i]) {
+            i++;
+        }
+        if (i < m) {
+            /* Without memory, the last character of the window has the low
+               bits of the last character of the needle, so that shifts
+               below gap cannot match. */
+            window_last += memory ? i - cut + 1 : Py_MAX(i - cut + 1, gap);
+            memory = 0;
+            continue;
+        }
+        i = cut;
+        while (i > memory && p[i - 1] == window[i - 1]) {
+            i--;
+        }
+        if (i <= memory) {
+            return window - s;
+        }
+        window_last += period;
+        if (pw->is_periodic) {
+            memory = m - period;
+        }
+    }
+    return -1;
+}
+
+static Py_ssize_t
+STRINGLIB(_two_way_find)(const STRINGLIB_CHAR *s, Py_ssize_t n,
+                         const STRINGLIB_CHAR *p, Py_ssize_t m)
+{
+    STRINGLIB(prework) pw;
+    STRINGLIB(_preprocess)(p, m, &pw);
+    return STRINGLIB(_two_way)(s, n, &pw);
+}
+
+static Py_ssize_t
+STRINGLIB(_two_way_count)(const STRINGLIB_CHAR *s, Py_ssize_t n,
+                          const STRINGLIB_CHAR *p, Py_ssize_t m,
+                          Py_ssize_t maxcount)
+{
+    STRINGLIB(prework) pw;
+    Py_ssize_t index = 0, count = 0;
+
+    STRINGLIB(_preprocess)(p, m, &pw);
+    for (;;) {
+        Py_ssize_t result = STRINGLIB(_two_way)(s + index, n - index, &pw);
+        if (result == -1) {
+            return count;
+        }
+        count++;
+        if (count == maxcount) {
+            return maxcount;
+        }
+        index += result + m;
+    }
+}
+
+/* The mix of Boyer-Moore and Horspool described above, for FAST_SEARCH and
+   FAST_COUNT.  In adaptive mode, it goes on with the Two-Way algorithm once
+   the windows that were candidates compared m / 4 characters, which bounds
+   its time on the inputs where it would be quadratic. */
+static Py_ssize_t
+STRINGLIB(_horspool_find)(const STRINGLIB_CHAR* s, Py_ssize_t n,
+                          const STRINGLIB_CHAR* p, Py_ssize_t m,
+                          Py_ssize_t maxcount, int mode, int adaptive)
+{
+    const STRINGLIB_CHAR *ss = s + m - 1;
+    const STRINGLIB_CHAR *pp = p + m - 1;
+    const Py_ssize_t w = n - m, mlast = m - 1;
+    Py_ssize_t skip = mlast - 1, count = 0, hits = 0;
+    Py_ssize_t i, j;
+    unsigned long mask = 0;
+
+    /* create compressed boyer-moore delta 1 table */
+
+    /* process pattern[:-1] */
+    for (i = 0; i < mlast; i++) {
+        STRINGLIB_BLOOM_ADD(mask, p[i]);
+        if (p[i] == p[mlast])
+            skip = mlast - i - 1;
+    }
+    /* process pattern[-1] outside the loop */
+    STRINGLIB_BLOOM_ADD(mask, p[mlast]);
+
+    for (i = 0; i <= w; i++) {
+        /* note: using mlast in the skip path slows things down on x86 */
+        if (ss[i] == pp[0]) {
+            /* candidate match */
+            for (j = 0; j < mlast; j++)
+                if (s[i+j] != p[j])
+                    break;
+            if (j == mlast) {
+                /* got a match! */
+                if (mode != FAST_COUNT)
+                    return i;
+                count++;
+                if (count == maxcount)
+                    return maxcount;
+                i = i + mlast;
+                continue;
+            }
+            /* miss: check if next character is part of pattern */
+            if (!STRINGLIB_BLOOM(mask, ss[i+1]))
+                i = i + m;
+            else
+                i = i + skip;
+            hits += j + 1;
+            if (adaptive && hits >= m / 4 && i < w - 1000) {
+                /* the next window is at i + 1 */
+                Py_ssize_t res;
+                if (mode != FAST_COUNT) {
+                    res = STRINGLIB(_two_way_find)(s + i + 1, n - i - 1, p, m);
+                    return res == -1 ? -1 : res + i + 1;
+                }
+                res = STRINGLIB(_two_way_count)(s + i + 1, n - i - 1, p, m,
+                                                maxcount - count);
+                return count + res;
+            }
+        } else {
+            /* skip: check if next character is part of pattern */
+            if (!STRINGLIB_BLOOM(mask, ss[i+1]))
+                i = i + m;
+        }
+    }
+
+    if (mode != FAST_COUNT)
+        return -1;
+    return count;
+}
+
+#ifdef _Py_HAVE_X86_SIMD
+/* Short needles are searched by comparing their first and their last
+   characters with those of 16 or 32 bytes of windows at once, as in
+   W. Mula, "SIMD-friendly algorithms for substring searching", 2016; only
+   the windows where both match are compared with the whole needle.  The
+   windows past the last full vector are checked one by one. */
+
+#define STRINGLIB_SIMD_MAX_NEEDLE 64
+
+#if STRINGLIB_SIZEOF_CHAR == 1
+#  define STRINGLIB_MM_SET1(ch) _mm_set1_epi8((char)(ch))
+#  define STRINGLIB_MM_CMPEQ _mm_cmpeq_epi8
+#  define STRINGLIB_MM256_SET1(ch) _mm256_set1_epi8((char)(ch))
+#  define STRINGLIB_MM256_CMPEQ _mm256_cmpeq_epi8
+   /* The bits of the byte masks of vector comparisons kept per character */
+#  define STRINGLIB_SIMD_CHAR_BITS 0xFFFFFFFFu
+#elif STRINGLIB_SIZEOF_CHAR == 2
+#  define STRINGLIB_MM_SET1(ch) _mm_set1_epi16((short)(ch))
+#  define STRINGLIB_MM_CMPEQ _mm_cmpeq_epi16
+#  define STRINGLIB_MM256_SET1(ch) _mm256_set1_epi16((short)(ch))
+#  define STRINGLIB_MM256_CMPEQ _mm256_cmpeq_epi16
+#  define STRINGLIB_SIMD_CHAR_BITS 0x55555555u
+#else
+#  define STRINGLIB_MM_SET1(ch) _mm_set1_epi32((int)(ch))
+#  define STRINGLIB_MM_CMPEQ _mm_cmpeq_epi32
+#  define STRINGLIB_MM256_SET1(ch) _mm256_set1_epi32((int)(ch))
+#  define STRINGLIB_MM256_CMPEQ _mm256_cmpeq_epi32
+#  define STRINGLIB_SIMD_CHAR_BITS 0x11111111u
+#endif
+
+/* Check the windows from i of a search of the SIMD kernels, which found
+   count matches before them. */
+static Py_ssize_t
+STRINGLIB(_simd_find_tail)(const STRINGLIB_CHAR *s, Py_ssize_t n,
+                           const STRINGLIB_CHAR *p, Py_ssize_t m,
+                           Py_ssize_t maxcount, int mode,
+                           Py_ssize_t i, Py_ssize_t count)
+{
+    for (; i <= n - m; i++) {
+        if (s[i] == p[0] && s[i + m - 1] == p[m - 1] &&
+            memcmp(s + i + 1, p + 1, (m - 2) * STRINGLIB_SIZEOF_CHAR) == 0)
+        {
+            if (mode != FAST_COUNT) {
+                return i;
+            }
+            count++;
+            if (count == maxcount) {
+                return maxcount;
+            }
+            i += m - 1;
+        }
+    }
+    return mode != FAST_COUNT ? -1 : count;
+}
+
+static _Py_TARGET_SSE42 Py_ssize_t
+STRINGLIB(_simd_find_sse42)(const STRINGLIB_CHAR *s, Py_ssize_t n,
+                            const STRINGLIB_CHAR *p, Py_ssize_t m,
+                            Py_ssize_t maxcount, int mode)
+{
+    const Py_ssize_t lanes = 16 / STRINGLIB_SIZEOF_CHAR;
+    const __m128i first = STRINGLIB_MM_SET1(p[0]);
+    const __m128i last = STRINGLIB_MM_SET1(p[m - 1]);
+    Py_ssize_t i = 0, count = 0;
+
+    while (i + lanes <= n - m + 1) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(s + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(s + i + m - 1));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(
+            _mm_and_si128(STRINGLIB_MM_CMPEQ(a, first),
+                          STRINGLIB_MM_CMPEQ(b, last)));
+        Py_ssize_t next = i + lanes;
+
+        mask &= STRINGLIB_SIMD_CHAR_BITS;
+        while (mask) {
+            Py_ssize_t k = i + __builtin_ctz(mask) / STRINGLIB_SIZEOF_CHAR;
+            mask &= mask - 1;
+            if (memcmp(s + k + 1, p + 1, (m - 2) * STRINGLIB_SIZEOF_CHAR) == 0) {
+                if (mode != FAST_COUNT) {
+                    return k;
+                }
+                count++;
+                if (count == maxcount) {
+                    return maxcount;
+                }
+                next = k + m;
+                break;
+            }
+        }
+        i = next;
+    }
+    return STRINGLIB(_simd_find_tail)(s, n, p, m, maxcount, mode, i, count);
+}
+
+static _Py_TARGET_AVX2 Py_ssize_t
+STRINGLIB(_simd_find_avx2)(const STRINGLIB_CHAR *s, Py_ssize_t n,
+                           const STRINGLIB_CHAR *p, Py_ssize_t m,
+                           Py_ssize_t maxcount, int mode)
+{
+    const Py_ssize_t lanes = 32 / STRINGLIB_SIZEOF_CHAR;
+    const __m256i first = STRINGLIB_MM256_SET1(p[0]);
+    const __m256i last = STRINGLIB_MM256_SET1(p[m - 1]);
+    Py_ssize_t i = 0, count = 0;
+
+    while (i + lanes <= n - m + 1) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(s + i));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(s + i + m - 1));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(
+            _mm256_and_si256(STRINGLIB_MM256_CMPEQ(a, first),
+                             STRINGLIB_MM256_CMPEQ(b, last)));
+        Py_ssize_t next = i + lanes;
+
+        mask &= STRINGLIB_SIMD_CHAR_BITS;
+        while (mask) {
+            Py_ssize_t k = i + __builtin_ctz(mask) / STRINGLIB_SIZEOF_CHAR;
+            mask &= mask - 1;
+            if (memcmp(s + k + 1, p + 1, (m - 2) * STRINGLIB_SIZEOF_CHAR) == 0) {
+                if (mode != FAST_COUNT) {
+                    return k;
+                }
+                count++;
+                if (count == maxcount) {
+                    return maxcount;
+                }
+                next = k + m;
+                break;
+            }
+        }
+        i = next;
+    }
+    return STRINGLIB(_simd_find_tail)(s, n, p, m, maxcount, mode, i, count);
+}
+
+#undef STRINGLIB_MM_SET1
+#undef STRINGLIB_MM_CMPEQ
+#undef STRINGLIB_MM256_SET1
+#undef STRINGLIB_MM256_CMPEQ
+#undef STRINGLIB_SIMD_CHAR_BITS
+#endif /* _Py_HAVE_X86_SIMD */
+
 Py_LOCAL_INLINE(Py_ssize_t)
 FASTSEARCH(const STRINGLIB_CHAR* s, Py_ssize_t n,
            const STRINGLIB_CHAR* p, Py_ssize_t m,
@@ -194,90 +618,66 @@ FASTSEARCH(const STRINGLIB_CHAR* s, Py_ssize_t n,
         }
     }
 
-    mlast = m - 1;
-    skip = mlast - 1;
-    mask = 0;
-
     if (mode != FAST_RSEARCH) {
-        const STRINGLIB_CHAR *ss = s + m - 1;
-        const STRINGLIB_CHAR *pp = p + m - 1;
-
-        /* create compressed boyer-moore delta 1 table */
-
-        /* process pattern[:-1] */
-        for (i = 0; i < mlast; i++) {
-            STRINGLIB_BLOOM_ADD(mask, p[i]);
-            if (p[i] == p[mlast])
-                skip = mlast - i - 1;
-        }
-        /* process pattern[-1] outside the loop */
-        STRINGLIB_BLOOM_ADD(mask, p[mlast]);
-
-        for (i = 0; i <= w; i++) {
-            /* note: using mlast in the skip path slows things down on x86 */
-            if (ss[i] == pp[0]) {
-                /* candidate match */
-                for (j = 0; j < mlast; j++)
-                    if (s[i+j] != p[j])
-                        break;
-                if (j == mlast) {
-                    /* got a match! */
-                    if (mode != FAST_COUNT)
-                        return i;
-                    count++;
-                    if (count == maxcount)
-                        return maxcount;
-                    i = i + mlast;
-                    continue;
-                }
-                /* miss: check if next character is part of pattern */
-                if (!STRINGLIB_BLOOM(mask, ss[i+1]))
-                    i = i + m;
-                else
-                    i = i + skip;
-            } else {
-                /* skip: check if next character is part of pattern */
-                if (!STRINGLIB_BLOOM(mask, ss[i+1]))
-                    i = i + m;
+#ifdef _Py_HAVE_X86_SIMD
+        if (m <= STRINGLIB_SIMD_MAX_NEEDLE) {
+            int level = _Py_GetSIMDLevel();
+            if (level >= _Py_SIMD_AVX2) {
+                return STRINGLIB(_simd_find_avx2)(s, n, p, m, maxcount, mode);
+            }
+            if (level >= _Py_SIMD_SSE42) {
+                return STRINGLIB(_simd_find_sse42)(s, n, p, m, maxcount, mode);
             }
         }
-    } else {    /* FAST_RSEARCH */
+#endif
+        if (n < 2500 || (m < 100 && n < 30000) || m < 6) {
+            return STRINGLIB(_horspool_find)(s, n, p, m, maxcount, mode, 0);
+        }
+        if ((m >> 2) * 3 < (n >> 2)) {
+            /* The needle is less than a third of the haystack:  the time
+               to preprocess it for the Two-Way algorithm pays off. */
+            if (mode == FAST_SEARCH)
+                return STRINGLIB(_two_way_find)(s, n, p, m);
+            return STRINGLIB(_two_way_count)(s, n, p, m, maxcount);
+        }
+        return STRINGLIB(_horspool_find)(s, n, p, m, maxcount, mode, 1);
+    }
 
-        /* create compressed boyer-moore delta 1 table */
+    /* FAST_RSEARCH */
+    mlast = m - 1;
+    skip = mlast - 1;
+    mask = 0;
 
-        /* process pattern[0] outside the loop */
-        STRINGLIB_BLOOM_ADD(mask, p[0]);
-        /* process pattern[:0:-1] */
-        for (i = mlast; i > 0; i--) {
-            STRINGLIB_BLOOM_ADD(mask, p[i]);
-            if (p[i] == p[0])
-                skip = i - 1;
-        }
+    /* create compressed boyer-moore delta 1 table */
 
-        for (i = w; i >= 0; i--) {
-            if (s[i] == p[0]) {
-                /* candidate match */
-                for (j = mlast; j > 0; j--)
-                    if (s[i+j] != p[j])
-                        break;
-                if (j == 0)
-                    /* got a match! */
-                    return i;
-                /* miss: check if previous character is part of pattern */
-                if (i > 0 && !STRINGLIB_BLOOM(mask, s[i-1]))
-                    i = i - m;
-                else
-                    i = i - skip;
-            } else {
-                /* skip: check if previous character is part of pattern */
-                if (i > 0 && !STRINGLIB_BLOOM(mask, s[i-1]))
-                    i = i - m;
-            }
-        }
+    /* process pattern[0] outside the loop */
+    STRINGLIB_BLOOM_ADD(mask, p[0]);
+    /* process pattern[:0:-1] */
+    for (i = mlast; i > 0; i--) {
+        STRINGLIB_BLOOM_ADD(mask, p[i]);
+        if (p[i] == p[0])
+            skip = i - 1;
     }
 
-    if (mode != FAST_COUNT)
-        return -1;
-    return count;
+    for (i = w; i >= 0; i--) {
+        if (s[i] == p[0]) {
+            /* candidate match */
+            for (j = mlast; j > 0; j--)
+                if (s[i+j] != p[j])
+                    break;
+            if (j == 0)
+                /* got a match! */
+                return i;
+            /* miss: check if previous character is part of pattern */
+            if (i > 0 && !STRINGLIB_BLOOM(mask, s[i-1]))
+                i = i - m;
+            else
+                i = i - skip;
+        } else {
+            /* skip: check if previous character is part of pattern */
+            if (i > 0 && !STRINGLIB_BLOOM(mask, s[i-1]))
+                i = i - m;
+        }
+    }
+    return -1;
 }
-
@@ -0,0 +1,452 @@
+/* SIMD kernels for the UTF-8 and ASCII decoders of unicodeobject.c.
+
+   They are only compiled when _Py_HAVE_X86_SIMD is defined (see
+   pycore_cpuinfo.h), and only called for the levels returned by
+   _Py_GetSIMDLevel().
+
+   The validation follows J. Keiser and D. Lemire, "Validating UTF-8 In Less
+   Than One Instruction Per Byte", Software: Practice and Experience 51(5),
+   2021.  Each byte is checked together with the byte before it, with three
+   table lookups indexed by their nibbles whose results are ANDed:  the
+   tables have a bit set for each kind of error that the nibble is part of.
+   The third and fourth bytes of a sequence, which the lookups cannot tell
+   from a misplaced continuation byte, are found by shifting the input by two
+   and three bytes. */
+
+#ifdef _Py_HAVE_X86_SIMD
+
+/* Error bits of the lookup tables, with the patterns of the two bytes */
+#define U8_TOO_SHORT      (1 << 0)  /* 11______ 0_______ or 11______ */
+#define U8_TOO_LONG       (1 << 1)  /* 0_______ 10______ */
+#define U8_OVERLONG_3     (1 << 2)  /* 11100000 100_____ */
+#define U8_TOO_LARGE      (1 << 3)  /* 11110100 1001____ or 101_____,
+                                       11110101+ 1001____ or 101_____ */
+#define U8_SURROGATE      (1 << 4)  /* 11101101 101_____ */
+#define U8_OVERLONG_2     (1 << 5)  /* 1100000_ 10______ */
+#define U8_TOO_LARGE_1000 (1 << 6)  /* 11110101+ 1000____ */
+#define U8_OVERLONG_4     (1 << 6)  /* 11110000 1000____ */
+#define U8_TWO_CONTS      (1 << 7)  /* 10______ 10______ */
+/* The errors that do not depend on the low nibble of the first byte */
+#define U8_CARRY (U8_TOO_SHORT | U8_TOO_LONG | U8_TWO_CONTS)
+
+/* Indexed by the high nibble of the first byte */
+static const unsigned char utf8_byte_1_high[16] = {
+    /* 0_______: ASCII */
+    U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG,
+    U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG,
+    /* 10______: continuation byte */
+    U8_TWO_CONTS, U8_TWO_CONTS, U8_TWO_CONTS, U8_TWO_CONTS,
+    /* 110_____: lead byte of 2 */
+    U8_TOO_SHORT | U8_OVERLONG_2,
+    U8_TOO_SHORT,
+    /* 1110____: lead byte of 3 */
+    U8_TOO_SHORT | U8_OVERLONG_3 | U8_SURROGATE,
+    /* 1111____: lead byte of 4, or invalid */
+    U8_TOO_SHORT | U8_TOO_LARGE | U8_TOO_LARGE_1000 | U8_OVERLONG_4
+};
+
+/* Indexed by the low nibble of the first byte */
+static const unsigned char utf8_byte_1_low[16] = {
+    U8_CARRY | U8_OVERLONG_2 | U8_OVERLONG_3 | U8_OVERLONG_4,
+    U8_CARRY | U8_OVERLONG_2,
+    U8_CARRY,
+    U8_CARRY,
+    U8_CARRY | U8_TOO_LARGE,
+    U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+    U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+    U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+    U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+    U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+    U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+    U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+    U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+    U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000 | U8_SURROGATE,
+    U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000,
+    U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000
+};
+
+/* Indexed by the high nibble of the second byte */
+static const unsigned char utf8_byte_2_high[16] = {
+    /* 0_______: ASCII */
+    U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT,
+    U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT,
+    /* 1000____ */
+    U8_TOO_LONG | U8_OVERLONG_2 | U8_TWO_CONTS | U8_OVERLONG_3 |
+    U8_TOO_LARGE_1000 | U8_OVERLONG_4,
+    /* 1001____ */
+    U8_TOO_LONG | U8_OVERLONG_2 | U8_TWO_CONTS | U8_OVERLONG_3 |
+    U8_TOO_LARGE,
+    /* 101_____ */
+    U8_TOO_LONG | U8_OVERLONG_2 | U8_TWO_CONTS | U8_SURROGATE |
+    U8_TOO_LARGE,
+    U8_TOO_LONG | U8_OVERLONG_2 | U8_TWO_CONTS | U8_SURROGATE |
+    U8_TOO_LARGE,
+    /* 11______: lead byte */
+    U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT
+};
+
+/* Return the errors of the 16 bytes of input, given the 16 bytes before
+   them. */
+static _Py_TARGET_SSE42 __m128i
+utf8_errors_sse42(__m128i input, __m128i prev_input)
+{
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    __m128i prev1 = _mm_alignr_epi8(input, prev_input, 15);
+    __m128i prev2 = _mm_alignr_epi8(input, prev_input, 14);
+    __m128i prev3 = _mm_alignr_epi8(input, prev_input, 13);
+    __m128i b1h, b1l, b2h, must23;
+
+    b1h = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)utf8_byte_1_high),
+                           _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+    b1l = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)utf8_byte_1_low),
+                           _mm_and_si128(prev1, nibble));
+    b2h = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)utf8_byte_2_high),
+                           _mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+    /* The bytes that follow a lead byte of 3 or 4 by two bytes, or a lead
+       byte of 4 by three bytes, must be continuation bytes, whose pair with
+       the byte before them then gives U8_TWO_CONTS and nothing else. */
+    must23 = _mm_or_si128(
+        _mm_subs_epu8(prev2, _mm_set1_epi8((char)(0xE0 - 0x80))),
+        _mm_subs_epu8(prev3, _mm_set1_epi8((char)(0xF0 - 0x80))));
+    must23 = _mm_and_si128(must23, _mm_set1_epi8((char)0x80));
+    return _mm_xor_si128(must23,
+                         _mm_and_si128(_mm_and_si128(b1h, b1l), b2h));
+}
+
+/* Check that s[0:end - s] is valid UTF-8.  Return the number of characters
+   it encodes and set *pmaxbyte to its largest byte, or return -1 if it is
+   invalid. */
+static _Py_TARGET_SSE42 Py_ssize_t
+utf8_count_sse42(const unsigned char *s, const unsigned char *end,
+                 unsigned char *pmaxbyte)
+{
+    const __m128i zero = _mm_setzero_si128();
+    /* Bytes greater than these at the end of a block start sequences that
+       continue in the next block. */
+    const __m128i max_last = _mm_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        (char)(0xF0 - 1), (char)(0xE0 - 1), (char)(0xC0 - 1));
+    __m128i prev_input = zero, incomplete = zero, error = zero;
+    __m128i maxv = zero, nconts = zero, total = zero;
+    unsigned char buf[16];
+    uint64_t sums[2];
+    Py_ssize_t size = end - s;
+    int i, last = 0, rounds = 0;
+
+    while (!last) {
+        __m128i input;
+        if (end - s >= 16) {
+            input = _mm_loadu_si128((const __m128i *)s);
+            s += 16;
+        }
+        else {
+            /* Pad the last block with zeros.  They are ASCII, so the usual
+               checks also catch a sequence cut short by the end. */
+            memset(buf, 0, sizeof(buf));
+            memcpy(buf, s, end - s);
+            input = _mm_loadu_si128((const __m128i *)buf);
+            last = 1;
+        }
+        if (_mm_movemask_epi8(input) == 0) {
+            /* Only the end of the previous block can be wrong. */
+            error = _mm_or_si128(error, incomplete);
+            incomplete = zero;
+        }
+        else {
+            error = _mm_or_si128(error, utf8_errors_sse42(input, prev_input));
+            incomplete = _mm_subs_epu8(input, max_last);
+            maxv = _mm_max_epu8(maxv, input);
+            /* Count the continuation bytes, 0x80-0xBF, by lane, until the
+               counts could overflow. */
+            nconts = _mm_sub_epi8(nconts, _mm_cmplt_epi8(input,
+                                                         _mm_set1_epi8(-64)));
+            if (++rounds == 255) {
+                total = _mm_add_epi64(total, _mm_sad_epu8(nconts, zero));
+                nconts = zero;
+                rounds = 0;
+            }
+        }
+        prev_input = input;
+    }
+    if (!_mm_testz_si128(error, error)) {
+        return -1;
+    }
+    total = _mm_add_epi64(total, _mm_sad_epu8(nconts, zero));
+    _mm_storeu_si128((__m128i *)sums, total);
+    _mm_storeu_si128((__m128i *)buf, maxv);
+    *pmaxbyte = 0;
+    for (i = 0; i < 16; i++) {
+        if (buf[i] > *pmaxbyte) {
+            *pmaxbyte = buf[i];
+        }
+    }
+    return size - (Py_ssize_t)(sums[0] + sums[1]);
+}
+
+/* The same for 32 bytes of input. */
+static _Py_TARGET_AVX2 __m256i
+utf8_errors_avx2(__m256i input, __m256i prev_input)
+{
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    /* The last 16 bytes of prev_input and the first 16 bytes of input, to
+       shift bytes across the two halves of the registers. */
+    __m256i carry = _mm256_permute2x128_si256(prev_input, input, 0x21);
+    __m256i prev1 = _mm256_alignr_epi8(input, carry, 15);
+    __m256i prev2 = _mm256_alignr_epi8(input, carry, 14);
+    __m256i prev3 = _mm256_alignr_epi8(input, carry, 13);
+    __m256i b1h, b1l, b2h, must23;
+
+    b1h = _mm256_shuffle_epi8(
+        _mm256_broadcastsi128_si256(
+            _mm_loadu_si128((const __m128i *)utf8_byte_1_high)),
+        _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+    b1l = _mm256_shuffle_epi8(
+        _mm256_broadcastsi128_si256(
+            _mm_loadu_si128((const __m128i *)utf8_byte_1_low)),
+        _mm256_and_si256(prev1, nibble));
+    b2h = _mm256_shuffle_epi8(
+        _mm256_broadcastsi128_si256(
+            _mm_loadu_si128((const __m128i *)utf8_byte_2_high)),
+        _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble));
+    must23 = _mm256_or_si256(
+        _mm256_subs_epu8(prev2, _mm256_set1_epi8((char)(0xE0 - 0x80))),
+        _mm256_subs_epu8(prev3, _mm256_set1_epi8((char)(0xF0 - 0x80))));
+    must23 = _mm256_and_si256(must23, _mm256_set1_epi8((char)0x80));
+    return _mm256_xor_si256(must23,
+                            _mm256_and_si256(_mm256_and_si256(b1h, b1l), b2h));
+}
+
+static _Py_TARGET_AVX2 Py_ssize_t
+utf8_count_avx2(const unsigned char *s, const unsigned char *end,
+                unsigned char *pmaxbyte)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i max_last = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        (char)(0xF0 - 1), (char)(0xE0 - 1), (char)(0xC0 - 1));
+    __m256i prev_input = zero, incomplete = zero, error = zero;
+    __m256i maxv = zero, nconts = zero, total = zero;
+    unsigned char buf[32];
+    uint64_t sums[4];
+    Py_ssize_t size = end - s;
+    int i, last = 0, rounds = 0;
+
+    while (!last) {
+        __m256i input;
+        if (end - s >= 32) {
+            input = _mm256_loadu_si256((const __m256i *)s);
+            s += 32;
+        }
+        else {
+            memset(buf, 0, sizeof(buf));
+            memcpy(buf, s, end - s);
+            input = _mm256_loadu_si256((const __m256i *)buf);
+            last = 1;
+        }
+        if (_mm256_movemask_epi8(input) == 0) {
+            error = _mm256_or_si256(error, incomplete);
+            incomplete = zero;
+        }
+        else {
+            error = _mm256_or_si256(error,
+                                    utf8_errors_avx2(input, prev_input));
+            incomplete = _mm256_subs_epu8(input, max_last);
+            maxv = _mm256_max_epu8(maxv, input);
+            nconts = _mm256_sub_epi8(
+                nconts, _mm256_cmpgt_epi8(_mm256_set1_epi8(-64), input));
+            if (++rounds == 255) {
+                total = _mm256_add_epi64(total,
+                                         _mm256_sad_epu8(nconts, zero));
+                nconts = zero;
+                rounds = 0;
+            }
+        }
+        prev_input = input;
+    }
+    if (!_mm256_testz_si256(error, error)) {
+        return -1;
+    }
+    total = _mm256_add_epi64(total, _mm256_sad_epu8(nconts, zero));
+    _mm256_storeu_si256((__m256i *)sums, total);
+    _mm256_storeu_si256((__m256i *)buf, maxv);
+    *pmaxbyte = 0;
+    for (i = 0; i < 32; i++) {
+        if (buf[i] > *pmaxbyte) {
+            *pmaxbyte = buf[i];
+        }
+    }
+    return size - (Py_ssize_t)(sums[0] + sums[1] + sums[2] + sums[3]);
+}
+
+/* Copy the ASCII prefix of start[0:end - start] to dest, which has room for
+   all of it, and return its length. */
+static _Py_TARGET_SSE42 Py_ssize_t
+ascii_decode_sse42(const char *start, const char *end, Py_UCS1 *dest)
+{
+    const char *p = start;
+
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)p);
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(v);
+        _mm_storeu_si128((__m128i *)(dest + (p - start)), v);
+        if (mask) {
+            return p - start + __builtin_ctz(mask);
+        }
+        p += 16;
+    }
+    while (p < end && !((unsigned char)*p & 0x80)) {
+        dest[p - start] = (Py_UCS1)*p;
+        p++;
+    }
+    return p - start;
+}
+
+static _Py_TARGET_AVX2 Py_ssize_t
+ascii_decode_avx2(const char *start, const char *end, Py_UCS1 *dest)
+{
+    const char *p = start;
+
+    while (end - p >= 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)p);
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(v);
+        _mm256_storeu_si256((__m256i *)(dest + (p - start)), v);
+        if (mask) {
+            return p - start + __builtin_ctz(mask);
+        }
+        p += 32;
+    }
+    return p - start + ascii_decode_sse42(p, end, dest + (p - start));
+}
+
+/* STRINGLIB(utf8_decode_valid) in codecs.h decodes valid UTF-8 by steps of
+   up to 16 bytes, following D. Lemire and J. Keiser, "Transcoding Billions
+   of Unicode Characters per Second with SIMD Instructions", Software:
+   Practice and Experience 52(2), 2022.  The bytes that end a character
+   among the first 12 bytes of the step, those followed by a byte that is
+   not a continuation byte, give the lengths of the first characters.  If
+   the first 6 characters take 1 or 2 bytes each, a shuffle gathers each of
+   them into a 16-bit lane; else if the first 4 characters take up to 3
+   bytes each, a shuffle gathers each of them into a 32-bit lane.  The lanes
+   hold the last byte of the character in their low byte, and the bits of
+   the characters are then extracted with masks and shifts.
+
+   utf8_shuffle_index[m] gives the index of the shuffle in utf8_shuffles
+   and the number of bytes it consumes, for the mask m of the bytes that
+   end a character.  The first 64 shuffles are for 16-bit lanes:  bit i of
+   their index is set if character i takes 2 bytes.  The next 81 are for
+   32-bit lanes:  their index is 64 plus the number with the length minus 1
+   of character i as digit i in base 3.  The index is 255 when neither kind
+   applies, because of a sequence of 4 bytes:  the characters are then
+   decoded one by one, which is faster than shuffles of 3 characters for
+   the mostly ASCII text where such sequences are frequent. */
+
+#define UTF8_SHUFFLES_16 64
+#define UTF8_SHUFFLES (UTF8_SHUFFLES_16 + 81)
+#define UTF8_NO_SHUFFLE 255
+
+static unsigned char utf8_shuffle_index[1 << 12][2];
+static unsigned char utf8_shuffles[UTF8_SHUFFLES][16];
+static int utf8_shuffles_ready = 0;
+
+/* Fill the shuffle tables on the first use.  The GIL serializes the
+   callers. */
+static void
+utf8_init_shuffles(void)
+{
+    int idx, i, j, mask;
+
+    if (utf8_shuffles_ready) {
+        return;
+    }
+    memset(utf8_shuffles, 0x80, sizeof(utf8_shuffles));
+    for (idx = 0; idx < UTF8_SHUFFLES; idx++) {
+        int pos = 0;
+        if (idx < UTF8_SHUFFLES_16) {
+            for (i = 0; i < 6; i++) {
+                int len = 1 + ((idx >> i) & 1);
+                for (j = 0; j < len; j++) {
+                    utf8_shuffles[idx][2 * i + j] = pos + len - 1 - j;
+                }
+                pos += len;
+            }
+        }
+        else {
+            int digits = idx - UTF8_SHUFFLES_16;
+            for (i = 0; i < 4; i++, digits /= 3) {
+                int len = 1 + digits % 3;
+                for (j = 0; j < len; j++) {
+                    utf8_shuffles[idx][4 * i + j] = pos + len - 1 - j;
+                }
+                pos += len;
+            }
+        }
+    }
+    for (mask = 0; mask < (1 << 12); mask++) {
+        int lens[12], n = 0, start = 0, bits16 = 0, digits = 0, pow3 = 1;
+        for (i = 0; i < 12; i++) {
+            if (mask & (1 << i)) {
+                lens[n++] = i + 1 - start;
+                start = i + 1;
+            }
+        }
+        utf8_shuffle_index[mask][0] = UTF8_NO_SHUFFLE;
+        utf8_shuffle_index[mask][1] = 0;
+        for (i = 0, start = 0; i < 6 && i < n && lens[i] <= 2; i++) {
+            bits16 |= (lens[i] - 1) << i;
+            start += lens[i];
+        }
+        if (i == 6) {
+            utf8_shuffle_index[mask][0] = bits16;
+            utf8_shuffle_index[mask][1] = start;
+            continue;
+        }
+        for (i = 0, start = 0; i < 4 && i < n && lens[i] <= 3; i++) {
+            digits += (lens[i] - 1) * pow3;
+            pow3 *= 3;
+            start += lens[i];
+        }
+        if (i == 4) {
+            utf8_shuffle_index[mask][0] = UTF8_SHUFFLES_16 + digits;
+            utf8_shuffle_index[mask][1] = start;
+        }
+    }
+    utf8_shuffles_ready = 1;
+}
+
+/* Decode the characters of up to 2 bytes gathered into 16-bit lanes. */
+static _Py_TARGET_SSE42 __m128i
+utf8_compose_16(__m128i v, int idx)
+{
+    __m128i perm = _mm_shuffle_epi8(
+        v, _mm_loadu_si128((const __m128i *)utf8_shuffles[idx]));
+    __m128i low = _mm_and_si128(perm, _mm_set1_epi16(0x7F));
+    __m128i high = _mm_and_si128(perm, _mm_set1_epi16(0x1F00));
+    return _mm_or_si128(low, _mm_srli_epi16(high, 2));
+}
+
+/* Decode the characters of up to 3 bytes gathered into 32-bit lanes. */
+static _Py_TARGET_SSE42 __m128i
+utf8_compose_32(__m128i v, int idx)
+{
+    __m128i perm = _mm_shuffle_epi8(
+        v, _mm_loadu_si128((const __m128i *)utf8_shuffles[idx]));
+    __m128i low = _mm_and_si128(perm, _mm_set1_epi32(0x7F));
+    __m128i middle = _mm_and_si128(perm, _mm_set1_epi32(0x3F00));
+    __m128i high = _mm_and_si128(perm, _mm_set1_epi32(0x0F0000));
+    return _mm_or_si128(_mm_or_si128(low, _mm_srli_epi32(middle, 2)),
+                        _mm_srli_epi32(high, 4));
+}
+
+#undef U8_TOO_SHORT
+#undef U8_TOO_LONG
+#undef U8_OVERLONG_3
+#undef U8_TOO_LARGE
+#undef U8_SURROGATE
+#undef U8_OVERLONG_2
+#undef U8_TOO_LARGE_1000
+#undef U8_OVERLONG_4
+#undef U8_TWO_CONTS
+#undef U8_CARRY
+
+#endif /* _Py_HAVE_X86_SIMD */
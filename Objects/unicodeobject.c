@@ -42,6 +42,7 @@ OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 #include "Python.h"
 #include "pycore_abstract.h"       // _PyIndex_Check()
 #include "pycore_bytes_methods.h"
+#include "pycore_cpuinfo.h"        // _Py_GetSIMDLevel()
 #include "pycore_fileutils.h"
 #include "pycore_initconfig.h"
 #include "pycore_interp.h"         // PyInterpreterState.fs_codec
@@ -49,6 +50,7 @@ OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 #include "pycore_pathconfig.h"
 #include "pycore_pylifecycle.h"
 #include "pycore_pystate.h"        // _PyInterpreterState_GET()
+#include "pycore_unicodeobject.h"  // _PyUnicode_FindSubstring()
 #include "ucnhash.h"
 #include "stringlib/eq.h"
 
@@ -1008,6 +1010,36 @@ findchar(const void *s, int kind,
     }
 }
 
+/* Search for the substring p[:m] in s[:n], both made of characters of the
+   given kind, without reading s[n] as fastsearch() does: s may be the
+   buffer of a bytes-like object.  Used by the regular expression engine. */
+Py_ssize_t
+_PyUnicode_FindSubstring(int kind, const void *s, Py_ssize_t n,
+                         const void *p, Py_ssize_t m)
+{
+    Py_ssize_t i;
+
+    if (m <= 0 || m > n)
+        return m == 0 ? 0 : -1;
+    /* the windows before the last one, then the last one */
+    switch (kind) {
+    case PyUnicode_1BYTE_KIND:
+        i = ucs1lib_fastsearch(s, n - 1, p, m, -1, FAST_SEARCH);
+        break;
+    case PyUnicode_2BYTE_KIND:
+        i = ucs2lib_fastsearch(s, n - 1, p, m, -1, FAST_SEARCH);
+        break;
+    case PyUnicode_4BYTE_KIND:
+        i = ucs4lib_fastsearch(s, n - 1, p, m, -1, FAST_SEARCH);
+        break;
+    default:
+        Py_UNREACHABLE();
+    }
+    if (i < 0 && memcmp((const char *)s + (n - m) * kind, p, m * kind) == 0)
+        i = n - m;
+    return i;
+}
+
 #ifdef Py_DEBUG
 /* Fill the data of a Unicode string with invalid characters to detect bugs
    earlier.
@@ -4875,6 +4907,8 @@ PyUnicode_DecodeUTF8(const char *s,
     return PyUnicode_DecodeUTF8Stateful(s, size, errors, NULL);
 }
 
+#include "stringlib/utf8_simd.h"
+
 #include "stringlib/asciilib.h"
 #include "stringlib/codecs.h"
 #include "stringlib/undef.h"
@@ -4907,6 +4941,15 @@ ascii_decode(const char *start, const char *end, Py_UCS1 *dest)
     const char *p = start;
     const char *aligned_end = (const char *) _Py_ALIGN_DOWN(end, SIZEOF_LONG);
 
+#ifdef _Py_HAVE_X86_SIMD
+    int level = _Py_GetSIMDLevel();
+    if (level >= _Py_SIMD_AVX2) {
+        return ascii_decode_avx2(start, end, dest);
+    }
+    if (level >= _Py_SIMD_SSE42) {
+        return ascii_decode_sse42(start, end, dest);
+    }
+#endif
     /*
      * Issue #17237: m68k is a bit different from most architectures in
      * that objects do not use "natural alignment" - for example, int and
@@ -4965,6 +5008,92 @@ ascii_decode(const char *start, const char *end, Py_UCS1 *dest)
     return p - start;
 }
 
+#ifdef _Py_HAVE_X86_SIMD
+/* Return the end of s[0:end - s] without the sequence that its last bytes
+   start, if it is incomplete. */
+static const char *
+utf8_complete_end(const char *s, const char *end)
+{
+    const char *p = end;
+
+    while (p > s && end - p < 4) {
+        unsigned char ch = (unsigned char)*--p;
+        if (ch < 0x80) {
+            break;
+        }
+        if (ch >= 0xC0) {
+            if (end - p < (ch >= 0xF0 ? 4 : ch >= 0xE0 ? 3 : 2)) {
+                return p;
+            }
+            break;
+        }
+    }
+    return end;
+}
+
+/* Decode the UTF-8 data starts[0:end - starts] with the SIMD kernels, given
+   that its first s - starts bytes are ASCII and that s[0] is not ASCII.
+   Return 1 and set *result to the decoded string, or return 0 if the data
+   after the ASCII prefix is not valid UTF-8.  Return -1 on memory error. */
+static int
+unicode_decode_utf8_simd(const char *starts, const char *s, const char *end,
+                         int level, PyObject **result)
+{
+    const unsigned char *p = (const unsigned char *)s;
+    const unsigned char *e = (const unsigned char *)end;
+    Py_ssize_t nprefix = s - starts, n;
+    const Py_UCS1 *pdata = (const Py_UCS1 *)starts;
+    unsigned char maxbyte;
+    Py_UCS4 maxchar;
+    PyObject *v;
+
+    if (level >= _Py_SIMD_AVX2) {
+        n = utf8_count_avx2(p, e, &maxbyte);
+    }
+    else {
+        n = utf8_count_sse42(p, e, &maxbyte);
+    }
+    if (n < 0) {
+        return 0;
+    }
+    utf8_init_shuffles();
+    /* Lead bytes up to 0xC3 encode characters up to U+00FF, up to 0xEF
+       characters up to U+FFFF. */
+    assert(maxbyte >= 0xC2);
+    maxchar = maxbyte < 0xC4 ? 0xFF : maxbyte < 0xF0 ? 0xFFFF : MAX_UNICODE;
+    v = PyUnicode_New(nprefix + n, maxchar);
+    if (v == NULL) {
+        return -1;
+    }
+    switch (PyUnicode_KIND(v)) {
+    case PyUnicode_1BYTE_KIND: {
+        Py_UCS1 *data = PyUnicode_1BYTE_DATA(v);
+        memcpy(data, pdata, nprefix);
+        ucs1lib_utf8_decode_valid(p, e, data + nprefix, data + nprefix + n);
+        break;
+    }
+    case PyUnicode_2BYTE_KIND: {
+        Py_UCS2 *data = PyUnicode_2BYTE_DATA(v);
+        _PyUnicode_CONVERT_BYTES(Py_UCS1, Py_UCS2, pdata, pdata + nprefix,
+                                 data);
+        ucs2lib_utf8_decode_valid(p, e, data + nprefix, data + nprefix + n);
+        break;
+    }
+    default: {
+        Py_UCS4 *data = PyUnicode_4BYTE_DATA(v);
+        assert(PyUnicode_KIND(v) == PyUnicode_4BYTE_KIND);
+        _PyUnicode_CONVERT_BYTES(Py_UCS1, Py_UCS4, pdata, pdata + nprefix,
+                                 data);
+        ucs4lib_utf8_decode_valid(p, e, data + nprefix, data + nprefix + n);
+        break;
+    }
+    }
+    assert(_PyUnicode_CheckConsistency(v, 1));
+    *result = v;
+    return 1;
+}
+#endif
+
 static PyObject *
 unicode_decode_utf8(const char *s, Py_ssize_t size,
                     _Py_error_handler error_handler, const char *errors,
@@ -4995,11 +5124,50 @@ unicode_decode_utf8(const char *s, Py_ssize_t size,
     if (s == end) {
         return u;
     }
+    Py_ssize_t pos = s - starts;
+
+#ifdef _Py_HAVE_X86_SIMD
+    // Validate the rest with the SIMD kernels: valid data can then be
+    // decoded straight into a string of the right kind and length.  An
+    // incomplete sequence at the end of the data of a stateful decoder
+    // is left to the loop below.
+    int level = _Py_GetSIMDLevel();
+    if (level >= _Py_SIMD_SSE42) {
+        const char *valid_end = consumed ? utf8_complete_end(s, end) : end;
+        if (valid_end > s) {
+            // Release the ASCII string first: the allocator can then reuse
+            // its memory, which is still in the cache, for the result.
+            Py_CLEAR(u);
+            int res = unicode_decode_utf8_simd(starts, s, valid_end, level,
+                                               &u);
+            if (res < 0) {
+                return NULL;
+            }
+            if (res > 0) {
+                if (valid_end == end) {
+                    if (consumed) {
+                        *consumed = size;
+                    }
+                    return u;
+                }
+                s = valid_end;
+                pos = PyUnicode_GET_LENGTH(u);
+            }
+            else {
+                u = PyUnicode_New(size, 127);
+                if (u == NULL) {
+                    return NULL;
+                }
+                memcpy(PyUnicode_1BYTE_DATA(u), starts, pos);
+            }
+        }
+    }
+#endif
 
     // Use _PyUnicodeWriter after fast path is failed.
     _PyUnicodeWriter writer;
     _PyUnicodeWriter_InitWithBuffer(&writer, u);
-    writer.pos = s - starts;
+    writer.pos = pos;
 
     Py_ssize_t startinpos, endinpos;
     const char *errmsg = "";
@@ -15,6 +15,7 @@
 #include "pycore_ceval.h"
 #include "pycore_code.h"
 #include "pycore_initconfig.h"
+#include "pycore_long.h"          // _PyLong_Add()
 #include "pycore_object.h"
 #include "pycore_pyerrors.h"
 #include "pycore_pylifecycle.h"
@@ -29,6 +30,7 @@
 #include "opcode.h"
 #include "pydtrace.h"
 #include "setobject.h"
+#include "structmember.h"         // struct PyMemberDef, T_OBJECT_EX
 
 #include <ctype.h>
 
@@ -120,8 +122,73 @@ static size_t opcache_code_objects_extra_mem = 0;
 static size_t opcache_global_opts = 0;
 static size_t opcache_global_hits = 0;
 static size_t opcache_global_misses = 0;
+
+static size_t opcache_attr_opts = 0;
+static size_t opcache_attr_deopts = 0;
+static size_t opcache_attr_hits = 0;
+static size_t opcache_attr_misses = 0;
+
+static size_t opcache_store_attr_opts = 0;
+static size_t opcache_store_attr_deopts = 0;
+static size_t opcache_store_attr_hits = 0;
+static size_t opcache_store_attr_misses = 0;
+
+static size_t opcache_method_opts = 0;
+static size_t opcache_method_deopts = 0;
+static size_t opcache_method_hits = 0;
+static size_t opcache_method_misses = 0;
 #endif
 
+/* Number of misses tolerated by a LOAD_ATTR, STORE_ATTR or LOAD_METHOD
+   cache entry before the instruction is deoptimized for good. */
+#define OPCACHE_MAX_TRIES 20
+
+/* Backoff of the adaptive instructions, see ADAPTIVE_WAIT() */
+#define ADAPTIVE_BACKOFF_BITS 12
+#define ADAPTIVE_WAIT_MASK ((1 << ADAPTIVE_BACKOFF_BITS) - 1)
+#define ADAPTIVE_MAX_BACKOFF ADAPTIVE_BACKOFF_BITS
+
+static inline void
+adaptive_backoff(uint16_t *counter)
+{
+    int backoff = *counter >> ADAPTIVE_BACKOFF_BITS;
+    if (backoff < ADAPTIVE_MAX_BACKOFF) {
+        backoff++;
+    }
+    *counter = (uint16_t)((backoff << ADAPTIVE_BACKOFF_BITS) |
+                          ((1 << backoff) - 1));
+}
+
+/* Helpers for the COMPARE_OP specializations: evaluate the rich comparison
+   operator op on a three-way comparison result, or on two doubles. */
+static inline int
+compare_sign(Py_ssize_t sign, int op)
+{
+    switch (op) {
+    case Py_LT: return sign < 0;
+    case Py_LE: return sign <= 0;
+    case Py_EQ: return sign == 0;
+    case Py_NE: return sign != 0;
+    case Py_GT: return sign > 0;
+    case Py_GE: return sign >= 0;
+    default: Py_UNREACHABLE();
+    }
+}
+
+static inline int
+compare_doubles(double a, double b, int op)
+{
+    switch (op) {
+    case Py_LT: return a < b;
+    case Py_LE: return a <= b;
+    case Py_EQ: return a == b;
+    case Py_NE: return a != b;
+    case Py_GT: return a > b;
+    case Py_GE: return a >= b;
+    default: Py_UNREACHABLE();
+    }
+}
+
 
 #ifndef NDEBUG
 /* Ensure that tstate is valid: sanity check for PyEval_AcquireThread() and
@@ -340,6 +407,23 @@ PyEval_InitThreads(void)
     /* Do nothing: kept for backward compatibility */
 }
 
+#if OPCACHE_STATS
+static void
+print_opcache_stats(const char *opname, size_t hits, size_t misses,
+                    size_t opts, size_t deopts)
+{
+    size_t total = hits + misses;
+
+    fprintf(stderr, "-- Opcode cache %s hits   = %zd (%d%%)\n",
+            opname, hits, total ? (int) (100.0 * hits / total) : 0);
+    fprintf(stderr, "-- Opcode cache %s misses = %zd (%d%%)\n",
+            opname, misses, total ? (int) (100.0 * misses / total) : 0);
+    fprintf(stderr, "-- Opcode cache %s opts   = %zd\n", opname, opts);
+    fprintf(stderr, "-- Opcode cache %s deopts = %zd\n", opname, deopts);
+    fprintf(stderr, "\n");
+}
+#endif
+
 void
 _PyEval_Fini(void)
 {
@@ -366,6 +450,16 @@ _PyEval_Fini(void)
             opcache_global_opts);
 
     fprintf(stderr, "\n");
+
+    print_opcache_stats("LOAD_ATTR", opcache_attr_hits,
+                        opcache_attr_misses, opcache_attr_opts,
+                        opcache_attr_deopts);
+    print_opcache_stats("STORE_ATTR", opcache_store_attr_hits,
+                        opcache_store_attr_misses, opcache_store_attr_opts,
+                        opcache_store_attr_deopts);
+    print_opcache_stats("LOAD_METHOD", opcache_method_hits,
+                        opcache_method_misses, opcache_method_opts,
+                        opcache_method_deopts);
 #endif
 }
 
@@ -1268,14 +1362,124 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, PyFrameObject *f, int throwflag)
         if (co->co_opcache != NULL) opcache_global_opts++; \
     } while (0)
 
+/* kind is one of attr, store_attr or method */
+#define OPCACHE_STAT_HIT(kind) \
+    do { \
+        if (co->co_opcache != NULL) opcache_ ## kind ## _hits++; \
+    } while (0)
+
+#define OPCACHE_STAT_MISS(kind) \
+    do { \
+        if (co->co_opcache != NULL) opcache_ ## kind ## _misses++; \
+    } while (0)
+
+#define OPCACHE_STAT_OPT(kind) \
+    do { \
+        if (co->co_opcache != NULL) opcache_ ## kind ## _opts++; \
+    } while (0)
+
+#define OPCACHE_STAT_DEOPT(kind) \
+    do { \
+        if (co->co_opcache != NULL) opcache_ ## kind ## _deopts++; \
+    } while (0)
+
 #else /* OPCACHE_STATS */
 
 #define OPCACHE_STAT_GLOBAL_HIT()
 #define OPCACHE_STAT_GLOBAL_MISS()
 #define OPCACHE_STAT_GLOBAL_OPT()
 
+#define OPCACHE_STAT_HIT(kind)
+#define OPCACHE_STAT_MISS(kind)
+#define OPCACHE_STAT_OPT(kind)
+#define OPCACHE_STAT_DEOPT(kind)
+
 #endif
 
+/* Disable the cache of the current instruction for good: used when an
+   instruction is not cacheable (e.g. the attribute is a property) or keeps
+   seeing different types. */
+#define OPCACHE_DEOPT(kind) \
+    do { \
+        if (co_opcache != NULL) { \
+            OPCACHE_STAT_DEOPT(kind); \
+            co_opcache->optimized = -1; \
+            co->co_opcache_map[next_instr - first_instr] = 0; \
+            co_opcache = NULL; \
+        } \
+    } while (0)
+
+#define OPCACHE_MAYBE_DEOPT(kind) \
+    do { \
+        if (co_opcache != NULL && --co_opcache->optimized <= 0) { \
+            OPCACHE_DEOPT(kind); \
+        } \
+    } while (0)
+
+/* Macros for the specialized instructions.  They only run from the
+   quickened copy of the bytecode (see _PyCode_Quicken()), which they
+   rewrite in place: an adaptive instruction replaces itself with the form
+   specialized for the types of its operands, and a specialized instruction
+   whose type guard fails replaces itself with the adaptive form again.
+   The replacement is executed right away, with the stack untouched.
+
+   After each failure, to specialize or of a type guard, the adaptive form
+   runs the generic instruction for a number of executions which doubles
+   every time (up to ADAPTIVE_MAX_BACKOFF), before it tries to specialize
+   again: an instruction which sees operands of mixed types does not keep
+   rewriting itself, while one whose operand types changed for good gets
+   specialized for the new types. */
+#define GO_TO_INSTRUCTION(op) goto PREDICT_ID(op)
+
+#define WRITE_INSTRUCTION(op) \
+    (((_Py_CODEUNIT *)next_instr)[-1] = \
+        _Py_MAKECODEUNIT(op, _Py_OPARG(next_instr[-1])))
+
+#define SPECIALIZE(op) \
+    do { \
+        WRITE_INSTRUCTION(op); \
+        GO_TO_INSTRUCTION(op); \
+    } while (0)
+
+/* The counter of the current instruction: the number of executions left
+   to wait in the low bits, the log2 of the backoff in the high bits */
+#define ADAPTIVE_COUNTER() \
+    (co->co_adaptive_counters[next_instr - first_instr - 1])
+
+/* At the start of an adaptive instruction: run the generic instruction op
+   while backing off */
+#define ADAPTIVE_WAIT(op) \
+    do { \
+        if ((ADAPTIVE_COUNTER() & ADAPTIVE_WAIT_MASK) != 0) { \
+            ADAPTIVE_COUNTER()--; \
+            GO_TO_INSTRUCTION(op); \
+        } \
+    } while (0)
+
+/* In an adaptive instruction: no specialized form fits the operands */
+#define ADAPTIVE_MISS(op) \
+    do { \
+        adaptive_backoff(&ADAPTIVE_COUNTER()); \
+        GO_TO_INSTRUCTION(op); \
+    } while (0)
+
+/* In a specialized form of op: the type guard failed */
+#define DEOPT(op) \
+    do { \
+        adaptive_backoff(&ADAPTIVE_COUNTER()); \
+        WRITE_INSTRUCTION(op##_ADAPTIVE); \
+        GO_TO_INSTRUCTION(op); \
+    } while (0)
+
+/* Mark the cache of the current instruction as filled */
+#define OPCACHE_SET_OPTIMIZED(kind) \
+    do { \
+        if (co_opcache->optimized == 0) { \
+            OPCACHE_STAT_OPT(kind); \
+            co_opcache->optimized = OPCACHE_MAX_TRIES; \
+        } \
+    } while (0)
+
 /* Start of code */
 
     /* push frame */
@@ -1361,18 +1565,26 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, PyFrameObject *f, int throwflag)
     if (co->co_opcache_flag < OPCACHE_MIN_RUNS) {
         co->co_opcache_flag++;
         if (co->co_opcache_flag == OPCACHE_MIN_RUNS) {
-            if (_PyCode_InitOpcache(co) < 0) {
+            if (_PyCode_InitOpcache(co) < 0 || _PyCode_Quicken(co) < 0) {
                 goto exit_eval_frame;
             }
 #if OPCACHE_STATS
             opcache_code_objects_extra_mem +=
                 PyBytes_Size(co->co_code) / sizeof(_Py_CODEUNIT) +
-                sizeof(_PyOpcache) * co->co_opcache_size;
+                sizeof(_PyOpcache) * co->co_opcache_size +
+                PyBytes_Size(co->co_code);
             opcache_code_objects++;
 #endif
         }
     }
 
+    /* Hot code objects run from their quickened copy of co_code.  It has
+       the same layout as co_code, so f_lasti is valid for both. */
+    if (co->co_quickened != NULL) {
+        next_instr = co->co_quickened + (next_instr - first_instr);
+        first_instr = co->co_quickened;
+    }
+
 #ifdef LLTRACE
     lltrace = _PyDict_GetItemId(f->f_globals, &PyId___ltrace__) != NULL;
 #endif
@@ -1709,6 +1921,7 @@ main_loop:
         }
 
         case TARGET(BINARY_ADD): {
+            PREDICTED(BINARY_ADD);
             PyObject *right = POP();
             PyObject *left = TOP();
             PyObject *sum;
@@ -1717,7 +1930,8 @@ main_loop:
                See http://bugs.python.org/issue21955 and
                http://bugs.python.org/issue10044 for the discussion. In short,
                no patch shown any impact on a realistic benchmark, only a minor
-               speedup on microbenchmarks. */
+               speedup on microbenchmarks.  Hot code objects use the
+               type-specialized forms of this instruction below instead. */
             if (PyUnicode_CheckExact(left) &&
                      PyUnicode_CheckExact(right)) {
                 sum = unicode_concatenate(tstate, left, right, f, next_instr);
@@ -1734,6 +1948,78 @@ main_loop:
             DISPATCH();
         }
 
+        case TARGET(BINARY_ADD_ADAPTIVE): {
+            ADAPTIVE_WAIT(BINARY_ADD);
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            if (Py_IS_TYPE(left, Py_TYPE(right))) {
+                if (PyLong_CheckExact(left)) {
+                    SPECIALIZE(BINARY_ADD_INT);
+                }
+                if (PyFloat_CheckExact(left)) {
+                    SPECIALIZE(BINARY_ADD_FLOAT);
+                }
+                if (PyUnicode_CheckExact(left)) {
+                    SPECIALIZE(BINARY_ADD_UNICODE);
+                }
+            }
+            ADAPTIVE_MISS(BINARY_ADD);
+        }
+
+        case TARGET(BINARY_ADD_INT): {
+            PREDICTED(BINARY_ADD_INT);
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            if (!PyLong_CheckExact(left) || !PyLong_CheckExact(right)) {
+                DEOPT(BINARY_ADD);
+            }
+            PyObject *sum = _PyLong_Add((PyLongObject *)left,
+                                        (PyLongObject *)right);
+            STACK_SHRINK(1);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            SET_TOP(sum);
+            if (sum == NULL)
+                goto error;
+            DISPATCH();
+        }
+
+        case TARGET(BINARY_ADD_FLOAT): {
+            PREDICTED(BINARY_ADD_FLOAT);
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            if (!PyFloat_CheckExact(left) || !PyFloat_CheckExact(right)) {
+                DEOPT(BINARY_ADD);
+            }
+            PyObject *sum = PyFloat_FromDouble(PyFloat_AS_DOUBLE(left) +
+                                               PyFloat_AS_DOUBLE(right));
+            STACK_SHRINK(1);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            SET_TOP(sum);
+            if (sum == NULL)
+                goto error;
+            DISPATCH();
+        }
+
+        case TARGET(BINARY_ADD_UNICODE): {
+            PREDICTED(BINARY_ADD_UNICODE);
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            if (!PyUnicode_CheckExact(left) || !PyUnicode_CheckExact(right)) {
+                DEOPT(BINARY_ADD);
+            }
+            STACK_SHRINK(1);
+            PyObject *sum = unicode_concatenate(tstate, left, right, f,
+                                                next_instr);
+            /* unicode_concatenate consumed the ref to left */
+            Py_DECREF(right);
+            SET_TOP(sum);
+            if (sum == NULL)
+                goto error;
+            DISPATCH();
+        }
+
         case TARGET(BINARY_SUBTRACT): {
             PyObject *right = POP();
             PyObject *left = TOP();
@@ -1747,6 +2033,7 @@ main_loop:
         }
 
         case TARGET(BINARY_SUBSCR): {
+            PREDICTED(BINARY_SUBSCR);
             PyObject *sub = POP();
             PyObject *container = TOP();
             PyObject *res = PyObject_GetItem(container, sub);
@@ -1758,6 +2045,107 @@ main_loop:
             DISPATCH();
         }
 
+        case TARGET(BINARY_SUBSCR_ADAPTIVE): {
+            ADAPTIVE_WAIT(BINARY_SUBSCR);
+            PyObject *sub = TOP();
+            PyObject *container = SECOND();
+            if (PyLong_CheckExact(sub)) {
+                if (PyList_CheckExact(container)) {
+                    SPECIALIZE(BINARY_SUBSCR_LIST_INT);
+                }
+                if (PyTuple_CheckExact(container)) {
+                    SPECIALIZE(BINARY_SUBSCR_TUPLE_INT);
+                }
+            }
+            if (PyDict_CheckExact(container)) {
+                SPECIALIZE(BINARY_SUBSCR_DICT);
+            }
+            ADAPTIVE_MISS(BINARY_SUBSCR);
+        }
+
+        case TARGET(BINARY_SUBSCR_LIST_INT): {
+            PREDICTED(BINARY_SUBSCR_LIST_INT);
+            PyObject *sub = TOP();
+            PyObject *container = SECOND();
+            if (!PyList_CheckExact(container) || !PyLong_CheckExact(sub)) {
+                DEOPT(BINARY_SUBSCR);
+            }
+            Py_ssize_t i = PyLong_AsSsize_t(sub);
+            if (i == -1 && _PyErr_Occurred(tstate)) {
+                /* Let the generic form raise IndexError for indexes which
+                   do not fit in Py_ssize_t */
+                _PyErr_Clear(tstate);
+                GO_TO_INSTRUCTION(BINARY_SUBSCR);
+            }
+            if (i < 0) {
+                i += PyList_GET_SIZE(container);
+            }
+            if ((size_t)i >= (size_t)PyList_GET_SIZE(container)) {
+                /* Let the generic form raise IndexError */
+                GO_TO_INSTRUCTION(BINARY_SUBSCR);
+            }
+            PyObject *res = PyList_GET_ITEM(container, i);
+            Py_INCREF(res);
+            STACK_SHRINK(1);
+            Py_DECREF(container);
+            Py_DECREF(sub);
+            SET_TOP(res);
+            DISPATCH();
+        }
+
+        case TARGET(BINARY_SUBSCR_TUPLE_INT): {
+            PREDICTED(BINARY_SUBSCR_TUPLE_INT);
+            PyObject *sub = TOP();
+            PyObject *container = SECOND();
+            if (!PyTuple_CheckExact(container) || !PyLong_CheckExact(sub)) {
+                DEOPT(BINARY_SUBSCR);
+            }
+            Py_ssize_t i = PyLong_AsSsize_t(sub);
+            if (i == -1 && _PyErr_Occurred(tstate)) {
+                /* Let the generic form raise IndexError for indexes which
+                   do not fit in Py_ssize_t */
+                _PyErr_Clear(tstate);
+                GO_TO_INSTRUCTION(BINARY_SUBSCR);
+            }
+            if (i < 0) {
+                i += PyTuple_GET_SIZE(container);
+            }
+            if ((size_t)i >= (size_t)PyTuple_GET_SIZE(container)) {
+                /* Let the generic form raise IndexError */
+                GO_TO_INSTRUCTION(BINARY_SUBSCR);
+            }
+            PyObject *res = PyTuple_GET_ITEM(container, i);
+            Py_INCREF(res);
+            STACK_SHRINK(1);
+            Py_DECREF(container);
+            Py_DECREF(sub);
+            SET_TOP(res);
+            DISPATCH();
+        }
+
+        case TARGET(BINARY_SUBSCR_DICT): {
+            PREDICTED(BINARY_SUBSCR_DICT);
+            PyObject *sub = TOP();
+            PyObject *container = SECOND();
+            if (!PyDict_CheckExact(container)) {
+                DEOPT(BINARY_SUBSCR);
+            }
+            PyObject *res = PyDict_GetItemWithError(container, sub);
+            if (res != NULL) {
+                Py_INCREF(res);
+            }
+            else if (!_PyErr_Occurred(tstate)) {
+                _PyErr_SetKeyError(sub);
+            }
+            STACK_SHRINK(1);
+            Py_DECREF(container);
+            Py_DECREF(sub);
+            SET_TOP(res);
+            if (res == NULL)
+                goto error;
+            DISPATCH();
+        }
+
         case TARGET(BINARY_LSHIFT): {
             PyObject *right = POP();
             PyObject *left = TOP();
@@ -1915,6 +2303,7 @@ main_loop:
         }
 
         case TARGET(INPLACE_ADD): {
+            PREDICTED(INPLACE_ADD);
             PyObject *right = POP();
             PyObject *left = TOP();
             PyObject *sum;
@@ -1933,6 +2322,79 @@ main_loop:
             DISPATCH();
         }
 
+        case TARGET(INPLACE_ADD_ADAPTIVE): {
+            ADAPTIVE_WAIT(INPLACE_ADD);
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            if (Py_IS_TYPE(left, Py_TYPE(right))) {
+                if (PyLong_CheckExact(left)) {
+                    SPECIALIZE(INPLACE_ADD_INT);
+                }
+                if (PyFloat_CheckExact(left)) {
+                    SPECIALIZE(INPLACE_ADD_FLOAT);
+                }
+                if (PyUnicode_CheckExact(left)) {
+                    SPECIALIZE(INPLACE_ADD_UNICODE);
+                }
+            }
+            ADAPTIVE_MISS(INPLACE_ADD);
+        }
+
+        case TARGET(INPLACE_ADD_INT): {
+            PREDICTED(INPLACE_ADD_INT);
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            if (!PyLong_CheckExact(left) || !PyLong_CheckExact(right)) {
+                DEOPT(INPLACE_ADD);
+            }
+            /* int is immutable: in-place addition is plain addition */
+            PyObject *sum = _PyLong_Add((PyLongObject *)left,
+                                        (PyLongObject *)right);
+            STACK_SHRINK(1);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            SET_TOP(sum);
+            if (sum == NULL)
+                goto error;
+            DISPATCH();
+        }
+
+        case TARGET(INPLACE_ADD_FLOAT): {
+            PREDICTED(INPLACE_ADD_FLOAT);
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            if (!PyFloat_CheckExact(left) || !PyFloat_CheckExact(right)) {
+                DEOPT(INPLACE_ADD);
+            }
+            PyObject *sum = PyFloat_FromDouble(PyFloat_AS_DOUBLE(left) +
+                                               PyFloat_AS_DOUBLE(right));
+            STACK_SHRINK(1);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            SET_TOP(sum);
+            if (sum == NULL)
+                goto error;
+            DISPATCH();
+        }
+
+        case TARGET(INPLACE_ADD_UNICODE): {
+            PREDICTED(INPLACE_ADD_UNICODE);
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            if (!PyUnicode_CheckExact(left) || !PyUnicode_CheckExact(right)) {
+                DEOPT(INPLACE_ADD);
+            }
+            STACK_SHRINK(1);
+            PyObject *sum = unicode_concatenate(tstate, left, right, f,
+                                                next_instr);
+            /* unicode_concatenate consumed the ref to left */
+            Py_DECREF(right);
+            SET_TOP(sum);
+            if (sum == NULL)
+                goto error;
+            DISPATCH();
+        }
+
         case TARGET(INPLACE_SUBTRACT): {
             PyObject *right = POP();
             PyObject *left = TOP();
@@ -2457,9 +2919,107 @@ main_loop:
             PyObject *name = GETITEM(names, oparg);
             PyObject *owner = TOP();
             PyObject *v = SECOND();
+            PyTypeObject *type = Py_TYPE(owner);
+            _PyOpcache_LoadAttr *la = NULL;
             int err;
             STACK_SHRINK(2);
+
+            OPCACHE_CHECK();
+            if (co_opcache != NULL && co_opcache->optimized > 0) {
+                la = &co_opcache->u.la;
+                if (la->type == type &&
+                    la->tp_version_tag == type->tp_version_tag &&
+                    _PyType_HasFeature(type, Py_TPFLAGS_VALID_VERSION_TAG))
+                {
+                    if (la->hint < -1) {
+                        /* __slots__ member: steal the reference to v */
+                        PyObject **addr = (PyObject **)(
+                            (char *)owner + ~la->hint);
+                        PyObject *old = *addr;
+                        OPCACHE_STAT_HIT(store_attr);
+                        *addr = v;
+                        Py_XDECREF(old);
+                        Py_DECREF(owner);
+                        DISPATCH();
+                    }
+                    PyObject *dict = *(PyObject **)(
+                        (char *)owner + type->tp_dictoffset);
+                    if (dict != NULL && PyDict_CheckExact(dict) &&
+                        _PyDict_SetItemHint((PyDictObject *)dict, name,
+                                            la->hint, v))
+                    {
+                        OPCACHE_STAT_HIT(store_attr);
+                        Py_DECREF(v);
+                        Py_DECREF(owner);
+                        DISPATCH();
+                    }
+                    /* Missing dict or stale hint: learn a new hint below */
+                    OPCACHE_STAT_MISS(store_attr);
+                }
+                else {
+                    /* The type is different or was modified */
+                    OPCACHE_STAT_MISS(store_attr);
+                    OPCACHE_MAYBE_DEOPT(store_attr);
+                    la = NULL;
+                }
+            }
+            else if (co_opcache != NULL && co_opcache->optimized == 0) {
+                /* Cache the store if it goes to the instance dict or to a
+                   __slots__ member. */
+                PyObject *descr = NULL;
+                PyMemberDef *dmem;
+                if (type->tp_setattro != PyObject_GenericSetAttr ||
+                    type->tp_dict == NULL ||
+                    (descr = _PyType_Lookup(type, name),
+                     !_PyType_HasFeature(type, Py_TPFLAGS_VALID_VERSION_TAG)))
+                {
+                    OPCACHE_DEOPT(store_attr);
+                }
+                else if (descr == NULL && type->tp_dictoffset > 0) {
+                    la = &co_opcache->u.la;
+                    OPCACHE_SET_OPTIMIZED(store_attr);
+                    la->type = type;
+                    la->tp_version_tag = type->tp_version_tag;
+                    la->hint = -1;
+                }
+                else if (descr != NULL &&
+                         Py_IS_TYPE(descr, &PyMemberDescr_Type) &&
+                         (dmem = ((PyMemberDescrObject *)descr)->d_member,
+                          dmem->type == T_OBJECT_EX && dmem->flags == 0))
+                {
+                    assert(dmem->offset > 0);
+                    la = &co_opcache->u.la;
+                    OPCACHE_SET_OPTIMIZED(store_attr);
+                    la->type = type;
+                    la->tp_version_tag = type->tp_version_tag;
+                    la->hint = ~dmem->offset;
+                    la = NULL;
+                }
+                else {
+                    /* Properties, non-slot descriptors, no __dict__... */
+                    OPCACHE_DEOPT(store_attr);
+                }
+            }
+
             err = PyObject_SetAttr(owner, name, v);
+            if (err == 0 && la != NULL && Py_TYPE(owner) == type) {
+                /* Remember where the value landed in the instance dict */
+                PyObject *dict = *(PyObject **)(
+                    (char *)owner + type->tp_dictoffset);
+                la->hint = -1;
+                if (dict != NULL && PyDict_CheckExact(dict)) {
+                    PyObject *res = NULL;
+                    Py_ssize_t hint = _PyDict_GetItemHint(
+                        (PyDictObject *)dict, name, -1, &res);
+                    if (res != NULL) {
+                        la->hint = hint;
+                    }
+                    else if (_PyErr_Occurred(tstate)) {
+                        /* The store itself succeeded */
+                        _PyErr_Clear(tstate);
+                    }
+                }
+            }
             Py_DECREF(v);
             Py_DECREF(owner);
             if (err != 0)
@@ -3018,7 +3578,135 @@ main_loop:
         case TARGET(LOAD_ATTR): {
             PyObject *name = GETITEM(names, oparg);
             PyObject *owner = TOP();
-            PyObject *res = PyObject_GetAttr(owner, name);
+            PyTypeObject *type = Py_TYPE(owner);
+            PyObject *res;
+
+            OPCACHE_CHECK();
+            if (co_opcache != NULL && co_opcache->optimized > 0) {
+                _PyOpcache_LoadAttr *la = &co_opcache->u.la;
+
+                if (la->type == type &&
+                    la->tp_version_tag == type->tp_version_tag &&
+                    _PyType_HasFeature(type, Py_TPFLAGS_VALID_VERSION_TAG))
+                {
+                    if (la->hint < -1) {
+                        /* __slots__ member */
+                        res = *(PyObject **)((char *)owner + ~la->hint);
+                        if (res != NULL) {
+                            OPCACHE_STAT_HIT(attr);
+                            Py_INCREF(res);
+                            SET_TOP(res);
+                            Py_DECREF(owner);
+                            DISPATCH();
+                        }
+                        /* Unset slot: the slow path raises AttributeError */
+                    }
+                    else {
+                        PyObject *dict = *(PyObject **)(
+                            (char *)owner + type->tp_dictoffset);
+                        if (dict != NULL && PyDict_CheckExact(dict)) {
+                            Py_ssize_t hint = la->hint;
+                            res = NULL;
+                            Py_INCREF(dict);
+                            hint = _PyDict_GetItemHint(
+                                (PyDictObject *)dict, name, hint, &res);
+                            if (res != NULL) {
+                                if (la->hint == hint) {
+                                    OPCACHE_STAT_HIT(attr);
+                                }
+                                else {
+                                    OPCACHE_STAT_MISS(attr);
+                                    la->hint = hint;
+                                }
+                                Py_INCREF(res);
+                                SET_TOP(res);
+                                Py_DECREF(owner);
+                                Py_DECREF(dict);
+                                DISPATCH();
+                            }
+                            Py_DECREF(dict);
+                            if (_PyErr_Occurred(tstate)) {
+                                Py_DECREF(owner);
+                                SET_TOP(NULL);
+                                goto error;
+                            }
+                            /* The attribute is missing from this instance:
+                               the slow path raises AttributeError. */
+                        }
+                    }
+                    OPCACHE_STAT_MISS(attr);
+                }
+                else {
+                    /* The type is different or was modified */
+                    OPCACHE_STAT_MISS(attr);
+                    OPCACHE_MAYBE_DEOPT(attr);
+                }
+            }
+            else if (co_opcache != NULL && co_opcache->optimized == 0) {
+                /* Fill the cache if the attribute is a plain instance
+                   attribute, stored either in the instance dict or in a
+                   __slots__ member. */
+                PyObject *descr = NULL;
+                if (type->tp_getattro != PyObject_GenericGetAttr ||
+                    type->tp_dict == NULL ||
+                    (descr = _PyType_Lookup(type, name),
+                     !_PyType_HasFeature(type, Py_TPFLAGS_VALID_VERSION_TAG)))
+                {
+                    OPCACHE_DEOPT(attr);
+                }
+                else if (descr != NULL) {
+                    PyMemberDef *dmem;
+                    if (Py_IS_TYPE(descr, &PyMemberDescr_Type) &&
+                        (dmem = ((PyMemberDescrObject *)descr)->d_member,
+                         dmem->type == T_OBJECT_EX && dmem->flags == 0))
+                    {
+                        assert(dmem->offset > 0);
+                        _PyOpcache_LoadAttr *la = &co_opcache->u.la;
+                        OPCACHE_SET_OPTIMIZED(attr);
+                        la->type = type;
+                        la->tp_version_tag = type->tp_version_tag;
+                        la->hint = ~dmem->offset;
+                    }
+                    else {
+                        /* Properties, methods, class attributes... */
+                        OPCACHE_DEOPT(attr);
+                    }
+                }
+                else if (type->tp_dictoffset > 0) {
+                    PyObject *dict = *(PyObject **)(
+                        (char *)owner + type->tp_dictoffset);
+                    if (dict != NULL && PyDict_CheckExact(dict)) {
+                        _PyOpcache_LoadAttr *la = &co_opcache->u.la;
+                        Py_INCREF(dict);
+                        res = NULL;
+                        Py_ssize_t hint = _PyDict_GetItemHint(
+                            (PyDictObject *)dict, name, -1, &res);
+                        if (res != NULL) {
+                            OPCACHE_SET_OPTIMIZED(attr);
+                            la->type = type;
+                            la->tp_version_tag = type->tp_version_tag;
+                            la->hint = hint;
+                            Py_INCREF(res);
+                            SET_TOP(res);
+                            Py_DECREF(owner);
+                            Py_DECREF(dict);
+                            DISPATCH();
+                        }
+                        Py_DECREF(dict);
+                        if (_PyErr_Occurred(tstate)) {
+                            Py_DECREF(owner);
+                            SET_TOP(NULL);
+                            goto error;
+                        }
+                    }
+                    /* Else retry the next time */
+                }
+                else {
+                    OPCACHE_DEOPT(attr);
+                }
+            }
+
+            res = PyObject_GetAttr(owner, name);
             Py_DECREF(owner);
             SET_TOP(res);
             if (res == NULL)
@@ -3027,6 +3715,7 @@ main_loop:
         }
 
         case TARGET(COMPARE_OP): {
+            PREDICTED(COMPARE_OP);
             assert(oparg <= Py_GE);
             PyObject *right = POP();
             PyObject *left = TOP();
@@ -3041,6 +3730,86 @@ main_loop:
             DISPATCH();
         }
 
+        case TARGET(COMPARE_OP_ADAPTIVE): {
+            ADAPTIVE_WAIT(COMPARE_OP);
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            if (Py_IS_TYPE(left, Py_TYPE(right))) {
+                if (PyLong_CheckExact(left)) {
+                    SPECIALIZE(COMPARE_OP_INT);
+                }
+                if (PyFloat_CheckExact(left)) {
+                    SPECIALIZE(COMPARE_OP_FLOAT);
+                }
+                if (PyUnicode_CheckExact(left)) {
+                    SPECIALIZE(COMPARE_OP_UNICODE);
+                }
+            }
+            ADAPTIVE_MISS(COMPARE_OP);
+        }
+
+        case TARGET(COMPARE_OP_INT): {
+            PREDICTED(COMPARE_OP_INT);
+            assert(oparg <= Py_GE);
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            if (!PyLong_CheckExact(left) || !PyLong_CheckExact(right)) {
+                DEOPT(COMPARE_OP);
+            }
+            Py_ssize_t sign = _PyLong_Compare((PyLongObject *)left,
+                                              (PyLongObject *)right);
+            PyObject *res = compare_sign(sign, oparg) ? Py_True : Py_False;
+            Py_INCREF(res);
+            STACK_SHRINK(1);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            SET_TOP(res);
+            PREDICT(POP_JUMP_IF_FALSE);
+            PREDICT(POP_JUMP_IF_TRUE);
+            DISPATCH();
+        }
+
+        case TARGET(COMPARE_OP_FLOAT): {
+            PREDICTED(COMPARE_OP_FLOAT);
+            assert(oparg <= Py_GE);
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            if (!PyFloat_CheckExact(left) || !PyFloat_CheckExact(right)) {
+                DEOPT(COMPARE_OP);
+            }
+            PyObject *res = compare_doubles(PyFloat_AS_DOUBLE(left),
+                                            PyFloat_AS_DOUBLE(right),
+                                            oparg) ? Py_True : Py_False;
+            Py_INCREF(res);
+            STACK_SHRINK(1);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            SET_TOP(res);
+            PREDICT(POP_JUMP_IF_FALSE);
+            PREDICT(POP_JUMP_IF_TRUE);
+            DISPATCH();
+        }
+
+        case TARGET(COMPARE_OP_UNICODE): {
+            PREDICTED(COMPARE_OP_UNICODE);
+            assert(oparg <= Py_GE);
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            if (!PyUnicode_CheckExact(left) || !PyUnicode_CheckExact(right)) {
+                DEOPT(COMPARE_OP);
+            }
+            PyObject *res = PyUnicode_RichCompare(left, right, oparg);
+            STACK_SHRINK(1);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            SET_TOP(res);
+            if (res == NULL)
+                goto error;
+            PREDICT(POP_JUMP_IF_FALSE);
+            PREDICT(POP_JUMP_IF_TRUE);
+            DISPATCH();
+        }
+
         case TARGET(IS_OP): {
             PyObject *right = POP();
             PyObject *left = TOP();
@@ -3456,7 +4225,101 @@ main_loop:
             /* Designed to work in tandem with CALL_METHOD. */
             PyObject *name = GETITEM(names, oparg);
             PyObject *obj = TOP();
+            PyTypeObject *type = Py_TYPE(obj);
             PyObject *meth = NULL;
+            PyObject *dict;
+
+            OPCACHE_CHECK();
+            if (co_opcache != NULL && co_opcache->optimized > 0) {
+                _PyOpcache_LoadMethod *lm = &co_opcache->u.lm;
+
+                if (lm->type == type &&
+                    lm->tp_version_tag == type->tp_version_tag &&
+                    _PyType_HasFeature(type, Py_TPFLAGS_VALID_VERSION_TAG))
+                {
+                    /* The method is still found on the type: check that
+                       the instance dict does not shadow it.  The keys
+                       version only tells that for combined tables: the
+                       instances sharing split keys may or may not have a
+                       value for the name. */
+                    int shadowed = 0;
+                    if (type->tp_dictoffset > 0 &&
+                        (dict = *(PyObject **)(
+                            (char *)obj + type->tp_dictoffset)) != NULL)
+                    {
+                        if (!PyDict_CheckExact(dict)) {
+                            shadowed = 1;
+                        }
+                        else if (lm->dk_version == 0 ||
+                                 ((PyDictObject *)dict)->ma_values != NULL ||
+                                 _PyDict_GetKeysVersion(
+                                    (PyDictObject *)dict) != lm->dk_version)
+                        {
+                            PyObject *attr = NULL;
+                            Py_INCREF(dict);
+                            (void)_PyDict_GetItemHint(
+                                (PyDictObject *)dict, name, -1, &attr);
+                            if (attr == NULL && _PyErr_Occurred(tstate)) {
+                                Py_DECREF(dict);
+                                goto error;
+                            }
+                            if (attr != NULL ||
+                                Py_TYPE(obj) != type ||
+                                lm->tp_version_tag != type->tp_version_tag ||
+                                !_PyType_HasFeature(
+                                    type, Py_TPFLAGS_VALID_VERSION_TAG))
+                            {
+                                /* Shadowed, or the lookup ran code which
+                                   modified the type */
+                                shadowed = 1;
+                            }
+                            else if (((PyDictObject *)dict)->ma_values == NULL)
+                            {
+                                lm->dk_version = _PyDict_GetKeysVersion(
+                                    (PyDictObject *)dict);
+                            }
+                            Py_DECREF(dict);
+                        }
+                    }
+                    if (!shadowed) {
+                        OPCACHE_STAT_HIT(method);
+                        meth = lm->meth;
+                        Py_INCREF(meth);
+                        SET_TOP(meth);
+                        PUSH(obj);  // self
+                        DISPATCH();
+                    }
+                    OPCACHE_STAT_MISS(method);
+                }
+                else {
+                    /* The type is different or was modified */
+                    OPCACHE_STAT_MISS(method);
+                    OPCACHE_MAYBE_DEOPT(method);
+                }
+            }
+            else if (co_opcache != NULL && co_opcache->optimized == 0) {
+                /* Cache methods defined on the type and not shadowed by
+                   the instance dict. */
+                PyObject *descr = NULL;
+                if (type->tp_getattro != PyObject_GenericGetAttr ||
+                    type->tp_dict == NULL || type->tp_dictoffset < 0 ||
+                    (descr = _PyType_Lookup(type, name),
+                     !_PyType_HasFeature(type, Py_TPFLAGS_VALID_VERSION_TAG)) ||
+                    descr == NULL ||
+                    !_PyType_HasFeature(Py_TYPE(descr),
+                                        Py_TPFLAGS_METHOD_DESCRIPTOR))
+                {
+                    OPCACHE_DEOPT(method);
+                }
+                else {
+                    _PyOpcache_LoadMethod *lm = &co_opcache->u.lm;
+                    OPCACHE_SET_OPTIMIZED(method);
+                    lm->type = type;
+                    lm->meth = descr;
+                    lm->tp_version_tag = type->tp_version_tag;
+                    lm->dk_version = 0;
+                }
+            }
 
             int meth_found = _PyObject_GetMethod(obj, name, &meth);
 
@@ -0,0 +1,23 @@
+/* Runtime detection of the SIMD instruction sets, see pycore_cpuinfo.h */
+
+#include "Python.h"
+#include "pycore_cpuinfo.h"
+
+int _Py_simd_level = -1;
+
+int
+_Py_DetectSIMDLevel(void)
+{
+#ifdef _Py_HAVE_X86_SIMD
+    /* __builtin_cpu_supports() also checks that the OS saves the AVX
+       registers on context switches. */
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return _Py_SIMD_AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        return _Py_SIMD_SSE42;
+    }
+#endif
+    return _Py_SIMD_NONE;
+}
@@ -625,6 +625,8 @@ new_threadstate(PyInterpreterState *interp, int init)
     tstate->context = NULL;
     tstate->context_ver = 1;
 
+    tstate->obmalloc_cache = _PyObject_NewBlockCache();
+
     if (init) {
         _PyThreadState_Init(tstate);
     }
@@ -838,6 +840,12 @@ PyThreadState_Clear(PyThreadState *tstate)
     if (tstate->on_delete != NULL) {
         tstate->on_delete(tstate->on_delete_data);
     }
+
+    /* Give the cached blocks back last:  the code above can free memory.
+       From now on, the thread uses the pools directly. */
+    struct _PyObject_BlockCache *cache = tstate->obmalloc_cache;
+    tstate->obmalloc_cache = NULL;
+    _PyObject_FreeBlockCache(cache);
 }
 
 
@@ -870,6 +878,11 @@ tstate_delete_common(PyThreadState *tstate,
     {
         PyThread_tss_set(&gilstate->autoTSSkey, NULL);
     }
+
+    /* In case PyThreadState_Clear() was not called */
+    struct _PyObject_BlockCache *cache = tstate->obmalloc_cache;
+    tstate->obmalloc_cache = NULL;
+    _PyObject_FreeBlockCache(cache);
 }
 
 
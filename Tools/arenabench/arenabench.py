@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+"""Benchmark the effect of the pymalloc arena size on a large heap.
+
+Each configuration of the PYTHONMALLOCARENA environment variable is run in a
+child process which builds a heap of small objects and then visits them in
+random order, which stresses the TLB.  The report gives the time of both
+phases, the peak RSS and the number of arenas.  If the Linux perf tool is
+available, the --perf option also reports the data TLB misses of each child.
+
+Example:
+
+    ./python Tools/arenabench/arenabench.py -n 5000000 --perf 256K 2M huge
+"""
+
+import argparse
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+
+
+WORKLOAD = r'''
+import json, random, sys, time
+
+def rss_peak():
+    try:
+        with open('/proc/self/status') as f:
+            for line in f:
+                if line.startswith('VmHWM:'):
+                    return int(line.split()[1]) * 1024
+    except OSError:
+        pass
+    import resource
+    return resource.getrusage(resource.RUSAGE_SELF).ru_maxrss * 1024
+
+n = int(sys.argv[1])
+passes = int(sys.argv[2])
+
+t0 = time.perf_counter()
+objs = [(i, str(i), [i]) for i in range(n)]
+t1 = time.perf_counter()
+
+order = list(range(n))
+random.Random(42).shuffle(order)
+t2 = time.perf_counter()
+total = 0
+for _ in range(passes):
+    for i in order:
+        o = objs[i]
+        total += len(o[1]) + o[2][0]
+t3 = time.perf_counter()
+
+print(json.dumps({'build': t1 - t0, 'visit': t3 - t2, 'rss': rss_peak()}))
+sys.stdout.flush()
+sys._debugmallocstats()
+'''
+
+PERF_EVENTS = ('dTLB-loads', 'dTLB-load-misses')
+
+
+def run(arena, args):
+    env = dict(os.environ)
+    env.pop('PYTHONMALLOC', None)
+    if arena == 'default':
+        env.pop('PYTHONMALLOCARENA', None)
+    else:
+        env['PYTHONMALLOCARENA'] = arena
+    cmd = [args.python, '-c', WORKLOAD, str(args.objects), str(args.passes)]
+    if args.perf:
+        cmd = ['perf', 'stat', '-x,', '-e', ','.join(PERF_EVENTS)] + cmd
+    proc = subprocess.run(cmd, env=env, stdout=subprocess.PIPE,
+                          stderr=subprocess.PIPE, universal_newlines=True)
+    if proc.returncode:
+        sys.exit(f"{arena}: child process failed:\n{proc.stderr}")
+    result = json.loads(proc.stdout)
+
+    m = re.search(r'^(\d+) arenas \* (\d+) bytes/arena', proc.stderr, re.M)
+    if m:
+        result['arenas'] = int(m.group(1))
+        result['arena_size'] = int(m.group(2))
+    for line in proc.stderr.splitlines():
+        fields = line.split(',')
+        if len(fields) > 2 and fields[2] in PERF_EVENTS:
+            try:
+                result[fields[2]] = int(fields[0])
+            except ValueError:
+                # "<not supported>" or "<not counted>"
+                pass
+    return result
+
+
+def format_size(n):
+    for unit in ('B', 'KiB', 'MiB', 'GiB'):
+        if n < 1024 or unit == 'GiB':
+            return f"{n:.0f} {unit}" if unit == 'B' else f"{n:.1f} {unit}"
+        n /= 1024
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('arenas', nargs='*',
+                        default=['default', '1M', '2M', 'huge'],
+                        help="PYTHONMALLOCARENA values to compare "
+                             "('default' leaves it unset)")
+    parser.add_argument('-n', '--objects', type=int, default=1_000_000,
+                        help="number of objects in the heap "
+                             "(default: %(default)s)")
+    parser.add_argument('-p', '--passes', type=int, default=3,
+                        help="number of random visits of the heap "
+                             "(default: %(default)s)")
+    parser.add_argument('--perf', action='store_true',
+                        help="count data TLB misses with perf stat")
+    parser.add_argument('--python', default=sys.executable,
+                        help="interpreter to benchmark "
+                             "(default: %(default)s)")
+    args = parser.parse_args()
+    if args.perf and shutil.which('perf') is None:
+        parser.error("the perf tool is not available")
+
+    header = f"{'arena':>8} {'size':>10} {'arenas':>8} {'build':>8} " \
+             f"{'visit':>8} {'peak RSS':>11}"
+    if args.perf:
+        header += f" {'dTLB misses':>12} {'miss rate':>9}"
+    print(header)
+    print('-' * len(header))
+    for arena in args.arenas:
+        r = run(arena, args)
+        line = (f"{arena:>8} {format_size(r.get('arena_size', 0)):>10} "
+                f"{r.get('arenas', 0):>8} {r['build']:>7.2f}s "
+                f"{r['visit']:>7.2f}s {format_size(r['rss']):>11}")
+        if args.perf:
+            misses = r.get('dTLB-load-misses')
+            loads = r.get('dTLB-loads')
+            if misses is None:
+                line += f" {'n/a':>12} {'n/a':>9}"
+            else:
+                rate = f"{misses / loads:.2%}" if loads else 'n/a'
+                line += f" {misses:>12,} {rate:>9}"
+        print(line)
+
+
+if __name__ == '__main__':
+    main()
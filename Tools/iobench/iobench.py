@@ -96,6 +96,14 @@ def read_lines(f):
     for line in f:
         pass
 
+@with_open_mode("rt")
+@with_sizes("medium", "large")
+def read_lines_batch(f):
+    """ read lines by batches of 64 KiB """
+    f.seek(0)
+    while f.readlines(65536):
+        pass
+
 @with_open_mode("r")
 @with_sizes("medium")
 def seek_forward_bytewise(f):
@@ -225,7 +233,8 @@ def read_modify_blockwise(f, source):
 
 
 read_tests = [
-    read_bytewise, read_small_chunks, read_lines, read_big_chunks,
+    read_bytewise, read_small_chunks, read_lines, read_lines_batch,
+    read_big_chunks,
     None, read_whole_file, None,
     seek_forward_bytewise, seek_forward_blockwise,
     read_seek_bytewise, read_seek_blockwise,
@@ -49,6 +49,15 @@ def main(opcode_py, outfile='Include/opcode.h'):
             if name == 'POP_EXCEPT': # Special entry for HAVE_ARGUMENT
                 fobj.write("#define %-23s %3d\n" %
                             ('HAVE_ARGUMENT', opcode['HAVE_ARGUMENT']))
+        used = [False] * 256
+        for op in opmap.values():
+            used[op] = True
+        next_op = 1
+        for name in opcode['_specialized_instructions']:
+            while used[next_op]:
+                next_op += 1
+            fobj.write("#define %-23s %3s\n" % (name, next_op))
+            used[next_op] = True
         fobj.write(footer)
 
     print("%s regenerated from %s" % (outfile, opcode_py))
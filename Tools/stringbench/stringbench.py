@@ -1390,6 +1390,42 @@ def upper_conversion_dense(STR):
         s_upper()
 
 
+#### UTF-8 decoding
+
+def _get_utf8(STR, text):
+    if STR is BYTES:
+        raise UnsupportedType
+    return (text * 1000).encode("utf-8")
+
+@bench('("Le c\\u0153ur d\\u00e9\\u00e7u mais l\'\\u00e2me...!"*1000).decode("utf-8")',
+       "decode UTF-8 -- mostly ASCII", 10)
+def decode_utf8_latin(STR):
+    s = _get_utf8(STR, u"Le c\u0153ur d\u00e9\u00e7u mais l'\u00e2me "
+                       u"plut\u00f4t na\u00efve, Lou\u00ffs r\u00eava!")
+    s_decode = s.decode
+    for x in _RANGE_10:
+        s_decode("utf-8")
+
+@bench('("\\u0421\\u044a\\u0435\\u0448\\u044c \\u0436\\u0435...!"*1000).decode("utf-8")',
+       "decode UTF-8 -- 2-byte sequences", 10)
+def decode_utf8_cyrillic(STR):
+    s = _get_utf8(STR, u"\u0421\u044a\u0435\u0448\u044c \u0436\u0435 "
+                       u"\u0435\u0449\u0451 \u044d\u0442\u0438\u0445 "
+                       u"\u043c\u044f\u0433\u043a\u0438\u0445!")
+    s_decode = s.decode
+    for x in _RANGE_10:
+        s_decode("utf-8")
+
+@bench('("\\u6211\\u80fd\\u541e\\u4e0b...!"*1000).decode("utf-8")',
+       "decode UTF-8 -- 3-byte sequences", 10)
+def decode_utf8_cjk(STR):
+    s = _get_utf8(STR, u"\u6211\u80fd\u541e\u4e0b\u73bb\u7483\u800c"
+                       u"\u4e0d\u4f24\u8eab\u4f53\u3002")
+    s_decode = s.decode
+    for x in _RANGE_10:
+        s_decode("utf-8")
+
+
 # end of benchmarks
 
 #################
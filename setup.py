@@ -948,7 +948,8 @@ class PyBuildExt(build_ext):
                            libraries=['m']))
 
         # CSV files
-        self.add(Extension('_csv', ['_csv.c']))
+        self.add(Extension('_csv', ['_csv.c'],
+                           extra_compile_args=['-DPy_BUILD_CORE_MODULE']))
 
         # POSIX subprocess module helper.
         self.add(Extension('_posixsubprocess', ['_posixsubprocess.c']))